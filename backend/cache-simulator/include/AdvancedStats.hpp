@@ -20,6 +20,22 @@ struct VectorStats {
   uint64_t cross_line_accesses = 0; // Accesses spanning cache lines
 };
 
+// Gather/scatter statistics (masked vector ops tagged lane by lane).
+// lines_touched sums the distinct cache lines each op hit, so
+// avg_lines_per_op() near 1.0 means the "gather" was really contiguous
+// and near the lane count means every lane paid for its own line.
+struct GatherScatterStats {
+  uint64_t gathers = 0;       // Gather (vector load) instructions
+  uint64_t scatters = 0;      // Scatter (vector store) instructions
+  uint64_t lanes = 0;         // Active lanes across all ops
+  uint64_t bytes = 0;         // Bytes moved by those lanes
+  uint64_t lines_touched = 0; // Distinct cache lines, summed per op
+  [[nodiscard]] double avg_lines_per_op() const {
+    uint64_t ops = gathers + scatters;
+    return ops ? (double)lines_touched / ops : 0;
+  }
+};
+
 // Atomic operation statistics
 struct AtomicStats {
   uint64_t load_count = 0;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Bump allocator for trace-lifetime metadata
+//
+// Per-entry heap allocations (interned file names, report strings) are
+// tiny, never freed individually, and all die together when a run ends.
+// An arena hands them out by bumping a pointer through fixed-size blocks
+// and releases everything wholesale, so long runs pay neither per-object
+// malloc/free overhead nor fragmentation.
+//
+// Pointers stay valid until release(): blocks are never moved or
+// reclaimed early. Requests larger than the block size get a dedicated
+// block so they don't strand the tail of the current one.
+class Arena {
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE)
+      : block_size_(block_size ? block_size : DEFAULT_BLOCK_SIZE) {}
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // Allocate size bytes aligned to align (must be a power of two)
+  void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    if (size > block_size_) {
+      // Dedicated block, inserted behind the current one so the current
+      // block's remaining space stays usable
+      blocks_.emplace_back(new char[size]);
+      char *p = blocks_.back().get();
+      if (blocks_.size() > 1)
+        std::swap(blocks_[blocks_.size() - 2], blocks_.back());
+      else
+        offset_ = block_size_; // the dedicated block is full, never bump into it
+      bytes_used_ += size;
+      bytes_reserved_ += size;
+      return p;
+    }
+
+    size_t aligned = (offset_ + align - 1) & ~(align - 1);
+    if (blocks_.empty() || aligned + size > block_size_) {
+      blocks_.emplace_back(new char[block_size_]);
+      bytes_reserved_ += block_size_;
+      aligned = 0;
+    }
+    offset_ = aligned + size;
+    bytes_used_ += size;
+    return blocks_.back().get() + aligned;
+  }
+
+  // Copy a string into the arena, returning a view valid until release()
+  std::string_view copy_string(std::string_view s) {
+    if (s.empty())
+      return {};
+    char *p = static_cast<char *>(allocate(s.size(), 1));
+    std::memcpy(p, s.data(), s.size());
+    return {p, s.size()};
+  }
+
+  // Free every block at once; all pointers and views become invalid
+  void release() {
+    blocks_.clear();
+    offset_ = 0;
+    bytes_used_ = 0;
+    bytes_reserved_ = 0;
+  }
+
+  [[nodiscard]] size_t bytes_used() const { return bytes_used_; }
+  [[nodiscard]] size_t bytes_reserved() const { return bytes_reserved_; }
+
+private:
+  size_t block_size_;
+  size_t offset_ = 0; // bump position in the current (last) block
+  size_t bytes_used_ = 0;
+  size_t bytes_reserved_ = 0;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+};
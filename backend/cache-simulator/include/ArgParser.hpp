@@ -2,23 +2,85 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "../profiles/CacheConfig.hpp"
+#include "CoherenceController.hpp"
+#include "PageAllocator.hpp"
 #include "Prefetcher.hpp"
 
 struct SimulatorOptions {
     std::string config_name = "intel";
+    std::vector<std::string> config_list;  // --configs: several presets over one parse pass
     CacheHierarchyConfig cache_config;
     int num_cores = 0;  // 0 = auto-detect from trace
     PrefetchPolicy prefetch_policy = PrefetchPolicy::NONE;
     int prefetch_degree = 2;
+    bool prefetch_throttle = false;  // Feedback-directed per-core degree adaptation
+    CoherenceMode coherence_mode = CoherenceMode::Auto;  // directory above 64 cores
+    CoherenceProtocol coherence_protocol = CoherenceProtocol::MESI;  // --protocol override
+    bool coherence_protocol_set = false;  // false = use the preset's protocol
     bool verbose = false;
     bool json_output = false;
     bool stream_mode = false;
     bool flamegraph_output = false;
     bool fast_mode = false;  // Disable 3C miss classification for performance
+    bool mrc = false;  // Single-pass reuse-distance analysis / miss-ratio curve
+    bool opt_analysis = false;  // Compare achieved hit rates against Belady OPT
+    size_t hot_line_budget = 0;  // Bounded top-K hot-line tracking (0 = exact map)
+    int mshr_entries = 0;  // MSHR count for the MLP timing model (0 = preset default)
+    size_t victim_cache_entries = 0;  // Jouppi L1 victim buffer size (0 = disabled)
+    bool compress_l3 = false;  // Run the compressed-L3 what-if shadow
+    bool remap_analysis = false;  // Shadow alternative L1D geometries (conflict what-if)
+    bool bulk_sweep = true;  // Closed-form fast path for large memset/memcpy
+    bool self_profile = false;  // Per-stage rdtsc timing of the simulator itself
+    bool coherence_memo = true;  // Memoize repeated shared-line coherence transitions
+    int wb_buffer_entries = 0;  // Writeback buffer slots per level (0 = preset default)
+    int numa_sockets = 0;  // Multi-socket NUMA simulation (0 = single socket)
+    bool numa_interleave = false;  // Page placement: interleave instead of first-touch
+    int cores_per_ccx = -1;  // CCX L3 slicing (-1 = preset default, 0 = force shared L3)
+    std::string placement;       // Thread placement policy: scatter (default) or compact
+    std::string placement_file;  // Explicit "thread core" pin file
+    bool tlb_walk_injection = false;  // Page walks fetch PTEs through the caches
+    size_t huge_page_size = 0;  // Huge-page backing: 2MB/1GB (0 = 4KB pages)
+    PageAllocPolicy page_alloc = PageAllocPolicy::None;  // V->P layer for L2/L3 indexing
+    uint64_t page_alloc_seed = 42;  // Frame placement seed for --page-alloc random
+    double bloom_fp_rate = 0.01;  // 3C classifier Bloom filter false-positive rate
+    bool binary_input = false;  // Input is binary trace format (CXTB)
+    std::string trace_file;  // Read trace from mmap'd file instead of stdin
+    bool pipeline_mode = false;  // Overlap read/parse with simulation
+    bool spill_mode = false;  // Bounded-memory mode: spill parsed events to disk
+    std::string spill_dir;  // Where --spill puts its temp file ("" = $TMPDIR)
+    bool cache_segments = false;  // Memoize repeated access-pattern segments
+    size_t simpoint_interval = 0;  // Phase-sampled simulation interval (0 = off)
+    size_t simpoint_clusters = 0;  // Max phases for --simpoint (0 = default)
+    uint32_t sample_sets = 1;  // Simulate 1-in-n cache sets, extrapolate stats (1 = off)
+    size_t warmup_events = 0;  // Warm contents on the first n events, stats off (0 = off)
+    size_t checkpoint_every = 0;  // Snapshot state every n events (0 = off)
+    size_t stream_stats_every = 0;  // Emit stats snapshot to stderr every n events (0 = off)
+    size_t interval_events = 0;  // Record per-interval time-series every n events (0 = off)
+    std::string diff_file;  // --diff: emit only deltas against this prior result JSON
+    bool no_cache = false;  // Bypass the content-addressed result cache
+    std::string cache_fingerprint;  // Canonical argv digest for the result cache key
+    std::string checkpoint_file = "cache-sim.ckpt";  // Where --checkpoint-every writes
+    bool checkpoint_keep = false;  // Keep a <file>.<offset> series instead of overwriting
+    std::string restore_file;  // --restore: resume from this checkpoint
+    std::string incremental_baseline;  // --incremental: baseline trace for diff re-runs
+    std::string replay_range;  // --replay-range a:b, simulate only events [a, b)
+    std::string index_file;  // --index: sidecar path (default <trace>.cxi)
+    std::string batch_manifest;  // --batch: run a manifest of traces on a worker pool
+    std::string daemon_socket;  // Run as a persistent daemon on this UNIX socket
+    std::string shm_path;  // --shm: consume events live from this shared-memory segment
+    std::string filter_file;  // --filter-file: only simulate events from matching files
+    uint64_t filter_addr_lo = 0;  // --filter-addr lo:hi half-open address window
+    uint64_t filter_addr_hi = 0;  // lo == hi means no address filter
+    std::string filter_heap;  // --filter-heap[-exclude]: by allocation-site glob
+    bool filter_heap_exclude = false;
     bool parallel_parsing = false;  // Enable parallel trace parsing
     size_t parallel_threads = 0;  // 0 = auto-detect (hardware_concurrency)
+    bool parallel_sim = false;  // Simulate cores on parallel worker threads
+    size_t parallel_sim_threads = 0;  // 0 = auto-detect (hardware_concurrency)
+    bool virtual_time = false;  // Deterministic virtual-time thread interleaving
     bool show_help = false;
     bool prefetch_policy_set = false;
     bool prefetch_degree_set = false;
@@ -47,6 +109,24 @@ public:
     /// Convert prefetch policy enum to string name
     [[nodiscard]] static std::string prefetch_policy_name(PrefetchPolicy policy);
 
+    /// Parse page allocation policy name string to enum
+    [[nodiscard]] static PageAllocPolicy parse_page_alloc_policy(std::string_view name);
+
+    /// Convert page allocation policy enum to string name
+    [[nodiscard]] static std::string page_alloc_policy_name(PageAllocPolicy policy);
+
+    /// Parse coherence mode name string to enum
+    [[nodiscard]] static CoherenceMode parse_coherence_mode(std::string_view name);
+
+    /// Convert coherence mode enum to string name
+    [[nodiscard]] static std::string coherence_mode_name(CoherenceMode mode);
+
+    /// Parse coherence protocol name string to enum
+    [[nodiscard]] static CoherenceProtocol parse_coherence_protocol(std::string_view name);
+
+    /// Convert coherence protocol enum to string name
+    [[nodiscard]] static std::string coherence_protocol_name(CoherenceProtocol protocol);
+
     /// Get cache configuration for a named preset
     [[nodiscard]] static CacheHierarchyConfig get_preset_config(std::string_view name);
 
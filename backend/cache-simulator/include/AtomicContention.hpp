@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Atomic operation kinds as the trace records them ('A' loads/stores,
+// 'X' read-modify-writes, 'C' compare-exchanges)
+enum class AtomicOpKind { Load, Store, Rmw, Cmpxchg };
+
+// One contended atomic address in the ranked report
+struct ContendedAtomic {
+  uint64_t address;
+  uint64_t loads = 0;
+  uint64_t stores = 0;
+  uint64_t rmws = 0;
+  uint64_t cmpxchgs = 0;
+  uint32_t threads = 0;     // distinct threads seen (ids folded mod 64)
+  uint64_t ping_pongs = 0;  // write ownership bounced between threads
+  uint64_t retries = 0;     // back-to-back cmpxchg repeats by one thread
+  std::string_view file;    // first access site (interned via FileTable)
+  uint32_t line = 0;
+
+  [[nodiscard]] uint64_t total() const {
+    return loads + stores + rmws + cmpxchgs;
+  }
+
+  // Ping-pongs weigh double: each one is a coherence round trip, while a
+  // retry spin stays within the owner's cache
+  [[nodiscard]] uint64_t contention_score() const {
+    return 2 * ping_pongs + retries;
+  }
+};
+
+// Per-address contention profile over the trace's atomic operations.
+//
+// Three signals per address:
+//   - operation mix and the set of threads touching it
+//   - ping-pongs: a write-side op (store/RMW/cmpxchg) from a different
+//     thread than the previous writer, i.e. the MESI invalidation that
+//     bounces the line between L1s
+//   - retries: consecutive cmpxchg ops by the same thread with nothing in
+//     between, the signature of a failed CAS loop spinning on the value
+//
+// The report ranks addresses by contention score and drops addresses only
+// ever touched by one thread with no retry clusters - an uncontended
+// atomic counter is working as intended.
+class AtomicContentionTracker {
+private:
+  struct Entry {
+    uint64_t loads = 0;
+    uint64_t stores = 0;
+    uint64_t rmws = 0;
+    uint64_t cmpxchgs = 0;
+    uint64_t thread_mask = 0;  // bit per thread id mod 64, like HotLineTracker
+    uint64_t ping_pongs = 0;
+    uint64_t retries = 0;
+    uint32_t last_writer = 0;
+    bool has_writer = false;
+    uint32_t last_cmpxchg_thread = 0;
+    bool last_was_cmpxchg = false;
+    std::string_view file;
+    uint32_t line = 0;
+  };
+  std::unordered_map<uint64_t, Entry> entries;
+
+public:
+  // Record one atomic operation; returns true when it ping-ponged the
+  // address between threads (for the global contention counter)
+  bool record(uint64_t address, uint32_t thread_id, AtomicOpKind kind,
+              std::string_view file, uint32_t line) {
+    Entry &e = entries[address];
+    if (e.file.empty() && !file.empty()) {
+      e.file = file;
+      e.line = line;
+    }
+    e.thread_mask |= 1ULL << (thread_id & 63);
+
+    bool is_write_side = kind != AtomicOpKind::Load;
+    bool ping_pong = false;
+    if (is_write_side) {
+      if (e.has_writer && e.last_writer != thread_id) {
+        e.ping_pongs++;
+        ping_pong = true;
+      }
+      e.last_writer = thread_id;
+      e.has_writer = true;
+    }
+
+    if (kind == AtomicOpKind::Cmpxchg) {
+      if (e.last_was_cmpxchg && e.last_cmpxchg_thread == thread_id)
+        e.retries++;
+      e.last_cmpxchg_thread = thread_id;
+      e.last_was_cmpxchg = true;
+    } else {
+      e.last_was_cmpxchg = false;
+    }
+
+    switch (kind) {
+      case AtomicOpKind::Load: e.loads++; break;
+      case AtomicOpKind::Store: e.stores++; break;
+      case AtomicOpKind::Rmw: e.rmws++; break;
+      case AtomicOpKind::Cmpxchg: e.cmpxchgs++; break;
+    }
+    return ping_pong;
+  }
+
+  // Ranked contended addresses, highest contention score first
+  [[nodiscard]] std::vector<ContendedAtomic> top(size_t limit) const {
+    std::vector<ContendedAtomic> out;
+    for (const auto &[addr, e] : entries) {
+      uint32_t threads =
+          static_cast<uint32_t>(__builtin_popcountll(e.thread_mask));
+      if (threads < 2 && e.retries == 0)
+        continue;  // single-thread, no spinning - not contended
+      ContendedAtomic c;
+      c.address = addr;
+      c.loads = e.loads;
+      c.stores = e.stores;
+      c.rmws = e.rmws;
+      c.cmpxchgs = e.cmpxchgs;
+      c.threads = threads;
+      c.ping_pongs = e.ping_pongs;
+      c.retries = e.retries;
+      c.file = e.file;
+      c.line = e.line;
+      out.push_back(c);
+    }
+    std::sort(out.begin(), out.end(), [](const auto &a, const auto &b) {
+      if (a.contention_score() != b.contention_score())
+        return a.contention_score() > b.contention_score();
+      return a.total() > b.total();
+    });
+    if (out.size() > limit)
+      out.resize(limit);
+    return out;
+  }
+
+  [[nodiscard]] bool empty() const { return entries.empty(); }
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FileTable.hpp"
+#include "TraceEvent.hpp"
+
+// Binary trace format ("CXTB") shared with backend/runtime/cache-explorer-rt.c
+//
+// The runtime already buffers CacheEvent structs in its ring buffer; the text
+// protocol throws that structure away by formatting hex/decimal, and the
+// simulator re-parses it. The binary format keeps the packed representation
+// end to end:
+//
+//   Header:  4-byte magic "CXTB" + uint32 version
+//   Records: 1-byte tag followed by a fixed or length-prefixed payload
+//     'F' (file table entry): uint32 file_id, uint16 name_len, name bytes
+//     'E' (event):            BinaryEventRecord (28 bytes, packed)
+//     'G' (function entry):   uint32 packed (file_id << 20 | line),
+//                             uint16 name_len, name bytes
+//
+// File records are emitted before any event that references their id, so the
+// stream can be decoded in a single forward pass.
+
+constexpr char BINARY_TRACE_MAGIC[4] = {'C', 'X', 'T', 'B'};
+constexpr uint32_t BINARY_TRACE_VERSION = 1;
+
+constexpr char BINARY_RECORD_FILE = 'F';
+constexpr char BINARY_RECORD_EVENT = 'E';
+constexpr char BINARY_RECORD_FUNC = 'G';
+
+// Delta/varint compact events (CACHE_EXPLORER_COMPACT=1 in the runtime).
+// Any tag byte with the high bit set is itself a one-byte compact event:
+// the low bits are flags, followed by a zigzag-varint address delta
+// against the previous compact event, then size / packed-line / thread
+// varints only when the flag says the field changed. Plain loads and
+// stores - the overwhelming bulk of a trace - encode in 2-4 bytes this
+// way; every other event kind stays a fixed 'E' record, which does NOT
+// advance the delta state. Streams carrying compact events write header
+// version 2 so older readers fail at the unknown tag, not mid-record.
+constexpr uint32_t BINARY_TRACE_VERSION_COMPACT = 2;
+constexpr uint8_t BINARY_COMPACT_BIT = 0x80;
+constexpr uint8_t BINARY_COMPACT_STORE = 0x01;
+constexpr uint8_t BINARY_COMPACT_SIZE = 0x02;   // varint size follows
+constexpr uint8_t BINARY_COMPACT_LINE = 0x04;   // varint packed line follows
+constexpr uint8_t BINARY_COMPACT_THREAD = 0x08; // varint thread id follows
+
+// LEB128 varint decode; returns nullptr on a truncated run
+inline const char *read_varint(const char *p, const char *end,
+                               uint64_t &value) {
+  value = 0;
+  int shift = 0;
+  while (p < end) {
+    uint8_t byte = static_cast<uint8_t>(*p++);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return p;
+    shift += 7;
+  }
+  return nullptr;
+}
+
+inline int64_t zigzag_decode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// Event flag bits in the address field - must match cache-explorer-rt.h
+constexpr uint64_t BINARY_STORE_FLAG = 1ULL << 63;
+constexpr uint64_t BINARY_ICACHE_FLAG = 1ULL << 62;
+constexpr uint64_t BINARY_PREFETCH_FLAG = 1ULL << 61;
+constexpr uint64_t BINARY_VECTOR_FLAG = 1ULL << 60;
+constexpr uint64_t BINARY_ATOMIC_FLAG = 1ULL << 59;
+constexpr uint64_t BINARY_MEMINTR_FLAG = 1ULL << 56;
+constexpr uint64_t BINARY_RANGE_FLAG = 1ULL << 53;
+constexpr uint64_t BINARY_HEAP_FLAG = 1ULL << 52;
+constexpr uint64_t BINARY_PHASE_FLAG = 1ULL << 51;
+constexpr uint64_t BINARY_GATHER_FLAG = 1ULL << 50;
+constexpr uint64_t BINARY_ADDR_MASK = 0x00FFFFFFFFFFFFFFULL;
+// Range records steal bit 53 (real addresses fit in 48 bits), so their
+// base address uses the narrower mask; heap records steal bit 52 too,
+// and gather lanes bit 50
+constexpr uint64_t BINARY_RANGE_ADDR_MASK = BINARY_RANGE_FLAG - 1;
+constexpr uint64_t BINARY_HEAP_ADDR_MASK = BINARY_HEAP_FLAG - 1;
+constexpr uint64_t BINARY_PHASE_ID_MASK = BINARY_PHASE_FLAG - 1;
+constexpr uint64_t BINARY_GATHER_ADDR_MASK = BINARY_GATHER_FLAG - 1;
+
+// Mirrors the runtime's CacheEvent layout (without padding):
+// address carries the flag bits above, line packs (file_id << 20) | line.
+struct BinaryEventRecord {
+  uint64_t address;
+  uint64_t src_address;
+  uint32_t size;
+  uint32_t line;
+  uint32_t thread_id;
+};
+constexpr size_t BINARY_EVENT_RECORD_SIZE = 28;
+
+// Returns true if the buffer starts with the binary trace magic
+inline bool is_binary_trace(const char *data, size_t size) {
+  return size >= sizeof(BINARY_TRACE_MAGIC) &&
+         memcmp(data, BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC)) == 0;
+}
+
+// Decodes a packed event record into a TraceEvent using the file table
+// accumulated from 'F' records seen so far
+inline TraceEvent decode_binary_event(const BinaryEventRecord &rec,
+                                      const std::vector<std::string_view> &files) {
+  TraceEvent event;
+  event.address = rec.address & BINARY_ADDR_MASK;
+  event.size = rec.size;
+  event.thread_id = rec.thread_id;
+  event.line = rec.line & 0xFFFFF;
+
+  uint32_t file_id = rec.line >> 20;
+  if (file_id < files.size()) {
+    event.file = files[file_id];
+  }
+
+  if (rec.address & BINARY_PHASE_FLAG) {
+    // Phase marker: the store bit distinguishes end (1) from begin (0)
+    event.address = rec.address & BINARY_PHASE_ID_MASK;
+    if (rec.address & BINARY_STORE_FLAG) {
+      event.is_phase_end = true;
+    } else {
+      event.is_phase_begin = true;
+    }
+  } else if (rec.address & BINARY_HEAP_FLAG) {
+    // Heap record: the store bit distinguishes free (1) from alloc (0)
+    event.address = rec.address & BINARY_HEAP_ADDR_MASK;
+    if (rec.address & BINARY_STORE_FLAG) {
+      event.is_free = true;
+    } else {
+      event.is_alloc = true;
+    }
+  } else if (rec.address & BINARY_RANGE_FLAG) {
+    // Compressed range: src_address packs (count << 32) | stride (int32)
+    event.address = rec.address & BINARY_RANGE_ADDR_MASK;
+    event.is_range = true;
+    event.stride = (int32_t)(rec.src_address & 0xFFFFFFFF);
+    event.count = rec.src_address >> 32;
+    event.is_write = (rec.address & BINARY_STORE_FLAG) != 0;
+  } else if (rec.address & BINARY_MEMINTR_FLAG) {
+    uint64_t intrinsic_type = (rec.address >> 54) & 0x3;
+    // The type bits sit at 54-55, inside BINARY_ADDR_MASK - strip them
+    // or memset/memmove destinations decode with a phantom high bit
+    event.address = rec.address & ((1ULL << 54) - 1);
+    event.is_write = true;
+    if (intrinsic_type == 1) {
+      event.is_memset = true;
+    } else if (intrinsic_type == 2) {
+      event.is_memmove = true;
+      event.src_address = rec.src_address;
+    } else {
+      event.is_memcpy = true;
+      event.src_address = rec.src_address;
+    }
+  } else if (rec.address & BINARY_ATOMIC_FLAG) {
+    event.is_atomic = true;
+    uint64_t atomic_type = (rec.address >> 57) & 0x3;
+    if (atomic_type == 3) {
+      event.is_cmpxchg = true;
+    } else if (atomic_type == 2 || (rec.address & BINARY_STORE_FLAG)) {
+      event.is_rmw = true;
+      event.is_write = true;
+    }
+  } else if (rec.address & BINARY_GATHER_FLAG) {
+    // Gather/scatter lane: src_address packs (lanes << 32) | lane
+    event.address = rec.address & BINARY_GATHER_ADDR_MASK;
+    event.is_gather = true;
+    event.lane = static_cast<uint8_t>(rec.src_address & 0xFFFFFFFF);
+    event.lanes = static_cast<uint8_t>(rec.src_address >> 32);
+    event.is_write = (rec.address & BINARY_STORE_FLAG) != 0;
+  } else if (rec.address & BINARY_VECTOR_FLAG) {
+    event.is_vector = true;
+    event.is_write = (rec.address & BINARY_STORE_FLAG) != 0;
+  } else if (rec.address & BINARY_PREFETCH_FLAG) {
+    event.is_prefetch = true;
+    event.prefetch_hint = (rec.address >> 54) & 0x3;
+    // Hint bits share 54-55 with the address mask - strip them too
+    event.address = rec.address & ((1ULL << 54) - 1);
+  } else if (rec.address & BINARY_ICACHE_FLAG) {
+    event.is_icache = true;
+  } else {
+    event.is_write = (rec.address & BINARY_STORE_FLAG) != 0;
+  }
+
+  return event;
+}
+
+// Single-pass decoder for a complete binary trace buffer.
+// Calls the callback with each decoded TraceEvent; maintains the file table
+// from interleaved 'F' records. Returns the number of events decoded.
+template <typename Callback>
+inline size_t parse_binary_trace(const char *data, size_t size, Callback &&cb) {
+  if (!is_binary_trace(data, size))
+    return 0;
+
+  const char *p = data + sizeof(BINARY_TRACE_MAGIC) + sizeof(uint32_t);
+  const char *end = data + size;
+  std::vector<std::string_view> files;
+  size_t count = 0;
+
+  // Compact-event delta state - initial values match the encoder's
+  // (cache-explorer-rt.c), and only compact records advance it
+  uint64_t prev_addr = 0;
+  uint32_t prev_size = 0;
+  uint32_t prev_line = 0;
+  uint32_t prev_tid = 1;
+
+  while (p < end) {
+    char tag = *p++;
+    if (static_cast<uint8_t>(tag) & BINARY_COMPACT_BIT) {
+      uint8_t op = static_cast<uint8_t>(tag);
+      uint64_t v;
+      const char *q = read_varint(p, end, v);
+      if (!q)
+        break; // Truncated record at end of stream
+      prev_addr += static_cast<uint64_t>(zigzag_decode(v));
+      if (op & BINARY_COMPACT_SIZE) {
+        if (!(q = read_varint(q, end, v)))
+          break;
+        prev_size = static_cast<uint32_t>(v);
+      }
+      if (op & BINARY_COMPACT_LINE) {
+        if (!(q = read_varint(q, end, v)))
+          break;
+        prev_line = static_cast<uint32_t>(v);
+      }
+      if (op & BINARY_COMPACT_THREAD) {
+        if (!(q = read_varint(q, end, v)))
+          break;
+        prev_tid = static_cast<uint32_t>(v);
+      }
+      p = q;
+      TraceEvent event;
+      event.address = prev_addr & BINARY_ADDR_MASK;
+      event.size = prev_size;
+      event.is_write = (op & BINARY_COMPACT_STORE) != 0;
+      event.line = prev_line & 0xFFFFF;
+      uint32_t file_id = prev_line >> 20;
+      if (file_id < files.size())
+        event.file = files[file_id];
+      event.thread_id = prev_tid;
+      cb(std::move(event));
+      count++;
+    } else if (tag == BINARY_RECORD_EVENT) {
+      if (p + BINARY_EVENT_RECORD_SIZE > end)
+        break; // Truncated record at end of stream
+      BinaryEventRecord rec;
+      memcpy(&rec.address, p, 8);
+      memcpy(&rec.src_address, p + 8, 8);
+      memcpy(&rec.size, p + 16, 4);
+      memcpy(&rec.line, p + 20, 4);
+      memcpy(&rec.thread_id, p + 24, 4);
+      p += BINARY_EVENT_RECORD_SIZE;
+      cb(decode_binary_event(rec, files));
+      count++;
+    } else if (tag == BINARY_RECORD_FILE) {
+      if (p + 6 > end)
+        break;
+      uint32_t file_id;
+      uint16_t name_len;
+      memcpy(&file_id, p, 4);
+      memcpy(&name_len, p + 4, 2);
+      p += 6;
+      if (p + name_len > end)
+        break;
+      if (file_id >= files.size())
+        files.resize(file_id + 1);
+      // Intern so the view outlives the input buffer
+      files[file_id] = FileTable::instance().view(std::string_view(p, name_len));
+      p += name_len;
+    } else if (tag == BINARY_RECORD_FUNC) {
+      // Function registration: packed (file_id << 20 | line) site plus
+      // the enclosing function's name
+      if (p + 6 > end)
+        break;
+      uint32_t packed;
+      uint16_t name_len;
+      memcpy(&packed, p, 4);
+      memcpy(&name_len, p + 4, 2);
+      p += 6;
+      if (p + name_len > end)
+        break;
+      uint32_t file_id = packed >> 20;
+      if (file_id < files.size()) {
+        TraceFuncMap::instance().register_site(
+            files[file_id], packed & 0xFFFFF, std::string_view(p, name_len));
+      }
+      p += name_len;
+    } else {
+      break; // Unknown record tag - stop rather than misinterpret
+    }
+  }
+
+  return count;
+}
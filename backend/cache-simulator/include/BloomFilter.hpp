@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Checkpoint.hpp"
+
+// Bloom filter over 64-bit line addresses, used for compulsory-miss tracking.
+// The exact std::unordered_set grew without bound (hundreds of millions of
+// entries on large traces); the filter answers "seen before?" in fixed memory
+// at a configurable false-positive rate. A false positive turns a compulsory
+// miss into a capacity/conflict miss - a small, quantifiable skew that
+// estimated_fp_rate() reports so the JSON output can surface it.
+//
+// Entries are never removed, so a plain bit-vector filter suffices - counting
+// buckets would cost 4-8x the memory for a delete operation nothing needs.
+// Aggregate filter health across a cache hierarchy, for JSON reporting
+struct ClassifierSummary {
+  double fp_rate = 0.0;            // Configured target rate
+  double estimated_fp_rate = 0.0;  // Worst current rate across levels
+  uint64_t memory_bytes = 0;       // Total filter memory
+};
+
+class BloomFilter {
+public:
+  static constexpr uint64_t DEFAULT_EXPECTED_ITEMS = 1ULL << 23; // 8M lines
+  static constexpr double DEFAULT_FP_RATE = 0.01;
+
+  explicit BloomFilter(uint64_t expected_items = DEFAULT_EXPECTED_ITEMS,
+                       double fp_rate = DEFAULT_FP_RATE) {
+    configure(expected_items, fp_rate);
+  }
+
+  // Size the filter for an expected item count and target false-positive
+  // rate. Discards all current contents.
+  void configure(uint64_t expected_items, double fp_rate) {
+    if (expected_items == 0)
+      expected_items = 1;
+    if (fp_rate <= 0.0 || fp_rate >= 1.0)
+      fp_rate = DEFAULT_FP_RATE;
+
+    fp_rate_ = fp_rate;
+    // Standard sizing: m = -n ln(p) / (ln 2)^2, k = (m/n) ln 2
+    double ln2 = std::log(2.0);
+    double bits = -static_cast<double>(expected_items) * std::log(fp_rate) /
+                  (ln2 * ln2);
+    num_bits_ = (static_cast<uint64_t>(bits) + 63) & ~63ULL;
+    num_hashes_ = static_cast<int>(std::round(bits / expected_items * ln2));
+    if (num_hashes_ < 1)
+      num_hashes_ = 1;
+    clear();
+  }
+
+  // Insert key, returning true if it was (possibly) already present.
+  // "true" can be a false positive; "false" is always exact.
+  bool test_and_insert(uint64_t key) {
+    if (words_.empty())
+      words_.resize(num_bits_ / 64, 0); // Allocate on first use
+
+    uint64_t h1 = mix(key);
+    uint64_t h2 = mix(key ^ 0x9e3779b97f4a7c15ULL) | 1;
+
+    bool all_set = true;
+    for (int i = 0; i < num_hashes_; i++) {
+      uint64_t bit = (h1 + static_cast<uint64_t>(i) * h2) % num_bits_;
+      uint64_t mask = 1ULL << (bit & 63);
+      uint64_t &word = words_[bit >> 6];
+      if (!(word & mask)) {
+        all_set = false;
+        word |= mask;
+        set_bits_++;
+      }
+    }
+    return all_set;
+  }
+
+  [[nodiscard]] bool contains(uint64_t key) const {
+    if (words_.empty())
+      return false;
+    uint64_t h1 = mix(key);
+    uint64_t h2 = mix(key ^ 0x9e3779b97f4a7c15ULL) | 1;
+    for (int i = 0; i < num_hashes_; i++) {
+      uint64_t bit = (h1 + static_cast<uint64_t>(i) * h2) % num_bits_;
+      if (!(words_[bit >> 6] & (1ULL << (bit & 63))))
+        return false;
+    }
+    return true;
+  }
+
+  void clear() {
+    words_.clear();
+    words_.shrink_to_fit();
+    set_bits_ = 0;
+  }
+
+  // Target rate the filter was sized for
+  [[nodiscard]] double configured_fp_rate() const { return fp_rate_; }
+
+  // Current rate given actual fill: (set_bits / m)^k. Exceeding the
+  // expected item count degrades this gracefully rather than failing.
+  [[nodiscard]] double estimated_fp_rate() const {
+    if (set_bits_ == 0)
+      return 0.0;
+    double fill = static_cast<double>(set_bits_) / num_bits_;
+    return std::pow(fill, num_hashes_);
+  }
+
+  [[nodiscard]] uint64_t memory_bytes() const {
+    return words_.size() * sizeof(uint64_t);
+  }
+  [[nodiscard]] int num_hashes() const { return num_hashes_; }
+
+  // Checkpointing: persist the seen-lines bits so compulsory-miss
+  // classification stays exact across a restore
+  void save_state(CheckpointWriter &w) const {
+    w.write(num_bits_);
+    w.write(set_bits_);
+    w.write(num_hashes_);
+    w.write(fp_rate_);
+    w.write_vec(words_);
+  }
+
+  void load_state(CheckpointReader &r) {
+    num_bits_ = r.read<uint64_t>();
+    set_bits_ = r.read<uint64_t>();
+    num_hashes_ = r.read<int>();
+    fp_rate_ = r.read<double>();
+    r.read_vec(words_);
+  }
+
+private:
+  // splitmix64 finalizer - line addresses are too regular to use raw
+  static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  std::vector<uint64_t> words_;
+  uint64_t num_bits_ = 0;
+  uint64_t set_bits_ = 0;
+  int num_hashes_ = 1;
+  double fp_rate_ = DEFAULT_FP_RATE;
+};
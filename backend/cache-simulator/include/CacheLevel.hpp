@@ -2,12 +2,13 @@
 
 #include <cstdlib>
 #include <stdexcept>
-#include <unordered_set>
 #include <vector>
 
 #include "../profiles/CacheConfig.hpp"
-#include "CacheLine.hpp"
+#include "BloomFilter.hpp"
+#include "Checkpoint.hpp"
 #include "CacheStats.hpp"
+#include "CoherenceState.hpp"
 #include "EvictionPolicy.hpp"
 
 enum class AccessResult { Hit, Miss, MissWithEviction };
@@ -19,14 +20,49 @@ struct AccessInfo {
   bool had_eviction;  // True if a valid line was evicted (for inclusive cache back-invalidation)
 };
 
+// Read-only snapshot of one line's metadata (for visualization)
+struct CacheLineView {
+  uint64_t tag;
+  bool valid;
+  bool dirty;
+  CoherenceState coherence_state;
+};
+
 class CacheLevel {
+public:
+  // Packed line metadata: one 64-bit word per line carries the tag plus
+  // every per-line flag, so the common case is 16 bytes per line (meta +
+  // LRU timestamp) instead of the 28 the split byte arrays cost. A 256MB
+  // epyc L3 is 4M lines - the packing saves ~48MB per simulated level
+  // and keeps a whole set's state in one or two host cache lines.
+  //
+  // Tags are truncated to 56 bits; the binary trace format already masks
+  // addresses to 56 bits (BINARY_ADDR_MASK) and both store and compare
+  // apply the same mask, so wider synthetic addresses stay consistent.
+  static constexpr uint64_t LINE_VALID = 1ULL << 63;
+  static constexpr uint64_t LINE_DIRTY = 1ULL << 62;
+  static constexpr int LINE_COH_SHIFT = 58;    // 3 bits, CoherenceState
+                                               // (MOESI/MESIF need 6 states)
+  static constexpr int LINE_RRIP_SHIFT = 56;   // 2 bits, RRPV 0-3
+  static constexpr uint64_t LINE_FIELD_MASK = 3;
+  static constexpr uint64_t LINE_COH_MASK = 7;
+  static constexpr uint64_t LINE_TAG_MASK = (1ULL << 56) - 1;
+
 private:
   CacheConfig config;
-  std::vector<std::vector<CacheLine>> sets;
+  // Flat SoA arrays indexed by set * associativity + way. Keeping each
+  // field contiguous means a set's metadata shares a cache line and the
+  // tag compare in find_way() can test all ways with one vector
+  // instruction, instead of chasing per-set heap blocks of line structs.
+  std::vector<uint64_t> meta_;       // packed tag + flags (layout above)
+  std::vector<uint64_t> lru_times_;
+  std::vector<uint64_t> next_use_;  // OPT only: when each line is referenced next
   std::vector<uint64_t> plru_bits;
   std::vector<int> set_mru_;  // MRU way index per set, -1 if none
   uint64_t access_time = 0;
-  CacheStats stats;
+  // Cacheline-aligned so per-core L1 counters updated by parallel epoch
+  // workers can never share a line with a neighboring object's fields
+  AlignedCacheStats stats;
 
   // Cached bit widths for performance (avoid repeated log2 calculations)
   int cached_offset_bits_;
@@ -35,27 +71,103 @@ private:
 
   // For 3C miss classification (can be disabled for performance)
   bool track_3c_misses_ = true;
-  std::unordered_set<uint64_t> ever_accessed;  // Track compulsory misses
+  BloomFilter ever_accessed;  // Compulsory-miss tracking in fixed memory
   uint64_t unique_lines_accessed = 0;          // For capacity estimation
   std::vector<uint64_t> set_unique_lines;      // Track unique lines per set for conflict detection
 
-  int find_victim_lru(const std::vector<CacheLine> &set) const;
+  // First element of a set's slice in the flat arrays
+  [[nodiscard]] size_t set_base(uint64_t set_index) const {
+    return set_index * static_cast<size_t>(config.associativity);
+  }
+
+  // Packed-metadata field accessors
+  [[nodiscard]] bool line_valid(size_t i) const { return meta_[i] & LINE_VALID; }
+  [[nodiscard]] bool line_dirty(size_t i) const { return meta_[i] & LINE_DIRTY; }
+  [[nodiscard]] uint64_t line_tag(size_t i) const { return meta_[i] & LINE_TAG_MASK; }
+  void set_line_dirty(size_t i, bool d) {
+    if (d)
+      meta_[i] |= LINE_DIRTY;
+    else
+      meta_[i] &= ~LINE_DIRTY;
+  }
+  [[nodiscard]] uint8_t line_rrip(size_t i) const {
+    return static_cast<uint8_t>((meta_[i] >> LINE_RRIP_SHIFT) & LINE_FIELD_MASK);
+  }
+  void set_line_rrip(size_t i, uint8_t v) {
+    meta_[i] = (meta_[i] & ~(LINE_FIELD_MASK << LINE_RRIP_SHIFT)) |
+               (static_cast<uint64_t>(v & LINE_FIELD_MASK) << LINE_RRIP_SHIFT);
+  }
+  [[nodiscard]] CoherenceState line_coherence(size_t i) const {
+    return static_cast<CoherenceState>((meta_[i] >> LINE_COH_SHIFT) &
+                                       LINE_COH_MASK);
+  }
+  void set_line_coherence(size_t i, CoherenceState s) {
+    meta_[i] = (meta_[i] & ~(LINE_COH_MASK << LINE_COH_SHIFT)) |
+               (static_cast<uint64_t>(s) << LINE_COH_SHIFT);
+  }
+
+  // SIMD tag compare across all ways of a set; returns way or -1
+  [[nodiscard]] int find_way(uint64_t set_index, uint64_t tag) const;
+
+  // 3C bookkeeping for one miss (shared by access_impl and sweep_install)
+  void record_miss_class(uint64_t address, uint64_t index);
+
+  int find_victim_lru(uint64_t set_index) const;
+  int find_victim_opt(uint64_t set_index) const;
   int find_victim_plru(uint64_t set_index);
-  int find_victim_random(const std::vector<CacheLine> &set) const;
-  int find_victim_srrip(std::vector<CacheLine> &set);
-  int find_victim_brrip(std::vector<CacheLine> &set);
+  int find_victim_random(uint64_t set_index) const;
+  int find_victim_srrip(uint64_t set_index);
+  int find_victim_brrip(uint64_t set_index);
   int find_victim(uint64_t set_index);
 
+  // Specialized access kernels: the hot path is stamped out once per
+  // (policy, 3C-tracking) combination, so the per-event policy tests and
+  // the find_victim switch resolve at compile time. access() dispatches
+  // through a member-function pointer picked when the policy or the
+  // tracking flag changes - one indirect call per event instead of a
+  // branch cascade.
+  template <EvictionPolicy P, bool Track3C>
+  AccessInfo access_impl(uint64_t address, bool is_write);
+  template <EvictionPolicy P> int find_victim_for(uint64_t set_index);
+  template <EvictionPolicy P> void touch_replacement(uint64_t set_index, int way);
+  using AccessKernel = AccessInfo (CacheLevel::*)(uint64_t, bool);
+  AccessKernel access_kernel_ = nullptr;
+  void select_access_kernel();
+
+  // PLRU tree update shared by the runtime and templated paths
+  void update_plru_bits(uint64_t set_index, int way);
+
+  // DRRIP set dueling: a few leader sets run pure SRRIP or BRRIP and
+  // steer PSEL with their misses; every other set follows the winner
+  static constexpr uint64_t DUEL_MODULUS = 32;
+  static constexpr uint64_t SRRIP_LEADER_SLOT = 0;
+  static constexpr uint64_t BRRIP_LEADER_SLOT = 1;
+  static constexpr uint16_t PSEL_MAX = 1023;
+  uint16_t psel_ = PSEL_MAX / 2;
+
+  // RRPV for a newly installed line under the configured RRIP policy
+  [[nodiscard]] uint8_t rrip_insert_value(uint64_t set_index);
+
   void update_replacement_state(uint64_t set_index, int way);
   uint64_t rebuild_address(uint64_t tag, uint64_t index) const;
 
+  // OPT: next-use time the oracle supplied for the access in flight
+  uint64_t pending_next_use_ = UINT64_MAX;
+
 public:
+  // OPT next-use value meaning "never referenced again"
+  static constexpr uint64_t NEXT_USE_NEVER = UINT64_MAX;
+
   CacheLevel() = delete;
 
   explicit CacheLevel(const CacheConfig &cfg);
 
   [[nodiscard]] const CacheConfig &get_config() const { return config; }
   [[nodiscard]] const CacheStats &get_stats() const { return stats; }
+
+  // Apply a memoized stats delta (segment caching fast-forward)
+  void add_stats(const CacheStats &delta) { stats += delta; }
+
   void reset_stats() {
     stats.reset();
     ever_accessed.clear();
@@ -64,28 +176,80 @@ public:
     std::fill(set_mru_.begin(), set_mru_.end(), -1);
   }
 
+  // Drop all cached lines as well as stats, returning to the
+  // freshly-constructed state (daemon job reuse)
+  void clear() {
+    // Empty line: invalid, clean, coherence Invalid (0), RRPV at max (3)
+    std::fill(meta_.begin(), meta_.end(), LINE_FIELD_MASK << LINE_RRIP_SHIFT);
+    std::fill(lru_times_.begin(), lru_times_.end(), 0);
+    std::fill(next_use_.begin(), next_use_.end(), NEXT_USE_NEVER);
+    std::fill(plru_bits.begin(), plru_bits.end(), 0);
+    access_time = 0;
+    psel_ = PSEL_MAX / 2;
+    reset_stats();
+  }
+
   [[nodiscard]] int get_num_sets() const { return config.num_sets(); }
   [[nodiscard]] int get_associativity() const { return config.associativity; }
   [[nodiscard]] int get_size_kb() const { return config.kb_size; }
   [[nodiscard]] int get_line_size() const { return config.line_size; }
   [[nodiscard]] EvictionPolicy get_eviction_policy() const { return config.policy; }
 
+  // DRRIP policy-selector counter (above the midpoint = BRRIP winning)
+  [[nodiscard]] uint16_t get_psel() const { return psel_; }
+
+  // OPT: stamp the oracle's next-use time for the upcoming access. The
+  // touched line remembers it, and find_victim_opt() evicts the line whose
+  // remembered next use lies farthest in the future.
+  void set_pending_next_use(uint64_t t) { pending_next_use_ = t; }
+
   // Performance: disable 3C miss classification for faster simulation
-  void set_track_3c_misses(bool enable) { track_3c_misses_ = enable; }
+  // (re-selects the specialized access kernel)
+  void set_track_3c_misses(bool enable) {
+    track_3c_misses_ = enable;
+    select_access_kernel();
+  }
   [[nodiscard]] bool is_tracking_3c_misses() const { return track_3c_misses_; }
 
+  // Resize the compulsory-miss filter for a different false-positive rate
+  void set_classifier_fp_rate(double fp_rate) {
+    ever_accessed.configure(BloomFilter::DEFAULT_EXPECTED_ITEMS, fp_rate);
+  }
+  [[nodiscard]] const BloomFilter &get_classifier() const { return ever_accessed; }
+
   AccessInfo access(uint64_t address, bool is_write);
   AccessInfo install(uint64_t address, bool is_dirty = false);
+
+  // Bulk-sweep kernel: one access that the caller has proven is a miss
+  // (the line is absent and the sweep touches it exactly once), so the
+  // tag search and hit paths are skipped entirely - victim selection,
+  // install and the miss stats are all that remains. Only valid under
+  // CacheSystem::bulk_sweep()'s preconditions; not for OPT, which needs
+  // the oracle's per-access next-use stamp.
+  AccessInfo sweep_install(uint64_t address, bool is_write);
+
+  // Whether any resident line falls inside [base_addr, base_addr +
+  // line_count * line_size). O(capacity) scan, used to guard bulk sweeps.
+  [[nodiscard]] bool overlaps_range(uint64_t base_addr,
+                                    uint64_t line_count) const;
   AccessInfo install_with_state(uint64_t address, CoherenceState state);
   bool is_present(uint64_t address) const;
   void invalidate(uint64_t address);
   bool is_dirty(uint64_t address) const;
   bool get_line_for_writeback(uint64_t address, bool &was_dirty);
-  std::vector<uint64_t> get_all_addresses() const;
   [[nodiscard]] bool probe(uint64_t address) const { return is_present(address); }
 
-  // Get full cache state for visualization
-  [[nodiscard]] const std::vector<std::vector<CacheLine>>& get_sets() const { return sets; }
+  // Get one line's state for visualization
+  [[nodiscard]] CacheLineView get_line(int set, int way) const {
+    size_t i = set_base(set) + way;
+    return {line_tag(i), line_valid(i), line_dirty(i), line_coherence(i)};
+  }
+
+  // Checkpointing: serialize/restore every line, the replacement
+  // metadata, accumulated stats and the 3C classifier (Checkpoint.hpp).
+  // load_state() verifies the stored geometry against this level's config.
+  void save_state(CheckpointWriter &w) const;
+  void load_state(CheckpointReader &r);
 
   // MESI coherence state management
   [[nodiscard]] CoherenceState get_coherence_state(uint64_t address) const;
@@ -51,6 +51,18 @@ struct CacheStats {
     conflict_misses = 0;
   }
 
+  // Extrapolate counts from a sampled run back to the full cache
+  // (--sample-sets); rates are ratios and stay unbiased
+  void scale(uint64_t factor) {
+    hits *= factor;
+    misses *= factor;
+    writebacks *= factor;
+    invalidations *= factor;
+    compulsory_misses *= factor;
+    capacity_misses *= factor;
+    conflict_misses *= factor;
+  }
+
   CacheStats& operator+=(const CacheStats& other) {
     hits += other.hits;
     misses += other.misses;
@@ -61,7 +73,35 @@ struct CacheStats {
     conflict_misses += other.conflict_misses;
     return *this;
   }
+
+  bool operator==(const CacheStats& other) const {
+    return hits == other.hits && misses == other.misses &&
+           writebacks == other.writebacks &&
+           invalidations == other.invalidations &&
+           compulsory_misses == other.compulsory_misses &&
+           capacity_misses == other.capacity_misses &&
+           conflict_misses == other.conflict_misses;
+  }
+};
+
+// Live counter slab for a level owned by one simulated core. The parallel
+// epoch engine has each worker bump its own core's counters with plain
+// stores - no atomics - which is only safe if no two cores' counters ever
+// share a hardware cache line. The alignment pads the slab out to whole
+// lines, so adjacent slabs (or whatever member the owning object declares
+// next) cannot false-share with it - a hazard this tool exists to report,
+// not exhibit. get_stats() merges slabs into plain CacheStats snapshots;
+// only live, worker-updated counters need the aligned form.
+struct alignas(64) AlignedCacheStats : CacheStats {
+  AlignedCacheStats() = default;
+  AlignedCacheStats(const CacheStats &s) : CacheStats(s) {}
+  AlignedCacheStats &operator=(const CacheStats &s) {
+    CacheStats::operator=(s);
+    return *this;
+  }
 };
+static_assert(sizeof(AlignedCacheStats) % 64 == 0,
+              "slab must cover whole cache lines");
 
 // Timing statistics for cycle-level analysis
 struct TimingStats {
@@ -72,6 +112,30 @@ struct TimingStats {
   uint64_t memory_cycles = 0;         // Cycles from memory accesses
   uint64_t tlb_miss_cycles = 0;       // Additional cycles from TLB misses
 
+  // MSHR / memory-level-parallelism accounting (see MSHR.hpp)
+  uint64_t serialized_miss_cycles = 0; // Sum of miss latencies, no overlap
+  uint64_t overlapped_miss_cycles = 0; // Union of miss busy intervals
+  uint64_t mshr_merges = 0;            // Misses folded into in-flight lines
+  uint64_t mshr_full_stalls = 0;       // Misses that waited for a free MSHR
+  uint64_t mshr_stall_cycles = 0;      // Cycles lost to full-MSHR waits
+
+  // Writeback buffer accounting (see WritebackBuffer.hpp)
+  uint64_t writebacks_drained = 0;      // Dirty evictions a buffer accepted
+  uint64_t writebacks_coalesced = 0;    // Repeats folded into draining entries
+  uint64_t writeback_full_stalls = 0;   // Evictions that waited for a slot
+  uint64_t writeback_stall_cycles = 0;  // Cycles lost to full-buffer waits
+
+  // DRAM row-buffer accounting (see DramModel.hpp)
+  uint64_t dram_row_hits = 0;          // Open-row accesses (CAS only)
+  uint64_t dram_row_empty = 0;         // Closed bank, activate needed
+  uint64_t dram_row_conflicts = 0;     // Wrong row open, precharge needed
+  uint64_t dram_cycles = 0;            // Sum of row-aware DRAM latencies
+
+  // Page-walk accounting behind the STLB (see PageWalker.hpp)
+  uint64_t page_walks = 0;             // Full walks after L1 TLB + STLB miss
+  uint64_t page_walk_cycles = 0;       // Cycles spent fetching PTEs
+  uint64_t pwc_skipped_levels = 0;     // Walk levels served by paging caches
+
   [[nodiscard]] constexpr double average_access_latency(uint64_t total_accesses) const noexcept {
     if (total_accesses == 0) return 0.0;
     return static_cast<double>(total_cycles) / total_accesses;
@@ -84,6 +148,49 @@ struct TimingStats {
     l3_hit_cycles = 0;
     memory_cycles = 0;
     tlb_miss_cycles = 0;
+    serialized_miss_cycles = 0;
+    overlapped_miss_cycles = 0;
+    mshr_merges = 0;
+    mshr_full_stalls = 0;
+    mshr_stall_cycles = 0;
+    writebacks_drained = 0;
+    writebacks_coalesced = 0;
+    writeback_full_stalls = 0;
+    writeback_stall_cycles = 0;
+    dram_row_hits = 0;
+    dram_row_empty = 0;
+    dram_row_conflicts = 0;
+    dram_cycles = 0;
+    page_walks = 0;
+    page_walk_cycles = 0;
+    pwc_skipped_levels = 0;
+  }
+
+  // Every counter here is additive per access, so sampled-run
+  // extrapolation is a straight multiply (--sample-sets)
+  void scale(uint64_t factor) {
+    total_cycles *= factor;
+    l1_hit_cycles *= factor;
+    l2_hit_cycles *= factor;
+    l3_hit_cycles *= factor;
+    memory_cycles *= factor;
+    tlb_miss_cycles *= factor;
+    serialized_miss_cycles *= factor;
+    overlapped_miss_cycles *= factor;
+    mshr_merges *= factor;
+    mshr_full_stalls *= factor;
+    mshr_stall_cycles *= factor;
+    writebacks_drained *= factor;
+    writebacks_coalesced *= factor;
+    writeback_full_stalls *= factor;
+    writeback_stall_cycles *= factor;
+    dram_row_hits *= factor;
+    dram_row_empty *= factor;
+    dram_row_conflicts *= factor;
+    dram_cycles *= factor;
+    page_walks *= factor;
+    page_walk_cycles *= factor;
+    pwc_skipped_levels *= factor;
   }
 
   TimingStats& operator+=(const TimingStats& other) {
@@ -93,6 +200,118 @@ struct TimingStats {
     l3_hit_cycles += other.l3_hit_cycles;
     memory_cycles += other.memory_cycles;
     tlb_miss_cycles += other.tlb_miss_cycles;
+    serialized_miss_cycles += other.serialized_miss_cycles;
+    overlapped_miss_cycles += other.overlapped_miss_cycles;
+    mshr_merges += other.mshr_merges;
+    mshr_full_stalls += other.mshr_full_stalls;
+    mshr_stall_cycles += other.mshr_stall_cycles;
+    writebacks_drained += other.writebacks_drained;
+    writebacks_coalesced += other.writebacks_coalesced;
+    writeback_full_stalls += other.writeback_full_stalls;
+    writeback_stall_cycles += other.writeback_stall_cycles;
+    dram_row_hits += other.dram_row_hits;
+    dram_row_empty += other.dram_row_empty;
+    dram_row_conflicts += other.dram_row_conflicts;
+    dram_cycles += other.dram_cycles;
+    page_walks += other.page_walks;
+    page_walk_cycles += other.page_walk_cycles;
+    pwc_skipped_levels += other.pwc_skipped_levels;
+    return *this;
+  }
+
+  bool operator==(const TimingStats& other) const {
+    return total_cycles == other.total_cycles &&
+           l1_hit_cycles == other.l1_hit_cycles &&
+           l2_hit_cycles == other.l2_hit_cycles &&
+           l3_hit_cycles == other.l3_hit_cycles &&
+           memory_cycles == other.memory_cycles &&
+           tlb_miss_cycles == other.tlb_miss_cycles &&
+           serialized_miss_cycles == other.serialized_miss_cycles &&
+           overlapped_miss_cycles == other.overlapped_miss_cycles &&
+           mshr_merges == other.mshr_merges &&
+           mshr_full_stalls == other.mshr_full_stalls &&
+           mshr_stall_cycles == other.mshr_stall_cycles &&
+           writebacks_drained == other.writebacks_drained &&
+           writebacks_coalesced == other.writebacks_coalesced &&
+           writeback_full_stalls == other.writeback_full_stalls &&
+           writeback_stall_cycles == other.writeback_stall_cycles &&
+           dram_row_hits == other.dram_row_hits &&
+           dram_row_empty == other.dram_row_empty &&
+           dram_row_conflicts == other.dram_row_conflicts &&
+           dram_cycles == other.dram_cycles &&
+           page_walks == other.page_walks &&
+           page_walk_cycles == other.page_walk_cycles &&
+           pwc_skipped_levels == other.pwc_skipped_levels;
+  }
+};
+
+// L1 victim buffer (Jouppi) statistics - probed on every L1 miss
+struct VictimStats {
+  uint64_t probes = 0;      // L1 misses that checked the buffer
+  uint64_t hits = 0;        // Misses absorbed without an L2 round trip
+  uint64_t insertions = 0;  // L1 victims parked in the buffer
+  uint64_t writebacks = 0;  // Dirty lines pushed out of the buffer
+
+  [[nodiscard]] constexpr double hit_rate() const noexcept {
+    if (probes == 0) return 0.0;
+    return static_cast<double>(hits) / probes;
+  }
+
+  void reset() {
+    probes = 0;
+    hits = 0;
+    insertions = 0;
+    writebacks = 0;
+  }
+
+  void scale(uint64_t factor) {
+    probes *= factor;
+    hits *= factor;
+    insertions *= factor;
+    writebacks *= factor;
+  }
+
+  VictimStats& operator+=(const VictimStats& other) {
+    probes += other.probes;
+    hits += other.hits;
+    insertions += other.insertions;
+    writebacks += other.writebacks;
+    return *this;
+  }
+};
+
+// Bytes moved across each hierarchy link - fills and writebacks, demand
+// and prefetch alike. Divided by the simulated cycle count these become
+// achieved bandwidths, which the roofline report holds against the
+// preset's configured peaks (see BandwidthConfig) to tell a
+// latency-bound run from a bandwidth-saturated one.
+struct BandwidthStats {
+  uint64_t l1_l2_bytes = 0;   // L1 fills from L2 + L1 writebacks
+  uint64_t l2_l3_bytes = 0;   // L2 fills from L3 + L2 writebacks
+  uint64_t l3_mem_bytes = 0;  // memory-side fills + writebacks (L2's own
+                              // in hierarchies without an L3)
+
+  [[nodiscard]] static constexpr double
+  bytes_per_cycle(uint64_t bytes, uint64_t cycles) noexcept {
+    return cycles ? static_cast<double>(bytes) / cycles : 0.0;
+  }
+
+  void reset() {
+    l1_l2_bytes = 0;
+    l2_l3_bytes = 0;
+    l3_mem_bytes = 0;
+  }
+
+  void scale(uint64_t factor) {
+    l1_l2_bytes *= factor;
+    l2_l3_bytes *= factor;
+    l3_mem_bytes *= factor;
+  }
+
+  BandwidthStats& operator+=(const BandwidthStats& other) {
+    l1_l2_bytes += other.l1_l2_bytes;
+    l2_l3_bytes += other.l2_l3_bytes;
+    l3_mem_bytes += other.l3_mem_bytes;
     return *this;
   }
 };
@@ -102,7 +321,9 @@ struct HierarchyStats {
   CacheStats l1i;
   CacheStats l2;
   CacheStats l3;
-  TimingStats timing;  // Cycle-level timing statistics
+  TimingStats timing;        // Cycle-level timing statistics
+  VictimStats victim;        // L1 victim buffer (zero when disabled)
+  BandwidthStats bandwidth;  // Bytes moved per hierarchy link
 
   void reset() {
     l1d.reset();
@@ -110,5 +331,19 @@ struct HierarchyStats {
     l2.reset();
     l3.reset();
     timing.reset();
+    victim.reset();
+    bandwidth.reset();
+  }
+
+  // Extrapolate a set-sampled run (--sample-sets) back to the full
+  // hierarchy: every component counter is additive per access
+  void scale(uint64_t factor) {
+    l1d.scale(factor);
+    l1i.scale(factor);
+    l2.scale(factor);
+    l3.scale(factor);
+    timing.scale(factor);
+    victim.scale(factor);
+    bandwidth.scale(factor);
   }
 };
@@ -1,14 +1,25 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "../profiles/CacheConfig.hpp"
+#include "BranchTargetBuffer.hpp"
 #include "CacheLevel.hpp"
 #include "CacheStats.hpp"
+#include "CompressedCacheModel.hpp"
+#include "DramModel.hpp"
 #include "InclusionPolicy.hpp"
+#include "LatencyHistogram.hpp"
+#include "MSHR.hpp"
+#include "PageAllocator.hpp"
+#include "PageWalker.hpp"
 #include "Prefetcher.hpp"
 #include "TLB.hpp"
+#include "VictimCache.hpp"
+#include "WritebackBuffer.hpp"
 
 enum class AccessType { Read, Write, InstructionFetch };
 
@@ -33,19 +44,59 @@ private:
   std::optional<CacheLevel> l3_;  // Optional L3 (some CPUs like RPi4 don't have L3)
   TLB dtlb;  // Data TLB
   TLB itlb;  // Instruction TLB
+  TLB stlb;  // Unified second-level TLB behind both L1 TLBs
+  PageWalker walker;             // Page-table walker with paging caches
+  bool walk_injection = false;   // Send PTE fetches through the caches
+  PageAllocator page_alloc;      // Optional virtual->physical layer
   Prefetcher prefetcher;
   bool prefetch_enabled;
   bool tlb_enabled;
   std::unordered_set<uint64_t> prefetched_addresses;  // Track prefetched lines
   LatencyConfig latency_config;  // Timing configuration
   TimingStats timing_stats;      // Accumulated timing statistics
+  LatencyHistogram latency_hist_;  // Per-access latency distribution
+  BandwidthStats bw_stats;       // Bytes moved per hierarchy link
+  MSHRSet mshrs;                 // Overlapped-miss (MLP) accounting
+  uint64_t issue_clock = 0;      // Virtual issue time for the MSHR model
+  DramModel dram;                // Row-buffer model behind the L3
+  VictimCache victim_cache;      // Optional Jouppi buffer between L1 and L2
+  WritebackBuffer wb_l1;         // Dirty-eviction drain accounting per level
+  WritebackBuffer wb_l2;
+  WritebackBuffer wb_l3;
 
-  void handle_inclusive_eviction(uint64_t evicted_addr, CacheLevel &from_level);
+  // Front-end sequencing for instruction fetches: a fetch that continues
+  // neither the previous fetch line nor the next sequential line is a
+  // taken branch, and its target goes through the BTB (see
+  // BranchTargetBuffer.hpp). Only meaningful when the trace carries real
+  // post-layout block addresses.
+  BranchTargetBuffer btb;
+  uint64_t last_fetch_addr = 0;  // Previous fetch's line address
+  uint64_t last_fetch_end = 0;   // First address past the previous fetch line
+
+  // Optional compressed-L3 what-if shadow, fed the same demand stream
+  // the real L3 sees (see CompressedCacheModel.hpp)
+  std::optional<CompressedCacheModel> l3_compress_;
+
+  // Reverse index for inclusive back-invalidation: per-line bitmap of the
+  // upper levels that may still hold a line, so an L3 victim only probes
+  // the levels it could actually live in instead of all three. Like the
+  // coherence controller's sharer bitmaps this over-approximates - bits
+  // are set on fill and only dropped when the victim is handled - which
+  // is safe because invalidating an absent line is a no-op.
+  static constexpr uint8_t PRESENT_L1D = 1;
+  static constexpr uint8_t PRESENT_L1I = 2;
+  static constexpr uint8_t PRESENT_L2 = 4;
+  std::unordered_map<uint64_t, uint8_t> upper_presence;
+
+  void note_fill(uint64_t line_addr, uint8_t level_bit);
+  void back_invalidate(uint64_t line_addr);
   void handle_exclusive_eviction(uint64_t evicted_addr, CacheLevel &from_level,
                                   CacheLevel &to_level, bool was_dirty);
   SystemAccessResult access_hierarchy(uint64_t address, bool is_write,
                                        CacheLevel &l1, TLB &tlb, uint64_t pc = 0);
   void issue_prefetches(const std::vector<uint64_t> &addrs);
+  uint64_t translate(uint64_t address, TLB &tlb, SystemAccessResult &result);
+  uint64_t walk_fetch(uint64_t pte_addr, SystemAccessResult &result);
 
   // Helper to check if L3 exists
   [[nodiscard]] bool has_l3() const { return l3_.has_value(); }
@@ -57,23 +108,147 @@ public:
         l3_(cfg.l3.is_valid() ? std::optional<CacheLevel>(cfg.l3) : std::nullopt),
         dtlb(TLBConfig{64, 4, 4096}),   // 64-entry, 4-way, 4KB pages
         itlb(TLBConfig{64, 4, 4096}),   // 64-entry, 4-way, 4KB pages
+        stlb(TLBConfig{1536, 8, 4096}), // Unified STLB, Alder-Lake-sized
         prefetcher(PrefetchPolicy::NONE, 2, cfg.l1_data.line_size),
         prefetch_enabled(false), tlb_enabled(true),
-        latency_config(cfg.latency), timing_stats() {}
+        latency_config(cfg.latency), timing_stats(),
+        mshrs(cfg.latency.mshr_entries), dram(cfg.dram),
+        wb_l1(cfg.latency.writeback_entries),
+        wb_l2(cfg.latency.writeback_entries),
+        wb_l3(cfg.latency.writeback_entries) {}
+
+  // OPT analysis: forward the oracle's next-use time for the upcoming
+  // access to every data level (the global next-use order is the oracle
+  // for the whole hierarchy)
+  void set_pending_next_use(uint64_t t) {
+    l1d.set_pending_next_use(t);
+    l2.set_pending_next_use(t);
+    if (l3_.has_value()) {
+      l3_->set_pending_next_use(t);
+    }
+  }
 
   SystemAccessResult read(uint64_t address, uint64_t pc = 0);
   SystemAccessResult write(uint64_t address, uint64_t pc = 0);
   SystemAccessResult fetch(uint64_t address, uint64_t pc = 0);
 
+  // Bulk-intrinsic fast path: account a sequential sweep over
+  // [base_addr, base_addr + size) as if every line had gone through
+  // read()/write(), without the per-line tag searches. Every line of a
+  // fresh sweep misses all the way to memory, so the hierarchy side
+  // reduces to guaranteed-miss installs (CacheLevel::sweep_install) and
+  // the small timing models (TLB, MSHRs, DRAM, writeback buffers) are
+  // replayed against the same virtual clock - the resulting stats and
+  // cache state are identical to the per-line path, not an estimate.
+  // Returns false without touching anything when a precondition fails
+  // (short range, a range line already resident, or a side model whose
+  // per-access behavior the sweep cannot reproduce); the caller then
+  // falls back to per-line simulation.
+  bool bulk_sweep(uint64_t base_addr, uint64_t size, bool is_write);
+
+  // Below this many lines a range takes the normal per-line path
+  static constexpr uint64_t BULK_SWEEP_MIN_LINES = 4096;
+
   // Prefetching control
   void enable_prefetching(PrefetchPolicy policy, int degree = 2);
   void disable_prefetching();
   [[nodiscard]] bool is_prefetching_enabled() const { return prefetch_enabled; }
   [[nodiscard]] const PrefetchStats &get_prefetch_stats() const { return prefetcher.get_stats(); }
+  void enable_prefetch_throttling() { prefetcher.enable_throttling(); }
+  [[nodiscard]] const Prefetcher &get_prefetcher() const { return prefetcher; }
+
+  // Size the fully-associative L1 victim buffer (0 disables it)
+  void enable_victim_cache(size_t entries) { victim_cache = VictimCache(entries); }
+  [[nodiscard]] bool has_victim_cache() const { return victim_cache.is_enabled(); }
+  [[nodiscard]] const VictimCache &get_victim_cache() const { return victim_cache; }
+
+  // Run the compressed-L3 shadow beside the real L3 (no-op without one)
+  void enable_l3_compression(const CompressionConfig &comp) {
+    if (has_l3()) {
+      l3_compress_.emplace(l3_->get_config(), comp);
+    }
+  }
+  [[nodiscard]] bool has_l3_compression() const {
+    return l3_compress_.has_value();
+  }
+  [[nodiscard]] const CompressedCacheModel &get_l3_compression() const {
+    return *l3_compress_;
+  }
 
   [[nodiscard]] HierarchyStats get_stats() const;
   void reset_stats();
 
+  // Stats-only reset across every component - levels, TLBs, prefetcher,
+  // timing - leaving all contents warm (warmup fast-forward boundary)
+  void reset_all_stats() {
+    reset_stats();
+    dtlb.reset_stats();
+    itlb.reset_stats();
+    stlb.reset_stats();
+    prefetcher.reset_stats();
+  }
+
+  // Checkpointing: serialize/restore the whole hierarchy's warm state -
+  // every level, the TLBs and page walker, the prefetcher, the timing
+  // side models and the accumulated stats (see Checkpoint.hpp)
+  void save_state(CheckpointWriter &w) const;
+  void load_state(CheckpointReader &r);
+
+  // Drop all cache/TLB/prefetcher state, returning to the
+  // freshly-constructed hierarchy (daemon job reuse)
+  void clear() {
+    l1d.clear();
+    l1i.clear();
+    l2.clear();
+    if (l3_.has_value()) {
+      l3_->clear();
+    }
+    dtlb.flush();
+    dtlb.reset_stats();
+    itlb.flush();
+    itlb.reset_stats();
+    stlb.flush();
+    stlb.reset_stats();
+    walker.clear();
+    page_alloc.clear();
+    prefetcher.clear();
+    prefetch_enabled = false;
+    prefetched_addresses.clear();
+    upper_presence.clear();
+    victim_cache.clear();
+    timing_stats.reset();
+    mshrs.clear();
+    issue_clock = 0;
+    dram.clear();
+    wb_l1.clear();
+    wb_l2.clear();
+    wb_l3.clear();
+    btb.flush();
+    btb.reset_stats();
+    last_fetch_addr = 0;
+    last_fetch_end = 0;
+    if (l3_compress_.has_value()) {
+      l3_compress_->clear();
+    }
+  }
+
+  // Apply a memoized stats delta without simulating (segment caching)
+  void apply_stats_delta(const HierarchyStats &delta, const TLBStats &dtlb_delta,
+                         const TLBStats &itlb_delta,
+                         const TLBStats &stlb_delta = {}) {
+    l1d.add_stats(delta.l1d);
+    l1i.add_stats(delta.l1i);
+    l2.add_stats(delta.l2);
+    if (l3_.has_value()) {
+      l3_->add_stats(delta.l3);
+    }
+    timing_stats += delta.timing;
+    victim_cache.add_stats(delta.victim);
+    dtlb.add_stats(dtlb_delta);
+    itlb.add_stats(itlb_delta);
+    stlb.add_stats(stlb_delta);
+  }
+
   [[nodiscard]] const CacheLevel &get_l1d() const { return l1d; }
   [[nodiscard]] const CacheLevel &get_l1i() const { return l1i; }
   [[nodiscard]] const CacheLevel &get_l2() const { return l2; }
@@ -82,9 +257,56 @@ public:
   // TLB access
   [[nodiscard]] const TLB &get_dtlb() const { return dtlb; }
   [[nodiscard]] const TLB &get_itlb() const { return itlb; }
+  [[nodiscard]] const TLB &get_stlb() const { return stlb; }
   [[nodiscard]] TLBHierarchyStats get_tlb_stats() const {
-    return {dtlb.get_stats(), itlb.get_stats(), {}};
+    return {dtlb.get_stats(), itlb.get_stats(), stlb.get_stats()};
+  }
+
+  // Front-end branch-target stats accumulated by fetch()
+  [[nodiscard]] const BranchTargetBuffer &get_btb() const { return btb; }
+  [[nodiscard]] const BTBStats &get_btb_stats() const {
+    return btb.get_stats();
+  }
+  // Back all mappings with huge pages: fewer but larger TLB entries
+  // (real chips keep separate, smaller arrays for huge translations)
+  // and a shorter page-table walk. Pass 4096 to return to 4KB pages.
+  void set_page_size(size_t page_size) {
+    if (page_size == (1ULL << 30)) {
+      dtlb = TLB(TLBConfig{8, 4, page_size});
+      itlb = TLB(TLBConfig{8, 4, page_size});
+      stlb = TLB(TLBConfig{1024, 8, page_size});
+      walker.set_levels(2);
+    } else if (page_size == (2ULL << 20)) {
+      dtlb = TLB(TLBConfig{32, 4, page_size});
+      itlb = TLB(TLBConfig{32, 4, page_size});
+      stlb = TLB(TLBConfig{1024, 8, page_size});
+      walker.set_levels(3);
+    } else {
+      dtlb = TLB(TLBConfig{64, 4, 4096});
+      itlb = TLB(TLBConfig{64, 4, 4096});
+      stlb = TLB(TLBConfig{1536, 8, 4096});
+      walker.set_levels(PageWalker::LEVELS);
+    }
   }
+  [[nodiscard]] size_t get_page_size() const { return dtlb.get_config().page_size; }
+
+  // Route page-walk PTE fetches through L2/L3/DRAM instead of charging
+  // a flat per-PTE cost
+  void set_walk_injection(bool enable) { walk_injection = enable; }
+  [[nodiscard]] bool is_walk_injection_enabled() const { return walk_injection; }
+
+  // Virtual->physical page allocation for the physically-indexed levels
+  // (see PageAllocator.hpp). Color count derives from the lowest level's
+  // geometry: how many pages tile one pass through its sets. Call after
+  // set_page_size - the allocator snapshots the page size.
+  void enable_page_allocation(PageAllocPolicy policy, uint64_t seed) {
+    const CacheLevel &lowest = l3_.has_value() ? *l3_ : l2;
+    uint64_t span = static_cast<uint64_t>(lowest.get_num_sets()) *
+                    static_cast<uint64_t>(lowest.get_line_size());
+    uint64_t page = get_page_size();
+    page_alloc.configure(policy, seed, page, span > page ? span / page : 1);
+  }
+  [[nodiscard]] const PageAllocator &get_page_allocator() const { return page_alloc; }
   void enable_tlb() { tlb_enabled = true; }
   void disable_tlb() { tlb_enabled = false; }
   [[nodiscard]] bool is_tlb_enabled() const { return tlb_enabled; }
@@ -94,7 +316,11 @@ public:
 
   // Timing stats access
   [[nodiscard]] const TimingStats& get_timing_stats() const { return timing_stats; }
+  // Per-access latency distribution behind avgLatency (every demand
+  // read/write/fetch records its charged cycles, including TLB extra)
+  [[nodiscard]] const LatencyHistogram& get_latency_histogram() const { return latency_hist_; }
   [[nodiscard]] const LatencyConfig& get_latency_config() const { return latency_config; }
+  [[nodiscard]] const DramConfig& get_dram_config() const { return dram.config(); }
   void set_latency_config(const LatencyConfig& cfg) { latency_config = cfg; }
 
   // Fast mode: disable expensive 3C miss classification for performance
@@ -106,4 +332,29 @@ public:
       l3_->set_track_3c_misses(!enable);
     }
   }
+
+  // 3C classification Bloom filter: target false-positive rate and health
+  void set_classifier_fp_rate(double fp_rate) {
+    l1d.set_classifier_fp_rate(fp_rate);
+    l1i.set_classifier_fp_rate(fp_rate);
+    l2.set_classifier_fp_rate(fp_rate);
+    if (l3_.has_value()) {
+      l3_->set_classifier_fp_rate(fp_rate);
+    }
+  }
+
+  [[nodiscard]] ClassifierSummary get_classifier_summary() const {
+    ClassifierSummary s;
+    s.fp_rate = l1d.get_classifier().configured_fp_rate();
+    const CacheLevel *levels[] = {&l1d, &l1i, &l2,
+                                  l3_.has_value() ? &*l3_ : nullptr};
+    for (const CacheLevel *level : levels) {
+      if (!level)
+        continue;
+      const BloomFilter &f = level->get_classifier();
+      s.estimated_fp_rate = std::max(s.estimated_fp_rate, f.estimated_fp_rate());
+      s.memory_bytes += f.memory_bytes();
+    }
+    return s;
+  }
 };
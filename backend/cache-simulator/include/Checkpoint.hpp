@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Versioned binary snapshot of the simulator's warm state
+// (--checkpoint-every / --restore).
+//
+// Long batch runs die to preemption and restart from zero; a snapshot of
+// the microarchitectural state - every cache line and its replacement
+// metadata, TLB entries, prefetcher tables, accumulated stats - lets a
+// restarted run skip straight to where the last one stopped, and lets
+// comparison-mode runs start from a warmed hierarchy instead of paying
+// the cold-start transient twice.
+//
+// Layout: 4-byte magic "CXCP" + uint32 version + uint64 event offset,
+// then each component's state in a fixed order. Values are host-format,
+// like the CXTB trace format: a checkpoint resumes runs on the machine
+// that wrote it, it is not a portable interchange file. Each component
+// embeds a geometry fingerprint that load verifies, so restoring under a
+// different preset or flag set fails loudly instead of silently
+// corrupting the simulation.
+
+constexpr char CHECKPOINT_MAGIC[4] = {'C', 'X', 'C', 'P'};
+// Version 2: CacheLevel stores one packed meta word per line instead of
+// separate tag/valid/dirty/rrip/coherence vectors
+// Version 3: CacheSystem state gains the per-link bandwidth counters
+// Version 4: packed line meta widens the coherence field to 3 bits
+// (MOESI/MESIF states), moving the RRIP bits down to 56-57
+// Version 5: CacheSystem state gains the BTB and front-end fetch sequencing
+// Version 6: CacheSystem state gains the compressed-L3 shadow (presence
+// flag plus model state when enabled)
+// Version 7: CacheSystem state gains the per-access latency histogram
+constexpr uint32_t CHECKPOINT_VERSION = 7;
+
+class CheckpointWriter {
+public:
+  explicit CheckpointWriter(std::ostream &out) : out_(out) {}
+
+  template <typename T> void write(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "checkpoint fields must be trivially copyable");
+    out_.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  // Length-prefixed vector of trivially copyable elements
+  template <typename T> void write_vec(const std::vector<T> &v) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "checkpoint fields must be trivially copyable");
+    write<uint64_t>(v.size());
+    if (!v.empty()) {
+      out_.write(reinterpret_cast<const char *>(v.data()),
+                 static_cast<std::streamsize>(v.size() * sizeof(T)));
+    }
+  }
+
+  // Length-prefixed set/map contents (element order is not preserved,
+  // which is fine - hash containers rebuild their own layout on load)
+  template <typename Set> void write_set(const Set &s) {
+    write<uint64_t>(s.size());
+    for (const auto &value : s)
+      write(value);
+  }
+
+  template <typename Map> void write_map(const Map &m) {
+    write<uint64_t>(m.size());
+    for (const auto &[key, value] : m) {
+      write(key);
+      write(value);
+    }
+  }
+
+  // The stream only reports failure lazily; check once after the last write
+  [[nodiscard]] bool ok() const { return static_cast<bool>(out_); }
+
+private:
+  std::ostream &out_;
+};
+
+class CheckpointReader {
+public:
+  explicit CheckpointReader(std::istream &in) : in_(in) {}
+
+  template <typename T> [[nodiscard]] T read() {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "checkpoint fields must be trivially copyable");
+    T value{};
+    in_.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!in_)
+      throw std::runtime_error("checkpoint truncated or unreadable");
+    return value;
+  }
+
+  template <typename T> void read_vec(std::vector<T> &v) {
+    uint64_t n = read<uint64_t>();
+    v.resize(n);
+    if (n > 0) {
+      in_.read(reinterpret_cast<char *>(v.data()),
+               static_cast<std::streamsize>(n * sizeof(T)));
+      if (!in_)
+        throw std::runtime_error("checkpoint truncated or unreadable");
+    }
+  }
+
+  // For vectors whose size is fixed by the configuration (cache arrays,
+  // DRAM banks): the stored size must match the live one
+  template <typename T> void read_vec_expect(std::vector<T> &v, const char *what) {
+    size_t expected = v.size();
+    read_vec(v);
+    if (v.size() != expected)
+      mismatch(what);
+  }
+
+  template <typename Set> void read_set(Set &s) {
+    uint64_t n = read<uint64_t>();
+    s.clear();
+    for (uint64_t i = 0; i < n; i++)
+      s.insert(read<typename Set::value_type>());
+  }
+
+  template <typename Map> void read_map(Map &m) {
+    uint64_t n = read<uint64_t>();
+    m.clear();
+    for (uint64_t i = 0; i < n; i++) {
+      auto key = read<typename Map::key_type>();
+      m[key] = read<typename Map::mapped_type>();
+    }
+  }
+
+  // Geometry fingerprint check: the stored value must match what the
+  // current run is configured with
+  template <typename T> void expect(T expected, const char *what) {
+    if (read<T>() != expected)
+      mismatch(what);
+  }
+
+  [[noreturn]] static void mismatch(const char *what) {
+    throw std::runtime_error(std::string("checkpoint mismatch: ") + what +
+                             " differs from the current configuration");
+  }
+
+private:
+  std::istream &in_;
+};
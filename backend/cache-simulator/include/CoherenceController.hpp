@@ -20,17 +20,72 @@ struct CoherenceEvent {
   int source_core;
 };
 
+// How coherence metadata is organized:
+//   Snoop     - single-word sharer bitmap per line (up to 64 cores)
+//   Directory - multi-word sharer bitmaps sharded across address-interleaved
+//               home nodes, for large core counts (64-128+)
+//   Auto      - Snoop up to 64 cores, Directory beyond
+enum class CoherenceMode { Auto, Snoop, Directory };
+
 class CoherenceController {
 private:
   int num_cores;
+  CoherenceMode mode;
+  CoherenceProtocol protocol;
   std::vector<CacheLevel *> l1_caches;
 
-  // Directory: tracks which cores have each line
-  std::unordered_map<uint64_t, std::vector<int>> sharers;
-  std::unordered_map<uint64_t, int> owner;
+  // Protocol-specific traffic counters (see getters below)
+  uint64_t snoop_writebacks = 0;
+  uint64_t dirty_shares = 0;
+  uint64_t forwards = 0;
+
+  // Snoop filter (Snoop mode): per-line bitmap of cores that may hold the
+  // line (bit i = core i, so up to 64 cores). Bits are set on every install
+  // and cleared on invalidation; silent L1 evictions leave stale bits that
+  // are scrubbed lazily the next time the line is snooped. The bitmap
+  // therefore over-approximates the true sharer set - safe for coherence -
+  // and lets a miss probe only the cores whose bits are set instead of all
+  // peers.
+  std::unordered_map<uint64_t, uint64_t> sharers;
+
+  // Directory (Directory mode): same over-approximating sharer bitmaps,
+  // widened to (num_cores+63)/64 words per line and sharded across
+  // address-interleaved home nodes the way a distributed directory spreads
+  // its entries. Sharding keeps any one hash table small at 128-core scale;
+  // home_node() picks the shard.
+  int dir_words = 0;
+  std::vector<std::unordered_map<uint64_t, std::vector<uint64_t>>> dir_shards;
+
+  // Bit for a single core within one bitmap word
+  static uint64_t core_bit(int core_id) { return 1ULL << (core_id & 63); }
+
+  // Address-interleaved home node owning a line's directory entry
+  [[nodiscard]] int home_node(uint64_t address) const {
+    return static_cast<int>((address >> 6) % dir_shards.size());
+  }
+
+  // Directory entry for a line, created zeroed on first touch
+  std::vector<uint64_t> &dir_entry(uint64_t address);
+
+  SnoopResult request_read_dir(int requesting_core, uint64_t address);
+  SnoopResult request_exclusive_dir(int requesting_core, uint64_t address);
 
 public:
-  explicit CoherenceController(int cores);
+  explicit CoherenceController(int cores,
+                               CoherenceMode mode = CoherenceMode::Auto,
+                               CoherenceProtocol protocol = CoherenceProtocol::MESI);
+
+  [[nodiscard]] CoherenceMode get_mode() const { return mode; }
+  [[nodiscard]] CoherenceProtocol get_protocol() const { return protocol; }
+
+  // MESI/MESIF: dirty lines written back to memory when a remote read
+  // downgraded their owner M -> S
+  [[nodiscard]] uint64_t get_snoop_writebacks() const { return snoop_writebacks; }
+  // MOESI: remote reads of a dirty line served cache-to-cache with the
+  // owner keeping it in Owned - each one is a memory writeback avoided
+  [[nodiscard]] uint64_t get_dirty_shares() const { return dirty_shares; }
+  // MESIF: clean lines supplied by the Forward copy instead of memory
+  [[nodiscard]] uint64_t get_forwards() const { return forwards; }
 
   void register_cache(int core_id, CacheLevel *cache);
 
@@ -40,11 +95,34 @@ public:
   // Called when a core wants exclusive access (write)
   SnoopResult request_exclusive(int requesting_core, uint64_t address);
 
+  // Register a line installed outside the read/write request path
+  // (e.g. prefetch) so the snoop filter stays inclusive
+  void add_sharer(int core_id, uint64_t address);
+
+  // True if any core other than core_id currently holds the line.
+  // Scrubs stale filter bits as a side effect, hence non-const.
+  [[nodiscard]] bool has_remote_sharers(int core_id, uint64_t address);
+
   // Detect false sharing: different cores accessing different bytes in same
   // line
   [[nodiscard]] bool detect_false_sharing(uint64_t address, int line_size);
 
   void evict_line(int core_id, uint64_t address);
 
+  // Commit a transition replayed from the cache system's coherence memo:
+  // the request was computed once by request_read()/request_exclusive()
+  // and its peer effects already applied, so only the filter word and
+  // traffic counters remain. Both request paths leave the filter fully
+  // scrubbed, which is why overwriting it here matches the slow path
+  // bit for bit. Snoop mode only - the memo is gated off under the
+  // directory.
+  void apply_memoized(uint64_t address, uint64_t sharer_bits,
+                      uint32_t writebacks, uint32_t shares, uint32_t fwds) {
+    sharers[address] = sharer_bits;
+    snoop_writebacks += writebacks;
+    dirty_shares += shares;
+    forwards += fwds;
+  }
+
   [[nodiscard]] int get_sharer_count(uint64_t address) const;
 };
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CoherenceState.hpp"
+
+// One memoized coherence transition: what a snoop request did to the
+// peers' copies of a line, given how those copies looked beforehand.
+//
+// The line's peer states pack into one word (a CoherenceState nibble per
+// core, Invalid = 0 for cores without a copy), and together with the
+// request type and requesting core they fully determine the outcome:
+// which peer supplied data, which counters ticked and what every peer's
+// state became. The line address itself does not participate - the same
+// snapshot replays identically for any line.
+struct CoherenceTransition {
+  uint64_t peer_states;      // packed peer nibbles before the request (key)
+  uint64_t new_peer_states;  // packed peer nibbles after it
+  uint8_t op_core;           // (exclusive << 7) | requesting core (key)
+  bool found;                // SnoopResult the request produced
+  bool was_modified;
+  uint8_t data_source_core;
+  uint8_t snoop_writebacks;  // coherence traffic the request charged
+  uint8_t dirty_shares;
+  uint8_t forwards;
+  bool valid = false;
+};
+
+struct CoherenceMemoStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t insertions = 0;
+};
+
+// Direct-mapped memo of coherence transitions, the multi-core sibling of
+// SegmentCache: producer-consumer traces bounce a handful of shared lines
+// through the same few MESI transition sequences millions of times, and
+// each repeat re-probes every candidate peer. Keyed by the packed state
+// snapshot, a hit skips the probe loop entirely - the cache system
+// replays the recorded peer effects and counter deltas instead.
+//
+// Collisions simply overwrite (the table is a cache of pure functions;
+// losing an entry only costs a recomputation), so there is no eviction
+// bookkeeping and lookups are one indexed load plus a key compare.
+class CoherenceMemo {
+public:
+  // Nibble packing caps the snapshot at 16 cores per word; larger systems
+  // fall back to the full controller path.
+  static constexpr int MAX_CORES = 16;
+  static constexpr size_t TABLE_SIZE = 1024;  // power of two, ~48KB
+
+  CoherenceMemo() : table_(TABLE_SIZE) {}
+
+  static uint64_t set_nibble(uint64_t packed, int core, CoherenceState state) {
+    int shift = core * 4;
+    return (packed & ~(0xFULL << shift)) |
+           (static_cast<uint64_t>(state) << shift);
+  }
+
+  static uint64_t clear_nibble(uint64_t packed, int core) {
+    return packed & ~(0xFULL << (core * 4));
+  }
+
+  static CoherenceState nibble_state(uint64_t packed, int core) {
+    return static_cast<CoherenceState>((packed >> (core * 4)) & 0xF);
+  }
+
+  // Sharer bitmap implied by a snapshot: one bit per non-Invalid nibble
+  static uint64_t present_mask(uint64_t packed) {
+    uint64_t mask = 0;
+    for (uint64_t rest = packed; rest; rest &= rest - 1) {
+      mask |= 1ULL << (__builtin_ctzll(rest) / 4);
+    }
+    return mask;
+  }
+
+  [[nodiscard]] const CoherenceTransition *lookup(uint64_t peer_states,
+                                                  bool exclusive, int core) {
+    uint8_t op_core = pack_op(exclusive, core);
+    const CoherenceTransition &entry = table_[slot_of(peer_states, op_core)];
+    if (entry.valid && entry.peer_states == peer_states &&
+        entry.op_core == op_core) {
+      stats_.hits++;
+      return &entry;
+    }
+    stats_.misses++;
+    return nullptr;
+  }
+
+  void insert(const CoherenceTransition &transition) {
+    table_[slot_of(transition.peer_states, transition.op_core)] = transition;
+    stats_.insertions++;
+  }
+
+  static uint8_t pack_op(bool exclusive, int core) {
+    return static_cast<uint8_t>((exclusive ? 0x80 : 0) | core);
+  }
+
+  [[nodiscard]] const CoherenceMemoStats &get_stats() const { return stats_; }
+
+private:
+  [[nodiscard]] static size_t slot_of(uint64_t peer_states, uint8_t op_core) {
+    uint64_t h = (peer_states ^ (static_cast<uint64_t>(op_core) << 56)) *
+                 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h >> 32) & (TABLE_SIZE - 1);
+  }
+
+  std::vector<CoherenceTransition> table_;
+  CoherenceMemoStats stats_;
+};
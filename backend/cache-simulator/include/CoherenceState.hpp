@@ -1,6 +1,15 @@
 #pragma once
 
-enum class CoherenceState { Invalid, Shared, Exclusive, Modified };
+// Per-line coherence states. MESI uses the first four; MOESI adds Owned
+// (dirty but shared - the owner supplies data and defers the memory
+// writeback to eviction) and MESIF adds Forward (clean shared copy
+// designated to answer requests cache-to-cache instead of memory).
+enum class CoherenceState { Invalid, Shared, Exclusive, Modified, Owned, Forward };
+
+// Which protocol the coherence controller speaks. The hardware presets
+// pick the vendor's protocol: AMD is MOESI, Intel is MESIF, everything
+// else defaults to plain MESI.
+enum class CoherenceProtocol { MESI, MOESI, MESIF };
 
 inline bool can_read(CoherenceState state) {
   return state != CoherenceState::Invalid;
@@ -11,5 +20,5 @@ inline bool can_write_silently(CoherenceState state) {
 }
 
 inline bool is_dirty_state(CoherenceState state) {
-  return state == CoherenceState::Modified;
+  return state == CoherenceState::Modified || state == CoherenceState::Owned;
 }
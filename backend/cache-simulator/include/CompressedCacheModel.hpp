@@ -0,0 +1,295 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../profiles/CacheConfig.hpp"
+#include "Checkpoint.hpp"
+
+// BDI (Base-Delta-Immediate) compressibility classes, sampled by the
+// runtime from a subset of stores and carried in the trace as Y records.
+// The classes are ordered from most to least compressible.
+enum : uint8_t {
+  BDI_ZEROS = 0,         // Line is all zero bytes
+  BDI_REPEATED = 1,      // One 8-byte value repeated across the line
+  BDI_BASE_DELTA = 2,    // 8-byte base, per-word deltas fit in 16 bits
+  BDI_UNCOMPRESSED = 3,  // None of the above
+};
+inline constexpr int BDI_CLASS_COUNT = 4;
+
+[[nodiscard]] inline const char *bdi_class_name(uint8_t cls) {
+  switch (cls) {
+    case BDI_ZEROS: return "zeros";
+    case BDI_REPEATED: return "repeated";
+    case BDI_BASE_DELTA: return "baseDelta";
+    default: return "uncompressed";
+  }
+}
+
+// Segment-rounded compressed size of one line for a BDI class. Real BDI
+// stores an all-zero line in the tag alone; we round every class up to
+// an 8-byte data segment boundary, scaled to the configured line size
+// (8/16/24/64 bytes for a 64B line).
+[[nodiscard]] inline uint32_t bdi_class_bytes(uint8_t cls, uint32_t line_size) {
+  switch (cls) {
+    case BDI_ZEROS: return line_size / 8;
+    case BDI_REPEATED: return line_size / 4;
+    case BDI_BASE_DELTA: return line_size * 3 / 8;
+    default: return line_size;
+  }
+}
+
+/**
+ * TraceCompressHints - registration table for sampled data-value
+ * compressibility hints carried in the trace (Y records).
+ *
+ * Same shape as TraceRegionMap: the parser registers hints as they
+ * arrive, and the compression model keeps a lock-free local snapshot it
+ * refreshes only when the version counter moves.
+ */
+class TraceCompressHints {
+public:
+  static TraceCompressHints &instance() {
+    static TraceCompressHints hints;
+    return hints;
+  }
+
+  void register_hint(uint64_t line_addr, uint8_t cls) {
+    std::unique_lock lock(mutex_);
+    hints_.emplace_back(line_addr, cls);
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  [[nodiscard]] uint64_t version() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::vector<std::pair<uint64_t, uint8_t>> snapshot() const {
+    std::shared_lock lock(mutex_);
+    return hints_;
+  }
+
+  void clear() {
+    std::unique_lock lock(mutex_);
+    hints_.clear();
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+private:
+  TraceCompressHints() = default;
+  mutable std::shared_mutex mutex_;
+  std::vector<std::pair<uint64_t, uint8_t>> hints_;
+  std::atomic<uint64_t> version_{0};
+};
+
+struct CompressedL3Stats {
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  uint64_t installs = 0;
+  uint64_t hinted_installs = 0;    // Installs whose line had a sampled hint
+  uint64_t compressed_bytes = 0;   // Sum of compressed sizes over installs
+
+  [[nodiscard]] uint64_t misses() const { return lookups - hits; }
+  [[nodiscard]] double hit_rate() const {
+    return lookups ? static_cast<double>(hits) / lookups : 0.0;
+  }
+  void reset() { *this = CompressedL3Stats{}; }
+};
+
+/**
+ * CompressedCacheModel - what-if shadow of the L3 with BDI-style
+ * compression, for evaluating compressed-L3 parts before buying one.
+ *
+ * Runs beside the real L3 on the same demand stream (see the OPT
+ * comparison for the same shadow-replay idea). Each set keeps the
+ * physical data budget (associativity x line size bytes) but twice the
+ * tags, so compressible lines pack in and effective capacity grows;
+ * incompressible data degenerates to exactly the physical cache. Lines
+ * take the compressed size of their sampled BDI class; unhinted lines
+ * use the running average of all sampled lines, falling back to
+ * uncompressed when the trace carries no hints at all.
+ */
+class CompressedCacheModel {
+private:
+  struct Slot {
+    uint64_t tag = 0;
+    uint64_t lru_time = 0;
+    uint32_t bytes = 0;
+    uint32_t valid = 0;
+  };
+
+  CacheConfig cfg_;          // Geometry of the L3 being shadowed
+  int tag_slots_ = 0;        // Tags per set (physical associativity x factor)
+  uint32_t set_budget_ = 0;  // Data bytes per set (the physical budget)
+  std::vector<Slot> slots_;  // num_sets x tag_slots_
+  uint64_t clock_ = 0;
+  CompressedL3Stats stats;
+
+  // Local snapshot of the sampled hints, refreshed on version change
+  std::unordered_map<uint64_t, uint8_t> hint_map_;
+  uint64_t hint_version_ = 0;
+  uint64_t class_counts_[BDI_CLASS_COUNT] = {};
+  uint32_t default_bytes_ = 0;  // Average sampled size for unhinted lines
+
+  void refresh_hints() {
+    uint64_t version = TraceCompressHints::instance().version();
+    if (version == hint_version_) {
+      return;
+    }
+    hint_version_ = version;
+    hint_map_.clear();
+    for (uint64_t &c : class_counts_) {
+      c = 0;
+    }
+    uint64_t total_bytes = 0, samples = 0;
+    uint32_t line = static_cast<uint32_t>(cfg_.line_size);
+    for (const auto &[addr, cls] : TraceCompressHints::instance().snapshot()) {
+      hint_map_[addr >> cfg_.offset_bits()] = cls;
+      class_counts_[cls < BDI_CLASS_COUNT ? cls : BDI_UNCOMPRESSED]++;
+      total_bytes += bdi_class_bytes(cls, line);
+      samples++;
+    }
+    default_bytes_ = samples
+        ? static_cast<uint32_t>((total_bytes + samples - 1) / samples)
+        : line;
+  }
+
+  [[nodiscard]] uint32_t compressed_size(uint64_t set_line_tag) const {
+    auto it = hint_map_.find(set_line_tag);
+    uint8_t cls = it != hint_map_.end() ? it->second : 0xFF;
+    return cls != 0xFF ? bdi_class_bytes(cls, cfg_.line_size) : default_bytes_;
+  }
+
+public:
+  CompressedCacheModel() = default;
+
+  CompressedCacheModel(const CacheConfig &l3_cfg, const CompressionConfig &comp)
+      : cfg_(l3_cfg), tag_slots_(l3_cfg.associativity * comp.tag_factor),
+        set_budget_(static_cast<uint32_t>(l3_cfg.associativity) *
+                    static_cast<uint32_t>(l3_cfg.line_size)),
+        slots_(static_cast<size_t>(l3_cfg.num_sets()) * tag_slots_),
+        default_bytes_(static_cast<uint32_t>(l3_cfg.line_size)) {}
+
+  [[nodiscard]] bool is_enabled() const { return !slots_.empty(); }
+  [[nodiscard]] const CompressedL3Stats &get_stats() const { return stats; }
+  [[nodiscard]] int get_tag_slots() const { return tag_slots_; }
+  [[nodiscard]] uint32_t get_set_budget() const { return set_budget_; }
+
+  // Average compression ratio over installed lines (1.0 = nothing gained)
+  [[nodiscard]] double avg_compression_ratio() const {
+    return stats.compressed_bytes
+        ? static_cast<double>(stats.installs) * cfg_.line_size /
+              stats.compressed_bytes
+        : 1.0;
+  }
+
+  // Fraction of installs whose line carried a sampled hint
+  [[nodiscard]] double hint_coverage() const {
+    return stats.installs
+        ? static_cast<double>(stats.hinted_installs) / stats.installs
+        : 0.0;
+  }
+
+  // Sampled-hint histogram, indexed by BDI class
+  [[nodiscard]] const uint64_t *get_class_counts() const {
+    return class_counts_;
+  }
+
+  // Shadow one demand L3 access. Returns true on a hit in the
+  // compressed model (independent of what the real L3 did).
+  bool access(uint64_t address) {
+    if (!is_enabled()) {
+      return false;
+    }
+    refresh_hints();
+    stats.lookups++;
+    uint64_t set = cfg_.get_index(address);
+    uint64_t tag = cfg_.get_tag(address);
+    size_t base = static_cast<size_t>(set) * tag_slots_;
+
+    uint32_t used = 0;
+    for (int way = 0; way < tag_slots_; way++) {
+      Slot &s = slots_[base + way];
+      if (!s.valid) {
+        continue;
+      }
+      if (s.tag == tag) {
+        s.lru_time = ++clock_;
+        stats.hits++;
+        return true;
+      }
+      used += s.bytes;
+    }
+
+    // Miss: install at the line's sampled (or average) compressed size,
+    // evicting LRU lines until both a tag slot and the byte budget fit
+    uint64_t line_key = address >> cfg_.offset_bits();
+    bool hinted = hint_map_.count(line_key) != 0;
+    uint32_t bytes = compressed_size(line_key);
+    Slot *free_slot = nullptr;
+    for (;;) {
+      free_slot = nullptr;
+      for (int way = 0; way < tag_slots_; way++) {
+        Slot &s = slots_[base + way];
+        if (!s.valid) {
+          free_slot = &s;
+          break;
+        }
+      }
+      if (free_slot && used + bytes <= set_budget_) {
+        break;
+      }
+      Slot *victim = nullptr;
+      for (int way = 0; way < tag_slots_; way++) {
+        Slot &s = slots_[base + way];
+        if (s.valid && (!victim || s.lru_time < victim->lru_time)) {
+          victim = &s;
+        }
+      }
+      used -= victim->bytes;
+      victim->valid = 0;
+    }
+    *free_slot = {tag, ++clock_, bytes, 1};
+    stats.installs++;
+    stats.compressed_bytes += bytes;
+    if (hinted) {
+      stats.hinted_installs++;
+    }
+    return false;
+  }
+
+  void reset_stats() { stats.reset(); }
+
+  void clear() {
+    for (Slot &s : slots_) {
+      s = Slot{};
+    }
+    clock_ = 0;
+    stats.reset();
+  }
+
+  // Checkpointing: serialize/restore the shadow contents and stats.
+  // The hint snapshot is rebuilt from the registration table on the
+  // first access after a restore.
+  void save_state(CheckpointWriter &w) const {
+    w.write<uint32_t>(static_cast<uint32_t>(tag_slots_));
+    w.write(set_budget_);
+    w.write_vec(slots_);
+    w.write(clock_);
+    w.write(stats);
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.expect<uint32_t>(static_cast<uint32_t>(tag_slots_),
+                       "compressed L3 tag slots");
+    r.expect<uint32_t>(set_budget_, "compressed L3 set budget");
+    r.read_vec_expect(slots_, "compressed L3 slots");
+    clock_ = r.read<uint64_t>();
+    stats = r.read<CompressedL3Stats>();
+  }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../profiles/CacheConfig.hpp"
+#include "CacheStats.hpp"
+#include "Checkpoint.hpp"
+
+// DRAM stage behind the L3: channels, banks and row buffers with an
+// open-page policy.
+//
+// The flat timing model charges every memory access the same latency,
+// but real DRAM is cheap when an access lands in a bank's open row
+// (column access only) and expensive when the wrong row is open
+// (precharge + activate + column access). Streaming layouts live or die
+// by this, so the model classifies every post-L3 access as a row hit,
+// an access to a closed bank, or a row conflict, and accumulates the
+// corresponding latencies from DramConfig into TimingStats.
+//
+// Address mapping interleaves cache lines across channels, then lays
+// row-sized column runs across banks, so a linear stream stays in one
+// row per channel until the row is exhausted.
+class DramModel {
+public:
+  explicit DramModel(const DramConfig &cfg = {})
+      : config_(cfg),
+        lines_per_row_(std::max(1, cfg.row_size / LINE_SIZE)),
+        open_rows_(static_cast<size_t>(std::max(1, cfg.channels)) *
+                       static_cast<size_t>(std::max(1, cfg.banks)),
+                   NO_OPEN_ROW) {}
+
+  // Account one post-L3 memory access and return its DRAM latency
+  uint64_t access(uint64_t address, TimingStats &timing) {
+    uint64_t line = address / LINE_SIZE;
+    uint64_t channel = line % channels();
+    uint64_t run = line / channels();          // line index within this channel
+    uint64_t bank = (run / lines_per_row_) % banks();
+    uint64_t row = run / (lines_per_row_ * banks());
+
+    int64_t &open = open_rows_[channel * banks() + bank];
+    uint64_t latency;
+    if (open == static_cast<int64_t>(row)) {
+      timing.dram_row_hits++;
+      latency = config_.row_hit;
+    } else if (open == NO_OPEN_ROW) {
+      timing.dram_row_empty++;
+      latency = config_.row_empty;
+    } else {
+      timing.dram_row_conflicts++;
+      latency = config_.row_conflict;
+    }
+    open = static_cast<int64_t>(row);  // open-page: leave the row open
+    timing.dram_cycles += latency;
+    return latency;
+  }
+
+  [[nodiscard]] const DramConfig &config() const { return config_; }
+
+  void clear() {
+    std::fill(open_rows_.begin(), open_rows_.end(), NO_OPEN_ROW);
+  }
+
+  // Checkpointing: serialize/restore the open row per bank
+  void save_state(CheckpointWriter &w) const { w.write_vec(open_rows_); }
+  void load_state(CheckpointReader &r) {
+    r.read_vec_expect(open_rows_, "DRAM bank count");
+  }
+
+private:
+  static constexpr int LINE_SIZE = 64;
+  static constexpr int64_t NO_OPEN_ROW = -1;
+
+  [[nodiscard]] uint64_t channels() const {
+    return static_cast<uint64_t>(std::max(1, config_.channels));
+  }
+  [[nodiscard]] uint64_t banks() const {
+    return static_cast<uint64_t>(std::max(1, config_.banks));
+  }
+
+  DramConfig config_;
+  uint64_t lines_per_row_;
+  std::vector<int64_t> open_rows_;  // Open row per (channel, bank), -1 = closed
+};
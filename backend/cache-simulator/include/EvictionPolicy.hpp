@@ -6,4 +6,6 @@ enum class EvictionPolicy {
   RANDOM,   // Random replacement
   SRRIP,    // Static Re-Reference Interval Prediction (Intel L3)
   BRRIP,    // Bimodal RRIP (scan-resistant)
+  DRRIP,    // Dynamic RRIP (set dueling picks SRRIP or BRRIP at runtime)
+  OPT,      // Belady-optimal (offline analysis; needs a next-use oracle)
 };
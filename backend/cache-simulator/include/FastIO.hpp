@@ -3,11 +3,167 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <optional>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 
 #include "TraceEvent.hpp"
 
+#ifdef CACHE_EXPLORER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// SIMD tokenizer support: AVX2/SSE2 on x86-64, NEON on ARM, scalar fallback.
+// Parsing is a large share of non-fast-mode runtime, so line splitting and
+// hex conversion work on 16/32 bytes at a time where the ISA allows.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FASTIO_HAVE_AVX2 1
+#define FASTIO_HAVE_SSE2 1
+#elif defined(__SSE2__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define FASTIO_HAVE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FASTIO_HAVE_NEON 1
+#endif
+
+// Find the next '\n' in [p, end), or end if none
+inline const char *find_newline(const char *p, const char *end) {
+#if defined(FASTIO_HAVE_AVX2)
+  const __m256i nl = _mm256_set1_epi8('\n');
+  while (p + 32 <= end) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl));
+    if (mask)
+      return p + __builtin_ctz(mask);
+    p += 32;
+  }
+#elif defined(FASTIO_HAVE_SSE2)
+  const __m128i nl = _mm_set1_epi8('\n');
+  while (p + 16 <= end) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl));
+    if (mask)
+      return p + __builtin_ctz(mask);
+    p += 16;
+  }
+#elif defined(FASTIO_HAVE_NEON)
+  const uint8x16_t nl = vdupq_n_u8('\n');
+  while (p + 16 <= end) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+    uint8x16_t eq = vceqq_u8(chunk, nl);
+    if (vmaxvq_u8(eq)) {
+      // Narrow to a 64-bit mask (4 bits per lane) and count trailing zeros
+      uint64_t mask = vget_lane_u64(
+          vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+      return p + (__builtin_ctzll(mask) >> 2);
+    }
+    p += 16;
+  }
+#endif
+  const char *nl_pos =
+      static_cast<const char *>(memchr(p, '\n', end - p));
+  return nl_pos ? nl_pos : end;
+}
+
+// Parse a run of hex digits at p (no 0x prefix), accumulating into value
+// exactly like the scalar shift-or loop. Returns the position after the run.
+inline const char *parse_hex_run(const char *p, const char *end,
+                                 uint64_t &value) {
+#if defined(FASTIO_HAVE_SSE2)
+  while (p + 16 <= end) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+    // digit = c - '0' valid if <= 9; alpha = (c | 0x20) - 'a' valid if <= 5
+    __m128i digit = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i alpha = _mm_sub_epi8(lower, _mm_set1_epi8('a'));
+    __m128i is_digit =
+        _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i is_alpha =
+        _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+
+    uint32_t valid = _mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha));
+    int nibbles = (valid == 0xFFFF) ? 16 : __builtin_ctz(~valid);
+    if (nibbles == 0)
+      return p;
+
+    // Select digit value or alpha value + 10 per lane, then fold scalar
+    __m128i vals = _mm_or_si128(
+        _mm_and_si128(is_digit, digit),
+        _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+    alignas(16) uint8_t tmp[16];
+    _mm_store_si128(reinterpret_cast<__m128i *>(tmp), vals);
+    for (int i = 0; i < nibbles; i++) {
+      value = (value << 4) | tmp[i];
+    }
+
+    p += nibbles;
+    if (nibbles < 16)
+      return p;
+    // All 16 bytes were hex digits - keep consuming (matches scalar loop)
+  }
+#endif
+  while (p < end) {
+    char c = *p;
+    if (c >= '0' && c <= '9')
+      value = (value << 4) | (c - '0');
+    else if (c >= 'a' && c <= 'f')
+      value = (value << 4) | (c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      value = (value << 4) | (c - 'A' + 10);
+    else
+      break;
+    p++;
+  }
+  return p;
+}
+
+// Zstd-compressed traces (written by the runtime with
+// CACHE_EXPLORER_COMPRESS=1) are detected by the frame magic and inflated
+// before parsing, so both BulkReader and MappedFile input paths accept them
+// transparently. Detection always works; inflation needs libzstd at build
+// time - without it callers can still fail with a clear message.
+constexpr unsigned char ZSTD_TRACE_MAGIC[4] = {0x28, 0xB5, 0x2F, 0xFD};
+
+inline bool is_zstd_trace(const char *data, size_t size) {
+  return size >= sizeof(ZSTD_TRACE_MAGIC) &&
+         memcmp(data, ZSTD_TRACE_MAGIC, sizeof(ZSTD_TRACE_MAGIC)) == 0;
+}
+
+#ifdef CACHE_EXPLORER_HAVE_ZSTD
+// Streaming inflate - traces can be tens of GB, so decompress in bounded
+// chunks rather than trusting the frame header's content size
+inline bool zstd_inflate(const char *data, size_t size, std::string &out) {
+  ZSTD_DStream *stream = ZSTD_createDStream();
+  if (!stream)
+    return false;
+
+  ZSTD_inBuffer in = {data, size, 0};
+  std::vector<char> chunk(ZSTD_DStreamOutSize());
+  bool ok = true;
+  while (in.pos < in.size) {
+    ZSTD_outBuffer buf = {chunk.data(), chunk.size(), 0};
+    size_t rc = ZSTD_decompressStream(stream, &buf, &in);
+    if (ZSTD_isError(rc)) {
+      ok = false;
+      break;
+    }
+    out.append(chunk.data(), buf.pos);
+  }
+  ZSTD_freeDStream(stream);
+  return ok;
+}
+#else
+inline bool zstd_inflate(const char *, size_t, std::string &) { return false; }
+#endif
+
 // Bulk stdin reader - reads entire input in large chunks
 // Eliminates per-character getc/mutex overhead from std::getline
 class BulkReader {
@@ -26,6 +182,67 @@ public:
   }
 };
 
+// Read-only memory-mapped trace file
+// Unlike BulkReader, needs no heap copy - pages stream in on demand, so a
+// 30GB trace adds nothing to peak RSS beyond the pages the kernel keeps warm
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::string &path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+      close();
+      return false;
+    }
+
+    mapped_size = static_cast<size_t>(st.st_size);
+    mapped_data = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped_data == MAP_FAILED) {
+      mapped_data = nullptr;
+      close();
+      return false;
+    }
+
+    // Trace replay is a single forward pass - tell the kernel so it
+    // reads ahead aggressively and drops pages behind us
+    madvise(mapped_data, mapped_size, MADV_SEQUENTIAL);
+    return true;
+  }
+
+  void close() {
+    if (mapped_data) {
+      munmap(mapped_data, mapped_size);
+      mapped_data = nullptr;
+      mapped_size = 0;
+    }
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+  [[nodiscard]] const char *data() const {
+    return static_cast<const char *>(mapped_data);
+  }
+  [[nodiscard]] size_t size() const { return mapped_size; }
+  [[nodiscard]] bool is_open() const { return mapped_data != nullptr; }
+
+private:
+  int fd = -1;
+  void *mapped_data = nullptr;
+  size_t mapped_size = 0;
+};
+
 // Fast trace event parser - avoids std::istringstream overhead
 // Parses directly from char pointers with no intermediate allocations
 inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
@@ -44,6 +261,132 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
   // Parse type character
   char type = *p++;
 
+  // File-registration records bind a numeric file id to a path
+  // (D 12 src/engine/hash.cpp); location fields then carry "12:10".
+  // They produce no event - just feed the id table.
+  if (type == 'D') {
+    while (p < end && *p == ' ')
+      p++;
+    uint32_t id = 0;
+    const char *id_start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      id = id * 10 + (*p - '0');
+      p++;
+    }
+    while (p < end && *p == ' ')
+      p++;
+    const char *name_start = p;
+    while (p < end && *p != '\n' && *p != '\r')
+      p++;
+    while (p > name_start && p[-1] == ' ')
+      p--;
+    if (p > id_start && p > name_start) {
+      TraceFileIds::instance().register_id(
+          id, std::string_view(name_start, p - name_start));
+    }
+    return std::nullopt;
+  }
+
+  // Function-registration records bind a source line to its enclosing
+  // pre-inlining function (G <file>:<line> <func>); no event either
+  if (type == 'G') {
+    while (p < end && *p == ' ')
+      p++;
+    const char *loc_start = p;
+    while (p < end && *p != ' ' && *p != '\n' && *p != '\r')
+      p++;
+    const char *loc_end = p;
+    const char *colon = nullptr;
+    for (const char *c = loc_end - 1; c >= loc_start; c--) {
+      if (*c == ':') {
+        colon = c;
+        break;
+      }
+    }
+    while (p < end && *p == ' ')
+      p++;
+    const char *name_start = p;
+    while (p < end && *p != '\n' && *p != '\r')
+      p++;
+    while (p > name_start && p[-1] == ' ')
+      p--;
+    if (colon && p > name_start) {
+      uint32_t line = 0;
+      for (const char *c = colon + 1; c < loc_end; c++)
+        line = line * 10 + (*c - '0');
+      std::string_view file =
+          resolve_trace_file(std::string_view(loc_start, colon - loc_start));
+      TraceFuncMap::instance().register_site(
+          file, line, std::string_view(name_start, p - name_start));
+    }
+    return std::nullopt;
+  }
+
+  // Region records bind an address range to a memory-region kind
+  // (K stack 0x7ffd00000000 0x7ffd00800000); no event either
+  if (type == 'K') {
+    while (p < end && *p == ' ')
+      p++;
+    const char *kind_start = p;
+    while (p < end && *p != ' ' && *p != '\n' && *p != '\r')
+      p++;
+    std::string_view kind(kind_start, p - kind_start);
+    while (p < end && *p == ' ')
+      p++;
+    uint64_t lo = 0, hi = 0;
+    if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+      p += 2;
+    p = parse_hex_run(p, end, lo);
+    while (p < end && *p == ' ')
+      p++;
+    if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+      p += 2;
+    p = parse_hex_run(p, end, hi);
+    if (!kind.empty() && hi > lo) {
+      TraceRegionMap::instance().register_range(
+          kind == "stack" ? RegionKind::Stack : RegionKind::Global, lo, hi);
+    }
+    return std::nullopt;
+  }
+
+  // Compressibility hints carry a sampled BDI class for a line
+  // (Y 0x7fff1200 2); no event either
+  if (type == 'Y') {
+    while (p < end && *p == ' ')
+      p++;
+    uint64_t hint_addr = 0;
+    if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+      p += 2;
+    p = parse_hex_run(p, end, hint_addr);
+    while (p < end && *p == ' ')
+      p++;
+    if (p < end && *p >= '0' && *p <= '9') {
+      TraceCompressHints::instance().register_hint(
+          hint_addr, static_cast<uint8_t>(*p - '0'));
+    }
+    return std::nullopt;
+  }
+
+  // Sample-rate records name the divisor now in effect (W 64): every
+  // event that follows stands for that many captured accesses. Unlike
+  // the registration records above, position in the stream matters, so
+  // they do produce an event.
+  if (type == 'W') {
+    while (p < end && *p == ' ')
+      p++;
+    uint64_t divisor = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      divisor = divisor * 10 + (*p - '0');
+      p++;
+    }
+    if (divisor == 0)
+      return std::nullopt;
+    TraceEvent event;
+    event.is_sample_rate = true;
+    event.count = divisor;
+    return event;
+  }
+
   // Handle type modifiers (P0, P1, etc.)
   uint8_t prefetch_hint = 0;
   if (type == 'P' && p < end && *p >= '0' && *p <= '3') {
@@ -51,6 +394,24 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
     p++;
   }
 
+  // Compressed range events (RL/RS): base stride count size location thread
+  bool is_range = false;
+  bool range_write = false;
+  if (type == 'R' && p < end && (*p == 'L' || *p == 'S')) {
+    is_range = true;
+    range_write = (*p == 'S');
+    p++;
+  }
+
+  // Gather/scatter lane events (VL/VS): addr lane lanes size location thread
+  bool is_gather = false;
+  bool gather_write = false;
+  if (type == 'V' && p < end && (*p == 'L' || *p == 'S')) {
+    is_gather = true;
+    gather_write = (*p == 'S');
+    p++;
+  }
+
   // Skip whitespace
   while (p < end && *p == ' ')
     p++;
@@ -62,17 +423,44 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
   if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
     p += 2; // skip 0x
   }
-  while (p < end && *p != ' ') {
-    char c = *p;
-    if (c >= '0' && c <= '9')
-      addr = (addr << 4) | (c - '0');
-    else if (c >= 'a' && c <= 'f')
-      addr = (addr << 4) | (c - 'a' + 10);
-    else if (c >= 'A' && c <= 'F')
-      addr = (addr << 4) | (c - 'A' + 10);
+  p = parse_hex_run(p, end, addr);
+
+  // Free records (F <addr> T<tid>) and phase markers (B/E <id> T<tid>)
+  // carry no size or location - branch before the size parse, which
+  // would otherwise reject them
+  if (type == 'F' || type == 'B' || type == 'E') {
+    TraceEvent event;
+    event.address = addr;
+    if (type == 'F')
+      event.is_free = true;
+    else if (type == 'B')
+      event.is_phase_begin = true;
     else
-      break;
-    p++;
+      event.is_phase_end = true;
+    event.thread_id = 1;
+    while (p < end && *p == ' ')
+      p++;
+    if (p < end && *p == 'T') {
+      p++;
+      uint32_t tid = 0;
+      while (p < end && *p >= '0' && *p <= '9') {
+        tid = tid * 10 + (*p - '0');
+        p++;
+      }
+      event.thread_id = tid;
+    }
+    while (p < end && *p == ' ')
+      p++;
+    if (p < end && *p == '@') {
+      p++;
+      uint64_t ts = 0;
+      while (p < end && *p >= '0' && *p <= '9') {
+        ts = ts * 10 + (*p - '0');
+        p++;
+      }
+      event.timestamp = ts;
+    }
+    return event;
   }
 
   // For memcpy/memmove: parse src address next
@@ -82,16 +470,46 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
       p++;
     if (p + 1 < end && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
       p += 2;
-    while (p < end && *p != ' ') {
-      char c = *p;
-      if (c >= '0' && c <= '9')
-        src_addr = (src_addr << 4) | (c - '0');
-      else if (c >= 'a' && c <= 'f')
-        src_addr = (src_addr << 4) | (c - 'a' + 10);
-      else if (c >= 'A' && c <= 'F')
-        src_addr = (src_addr << 4) | (c - 'A' + 10);
-      else
-        break;
+    p = parse_hex_run(p, end, src_addr);
+  }
+
+  // For ranges: parse signed decimal stride and decimal count before size
+  int64_t stride = 0;
+  uint64_t range_count = 0;
+  if (is_range) {
+    while (p < end && *p == ' ')
+      p++;
+    bool negative = (p < end && *p == '-');
+    if (negative)
+      p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      stride = stride * 10 + (*p - '0');
+      p++;
+    }
+    if (negative)
+      stride = -stride;
+    while (p < end && *p == ' ')
+      p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      range_count = range_count * 10 + (*p - '0');
+      p++;
+    }
+  }
+
+  // For gather lanes: parse the lane index and lane count before size
+  uint32_t lane = 0;
+  uint32_t lane_count = 0;
+  if (is_gather) {
+    while (p < end && *p == ' ')
+      p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      lane = lane * 10 + (*p - '0');
+      p++;
+    }
+    while (p < end && *p == ' ')
+      p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      lane_count = lane_count * 10 + (*p - '0');
       p++;
     }
   }
@@ -118,9 +536,17 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
   event.thread_id = 1;
 
   switch (type) {
+  case 'R':
+    if (is_range) {
+      event.is_range = true;
+      event.stride = stride;
+      event.count = range_count;
+      event.is_write = range_write;
+      break;
+    }
+    [[fallthrough]]; // bare 'R' is a load alias
   case 'L':
   case 'l':
-  case 'R':
   case 'r':
     break;
   case 'S':
@@ -136,6 +562,13 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
     event.prefetch_hint = prefetch_hint;
     break;
   case 'V':
+    if (is_gather) {
+      event.is_gather = true;
+      event.lane = static_cast<uint8_t>(lane);
+      event.lanes = static_cast<uint8_t>(lane_count);
+      event.is_write = gather_write;
+      break;
+    }
     event.is_vector = true;
     break;
   case 'U':
@@ -158,6 +591,9 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
     event.is_memset = true;
     event.is_write = true;
     break;
+  case 'H':
+    event.is_alloc = true;
+    break;
   case 'M':
     event.is_memcpy = true;
     event.is_write = true;
@@ -182,8 +618,9 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
     while (p < end && *p != ' ' && *p != '\n' && *p != '\r')
       p++;
 
-    // Don't parse if it starts with 'T' (thread ID with no location)
-    if (*loc_start != 'T') {
+    // Don't parse if it starts with 'T' (thread ID with no location) or
+    // '@' (timestamp with neither location nor thread)
+    if (*loc_start != 'T' && *loc_start != '@') {
       // Find last colon for file:line split
       const char *colon = nullptr;
       for (const char *c = p - 1; c >= loc_start; c--) {
@@ -194,7 +631,10 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
       }
 
       if (colon && colon > loc_start) {
-        event.file.assign(loc_start, colon - loc_start);
+        // Resolve the file span (numeric id or literal path) against the
+        // intern tables - no per-event heap allocation
+        event.file = resolve_trace_file(
+            std::string_view(loc_start, colon - loc_start));
         // Parse line number
         const char *lp = colon + 1;
         uint32_t ln = 0;
@@ -204,11 +644,17 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
         }
         event.line = ln;
       } else {
-        event.file.assign(loc_start, p - loc_start);
+        event.file = FileTable::instance().view(
+            std::string_view(loc_start, p - loc_start));
       }
-    } else {
-      // This was actually the thread field, parse it
+    } else if (*loc_start == 'T') {
+      // This was actually the thread field - rewind to its 'T' (the token
+      // scan above already consumed it) and parse it
+      p = loc_start;
       goto parse_thread_from_loc;
+    } else {
+      // A bare timestamp - rewind and let the '@' parse below take it
+      p = loc_start;
     }
   }
 
@@ -228,22 +674,33 @@ inline std::optional<TraceEvent> parse_trace_event_fast(const char *begin,
     event.thread_id = tid;
   }
 
+  // Skip whitespace
+  while (p < end && *p == ' ')
+    p++;
+
+  // Optional capture timestamp (@<cycles>, CACHE_EXPLORER_TIMESTAMPS=1)
+  if (p < end && *p == '@') {
+    p++;
+    uint64_t ts = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      ts = ts * 10 + (*p - '0');
+      p++;
+    }
+    event.timestamp = ts;
+  }
+
   return event;
 }
 
 // Iterate lines in a buffer, calling a callback for each line
 // Avoids any string allocation - passes char pointers
 template <typename Callback>
-inline void for_each_line(const std::string &buf, Callback &&cb) {
-  const char *data = buf.data();
-  const char *end = data + buf.size();
+inline void for_each_line(const char *data, size_t size, Callback &&cb) {
+  const char *end = data + size;
   const char *line_start = data;
 
   while (line_start < end) {
-    const char *line_end =
-        static_cast<const char *>(memchr(line_start, '\n', end - line_start));
-    if (!line_end)
-      line_end = end;
+    const char *line_end = find_newline(line_start, end);
 
     if (line_end > line_start) {
       cb(line_start, line_end);
@@ -252,3 +709,8 @@ inline void for_each_line(const std::string &buf, Callback &&cb) {
     line_start = line_end + 1;
   }
 }
+
+template <typename Callback>
+inline void for_each_line(const std::string &buf, Callback &&cb) {
+  for_each_line(buf.data(), buf.size(), std::forward<Callback>(cb));
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.hpp"
+
+// Global file-name intern table
+//
+// Traces reference only a few hundred distinct files, but every event line
+// names one. Interning maps each name to a stable uint32 ID and a
+// string_view backed by storage that lives for the whole run, so TraceEvent
+// can carry a view instead of allocating a heap string per event.
+//
+// String bytes live in an arena (one heap block per 64KB of names, not one
+// per name) so views stay valid as new names are added and everything is
+// freed wholesale in clear(). Lookups take a shared lock; only the first
+// sighting of a name takes the exclusive lock.
+class FileTable {
+public:
+  static FileTable &instance() {
+    static FileTable table;
+    return table;
+  }
+
+  // Intern a name, returning its stable ID
+  uint32_t intern(std::string_view name) {
+    {
+      std::shared_lock lock(mutex);
+      auto it = index.find(name);
+      if (it != index.end())
+        return it->second;
+    }
+
+    std::unique_lock lock(mutex);
+    // Re-check: another thread may have interned it between locks
+    auto it = index.find(name);
+    if (it != index.end())
+      return it->second;
+
+    uint32_t id = static_cast<uint32_t>(views.size());
+    std::string_view stored = arena.copy_string(name);
+    views.push_back(stored);
+    index.emplace(stored, id);
+    return id;
+  }
+
+  // Intern a name and return a view into the table's stable storage
+  std::string_view view(std::string_view name) { return view_of(intern(name)); }
+
+  // Look up the stable view for an already-interned ID
+  [[nodiscard]] std::string_view view_of(uint32_t id) const {
+    std::shared_lock lock(mutex);
+    return id < views.size() ? views[id] : std::string_view();
+  }
+
+  [[nodiscard]] size_t size() const {
+    std::shared_lock lock(mutex);
+    return views.size();
+  }
+
+  // Drop all entries - invalidates outstanding views (tests only)
+  void clear() {
+    std::unique_lock lock(mutex);
+    index.clear();
+    views.clear();
+    arena.release();
+  }
+
+private:
+  FileTable() = default;
+
+  mutable std::shared_mutex mutex;
+  std::unordered_map<std::string_view, uint32_t> index;
+  std::vector<std::string_view> views; // id -> arena-backed view
+  Arena arena;                         // string bytes, freed wholesale
+};
+
+// Numeric file ids declared by the trace itself
+//
+// The text protocol's registration records ("D 12 src/engine/hash.cpp")
+// bind a trace-local id to a path once; location fields then carry
+// "12:10" instead of repeating the path per event. These ids are the
+// producer's numbering, not FileTable's intern ids, so they live in
+// their own table. Registration interns the path, so resolved views have
+// the same lifetime as literal-path locations. A daemon job that reuses
+// the process simply re-registers its ids; later bindings win, and every
+// trace emits its registrations before the events that use them.
+class TraceFileIds {
+public:
+  static TraceFileIds &instance() {
+    static TraceFileIds table;
+    return table;
+  }
+
+  void register_id(uint32_t id, std::string_view name) {
+    std::string_view stored = FileTable::instance().view(name);
+    std::unique_lock lock(mutex);
+    if (id >= views.size())
+      views.resize(id + 1);
+    views[id] = stored;
+  }
+
+  // View bound to a trace id, or an empty view if never registered
+  [[nodiscard]] std::string_view view_of(uint32_t id) const {
+    std::shared_lock lock(mutex);
+    return id < views.size() ? views[id] : std::string_view();
+  }
+
+  void clear() {
+    std::unique_lock lock(mutex);
+    views.clear();
+  }
+
+private:
+  TraceFileIds() = default;
+
+  mutable std::shared_mutex mutex;
+  std::vector<std::string_view> views; // trace id -> interned view
+};
+
+// Function attribution from the pass's G registration records
+// ("G <file>:<line> <func>"): each instrumented source line maps to its
+// enclosing pre-inlining function, so reports can roll per-line stats up
+// to function granularity. Function names are interned like file names;
+// keys use the interned file view, so lookups with views from the same
+// run compare by identical bytes.
+class TraceFuncMap {
+public:
+  static TraceFuncMap &instance() {
+    static TraceFuncMap table;
+    return table;
+  }
+
+  // Bind a source line (file already resolved/interned) to its enclosing
+  // function. Later bindings win, matching TraceFileIds semantics.
+  void register_site(std::string_view file, uint32_t line,
+                     std::string_view func) {
+    std::string_view stored = FileTable::instance().view(func);
+    std::unique_lock lock(mutex);
+    sites[Key{file, line}] = stored;
+  }
+
+  // Enclosing function of a source line, or an empty view if unregistered
+  [[nodiscard]] std::string_view function_of(std::string_view file,
+                                             uint32_t line) const {
+    std::shared_lock lock(mutex);
+    auto it = sites.find(Key{file, line});
+    return it != sites.end() ? it->second : std::string_view();
+  }
+
+  [[nodiscard]] bool empty() const {
+    std::shared_lock lock(mutex);
+    return sites.empty();
+  }
+
+  void clear() {
+    std::unique_lock lock(mutex);
+    sites.clear();
+  }
+
+private:
+  TraceFuncMap() = default;
+
+  struct Key {
+    std::string_view file;
+    uint32_t line;
+    bool operator==(const Key &o) const {
+      return line == o.line && file == o.file;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key &k) const {
+      size_t h = std::hash<std::string_view>{}(k.file);
+      return h ^ (std::hash<uint32_t>{}(k.line) + 0x9e3779b9 + (h << 6) +
+                  (h >> 2));
+    }
+  };
+
+  mutable std::shared_mutex mutex;
+  std::unordered_map<Key, std::string_view, KeyHash> sites;
+};
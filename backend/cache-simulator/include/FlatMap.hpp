@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Open-addressing flat hash map for hot-path counters
+//
+// The per-source-line and per-cache-line stats maps are bumped on every
+// simulated access, and std::unordered_map pays a pointer chase into a
+// heap node for each bump. This table keeps key/value pairs in one flat
+// array with linear probing, so the common "find and increment" touches a
+// single cache line. Sized for our working sets - a few thousand distinct
+// source lines or tracked cache lines - and grows by doubling at 3/4 load.
+//
+// Deliberately minimal: only the operations the stats paths use
+// (operator[], find, emplace, count, erase-by-iterator, iteration, clear).
+// Erase leaves a tombstone; tombstones count toward the load factor so
+// probe chains stay short, and are reclaimed on the next rehash.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class FlatMap {
+public:
+  using value_type = std::pair<Key, T>;
+
+private:
+  enum State : uint8_t { Empty = 0, Occupied = 1, Tombstone = 2 };
+
+  std::vector<value_type> slots_;
+  std::vector<uint8_t> states_;
+  size_t count_ = 0; // occupied slots
+  size_t used_ = 0;  // occupied + tombstones (drives growth)
+
+  static size_t round_up_pow2(size_t n) {
+    size_t c = 16;
+    while (c < n)
+      c <<= 1;
+    return c;
+  }
+
+  // std::hash is the identity for integers on common implementations,
+  // which interacts badly with power-of-two masking on aligned addresses
+  // (cache-line keys share their low six bits) - finalize with a 64-bit
+  // avalanche mix so every key bit reaches the index
+  static size_t mix(size_t h) {
+    uint64_t x = h;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+  }
+
+  [[nodiscard]] size_t mask() const { return slots_.size() - 1; }
+
+  // Probe for key: returns the slot holding it (found = true) or the slot
+  // an insert should use (first tombstone on the path, else first empty)
+  [[nodiscard]] size_t probe(const Key &key, bool &found) const {
+    size_t i = mix(Hash{}(key)) & mask();
+    size_t insert_at = SIZE_MAX;
+    while (true) {
+      if (states_[i] == Empty) {
+        found = false;
+        return insert_at != SIZE_MAX ? insert_at : i;
+      }
+      if (states_[i] == Occupied && slots_[i].first == key) {
+        found = true;
+        return i;
+      }
+      if (states_[i] == Tombstone && insert_at == SIZE_MAX)
+        insert_at = i;
+      i = (i + 1) & mask();
+    }
+  }
+
+  void rehash(size_t new_capacity) {
+    std::vector<value_type> old_slots = std::move(slots_);
+    std::vector<uint8_t> old_states = std::move(states_);
+    slots_ = std::vector<value_type>(new_capacity);
+    states_.assign(new_capacity, Empty);
+    used_ = count_;
+    for (size_t i = 0; i < old_slots.size(); i++) {
+      if (old_states[i] != Occupied)
+        continue;
+      size_t j = mix(Hash{}(old_slots[i].first)) & mask();
+      while (states_[j] == Occupied)
+        j = (j + 1) & mask();
+      slots_[j] = std::move(old_slots[i]);
+      states_[j] = Occupied;
+    }
+  }
+
+  void maybe_grow() {
+    if ((used_ + 1) * 4 > slots_.size() * 3)
+      rehash(slots_.size() * 2);
+  }
+
+  template <bool Const> class basic_iterator {
+    using map_t = std::conditional_t<Const, const FlatMap, FlatMap>;
+    map_t *map_;
+    size_t i_;
+
+    void skip_to_occupied() {
+      while (i_ < map_->slots_.size() && map_->states_[i_] != Occupied)
+        i_++;
+    }
+
+  public:
+    basic_iterator(map_t *map, size_t i) : map_(map), i_(i) {
+      skip_to_occupied();
+    }
+    auto &operator*() const { return map_->slots_[i_]; }
+    auto *operator->() const { return &map_->slots_[i_]; }
+    basic_iterator &operator++() {
+      i_++;
+      skip_to_occupied();
+      return *this;
+    }
+    bool operator==(const basic_iterator &other) const {
+      return i_ == other.i_;
+    }
+    bool operator!=(const basic_iterator &other) const {
+      return i_ != other.i_;
+    }
+    friend class FlatMap;
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  explicit FlatMap(size_t initial_capacity = 4096)
+      : slots_(round_up_pow2(initial_capacity)),
+        states_(slots_.size(), Empty) {}
+
+  [[nodiscard]] iterator begin() { return {this, 0}; }
+  [[nodiscard]] iterator end() { return {this, slots_.size()}; }
+  [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+  [[nodiscard]] const_iterator end() const { return {this, slots_.size()}; }
+
+  [[nodiscard]] size_t size() const { return count_; }
+  [[nodiscard]] bool empty() const { return count_ == 0; }
+  [[nodiscard]] size_t capacity() const { return slots_.size(); }
+
+  // Drop all entries but keep the allocation (stale pairs are overwritten
+  // when their slots are reused)
+  void clear() {
+    std::fill(states_.begin(), states_.end(), static_cast<uint8_t>(Empty));
+    count_ = 0;
+    used_ = 0;
+  }
+
+  [[nodiscard]] iterator find(const Key &key) {
+    bool found;
+    size_t i = probe(key, found);
+    return found ? iterator{this, i} : end();
+  }
+
+  [[nodiscard]] const_iterator find(const Key &key) const {
+    bool found;
+    size_t i = probe(key, found);
+    return found ? const_iterator{this, i} : end();
+  }
+
+  [[nodiscard]] size_t count(const Key &key) const {
+    bool found;
+    probe(key, found);
+    return found ? 1 : 0;
+  }
+
+  T &operator[](const Key &key) {
+    maybe_grow();
+    bool found;
+    size_t i = probe(key, found);
+    if (!found) {
+      if (states_[i] == Empty)
+        used_++;
+      slots_[i].first = key;
+      slots_[i].second = T{};
+      states_[i] = Occupied;
+      count_++;
+    }
+    return slots_[i].second;
+  }
+
+  std::pair<iterator, bool> emplace(const Key &key, T value) {
+    maybe_grow();
+    bool found;
+    size_t i = probe(key, found);
+    if (!found) {
+      if (states_[i] == Empty)
+        used_++;
+      slots_[i].first = key;
+      slots_[i].second = std::move(value);
+      states_[i] = Occupied;
+      count_++;
+    }
+    return {iterator{this, i}, !found};
+  }
+
+  // Erase the entry at it, returning an iterator past it
+  iterator erase(iterator it) {
+    states_[it.i_] = Tombstone;
+    count_--;
+    ++it;
+    return it;
+  }
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <string_view>
+#include <vector>
+
+#include "FlatMap.hpp"
+#include "SourceKey.hpp"
+
+// Bounded top-K hot-line tracker
+//
+// The exact source_stats map grows with distinct source lines and
+// get_hot_lines() sorts all of it per call - fine for one-shot runs, not
+// for an always-on service. This tracker keeps exact counters for the K
+// currently-hottest lines (a lazily-refreshed min-heap knows which
+// resident line is coldest) and a count-min sketch for everything else,
+// so memory is fixed regardless of codebase size and the final report
+// only sorts K entries.
+//
+// A non-resident line is promoted when its sketched miss count exceeds
+// the coldest resident line's, evicting that line. Sketch estimates only
+// over-count (min over rows of pure over-counting counters), so a line
+// hot enough to matter cannot be missed; a tail line can be promoted
+// early by collisions, carrying a slightly inflated count. Hits are
+// sketched too so promoted lines report a sensible hit/miss split.
+class HotLineTracker {
+public:
+  struct Entry {
+    std::string_view file; // interned - stable for the whole run
+    uint32_t line = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t thread_mask = 0; // bit per thread id (mod 64)
+  };
+
+  static constexpr size_t DEFAULT_BUDGET = 64;
+  static constexpr size_t SKETCH_WIDTH = 4096; // counters per row
+  static constexpr size_t SKETCH_DEPTH = 4;
+
+  explicit HotLineTracker(size_t budget = DEFAULT_BUDGET)
+      : budget_(budget ? budget : 1), resident_(2 * budget_),
+        miss_sketch_(SKETCH_WIDTH * SKETCH_DEPTH, 0),
+        hit_sketch_(SKETCH_WIDTH * SKETCH_DEPTH, 0) {}
+
+  // Record one access outcome for a source line
+  void record(std::string_view file, uint32_t line, bool is_miss,
+              uint32_t thread_id = 0) {
+    SourceKey key{file, line};
+    auto it = resident_.find(key);
+    if (it != resident_.end()) {
+      Entry &e = it->second.entry;
+      if (is_miss)
+        e.misses++;
+      else
+        e.hits++;
+      e.thread_mask |= 1ULL << (thread_id & 63);
+      return;
+    }
+
+    // Tail line: sketch the access; only misses can promote
+    uint64_t est_misses = sketch_add(miss_sketch_, key, is_miss ? 1 : 0);
+    uint64_t est_hits = sketch_add(hit_sketch_, key, is_miss ? 0 : 1);
+    if (!is_miss)
+      return;
+
+    if (resident_.size() < budget_) {
+      promote(key, est_hits, est_misses, thread_id);
+      return;
+    }
+    refresh_min();
+    if (est_misses > heap_.top().misses) {
+      auto victim = resident_.find(heap_.top().key);
+      heap_.pop();
+      if (victim != resident_.end()) {
+        // Fold the counts accumulated while resident back into the
+        // sketch (its pre-promotion counts never left it), so a comeback
+        // resumes from where it left off
+        const Resident &r = victim->second;
+        sketch_add(miss_sketch_, victim->first,
+                   r.entry.misses - r.base_misses);
+        sketch_add(hit_sketch_, victim->first, r.entry.hits - r.base_hits);
+        resident_.erase(victim);
+      }
+      promote(key, est_hits, est_misses, thread_id);
+    }
+  }
+
+  // The resident entries, hottest first. Sorts K entries, never the full
+  // site population.
+  [[nodiscard]] std::vector<Entry> top(size_t limit = SIZE_MAX) const {
+    std::vector<Entry> entries;
+    entries.reserve(resident_.size());
+    for (const auto &[key, r] : resident_)
+      entries.push_back(r.entry);
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) {
+                if (a.misses != b.misses)
+                  return a.misses > b.misses;
+                if (a.file != b.file)
+                  return a.file < b.file;
+                return a.line < b.line;
+              });
+    if (entries.size() > limit)
+      entries.resize(limit);
+    return entries;
+  }
+
+  [[nodiscard]] size_t size() const { return resident_.size(); }
+  [[nodiscard]] size_t budget() const { return budget_; }
+
+  void clear() {
+    resident_.clear();
+    heap_ = {};
+    std::fill(miss_sketch_.begin(), miss_sketch_.end(), 0);
+    std::fill(hit_sketch_.begin(), hit_sketch_.end(), 0);
+  }
+
+private:
+  struct Resident {
+    Entry entry;
+    // Sketch estimates at promotion time: these counts are still in the
+    // sketch, so only growth since promotion folds back on eviction
+    uint64_t base_hits = 0;
+    uint64_t base_misses = 0;
+  };
+
+  struct HeapItem {
+    uint64_t misses; // snapshot at push time; refreshed lazily
+    SourceKey key;
+  };
+  struct HeapCompare {
+    bool operator()(const HeapItem &a, const HeapItem &b) const {
+      return a.misses > b.misses; // min-heap on misses
+    }
+  };
+
+  // Add delta to every row's counter for key, returning the count-min
+  // estimate after the update
+  uint64_t sketch_add(std::vector<uint64_t> &sketch, const SourceKey &key,
+                      uint64_t delta) {
+    size_t h = SourceKeyHash{}(key);
+    uint64_t est = UINT64_MAX;
+    for (size_t row = 0; row < SKETCH_DEPTH; row++) {
+      // Derive per-row hashes from one base hash (splitmix-style remix)
+      uint64_t x = h + row * 0x9e3779b97f4a7c15ULL;
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27;
+      uint64_t &counter = sketch[row * SKETCH_WIDTH + (x % SKETCH_WIDTH)];
+      counter += delta;
+      est = std::min(est, counter);
+    }
+    return est;
+  }
+
+  void promote(const SourceKey &key, uint64_t est_hits, uint64_t est_misses,
+               uint32_t thread_id) {
+    Resident &r = resident_[key];
+    r.entry.file = key.file;
+    r.entry.line = key.line;
+    r.entry.hits = est_hits;
+    r.entry.misses = est_misses;
+    r.entry.thread_mask = 1ULL << (thread_id & 63);
+    r.base_hits = est_hits;
+    r.base_misses = est_misses;
+    heap_.push({est_misses, key});
+  }
+
+  // Pop stale heap tops (evicted lines, or counts bumped since push)
+  // until the top reflects the live minimum
+  void refresh_min() {
+    while (!heap_.empty()) {
+      const HeapItem &top = heap_.top();
+      auto it = resident_.find(top.key);
+      if (it == resident_.end()) {
+        heap_.pop();
+        continue;
+      }
+      if (it->second.entry.misses != top.misses) {
+        uint64_t current = it->second.entry.misses;
+        SourceKey key = top.key;
+        heap_.pop();
+        heap_.push({current, key});
+        continue;
+      }
+      break;
+    }
+  }
+
+  size_t budget_;
+  FlatMap<SourceKey, Resident, SourceKeyHash> resident_;
+  std::priority_queue<HeapItem, std::vector<HeapItem>, HeapCompare> heap_;
+  std::vector<uint64_t> miss_sketch_;
+  std::vector<uint64_t> hit_sketch_;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include "TraceEvent.hpp"
+
+// Incremental re-simulation for comparison-mode re-runs (--incremental).
+//
+// A small source edit changes the trace only from the first touched site
+// onward: everything before it is the exact event stream the baseline
+// run already simulated. Instead of paying for that prefix again, the
+// baseline run leaves a checkpoint series behind (--checkpoint-every n
+// --checkpoint-keep writes <file>.<offset> snapshots), and the re-run
+// aligns the two traces, restores the newest snapshot at or before the
+// first divergence, and simulates only the remainder. Daily small-diff
+// compare cycles then cost the diverged suffix, not the whole trace.
+//
+// Alignment is exact: type, address, size, site and thread must all
+// match. Aligning on the site sequence alone and "reconciling" the
+// reused state periodically sounds tempting, but a checkpoint restored
+// under shifted addresses disagrees with the new trace in every
+// address-keyed structure - cache tags, TLB entries, the hot-line map -
+// and no cheap reconciliation repairs that. Divergence is therefore
+// declared at the first event that differs in any field, which keeps
+// incremental results bit-identical to a full re-simulation.
+
+// Fields that feed the simulation; presentation-only fields (timestamps)
+// don't force a divergence
+[[nodiscard]] inline bool same_trace_event(const TraceEvent &a,
+                                           const TraceEvent &b) {
+  return a.is_write == b.is_write && a.is_icache == b.is_icache &&
+         a.address == b.address && a.size == b.size && a.file == b.file &&
+         a.line == b.line && a.thread_id == b.thread_id &&
+         a.is_prefetch == b.is_prefetch && a.is_vector == b.is_vector &&
+         a.is_gather == b.is_gather && a.lane == b.lane && a.lanes == b.lanes &&
+         a.is_atomic == b.is_atomic && a.is_memcpy == b.is_memcpy &&
+         a.is_memset == b.is_memset && a.is_memmove == b.is_memmove &&
+         a.src_address == b.src_address && a.is_range == b.is_range &&
+         a.stride == b.stride && a.count == b.count &&
+         a.is_alloc == b.is_alloc && a.is_free == b.is_free &&
+         a.is_phase_begin == b.is_phase_begin &&
+         a.is_phase_end == b.is_phase_end &&
+         a.is_sample_rate == b.is_sample_rate;
+}
+
+// Length of the identical prefix shared by the baseline and new traces
+[[nodiscard]] inline size_t
+common_trace_prefix(const std::vector<TraceEvent> &baseline,
+                    const std::vector<TraceEvent> &current) {
+  size_t limit = std::min(baseline.size(), current.size());
+  for (size_t i = 0; i < limit; i++) {
+    if (!same_trace_event(baseline[i], current[i])) {
+      return i;
+    }
+  }
+  return limit;
+}
+
+struct IncrementalPlan {
+  size_t prefix_events = 0;     // Length of the identical trace prefix
+  size_t resume_offset = 0;     // Event offset of the chosen snapshot
+  std::string checkpoint_path;  // Empty = no usable snapshot, simulate all
+};
+
+// Pick the newest snapshot of a --checkpoint-keep series
+// (<checkpoint_base>.<offset>) whose offset lies within the identical
+// prefix. Snapshots past the divergence carry state the new trace never
+// produced and are skipped.
+[[nodiscard]] inline IncrementalPlan
+plan_incremental(size_t prefix_events, const std::string &checkpoint_base) {
+  IncrementalPlan plan;
+  plan.prefix_events = prefix_events;
+
+  size_t slash = checkpoint_base.find_last_of('/');
+  std::string dir = slash == std::string::npos
+                        ? "."
+                        : checkpoint_base.substr(0, slash);
+  std::string stem = slash == std::string::npos
+                         ? checkpoint_base
+                         : checkpoint_base.substr(slash + 1);
+
+  DIR *d = opendir(dir.c_str());
+  if (!d) {
+    return plan;
+  }
+  while (struct dirent *entry = readdir(d)) {
+    std::string name = entry->d_name;
+    if (name.size() <= stem.size() + 1 || name.compare(0, stem.size(), stem) != 0 ||
+        name[stem.size()] != '.') {
+      continue;
+    }
+    std::string suffix = name.substr(stem.size() + 1);
+    size_t offset = 0;
+    bool numeric = !suffix.empty();
+    for (char c : suffix) {
+      if (c < '0' || c > '9') {
+        numeric = false;
+        break;
+      }
+      offset = offset * 10 + (c - '0');
+    }
+    if (numeric && offset <= prefix_events && offset >= plan.resume_offset) {
+      plan.resume_offset = offset;
+      plan.checkpoint_path = dir + "/" + name;
+    }
+  }
+  closedir(d);
+  return plan;
+}
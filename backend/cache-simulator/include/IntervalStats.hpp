@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "Prefetcher.hpp"
+
+/**
+ * IntervalSeries - per-interval time-series of the headline counters.
+ *
+ * End-of-run averages hide phase behavior: a short bad phase can cause
+ * most of the misses while barely moving the aggregate hit rate. This
+ * records a snapshot of the existing accumulators every N events and
+ * stores the per-interval deltas in columnar arrays (one vector per
+ * counter), which serialize compactly and plot directly.
+ *
+ * There is no per-event cost: the simulator already maintains the
+ * cumulative counters, so an interval boundary is a handful of
+ * subtractions. record() takes cumulative values and stores deltas
+ * against the previous boundary.
+ */
+class IntervalSeries {
+public:
+  explicit IntervalSeries(uint64_t granularity) : granularity_(granularity) {}
+
+  // Snapshot at an interval boundary; all arguments are cumulative except
+  // wss, which is the sketch's per-window estimate (the caller resets the
+  // window after recording)
+  void record(uint64_t events_done, const CacheStats &l1d,
+              const CacheStats &l2, const CacheStats &l3,
+              uint64_t invalidations, const PrefetchStats &prefetch,
+              uint64_t wss) {
+    events.push_back(events_done);
+    l1d_hits.push_back(l1d.hits - prev_l1d_.hits);
+    l1d_misses.push_back(l1d.misses - prev_l1d_.misses);
+    l2_hits.push_back(l2.hits - prev_l2_.hits);
+    l2_misses.push_back(l2.misses - prev_l2_.misses);
+    l3_hits.push_back(l3.hits - prev_l3_.hits);
+    l3_misses.push_back(l3.misses - prev_l3_.misses);
+    this->invalidations.push_back(invalidations - prev_invalidations_);
+    prefetch_issued.push_back(prefetch.prefetches_issued - prev_prefetch_.prefetches_issued);
+    prefetch_useful.push_back(prefetch.prefetches_useful - prev_prefetch_.prefetches_useful);
+    wss_lines.push_back(wss);
+
+    prev_l1d_ = l1d;
+    prev_l2_ = l2;
+    prev_l3_ = l3;
+    prev_invalidations_ = invalidations;
+    prev_prefetch_ = prefetch;
+  }
+
+  [[nodiscard]] uint64_t granularity() const { return granularity_; }
+  [[nodiscard]] size_t size() const { return events.size(); }
+  [[nodiscard]] bool empty() const { return events.empty(); }
+
+  // Columnar storage: index i across all vectors is interval i
+  std::vector<uint64_t> events; // cumulative event count at the boundary
+  std::vector<uint64_t> l1d_hits, l1d_misses;
+  std::vector<uint64_t> l2_hits, l2_misses;
+  std::vector<uint64_t> l3_hits, l3_misses;
+  std::vector<uint64_t> invalidations;
+  std::vector<uint64_t> prefetch_issued, prefetch_useful;
+  std::vector<uint64_t> wss_lines; // distinct lines touched in the interval
+
+private:
+  uint64_t granularity_;
+  CacheStats prev_l1d_, prev_l2_, prev_l3_;
+  uint64_t prev_invalidations_ = 0;
+  PrefetchStats prev_prefetch_;
+};
@@ -6,12 +6,17 @@
 #include <vector>
 
 #include "../profiles/CacheConfig.hpp"
+#include "BranchTargetBuffer.hpp"
 #include "CacheLevel.hpp"
 #include "CacheStats.hpp"
+#include "CompressedCacheModel.hpp"
+#include "IntervalStats.hpp"
+#include "LatencyHistogram.hpp"
 #include "MultiCoreCacheSystem.hpp"
 #include "MultiCoreTraceProcessor.hpp"
 #include "OptimizationSuggester.hpp"
 #include "Prefetcher.hpp"
+#include "ReuseDistance.hpp"
 #include "TLB.hpp"
 #include "TraceProcessor.hpp"
 
@@ -84,6 +89,45 @@ public:
      */
     static void write_tlb_stats(std::ostream& out, const TLBHierarchyStats& stats);
 
+    // ========== Branch Target Buffer ==========
+
+    /**
+     * Write BTB statistics as JSON.
+     * Lookups count discontinuous fetches (taken branches); mispredicts
+     * are entries found with a stale target.
+     */
+    static void write_btb_stats(std::ostream& out, const BTBStats& stats);
+
+    // ========== Compressed L3 ==========
+
+    /**
+     * Write the compressed-L3 what-if comparison as JSON: the shadow
+     * model's hit rate against the real L3's on the same stream, the
+     * average BDI compression ratio, and the sampled-hint histogram.
+     */
+    static void write_compression(std::ostream& out,
+                                  const CompressedCacheModel& model,
+                                  const CacheStats& l3_stats);
+
+    // ========== Set-Associative Remap ==========
+
+    /**
+     * Write the conflict-miss remap what-if as JSON: each candidate
+     * geometry's misses and avoided-miss count against the baseline
+     * shadow, plus the most-fixable hot lines (--remap).
+     */
+    static void write_remap(std::ostream& out, const RemapAnalysis& remap);
+
+    // ========== Region Breakdown ==========
+
+    /**
+     * Write the stack/global/heap/other traffic breakdown as JSON
+     * (TraceProcessor::get_region_stats, indexed by RegionKind).
+     */
+    static void write_region_stats(
+        std::ostream& out,
+        const std::array<RegionStats, REGION_KIND_COUNT>& regions);
+
     // ========== Timing Statistics ==========
 
     /**
@@ -94,10 +138,16 @@ public:
      * @param timing The timing statistics
      * @param total_accesses Total number of accesses for average calculation
      * @param latency The latency configuration used
+     * @param dram The DRAM geometry/timing used for the row-buffer model
+     * @param lat_hist Per-access latency distribution; when present the
+     *        timing block gains a "latency" object with percentiles
+     *        (avgLatency hides the hit/miss bimodality the tail shows)
      */
     static void write_timing_stats(std::ostream& out, const TimingStats& timing,
                                    uint64_t total_accesses,
-                                   const LatencyConfig& latency);
+                                   const LatencyConfig& latency,
+                                   const DramConfig& dram = {},
+                                   const LatencyHistogram* lat_hist = nullptr);
 
     /**
      * Write timing statistics for multi-core mode (calculated from stats).
@@ -109,6 +159,25 @@ public:
                                               const CacheStats& l3,
                                               const LatencyConfig& latency);
 
+    // ========== Bandwidth / Roofline ==========
+
+    /**
+     * Write per-link bandwidth counters and a roofline-style verdict as JSON.
+     * Achieved bytes/cycle on each hierarchy link are held against the
+     * preset's configured peaks (BandwidthConfig) to separate latency-bound
+     * runs from bandwidth-saturated ones.
+     *
+     * @param out Output stream
+     * @param bw Bytes moved per link during the run
+     * @param total_cycles Simulated cycle count the bytes are divided by
+     * @param peak Per-link peak bandwidths from the hardware preset
+     * @param has_l3 Whether the hierarchy has an L3 (no-L3 presets move
+     *               L2 traffic straight to memory, so the L2-L3 link is omitted)
+     */
+    static void write_bandwidth(std::ostream& out, const BandwidthStats& bw,
+                                uint64_t total_cycles,
+                                const BandwidthConfig& peak, bool has_l3);
+
     // ========== Hot Lines ==========
 
     /**
@@ -159,6 +228,13 @@ public:
     static void write_prefetch_stats(std::ostream& out, std::string_view policy_name,
                                      int degree, const PrefetchStats& stats);
 
+    /**
+     * Write one prefetcher's feedback-throttle adaptation as a compact
+     * JSON object: the final degree plus the per-epoch timeline of
+     * accuracy samples and the degree chosen after each.
+     */
+    static void write_throttle(std::ostream& out, const Prefetcher& pf);
+
     // ========== Cache Configuration ==========
 
     /**
@@ -166,6 +242,42 @@ public:
      */
     static void write_cache_config(std::ostream& out, const CacheHierarchyConfig& cfg);
 
+    // ========== Reuse Distance / Miss-Ratio Curve ==========
+
+    /**
+     * Write reuse-distance analysis results as a JSON object.
+     * Emits the miss-ratio curve for power-of-two cache sizes plus the
+     * cold-miss and distinct-line totals behind it.
+     *
+     * @param out Output stream
+     * @param mrc The reuse-distance analyzer fed with the full trace
+     * @param line_size Cache line size used when feeding the analyzer
+     */
+    static void write_mrc(std::ostream& out, const ReuseDistanceAnalyzer& mrc,
+                          uint32_t line_size);
+
+    // ========== Belady OPT Comparison ==========
+
+    /**
+     * Write the Belady-optimal replacement comparison as a JSON object.
+     * For each level: the configured policy, the hit rate it achieved, the
+     * hit rate OPT achieved on the same stream, and the headroom between
+     * them. Small headroom means replacement is not the bottleneck.
+     *
+     * @param out Output stream
+     * @param cfg Hierarchy config (names the achieved policies)
+     * @param achieved_l1/l2/l3 Stats from the configured-policy run
+     * @param opt_l1/l2/l3 Stats from the OPT replay
+     */
+    static void write_opt_comparison(std::ostream& out,
+                                     const CacheHierarchyConfig& cfg,
+                                     const CacheStats& achieved_l1,
+                                     const CacheStats& achieved_l2,
+                                     const CacheStats& achieved_l3,
+                                     const CacheStats& opt_l1,
+                                     const CacheStats& opt_l2,
+                                     const CacheStats& opt_l3);
+
     // ========== Coherence Statistics ==========
 
     /**
@@ -195,6 +307,41 @@ public:
         uint32_t line;
     };
 
+    // ========== Interval Time-Series ==========
+
+    /**
+     * Write the per-interval time-series as a compact columnar object:
+     * one array per counter, index i across all arrays is interval i.
+     * The hierarchy config supplies per-level capacities in lines so the
+     * working-set column plots directly against them.
+     * Emitted with a trailing comma (mid-document section).
+     */
+    static void write_intervals(std::ostream& out, const IntervalSeries& series,
+                                const CacheHierarchyConfig& cfg);
+
+    /**
+     * Minimal hot-line view for periodic stats snapshots - just enough
+     * for a "top offenders so far" list, shared between the single-core
+     * and multi-core callers.
+     */
+    struct HotLineBrief {
+        std::string_view file;
+        uint32_t line;
+        uint64_t misses;
+    };
+
+    /**
+     * Write one --stream-stats snapshot as a single NDJSON line.
+     * Level stats are deltas since the previous snapshot (the UI
+     * accumulates them; deltas keep each line small and make phase
+     * changes directly visible); events and hot lines are cumulative.
+     */
+    static void write_stats_snapshot(std::ostream& out, uint64_t events,
+                                     const CacheStats& l1d_delta,
+                                     const CacheStats& l2_delta,
+                                     const CacheStats& l3_delta,
+                                     const std::vector<HotLineBrief>& hot);
+
     /**
      * Write streaming mode progress message.
      */
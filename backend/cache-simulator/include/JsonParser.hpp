@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * JsonParser - minimal recursive-descent JSON reader.
+ *
+ * The simulator only ever wrote JSON until --diff needed to read a
+ * prior result document back. This is deliberately small: enough of
+ * RFC 8259 to round-trip our own output (objects, arrays, strings with
+ * the escapes we emit, numbers, booleans, null). It builds a DOM and
+ * favors clarity over speed - baseline files are a few hundred KB and
+ * parsed once per run.
+ */
+class JsonValue {
+public:
+  enum class Type { Null, Boolean, Number, String, Array, Object };
+
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<JsonValue> array;
+  // Ordered map keeps output deterministic if anyone re-serializes
+  std::map<std::string, JsonValue> object;
+
+  // Object member lookup; nullptr when absent or not an object
+  [[nodiscard]] const JsonValue *find(const std::string &key) const {
+    if (type != Type::Object)
+      return nullptr;
+    auto it = object.find(key);
+    return it != object.end() ? &it->second : nullptr;
+  }
+
+  // Nested lookup: find("levels","l1d") walks two object levels
+  template <typename... Keys>
+  [[nodiscard]] const JsonValue *find(const std::string &key,
+                                      Keys &&...rest) const {
+    const JsonValue *child = find(key);
+    return child ? child->find(std::forward<Keys>(rest)...) : nullptr;
+  }
+
+  [[nodiscard]] uint64_t as_u64(uint64_t fallback = 0) const {
+    return type == Type::Number ? static_cast<uint64_t>(number) : fallback;
+  }
+  [[nodiscard]] double as_double(double fallback = 0.0) const {
+    return type == Type::Number ? number : fallback;
+  }
+  [[nodiscard]] const std::string &as_string() const { return string; }
+};
+
+class JsonParser {
+public:
+  // Returns nullopt on malformed input
+  static std::optional<JsonValue> parse(std::string_view text) {
+    JsonParser p(text);
+    JsonValue v;
+    if (!p.parse_value(v))
+      return std::nullopt;
+    p.skip_ws();
+    if (p.pos_ != p.text_.size()) // trailing garbage
+      return std::nullopt;
+    return v;
+  }
+
+private:
+  explicit JsonParser(std::string_view text) : text_(text) {}
+
+  void skip_ws() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' ||
+            text_[pos_] == '\r'))
+      pos_++;
+  }
+
+  [[nodiscard]] bool consume(char c) {
+    skip_ws();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] bool literal(std::string_view word) {
+    if (text_.substr(pos_, word.size()) != word)
+      return false;
+    pos_ += word.size();
+    return true;
+  }
+
+  bool parse_value(JsonValue &out) {
+    skip_ws();
+    if (pos_ >= text_.size())
+      return false;
+    switch (text_[pos_]) {
+    case '{': return parse_object(out);
+    case '[': return parse_array(out);
+    case '"': out.type = JsonValue::Type::String; return parse_string(out.string);
+    case 't': out.type = JsonValue::Type::Boolean; out.boolean = true; return literal("true");
+    case 'f': out.type = JsonValue::Type::Boolean; out.boolean = false; return literal("false");
+    case 'n': out.type = JsonValue::Type::Null; return literal("null");
+    default: return parse_number(out);
+    }
+  }
+
+  bool parse_object(JsonValue &out) {
+    out.type = JsonValue::Type::Object;
+    pos_++; // '{'
+    if (consume('}'))
+      return true;
+    while (true) {
+      skip_ws();
+      std::string key;
+      if (pos_ >= text_.size() || text_[pos_] != '"' || !parse_string(key))
+        return false;
+      if (!consume(':'))
+        return false;
+      JsonValue member;
+      if (!parse_value(member))
+        return false;
+      out.object.emplace(std::move(key), std::move(member));
+      if (consume(','))
+        continue;
+      return consume('}');
+    }
+  }
+
+  bool parse_array(JsonValue &out) {
+    out.type = JsonValue::Type::Array;
+    pos_++; // '['
+    if (consume(']'))
+      return true;
+    while (true) {
+      JsonValue element;
+      if (!parse_value(element))
+        return false;
+      out.array.push_back(std::move(element));
+      if (consume(','))
+        continue;
+      return consume(']');
+    }
+  }
+
+  bool parse_string(std::string &out) {
+    pos_++; // opening quote
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"')
+        return true;
+      if (c == '\\') {
+        if (pos_ >= text_.size())
+          return false;
+        char esc = text_[pos_++];
+        switch (esc) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u':
+          // We never emit \u escapes; skip the four hex digits and keep
+          // a placeholder rather than failing on foreign documents
+          if (pos_ + 4 > text_.size())
+            return false;
+          pos_ += 4;
+          out += '?';
+          break;
+        default: return false;
+        }
+      } else {
+        out += c;
+      }
+    }
+    return false; // unterminated
+  }
+
+  bool parse_number(JsonValue &out) {
+    size_t start = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-')
+      pos_++;
+    while (pos_ < text_.size() &&
+           ((text_[pos_] >= '0' && text_[pos_] <= '9') || text_[pos_] == '.' ||
+            text_[pos_] == 'e' || text_[pos_] == 'E' || text_[pos_] == '+' ||
+            text_[pos_] == '-'))
+      pos_++;
+    if (pos_ == start)
+      return false;
+    try {
+      out.number = std::stod(std::string(text_.substr(start, pos_ - start)));
+    } catch (const std::exception &) {
+      return false;
+    }
+    out.type = JsonValue::Type::Number;
+    return true;
+  }
+
+  std::string_view text_;
+  size_t pos_ = 0;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * JsonWriter - single-buffer JSON appender.
+ *
+ * The result document used to be built with ostream operator<< chains:
+ * every number went through locale-aware formatting and every fragment
+ * was a separate stream write, which dominated output time on reports
+ * with large hotLines/falseSharing/cacheState sections. This writer
+ * appends into one preallocated buffer instead - numbers via
+ * std::to_chars, strings via memcpy - and hands the finished section
+ * to the stream in a single write.
+ *
+ * Two modes:
+ *   - Buffered (default): append everything, then flush(out) once.
+ *   - Streaming: call stream_to(out) first and the buffer drains to the
+ *     sink whenever it crosses the watermark, so multi-megabyte sections
+ *     (the full cache-state dump) are emitted as they are computed
+ *     instead of being held in memory.
+ */
+class JsonWriter {
+public:
+  explicit JsonWriter(size_t reserve_bytes = 4096) { buf_.reserve(reserve_bytes); }
+
+  // Switch to streaming mode: drain to sink whenever the buffer crosses
+  // the watermark. The final partial chunk still needs a flush() call.
+  void stream_to(std::ostream &sink, size_t watermark = 64 * 1024) {
+    sink_ = &sink;
+    watermark_ = watermark;
+  }
+
+  void raw(std::string_view s) {
+    buf_.append(s.data(), s.size());
+    maybe_drain();
+  }
+
+  void raw(char c) {
+    buf_.push_back(c);
+    maybe_drain();
+  }
+
+  // String literal contents with JSON escaping (same set the old
+  // escape() handled: quote and backslash)
+  void escaped(std::string_view s) {
+    for (char c : s) {
+      if (c == '"' || c == '\\')
+        buf_.push_back('\\');
+      buf_.push_back(c);
+    }
+    maybe_drain();
+  }
+
+  void number(uint64_t v) { append_chars(v); }
+  void number(int64_t v) { append_chars(v); }
+  void number(uint32_t v) { append_chars(v); }
+  void number(int v) { append_chars(v); }
+
+  // Fixed-point double, matching what std::fixed << setprecision(p)
+  // used to produce
+  void fixed(double v, int precision) {
+    char tmp[48];
+    auto [p, ec] =
+        std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::fixed, precision);
+    if (ec == std::errc{})
+      buf_.append(tmp, static_cast<size_t>(p - tmp));
+    maybe_drain();
+  }
+
+  // Hex without the 0x prefix (callers add it inside their quoting)
+  void hex(uint64_t v) {
+    char tmp[20];
+    auto [p, ec] = std::to_chars(tmp, tmp + sizeof(tmp), v, 16);
+    if (ec == std::errc{})
+      buf_.append(tmp, static_cast<size_t>(p - tmp));
+    maybe_drain();
+  }
+
+  void boolean(bool b) { raw(b ? std::string_view("true") : std::string_view("false")); }
+
+  // Write everything still buffered to out in one call
+  void flush(std::ostream &out) {
+    out.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    buf_.clear();
+  }
+
+  [[nodiscard]] std::string_view view() const { return buf_; }
+  void clear() { buf_.clear(); }
+
+private:
+  template <typename T> void append_chars(T v) {
+    char tmp[24];
+    auto [p, ec] = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    if (ec == std::errc{})
+      buf_.append(tmp, static_cast<size_t>(p - tmp));
+    maybe_drain();
+  }
+
+  void maybe_drain() {
+    if (sink_ != nullptr && buf_.size() >= watermark_)
+      flush(*sink_);
+  }
+
+  std::string buf_;
+  std::ostream *sink_ = nullptr;
+  size_t watermark_ = 0;
+};
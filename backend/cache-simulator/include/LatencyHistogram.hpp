@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Checkpoint.hpp"
+
+// HDR-style per-access latency histogram. avgLatency hides the bimodality
+// of cache timing - a stream of 4-cycle L1 hits with a few hundred-cycle
+// DRAM round trips averages to a number nothing actually experienced, and
+// it is the tail that tracks observed service latency. Buckets are
+// power-of-two octaves split into 16 linear sub-buckets, so record() is a
+// constant-time increment (no allocation, no sort) and any recorded value
+// lands within 1/16 (~6%) of its bucket's representative. Percentiles are
+// resolved once at report time by a cumulative walk.
+class LatencyHistogram {
+public:
+  static constexpr int SUB_BUCKET_BITS = 4;
+  static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  // Values below SUB_BUCKETS are exact; each later octave adds SUB_BUCKETS
+  // counters, covering the full 64-bit range
+  static constexpr size_t BUCKET_COUNT =
+      static_cast<size_t>(64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  void record(uint64_t cycles) {
+    count_++;
+    if (cycles > max_) {
+      max_ = cycles;
+    }
+    buckets_[bucket_index(cycles)]++;
+  }
+
+  [[nodiscard]] uint64_t count() const { return count_; }
+  [[nodiscard]] uint64_t max() const { return max_; }
+
+  // Value at quantile q in (0, 1]: the representative of the bucket
+  // holding the ceil(q * count)-th smallest sample, clamped to the true
+  // maximum so p100 never overshoots. Returns 0 when nothing was recorded.
+  [[nodiscard]] uint64_t percentile(double q) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(q * static_cast<double>(count_));
+    if (target < 1) {
+      target = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+      seen += buckets_[i];
+      if (seen >= target) {
+        uint64_t rep = bucket_representative(i);
+        return rep < max_ ? rep : max_;
+      }
+    }
+    return max_;
+  }
+
+  void reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    max_ = 0;
+  }
+
+  // Checkpointing: the tail of a restored run is only meaningful if it
+  // includes the warm-up's samples
+  void save_state(CheckpointWriter &w) const {
+    w.write(count_);
+    w.write(max_);
+    for (uint64_t b : buckets_) {
+      w.write(b);
+    }
+  }
+
+  void load_state(CheckpointReader &r) {
+    count_ = r.read<uint64_t>();
+    max_ = r.read<uint64_t>();
+    for (uint64_t &b : buckets_) {
+      b = r.read<uint64_t>();
+    }
+  }
+
+private:
+  // Octave = position of the value's leading bit; within an octave the
+  // top SUB_BUCKET_BITS bits below it pick the linear sub-bucket
+  static size_t bucket_index(uint64_t v) {
+    if (v < SUB_BUCKETS) {
+      return static_cast<size_t>(v);
+    }
+    int msb = 63 - __builtin_clzll(v);
+    int shift = msb - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(v >> shift) - SUB_BUCKETS;
+    return static_cast<size_t>(msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+  }
+
+  // Midpoint of the bucket's value range (exact below SUB_BUCKETS)
+  static uint64_t bucket_representative(size_t index) {
+    if (index < SUB_BUCKETS) {
+      return static_cast<uint64_t>(index);
+    }
+    size_t octave = index / SUB_BUCKETS;
+    size_t sub = index % SUB_BUCKETS;
+    int shift = static_cast<int>(octave) - 1;
+    uint64_t lo = (static_cast<uint64_t>(SUB_BUCKETS) + sub) << shift;
+    uint64_t width = 1ULL << shift;
+    return lo + (width >> 1);
+  }
+
+  std::array<uint64_t, BUCKET_COUNT> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t max_ = 0;
+};
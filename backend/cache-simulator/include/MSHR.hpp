@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "Checkpoint.hpp"
+
+// Miss-status holding registers: memory-level-parallelism accounting
+//
+// The flat timing model charges every miss its full latency, as if the
+// core drained one miss before issuing the next. Real cores keep misses
+// in MSHRs and overlap them, so two independent DRAM misses cost little
+// more than one. This models that: a virtual issue clock advances per
+// access, each primary miss occupies an entry until its fill completes,
+// a second miss to an in-flight line merges instead of re-requesting,
+// and when all entries are busy the core stalls until one frees up.
+//
+// Accounting lands in TimingStats: serialized_miss_cycles is the sum of
+// miss latencies (what total_cycles already charges), and
+// overlapped_miss_cycles is the union of the miss busy intervals - the
+// cost a core with this many MSHRs actually pays. Their ratio is the
+// achieved memory-level parallelism.
+class MSHRSet {
+public:
+  static constexpr size_t DEFAULT_ENTRIES = 10;
+
+  explicit MSHRSet(size_t entries = DEFAULT_ENTRIES)
+      : capacity_(entries ? entries : 1) {}
+
+  // Account a miss issued at time now that needs latency cycles to fill.
+  // Advances now past any full-MSHR stall.
+  void on_miss(uint64_t line, uint64_t &now, uint64_t latency,
+               TimingStats &timing) {
+    retire(now);
+
+    // Secondary miss to an in-flight line: merged, no new request
+    for (const auto &e : inflight_) {
+      if (e.line == line) {
+        timing.mshr_merges++;
+        return;
+      }
+    }
+
+    if (inflight_.size() >= capacity_) {
+      // All entries busy: the core stalls until the earliest fill lands
+      size_t earliest = 0;
+      for (size_t i = 1; i < inflight_.size(); i++) {
+        if (inflight_[i].ready_at < inflight_[earliest].ready_at)
+          earliest = i;
+      }
+      uint64_t freed_at = inflight_[earliest].ready_at;
+      timing.mshr_full_stalls++;
+      timing.mshr_stall_cycles += freed_at - now;
+      now = freed_at;
+      retire(now);
+    }
+
+    uint64_t ready = now + latency;
+    inflight_.push_back({line, ready});
+    timing.serialized_miss_cycles += latency;
+    // Union of busy intervals: only the part past the current busy
+    // horizon adds wall-clock cost
+    uint64_t overlap_start = std::max(now, busy_until_);
+    if (ready > overlap_start)
+      timing.overlapped_miss_cycles += ready - overlap_start;
+    busy_until_ = std::max(busy_until_, ready);
+  }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+  [[nodiscard]] size_t in_flight() const { return inflight_.size(); }
+
+  void clear() {
+    inflight_.clear();
+    busy_until_ = 0;
+  }
+
+  // Checkpointing: serialize/restore the in-flight misses
+  void save_state(CheckpointWriter &w) const {
+    w.write<uint64_t>(capacity_);
+    w.write_vec(inflight_);
+    w.write(busy_until_);
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.expect<uint64_t>(capacity_, "MSHR entries");
+    r.read_vec(inflight_);
+    busy_until_ = r.read<uint64_t>();
+  }
+
+private:
+  struct Entry {
+    uint64_t line;
+    uint64_t ready_at;
+  };
+
+  void retire(uint64_t now) {
+    inflight_.erase(std::remove_if(inflight_.begin(), inflight_.end(),
+                                   [now](const Entry &e) {
+                                     return e.ready_at <= now;
+                                   }),
+                    inflight_.end());
+  }
+
+  size_t capacity_;
+  std::vector<Entry> inflight_;
+  uint64_t busy_until_ = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <optional>
 #include <string_view>
@@ -11,12 +12,14 @@
 #include "CacheLevel.hpp"
 #include "CacheStats.hpp"
 #include "CoherenceController.hpp"
+#include "CoherenceMemo.hpp"
+#include "FlatMap.hpp"
 #include "Prefetcher.hpp"
 #include "TLB.hpp"
 
 struct FalseSharingEvent {
   uint64_t cache_line_addr;
-  std::string file;
+  std::string_view file; // interned via FileTable - stable for the whole run
   uint32_t line;
   uint32_t thread_id;
   bool is_write;
@@ -26,7 +29,7 @@ struct FalseSharingEvent {
 struct FalseSharingReport {
   uint64_t cache_line_addr;
   std::vector<FalseSharingEvent> accesses;
-  uint32_t invalidation_count = 0;
+  uint64_t invalidation_count = 0;  // coherence events this line caused
 };
 
 struct MultiCoreStats {
@@ -35,9 +38,51 @@ struct MultiCoreStats {
   CacheStats l3;
   uint64_t coherence_invalidations = 0;
   uint64_t false_sharing_events = 0;
+  // Protocol-specific coherence traffic (see CoherenceController getters)
+  uint64_t snoop_writebacks = 0;
+  uint64_t dirty_shares = 0;
+  uint64_t forwards = 0;
   std::vector<PrefetchStats> prefetch_per_core;  // Per-core prefetch statistics
 };
 
+// Thread-to-core placement policy (see set_thread_placement). Explicit
+// per-thread pins layer on top of either policy via pin_thread.
+enum class ThreadPlacement {
+  Scatter,  // Spread threads breadth-first across LLC domains (default)
+  Compact   // Fill each CCX/socket before spilling to the next
+};
+
+// NUMA page-placement policy over the trace's address space
+enum class NumaPlacement {
+  FirstTouch,  // Page homed on the socket that touches it first (Linux default)
+  Interleave   // Pages striped round-robin across sockets
+};
+
+struct NumaStats {
+  int sockets = 1;
+  NumaPlacement placement = NumaPlacement::FirstTouch;
+  uint64_t local_accesses = 0;   // DRAM accesses served by the home socket
+  uint64_t remote_accesses = 0;  // DRAM accesses that crossed the interconnect
+
+  [[nodiscard]] double remote_ratio() const {
+    uint64_t total = local_accesses + remote_accesses;
+    return total ? static_cast<double>(remote_accesses) / total : 0.0;
+  }
+};
+
+// Per-source-line NUMA traffic for the report
+struct NumaLineStat {
+  std::string_view file;  // interned via FileTable - stable for the whole run
+  uint32_t line;
+  uint64_t local;
+  uint64_t remote;
+
+  [[nodiscard]] double remote_ratio() const {
+    uint64_t total = local + remote;
+    return total ? static_cast<double>(remote) / total : 0.0;
+  }
+};
+
 struct MultiCoreAccessResult {
   bool l1_hit;
   bool l2_hit;
@@ -51,38 +96,161 @@ private:
   std::vector<std::unique_ptr<CacheLevel>> l1_caches;
   std::vector<std::unique_ptr<Prefetcher>> prefetchers;  // Per-core prefetchers
   std::vector<std::unique_ptr<TLB>> dtlbs;  // Per-core data TLBs
+  std::vector<std::unique_ptr<TLB>> stlbs;  // Per-core unified second-level TLBs
   CacheLevel l2;
   std::optional<CacheLevel> l3_;  // Optional L3 (some CPUs like RPi4 don't have L3)
   CoherenceController coherence;
 
+  // Sliced L3 topology: cores split into contiguous blocks and each block
+  // gets a private L3 slice (l3_slices replaces l3_). Used by both NUMA
+  // mode (one slice per socket) and CCX mode (one slice per core complex,
+  // see enable_ccx_topology). A core missing its own slice goes to memory;
+  // it never probes a neighbor's slice.
+  std::vector<std::unique_ptr<CacheLevel>> l3_slices;
+  int cores_per_l3_slice = 0;  // 0 = monolithic shared L3
+  int ccx_size = 0;            // cores per CCX (0 = no CCX topology)
+
+  // Multi-socket (NUMA) mode: pages get a home socket by placement
+  // policy; a DRAM access from the wrong socket counts as interconnect
+  // traffic.
+  int num_sockets = 1;
+  NumaPlacement numa_placement = NumaPlacement::FirstTouch;
+  std::unordered_map<uint64_t, int> page_home;  // first-touch placement
+  uint64_t numa_local = 0;
+  uint64_t numa_remote = 0;
+  struct NumaLineCounts {
+    uint64_t local = 0;
+    uint64_t remote = 0;
+  };
+  std::unordered_map<uint64_t, NumaLineCounts> numa_by_line;  // (file_id<<32)|line
+  static constexpr uint64_t NUMA_PAGE_SIZE = 4096;
+
+  [[nodiscard]] int socket_of_core(int core) const {
+    return core / (num_cores / num_sockets);
+  }
+
+  // The L3 slice serving this core: the core block's own slice when the
+  // L3 is sliced, the shared L3 otherwise, nullptr when the preset has
+  // no L3
+  [[nodiscard]] CacheLevel *l3_for_core(int core) {
+    if (!l3_slices.empty())
+      return l3_slices[core / cores_per_l3_slice].get();
+    return l3_.has_value() ? &*l3_ : nullptr;
+  }
+
+  // Replace the monolithic l3_ with one slice per block of
+  // cores_per_slice cores, each with the preset's full L3 geometry
+  void build_l3_slices(int cores_per_slice);
+
+  void record_numa_access(int core, uint64_t address, std::string_view file,
+                          uint32_t line);
+
   // Helper to check if L3 exists
-  [[nodiscard]] bool has_l3() const { return l3_.has_value(); }
+  [[nodiscard]] bool has_l3() const {
+    return l3_.has_value() || !l3_slices.empty();
+  }
 
   PrefetchPolicy prefetch_policy = PrefetchPolicy::NONE;
   int prefetch_degree = 2;
 
   std::unordered_map<uint32_t, int> thread_to_core;
   int next_core = 0;
+  ThreadPlacement thread_placement = ThreadPlacement::Scatter;
+  // Explicit thread pins (pin_thread). Pinned threads never consume a
+  // policy slot, so the policy keeps assigning the unpinned ones as if
+  // the pins weren't there.
+  std::unordered_map<uint32_t, int> pinned_threads;
 
   struct LineAccess {
     uint32_t thread_id;
     uint32_t byte_offset;
     bool is_write;
-    std::string file;
+    uint32_t file_id;  // FileTable ID - resolved to a name at report time
     uint32_t line;
   };
-  std::unordered_map<uint64_t, std::vector<LineAccess>> line_accesses;
+
+  // Evidence samples kept per cache line for FalseSharingReport
+  static constexpr uint32_t FALSE_SHARING_SAMPLES = 16;
+
+  // Bounded false-sharing tracker (one per observed cache line).
+  //
+  // Detection only needs "more than one thread, more than one byte offset,
+  // at least one write", which a handful of scalar fields answer exactly -
+  // no access history required. Evidence for the report is a fixed
+  // reservoir of sampled accesses (Algorithm R), so every access has an
+  // equal chance of appearing and memory per line is constant no matter
+  // how long the trace runs.
+  struct LineTracker {
+    uint32_t first_thread = 0;
+    uint32_t first_offset = 0;
+    bool saw_second_thread = false;
+    bool saw_second_offset = false;
+    bool has_write = false;
+    uint64_t total_accesses = 0;
+    uint64_t invalidations = 0;  // coherence events charged to this line
+    uint32_t sample_count = 0;
+    std::array<LineAccess, FALSE_SHARING_SAMPLES> samples;
+  };
+  FlatMap<uint64_t, LineTracker> line_trackers;
   std::unordered_set<uint64_t> false_sharing_lines;
 
+  // Cap on how many distinct cache lines get a tracker at once. When the
+  // budget is hit, an unflagged line is recycled; flagged lines keep
+  // their evidence.
+  size_t false_sharing_line_budget = 1 << 16;
+
   uint64_t coherence_invalidations = 0;
   uint64_t false_sharing_count = 0;
   uint32_t line_size;
 
+  // Coherence memo (see CoherenceMemo.hpp): repeated shared-line snoops
+  // replay their recorded transition instead of re-probing every peer.
+  //
+  // line_states is the exact per-line snapshot the memo keys on - one
+  // CoherenceState nibble per core, adopted the first time a snoop finds
+  // the line shared and kept current at every point the line's copies
+  // change (installs, upgrades, evictions, replayed transitions). A line
+  // absent from the snapshot map simply takes the full controller path,
+  // so dropping snapshots (budget, parallel epochs) is always safe.
+  CoherenceMemo coherence_memo;
+  FlatMap<uint64_t, uint64_t> line_states;
+  static constexpr size_t COHERENCE_MEMO_LINE_BUDGET = 1 << 14;
+  bool coherence_memo_enabled = true;
+
+  [[nodiscard]] bool memo_active() const {
+    return coherence_memo_enabled &&
+           num_cores <= CoherenceMemo::MAX_CORES &&
+           coherence.get_mode() == CoherenceMode::Snoop;
+  }
+
+  // Record a core's copy of a tracked line changing state (Invalid when
+  // the copy is gone); untracked lines ignore the update
+  void shadow_update(int core, uint64_t line_addr, CoherenceState state) {
+    auto it = line_states.find(line_addr);
+    if (it != line_states.end())
+      it->second = CoherenceMemo::set_nibble(it->second, core, state);
+  }
+
+  // An L1 fill evicted a victim line silently; if the victim is tracked,
+  // its snapshot must drop this core or the memo would replay against a
+  // copy that no longer exists
+  void shadow_note_eviction(int core, const AccessInfo &info) {
+    if (info.had_eviction)
+      shadow_update(core, get_line_address(info.evicted_address),
+                    CoherenceState::Invalid);
+  }
+
+  void adopt_line_for_memo(uint64_t line_addr);
+
+  // Snoop wrappers around the coherence controller: memo fast path with
+  // fallback to the full request, plus the peer-side state fixups the
+  // request implies (owner downgrade on read, invalidations on write)
+  SnoopResult snoop_read(int core, uint64_t line_addr);
+  SnoopResult snoop_exclusive(int core, uint64_t line_addr);
+
   // Track prefetched addresses per core to measure usefulness
   std::vector<std::unordered_set<uint64_t>> prefetched_addresses_per_core;
 
-  int get_core_for_thread(uint32_t thread_id);
-
   uint64_t get_line_address(uint64_t addr) const {
     return addr & ~(static_cast<uint64_t>(line_size) - 1);
   }
@@ -93,12 +261,22 @@ private:
                                        bool is_write, std::string_view file,
                                        uint32_t line);
 
+  // Attribute a coherence invalidation to the line's tracker so the
+  // false-sharing report can rank lines by how much they actually bounce
+  void charge_invalidation(uint64_t line_addr) {
+    auto it = line_trackers.find(line_addr);
+    if (it != line_trackers.end())
+      it->second.invalidations++;
+  }
+
 public:
   MultiCoreCacheSystem(int cores, const CacheConfig &l1_cfg,
                        const CacheConfig &l2_cfg,
                        const CacheConfig &l3_cfg,
                        PrefetchPolicy pf_policy = PrefetchPolicy::NONE,
-                       int pf_degree = 2);
+                       int pf_degree = 2,
+                       CoherenceMode coherence_mode = CoherenceMode::Auto,
+                       CoherenceProtocol protocol = CoherenceProtocol::MESI);
 
   MultiCoreAccessResult read(uint64_t address, uint32_t thread_id,
                               std::string_view file = "", uint32_t line = 0);
@@ -106,8 +284,41 @@ public:
   MultiCoreAccessResult write(uint64_t address, uint32_t thread_id,
                                std::string_view file = "", uint32_t line = 0);
 
+  // One line-sized access inside a parallel epoch (address already split
+  // to a cache line by the trace processor, like read()/write() callers)
+  struct EpochAccess {
+    uint64_t address;
+    uint32_t thread_id;
+    std::string_view file;
+    uint32_t line;
+    bool is_write;
+  };
+
+  // Simulate a window of accesses with per-core worker threads, producing
+  // results[i] for accesses[i] exactly as the equivalent read()/write()
+  // sequence would.
+  //
+  // The epoch runs in parallel only when it is provably conflict-free:
+  // every line is touched by a single core and no other core may hold it
+  // (checked against the snoop filter / directory). Workers then simulate
+  // their own L1s and TLBs independently - the snoop outcome of every miss
+  // is already known - and defer shared L2/L3 lookups, which are replayed
+  // in trace order afterwards so shared-level LRU and stats match the
+  // sequential path. Returns false without simulating anything when the
+  // epoch has cross-core sharing (or prefetching is enabled, whose fills
+  // cannot be replayed exactly); the caller falls back to read()/write().
+  bool try_process_epoch_parallel(const EpochAccess *accesses, size_t count,
+                                  MultiCoreAccessResult *results,
+                                  int max_threads);
+
   [[nodiscard]] MultiCoreStats get_stats() const;
 
+  // Back all mappings with huge pages (see CacheSystem::set_page_size)
+  void set_page_size(size_t page_size);
+  [[nodiscard]] size_t get_page_size() const {
+    return dtlbs.empty() ? 4096 : dtlbs[0]->get_config().page_size;
+  }
+
   // Get aggregated TLB stats across all cores
   [[nodiscard]] TLBHierarchyStats get_tlb_stats() const;
 
@@ -116,9 +327,73 @@ public:
 
   [[nodiscard]] std::vector<FalseSharingReport> get_false_sharing_reports() const;
 
+  // Cap the number of cache lines tracked for false sharing (memory budget)
+  void set_false_sharing_budget(size_t max_lines) {
+    false_sharing_line_budget = max_lines > 0 ? max_lines : 1;
+  }
+
+  // Split the system into sockets: cores partition into contiguous
+  // blocks and the L3 becomes one private slice per socket. Call before
+  // feeding accesses; sockets must divide the core count.
+  void enable_numa(int sockets, NumaPlacement placement);
+  [[nodiscard]] bool is_numa_enabled() const { return num_sockets > 1; }
+  [[nodiscard]] NumaStats get_numa_stats() const;
+  [[nodiscard]] std::vector<NumaLineStat> get_numa_hot_lines(size_t limit = 10) const;
+
+  // CCX topology (AMD Zen): cores group into core complexes of
+  // cores_per_ccx, each with a private L3 slice of the preset's full L3
+  // size - Zen presets quote the per-CCX capacity, not the package total.
+  // Threads spread breadth-first across CCXes like the Linux scheduler
+  // spreads across LLC domains. Call before feeding accesses;
+  // cores_per_ccx must divide the core count.
+  void enable_ccx_topology(int cores_per_ccx);
+  [[nodiscard]] bool is_ccx_enabled() const { return ccx_size > 0; }
+  [[nodiscard]] int get_num_l3_slices() const {
+    return static_cast<int>(l3_slices.size());
+  }
+
   [[nodiscard]] int get_num_cores() const { return num_cores; }
   [[nodiscard]] uint32_t get_line_size() const { return line_size; }
 
+  // The core a thread's accesses are simulated on (assigned on first
+  // sight, topology-aware under CCX); virtual-time replay keys its
+  // per-core clocks off this mapping
+  int get_core_for_thread(uint32_t thread_id);
+
+  // How unpinned threads land on cores: Scatter spreads breadth-first
+  // across LLC domains (matching the Linux scheduler and the previous
+  // behavior), Compact fills each domain before the next (matching
+  // OMP_PROC_BIND=close). Call before feeding accesses.
+  void set_thread_placement(ThreadPlacement placement) {
+    thread_placement = placement;
+  }
+  [[nodiscard]] ThreadPlacement get_thread_placement() const {
+    return thread_placement;
+  }
+
+  // Pin one thread to a core, overriding the placement policy - mirrors
+  // a production pthread_setaffinity_np layout. Call before feeding
+  // accesses; the core must be in range.
+  void pin_thread(uint32_t thread_id, int core) {
+    pinned_threads[thread_id] = core;
+  }
+  [[nodiscard]] size_t get_pinned_thread_count() const {
+    return pinned_threads.size();
+  }
+
+  // The thread-to-core assignments made so far (pins and policy alike),
+  // for the per-placement report
+  [[nodiscard]] const std::unordered_map<uint32_t, int> &
+  get_thread_map() const {
+    return thread_to_core;
+  }
+  [[nodiscard]] CoherenceMode get_coherence_mode() const {
+    return coherence.get_mode();
+  }
+  [[nodiscard]] CoherenceProtocol get_coherence_protocol() const {
+    return coherence.get_protocol();
+  }
+
   // MESI state query for testing/debugging
   [[nodiscard]] CoherenceState get_l1_coherence_state(int core, uint64_t address) const;
 
@@ -135,6 +410,31 @@ public:
 
   void reset_prefetch_stats();
 
+  // Feedback-directed prefetch throttling (per-core degree adaptation)
+  void enable_prefetch_throttling() {
+    for (auto &pf : prefetchers) {
+      pf->enable_throttling();
+    }
+  }
+  [[nodiscard]] const Prefetcher &get_prefetcher(int core) const {
+    return *prefetchers[core];
+  }
+
   // Fast mode: disable expensive 3C miss classification for performance
   void set_fast_mode(bool enable);
+
+  // Coherence transition memo kill switch (--no-coherence-memo). The memo
+  // is bit-exact, so disabling it only trades speed for simpler debugging.
+  void set_coherence_memo(bool enable) {
+    coherence_memo_enabled = enable;
+    if (!enable)
+      line_states.clear();
+  }
+  [[nodiscard]] const CoherenceMemoStats &get_coherence_memo_stats() const {
+    return coherence_memo.get_stats();
+  }
+
+  // 3C classification Bloom filter: target false-positive rate and health
+  void set_classifier_fp_rate(double fp_rate);
+  [[nodiscard]] ClassifierSummary get_classifier_summary() const;
 };
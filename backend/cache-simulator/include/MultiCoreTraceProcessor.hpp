@@ -1,18 +1,26 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "AdvancedStats.hpp"
+#include "AtomicContention.hpp"
+#include "FlatMap.hpp"
+#include "HotLineTracker.hpp"
 #include "MemoryAccess.hpp"
 #include "MultiCoreCacheSystem.hpp"
+#include "ShardedHotLines.hpp"
+#include "SourceKey.hpp"
 #include "TraceEvent.hpp"
+#include "TraceSampling.hpp"
+#include "WorkingSetEstimator.hpp"
 
 struct MultiCoreSourceStats {
-  std::string file;
+  std::string_view file; // interned via FileTable - stable for the whole run
   uint32_t line;
   uint64_t hits = 0;
   uint64_t misses = 0;
@@ -24,42 +32,238 @@ struct MultiCoreSourceStats {
 class MultiCoreTraceProcessor {
 private:
   MultiCoreCacheSystem cache;
-  std::unordered_map<std::string, MultiCoreSourceStats> source_stats;
+  // Flat open-addressing table keyed by interned file view + line -
+  // bumped once per event, so no node chase and no per-event key string
+  FlatMap<SourceKey, MultiCoreSourceStats, SourceKeyHash> source_stats;
+  // Bounded alternative to source_stats (see set_hot_line_budget)
+  std::unique_ptr<HotLineTracker> hot_line_tracker;
+  // Parallel-sim alternative: per-core shard tables bumped by epoch
+  // workers, k-way-merged into the top-K at report time - hot-line
+  // accounting scales with the simulation instead of serializing it
+  std::unique_ptr<ShardedHotLines> shard_stats;
   std::unordered_set<uint32_t> seen_threads;
+
+  // Per-result hook invoked from the hot path: a raw function pointer
+  // plus context - no std::function dispatch per event (same scheme as
+  // TraceProcessor)
+  void (*event_hook)(void *, const EventResult &) = nullptr;
+  void *event_hook_ctx = nullptr;
+
+  // Type-erased storage backing set_event_callback (boundary adapter);
+  // the hot path never touches it directly, only through event_hook
   std::function<void(const EventResult &)> event_callback;
 
+  // Batched callback state (see set_batch_callback)
+  std::function<void(const EventResult *, size_t)> batch_callback;
+  std::vector<EventResult> result_buffer;
+  size_t result_batch_size = DEFAULT_RESULT_BATCH;
+
+  // Deliver any buffered results to the batch callback
+  void flush_results();
+
   // Advanced instrumentation statistics
   SoftwarePrefetchStats sw_prefetch_stats;
   VectorStats vector_stats;
+  GatherScatterStats gather_stats;
   AtomicStats atomic_stats;
   MemoryIntrinsicStats mem_intrinsic_stats;
 
+  // Lines touched so far by the in-progress gather/scatter op, per
+  // thread: an op's lane records are adjacent within its thread, but
+  // threads interleave in the merged trace
+  std::unordered_map<uint32_t, std::vector<uint64_t>> gather_lines_in_flight;
+
   // Track prefetched addresses to measure usefulness
   std::unordered_set<uint64_t> prefetched_addresses;
 
-  std::string make_key(std::string_view file, uint32_t line);
-  void process_line_access(const TraceEvent &event, uint64_t line_addr, bool is_write);
+  // Per-address contention profile of the trace's atomic operations
+  AtomicContentionTracker atomic_contention;
+
+  // Working-set sketch for the current interval window (--interval)
+  WorkingSetEstimator wss;
+
+  // Running aggregate of the trace's W sample-rate records (see
+  // TraceSampling.hpp); idle on unsampled traces
+  TraceSampling sampling;
+
+  // Parallel simulation state (see set_parallel_simulation). Line accesses
+  // are buffered into epochs and handed to the cache system's epoch engine;
+  // epochs the engine rejects are replayed sequentially.
+  size_t parallel_sim_threads = 0;
+  static constexpr size_t EPOCH_SIZE = 4096;
+  std::vector<MultiCoreCacheSystem::EpochAccess> epoch_accesses;
+  std::vector<uint32_t> epoch_sizes;  // original access sizes for callbacks
+  std::vector<MultiCoreAccessResult> epoch_results;
+  void flush_epoch();
+
+  // 1-in-n set-sampling factor (see set_set_sampling); 1 = simulate all
+  uint32_t set_sample_factor = 1;
+
+  // Virtual-time replay state (see enable_virtual_time): per-core cycle
+  // clocks advanced by the timing model's latency for each simulated
+  // access, and the latencies to charge
+  bool virtual_time = false;
+  LatencyConfig vt_latency;
+  std::vector<uint64_t> vt_clocks;
+  void process_batch_virtual_time(const TraceEvent *events, size_t count);
+
+  // `addr` is the first byte the access touches within its line - the
+  // cache aligns it internally, and the false-sharing tracker needs the
+  // sub-line offset
+  void process_line_access(const TraceEvent &event, uint64_t addr, bool is_write);
+
+  // Routes a line access to the epoch buffer (parallel mode) or straight
+  // through process_line_access (sequential mode)
+  void handle_line_access(const TraceEvent &event, uint64_t addr, bool is_write);
+
+  // Post-cache bookkeeping shared by both modes: prefetch usefulness,
+  // per-source stats, and the event callback
+  void record_access_result(uint64_t line_addr, bool is_write, uint32_t size,
+                            std::string_view file, uint32_t line,
+                            uint32_t thread_id,
+                            const MultiCoreAccessResult &result);
 
 public:
   MultiCoreTraceProcessor(int num_cores, const CacheConfig &l1_cfg,
                           const CacheConfig &l2_cfg,
                           const CacheConfig &l3_cfg,
                           PrefetchPolicy prefetch_policy = PrefetchPolicy::NONE,
-                          int prefetch_degree = 2);
+                          int prefetch_degree = 2,
+                          CoherenceMode coherence_mode = CoherenceMode::Auto,
+                          CoherenceProtocol protocol = CoherenceProtocol::MESI);
+
+  // Per-result delivery primitive: a static hook (function pointer plus
+  // context) the hot path calls directly. Pass nullptr to uninstall.
+  using EventHook = void (*)(void *, const EventResult &);
+  void set_event_hook(EventHook hook, void *ctx) {
+    event_hook = hook;
+    event_hook_ctx = ctx;
+  }
 
+  // Compile-time visitor: installs a trampoline making a direct call into
+  // the visitor's body, which the compiler can inline - preferred over
+  // set_event_callback for internal callers. The visitor must outlive the
+  // processing it observes.
+  template <typename Visitor> void set_event_visitor(Visitor &visitor) {
+    set_event_hook(
+        [](void *ctx, const EventResult &r) {
+          (*static_cast<Visitor *>(ctx))(r);
+        },
+        &visitor);
+  }
+
+  // Process a run of events with a visitor observing every result; the
+  // previously installed hook (if any) is restored afterwards
+  template <typename Visitor>
+  void process_batch(const TraceEvent *events, size_t count,
+                     Visitor &&visitor) {
+    EventHook saved_hook = event_hook;
+    void *saved_ctx = event_hook_ctx;
+    set_event_visitor(visitor);
+    process_batch(events, count);
+    event_hook = saved_hook;
+    event_hook_ctx = saved_ctx;
+  }
+
+  // Thin type-erased adapter for the library boundary (embedders handing
+  // us an opaque callable); pays std::function dispatch per event
   void set_event_callback(std::function<void(const EventResult &)> cb);
 
+  // Batched result delivery: results are buffered and handed to the
+  // callback in chunks of batch_size, amortizing the type-erased call
+  // that set_event_callback pays per event (same API as TraceProcessor)
+  using BatchCallback = std::function<void(const EventResult *, size_t)>;
+  static constexpr size_t DEFAULT_RESULT_BATCH = 256;
+  void set_batch_callback(BatchCallback cb,
+                          size_t batch_size = DEFAULT_RESULT_BATCH);
+
+  // Virtual-time replay (--virtual-time): instead of trace-arrival order,
+  // which reflects capture-time scheduling noise, dispatch events from
+  // per-thread streams in per-core clock order. Each core's clock advances
+  // by the timing model's latency for the level that served its access,
+  // so the interleaving is deterministic and physically plausible - the
+  // same program produces the same false-sharing counts run to run.
+  // Program order within a thread is always preserved. Mutually exclusive
+  // with set_parallel_simulation (dispatch is decided one event at a time
+  // from the simulated latencies, which epoch buffering would stale).
+  void enable_virtual_time(const LatencyConfig &latency);
+
+  // Simulate cores on worker threads inside process_batch, synchronizing
+  // at bounded epochs. Epochs with cross-core line sharing (or with
+  // prefetching enabled) automatically fall back to the sequential path,
+  // so results always match sequential simulation. 0 disables.
+  void set_parallel_simulation(size_t num_threads);
+
   // Process a trace event through the cache system
   void process(const TraceEvent &event);
 
+  // Process a run of events in one call so the per-event call overhead
+  // amortizes; flushes any pending batched results at the end
+  void process_batch(const TraceEvent *events, size_t count);
+  void process_batch(const std::vector<TraceEvent> &events) {
+    process_batch(events.data(), events.size());
+  }
+
   [[nodiscard]] MultiCoreStats get_stats() const { return cache.get_stats(); }
 
   // Get the hottest source lines by miss count
   [[nodiscard]] std::vector<MultiCoreSourceStats> get_hot_lines(size_t limit = 10) const;
 
+  // Per-function rollup of the per-line stats via the trace's G records
+  // (empty when the trace carries no function registrations)
+  [[nodiscard]] std::vector<FunctionStats> get_hot_functions(size_t limit = 10) const;
+
+  // Cap per-source-line tracking at k exact entries backed by a count-min
+  // sketch for the tail, so memory stays fixed no matter how many distinct
+  // source lines the trace touches. 0 (the default) keeps the exact map.
+  void set_hot_line_budget(size_t k) {
+    hot_line_tracker = k ? std::make_unique<HotLineTracker>(k) : nullptr;
+    if (hot_line_tracker) {
+      shard_stats.reset();  // the bounded tracker owns accounting outright
+    }
+  }
+
   // Get false sharing reports from the cache system
   [[nodiscard]] std::vector<FalseSharingReport> get_false_sharing_reports() const;
 
+  // Multi-socket (NUMA) simulation: per-socket L3 slices and page placement
+  void enable_numa(int sockets, NumaPlacement placement) {
+    cache.enable_numa(sockets, placement);
+  }
+  [[nodiscard]] NumaStats get_numa_stats() const { return cache.get_numa_stats(); }
+  [[nodiscard]] std::vector<NumaLineStat> get_numa_hot_lines(size_t limit = 10) const {
+    return cache.get_numa_hot_lines(limit);
+  }
+
+  // CCX topology (AMD Zen): per-core-complex L3 slices, threads spread
+  // breadth-first across complexes
+  void enable_ccx_topology(int cores_per_ccx) {
+    cache.enable_ccx_topology(cores_per_ccx);
+  }
+
+  // Thread-to-core placement: policy for unpinned threads plus explicit
+  // per-thread pins (--placement / --placement-file)
+  void set_thread_placement(ThreadPlacement placement) {
+    cache.set_thread_placement(placement);
+  }
+  void pin_thread(uint32_t thread_id, int core) {
+    cache.pin_thread(thread_id, core);
+  }
+  [[nodiscard]] const std::unordered_map<uint32_t, int> &
+  get_thread_map() const {
+    return cache.get_thread_map();
+  }
+
+  // Working-set size of the current interval window: estimated distinct
+  // lines touched since the last close_wss_window(). The interval loop
+  // reads the estimate at each boundary and resets the window.
+  [[nodiscard]] uint64_t wss_estimate() const { return wss.estimate(); }
+  void close_wss_window() { wss.reset(); }
+
+  // Sampling weights from the trace's W records: how many captured
+  // accesses each simulated one stood for (inactive on unsampled traces)
+  [[nodiscard]] const TraceSampling &get_sampling() const { return sampling; }
+
   [[nodiscard]] size_t get_thread_count() const { return seen_threads.size(); }
   [[nodiscard]] int get_num_cores() const { return cache.get_num_cores(); }
 
@@ -68,10 +272,32 @@ public:
 
   // Performance: enable fast mode (disables 3C miss classification)
   void set_fast_mode(bool enable) { cache.set_fast_mode(enable); }
+  // Coherence transition memo kill switch (--no-coherence-memo)
+  void set_coherence_memo(bool enable) { cache.set_coherence_memo(enable); }
+  // Set sampling (--sample-sets): simulate only lines whose index falls
+  // in a deterministic 1-in-n subset; the caller extrapolates the stats
+  void set_set_sampling(uint32_t factor) {
+    set_sample_factor = factor ? factor : 1;
+  }
+  // Simulate huge-page-backed mappings (2MB or 1GB)
+  void set_page_size(size_t page_size) { cache.set_page_size(page_size); }
+  // Adapt each core's prefetch degree at runtime from accuracy feedback
+  void enable_prefetch_throttling() { cache.enable_prefetch_throttling(); }
+  void set_classifier_fp_rate(double fp_rate) { cache.set_classifier_fp_rate(fp_rate); }
+  [[nodiscard]] ClassifierSummary get_classifier_summary() const {
+    return cache.get_classifier_summary();
+  }
+
+  // Ranked contended atomic addresses (locks/counters bouncing between
+  // threads or spinning in cmpxchg retry loops)
+  [[nodiscard]] std::vector<ContendedAtomic> get_contended_atomics(size_t limit = 10) const {
+    return atomic_contention.top(limit);
+  }
 
   // Advanced instrumentation statistics getters
   [[nodiscard]] const SoftwarePrefetchStats& get_software_prefetch_stats() const { return sw_prefetch_stats; }
   [[nodiscard]] const VectorStats& get_vector_stats() const { return vector_stats; }
+  [[nodiscard]] const GatherScatterStats& get_gather_scatter_stats() const { return gather_stats; }
   [[nodiscard]] const AtomicStats& get_atomic_stats() const { return atomic_stats; }
   [[nodiscard]] const MemoryIntrinsicStats& get_memory_intrinsic_stats() const { return mem_intrinsic_stats; }
 };
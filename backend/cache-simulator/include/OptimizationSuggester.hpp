@@ -9,7 +9,7 @@
 #include "TraceProcessor.hpp"
 
 struct OptimizationSuggestion {
-  std::string type;      // "false_sharing", "high_miss_rate", "strided_access"
+  std::string type;      // "false_sharing", "high_miss_rate", "partial_struct"
   std::string severity;  // "high", "medium", "low"
   std::string location;  // file:line or cache line address
   std::string message;
@@ -28,4 +28,15 @@ public:
   static std::vector<OptimizationSuggestion>
   analyze(const std::vector<SourceStats> &hot_lines, const CacheStats &l1_stats,
           const CacheStats &l2_stats);
+
+  // Data-structure layout analysis over the heap-attributed sites: a
+  // site whose objects only ever use a small slice of each fetched cache
+  // line is paying for bytes it never reads - the classic partially-used
+  // struct in a hot loop. Suggests splitting the hot fields out
+  // (AoS->SoA) or reordering, with the miss reduction a dense layout
+  // could reach (misses scale with lines fetched, so up to
+  // 1 - utilization of them are padding).
+  static std::vector<OptimizationSuggestion>
+  analyze_layout(const std::vector<HeapSiteStats> &heap_sites,
+                 uint32_t line_size);
 };
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Checkpoint.hpp"
+
+// Virtual-to-physical page allocation for the physically-indexed levels.
+//
+// Traces carry virtual addresses, but L2/L3 on real parts index by
+// physical address - which sets a virtual page lands in depends on the
+// frame the OS handed out, so conflict analysis above L1 is only as
+// real as that mapping. The allocator assigns each virtual page a
+// physical frame on first touch, deterministically, under one of three
+// policies:
+//
+//   Sequential - bump allocator: virtually contiguous pages stay
+//                physically contiguous (fresh boot, THP-backed heaps)
+//   Random     - seeded hash picks each frame: the fragmented state a
+//                long-running host's buddy allocator converges to
+//   Colored    - frames preserve the page's cache color, so every
+//                virtual page keeps its natural set group in the
+//                lowest level (FreeBSD-style page coloring)
+//
+// L1 index bits sit inside the page offset on every shipped preset, so
+// translating the whole hierarchy leaves L1 behavior bit-identical
+// while L2/L3 see the physical layout.
+enum class PageAllocPolicy { None, Sequential, Random, Colored };
+
+class PageAllocator {
+public:
+  // Frame pool the random policy draws from: 16GB of 4KB frames keeps
+  // probe chains short without pretending memory is unbounded
+  static constexpr uint64_t DEFAULT_FRAMES = 1ULL << 22;
+
+  void configure(PageAllocPolicy policy, uint64_t seed, uint64_t page_size,
+                 uint64_t colors) {
+    policy_ = policy;
+    seed_ = seed;
+    page_size_ = page_size ? page_size : 4096;
+    colors_ = colors ? colors : 1;
+    clear();
+  }
+
+  [[nodiscard]] bool enabled() const { return policy_ != PageAllocPolicy::None; }
+  [[nodiscard]] uint64_t pages_mapped() const { return page_table_.size(); }
+
+  // Physical address for a virtual one, allocating the page's frame on
+  // first touch. Identity when no policy is configured.
+  uint64_t translate(uint64_t vaddr) {
+    if (policy_ == PageAllocPolicy::None) {
+      return vaddr;
+    }
+    uint64_t vpn = vaddr / page_size_;
+    auto it = page_table_.find(vpn);
+    uint64_t pfn;
+    if (it != page_table_.end()) {
+      pfn = it->second;
+    } else {
+      pfn = allocate(vpn);
+      page_table_.emplace(vpn, pfn);
+    }
+    return pfn * page_size_ + (vaddr % page_size_);
+  }
+
+  // Drop all mappings, keeping the configured policy (daemon job reuse)
+  void clear() {
+    page_table_.clear();
+    used_frames_.clear();
+    next_frame_ = 0;
+    color_next_.assign(colors_, 0);
+  }
+
+  // Checkpointing: serialize/restore the page table and allocation
+  // cursors so a restored run keeps handing out the same frames
+  void save_state(CheckpointWriter &w) const {
+    w.write<uint8_t>(static_cast<uint8_t>(policy_));
+    w.write(seed_);
+    w.write(page_size_);
+    w.write(colors_);
+    w.write(next_frame_);
+    w.write_vec(color_next_);
+    w.write_map(page_table_);
+    w.write_set(used_frames_);
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.expect<uint8_t>(static_cast<uint8_t>(policy_), "page-alloc policy");
+    r.expect(seed_, "page-alloc seed");
+    r.expect(page_size_, "page-alloc page size");
+    r.expect(colors_, "page-alloc colors");
+    next_frame_ = r.read<uint64_t>();
+    r.read_vec(color_next_);
+    r.read_map(page_table_);
+    r.read_set(used_frames_);
+  }
+
+private:
+  // splitmix64 finalizer: the seed/VPN mix that decides random placement
+  static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  uint64_t allocate(uint64_t vpn) {
+    switch (policy_) {
+    case PageAllocPolicy::Sequential:
+      return next_frame_++;
+    case PageAllocPolicy::Colored: {
+      // One bump cursor per color keeps frames unique within a color
+      uint64_t color = vpn % colors_;
+      return color + colors_ * color_next_[color]++;
+    }
+    default: {
+      // Random: hash the VPN into the frame pool, linear-probe past
+      // frames already handed out
+      uint64_t pfn = mix(seed_ ^ vpn) % DEFAULT_FRAMES;
+      while (!used_frames_.insert(pfn).second) {
+        pfn = (pfn + 1) % DEFAULT_FRAMES;
+      }
+      return pfn;
+    }
+    }
+  }
+
+  PageAllocPolicy policy_ = PageAllocPolicy::None;
+  uint64_t seed_ = 0;
+  uint64_t page_size_ = 4096;
+  uint64_t colors_ = 1;
+  uint64_t next_frame_ = 0;
+  std::vector<uint64_t> color_next_;
+  std::unordered_map<uint64_t, uint64_t> page_table_;
+  std::unordered_set<uint64_t> used_frames_;  // Random policy only
+};
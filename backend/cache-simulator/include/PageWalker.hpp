@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "Checkpoint.hpp"
+
+// Page-table walker with paging-structure caches.
+//
+// A 4KB-page walk on x86-64 reads four levels of page-table entries
+// (PML4E, PDPTE, PDE, PTE). Hardware keeps small caches of the upper
+// three levels keyed by the virtual-page-number prefix they translate,
+// so a walk usually only fetches the levels below its deepest cached
+// structure - walks for neighbouring pages fetch a single PTE.
+//
+// walk() returns the synthetic physical addresses of the PTEs that
+// still need fetching, deepest-cached level first. The caller decides
+// what a fetch costs: a flat per-PTE charge, or a real lookup through
+// the data cache hierarchy (see CacheSystem::walk_fetch).
+class PageWalker {
+public:
+  static constexpr int LEVELS = 4;       // 4KB pages, 9 VPN bits per level
+  static constexpr size_t PWC_ENTRIES = 32;  // Per cached level, full LRU
+
+  explicit PageWalker(int levels = LEVELS) : levels_(levels) {}
+
+  // Huge pages terminate the walk early: 2MB leaves at the PDE
+  // (3 levels), 1GB at the PDPTE (2 levels)
+  void set_levels(int levels) {
+    levels_ = levels;
+    clear();
+  }
+
+  std::vector<uint64_t> walk(uint64_t vpn, TimingStats &timing) {
+    timing.page_walks++;
+
+    // Deepest upper level whose structure is cached (0 = none)
+    int cached = 0;
+    for (int level = levels_ - 1; level >= 1; level--) {
+      if (lookup(level, tag_for(vpn, level))) {
+        cached = level;
+        break;
+      }
+    }
+    timing.pwc_skipped_levels += cached;
+
+    std::vector<uint64_t> fetches;
+    fetches.reserve(levels_ - cached);
+    for (int level = cached + 1; level <= levels_; level++) {
+      fetches.push_back(pte_address(vpn, level));
+      if (level < levels_) {
+        insert(level, tag_for(vpn, level));
+      }
+    }
+    return fetches;
+  }
+
+  void clear() {
+    for (auto &cache : pwc_) {
+      cache.clear();
+    }
+    access_counter_ = 0;
+  }
+
+  // Checkpointing: serialize/restore the paging-structure caches
+  void save_state(CheckpointWriter &w) const {
+    w.write<uint32_t>(static_cast<uint32_t>(levels_));
+    w.write(access_counter_);
+    for (const auto &cache : pwc_) {
+      w.write_vec(cache);
+    }
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.expect<uint32_t>(static_cast<uint32_t>(levels_), "page-walk levels");
+    access_counter_ = r.read<uint64_t>();
+    for (auto &cache : pwc_) {
+      r.read_vec(cache);
+    }
+  }
+
+private:
+  struct PwcEntry {
+    uint64_t tag;
+    uint64_t last_access;
+  };
+
+  // VPN prefix translated by the structure at this level: level 1
+  // (PML4E) covers 27 VPN bits, the deepest level covers the top 9
+  uint64_t tag_for(uint64_t vpn, int level) const {
+    return vpn >> (9 * (levels_ - level));
+  }
+
+  // Synthetic page-table addresses: one region per level, 8-byte
+  // entries indexed by the VPN prefix. Placed high so they never
+  // collide with traced data addresses
+  uint64_t pte_address(uint64_t vpn, int level) const {
+    return PT_REGION_BASE + static_cast<uint64_t>(level) * PT_LEVEL_STRIDE +
+           tag_for(vpn, level) * 8;
+  }
+
+  bool lookup(int level, uint64_t tag) {
+    for (auto &entry : pwc_[level - 1]) {
+      if (entry.tag == tag) {
+        entry.last_access = ++access_counter_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void insert(int level, uint64_t tag) {
+    auto &cache = pwc_[level - 1];
+    for (auto &entry : cache) {
+      if (entry.tag == tag) {
+        entry.last_access = ++access_counter_;
+        return;
+      }
+    }
+    if (cache.size() < PWC_ENTRIES) {
+      cache.push_back({tag, ++access_counter_});
+      return;
+    }
+    size_t victim = 0;
+    for (size_t i = 1; i < cache.size(); i++) {
+      if (cache[i].last_access < cache[victim].last_access) {
+        victim = i;
+      }
+    }
+    cache[victim] = {tag, ++access_counter_};
+  }
+
+  static constexpr uint64_t PT_REGION_BASE = 0xFFFF880000000000ULL;
+  static constexpr uint64_t PT_LEVEL_STRIDE = 0x0000010000000000ULL;
+
+  int levels_;
+  std::vector<PwcEntry> pwc_[LEVELS - 1];  // Levels 1..3; leaves aren't cached
+  uint64_t access_counter_ = 0;
+};
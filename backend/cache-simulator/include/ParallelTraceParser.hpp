@@ -0,0 +1,98 @@
+#pragma once
+
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "FastIO.hpp"
+#include "ThreadPool.hpp"
+#include "TraceEvent.hpp"
+
+// Parallel text-trace parser (--parallel)
+//
+// Splits the input buffer into newline-aligned chunks, parses them on a
+// ThreadPool into per-chunk event vectors, and splices the results back
+// together in buffer order - the simulator sees exactly the sequence a
+// serial parse would produce. Several chunks per thread keep the pool
+// balanced when line densities differ across the buffer.
+//
+// Workers share no mutable state except the FileTable intern table, which
+// takes only a shared lock once a name has been seen, so parsing scales
+// with cores while simulation stays sequential (MESI order is preserved).
+// Small buffers parse serially - thread startup would dominate.
+class ParallelTraceParser {
+public:
+  static constexpr size_t MIN_PARALLEL_BYTES = 1 << 20; // 1MB
+  static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+  // Parse the whole buffer with num_threads workers (0 = auto-detect)
+  [[nodiscard]] static std::vector<TraceEvent>
+  parse(const char *data, size_t size, size_t num_threads = 0) {
+    if (num_threads == 0)
+      num_threads = std::thread::hardware_concurrency();
+
+    std::vector<TraceEvent> events;
+    if (num_threads <= 1 || size < MIN_PARALLEL_BYTES) {
+      events.reserve(size / 40); // ~40 chars per line estimate
+      parse_range(data, data + size, events);
+      return events;
+    }
+
+    // Cut points land mid-line; round each up to the next line start so
+    // chunks hold whole lines and cover the buffer exactly once
+    const char *end = data + size;
+    std::vector<const char *> bounds;
+    bounds.push_back(data);
+    size_t num_chunks = num_threads * CHUNKS_PER_THREAD;
+    for (size_t i = 1; i < num_chunks; i++) {
+      const char *cut = data + (size * i) / num_chunks;
+      if (cut <= bounds.back())
+        continue;
+      const char *nl = find_newline(cut, end);
+      const char *start = (nl < end) ? nl + 1 : end;
+      if (start > bounds.back() && start < end)
+        bounds.push_back(start);
+    }
+    bounds.push_back(end);
+
+    // File- and function-registration records must be bound before any
+    // chunk that references them parses, and chunks run out of order - so
+    // bind them in a sequential pre-pass first. Only 'D'/'G' lines get
+    // parsed; for everything else this is just the SIMD newline walk.
+    for_each_line(data, size, [](const char *lb, const char *le) {
+      if (*lb == 'D' || *lb == 'G')
+        parse_trace_event_fast(lb, le);
+    });
+
+    std::vector<std::vector<TraceEvent>> per_chunk(bounds.size() - 1);
+    ThreadPool pool(num_threads);
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+      pool.submit([&per_chunk, &bounds, i] {
+        per_chunk[i].reserve((bounds[i + 1] - bounds[i]) / 40);
+        parse_range(bounds[i], bounds[i + 1], per_chunk[i]);
+      });
+    }
+    pool.wait_idle();
+
+    // Splice in buffer order
+    size_t total = 0;
+    for (const auto &chunk : per_chunk)
+      total += chunk.size();
+    events.reserve(total);
+    for (auto &chunk : per_chunk) {
+      events.insert(events.end(), std::make_move_iterator(chunk.begin()),
+                    std::make_move_iterator(chunk.end()));
+    }
+    return events;
+  }
+
+private:
+  static void parse_range(const char *begin, const char *end,
+                          std::vector<TraceEvent> &out) {
+    for_each_line(begin, end - begin, [&](const char *lb, const char *le) {
+      auto event = parse_trace_event_fast(lb, le);
+      if (event)
+        out.push_back(std::move(*event));
+    });
+  }
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "TraceEvent.hpp"
+
+// SimPoint-style phase sampling for fast, statistically grounded simulation
+//
+// Uniform event sampling (CACHE_EXPLORER_SAMPLE_RATE) corrupts temporal
+// locality: dropping every Nth access makes reuse distances meaningless.
+// Phase sampling keeps locality intact by operating on whole intervals
+// instead. The trace is cut into fixed-length intervals, each summarized
+// by an access-pattern vector (a hashed histogram of the cache lines it
+// touches - the address-stream analogue of SimPoint's basic-block
+// vectors). K-means clustering groups intervals into phases; only the
+// interval nearest each centroid is simulated in detail, and its stats
+// are scaled by the cluster's population to estimate the full trace.
+//
+// The reported error bound is a heuristic, not a formal confidence
+// interval: one representative per cluster leaves the within-phase
+// variance unobserved, so the bound scales each phase's contribution by
+// its normalized clustering distortion (tight clusters extrapolate with
+// more certainty than loose ones).
+class PhaseSampler {
+public:
+  static constexpr size_t FEATURE_DIMS = 64;
+  static constexpr size_t DEFAULT_INTERVAL = 100000;
+  static constexpr size_t DEFAULT_MAX_CLUSTERS = 8;
+
+  explicit PhaseSampler(size_t interval_length = DEFAULT_INTERVAL,
+                        size_t max_clusters = DEFAULT_MAX_CLUSTERS)
+      : interval_len(interval_length ? interval_length : DEFAULT_INTERVAL),
+        max_k(max_clusters ? max_clusters : 1) {}
+
+  // Record one event into the current interval's feature vector. Only the
+  // access pattern matters here - nothing is simulated. Every event counts
+  // toward the interval length (so intervals are exact slices of the event
+  // stream), but side-band records contribute nothing to the pattern.
+  void add_event(const TraceEvent &event) {
+    if (!(event.is_phase_begin || event.is_phase_end || event.is_alloc ||
+          event.is_free || event.is_sample_rate)) {
+      uint64_t line = event.address >> 6; // line granularity, size-agnostic
+      current[hash_dim(line)] += 1.0;
+    }
+    current_count++;
+    if (current_count >= interval_len)
+      close_interval();
+  }
+
+  // Close the trailing partial interval (call once after the last event)
+  void finish() {
+    if (current_count > 0)
+      close_interval();
+  }
+
+  [[nodiscard]] size_t num_intervals() const { return features.size(); }
+  [[nodiscard]] size_t get_interval_length() const { return interval_len; }
+  // Events in a closed interval (the last may be short)
+  [[nodiscard]] size_t events_in_interval(size_t i) const { return interval_events[i]; }
+
+  struct Cluster {
+    size_t representative = 0; // interval index nearest the centroid
+    uint64_t weight = 0;       // intervals assigned to this phase
+    double distortion = 0.0;   // mean member distance to centroid, 0..1
+  };
+
+  struct Plan {
+    std::vector<Cluster> clusters;
+    std::vector<int> assignment; // interval index -> cluster index
+  };
+
+  // K-means over the interval vectors (deterministic: farthest-point
+  // seeding from interval 0, fixed iteration cap). Empty clusters are
+  // dropped, so the result can have fewer phases than max_clusters.
+  [[nodiscard]] Plan cluster() const {
+    Plan plan;
+    size_t n = features.size();
+    if (n == 0)
+      return plan;
+    size_t k = std::min(max_k, n);
+
+    // Farthest-point seeding: start from interval 0, then repeatedly take
+    // the interval farthest from every centroid chosen so far
+    std::vector<Feature> centroids;
+    centroids.push_back(features[0]);
+    while (centroids.size() < k) {
+      size_t farthest = 0;
+      double best = -1.0;
+      for (size_t i = 0; i < n; i++) {
+        double d = std::numeric_limits<double>::max();
+        for (const auto &c : centroids)
+          d = std::min(d, distance(features[i], c));
+        if (d > best) {
+          best = d;
+          farthest = i;
+        }
+      }
+      centroids.push_back(features[farthest]);
+    }
+
+    std::vector<int> assign(n, 0);
+    for (int iter = 0; iter < 50; iter++) {
+      bool changed = false;
+      for (size_t i = 0; i < n; i++) {
+        int nearest = 0;
+        double best = std::numeric_limits<double>::max();
+        for (size_t c = 0; c < centroids.size(); c++) {
+          double d = distance(features[i], centroids[c]);
+          if (d < best) {
+            best = d;
+            nearest = static_cast<int>(c);
+          }
+        }
+        if (assign[i] != nearest) {
+          assign[i] = nearest;
+          changed = true;
+        }
+      }
+      if (!changed && iter > 0)
+        break;
+
+      // Recompute centroids as member means
+      for (auto &c : centroids)
+        c.fill(0.0);
+      std::vector<size_t> counts(centroids.size(), 0);
+      for (size_t i = 0; i < n; i++) {
+        for (size_t d = 0; d < FEATURE_DIMS; d++)
+          centroids[assign[i]][d] += features[i][d];
+        counts[assign[i]]++;
+      }
+      for (size_t c = 0; c < centroids.size(); c++) {
+        if (counts[c] == 0)
+          continue; // empty cluster keeps its (zero) centroid, dropped below
+        for (size_t d = 0; d < FEATURE_DIMS; d++)
+          centroids[c][d] /= static_cast<double>(counts[c]);
+      }
+    }
+
+    // Build the plan: representative = member nearest the centroid,
+    // distortion = mean member distance normalized to [0, 1] (sqrt(2) is
+    // the largest distance two L1-normalized histograms can be apart)
+    std::vector<int> remap(centroids.size(), -1);
+    for (size_t c = 0; c < centroids.size(); c++) {
+      Cluster cl;
+      double nearest = std::numeric_limits<double>::max();
+      double dist_sum = 0.0;
+      for (size_t i = 0; i < n; i++) {
+        if (assign[i] != static_cast<int>(c))
+          continue;
+        double d = distance(features[i], centroids[c]);
+        dist_sum += d;
+        if (d < nearest) {
+          nearest = d;
+          cl.representative = i;
+        }
+        cl.weight++;
+      }
+      if (cl.weight == 0)
+        continue; // dropped empty cluster
+      cl.distortion = (dist_sum / static_cast<double>(cl.weight)) / SQRT2;
+      remap[c] = static_cast<int>(plan.clusters.size());
+      plan.clusters.push_back(cl);
+    }
+    plan.assignment.resize(n);
+    for (size_t i = 0; i < n; i++)
+      plan.assignment[i] = remap[assign[i]];
+    return plan;
+  }
+
+private:
+  using Feature = std::array<double, FEATURE_DIMS>;
+
+  static constexpr double SQRT2 = 1.4142135623730951;
+
+  static size_t hash_dim(uint64_t line) {
+    // Fibonacci hash so adjacent lines spread across dimensions
+    return static_cast<size_t>((line * 11400714819323198485ULL) >>
+                               (64 - 6)); // log2(FEATURE_DIMS)
+  }
+
+  static double distance(const Feature &a, const Feature &b) {
+    double sum = 0.0;
+    for (size_t d = 0; d < FEATURE_DIMS; d++) {
+      double diff = a[d] - b[d];
+      sum += diff * diff;
+    }
+    return std::sqrt(sum);
+  }
+
+  void close_interval() {
+    // L1-normalize so interval length doesn't affect the comparison
+    // (the final interval is usually short)
+    for (auto &v : current)
+      v /= static_cast<double>(current_count);
+    features.push_back(current);
+    interval_events.push_back(current_count);
+    current.fill(0.0);
+    current_count = 0;
+  }
+
+  size_t interval_len;
+  size_t max_k;
+  Feature current{};
+  size_t current_count = 0;
+  std::vector<Feature> features;
+  std::vector<size_t> interval_events;
+};
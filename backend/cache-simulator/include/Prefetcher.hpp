@@ -1,16 +1,22 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
 
+#include "Checkpoint.hpp"
+
 enum class PrefetchPolicy {
-  NONE,       // No prefetching
-  NEXT_LINE,  // Always prefetch next cache line (adjacent line prefetcher)
-  STREAM,     // Detect sequential streams, prefetch ahead
-  STRIDE,     // Detect strided access patterns
-  ADAPTIVE,   // Combine stream and stride detection
-  INTEL,      // Intel-like: adjacent line + adaptive (most realistic)
+  NONE,        // No prefetching
+  NEXT_LINE,   // Always prefetch next cache line (adjacent line prefetcher)
+  STREAM,      // Detect sequential streams, prefetch ahead
+  STRIDE,      // Detect strided access patterns
+  ADAPTIVE,    // Combine stream and stride detection
+  INTEL,       // Intel-like: adjacent line + adaptive (most realistic)
+  BEST_OFFSET, // Michaud best-offset: score offsets against recent requests
+  SMS,         // Spatial memory streaming: replay per-PC region footprints
 };
 
 struct PrefetchStats {
@@ -62,10 +68,48 @@ struct StrideEntry {
   static constexpr int MAX_CONFIDENCE = 8;
 };
 
+// Best-offset prefetcher state (Michaud, HPCA 2016). Candidate offsets
+// are scored against a recent-requests table across learning rounds;
+// the winner becomes the single prefetch offset for the next phase.
+struct BestOffsetState {
+  static constexpr int RR_ENTRIES = 64; // Recent requests (direct mapped)
+  static constexpr int SCORE_MAX = 31;  // Early exit: offset clearly wins
+  static constexpr int ROUND_MAX = 16;  // Learning rounds per phase
+  static constexpr int BAD_SCORE = 2;   // Best below this: stop prefetching
+  static constexpr std::array<int64_t, 16> OFFSETS = {
+      1, 2, 3, 4, 5, 6, 8, 9, 10, 12, 15, 16, 20, 24, 30, 32};
+
+  std::array<uint64_t, RR_ENTRIES> recent{};
+  std::array<bool, RR_ENTRIES> recent_valid{};
+  std::array<int, OFFSETS.size()> scores{};
+  size_t test_index = 0;  // Next candidate to test
+  int round = 0;
+  int64_t best_offset = 1; // Offset in cache lines (paper's default D=1)
+  bool active = true;      // False when no stable offset exists
+};
+
+// One throttle decision: the feedback-directed throttle samples accuracy
+// once per epoch of issued prefetches and records the degree it chose
+struct ThrottleEvent {
+  uint64_t issued = 0;   // Cumulative prefetches issued at the decision
+  double accuracy = 0.0; // Accuracy over the epoch that just ended
+  int degree = 0;        // Degree chosen for the next epoch
+};
+
+// Active spatial-region generation for the SMS prefetcher (Somogyi et
+// al., ISCA 2006): accumulates the footprint of lines touched between
+// region entry and eviction, then commits it to the pattern table.
+struct SpatialRegion {
+  uint64_t key = 0;       // Pattern-table key of the triggering access
+  uint32_t footprint = 0; // One bit per line in the region
+  uint64_t last_touch = 0;
+};
+
 class Prefetcher {
 private:
   PrefetchPolicy policy;
   int prefetch_degree;   // How many lines to prefetch ahead
+  int base_degree;       // Configured degree (throttle restarts from here)
   int line_size;         // Cache line size in bytes
 
   // Stream detection state (per-page tracking)
@@ -75,6 +119,32 @@ private:
   // Stride detection state (per-PC tracking)
   std::unordered_map<uint64_t, StrideEntry> stride_table;
 
+  // Best-offset state (offset scoring, recent-requests table)
+  BestOffsetState bop;
+
+  // SMS state: active generations per region plus learned footprints.
+  // 2KB regions of 64B lines give 32-line footprints (one uint32_t).
+  static constexpr uint64_t SMS_REGION_SIZE = 2048;
+  static constexpr size_t SMS_ACTIVE_REGIONS = 64;
+  std::unordered_map<uint64_t, SpatialRegion> sms_active;
+  std::unordered_map<uint64_t, uint32_t> sms_patterns;
+  uint64_t sms_clock = 0;
+
+  // Feedback-directed throttling: sample accuracy once per epoch of
+  // issued prefetches and halve/double the degree accordingly
+  static constexpr uint64_t THROTTLE_EPOCH = 256;
+  static constexpr double THROTTLE_HIGH = 0.75;
+  static constexpr double THROTTLE_LOW = 0.35;
+  static constexpr int THROTTLE_MIN_DEGREE = 1;
+  static constexpr int THROTTLE_MAX_DEGREE = 8;
+  static constexpr size_t THROTTLE_TIMELINE_CAP = 64;
+  bool throttling_enabled = false;
+  uint64_t epoch_issued = 0; // Stats snapshot at the current epoch start
+  uint64_t epoch_useful = 0;
+  std::vector<ThrottleEvent> throttle_timeline;
+
+  void update_throttle();
+
   PrefetchStats stats;
 
   // Internal methods
@@ -83,6 +153,8 @@ private:
   std::vector<uint64_t> stride_prefetch(uint64_t addr, uint64_t pc);
   std::vector<uint64_t> adaptive_prefetch(uint64_t addr, uint64_t pc);
   std::vector<uint64_t> intel_prefetch(uint64_t addr, uint64_t pc);
+  std::vector<uint64_t> best_offset_prefetch(uint64_t addr);
+  std::vector<uint64_t> sms_prefetch(uint64_t addr, uint64_t pc);
 
   void update_stream_table(uint64_t addr);
   void update_stride_table(uint64_t addr, uint64_t pc);
@@ -98,7 +170,8 @@ private:
 public:
   Prefetcher(PrefetchPolicy p = PrefetchPolicy::NONE, int degree = 2,
              int line_sz = 64)
-      : policy(p), prefetch_degree(degree), line_size(line_sz) {
+      : policy(p), prefetch_degree(degree), base_degree(degree),
+        line_size(line_sz) {
     stream_table.resize(NUM_STREAM_ENTRIES);
   }
 
@@ -115,7 +188,34 @@ public:
   [[nodiscard]] PrefetchPolicy get_policy() const { return policy; }
   void set_policy(PrefetchPolicy p) { policy = p; }
   [[nodiscard]] int get_degree() const { return prefetch_degree; }
-  void set_degree(int d) { prefetch_degree = d; }
+  void set_degree(int d) { prefetch_degree = base_degree = d; }
+
+  // Feedback-directed throttling control and adaptation timeline
+  void enable_throttling(bool on = true) { throttling_enabled = on; }
+  [[nodiscard]] bool is_throttling_enabled() const { return throttling_enabled; }
+  [[nodiscard]] const std::vector<ThrottleEvent> &get_throttle_timeline() const {
+    return throttle_timeline;
+  }
   [[nodiscard]] const PrefetchStats &get_stats() const { return stats; }
   void reset_stats() { stats.reset(); }
+
+  // Checkpointing: serialize/restore the learned tables, throttle state
+  // and stats (see Checkpoint.hpp). load_state verifies the policy.
+  void save_state(CheckpointWriter &w) const;
+  void load_state(CheckpointReader &r);
+
+  // Drop learned stream/stride state along with the stats (job reuse)
+  void clear() {
+    stream_table.assign(NUM_STREAM_ENTRIES, StreamEntry{});
+    stride_table.clear();
+    bop = BestOffsetState{};
+    sms_active.clear();
+    sms_patterns.clear();
+    sms_clock = 0;
+    prefetch_degree = base_degree;
+    epoch_issued = 0;
+    epoch_useful = 0;
+    throttle_timeline.clear();
+    reset_stats();
+  }
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// Memory-region map from the runtime's K registration records
+//
+// The runtime emits "K <kind> <lo> <hi>" for each address range it can
+// classify at capture time - every traced thread's stack and the
+// module's writable PT_LOAD segments (.data/.bss). With those ranges,
+// plus the heap envelope the H records already provide, TraceProcessor
+// buckets every access by region kind: 40% of L1 misses being stack
+// traffic (spills) calls for a very different fix than 40% being heap
+// pointer chasing. Like TraceFileIds, registrations are global and
+// precede any event that could land in them.
+
+enum class RegionKind : uint8_t {
+  Stack = 0,  // A thread's stack range
+  Global = 1, // Module .data/.bss ("data" records)
+  Heap = 2,   // Inside the envelope of H-record allocations
+  Other = 3,  // Nothing claimed it (mmap'd files, code, ...)
+};
+inline constexpr size_t REGION_KIND_COUNT = 4;
+
+inline const char *region_kind_name(RegionKind kind) {
+  switch (kind) {
+  case RegionKind::Stack:  return "stack";
+  case RegionKind::Global: return "global";
+  case RegionKind::Heap:   return "heap";
+  case RegionKind::Other:  return "other";
+  }
+  return "other";
+}
+
+class TraceRegionMap {
+public:
+  struct Range {
+    uint64_t lo, hi; // [lo, hi)
+    RegionKind kind;
+  };
+
+  static TraceRegionMap &instance() {
+    static TraceRegionMap map;
+    return map;
+  }
+
+  void register_range(RegionKind kind, uint64_t lo, uint64_t hi) {
+    if (hi <= lo)
+      return;
+    std::unique_lock lock(mutex);
+    ranges.push_back({lo, hi, kind});
+    // Bump last so a snapshot taken against the new version sees the range
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  // Cheap change check so the hot path can keep a lock-free local copy
+  // and only re-snapshot when a registration actually landed
+  [[nodiscard]] uint64_t version() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::vector<Range> snapshot() const {
+    std::shared_lock lock(mutex);
+    return ranges;
+  }
+
+  [[nodiscard]] bool empty() const {
+    std::shared_lock lock(mutex);
+    return ranges.empty();
+  }
+
+  void clear() {
+    std::unique_lock lock(mutex);
+    ranges.clear();
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+private:
+  TraceRegionMap() = default;
+
+  mutable std::shared_mutex mutex;
+  std::vector<Range> ranges;
+  std::atomic<uint64_t> version_{0};
+};
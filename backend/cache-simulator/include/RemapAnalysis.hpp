@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../profiles/CacheConfig.hpp"
+#include "FlatMap.hpp"
+#include "SourceKey.hpp"
+
+// Set-associative remap analysis (--remap): a conflict-miss what-if
+// engine that answers "what would fix them" instead of re-running the
+// preset sweep. The 3C breakdown counts conflict misses; it doesn't say
+// whether doubling the associativity, hashing the set index, or simply
+// adding capacity would make them go away.
+//
+// Runs beside the real L1D on the same demand stream (the same
+// shadow-replay idea as the compressed-L3 model): one baseline shadow
+// with the L1D's own geometry plus one shadow per candidate remap, all
+// tags-only with plain LRU - no data, no coherence, no stats machinery
+// beyond a miss counter. An access the baseline shadow misses but a
+// variant hits is a miss that remap would have avoided; attributing
+// those to the access's source line tells the report which change fixes
+// which hot line.
+//
+// The three candidates bracket the diagnosis:
+//   assoc2x - double the ways, half the sets (same capacity). Pure
+//             conflict fix: only set-mapping pressure changes.
+//   hashed  - same geometry, XOR-folded set index. A zero-cost fix for
+//             power-of-two stride pathologies.
+//   sets2x  - double the sets, same ways (double capacity). The control:
+//             if only this one helps, the misses are capacity, not
+//             conflict, and no remap will save them.
+
+// One tags-only shadow tag array: the geometry under test, nothing else.
+// Operates on line keys (byte address >> offset bits), so the line size
+// is fixed by the caller and only sets/ways/indexing vary.
+class ShadowTagArray {
+private:
+  // Valid flag packed above the tag, same trick as CacheLevel's packed
+  // metadata - tag 0 must remain representable
+  static constexpr uint64_t SLOT_VALID = 1ULL << 63;
+  static constexpr uint64_t SLOT_TAG_MASK = SLOT_VALID - 1;
+
+  int ways_;
+  int index_bits_;
+  bool hashed_;
+  std::vector<uint64_t> slots_;  // num_sets x ways_: valid bit + tag
+  std::vector<uint64_t> lru_;
+
+  [[nodiscard]] uint64_t set_of(uint64_t line_key) const {
+    uint64_t mask = (1ULL << index_bits_) - 1;
+    // XOR-fold the low tag bits into the index: consecutive power-of-two
+    // strides that pile onto one set under modulo indexing spread out
+    uint64_t key = hashed_ ? line_key ^ (line_key >> index_bits_) : line_key;
+    return key & mask;
+  }
+
+public:
+  ShadowTagArray(int num_sets, int ways, bool hashed)
+      : ways_(ways), index_bits_(__builtin_ctz(num_sets)), hashed_(hashed),
+        slots_(static_cast<size_t>(num_sets) * ways, 0),
+        lru_(static_cast<size_t>(num_sets) * ways, 0) {}
+
+  // Probe-and-fill one demand access; returns true on a shadow hit
+  bool access(uint64_t line_key, uint64_t now) {
+    uint64_t tag = line_key >> index_bits_;
+    size_t base = static_cast<size_t>(set_of(line_key)) * ways_;
+    for (int way = 0; way < ways_; way++) {
+      uint64_t slot = slots_[base + way];
+      if ((slot & SLOT_VALID) && (slot & SLOT_TAG_MASK) == tag) {
+        lru_[base + way] = now;
+        return true;
+      }
+    }
+    // Miss: fill the first empty way, else evict the LRU one
+    int victim = 0;
+    for (int way = 0; way < ways_; way++) {
+      if (!(slots_[base + way] & SLOT_VALID)) {
+        victim = way;
+        break;
+      }
+      if (lru_[base + way] < lru_[base + victim])
+        victim = way;
+    }
+    slots_[base + victim] = SLOT_VALID | (tag & SLOT_TAG_MASK);
+    lru_[base + victim] = now;
+    return false;
+  }
+};
+
+// Per-source-line avoided-miss attribution (see RemapAnalysis)
+struct RemapLineStats {
+  std::string_view file;  // interned via FileTable - stable for the whole run
+  uint32_t line = 0;
+  uint64_t shadow_misses = 0;             // baseline-shadow misses at this line
+  std::array<uint64_t, 3> avoided = {};   // indexed like the variant list
+};
+
+// One candidate geometry's verdict
+struct RemapVariantReport {
+  const char *name;
+  int sets;
+  int ways;
+  bool hashed;
+  uint64_t misses = 0;   // shadow misses under this geometry
+  uint64_t avoided = 0;  // baseline-shadow misses this geometry hit
+};
+
+class RemapAnalysis {
+public:
+  static constexpr size_t VARIANT_COUNT = 3;
+
+private:
+  ShadowTagArray baseline_;
+  std::array<ShadowTagArray, VARIANT_COUNT> variants_;
+  std::array<RemapVariantReport, VARIANT_COUNT> reports_;
+  int offset_bits_;
+  uint64_t clock_ = 0;
+  uint64_t accesses_ = 0;
+  uint64_t baseline_misses_ = 0;
+  FlatMap<SourceKey, RemapLineStats, SourceKeyHash> line_stats_;
+
+public:
+  explicit RemapAnalysis(const CacheConfig &l1d)
+      : baseline_(l1d.num_sets(), l1d.associativity, false),
+        variants_{ShadowTagArray(std::max(l1d.num_sets() / 2, 1),
+                                 l1d.associativity * 2, false),
+                  ShadowTagArray(l1d.num_sets(), l1d.associativity, true),
+                  ShadowTagArray(l1d.num_sets() * 2, l1d.associativity, false)},
+        offset_bits_(l1d.offset_bits()) {
+    reports_[0] = {"assoc2x", std::max(l1d.num_sets() / 2, 1),
+                   l1d.associativity * 2, false};
+    reports_[1] = {"hashed", l1d.num_sets(), l1d.associativity, true};
+    reports_[2] = {"sets2x", l1d.num_sets() * 2, l1d.associativity, false};
+  }
+
+  // Shadow one demand data access through the baseline and every
+  // candidate geometry, attributing avoided misses to the source line
+  void observe(uint64_t line_addr, std::string_view file, uint32_t line) {
+    uint64_t key = line_addr >> offset_bits_;
+    clock_++;
+    accesses_++;
+    bool base_hit = baseline_.access(key, clock_);
+    if (!base_hit)
+      baseline_misses_++;
+
+    RemapLineStats *per_line = nullptr;
+    if (!base_hit && !file.empty()) {
+      SourceKey src{file, line};
+      auto it = line_stats_.find(src);
+      if (it == line_stats_.end()) {
+        RemapLineStats stats;
+        stats.file = file;
+        stats.line = line;
+        it = line_stats_.emplace(src, std::move(stats)).first;
+      }
+      it->second.shadow_misses++;
+      per_line = &it->second;
+    }
+
+    for (size_t v = 0; v < VARIANT_COUNT; v++) {
+      bool hit = variants_[v].access(key, clock_);
+      if (!hit)
+        reports_[v].misses++;
+      if (!base_hit && hit) {
+        reports_[v].avoided++;
+        if (per_line)
+          per_line->avoided[v]++;
+      }
+    }
+  }
+
+  [[nodiscard]] uint64_t accesses() const { return accesses_; }
+  [[nodiscard]] uint64_t baseline_misses() const { return baseline_misses_; }
+  [[nodiscard]] const std::array<RemapVariantReport, VARIANT_COUNT> &
+  get_variants() const {
+    return reports_;
+  }
+
+  // Fraction of baseline-shadow misses the variant eliminated
+  [[nodiscard]] double reduction(size_t v) const {
+    return baseline_misses_
+        ? static_cast<double>(reports_[v].avoided) / baseline_misses_
+        : 0.0;
+  }
+
+  // Lines whose misses some remap would avoid, most-fixable first
+  [[nodiscard]] std::vector<RemapLineStats> get_hot_lines(size_t limit = 10) const {
+    std::vector<RemapLineStats> sorted;
+    for (const auto &[key, stats] : line_stats_) {
+      uint64_t best = *std::max_element(stats.avoided.begin(), stats.avoided.end());
+      if (best > 0)
+        sorted.push_back(stats);
+    }
+    // Break avoided-count ties on location so output is deterministic
+    // regardless of hash-map iteration order
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+      uint64_t av = *std::max_element(a.avoided.begin(), a.avoided.end());
+      uint64_t bv = *std::max_element(b.avoided.begin(), b.avoided.end());
+      if (av != bv)
+        return av > bv;
+      if (a.file != b.file)
+        return a.file < b.file;
+      return a.line < b.line;
+    });
+    if (sorted.size() > limit)
+      sorted.resize(limit);
+    return sorted;
+  }
+};
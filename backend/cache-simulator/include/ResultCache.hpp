@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * ResultCache - content-addressed result memoization.
+ *
+ * The server already caches at the request level (cache-explorer.db),
+ * but batch pipelines drive cache-sim directly and resubmit a lot of
+ * duplicate work after retries. Identical trace bytes plus identical
+ * effective configuration always produce identical JSON, so the run can
+ * be keyed by a hash of both and short-circuited to the stored output.
+ *
+ * Keys are 64-bit FNV-1a (same hash family as SegmentCache); entries
+ * live as individual files under ~/.cache/cache-explorer/results/ next
+ * to the CLI's pass cache, written via temp-file + rename so a killed
+ * run never leaves a truncated entry. --no-cache bypasses both lookup
+ * and store.
+ */
+class ResultCache {
+public:
+  static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+  static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+  // Streaming FNV-1a; pass the previous return value as seed to chain
+  static uint64_t hash_bytes(const void *data, size_t len,
+                             uint64_t seed = FNV_OFFSET) {
+    const auto *p = static_cast<const unsigned char *>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < len; i++) {
+      h ^= p[i];
+      h *= FNV_PRIME;
+    }
+    return h;
+  }
+
+  static uint64_t hash_string(std::string_view s, uint64_t seed = FNV_OFFSET) {
+    return hash_bytes(s.data(), s.size(), seed);
+  }
+
+  // ~/.cache/cache-explorer/results (XDG_CACHE_HOME respected), matching
+  // where the CLI keeps its pre-built pass cache
+  static std::string default_dir() {
+    std::string base;
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+      base = xdg;
+    } else if (const char *home = std::getenv("HOME"); home && *home) {
+      base = std::string(home) + "/.cache";
+    } else {
+      return ""; // no usable cache location - caching silently disabled
+    }
+    return base + "/cache-explorer/results";
+  }
+
+  explicit ResultCache(std::string dir = default_dir()) : dir_(std::move(dir)) {}
+
+  [[nodiscard]] bool usable() const { return !dir_.empty(); }
+
+  // Returns the stored JSON for this key, or nullopt on miss
+  [[nodiscard]] std::optional<std::string> lookup(uint64_t key) const {
+    if (!usable())
+      return std::nullopt;
+    std::ifstream in(entry_path(key), std::ios::binary);
+    if (!in)
+      return std::nullopt;
+    std::ostringstream buf;
+    buf << in.rdbuf();
+    std::string text = buf.str();
+    if (text.empty()) // never replay a truncated entry
+      return std::nullopt;
+    return text;
+  }
+
+  // Best-effort store; failures (read-only FS, disk full) are ignored -
+  // the cache is an accelerator, never a correctness dependency
+  void store(uint64_t key, std::string_view json) const {
+    if (!usable() || json.empty())
+      return;
+    if (!ensure_dir())
+      return;
+    std::string final_path = entry_path(key);
+    std::string tmp_path =
+        final_path + ".tmp." + std::to_string(::getpid());
+    {
+      std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!out)
+        return;
+      out.write(json.data(), static_cast<std::streamsize>(json.size()));
+      if (!out) {
+        out.close();
+        ::unlink(tmp_path.c_str());
+        return;
+      }
+    }
+    if (::rename(tmp_path.c_str(), final_path.c_str()) != 0)
+      ::unlink(tmp_path.c_str());
+  }
+
+private:
+  [[nodiscard]] std::string entry_path(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.json",
+                  static_cast<unsigned long long>(key));
+    return dir_ + "/" + name;
+  }
+
+  // mkdir -p for the cache directory
+  [[nodiscard]] bool ensure_dir() const {
+    std::string partial;
+    for (size_t i = 0; i <= dir_.size(); i++) {
+      if (i == dir_.size() || dir_[i] == '/') {
+        partial = dir_.substr(0, i);
+        if (partial.empty())
+          continue;
+        if (::mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  std::string dir_;
+};
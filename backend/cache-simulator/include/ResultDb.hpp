@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "JsonParser.hpp"
+
+// Columnar result database behind the result-db tool.
+//
+// Nightly reporting jobs used to re-read hundreds of multi-MB result
+// JSON files to answer questions like "how did this line's miss rate
+// move over the last 50 runs" - the JSON parsing dominated the job.
+// result-db ingests each run's JSON once, keeps only what the reports
+// query (per-run summary metrics, hot lines, interval series), and
+// stores every field as its own contiguous column. A year of nightly
+// runs is a few hundred KB, loaded with one read per column.
+//
+// Layout: 4-byte magic "CXRD" + uint32 version, the interned string
+// table (labels, commits, presets, file names), then each column as a
+// length-prefixed array. Values are host-format like the CXTB trace and
+// CXCP checkpoint formats: the database lives next to the CI job that
+// writes it, it is not a portable interchange file.
+
+constexpr char RESULTDB_MAGIC[4] = {'C', 'X', 'R', 'D'};
+constexpr uint32_t RESULTDB_VERSION = 1;
+
+// One run's summary row, materialized from the columns for callers
+struct ResultRun {
+  uint32_t id = 0;
+  uint64_t timestamp = 0;       // seconds since the epoch, caller-supplied
+  std::string_view label;       // e.g. the benchmark or trace name
+  std::string_view commit;      // source revision the run measured
+  std::string_view config;      // hardware preset
+  uint64_t events = 0;
+  uint64_t l1d_hits = 0, l1d_misses = 0;
+  uint64_t l2_hits = 0, l2_misses = 0;
+  uint64_t l3_hits = 0, l3_misses = 0;
+  uint64_t total_cycles = 0;
+  [[nodiscard]] double l1d_miss_rate() const {
+    uint64_t total = l1d_hits + l1d_misses;
+    return total ? static_cast<double>(l1d_misses) / total : 0.0;
+  }
+};
+
+// One point of a source line's miss-rate trend, oldest first
+struct TrendPoint {
+  uint32_t run = 0;
+  uint64_t timestamp = 0;
+  std::string_view commit;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  [[nodiscard]] double miss_rate() const {
+    uint64_t total = hits + misses;
+    return total ? static_cast<double>(misses) / total : 0.0;
+  }
+};
+
+// A hot line whose miss rate worsened between two runs
+struct LineRegression {
+  std::string_view file;
+  uint32_t line = 0;
+  double before_rate = 0.0;
+  double after_rate = 0.0;
+  uint64_t after_misses = 0;
+};
+
+// One preset x commit cell: the newest run's L1D miss rate there
+struct MatrixCell {
+  std::string_view config;
+  std::string_view commit;
+  uint32_t run = 0;
+  double l1d_miss_rate = 0.0;
+};
+
+class ResultDb {
+private:
+  // Interned strings: every repeated label/commit/preset/file name is
+  // one uint32 per row instead of a copy per row
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> string_ids_;
+
+  // Per-run columns, indexed by run id (append-only)
+  std::vector<uint64_t> run_timestamp_;
+  std::vector<uint32_t> run_label_;
+  std::vector<uint32_t> run_commit_;
+  std::vector<uint32_t> run_config_;
+  std::vector<uint64_t> run_events_;
+  std::vector<uint64_t> run_l1d_hits_, run_l1d_misses_;
+  std::vector<uint64_t> run_l2_hits_, run_l2_misses_;
+  std::vector<uint64_t> run_l3_hits_, run_l3_misses_;
+  std::vector<uint64_t> run_cycles_;
+
+  // Hot-line columns: one row per (run, source line) from the run's
+  // hotLines block, grouped by run in ingestion order
+  std::vector<uint32_t> hl_run_;
+  std::vector<uint32_t> hl_file_;
+  std::vector<uint32_t> hl_line_;
+  std::vector<uint64_t> hl_hits_;
+  std::vector<uint64_t> hl_misses_;
+
+  // Interval columns: one row per --interval window of a run
+  std::vector<uint32_t> iv_run_;
+  std::vector<uint64_t> iv_events_;
+  std::vector<uint64_t> iv_l1d_hits_;
+  std::vector<uint64_t> iv_l1d_misses_;
+
+  uint32_t intern(const std::string &s) {
+    auto it = string_ids_.find(s);
+    if (it != string_ids_.end())
+      return it->second;
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(s);
+    string_ids_.emplace(s, id);
+    return id;
+  }
+
+  [[nodiscard]] std::string_view name(uint32_t id) const {
+    return id < strings_.size() ? std::string_view(strings_[id])
+                                : std::string_view();
+  }
+
+  template <typename T>
+  static void write_column(std::ofstream &out, const std::vector<T> &v) {
+    uint64_t n = v.size();
+    out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+    if (n)
+      out.write(reinterpret_cast<const char *>(v.data()),
+                static_cast<std::streamsize>(n * sizeof(T)));
+  }
+
+  template <typename T>
+  static void read_column(std::ifstream &in, std::vector<T> &v) {
+    uint64_t n = 0;
+    in.read(reinterpret_cast<char *>(&n), sizeof(n));
+    v.resize(n);
+    if (n)
+      in.read(reinterpret_cast<char *>(v.data()),
+              static_cast<std::streamsize>(n * sizeof(T)));
+    if (!in)
+      throw std::runtime_error("result database truncated or unreadable");
+  }
+
+public:
+  [[nodiscard]] size_t run_count() const { return run_timestamp_.size(); }
+  [[nodiscard]] size_t hot_line_count() const { return hl_run_.size(); }
+
+  [[nodiscard]] ResultRun get_run(uint32_t id) const {
+    ResultRun run;
+    run.id = id;
+    run.timestamp = run_timestamp_[id];
+    run.label = name(run_label_[id]);
+    run.commit = name(run_commit_[id]);
+    run.config = name(run_config_[id]);
+    run.events = run_events_[id];
+    run.l1d_hits = run_l1d_hits_[id];
+    run.l1d_misses = run_l1d_misses_[id];
+    run.l2_hits = run_l2_hits_[id];
+    run.l2_misses = run_l2_misses_[id];
+    run.l3_hits = run_l3_hits_[id];
+    run.l3_misses = run_l3_misses_[id];
+    run.total_cycles = run_cycles_[id];
+    return run;
+  }
+
+  // Ingest one run's result JSON (the simulator's own output). Only the
+  // queried fields are kept; anything the document lacks stays zero.
+  // Returns the new run's id.
+  uint32_t add_run(const JsonValue &doc, const std::string &label,
+                   const std::string &commit, uint64_t timestamp) {
+    uint32_t id = static_cast<uint32_t>(run_count());
+    run_timestamp_.push_back(timestamp);
+    run_label_.push_back(intern(label));
+    run_commit_.push_back(intern(commit));
+    const JsonValue *config = doc.find("config");
+    run_config_.push_back(intern(config ? config->as_string() : "unknown"));
+    const JsonValue *events = doc.find("events");
+    run_events_.push_back(events ? events->as_u64() : 0);
+
+    auto level = [&](const char *key, std::vector<uint64_t> &hits,
+                     std::vector<uint64_t> &misses) {
+      const JsonValue *h = doc.find("levels", key, "hits");
+      const JsonValue *m = doc.find("levels", key, "misses");
+      hits.push_back(h ? h->as_u64() : 0);
+      misses.push_back(m ? m->as_u64() : 0);
+    };
+    // Multicore runs report a combined "l1"; fold it into the l1d column
+    if (doc.find("levels", "l1d")) {
+      level("l1d", run_l1d_hits_, run_l1d_misses_);
+    } else {
+      level("l1", run_l1d_hits_, run_l1d_misses_);
+    }
+    level("l2", run_l2_hits_, run_l2_misses_);
+    level("l3", run_l3_hits_, run_l3_misses_);
+
+    const JsonValue *cycles = doc.find("timing", "totalCycles");
+    run_cycles_.push_back(cycles ? cycles->as_u64() : 0);
+
+    if (const JsonValue *hot = doc.find("hotLines");
+        hot && hot->type == JsonValue::Type::Array) {
+      for (const JsonValue &entry : hot->array) {
+        const JsonValue *file = entry.find("file");
+        const JsonValue *line = entry.find("line");
+        if (!file || !line)
+          continue;
+        hl_run_.push_back(id);
+        hl_file_.push_back(intern(file->as_string()));
+        hl_line_.push_back(static_cast<uint32_t>(line->as_u64()));
+        const JsonValue *hits = entry.find("hits");
+        const JsonValue *misses = entry.find("misses");
+        hl_hits_.push_back(hits ? hits->as_u64() : 0);
+        hl_misses_.push_back(misses ? misses->as_u64() : 0);
+      }
+    }
+
+    if (const JsonValue *iv = doc.find("intervals")) {
+      const JsonValue *events_col = iv->find("events");
+      const JsonValue *hits_col = iv->find("l1dHits");
+      const JsonValue *misses_col = iv->find("l1dMisses");
+      if (events_col && hits_col && misses_col) {
+        size_t n = events_col->array.size();
+        for (size_t i = 0; i < n; i++) {
+          iv_run_.push_back(id);
+          iv_events_.push_back(events_col->array[i].as_u64());
+          iv_l1d_hits_.push_back(i < hits_col->array.size()
+                                     ? hits_col->array[i].as_u64()
+                                     : 0);
+          iv_l1d_misses_.push_back(i < misses_col->array.size()
+                                       ? misses_col->array[i].as_u64()
+                                       : 0);
+        }
+      }
+    }
+    return id;
+  }
+
+  // A source line's miss-rate history over the last `last_n` runs that
+  // ranked it among their hot lines, oldest first
+  [[nodiscard]] std::vector<TrendPoint> trend(std::string_view file,
+                                              uint32_t line,
+                                              size_t last_n = 50) const {
+    std::vector<TrendPoint> points;
+    for (size_t i = 0; i < hl_run_.size(); i++) {
+      if (hl_line_[i] != line || name(hl_file_[i]) != file)
+        continue;
+      TrendPoint p;
+      p.run = hl_run_[i];
+      p.timestamp = run_timestamp_[p.run];
+      p.commit = name(run_commit_[p.run]);
+      p.hits = hl_hits_[i];
+      p.misses = hl_misses_[i];
+      points.push_back(p);
+    }
+    if (points.size() > last_n)
+      points.erase(points.begin(), points.end() - last_n);
+    return points;
+  }
+
+  // Hot lines whose miss rate rose by at least `min_delta` between the
+  // two newest runs, worst first. Lines absent from either run are
+  // skipped - a line falling off the hot list is a resolution, not a
+  // regression.
+  [[nodiscard]] std::vector<LineRegression>
+  regressions(double min_delta = 0.01) const {
+    std::vector<LineRegression> found;
+    if (run_count() < 2)
+      return found;
+    uint32_t after = static_cast<uint32_t>(run_count() - 1);
+    uint32_t before = after - 1;
+    for (size_t i = 0; i < hl_run_.size(); i++) {
+      if (hl_run_[i] != after)
+        continue;
+      for (size_t j = 0; j < hl_run_.size(); j++) {
+        if (hl_run_[j] != before || hl_file_[j] != hl_file_[i] ||
+            hl_line_[j] != hl_line_[i])
+          continue;
+        uint64_t bt = hl_hits_[j] + hl_misses_[j];
+        uint64_t at = hl_hits_[i] + hl_misses_[i];
+        double before_rate = bt ? static_cast<double>(hl_misses_[j]) / bt : 0;
+        double after_rate = at ? static_cast<double>(hl_misses_[i]) / at : 0;
+        if (after_rate - before_rate >= min_delta) {
+          found.push_back({name(hl_file_[i]), hl_line_[i], before_rate,
+                           after_rate, hl_misses_[i]});
+        }
+        break;
+      }
+    }
+    std::sort(found.begin(), found.end(), [](const auto &a, const auto &b) {
+      return a.after_rate - a.before_rate > b.after_rate - b.before_rate;
+    });
+    return found;
+  }
+
+  // Preset x commit matrix of L1D miss rates, newest run per cell,
+  // ordered by preset then commit for stable output
+  [[nodiscard]] std::vector<MatrixCell> matrix() const {
+    std::vector<MatrixCell> cells;
+    for (uint32_t id = 0; id < run_count(); id++) {
+      MatrixCell cell{name(run_config_[id]), name(run_commit_[id]), id,
+                      get_run(id).l1d_miss_rate()};
+      auto it = std::find_if(cells.begin(), cells.end(), [&](const auto &c) {
+        return c.config == cell.config && c.commit == cell.commit;
+      });
+      if (it != cells.end())
+        *it = cell; // newer run wins the cell
+      else
+        cells.push_back(cell);
+    }
+    std::sort(cells.begin(), cells.end(), [](const auto &a, const auto &b) {
+      if (a.config != b.config)
+        return a.config < b.config;
+      return a.commit < b.commit;
+    });
+    return cells;
+  }
+
+  // One run's interval series (events, L1D hits, L1D misses per window)
+  [[nodiscard]] std::vector<std::array<uint64_t, 3>>
+  intervals(uint32_t run) const {
+    std::vector<std::array<uint64_t, 3>> rows;
+    for (size_t i = 0; i < iv_run_.size(); i++) {
+      if (iv_run_[i] == run)
+        rows.push_back({iv_events_[i], iv_l1d_hits_[i], iv_l1d_misses_[i]});
+    }
+    return rows;
+  }
+
+  // Throws std::runtime_error on I/O failure, like the checkpoint reader
+  void save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+      throw std::runtime_error("cannot write result database: " + path);
+    out.write(RESULTDB_MAGIC, sizeof(RESULTDB_MAGIC));
+    uint32_t version = RESULTDB_VERSION;
+    out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+
+    uint64_t string_count = strings_.size();
+    out.write(reinterpret_cast<const char *>(&string_count),
+              sizeof(string_count));
+    for (const std::string &s : strings_) {
+      uint32_t len = static_cast<uint32_t>(s.size());
+      out.write(reinterpret_cast<const char *>(&len), sizeof(len));
+      out.write(s.data(), len);
+    }
+
+    write_column(out, run_timestamp_);
+    write_column(out, run_label_);
+    write_column(out, run_commit_);
+    write_column(out, run_config_);
+    write_column(out, run_events_);
+    write_column(out, run_l1d_hits_);
+    write_column(out, run_l1d_misses_);
+    write_column(out, run_l2_hits_);
+    write_column(out, run_l2_misses_);
+    write_column(out, run_l3_hits_);
+    write_column(out, run_l3_misses_);
+    write_column(out, run_cycles_);
+    write_column(out, hl_run_);
+    write_column(out, hl_file_);
+    write_column(out, hl_line_);
+    write_column(out, hl_hits_);
+    write_column(out, hl_misses_);
+    write_column(out, iv_run_);
+    write_column(out, iv_events_);
+    write_column(out, iv_l1d_hits_);
+    write_column(out, iv_l1d_misses_);
+    if (!out)
+      throw std::runtime_error("result database write failed: " + path);
+  }
+
+  void load(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+      throw std::runtime_error("cannot open result database: " + path);
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || std::string_view(magic, 4) != std::string_view(RESULTDB_MAGIC, 4))
+      throw std::runtime_error("not a result database: " + path);
+    uint32_t version = 0;
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (!in || version != RESULTDB_VERSION)
+      throw std::runtime_error("unsupported result database version");
+
+    uint64_t string_count = 0;
+    in.read(reinterpret_cast<char *>(&string_count), sizeof(string_count));
+    strings_.clear();
+    string_ids_.clear();
+    for (uint64_t i = 0; i < string_count; i++) {
+      uint32_t len = 0;
+      in.read(reinterpret_cast<char *>(&len), sizeof(len));
+      std::string s(len, '\0');
+      in.read(s.data(), len);
+      if (!in)
+        throw std::runtime_error("result database truncated or unreadable");
+      string_ids_.emplace(s, static_cast<uint32_t>(strings_.size()));
+      strings_.push_back(std::move(s));
+    }
+
+    read_column(in, run_timestamp_);
+    read_column(in, run_label_);
+    read_column(in, run_commit_);
+    read_column(in, run_config_);
+    read_column(in, run_events_);
+    read_column(in, run_l1d_hits_);
+    read_column(in, run_l1d_misses_);
+    read_column(in, run_l2_hits_);
+    read_column(in, run_l2_misses_);
+    read_column(in, run_l3_hits_);
+    read_column(in, run_l3_misses_);
+    read_column(in, run_cycles_);
+    read_column(in, hl_run_);
+    read_column(in, hl_file_);
+    read_column(in, hl_line_);
+    read_column(in, hl_hits_);
+    read_column(in, hl_misses_);
+    read_column(in, iv_run_);
+    read_column(in, iv_events_);
+    read_column(in, iv_l1d_hits_);
+    read_column(in, iv_l1d_misses_);
+  }
+};
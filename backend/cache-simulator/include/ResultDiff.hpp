@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CacheStats.hpp"
+
+/**
+ * ResultDiff - computed baseline comparison (--diff baseline.json).
+ *
+ * Comparison used to live entirely in the frontend: both complete
+ * result documents crossed the wire and the browser diffed them. For
+ * CI-style before/after runs that is the slow part, so the simulator
+ * can now load a prior result JSON and emit only the deltas - per-level
+ * metric changes, hot lines that entered or changed in the current
+ * top-K, and baseline lines that resolved (dropped off the list).
+ */
+
+// The slice of a prior result document the diff needs
+struct BaselineHotLine {
+  std::string file;
+  uint32_t line = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+struct BaselineLevel {
+  bool present = false;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  [[nodiscard]] double hit_rate() const {
+    uint64_t total = hits + misses;
+    return total ? static_cast<double>(hits) / total : 0.0;
+  }
+};
+
+struct BaselineResult {
+  std::string config;
+  uint64_t events = 0;
+  BaselineLevel l1d, l2, l3;
+  uint64_t total_cycles = 0;
+  std::vector<BaselineHotLine> hot_lines;
+
+  // Reads and parses a prior --json result; nullopt when the file is
+  // missing or not a result document. Accepts both the single-core
+  // ("l1d") and multi-core ("l1") level naming.
+  static std::optional<BaselineResult> load(const std::string &path);
+};
+
+// Emit the compact diff document comparing the current run against the
+// baseline. Hot lines are matched by file:line; top_k bounds both lists.
+void write_result_diff(std::ostream &out, const std::string &config_name,
+                       uint64_t events, const CacheStats &l1d,
+                       const CacheStats &l2, const CacheStats &l3,
+                       uint64_t total_cycles,
+                       const std::vector<BaselineHotLine> &hot_lines,
+                       const BaselineResult &baseline, size_t top_k = 10);
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Single-pass reuse-distance (Mattson stack) analysis
+//
+// Computes the LRU stack distance of every line access in one pass using a
+// Fenwick tree over access timestamps: each live line contributes a 1 at its
+// last-access time, so the number of distinct lines touched since a line's
+// previous access is a prefix-sum difference - O(log n) per access.
+//
+// Distances land in power-of-two buckets, which stays exact for miss-ratio
+// queries at power-of-two cache sizes: a fully associative LRU cache of C
+// lines misses exactly the accesses with stack distance >= C, and every
+// bucket falls entirely on one side of such a boundary.
+//
+// Timestamps are renumbered in place when the tree fills, so memory is
+// O(distinct lines), not O(trace length).
+class ReuseDistanceAnalyzer {
+public:
+  explicit ReuseDistanceAnalyzer(size_t initial_capacity = 1 << 16)
+      : capacity(initial_capacity), tree(initial_capacity + 1, 0) {}
+
+  // Record one access to a cache-line address
+  void access(uint64_t line_addr) {
+    total++;
+    auto it = last_access.find(line_addr);
+    if (it != last_access.end()) {
+      // Distinct lines touched strictly after this line's previous access
+      uint64_t d = prefix(cur_time) - prefix(it->second + 1);
+      hist[bucket(d)]++;
+      update(it->second, -1);
+      // Drop the stale entry so a compaction below only sees live marks
+      last_access.erase(it);
+    } else {
+      cold++;
+    }
+
+    if (cur_time == capacity)
+      compact();
+    update(cur_time, +1);
+    last_access.emplace(line_addr, cur_time);
+    cur_time++;
+  }
+
+  // Misses a fully associative LRU cache of line_count lines would take
+  // over the recorded trace. line_count must be a power of two.
+  [[nodiscard]] uint64_t misses_at(uint64_t line_count) const {
+    if (line_count == 0)
+      return total;
+    int m = 0;
+    while ((1ULL << (m + 1)) <= line_count)
+      m++;
+    uint64_t misses = cold;
+    for (int k = m + 1; k <= 64; k++)
+      misses += hist[k];
+    return misses;
+  }
+
+  struct MissRatioPoint {
+    uint64_t cache_bytes;
+    uint64_t misses;
+    double miss_ratio;
+  };
+
+  // Miss-ratio curve at power-of-two cache sizes from min_bytes to
+  // max_bytes inclusive
+  [[nodiscard]] std::vector<MissRatioPoint>
+  miss_ratio_curve(uint32_t line_size, uint64_t min_bytes = 4096,
+                   uint64_t max_bytes = 256ULL << 20) const {
+    std::vector<MissRatioPoint> curve;
+    if (total == 0)
+      return curve;
+    for (uint64_t bytes = min_bytes; bytes <= max_bytes; bytes *= 2) {
+      uint64_t lines = bytes / line_size;
+      if (lines == 0)
+        continue;
+      uint64_t misses = misses_at(lines);
+      curve.push_back({bytes, misses, (double)misses / (double)total});
+    }
+    return curve;
+  }
+
+  [[nodiscard]] uint64_t total_accesses() const { return total; }
+  [[nodiscard]] uint64_t cold_misses() const { return cold; }
+  [[nodiscard]] size_t distinct_lines() const { return last_access.size(); }
+
+private:
+  // Power-of-two distance bucket: 0 -> 0, then [2^(k-1), 2^k - 1] -> k
+  static int bucket(uint64_t d) {
+    return d == 0 ? 0 : 64 - __builtin_clzll(d);
+  }
+
+  // Fenwick tree over timestamps, 1-based internally
+  void update(size_t pos, int delta) {
+    for (size_t i = pos + 1; i <= capacity; i += i & (~i + 1))
+      tree[i] += delta;
+  }
+
+  // Number of marked timestamps < n
+  [[nodiscard]] uint64_t prefix(size_t n) const {
+    uint64_t sum = 0;
+    for (size_t i = n; i > 0; i -= i & (~i + 1))
+      sum += tree[i];
+    return sum;
+  }
+
+  // The tree is full: renumber live lines' timestamps to 0..live-1 in
+  // order, growing the tree only when the live set actually needs it
+  void compact() {
+    std::vector<std::pair<size_t, uint64_t>> live;  // (old ts, line)
+    live.reserve(last_access.size());
+    for (const auto &[line, ts] : last_access)
+      live.emplace_back(ts, line);
+    std::sort(live.begin(), live.end());
+
+    if (live.size() * 2 > capacity)
+      capacity *= 2;
+    tree.assign(capacity + 1, 0);
+    for (size_t i = 0; i < live.size(); i++) {
+      last_access[live[i].second] = i;
+      update(i, +1);
+    }
+    cur_time = live.size();
+  }
+
+  size_t capacity;
+  size_t cur_time = 0;
+  std::vector<int64_t> tree;
+  std::unordered_map<uint64_t, size_t> last_access;
+  uint64_t hist[65] = {};
+  uint64_t total = 0;
+  uint64_t cold = 0;
+};
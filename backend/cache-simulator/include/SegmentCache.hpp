@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "TLB.hpp"
+
+// Segment caching: memoize the stats delta of repeated access patterns
+//
+// Tight loops replay identical address sequences millions of times. Once a
+// segment (a fixed-length window of accesses) has produced the same stats
+// delta on two consecutive simulated runs, the cache state is periodic at
+// segment boundaries and further repeats can be fast-forwarded by applying
+// the memoized delta instead of simulating every access.
+//
+// Correctness fallback: every VERIFY_INTERVAL applications the segment is
+// re-simulated and the delta compared; a mismatch marks the entry unstable
+// and simulation resumes until it converges again. The memo store is
+// LRU-bounded so pathological traces can't grow it without limit.
+
+// Per-source-line portion of a segment's stats delta
+struct SegmentSourceDelta {
+  std::string_view file; // Interned via FileTable - stable for the whole run
+  uint32_t line;
+  uint64_t hits;
+  uint64_t misses;
+
+  bool operator==(const SegmentSourceDelta &other) const {
+    return line == other.line && hits == other.hits &&
+           misses == other.misses && file == other.file;
+  }
+};
+
+// Everything one segment run changes, captured by diffing before/after
+struct SegmentDelta {
+  HierarchyStats hierarchy;
+  TLBStats dtlb;
+  TLBStats itlb;
+  TLBStats stlb;
+  std::vector<SegmentSourceDelta> sources;
+
+  bool operator==(const SegmentDelta &other) const {
+    return hierarchy.l1d == other.hierarchy.l1d &&
+           hierarchy.l1i == other.hierarchy.l1i &&
+           hierarchy.l2 == other.hierarchy.l2 &&
+           hierarchy.l3 == other.hierarchy.l3 &&
+           hierarchy.timing == other.hierarchy.timing &&
+           dtlb == other.dtlb && itlb == other.itlb &&
+           stlb == other.stlb &&
+           sources == other.sources;
+  }
+};
+
+struct SegmentCacheStats {
+  uint64_t lookups = 0;        // Completed segments checked against the memo
+  uint64_t fast_forwards = 0;  // Segments skipped by applying a memoized delta
+  uint64_t verifications = 0;  // Stable segments re-simulated as a spot check
+  uint64_t divergences = 0;    // Verifications whose delta no longer matched
+  uint64_t evictions = 0;      // Entries dropped by the LRU bound
+
+  [[nodiscard]] double hit_rate() const {
+    return lookups ? (double)fast_forwards / lookups : 0;
+  }
+};
+
+class SegmentCache {
+public:
+  static constexpr size_t DEFAULT_MAX_ENTRIES = 4096;
+  static constexpr uint64_t VERIFY_INTERVAL = 64;
+
+  struct Entry {
+    uint64_t pattern_hash;
+    SegmentDelta delta;
+    bool stable = false;       // Same delta on two consecutive simulated runs
+    uint64_t applications = 0; // Fast-forwards since the last simulation
+  };
+
+  explicit SegmentCache(size_t max_entries = DEFAULT_MAX_ENTRIES)
+      : max_entries(max_entries) {}
+
+  // Incremental FNV-1a over the segment's access pattern
+  static constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ULL;
+  static uint64_t hash_access(uint64_t h, uint64_t address, uint32_t flags) {
+    h ^= address;
+    h *= 0x100000001b3ULL;
+    h ^= flags;
+    h *= 0x100000001b3ULL;
+    return h;
+  }
+
+  // Look up a completed segment. If the entry is stable and not due for a
+  // verification run, its delta can be applied without simulating.
+  Entry *lookup(uint64_t pattern_hash) {
+    stats_.lookups++;
+    auto it = index.find(pattern_hash);
+    if (it == index.end())
+      return nullptr;
+    // Touch for LRU
+    lru_list.splice(lru_list.begin(), lru_list, it->second);
+    return &*it->second;
+  }
+
+  // True if this entry's delta can be applied without re-simulating
+  bool can_fast_forward(Entry &entry) {
+    if (!entry.stable)
+      return false;
+    if ((entry.applications + 1) % VERIFY_INTERVAL == 0) {
+      stats_.verifications++;
+      return false; // Periodic spot check - caller simulates and records
+    }
+    entry.applications++;
+    stats_.fast_forwards++;
+    return true;
+  }
+
+  // Record the delta from a simulated run of this segment. The entry becomes
+  // stable once two consecutive simulated runs produce the same delta.
+  void record(uint64_t pattern_hash, SegmentDelta delta) {
+    auto it = index.find(pattern_hash);
+    if (it != index.end()) {
+      Entry &entry = *it->second;
+      if (entry.delta == delta) {
+        entry.stable = true;
+        entry.applications = 0; // Restart the verification countdown
+      } else {
+        if (entry.stable)
+          stats_.divergences++;
+        entry.delta = std::move(delta);
+        entry.stable = false;
+        entry.applications = 0;
+      }
+      return;
+    }
+
+    if (lru_list.size() >= max_entries) {
+      index.erase(lru_list.back().pattern_hash);
+      lru_list.pop_back();
+      stats_.evictions++;
+    }
+    lru_list.push_front(Entry{pattern_hash, std::move(delta), false, 0});
+    index.emplace(pattern_hash, lru_list.begin());
+  }
+
+  [[nodiscard]] const SegmentCacheStats &get_stats() const { return stats_; }
+  [[nodiscard]] size_t size() const { return lru_list.size(); }
+
+  void clear() {
+    index.clear();
+    lru_list.clear();
+    stats_ = {};
+  }
+
+private:
+  size_t max_entries;
+  std::list<Entry> lru_list; // Front = most recently used
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+  SegmentCacheStats stats_;
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+// Self-profiling for the simulator's own pipeline (--self-profile): when a
+// run is slow, this answers "which stage?" without reaching for perf. The
+// pipeline is staged, not interleaved, so four timestamps cover it - each
+// enter() closes the previous stage with one raw cycle-counter read (rdtsc
+// on x86, the generic timer on ARM) and there is no per-event cost at all,
+// which is what makes it safe to leave on in production batch runs. Tick
+// counts are calibrated against wall time once at report, so the stderr
+// summary shows real milliseconds plus per-stage throughput.
+enum class ProfileStage { Read = 0, Parse, Simulate, Output };
+
+class SelfProfiler {
+public:
+  static constexpr size_t STAGE_COUNT = 4;
+
+  explicit SelfProfiler(bool enabled) : enabled_(enabled) {
+    if (enabled_) {
+      wall_start_ = std::chrono::steady_clock::now();
+      tick_start_ = read_ticks();
+    }
+  }
+
+  SelfProfiler(const SelfProfiler &) = delete;
+  SelfProfiler &operator=(const SelfProfiler &) = delete;
+
+  ~SelfProfiler() {
+    if (enabled_ && current_ >= 0) {
+      report(*report_out_);
+    }
+  }
+
+  // Close the running stage (if any) and start timing the given one.
+  // Stages may be re-entered; ticks accumulate.
+  void enter(ProfileStage stage) {
+    if (!enabled_) {
+      return;
+    }
+    uint64_t now = read_ticks();
+    if (current_ >= 0) {
+      ticks_[static_cast<size_t>(current_)] += now - stage_start_;
+    }
+    current_ = static_cast<int>(stage);
+    stage_start_ = now;
+  }
+
+  void set_bytes_read(uint64_t bytes) { bytes_read_ = bytes; }
+  void set_events(uint64_t events) { events_ = events; }
+
+  // Where the exit summary goes (stderr by default; tests redirect it)
+  void set_report_stream(std::ostream &out) { report_out_ = &out; }
+
+  [[nodiscard]] bool is_enabled() const { return enabled_; }
+  [[nodiscard]] uint64_t stage_ticks(ProfileStage stage) const {
+    return ticks_[static_cast<size_t>(stage)];
+  }
+
+  // Raw cycle/timer counter: ~20 cycles to read, monotonic per core and
+  // constant-rate on every machine this targets (invariant TSC on x86,
+  // cntvct_el0 on aarch64). Falls back to the steady clock elsewhere.
+  static uint64_t read_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+  }
+
+  void report(std::ostream &out) {
+    // Close the stage still running, then calibrate ticks to wall time
+    // from the run's own start/end pair
+    uint64_t now = read_ticks();
+    if (current_ >= 0) {
+      ticks_[static_cast<size_t>(current_)] += now - stage_start_;
+      current_ = -1;
+    }
+    double wall_ms =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - wall_start_)
+            .count();
+    uint64_t total_ticks = now - tick_start_;
+    double ms_per_tick = total_ticks > 0 ? wall_ms / total_ticks : 0.0;
+
+    static constexpr const char *NAMES[STAGE_COUNT] = {"read", "parse",
+                                                       "simulate", "output"};
+    uint64_t staged_ticks = 0;
+    for (uint64_t t : ticks_) {
+      staged_ticks += t;
+    }
+
+    out << "[self-profile] pipeline stages (" << total_ticks
+        << " ticks, " << fixed1(wall_ms) << " ms wall):\n";
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+      double ms = ticks_[i] * ms_per_tick;
+      double pct = staged_ticks > 0
+                       ? 100.0 * static_cast<double>(ticks_[i]) / staged_ticks
+                       : 0.0;
+      out << "[self-profile]   " << NAMES[i] << pad(NAMES[i]) << ticks_[i]
+          << " ticks  " << fixed1(ms) << " ms  " << fixed1(pct) << "%";
+      if (i == static_cast<size_t>(ProfileStage::Read) && bytes_read_ > 0 &&
+          ms > 0.0) {
+        out << "  " << fixed1(bytes_read_ / (ms * 1e3)) << " MB/s";
+      }
+      if ((i == static_cast<size_t>(ProfileStage::Parse) ||
+           i == static_cast<size_t>(ProfileStage::Simulate)) &&
+          events_ > 0 && ms > 0.0) {
+        out << "  " << fixed1(events_ / (ms * 1e3)) << " Mevents/s";
+      }
+      out << "\n";
+    }
+    if (events_ > 0) {
+      out << "[self-profile]   events: " << events_ << "\n";
+    }
+  }
+
+private:
+  // Minimal fixed-point formatting without dragging <iomanip> state onto
+  // a stream the caller also uses
+  struct fixed1 {
+    double v;
+    explicit fixed1(double value) : v(value) {}
+    friend std::ostream &operator<<(std::ostream &os, const fixed1 &f) {
+      int64_t scaled = static_cast<int64_t>(f.v * 10.0 + (f.v >= 0 ? 0.5 : -0.5));
+      return os << scaled / 10 << "." << (scaled < 0 ? -scaled : scaled) % 10;
+    }
+  };
+
+  // Pad stage names to the longest ("simulate") for aligned columns
+  static const char *pad(const char *name) {
+    static constexpr const char *SPACES = "          ";
+    size_t len = 0;
+    while (name[len] != '\0') {
+      len++;
+    }
+    return SPACES + len + 1;
+  }
+
+  bool enabled_;
+  int current_ = -1;
+  uint64_t stage_start_ = 0;
+  uint64_t tick_start_ = 0;
+  std::chrono::steady_clock::time_point wall_start_;
+  std::array<uint64_t, STAGE_COUNT> ticks_{};
+  uint64_t bytes_read_ = 0;
+  uint64_t events_ = 0;
+  std::ostream *report_out_ = &std::cerr;
+};
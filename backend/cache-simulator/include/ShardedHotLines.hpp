@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "FlatMap.hpp"
+#include "SourceKey.hpp"
+
+// Mergeable per-shard hot-line tables (--parallel-sim)
+//
+// The single source_stats table serializes hot-line accounting: every
+// access bumps one shared map, so the epoch engine's workers hand their
+// results back to a sequential loop. These shards give each worker a
+// private flat table to bump instead - shards share nothing, so epoch
+// accounting parallelizes with the simulation itself.
+//
+// The same source line lands in every shard whose worker touched it, but
+// reporting never builds a union map to reconcile them: each shard's
+// entries are sorted by key once, a k-way merge folds the per-shard runs
+// of each key on the fly, and every folded record streams straight into
+// a bounded top-K heap. Peak merge memory is the shard cursor heap plus
+// K entries, no matter how many distinct lines the trace touched.
+class ShardedHotLines {
+public:
+  struct Entry {
+    std::string_view file; // interned - stable for the whole run
+    uint32_t line = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t thread_mask = 0; // bit per thread id (mod 64)
+  };
+
+  explicit ShardedHotLines(size_t num_shards)
+      : shards_(num_shards ? num_shards : 1) {}
+
+  [[nodiscard]] size_t shard_count() const { return shards_.size(); }
+
+  [[nodiscard]] bool empty() const {
+    for (const auto &shard : shards_) {
+      if (!shard.empty())
+        return false;
+    }
+    return true;
+  }
+
+  // Record one access outcome into one shard. Shards share nothing, so
+  // concurrent calls are safe as long as each worker sticks to its own
+  // shards.
+  void record(size_t shard, std::string_view file, uint32_t line,
+              bool l1_hit, uint32_t thread_id) {
+    auto &entry = shards_[shard][SourceKey{file, line}];
+    entry.file = file;
+    entry.line = line;
+    entry.thread_mask |= 1ULL << (thread_id & 63);
+    if (l1_hit)
+      entry.hits++;
+    else
+      entry.misses++;
+  }
+
+  // Stream every distinct source line through fn exactly once, with the
+  // per-shard counts already folded - the k-way merge core, shared by
+  // merge_top_k and the per-function rollup
+  template <typename Fn> void for_each_merged(Fn &&fn) const {
+    // One key-sorted cursor per non-empty shard. Interned file views
+    // compare by pointer: equal names share storage, so the order is
+    // arbitrary but identical across shards - all a merge needs.
+    auto key_less = [](const Entry *a, const Entry *b) {
+      if (a->file.data() != b->file.data())
+        return a->file.data() < b->file.data();
+      return a->line < b->line;
+    };
+    std::vector<std::vector<const Entry *>> runs;
+    runs.reserve(shards_.size());
+    for (const auto &shard : shards_) {
+      if (shard.empty())
+        continue;
+      std::vector<const Entry *> run;
+      run.reserve(shard.size());
+      for (const auto &[key, entry] : shard)
+        run.push_back(&entry);
+      std::sort(run.begin(), run.end(), key_less);
+      runs.push_back(std::move(run));
+    }
+
+    // Min-heap of shard cursors keyed by their current entry; equal keys
+    // surface back to back and fold into one record
+    struct Cursor {
+      const Entry *const *pos;
+      const Entry *const *end;
+    };
+    auto cursor_greater = [&](const Cursor &a, const Cursor &b) {
+      return key_less(*b.pos, *a.pos);
+    };
+    std::vector<Cursor> heap;
+    heap.reserve(runs.size());
+    for (const auto &run : runs)
+      heap.push_back({run.data(), run.data() + run.size()});
+    std::make_heap(heap.begin(), heap.end(), cursor_greater);
+
+    while (!heap.empty()) {
+      Entry folded;
+      folded.file = (*heap.front().pos)->file;
+      folded.line = (*heap.front().pos)->line;
+      // The heap front never precedes folded's key, so "not after" here
+      // means equal - keep folding until the key changes
+      while (!heap.empty() && !key_less(&folded, *heap.front().pos)) {
+        const Entry &e = **heap.front().pos;
+        folded.hits += e.hits;
+        folded.misses += e.misses;
+        folded.thread_mask |= e.thread_mask;
+        std::pop_heap(heap.begin(), heap.end(), cursor_greater);
+        if (++heap.back().pos == heap.back().end)
+          heap.pop_back();
+        else
+          std::push_heap(heap.begin(), heap.end(), cursor_greater);
+      }
+      fn(folded);
+    }
+  }
+
+  // Report-time ordering: misses first, file/line as a deterministic
+  // tiebreak so shard count never changes which ties make the cut
+  static bool hotter(const Entry &a, const Entry &b) {
+    if (a.misses != b.misses)
+      return a.misses > b.misses;
+    if (a.file != b.file)
+      return a.file < b.file;
+    return a.line < b.line;
+  }
+
+  // The limit hottest lines, descending. Folded records stream through a
+  // bounded min-heap, so only the top K are ever materialized.
+  [[nodiscard]] std::vector<Entry> merge_top_k(size_t limit) const {
+    std::vector<Entry> top;
+    top.reserve(limit + 1);
+    for_each_merged([&](const Entry &folded) {
+      if (top.size() < limit) {
+        top.push_back(folded);
+        std::push_heap(top.begin(), top.end(), hotter);
+      } else if (limit > 0 && hotter(folded, top.front())) {
+        std::pop_heap(top.begin(), top.end(), hotter);
+        top.back() = folded;
+        std::push_heap(top.begin(), top.end(), hotter);
+      }
+    });
+    // sort_heap with "hotter-is-less" leaves the hottest entries first
+    std::sort_heap(top.begin(), top.end(), hotter);
+    return top;
+  }
+
+private:
+  std::vector<FlatMap<SourceKey, Entry, SourceKeyHash>> shards_;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryTrace.hpp"
+#include "FileTable.hpp"
+#include "TraceEvent.hpp"
+
+// Shared-memory trace transport ("CXSM") shared with
+// backend/runtime/cache-explorer-rt.c (CACHE_EXPLORER_SHM=<path>)
+//
+// Even the binary pipe formats events and copies them through the kernel
+// twice. Here the runtime places its per-thread SPSC rings in a
+// file-backed segment and we map the same file and consume the packed
+// CacheEvent records in place: the producer writes a slot and advances
+// head, we decode it and advance tail. No formatting, no copies, no
+// syscalls per batch on either side.
+//
+// Layout (offsets fixed at compile time - keep in sync with the
+// CACHE_SHM_* constants in cache-explorer-rt.h):
+//   [0, 4096)            ShmTraceHeader; magic published last (release)
+//   [SHM_FILE_OFF, ...)  SHM_MAX_FILES file registrations
+//   [SHM_RING_OFF, ...)  SHM_MAX_RINGS page-aligned ring slots
+//
+// A ring is live once num_rings covers its slot; producer_done announces
+// that no further events will be produced. File registrations are
+// published (release on `ready`) before any event referencing their id
+// is reachable through a ring head, so a plain acquire scan never sees a
+// dangling file id.
+
+constexpr char SHM_TRACE_MAGIC[4] = {'C', 'X', 'S', 'M'};
+constexpr uint32_t SHM_TRACE_VERSION = 1;
+constexpr uint32_t SHM_RING_EVENTS = 1u << 16;
+constexpr uint32_t SHM_MAX_RINGS = 64;
+constexpr uint32_t SHM_MAX_FILES = 4096;
+constexpr uint32_t SHM_NAME_MAX = 256;
+
+// Mirrors the runtime's CacheEvent (32 bytes; tsc occupies the tail pad)
+struct ShmEventRecord {
+  uint64_t address;
+  uint64_t src_address;
+  uint32_t size;
+  uint32_t line;
+  uint32_t thread_id;
+  uint32_t tsc;
+};
+static_assert(sizeof(ShmEventRecord) == 32, "layout baked into pass IR");
+
+struct ShmTraceHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t ring_events;
+  uint32_t max_rings;
+  uint32_t max_files;
+  uint32_t num_rings;      // atomic
+  uint32_t producer_done;  // atomic
+  uint64_t dropped_events;
+};
+
+struct ShmFileEntry {
+  uint32_t ready;  // atomic
+  uint32_t pad;
+  char name[SHM_NAME_MAX];
+};
+
+// Same geometry as the runtime's ThreadRing: events array, then head and
+// tail on their own cache lines (head producer-owned, tail ours)
+struct ShmRing {
+  ShmEventRecord events[SHM_RING_EVENTS];
+  alignas(64) uint64_t head;
+  alignas(64) uint64_t tail;
+};
+
+constexpr size_t SHM_FILE_OFF = 4096;
+constexpr size_t SHM_RING_OFF =
+    SHM_FILE_OFF + SHM_MAX_FILES * sizeof(ShmFileEntry);
+constexpr size_t SHM_RING_STRIDE =
+    ((SHM_RING_EVENTS * 32ull + 128 + 4095) / 4096) * 4096;
+constexpr size_t SHM_SEGMENT_SIZE =
+    SHM_RING_OFF + SHM_MAX_RINGS * SHM_RING_STRIDE;
+static_assert(sizeof(ShmRing) <= SHM_RING_STRIDE,
+              "ring slots must hold a whole ring");
+static_assert(sizeof(ShmTraceHeader) <= SHM_FILE_OFF,
+              "header must fit its page");
+
+// Maps a producer's segment and drains the rings into TraceEvents.
+// Single-threaded consumer: each ring is SPSC with its producing thread,
+// and we are the S on the consuming side of all of them.
+class ShmTraceConsumer {
+public:
+    ~ShmTraceConsumer() {
+        if (base_ != nullptr) {
+            munmap(base_, SHM_SEGMENT_SIZE);
+        }
+    }
+
+    /// Map the segment at `path`, waiting up to `timeout_ms` for the
+    /// producer to create it and publish the header magic
+    [[nodiscard]] bool open(const std::string& path, int timeout_ms = 10000) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+        while (true) {
+            if (try_map(path) && magic_valid()) {
+                return header_->version == SHM_TRACE_VERSION &&
+                       header_->ring_events == SHM_RING_EVENTS &&
+                       header_->max_rings == SHM_MAX_RINGS;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    /// Drain events until the producer is done and every ring is empty.
+    /// Calls the callback with each decoded TraceEvent; returns the
+    /// number of events consumed.
+    template <typename Callback>
+    uint64_t consume(Callback&& cb) {
+        uint64_t consumed = 0;
+        bool done = false;
+        while (true) {
+            bool drained = false;
+            uint32_t rings = __atomic_load_n(&header_->num_rings, __ATOMIC_ACQUIRE);
+            if (rings > SHM_MAX_RINGS) {
+                rings = SHM_MAX_RINGS;
+            }
+            for (uint32_t slot = 0; slot < rings; slot++) {
+                consumed += drain_ring(ring(slot), cb, drained);
+            }
+            if (drained) {
+                continue;
+            }
+            if (done) {
+                break;  // One clean sweep after producer_done - all drained
+            }
+            if (__atomic_load_n(&header_->producer_done, __ATOMIC_ACQUIRE)) {
+                done = true;  // Final sweep picks up anything left in flight
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return consumed;
+    }
+
+    /// Events the producer dropped because we fell behind (valid after
+    /// consume() returns)
+    [[nodiscard]] uint64_t dropped() const {
+        return __atomic_load_n(&header_->dropped_events, __ATOMIC_RELAXED);
+    }
+
+private:
+    bool try_map(const std::string& path) {
+        if (base_ != nullptr) {
+            return true;
+        }
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) {
+            return false;
+        }
+        // The producer ftruncates to full size before publishing the
+        // magic; don't map a partially created file
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < SHM_SEGMENT_SIZE) {
+            close(fd);
+            return false;
+        }
+        void* base = mmap(nullptr, SHM_SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        base_ = base;
+        header_ = static_cast<ShmTraceHeader*>(base);
+        return true;
+    }
+
+    [[nodiscard]] bool magic_valid() const {
+        uint32_t magic =
+            __atomic_load_n(reinterpret_cast<const uint32_t*>(header_->magic),
+                            __ATOMIC_ACQUIRE);
+        return memcmp(&magic, SHM_TRACE_MAGIC, 4) == 0;
+    }
+
+    [[nodiscard]] ShmRing* ring(uint32_t slot) const {
+        return reinterpret_cast<ShmRing*>(static_cast<char*>(base_) +
+                                          SHM_RING_OFF + slot * SHM_RING_STRIDE);
+    }
+
+    // The file id was bound (release on ready) before any event carrying
+    // it became reachable, so the entry is complete by the time we look
+    void ensure_file(uint32_t file_id) {
+        if (file_id >= SHM_MAX_FILES) {
+            return;
+        }
+        if (file_id < files_.size() && !files_[file_id].empty()) {
+            return;
+        }
+        const auto* entries =
+            reinterpret_cast<const ShmFileEntry*>(static_cast<char*>(base_) +
+                                                  SHM_FILE_OFF);
+        if (!__atomic_load_n(&entries[file_id].ready, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+        if (file_id >= files_.size()) {
+            files_.resize(file_id + 1);
+        }
+        files_[file_id] = FileTable::instance().view(
+            std::string_view(entries[file_id].name,
+                             strnlen(entries[file_id].name, SHM_NAME_MAX)));
+    }
+
+    template <typename Callback>
+    uint64_t drain_ring(ShmRing* r, Callback& cb, bool& drained) {
+        uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        uint64_t count = 0;
+        while (tail != head) {
+            const ShmEventRecord& e = r->events[tail];
+            ensure_file(e.line >> 20);
+            // Same field layout as the binary 'E' records - reuse their
+            // flag decoding wholesale
+            BinaryEventRecord rec;
+            rec.address = e.address;
+            rec.src_address = e.src_address;
+            rec.size = e.size;
+            rec.line = e.line;
+            rec.thread_id = e.thread_id;
+            cb(decode_binary_event(rec, files_));
+            tail = (tail + 1) & (SHM_RING_EVENTS - 1);
+            count++;
+        }
+        if (count > 0) {
+            // Release so the producer's acquire sees the slots as free
+            __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+            drained = true;
+        }
+        return count;
+    }
+
+    void* base_ = nullptr;
+    ShmTraceHeader* header_ = nullptr;
+    std::vector<std::string_view> files_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// Struct key for source location lookup - avoids string allocation in hot
+// path. The file view must be interned (see FileTable) so it stays valid
+// for the lifetime of the map.
+struct SourceKey {
+  std::string_view file;
+  uint32_t line;
+
+  bool operator==(const SourceKey &other) const {
+    return line == other.line && file == other.file;
+  }
+};
+
+struct SourceKeyHash {
+  size_t operator()(const SourceKey &k) const {
+    size_t h = std::hash<std::string_view>{}(k.file);
+    h ^= std::hash<uint32_t>{}(k.line) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+  }
+};
+
+// Per-function aggregate rolled up from per-line stats at report time,
+// using the trace's G function-registration records (see TraceFuncMap).
+// Lines the trace never attributed to a function are left out.
+struct FunctionStats {
+  std::string_view function; // interned via FileTable
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint32_t lines = 0; // distinct source lines folded into this function
+  [[nodiscard]] uint64_t total() const { return hits + misses; }
+  [[nodiscard]] double miss_rate() const {
+    return total() ? (double)misses / total() : 0;
+  }
+};
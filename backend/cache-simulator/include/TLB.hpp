@@ -5,6 +5,8 @@
 #include <vector>
 #include <unordered_set>
 
+#include "Checkpoint.hpp"
+
 /**
  * TLB (Translation Lookaside Buffer) Simulator
  *
@@ -54,8 +56,26 @@ struct TLBStats {
         misses += other.misses;
         return *this;
     }
+
+    bool operator==(const TLBStats& other) const {
+        return hits == other.hits && misses == other.misses;
+    }
 };
 
+// Live counter slab for one core's TLB, mirroring AlignedCacheStats
+// (CacheStats.hpp): parallel epoch workers bump their own core's TLB
+// counters without synchronization, so the slab must own its cache lines
+struct alignas(64) AlignedTLBStats : TLBStats {
+    AlignedTLBStats() = default;
+    AlignedTLBStats(const TLBStats& s) : TLBStats(s) {}
+    AlignedTLBStats& operator=(const TLBStats& s) {
+        TLBStats::operator=(s);
+        return *this;
+    }
+};
+static_assert(sizeof(AlignedTLBStats) % 64 == 0,
+              "slab must cover whole cache lines");
+
 struct TLBEntry {
     uint64_t page_number = 0;   // Virtual page number
     bool valid = false;
@@ -66,7 +86,7 @@ class TLB {
 private:
     TLBConfig config;
     std::vector<std::vector<TLBEntry>> sets;  // sets[set_index][way]
-    TLBStats stats;
+    AlignedTLBStats stats;  // worker-updated; see AlignedTLBStats
     uint64_t access_counter = 0;
     std::unordered_set<uint64_t> seen_pages;  // Track unique pages for compulsory detection
 
@@ -99,6 +119,9 @@ public:
 
     [[nodiscard]] const TLBStats& get_stats() const { return stats; }
 
+    // Apply a memoized stats delta (segment caching fast-forward)
+    void add_stats(const TLBStats& delta) { stats += delta; }
+
     void reset_stats();
 
     [[nodiscard]] const TLBConfig& get_config() const { return config; }
@@ -107,6 +130,13 @@ public:
      * Get number of unique pages accessed (working set in pages)
      */
     [[nodiscard]] size_t get_unique_pages() const { return seen_pages.size(); }
+
+    /**
+     * Checkpointing: serialize/restore the entries, stats and seen-page
+     * set (see Checkpoint.hpp). load_state verifies the stored geometry.
+     */
+    void save_state(CheckpointWriter& w) const;
+    void load_state(CheckpointReader& r);
 };
 
 /**
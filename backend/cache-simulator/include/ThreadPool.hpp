@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool with a shared task queue
+//
+// Workers pull tasks off one queue, so uneven tasks balance naturally:
+// submitters cut work into more pieces than there are threads and the
+// queue does the scheduling. wait_idle() blocks until every submitted
+// task has finished, so the pool can be reused across phases.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t num_threads) {
+    if (num_threads == 0)
+      num_threads = 1;
+    workers.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++)
+      workers.emplace_back([this] { run(); });
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    task_ready.notify_all();
+    for (auto &w : workers)
+      w.join();
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    task_ready.notify_one();
+  }
+
+  // Block until the queue is drained and every worker is idle
+  void wait_idle() {
+    std::unique_lock lock(mutex);
+    all_done.wait(lock, [this] { return tasks.empty() && active == 0; });
+  }
+
+  [[nodiscard]] size_t size() const { return workers.size(); }
+
+private:
+  void run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex);
+        task_ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (stopping && tasks.empty())
+          return;
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        active++;
+      }
+      task();
+      {
+        std::lock_guard lock(mutex);
+        active--;
+        if (tasks.empty() && active == 0)
+          all_done.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable task_ready;
+  std::condition_variable all_done;
+  size_t active = 0;
+  bool stopping = false;
+};
@@ -2,19 +2,29 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <sstream>
 
+#include "CompressedCacheModel.hpp"
+#include "FileTable.hpp"
+#include "RegionMap.hpp"
+
 struct TraceEvent {
   // Basic event properties
   bool is_write = false;
   bool is_icache = false;  // true for instruction fetch events
   uint64_t address = 0;
   uint32_t size = 0;
-  std::string file;
+  std::string_view file;  // interned via FileTable - stable for the whole run
   uint32_t line = 0;
   uint32_t thread_id = 1;
 
+  // Capture-time cycle counter ("@<cycles>" suffix, runtime
+  // CACHE_EXPLORER_TIMESTAMPS=1). 0 = untimestamped trace. Batch mode
+  // merges timestamped events into capture order before simulation.
+  uint64_t timestamp = 0;
+
   // Software prefetch hints (__builtin_prefetch)
   bool is_prefetch = false;
   uint8_t prefetch_hint = 0;  // 0=T0 (all), 1=T1 (L2+), 2=T2 (L3), 3=NTA
@@ -22,6 +32,14 @@ struct TraceEvent {
   // Vector/SIMD operations (AVX, SSE)
   bool is_vector = false;
 
+  // Gather/scatter lanes (VL/VS): one record per active lane of a masked
+  // gather or scatter, each carrying that lane's own address - a single
+  // base address would collapse up to 16 discontiguous lines into one.
+  // lane/lanes keep the instruction grouping for op-level stats.
+  bool is_gather = false;
+  uint8_t lane = 0;
+  uint8_t lanes = 0;
+
   // Atomic operations (std::atomic, atomicrmw, cmpxchg)
   bool is_atomic = false;
   bool is_rmw = false;      // Read-modify-write (fetch_add, etc.)
@@ -32,6 +50,31 @@ struct TraceEvent {
   bool is_memset = false;
   bool is_memmove = false;
   uint64_t src_address = 0;  // Source address for memcpy/memmove
+
+  // Compressed range events (RL/RS): one record standing for `count`
+  // accesses of `size` bytes each, starting at `address` and `stride`
+  // bytes apart. Emitted by the pass for constant-stride loops with
+  // known trip counts; expanded back to scalar accesses in process().
+  bool is_range = false;
+  int64_t stride = 0;
+  uint64_t count = 0;
+
+  // Heap records (H/F) from the runtime's malloc interposition. An alloc
+  // carries the object's base/size and the allocation site in file:line
+  // form ("heap[0x...]":0); a free carries only the base address.
+  bool is_alloc = false;
+  bool is_free = false;
+
+  // Phase markers (B/E) from the runtime's region-of-interest API. The
+  // address field carries the phase id; neither record has a size.
+  bool is_phase_begin = false;
+  bool is_phase_end = false;
+
+  // Sample-rate records (W) from the runtime's sampler. The divisor rides
+  // in `count`; every event after this one stands for `count` captured
+  // accesses. Position in the stream matters, so unlike the registration
+  // records these do produce an event.
+  bool is_sample_rate = false;
 };
 
 struct EventResult {
@@ -40,10 +83,73 @@ struct EventResult {
   bool l3_hit;
   uint64_t address;
   uint32_t size;
-  std::string file;
+  std::string_view file;
   uint32_t line;
 };
 
+// Resolve a location's file part. An all-digit name ("12") is a numeric
+// file id bound by the trace's D registration records; anything else -
+// and any id the trace never registered - interns as a literal path.
+inline std::string_view resolve_trace_file(std::string_view name) {
+  if (!name.empty()) {
+    bool numeric = true;
+    uint32_t id = 0;
+    for (char c : name) {
+      if (c < '0' || c > '9') {
+        numeric = false;
+        break;
+      }
+      id = id * 10 + (c - '0');
+    }
+    if (numeric) {
+      std::string_view view = TraceFileIds::instance().view_of(id);
+      if (!view.empty())
+        return view;
+    }
+  }
+  return FileTable::instance().view(name);
+}
+
+// Consume the trailing tokens shared by every record form: the thread id
+// ("T<n>") and the optional capture timestamp ("@<cycles>")
+inline void parse_trace_tail(std::istringstream &iss, TraceEvent &event) {
+  std::string tok;
+  while (iss >> tok) {
+    if (tok.size() > 1 && tok[0] == 'T')
+      event.thread_id = std::stoul(tok.substr(1));
+    else if (tok.size() > 1 && tok[0] == '@')
+      event.timestamp = std::stoull(tok.substr(1));
+  }
+}
+
+// Parse the optional location token ("file:line", a bare file, or a
+// numeric file id), then the tail. Fileless records put the thread id or
+// timestamp where the location would sit, so a token opening with 'T' or
+// '@' is already the tail - same rule as the fast parser.
+inline void parse_trace_location_and_tail(std::istringstream &iss,
+                                          TraceEvent &event) {
+  std::string location;
+  if (iss >> location) {
+    if (location[0] == 'T' || location[0] == '@') {
+      if (location.size() > 1 && location[0] == 'T')
+        event.thread_id = std::stoul(location.substr(1));
+      else if (location.size() > 1)
+        event.timestamp = std::stoull(location.substr(1));
+    } else {
+      auto colon = location.find(':');
+      if (colon != std::string::npos) {
+        event.file =
+            resolve_trace_file(std::string_view(location).substr(0, colon));
+        event.line = std::stoul(location.substr(colon + 1));
+      } else {
+        event.file = FileTable::instance().view(location);
+        event.line = 0;
+      }
+    }
+  }
+  parse_trace_tail(iss, event);
+}
+
 inline std::optional<TraceEvent> parse_trace_event(const std::string &line) {
   if (line.empty() || line[0] == '#')
     return std::nullopt;
@@ -52,11 +158,73 @@ inline std::optional<TraceEvent> parse_trace_event(const std::string &line) {
   std::string type_str;
   uint64_t addr;
   uint32_t size;
-  std::string location;
-  std::string thread_str;
 
-  // First, read type and address
-  if (!(iss >> type_str >> std::hex >> addr))
+  if (!(iss >> type_str))
+    return std::nullopt;
+
+  // File-registration records bind a numeric id to a path and carry no
+  // event: D <id> <path>
+  if (type_str == "D") {
+    uint32_t id;
+    std::string path;
+    if (iss >> std::dec >> id >> path)
+      TraceFileIds::instance().register_id(id, path);
+    return std::nullopt;
+  }
+
+  // Function-registration records bind a source line to its enclosing
+  // pre-inlining function and carry no event: G <file>:<line> <func>
+  if (type_str == "G") {
+    std::string location, func;
+    if (iss >> location >> func) {
+      auto colon = location.rfind(':');
+      if (colon != std::string::npos) {
+        std::string_view file =
+            resolve_trace_file(std::string_view(location).substr(0, colon));
+        TraceFuncMap::instance().register_site(
+            file, std::stoul(location.substr(colon + 1)), func);
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Region records bind an address range to a memory-region kind and
+  // carry no event: K <kind> <lo> <hi>
+  if (type_str == "K") {
+    std::string kind;
+    uint64_t lo, hi;
+    if (iss >> kind >> std::hex >> lo >> hi) {
+      TraceRegionMap::instance().register_range(
+          kind == "stack" ? RegionKind::Stack : RegionKind::Global, lo, hi);
+    }
+    return std::nullopt;
+  }
+
+  // Compressibility hints carry a sampled BDI class for a line and no
+  // event: Y <addr> <class>
+  if (type_str == "Y") {
+    uint64_t hint_addr;
+    unsigned cls;
+    if (iss >> std::hex >> hint_addr >> std::dec >> cls) {
+      TraceCompressHints::instance().register_hint(hint_addr,
+                                                   static_cast<uint8_t>(cls));
+    }
+    return std::nullopt;
+  }
+
+  // Sample-rate records carry only the new divisor: W <divisor>
+  if (type_str == "W") {
+    uint64_t divisor;
+    if (!(iss >> std::dec >> divisor) || divisor == 0)
+      return std::nullopt;
+    TraceEvent event;
+    event.is_sample_rate = true;
+    event.count = divisor;
+    return event;
+  }
+
+  // Read the address
+  if (!(iss >> std::hex >> addr))
     return std::nullopt;
 
   TraceEvent event;
@@ -79,22 +247,53 @@ inline std::optional<TraceEvent> parse_trace_event(const std::string &line) {
       event.is_memmove = true;
     }
     event.is_write = true;
-    // Parse remaining location and thread
-    if (iss >> location) {
-      auto colon = location.find(':');
-      if (colon != std::string::npos) {
-        event.file = location.substr(0, colon);
-        event.line = std::stoul(location.substr(colon + 1));
-      } else {
-        event.file = location;
-        event.line = 0;
-      }
-    }
-    if (iss >> thread_str) {
-      if (!thread_str.empty() && thread_str[0] == 'T') {
-        event.thread_id = std::stoul(thread_str.substr(1));
-      }
-    }
+    parse_trace_location_and_tail(iss, event);
+    return event;
+  }
+
+  // Compressed range events
+  // Format: RL/RS <base> <stride> <count> <size> <location> <thread>
+  if (type == 'R' && type_str.length() > 1 &&
+      (type_str[1] == 'L' || type_str[1] == 'S')) {
+    int64_t stride;
+    uint64_t count;
+    if (!(iss >> std::dec >> stride >> count >> size))
+      return std::nullopt;
+    event.is_range = true;
+    event.stride = stride;
+    event.count = count;
+    event.size = size;
+    event.is_write = (type_str[1] == 'S');
+    parse_trace_location_and_tail(iss, event);
+    return event;
+  }
+
+  // Gather/scatter lane events
+  // Format: VL/VS <addr> <lane> <lanes> <size> <location> <thread>
+  if (type == 'V' && type_str.length() > 1 &&
+      (type_str[1] == 'L' || type_str[1] == 'S')) {
+    unsigned lane, lanes;
+    if (!(iss >> std::dec >> lane >> lanes >> size))
+      return std::nullopt;
+    event.is_gather = true;
+    event.lane = static_cast<uint8_t>(lane);
+    event.lanes = static_cast<uint8_t>(lanes);
+    event.size = size;
+    event.is_write = (type_str[1] == 'S');
+    parse_trace_location_and_tail(iss, event);
+    return event;
+  }
+
+  // Free records and phase markers carry no size or location
+  // Format: F <addr> <thread> / B <id> <thread> / E <id> <thread>
+  if (type == 'F' || type == 'B' || type == 'E') {
+    if (type == 'F')
+      event.is_free = true;
+    else if (type == 'B')
+      event.is_phase_begin = true;
+    else
+      event.is_phase_end = true;
+    parse_trace_tail(iss, event);
     return event;
   }
 
@@ -163,28 +362,17 @@ inline std::optional<TraceEvent> parse_trace_event(const std::string &line) {
       event.is_write = true;
       break;
 
+    case 'H':
+      // Heap allocation record
+      event.is_alloc = true;
+      break;
+
     default:
       return std::nullopt;
   }
 
-  // Parse location (file:line)
-  if (iss >> location) {
-    auto colon = location.find(':');
-    if (colon != std::string::npos) {
-      event.file = location.substr(0, colon);
-      event.line = std::stoul(location.substr(colon + 1));
-    } else {
-      event.file = location;
-      event.line = 0;
-    }
-  }
-
-  // Parse thread ID (format: T<number>)
-  if (iss >> thread_str) {
-    if (!thread_str.empty() && thread_str[0] == 'T') {
-      event.thread_id = std::stoul(thread_str.substr(1));
-    }
-  }
+  // Parse location (file:line), thread ID, and optional timestamp
+  parse_trace_location_and_tail(iss, event);
 
   return event;
 }
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "TraceEvent.hpp"
+
+// Simulator-side trace narrowing (--filter-file / --filter-addr /
+// --filter-heap). Selective instrumentation trims scope at capture time,
+// but once a full trace exists re-capturing just to ask "what does the
+// hash-table traffic alone look like?" is wasteful - excluded events
+// should cost a predicate check here, not a re-run and not a simulation.
+//
+// The filter is applied at parse time, before events reach a processor.
+// Side-band records (heap alloc/free, phase markers) always pass: the
+// processors need them for their own bookkeeping, and the heap-object
+// filter needs the alloc/free stream to know which addresses belong to
+// which allocation site. That makes admit() stateful and order-dependent,
+// so it must see events in trace order on a single thread.
+
+// Shell-style glob match: '*' matches any run of characters, '?' matches
+// exactly one. Iterative with single-star backtracking - no recursion,
+// linear in practice on path-like inputs.
+inline bool glob_match(std::string_view pattern, std::string_view text) {
+  size_t p = 0, t = 0;
+  size_t star = std::string_view::npos, mark = 0;
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      p++;
+      t++;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      mark = t;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      t = ++mark;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    p++;
+  return p == pattern.size();
+}
+
+class TraceFilter {
+public:
+  void set_file_glob(std::string glob) { file_glob = std::move(glob); }
+
+  // Half-open byte range [lo, hi)
+  void set_addr_range(uint64_t lo, uint64_t hi) {
+    addr_lo = lo;
+    addr_hi = hi;
+    addr_set = true;
+  }
+
+  // Keep (or with exclude=true, drop) only accesses landing inside live
+  // allocations whose allocation site matches the glob. Sites match on
+  // the file alone or on "file:line", so "alloc.c", "*.c:42" and the
+  // runtime's unresolved "heap[0x*]" pseudo-files all work.
+  void set_heap_glob(std::string glob, bool exclude) {
+    heap_glob = std::move(glob);
+    heap_exclude = exclude;
+  }
+
+  [[nodiscard]] bool active() const {
+    return !file_glob.empty() || addr_set || !heap_glob.empty();
+  }
+
+  [[nodiscard]] uint64_t excluded() const { return excluded_count; }
+
+  // Stateful: alloc/free records update the live-range map as a side
+  // effect. Call in trace order.
+  [[nodiscard]] bool admit(const TraceEvent &event) {
+    if (event.is_alloc || event.is_free) {
+      if (!heap_glob.empty())
+        track_heap(event);
+      return true; // side-band: processors do their own heap accounting
+    }
+    if (event.is_phase_begin || event.is_phase_end || event.is_sample_rate)
+      return true;
+
+    if (!file_glob.empty() && !glob_match(file_glob, event.file)) {
+      excluded_count++;
+      return false;
+    }
+
+    // Range events stand for a whole strided span; test the span, not
+    // just the base, so a window in the middle of the loop still matches
+    uint64_t lo = event.address;
+    uint64_t hi = event.address + event.size;
+    if (event.is_range && event.count > 1) {
+      int64_t extent = event.stride * static_cast<int64_t>(event.count - 1);
+      if (extent < 0)
+        lo += extent;
+      else
+        hi += extent;
+    }
+    if (addr_set && (hi <= addr_lo || lo >= addr_hi)) {
+      excluded_count++;
+      return false;
+    }
+
+    if (!heap_glob.empty()) {
+      bool in_matched = in_matched_alloc(event.address);
+      if (in_matched == heap_exclude) {
+        excluded_count++;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // In-place compaction for batch containers (pipeline batches, the
+  // parallel parser's output). Preserves trace order.
+  template <typename Vec> void compact(Vec &events) {
+    size_t kept = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+      if (admit(events[i])) {
+        if (kept != i)
+          events[kept] = std::move(events[i]);
+        kept++;
+      }
+    }
+    events.resize(kept);
+  }
+
+private:
+  void track_heap(const TraceEvent &event) {
+    if (event.is_free) {
+      matched_allocs.erase(event.address);
+      return;
+    }
+    bool matched = glob_match(heap_glob, event.file);
+    if (!matched && event.line != 0) {
+      std::string site(event.file);
+      site += ':';
+      site += std::to_string(event.line);
+      matched = glob_match(heap_glob, site);
+    }
+    if (matched)
+      matched_allocs[event.address] = event.address + event.size;
+  }
+
+  // Same containment probe as TraceProcessor::attribute_heap_access:
+  // last matching allocation starting at or before the address
+  [[nodiscard]] bool in_matched_alloc(uint64_t addr) const {
+    auto it = matched_allocs.upper_bound(addr);
+    if (it == matched_allocs.begin())
+      return false;
+    --it;
+    return addr < it->second;
+  }
+
+  std::string file_glob;
+  std::string heap_glob;
+  bool heap_exclude = false;
+  bool addr_set = false;
+  uint64_t addr_lo = 0;
+  uint64_t addr_hi = 0;
+  uint64_t excluded_count = 0;
+  std::map<uint64_t, uint64_t> matched_allocs; // base -> end, matching sites only
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "Checkpoint.hpp"
+#include "FastIO.hpp"
+
+// Sidecar index for random-access trace replay (trace-tool index /
+// --replay-range).
+//
+// Zooming in on event #1.8 billion of a 40GB trace used to mean parsing
+// the whole file just to throw most of it away. The sidecar records a
+// byte offset every `interval` events, so a replay seeks to the mark at
+// or before its window, parses only the bytes it needs, and - combined
+// with a --checkpoint-keep snapshot series from the original run -
+// restores warm state instead of re-simulating the prefix.
+//
+// Registration records (D/G/K/Y) bind ids and metadata the events after
+// them depend on, but a seek jumps straight past them. The index
+// therefore also records every registration line's byte offset; a replay
+// feeds the ones before its seek point back through the parser first.
+//
+// Layout: 4-byte magic "CXTI" + uint32 version, then interval, total
+// event count, the mark list and the registration offsets. Host-format
+// values like the CXTB and CXCP files: the sidecar indexes one concrete
+// trace file on the machine that wrote it.
+
+constexpr char TRACE_INDEX_MAGIC[4] = {'C', 'X', 'T', 'I'};
+constexpr uint32_t TRACE_INDEX_VERSION = 1;
+
+struct TraceIndexMark {
+  uint64_t event_index = 0;  // Index of the first event at/after the mark
+  uint64_t byte_offset = 0;  // Byte offset of that event's record
+};
+
+struct TraceIndex {
+  uint64_t interval = 0;      // Events between marks
+  uint64_t total_events = 0;  // Event records in the indexed trace
+  std::vector<TraceIndexMark> marks;
+  // Byte offsets of registration records (D/G/K/Y), in file order
+  std::vector<uint64_t> registrations;
+
+  // Newest mark at or before `event`; marks start at event 0, so any
+  // non-empty index resolves every in-range request
+  [[nodiscard]] const TraceIndexMark *mark_at_or_before(uint64_t event) const {
+    const TraceIndexMark *best = nullptr;
+    for (const auto &mark : marks) {
+      if (mark.event_index > event)
+        break;
+      best = &mark;
+    }
+    return best;
+  }
+
+  [[nodiscard]] bool save(std::ostream &out) const {
+    out.write(TRACE_INDEX_MAGIC, 4);
+    CheckpointWriter w(out);
+    w.write<uint32_t>(TRACE_INDEX_VERSION);
+    w.write<uint64_t>(interval);
+    w.write<uint64_t>(total_events);
+    w.write_vec(marks);
+    w.write_vec(registrations);
+    return w.ok();
+  }
+
+  // Throws std::runtime_error on a truncated or foreign file, same
+  // contract as checkpoint restore
+  static TraceIndex load(std::istream &in) {
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || std::memcmp(magic, TRACE_INDEX_MAGIC, 4) != 0)
+      throw std::runtime_error("not a trace index file");
+    CheckpointReader r(in);
+    r.expect<uint32_t>(TRACE_INDEX_VERSION, "trace index version");
+    TraceIndex index;
+    index.interval = r.read<uint64_t>();
+    index.total_events = r.read<uint64_t>();
+    r.read_vec(index.marks);
+    r.read_vec(index.registrations);
+    return index;
+  }
+};
+
+// Walk lines starting at `offset`, stopping when the callback returns
+// false - the early exit for_each_line doesn't offer, so a window replay
+// never touches the bytes past its end
+template <typename Callback>
+inline void for_each_line_from(const char *data, size_t size, size_t offset,
+                               Callback &&cb) {
+  const char *pos = data + offset;
+  const char *end = data + size;
+  while (pos < end) {
+    const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    const char *line_end = nl ? nl : end;
+    if (!cb(pos, line_end))
+      return;
+    pos = line_end + 1;
+  }
+}
+
+// One pass over a text trace: a mark every `interval` event records
+// (range records count once, same as trace-tool cut and the simulator's
+// checkpoint offsets), plus every registration record's position
+[[nodiscard]] inline TraceIndex build_trace_index(const char *data,
+                                                  size_t size,
+                                                  uint64_t interval) {
+  TraceIndex index;
+  index.interval = interval ? interval : 1;
+  uint64_t count = 0;
+  uint64_t next_mark = 0;
+  for_each_line(data, size, [&](const char *begin, const char *end) {
+    if (begin == end || *begin == '#')
+      return;
+    uint64_t offset = static_cast<uint64_t>(begin - data);
+    if (parse_trace_event_fast(begin, end)) {
+      if (count == next_mark) {
+        index.marks.push_back({count, offset});
+        next_mark += index.interval;
+      }
+      count++;
+    } else if (*begin == 'D' || *begin == 'G' || *begin == 'K' ||
+               *begin == 'Y') {
+      index.registrations.push_back(offset);
+    }
+  });
+  index.total_events = count;
+  return index;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FastIO.hpp"
+#include "TraceEvent.hpp"
+
+// Overlapped parse->simulate pipeline for batch mode
+//
+// Batch mode normally reads everything, then parses, then simulates - three
+// serialized phases. TracePipeline runs read+parse on a producer thread that
+// fills event batches and hands them to the simulation thread through a
+// bounded queue, so I/O and parsing hide behind simulation time.
+//
+// Chunks are cut at the last newline and the partial tail line is carried
+// into the next chunk, so events never straddle a batch boundary.
+//
+// Memory is constant no matter how long the trace runs: one fixed read
+// chunk, a bounded queue, and a pool of batch vectors the consumer hands
+// back through recycle() for the producer to refill - steady state does
+// no allocation at all, so multi-hour piped runs never grow.
+class TracePipeline {
+public:
+  static constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024; // 4MB read chunks
+  static constexpr size_t MAX_QUEUED_BATCHES = 4;       // Bounded queue depth
+
+  ~TracePipeline() { stop(); }
+
+  // Start the producer thread reading from a file, or stdin if path is empty
+  bool start(const std::string &path = "") {
+    if (!path.empty()) {
+      input = fopen(path.c_str(), "rb");
+      if (!input)
+        return false;
+      owns_input = true;
+    } else {
+      input = stdin;
+    }
+    producer = std::thread([this] { produce(); });
+    return true;
+  }
+
+  // Pop the next parsed batch; returns nullopt when the trace is exhausted
+  std::optional<std::vector<TraceEvent>> next_batch() {
+    std::unique_lock lock(mutex);
+    not_empty.wait(lock, [this] { return !queue.empty() || done; });
+    if (queue.empty())
+      return std::nullopt;
+
+    std::vector<TraceEvent> batch = std::move(queue.front());
+    queue.erase(queue.begin());
+    not_full.notify_one();
+    return batch;
+  }
+
+  // Hand a consumed batch back so the producer reuses its capacity
+  // instead of allocating a fresh vector per chunk
+  void recycle(std::vector<TraceEvent> &&batch) {
+    batch.clear();
+    std::lock_guard lock(mutex);
+    if (free_list.size() <= MAX_QUEUED_BATCHES)
+      free_list.push_back(std::move(batch));
+  }
+
+  void stop() {
+    if (producer.joinable()) {
+      {
+        std::lock_guard lock(mutex);
+        cancelled = true;
+        not_full.notify_all();
+      }
+      producer.join();
+    }
+    if (owns_input && input) {
+      fclose(input);
+      input = nullptr;
+      owns_input = false;
+    }
+  }
+
+private:
+  void produce() {
+    std::vector<char> chunk(CHUNK_SIZE);
+    std::string carry; // Partial line from the previous chunk
+    std::vector<TraceEvent> batch;
+
+    size_t n;
+    while ((n = fread(chunk.data(), 1, CHUNK_SIZE, input)) > 0) {
+      const char *data = chunk.data();
+      size_t size = n;
+
+      // Find the last complete line; everything after it carries over
+      size_t last_newline = size;
+      while (last_newline > 0 && data[last_newline - 1] != '\n')
+        last_newline--;
+
+      if (last_newline == 0) {
+        // No newline in this whole chunk - accumulate and keep reading
+        carry.append(data, size);
+        continue;
+      }
+
+      if (!carry.empty()) {
+        carry.append(data, last_newline);
+        parse_into(carry.data(), carry.size(), batch);
+        carry.clear();
+      } else {
+        parse_into(data, last_newline, batch);
+      }
+      carry.assign(data + last_newline, size - last_newline);
+
+      if (!push_batch(std::move(batch)))
+        return; // Consumer cancelled
+      batch = take_free();
+    }
+
+    // Flush any final unterminated line
+    if (!carry.empty()) {
+      parse_into(carry.data(), carry.size(), batch);
+    }
+    if (!batch.empty()) {
+      push_batch(std::move(batch));
+    }
+
+    std::lock_guard lock(mutex);
+    done = true;
+    not_empty.notify_all();
+  }
+
+  static void parse_into(const char *data, size_t size,
+                         std::vector<TraceEvent> &batch) {
+    for_each_line(data, size, [&](const char *begin, const char *end) {
+      auto event = parse_trace_event_fast(begin, end);
+      if (event) {
+        batch.push_back(std::move(*event));
+      }
+    });
+  }
+
+  // Pop a recycled batch vector, or an empty one if none are waiting
+  std::vector<TraceEvent> take_free() {
+    std::lock_guard lock(mutex);
+    if (free_list.empty())
+      return {};
+    std::vector<TraceEvent> batch = std::move(free_list.back());
+    free_list.pop_back();
+    return batch;
+  }
+
+  // Returns false if the consumer cancelled the pipeline
+  bool push_batch(std::vector<TraceEvent> &&batch) {
+    std::unique_lock lock(mutex);
+    not_full.wait(lock, [this] {
+      return queue.size() < MAX_QUEUED_BATCHES || cancelled;
+    });
+    if (cancelled)
+      return false;
+    queue.push_back(std::move(batch));
+    not_empty.notify_one();
+    return true;
+  }
+
+  FILE *input = nullptr;
+  bool owns_input = false;
+  std::thread producer;
+
+  std::mutex mutex;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+  std::vector<std::vector<TraceEvent>> queue;
+  std::vector<std::vector<TraceEvent>> free_list; // recycled batch vectors
+  bool done = false;
+  bool cancelled = false;
+};
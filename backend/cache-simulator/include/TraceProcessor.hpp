@@ -1,91 +1,434 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <array>
+
 #include "AdvancedStats.hpp"
 #include "CacheSystem.hpp"
+#include "FlatMap.hpp"
 #include "MemoryAccess.hpp"
+#include "RegionMap.hpp"
+#include "RemapAnalysis.hpp"
+#include "SegmentCache.hpp"
+#include "SourceKey.hpp"
 #include "TraceEvent.hpp"
+#include "TraceSampling.hpp"
+#include "WorkingSetEstimator.hpp"
 
-// Struct key for source location lookup - avoids string allocation in hot path
-struct SourceKey {
-  std::string_view file;
+struct SourceStats {
+  std::string_view file; // interned via FileTable - stable for the whole run
   uint32_t line;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  // Cache-line utilization: bytes actually touched between a line's fill
+  // and its refetch, attributed to the source line whose miss filled it.
+  // Low utilization is the clearest signal of a bandwidth-wasting layout
+  // - most of every fetched line goes unused.
+  uint64_t lines_fetched = 0;
+  uint64_t line_bytes_used = 0;
+  [[nodiscard]] uint64_t total() const { return hits + misses; }
+  [[nodiscard]] double miss_rate() const { return total() ? (double)misses / total() : 0; }
+  [[nodiscard]] double line_utilization(uint32_t line_size) const {
+    // Residency masks fold lines wider than 64 bytes (see LineUse)
+    uint64_t fetched = lines_fetched * std::min<uint64_t>(line_size, 64);
+    return fetched ? (double)line_bytes_used / fetched : 0;
+  }
+};
 
-  bool operator==(const SourceKey &other) const {
-    return line == other.line && file == other.file;
+// Per-allocation-site aggregate built from the runtime's H/F heap records
+// (CACHE_EXPLORER_TRACK_HEAP=1). `file` is the site's pseudo-filename
+// ("heap[0x...]") unless debug info resolved it to a real location.
+struct HeapSiteStats {
+  std::string_view file; // interned via FileTable - stable for the whole run
+  uint32_t line = 0;
+  uint64_t alloc_count = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t live_bytes = 0;       // currently live (allocs minus frees)
+  uint64_t peak_live_bytes = 0;
+  uint64_t accesses = 0;         // line accesses landing in this site's objects
+  uint64_t l1_misses = 0;
+  uint64_t memory_accesses = 0;  // accesses that went all the way to DRAM
+  // Union of byte positions touched within the cache lines of this site's
+  // objects (bit i = byte i of a line was accessed; lines wider than 64
+  // bytes are folded). A sparse mask means each fetched line carried
+  // mostly unused bytes - the layout advisor's partial-struct signal.
+  uint64_t touched_mask = 0;
+  [[nodiscard]] uint32_t line_bytes_touched() const {
+    return static_cast<uint32_t>(__builtin_popcountll(touched_mask));
   }
 };
 
-struct SourceKeyHash {
-  size_t operator()(const SourceKey &k) const {
-    size_t h = std::hash<std::string_view>{}(k.file);
-    h ^= std::hash<uint32_t>{}(k.line) + 0x9e3779b9 + (h << 6) + (h >> 2);
-    return h;
+// Per-region-kind bucket (see RegionMap.hpp): how much of the data
+// traffic - and more importantly, of the misses - lands on the stack,
+// in globals, or on the heap
+struct RegionStats {
+  uint64_t accesses = 0;
+  uint64_t l1_misses = 0;
+  uint64_t memory_accesses = 0; // went all the way to DRAM
+  [[nodiscard]] double miss_rate() const {
+    return accesses ? (double)l1_misses / accesses : 0;
   }
 };
 
-struct SourceStats {
-  std::string file;
-  uint32_t line;
-  uint64_t hits = 0;
-  uint64_t misses = 0;
-  [[nodiscard]] uint64_t total() const { return hits + misses; }
-  [[nodiscard]] double miss_rate() const { return total() ? (double)misses / total() : 0; }
+// Stats delta over one marked region (B/E phase markers from the
+// runtime's region-of-interest API)
+struct PhaseStats {
+  uint32_t id = 0;
+  CacheStats l1d, l2, l3;  // per-level deltas across the region
+  uint64_t cycles = 0;
+  [[nodiscard]] uint64_t accesses() const { return l1d.total_accesses(); }
 };
 
 class TraceProcessor {
 private:
   CacheSystem cache;
-  std::unordered_map<SourceKey, SourceStats, SourceKeyHash> source_stats;
+  // Flat open-addressing table: bumped once per event, so the lookup
+  // should cost one cache line, not a node pointer chase
+  FlatMap<SourceKey, SourceStats, SourceKeyHash> source_stats;
+
+  // Per-result hook invoked from the hot path: a raw function pointer
+  // plus context, so delivering a result is one indirect jump the
+  // branch predictor learns - no std::function dispatch per event
+  void (*event_hook)(void *, const EventResult &) = nullptr;
+  void *event_hook_ctx = nullptr;
+
+  // Type-erased storage backing set_event_callback (boundary adapter);
+  // the hot path never touches it directly, only through event_hook
   std::function<void(const EventResult &)> event_callback;
 
+  // Batched callback state (see set_batch_callback)
+  std::function<void(const EventResult *, size_t)> batch_callback;
+  std::vector<EventResult> result_buffer;
+  size_t result_batch_size = DEFAULT_RESULT_BATCH;
+
+  // Deliver any buffered results to the batch callback
+  void flush_results();
+
   // Advanced instrumentation statistics
   SoftwarePrefetchStats sw_prefetch_stats;
   VectorStats vector_stats;
+  GatherScatterStats gather_stats;
   AtomicStats atomic_stats;
   MemoryIntrinsicStats mem_intrinsic_stats;
 
+  // Lines touched so far by the in-progress gather/scatter op, per
+  // thread: an op's lane records are adjacent within its thread, but
+  // threads can interleave in the trace
+  std::unordered_map<uint32_t, std::vector<uint64_t>> gather_lines_in_flight;
+
   // Track prefetched addresses to measure usefulness
   std::unordered_set<uint64_t> prefetched_addresses;
 
-  // Helper to process a single cache line access
+  // Working-set sketch for the current interval window (--interval)
+  WorkingSetEstimator wss;
+
+  // Running aggregate of the trace's W sample-rate records (see
+  // TraceSampling.hpp); idle on unsampled traces
+  TraceSampling sampling;
+
+  // Conflict-miss what-if shadows (--remap, see RemapAnalysis.hpp)
+  std::unique_ptr<RemapAnalysis> remap;
+
+  // Segment caching (optional): memoize repeated access-pattern windows
+  std::unique_ptr<SegmentCache> segment_cache;
+  std::vector<TraceEvent> segment_buffer;
+  size_t segment_length = 64;
+  uint64_t segment_hash = SegmentCache::HASH_SEED;
+
+  // Heap object attribution (see HeapSiteStats): live allocations keyed by
+  // base address, each pointing at its site's aggregate. The ordered map
+  // makes "which allocation contains this address" an upper_bound away.
+  // Fast-forwarded segment windows skip attribution - their accesses were
+  // never re-simulated, so there is no per-access result to attribute.
+  struct LiveAlloc {
+    uint64_t size;
+    uint32_t site; // index into heap_sites
+  };
+  std::map<uint64_t, LiveAlloc> live_allocs;
+  std::vector<HeapSiteStats> heap_sites;
+  FlatMap<SourceKey, uint32_t, SourceKeyHash> heap_site_index;
+
+  void process_heap_event(const TraceEvent &event);
+  void attribute_heap_access(uint64_t line_addr, const SystemAccessResult &result);
+  // Fold the event's byte span into its owning site's touched_mask
+  void record_heap_density(uint64_t addr, uint32_t size);
+
+  // Stack/global/heap/other classification (see RegionMap.hpp). The
+  // stack and global ranges come from the trace's K records, held in a
+  // version-checked local snapshot so the per-event cost is a handful of
+  // range compares, no lock; the heap is the envelope of every H-record
+  // allocation - coarse, but growing it is O(1) per alloc where the
+  // precise live-allocation lookup is O(log live).
+  std::array<RegionStats, REGION_KIND_COUNT> region_stats{};
+  std::vector<TraceRegionMap::Range> region_ranges;
+  uint64_t region_version = 0;
+  uint64_t heap_env_lo = UINT64_MAX;
+  uint64_t heap_env_hi = 0;
+
+  void record_region_access(uint64_t line_addr, const SystemAccessResult &result);
+
+  // Cache-line utilization state (see SourceStats): per L1-resident data
+  // line, the bytes touched since its last fill and the site whose miss
+  // filled it. A refetch closes the residency into the filler's
+  // aggregate; lines still resident are folded in at report time.
+  struct LineUse {
+    uint64_t mask; // bit i = byte i of the line touched (folded to 64)
+    SourceKey filler;
+  };
+  std::unordered_map<uint64_t, LineUse> line_use;
+
+  void close_line_residency(const LineUse &use);
+
+  // Marked regions: snapshot on begin, delta on end. One region open at
+  // a time - a begin while another is open finalizes the previous one.
+  std::vector<PhaseStats> phases;
+  bool phase_open = false;
+  uint32_t open_phase_id = 0;
+  HierarchyStats phase_before;
+
+  void process_phase_marker(const TraceEvent &event);
+  [[nodiscard]] PhaseStats capture_phase_delta() const;
+
+  // Warmup fast-forward state (see begin_warmup)
+  bool warming = false;
+  bool warmup_3c_restore = true;
+
+  // Stripped-down warming path: touch cache/TLB/prefetcher contents only
+  void warm_event(const TraceEvent &event);
+
+  // 1-in-n set-sampling factor (see set_set_sampling); 1 = simulate all
+  uint32_t set_sample_factor = 1;
+
+  // Bulk-intrinsic fast path (see CacheSystem::bulk_sweep); the counter
+  // records how many ranges took it, for verification and debugging
+  bool bulk_intrinsics = true;
+  uint64_t bulk_sweeps = 0;
+
+  // Sweep one memset/memcpy range through the bulk fast path. Returns
+  // false when a per-line feature is live or the hierarchy declines;
+  // the caller then simulates the range line by line as before.
+  bool bulk_intrinsic_sweep(uint64_t base, uint64_t size, bool is_write,
+                            const TraceEvent &event);
+
+  // Helper to process a single cache line access. access_addr is the
+  // event's byte address - with event_size it bounds the span this line
+  // access touches, for the utilization mask.
   void process_line_access(uint64_t line_addr, bool is_write, bool is_icache,
                            std::string_view file, uint32_t line,
-                           uint32_t event_size);
+                           uint32_t event_size, uint64_t access_addr);
+
+  // Simulate one event through the hierarchy (bypasses segment buffering)
+  void simulate_event(const TraceEvent &event);
+
+  // Simulate or fast-forward a completed segment window
+  void complete_segment();
+  [[nodiscard]] SegmentDelta capture_segment_delta(const HierarchyStats &before,
+                                                   const TLBHierarchyStats &tlb_before,
+                                                   const std::vector<SegmentSourceDelta> &sources_before) const;
 
 public:
   explicit TraceProcessor(const CacheHierarchyConfig &cfg);
 
+  // Per-result delivery primitive: a static hook (function pointer plus
+  // context) the hot path calls directly. Pass nullptr to uninstall.
+  using EventHook = void (*)(void *, const EventResult &);
+  void set_event_hook(EventHook hook, void *ctx) {
+    event_hook = hook;
+    event_hook_ctx = ctx;
+  }
+
+  // Compile-time visitor: installs a trampoline making a direct call into
+  // the visitor's body, which the compiler can inline - preferred over
+  // set_event_callback for internal callers. The visitor must outlive the
+  // processing it observes.
+  template <typename Visitor> void set_event_visitor(Visitor &visitor) {
+    set_event_hook(
+        [](void *ctx, const EventResult &r) {
+          (*static_cast<Visitor *>(ctx))(r);
+        },
+        &visitor);
+  }
+
+  // Process a run of events with a visitor observing every result; the
+  // previously installed hook (if any) is restored afterwards
+  template <typename Visitor>
+  void process_batch(const TraceEvent *events, size_t count,
+                     Visitor &&visitor) {
+    EventHook saved_hook = event_hook;
+    void *saved_ctx = event_hook_ctx;
+    set_event_visitor(visitor);
+    process_batch(events, count);
+    event_hook = saved_hook;
+    event_hook_ctx = saved_ctx;
+  }
+
+  // Thin type-erased adapter for the library boundary (embedders handing
+  // us an opaque callable); pays std::function dispatch per event
   void set_event_callback(std::function<void(const EventResult &)> cb);
 
+  // Batched result delivery: results are buffered and handed to the
+  // callback in chunks of batch_size, amortizing the type-erased call
+  // that set_event_callback pays per event. Buffered EventResults hold
+  // interned file views, so they stay valid across the deferred delivery.
+  using BatchCallback = std::function<void(const EventResult *, size_t)>;
+  static constexpr size_t DEFAULT_RESULT_BATCH = 256;
+  void set_batch_callback(BatchCallback cb,
+                          size_t batch_size = DEFAULT_RESULT_BATCH);
+
   void enable_prefetching(PrefetchPolicy policy, int degree = 2);
   void disable_prefetching();
+  // Adapt the prefetch degree at runtime from accuracy feedback
+  void enable_prefetch_throttling() { cache.enable_prefetch_throttling(); }
+  // Size the Jouppi L1 victim buffer (0 disables it)
+  void enable_victim_cache(size_t entries) { cache.enable_victim_cache(entries); }
+
+  // Run the compressed-L3 what-if shadow beside the real L3
+  void enable_l3_compression(const CompressionConfig &comp) {
+    cache.enable_l3_compression(comp);
+  }
+
+  // Run the conflict-miss remap shadows beside the real L1D (--remap).
+  // Fast-forwarded segment windows skip the shadows - their accesses are
+  // never replayed - so combine with --cache-segments at your own risk.
+  void enable_remap_analysis() {
+    remap = std::make_unique<RemapAnalysis>(cache.get_l1d().get_config());
+  }
+  [[nodiscard]] bool has_remap_analysis() const { return remap != nullptr; }
+  [[nodiscard]] const RemapAnalysis &get_remap_analysis() const { return *remap; }
+
+  // Bulk-intrinsic fast path for large memset/memcpy ranges (on by
+  // default; --no-bulk-sweep forces per-line simulation)
+  void set_bulk_intrinsics(bool enable) { bulk_intrinsics = enable; }
+  [[nodiscard]] uint64_t get_bulk_sweeps() const { return bulk_sweeps; }
   [[nodiscard]] bool is_prefetching_enabled() const;
   [[nodiscard]] PrefetchPolicy get_prefetch_policy() const;
   [[nodiscard]] const PrefetchStats &get_prefetch_stats() const;
 
+  // Working-set size of the current interval window: estimated distinct
+  // lines touched since the last close_wss_window(). The interval loop
+  // reads the estimate at each boundary and resets the window.
+  [[nodiscard]] uint64_t wss_estimate() const { return wss.estimate(); }
+  void close_wss_window() { wss.reset(); }
+
+  // Sampling weights from the trace's W records: how many captured
+  // accesses each simulated one stood for (inactive on unsampled traces)
+  [[nodiscard]] const TraceSampling &get_sampling() const { return sampling; }
+
+  // Warmup fast-forward (--warmup): between begin_warmup() and
+  // finish_warmup(), events update cache, TLB and prefetcher contents
+  // through a stripped-down path - no source attribution, advanced
+  // stats, callbacks or 3C classification. finish_warmup() then wipes
+  // the accumulated counters, so the measured stats start from a warmed
+  // hierarchy instead of charging the cold-start transient to the run.
+  void begin_warmup();
+  void finish_warmup();
+  [[nodiscard]] bool is_warming() const { return warming; }
+
   void process(const TraceEvent &event);
 
+  // Process a run of events in one call so the per-event call overhead
+  // amortizes; flushes any pending batched results at the end. The
+  // pointer+length pair is the primitive, the vector overload is sugar.
+  void process_batch(const TraceEvent *events, size_t count);
+  void process_batch(const std::vector<TraceEvent> &events) {
+    process_batch(events.data(), events.size());
+  }
+
   [[nodiscard]] HierarchyStats get_stats() const;
 
   [[nodiscard]] std::vector<SourceStats> get_hot_lines(size_t limit = 10) const;
 
+  // Per-function rollup of the per-line stats via the trace's G records
+  // (empty when the trace carries no function registrations)
+  [[nodiscard]] std::vector<FunctionStats> get_hot_functions(size_t limit = 10) const;
+
+  // Per-object report from the malloc interposition's H/F records, sorted
+  // by memory accesses (the expensive ones) descending
+  [[nodiscard]] std::vector<HeapSiteStats> get_heap_objects(size_t limit = 10) const;
+  [[nodiscard]] bool has_heap_records() const { return !heap_sites.empty(); }
+
+  // Per-region-kind breakdown of the data traffic, indexed by RegionKind.
+  // Populated only when the trace carried K region records.
+  [[nodiscard]] const std::array<RegionStats, REGION_KIND_COUNT> &
+  get_region_stats() const {
+    return region_stats;
+  }
+  [[nodiscard]] bool has_region_records() const {
+    return region_version != 0 || !region_ranges.empty();
+  }
+
+  // Per-region stats from B/E phase markers, in trace order. A region
+  // still open at end of trace is reported up to the last processed event.
+  [[nodiscard]] std::vector<PhaseStats> get_phase_stats() const;
+  [[nodiscard]] bool has_phase_records() const { return !phases.empty() || phase_open; }
+
+  // Checkpointing (--checkpoint-every / --restore): snapshot the cache
+  // hierarchy's warm state plus the event offset it was taken at, so a
+  // killed batch run can resume instead of restarting from zero. The
+  // snapshot covers the microarchitectural state and accumulated
+  // hardware counters; source-level aggregates (hot lines, heap sites,
+  // phases) are not included - after a restore they cover only the
+  // resumed portion of the trace. Throws std::runtime_error on a
+  // truncated file or a configuration mismatch.
+  void save_checkpoint(std::ostream &out, uint64_t events_processed) const;
+  [[nodiscard]] uint64_t load_checkpoint(std::istream &in);
+
   void reset();
 
+  // Full reset back to the freshly-constructed state, including cache
+  // contents and per-job configuration - lets a daemon reuse the
+  // processor's allocations across jobs
+  void clear();
+
   // Access to cache system for visualization
   [[nodiscard]] const CacheSystem &get_cache_system() const;
 
   // Performance: enable fast mode (disables 3C miss classification)
   void set_fast_mode(bool enable) { cache.set_fast_mode(enable); }
+  // Set sampling (--sample-sets): simulate only lines whose index falls
+  // in a deterministic 1-in-n subset - with a power-of-two n those lines
+  // map onto an exact subset of sets at every level. The caller
+  // extrapolates the stats (HierarchyStats::scale).
+  void set_set_sampling(uint32_t factor) {
+    set_sample_factor = factor ? factor : 1;
+  }
+  // Route page-walk PTE fetches through the cache hierarchy
+  void set_walk_injection(bool enable) { cache.set_walk_injection(enable); }
+  // Simulate huge-page-backed mappings (2MB or 1GB)
+  void set_page_size(size_t page_size) { cache.set_page_size(page_size); }
+  // Virtual->physical page allocation for the physically-indexed levels
+  // (--page-alloc; see PageAllocator.hpp). Must follow set_page_size.
+  void set_page_allocation(PageAllocPolicy policy, uint64_t seed) {
+    cache.enable_page_allocation(policy, seed);
+  }
+  void set_classifier_fp_rate(double fp_rate) { cache.set_classifier_fp_rate(fp_rate); }
+  [[nodiscard]] ClassifierSummary get_classifier_summary() const {
+    return cache.get_classifier_summary();
+  }
+
+  // Segment caching: memoize stats deltas of repeated access patterns and
+  // fast-forward them instead of re-simulating (see SegmentCache.hpp)
+  void enable_segment_caching(size_t window = 64,
+                              size_t max_segments = SegmentCache::DEFAULT_MAX_ENTRIES);
+  // Simulate any events still buffered in a partial segment - must be
+  // called after the last event before reading stats
+  void flush_segments();
+  [[nodiscard]] bool is_segment_caching_enabled() const { return segment_cache != nullptr; }
+  [[nodiscard]] const SegmentCacheStats &get_segment_cache_stats() const;
 
   // Advanced instrumentation statistics getters
   [[nodiscard]] const SoftwarePrefetchStats &get_software_prefetch_stats() const;
   [[nodiscard]] const VectorStats &get_vector_stats() const;
+  [[nodiscard]] const GatherScatterStats &get_gather_scatter_stats() const;
   [[nodiscard]] const AtomicStats &get_atomic_stats() const;
   [[nodiscard]] const MemoryIntrinsicStats &get_memory_intrinsic_stats() const;
 };
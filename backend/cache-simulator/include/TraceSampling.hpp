@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Aggregate of the trace's W sample-rate records. The runtime's adaptive
+// sampler (CACHE_EXPLORER_ADAPTIVE=1) moves its emission divisor while
+// the program runs and announces every change with a "W <divisor>"
+// record; each event after one stands for <divisor> captured accesses.
+// Static sampling (CACHE_EXPLORER_SAMPLE_RATE=n) emits a single W record
+// up front. Both processors feed this so the reports can state how much
+// of the program the trace actually represents.
+struct TraceSampling {
+  uint64_t current_rate = 1;  // divisor in effect at this point in the stream
+  uint64_t min_rate = 0;      // lowest divisor any W record named (0 = none yet)
+  uint64_t max_rate = 0;
+  uint32_t rate_changes = 0;  // W records that moved the divisor
+  uint64_t weighted_events = 0;  // accesses scaled by the divisor they ran under
+
+  // A W record: the named divisor applies to everything that follows
+  void on_rate_record(uint64_t rate) {
+    if (rate == 0)
+      return;
+    if (min_rate == 0 || rate < min_rate)
+      min_rate = rate;
+    if (rate > max_rate)
+      max_rate = rate;
+    if (rate != current_rate)
+      rate_changes++;
+    current_rate = rate;
+  }
+
+  // One simulated access under the current divisor
+  void on_event() { weighted_events += current_rate; }
+
+  // True once the trace named a divisor; an unsampled trace never emits
+  // W records and the reports stay as they were
+  [[nodiscard]] bool active() const { return min_rate != 0; }
+};
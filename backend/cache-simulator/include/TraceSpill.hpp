@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "TraceEvent.hpp"
+
+// Disk-backed event store for traces larger than RAM (--spill)
+//
+// Batch mode materializes every parsed event in memory, and --parallel
+// makes that worse by also holding the raw text. For traces beyond RAM
+// the spill store writes parsed events to an anonymous temp file during
+// a bounded-memory parse pass, then streams them back through the
+// simulator in fixed-size batches - peak memory is one parse chunk plus
+// one replay batch no matter how long the trace is.
+//
+// Records are raw TraceEvent structs. That is safe here because the
+// embedded string_views point into the process-lifetime FileTable
+// intern pool, and a spill file never outlives its process: the temp
+// file is unlinked immediately after creation, so the kernel reclaims
+// it on close or crash. This is scratch space, not an interchange
+// format - CXTB remains the on-disk trace format.
+class TraceSpill {
+public:
+  static constexpr size_t BATCH_EVENTS = 65536; // ~5MB replay buffer
+
+  ~TraceSpill() {
+    if (file_)
+      fclose(file_);
+  }
+
+  // Create the backing temp file under dir ($TMPDIR or /tmp by default)
+  bool open(const std::string &dir = "") {
+    std::string base = dir;
+    if (base.empty()) {
+      const char *tmp = std::getenv("TMPDIR");
+      base = (tmp && *tmp) ? tmp : "/tmp";
+    }
+    std::string templ = base + "/cache-sim-spill-XXXXXX";
+    std::vector<char> path(templ.begin(), templ.end());
+    path.push_back('\0');
+    int fd = mkstemp(path.data());
+    if (fd < 0)
+      return false;
+    unlink(path.data()); // reclaimed automatically, even on crash
+    file_ = fdopen(fd, "w+b");
+    if (!file_) {
+      close(fd);
+      return false;
+    }
+    return true;
+  }
+
+  // Append a parsed batch; returns false when the write fails (disk full)
+  bool append(const TraceEvent *events, size_t count) {
+    if (fwrite(events, sizeof(TraceEvent), count, file_) != count)
+      return false;
+    count_ += count;
+    return true;
+  }
+
+  [[nodiscard]] size_t event_count() const { return count_; }
+
+  // Stream the spilled events back in order, BATCH_EVENTS at a time.
+  // fn(events, count) is invoked per batch; returns false on read error.
+  template <typename Fn> bool for_each_batch(Fn &&fn) {
+    if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0)
+      return false;
+    std::vector<TraceEvent> batch(BATCH_EVENTS);
+    size_t n;
+    while ((n = fread(batch.data(), sizeof(TraceEvent), BATCH_EVENTS,
+                      file_)) > 0) {
+      fn(batch.data(), n);
+    }
+    return ferror(file_) == 0;
+  }
+
+private:
+  FILE *file_ = nullptr;
+  size_t count_ = 0;
+};
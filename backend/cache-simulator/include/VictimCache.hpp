@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "Checkpoint.hpp"
+
+// Small fully-associative buffer between L1 and L2 in the classic Jouppi
+// design: L1 conflict victims park here, and an L1 miss that finds its
+// line in the buffer swaps it back without an L2 round trip. Real chips
+// use 8-16 entries; without one the simulator over-reports conflict
+// misses on set-thrashing loops. Disabled unless sized (zero entries).
+class VictimCache {
+private:
+  struct Entry {
+    uint64_t address = 0;
+    uint64_t lru_time = 0;
+    bool dirty = false;
+    bool valid = false;
+  };
+
+  std::vector<Entry> entries;
+  uint64_t clock = 0;
+  VictimStats stats;
+
+public:
+  VictimCache() = default;
+  explicit VictimCache(size_t num_entries) : entries(num_entries) {}
+
+  [[nodiscard]] bool is_enabled() const { return !entries.empty(); }
+  [[nodiscard]] size_t num_entries() const { return entries.size(); }
+  [[nodiscard]] const VictimStats &get_stats() const { return stats; }
+
+  // Apply a memoized stats delta (segment caching fast-forward)
+  void add_stats(const VictimStats &delta) { stats += delta; }
+
+  void reset_stats() { stats.reset(); }
+
+  void clear() {
+    for (auto &e : entries) {
+      e.valid = false;
+    }
+    clock = 0;
+    stats.reset();
+  }
+
+  // Checkpointing: serialize/restore the parked victims and stats
+  void save_state(CheckpointWriter &w) const {
+    w.write_vec(entries);
+    w.write(clock);
+    w.write(stats);
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.read_vec_expect(entries, "victim cache entries");
+    clock = r.read<uint64_t>();
+    stats = r.read<VictimStats>();
+  }
+
+  // L1 miss probe: on a hit the line moves back to L1, so the entry is
+  // freed. Reports whether the stored copy was dirty.
+  bool probe_and_extract(uint64_t line_addr, bool &was_dirty) {
+    if (!is_enabled()) {
+      return false;
+    }
+    stats.probes++;
+    for (auto &e : entries) {
+      if (e.valid && e.address == line_addr) {
+        stats.hits++;
+        was_dirty = e.dirty;
+        e.valid = false;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Park an L1 victim, displacing the LRU entry when full. Returns true
+  // if a dirty line was pushed out (address in evicted_addr).
+  bool insert(uint64_t line_addr, bool dirty, uint64_t &evicted_addr) {
+    if (!is_enabled()) {
+      return false;
+    }
+    stats.insertions++;
+    Entry *victim = &entries[0];
+    for (auto &e : entries) {
+      if (!e.valid) {
+        victim = &e;
+        break;
+      }
+      if (e.lru_time < victim->lru_time) {
+        victim = &e;
+      }
+    }
+    bool dirty_eviction = victim->valid && victim->dirty;
+    evicted_addr = victim->address;
+    *victim = {line_addr, ++clock, dirty, true};
+    if (dirty_eviction) {
+      stats.writebacks++;
+    }
+    return dirty_eviction;
+  }
+
+  // Inclusive back-invalidation reaches into the buffer too
+  void invalidate(uint64_t line_addr) {
+    for (auto &e : entries) {
+      if (e.valid && e.address == line_addr) {
+        e.valid = false;
+        return;
+      }
+    }
+  }
+};
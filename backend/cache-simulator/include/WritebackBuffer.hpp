@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "CacheStats.hpp"
+#include "Checkpoint.hpp"
+
+// Per-level writeback buffer: dirty-eviction coalescing and stall
+// accounting
+//
+// The stats charge every dirty eviction as drained traffic the moment it
+// happens, as if each level pushed its victim to the next level serially.
+// Real caches park victims in a small writeback buffer that drains in the
+// background: a repeat writeback to a line still waiting coalesces into
+// the existing entry, and an eviction only stalls when every slot is
+// busy. This mirrors MSHRSet for the store path - each accepted
+// writeback occupies a slot until its drain completes against the same
+// virtual issue clock, and only full-buffer waits cost cycles.
+//
+// Accounting lands in TimingStats: writebacks_drained/coalesced describe
+// the traffic after merging, writeback_full_stalls and
+// writeback_stall_cycles are the only cycle cost - a buffer that never
+// fills makes dirty evictions free, which is what hardware does.
+class WritebackBuffer {
+public:
+  static constexpr size_t DEFAULT_ENTRIES = 8;
+
+  explicit WritebackBuffer(size_t entries = DEFAULT_ENTRIES)
+      : capacity_(entries ? entries : 1) {}
+
+  // Account a dirty eviction issued at time now that takes drain_latency
+  // cycles to land in the next level. Advances now past any full-buffer
+  // stall.
+  void on_writeback(uint64_t line, uint64_t &now, uint64_t drain_latency,
+                    TimingStats &timing) {
+    retire(now);
+
+    // Repeat writeback to a line still draining: merged in place
+    for (const auto &e : inflight_) {
+      if (e.line == line) {
+        timing.writebacks_coalesced++;
+        return;
+      }
+    }
+
+    if (inflight_.size() >= capacity_) {
+      // All slots busy: the eviction waits for the earliest drain
+      size_t earliest = 0;
+      for (size_t i = 1; i < inflight_.size(); i++) {
+        if (inflight_[i].drained_at < inflight_[earliest].drained_at)
+          earliest = i;
+      }
+      uint64_t freed_at = inflight_[earliest].drained_at;
+      timing.writeback_full_stalls++;
+      timing.writeback_stall_cycles += freed_at - now;
+      now = freed_at;
+      retire(now);
+    }
+
+    inflight_.push_back({line, now + drain_latency});
+    timing.writebacks_drained++;
+  }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+  [[nodiscard]] size_t in_flight() const { return inflight_.size(); }
+
+  void clear() { inflight_.clear(); }
+
+  // Checkpointing: serialize/restore the draining writebacks
+  void save_state(CheckpointWriter &w) const {
+    w.write<uint64_t>(capacity_);
+    w.write_vec(inflight_);
+  }
+
+  void load_state(CheckpointReader &r) {
+    r.expect<uint64_t>(capacity_, "writeback buffer entries");
+    r.read_vec(inflight_);
+  }
+
+private:
+  struct Entry {
+    uint64_t line;
+    uint64_t drained_at;
+  };
+
+  void retire(uint64_t now) {
+    inflight_.erase(std::remove_if(inflight_.begin(), inflight_.end(),
+                                   [now](const Entry &e) {
+                                     return e.drained_at <= now;
+                                   }),
+                    inflight_.end());
+  }
+
+  size_t capacity_;
+  std::vector<Entry> inflight_;
+};
@@ -0,0 +1,117 @@
+#ifndef CACHESIM_H
+#define CACHESIM_H
+
+/*
+ * libcachesim - in-process cache simulation with a stable C API
+ *
+ * Everything else routes through the cache-sim binary and text pipes;
+ * embedders (the Node server via N-API, internal tools) pay to format
+ * events as text in the runtime and re-parse them in the simulator.
+ * This API drops both costs: create a processor, feed event structs in
+ * batches, fetch stats - zero serialization.
+ *
+ * The API is C so bindings stay trivial and the ABI stays stable while
+ * the C++ internals evolve. Handles are opaque and not thread-safe;
+ * feed one handle from one thread (multi-core traces carry their
+ * thread IDs in the events themselves).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHESIM_API_VERSION 1
+
+/* Opaque simulator handle */
+typedef struct cachesim cachesim_t;
+
+/* One memory event, mirroring the trace record. `file` may be NULL when
+ * source attribution is unavailable; when set it is interned internally,
+ * so the pointer only needs to stay valid for the cachesim_process call. */
+typedef struct cachesim_event {
+  uint64_t address;
+  uint32_t size;
+  uint32_t line;       /* source line, 0 if unknown */
+  const char *file;    /* source file, NULL if unknown */
+  uint32_t thread_id;
+  uint8_t is_write;
+  uint8_t is_icache;
+} cachesim_event_t;
+
+typedef struct cachesim_level_stats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t writebacks;
+  /* 3C miss breakdown (zero when fast mode is enabled) */
+  uint64_t compulsory_misses;
+  uint64_t capacity_misses;
+  uint64_t conflict_misses;
+  double hit_rate;
+} cachesim_level_stats_t;
+
+typedef struct cachesim_stats {
+  uint64_t events;     /* events fed since create/reset */
+  cachesim_level_stats_t l1d;
+  cachesim_level_stats_t l1i; /* single-core only, zero otherwise */
+  cachesim_level_stats_t l2;
+  cachesim_level_stats_t l3;
+  uint64_t dtlb_hits;
+  uint64_t dtlb_misses;
+  uint64_t total_cycles;              /* single-core only, zero otherwise */
+  uint64_t coherence_invalidations;   /* multi-core only, zero otherwise */
+  uint64_t false_sharing_events;      /* multi-core only, zero otherwise */
+} cachesim_stats_t;
+
+typedef struct cachesim_hot_line {
+  const char *file;    /* owned by the handle - valid until destroy */
+  uint32_t line;
+  uint64_t hits;
+  uint64_t misses;
+} cachesim_hot_line_t;
+
+/* Create a single-core simulator for a hardware preset ("intel", "amd",
+ * "educational", ... - the same names the CLI's --config accepts; an
+ * unknown name falls back to the Intel default, matching the CLI).
+ * Returns NULL on allocation failure. */
+cachesim_t *cachesim_create(const char *preset);
+
+/* Create a multi-core simulator with MESI coherence. Events are mapped
+ * to cores by their thread_id. Returns NULL if num_cores < 1. */
+cachesim_t *cachesim_create_multicore(const char *preset, int num_cores);
+
+void cachesim_destroy(cachesim_t *sim);
+
+/* Enable prefetching ("none", "nextline", "stream", "stride",
+ * "adaptive", "intel", "bop", "sms" - the CLI's --prefetch names).
+ * Returns 0 on success, -1 on an unknown policy name. */
+int cachesim_set_prefetching(cachesim_t *sim, const char *policy, int degree);
+
+/* Disable 3C miss classification for ~3x faster simulation */
+void cachesim_set_fast_mode(cachesim_t *sim, int enable);
+
+/* Feed a batch of events through the simulator */
+void cachesim_process(cachesim_t *sim, const cachesim_event_t *events,
+                      size_t count);
+
+void cachesim_get_stats(const cachesim_t *sim, cachesim_stats_t *out);
+
+/* Copy up to max_lines of the hottest source lines (by miss count) into
+ * out, returning how many were written. Events fed without file info
+ * contribute nothing here. */
+size_t cachesim_get_hot_lines(cachesim_t *sim, cachesim_hot_line_t *out,
+                              size_t max_lines);
+
+/* Clear accumulated stats and cache contents for a fresh run */
+void cachesim_reset(cachesim_t *sim);
+
+/* Library version string, e.g. "1.0.0" */
+const char *cachesim_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHESIM_H */
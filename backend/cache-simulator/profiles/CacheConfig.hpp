@@ -2,6 +2,7 @@
 
 #include <cstdint>
 
+#include "../include/CoherenceState.hpp"
 #include "../include/EvictionPolicy.hpp"
 #include "../include/InclusionPolicy.hpp"
 #include "../include/WritePolicy.hpp"
@@ -12,8 +13,12 @@ struct LatencyConfig {
   int l1_hit = 4;           // L1 cache hit latency
   int l2_hit = 12;          // L2 cache hit latency
   int l3_hit = 40;          // L3 cache hit latency
-  int memory = 200;         // Main memory latency
-  int tlb_miss_penalty = 7; // Additional cycles for TLB miss (page walk)
+  int memory = 200;         // Main memory latency (local socket)
+  int remote_memory = 320;  // Cross-socket DRAM access (local + interconnect hop)
+  int tlb_miss_penalty = 7; // Cycles per PTE fetch during a page walk
+  int stlb_hit = 9;         // Second-level (unified) TLB hit on L1 TLB miss
+  int mshr_entries = 10;    // Miss-status holding registers (MLP model, see MSHR.hpp)
+  int writeback_entries = 8; // Per-level writeback buffer slots (see WritebackBuffer.hpp)
 
   // Vendor-specific latency presets (realistic values from architecture manuals)
   static LatencyConfig intel_default() {
@@ -72,6 +77,99 @@ struct LatencyConfig {
   }
 };
 
+// DRAM geometry and row-buffer timing behind the L3 (see DramModel.hpp).
+// Latencies are CPU cycles for the DRAM stage of a memory access:
+// row_hit is CAS only, row_empty adds the activate, row_conflict adds
+// precharge of the previously open row on top of that.
+struct DramConfig {
+  int channels = 2;          // Line-interleaved memory channels
+  int banks = 16;            // Banks per channel
+  int row_size = 8192;       // Row buffer size in bytes
+  int row_hit = 80;          // Open row: column access only
+  int row_empty = 160;       // Closed bank: activate + column access
+  int row_conflict = 240;    // Wrong row open: precharge + activate + column
+
+  static DramConfig ddr5_default() {
+    // Dual-channel DDR5-4800, timings scaled to ~5GHz core clocks
+    return {
+      .channels = 2,
+      .banks = 32,
+      .row_size = 8192,
+      .row_hit = 80,
+      .row_empty = 160,
+      .row_conflict = 240
+    };
+  }
+
+  static DramConfig ddr4_default() {
+    // Dual-channel DDR4-3200 (older desktops, servers per channel)
+    return {
+      .channels = 2,
+      .banks = 16,
+      .row_size = 8192,
+      .row_hit = 90,
+      .row_empty = 175,
+      .row_conflict = 260
+    };
+  }
+
+  static DramConfig lpddr5_default() {
+    // Apple-style unified memory: many narrow channels, smaller rows
+    return {
+      .channels = 8,
+      .banks = 16,
+      .row_size = 2048,
+      .row_hit = 60,
+      .row_empty = 120,
+      .row_conflict = 180
+    };
+  }
+
+  static DramConfig educational_default() {
+    // Small geometry and round numbers so row conflicts are easy to provoke
+    return {
+      .channels = 1,
+      .banks = 4,
+      .row_size = 4096,
+      .row_hit = 50,
+      .row_empty = 100,
+      .row_conflict = 150
+    };
+  }
+};
+
+// Peak sustainable bandwidth per hierarchy link, in bytes per core
+// cycle. The roofline report compares achieved traffic (BandwidthStats)
+// against these to tell latency-bound runs from bandwidth-saturated
+// ones. Memory-side numbers are sustained DRAM bandwidth scaled to the
+// core clock, not the burst peak.
+struct BandwidthConfig {
+  double l1_l2 = 64.0;   // L1<->L2 fill/writeback path
+  double l2_l3 = 32.0;   // L2<->L3 ring/fabric share
+  double l3_mem = 16.0;  // Memory controller, per core
+
+  static BandwidthConfig intel_default() {
+    // Alder Lake: 64B/cycle L2->L1, half-width ring to L3,
+    // dual-channel DDR5-4800 (~76GB/s) at ~5GHz
+    return {.l1_l2 = 64.0, .l2_l3 = 32.0, .l3_mem = 15.0};
+  }
+
+  static BandwidthConfig amd_default() {
+    // Zen 4: 32B/cycle fabric links, DDR5 at ~5GHz
+    return {.l1_l2 = 64.0, .l2_l3 = 32.0, .l3_mem = 17.0};
+  }
+
+  static BandwidthConfig apple_default() {
+    // M-series unified memory: very wide LPDDR5 at ~3.2GHz clocks
+    return {.l1_l2 = 64.0, .l2_l3 = 32.0, .l3_mem = 30.0};
+  }
+
+  static BandwidthConfig educational_default() {
+    // Round numbers so saturation is easy to provoke and reason about
+    return {.l1_l2 = 32.0, .l2_l3 = 16.0, .l3_mem = 8.0};
+  }
+};
+
 // Prefetch configuration tied to hardware characteristics
 struct PrefetchConfig {
   // L1 prefetcher settings
@@ -195,6 +293,15 @@ struct PrefetchConfig {
   }
 };
 
+// BDI-style L3 compression what-if model (see CompressedCacheModel.hpp).
+// Newer server parts ship compressed L3s; enabling this runs a shadow L3
+// with tag_factor times the tags per set against the same demand stream
+// so the report can say whether the workload's data would benefit.
+struct CompressionConfig {
+  bool enabled = false;
+  int tag_factor = 2;  // Tags per set relative to the physical associativity
+};
+
 struct CacheConfig {
   CacheSize kb_size;
   int associativity;
@@ -238,4 +345,12 @@ struct CacheHierarchyConfig {
   InclusionPolicy inclusion_policy;
   PrefetchConfig prefetch = {};   // Default prefetch settings
   LatencyConfig latency = {};     // Default latency settings
+  DramConfig dram = {};           // DRAM stage behind the L3
+  BandwidthConfig bandwidth = {}; // Peak link bandwidths for the roofline report
+  int cores_per_ccx = 0;          // Cores per CCX L3 slice (0 = monolithic L3).
+                                  // AMD Zen presets quote per-CCX L3 capacity,
+                                  // so multi-core runs slice rather than share.
+  CoherenceProtocol coherence_protocol = CoherenceProtocol::MESI;
+                                  // MOESI on AMD presets, MESIF on Intel
+  CompressionConfig l3_compression = {};  // Compressed-L3 what-if shadow
 };
@@ -25,7 +25,10 @@ inline CacheHierarchyConfig make_intel_12th_gen_config() {
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
       .prefetch = PrefetchConfig::intel_default(),
-      .latency = LatencyConfig::intel_default()};
+      .latency = LatencyConfig::intel_default(),
+      .dram = DramConfig::ddr5_default(),
+      .bandwidth = BandwidthConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 inline CacheHierarchyConfig make_amd_zen4_config() {
@@ -52,7 +55,11 @@ inline CacheHierarchyConfig make_amd_zen4_config() {
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Exclusive,
       .prefetch = PrefetchConfig::amd_default(),
-      .latency = LatencyConfig::amd_default()};
+      .latency = LatencyConfig::amd_default(),
+      .dram = DramConfig::ddr5_default(),
+      .bandwidth = BandwidthConfig::amd_default(),
+      .cores_per_ccx = 8,              // Zen 4: 8 cores share a 32MB CCX slice
+      .coherence_protocol = CoherenceProtocol::MOESI};
 }
 
 inline CacheHierarchyConfig make_apple_m_series_config() {
@@ -79,7 +86,9 @@ inline CacheHierarchyConfig make_apple_m_series_config() {
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
       .prefetch = PrefetchConfig::apple_default(),
-      .latency = LatencyConfig::apple_default()};
+      .latency = LatencyConfig::apple_default(),
+      .dram = DramConfig::lpddr5_default(),
+      .bandwidth = BandwidthConfig::apple_default()};
 }
 
 // Intel 14th Gen (Raptor Lake Refresh) - P-cores
@@ -106,7 +115,8 @@ inline CacheHierarchyConfig make_intel_14th_gen_config() {
              .policy = EvictionPolicy::PLRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // AMD Zen 3 (Ryzen 5000 series)
@@ -133,7 +143,9 @@ inline CacheHierarchyConfig make_amd_zen3_config() {
              .policy = EvictionPolicy::LRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Exclusive,
-      .prefetch = PrefetchConfig::amd_default()};  // Zen uses victim cache
+      .prefetch = PrefetchConfig::amd_default(),   // Zen uses victim cache
+      .cores_per_ccx = 8,              // Zen 3: 8 cores share a 32MB CCX slice
+      .coherence_protocol = CoherenceProtocol::MOESI};
 }
 
 // AWS Graviton 3 (ARM Neoverse V1)
@@ -238,10 +250,11 @@ inline CacheHierarchyConfig make_intel_xeon_config() {
       .l3 = {.kb_size = 49152,         // 48MB shared L3
              .associativity = 12,
              .line_size = 64,
-             .policy = EvictionPolicy::PLRU,
+             .policy = EvictionPolicy::DRRIP,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // Intel Xeon Platinum 8488C (Sapphire Rapids) - AWS c7i instance
@@ -268,10 +281,11 @@ inline CacheHierarchyConfig make_xeon_8488c_config() {
       .l3 = {.kb_size = 98304,         // 96MB shared L3 (131072 sets)
              .associativity = 12,      // Adjusted from 15 for power-of-2 sets
              .line_size = 64,
-             .policy = EvictionPolicy::PLRU,
+             .policy = EvictionPolicy::DRRIP,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // AMD EPYC (Milan/Genoa)
@@ -292,13 +306,15 @@ inline CacheHierarchyConfig make_amd_epyc_config() {
              .line_size = 64,
              .policy = EvictionPolicy::LRU,
              .write_policy = WritePolicy::Back},
-      .l3 = {.kb_size = 262144,        // 256MB shared L3 (full socket)
+      .l3 = {.kb_size = 32768,         // 32MB L3 per CCX (256MB package total)
              .associativity = 16,
              .line_size = 64,
-             .policy = EvictionPolicy::LRU,
+             .policy = EvictionPolicy::DRRIP,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Exclusive,
-      .prefetch = PrefetchConfig::amd_default()};
+      .prefetch = PrefetchConfig::amd_default(),
+      .cores_per_ccx = 8,              // A core never hits a neighbor CCX's slice
+      .coherence_protocol = CoherenceProtocol::MOESI};
 }
 
 // Raspberry Pi 4 (Cortex-A72)
@@ -379,7 +395,9 @@ inline CacheHierarchyConfig make_educational_config() {
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Inclusive,
       .prefetch = PrefetchConfig::none(),  // Educational: no prefetch for clarity
-      .latency = LatencyConfig::educational_default()};
+      .latency = LatencyConfig::educational_default(),
+      .dram = DramConfig::educational_default(),
+      .bandwidth = BandwidthConfig::educational_default()};
 }
 
 // =============================================================================
@@ -471,7 +489,8 @@ inline CacheHierarchyConfig make_intel_10th_gen_config() {
              .policy = EvictionPolicy::PLRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // Intel 11th Gen (Tiger Lake) - 10nm SuperFin, Willow Cove
@@ -499,7 +518,8 @@ inline CacheHierarchyConfig make_intel_11th_gen_config() {
              .policy = EvictionPolicy::PLRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // Intel 13th Gen (Raptor Lake) - P-cores (Golden Cove based)
@@ -527,7 +547,8 @@ inline CacheHierarchyConfig make_intel_13th_gen_config() {
              .policy = EvictionPolicy::PLRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::NINE,
-      .prefetch = PrefetchConfig::intel_default()};
+      .prefetch = PrefetchConfig::intel_default(),
+      .coherence_protocol = CoherenceProtocol::MESIF};
 }
 
 // =============================================================================
@@ -559,7 +580,9 @@ inline CacheHierarchyConfig make_amd_zen2_config() {
              .policy = EvictionPolicy::LRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Exclusive,  // AMD victim cache design
-      .prefetch = PrefetchConfig::amd_default()};
+      .prefetch = PrefetchConfig::amd_default(),
+      .cores_per_ccx = 4,               // Zen 2 CCX: 4 cores per 16MB slice
+      .coherence_protocol = CoherenceProtocol::MOESI};
 }
 
 // =============================================================================
@@ -591,5 +614,7 @@ inline CacheHierarchyConfig make_amd_epyc_genoa_config() {
              .policy = EvictionPolicy::LRU,
              .write_policy = WritePolicy::Back},
       .inclusion_policy = InclusionPolicy::Exclusive,  // AMD victim cache design
-      .prefetch = PrefetchConfig::amd_default()};
+      .prefetch = PrefetchConfig::amd_default(),
+      .cores_per_ccx = 8,               // Genoa CCD: 8 cores per 96MB slice
+      .coherence_protocol = CoherenceProtocol::MOESI};
 }
@@ -6,15 +6,80 @@ void ArgParser::print_usage(const char* prog) {
     std::cerr << "Usage: " << prog << " [options]\n"
               << "Options:\n"
               << "  --config <name>   intel|amd|apple|educational|custom (default: intel)\n"
+              << "  --configs <a,b,c> Simulate several presets from one parse of the trace\n"
               << "  --cores <n>       Number of cores to simulate (default: auto)\n"
-              << "  --prefetch <p>    Prefetch policy: none|next|stream|stride|adaptive|intel\n"
+              << "  --prefetch <p>    Prefetch policy: none|next|stream|stride|adaptive|intel|bop|sms\n"
               << "  --prefetch-degree <n>  Number of lines to prefetch (default: 2)\n"
+              << "  --prefetch-throttle  Adapt degree per core from accuracy feedback\n"
+              << "  --coherence <m>   Coherence mode: auto|snoop|directory (default: auto)\n"
+              << "  --protocol <p>    Coherence protocol: mesi|moesi|mesif (default: preset's)\n"
               << "  --verbose         Print each cache event\n"
               << "  --json            Output JSON format\n"
               << "  --stream          Stream individual events as JSON (for real-time)\n"
               << "  --flamegraph      Output SVG flamegraph of cache misses\n"
               << "  --fast            Disable 3C miss classification for ~3x faster simulation\n"
+              << "  --mrc             Single-pass reuse-distance analysis with miss-ratio curve\n"
+              << "  --opt             Compare achieved hit rates against Belady-optimal replacement\n"
+              << "  --hot-line-budget <k>  Track top-k hot lines in fixed memory (default: exact)\n"
+              << "  --mshr <n>        Miss-status holding registers for MLP timing (default: 10)\n"
+              << "  --victim-cache [n]  Fully-associative L1 victim buffer with n entries (default: 8)\n"
+              << "  --wb-buffer <n>   Writeback buffer slots per cache level (default: 8)\n"
+              << "  --compress-l3     Model a BDI-compressed L3 beside the real one (what-if)\n"
+              << "  --remap           Shadow alternative L1D set mappings (conflict-miss what-if)\n"
+              << "  --no-bulk-sweep   Simulate large memset/memcpy ranges line by line\n"
+              << "  --no-coherence-memo  Recompute every coherence transition instead of memoizing\n"
+              << "  --self-profile    Report per-stage timing of the simulator itself to stderr\n"
+              << "  --numa <s>        Simulate s sockets with per-socket L3s and page placement\n"
+              << "  --numa-policy <p> NUMA page placement: first-touch (default) or interleave\n"
+              << "  --ccx <n>         Cores per CCX L3 slice (AMD presets default to theirs; 0 = shared L3)\n"
+              << "  --placement <p>   Thread-to-core placement: scatter (default) or compact\n"
+              << "  --placement-file <f>  Explicit thread pins, one \"thread core\" pair per line\n"
+              << "  --tlb-walk        Send page-walk PTE fetches through the cache hierarchy\n"
+              << "  --huge-pages [s]  Back mappings with huge pages: 2m (default) or 1g\n"
+              << "  --page-alloc <p>  Physical page placement for L2/L3 indexing: sequential, random, color\n"
+              << "  --page-seed <n>   Frame placement seed for --page-alloc random (default: 42)\n"
+              << "  --bloom-fp <r>    3C classifier false-positive rate (default: 0.01)\n"
+              << "  --binary          Read binary trace format (CXTB) instead of text\n"
+              << "  --trace-file <p>  Memory-map trace from file instead of reading stdin\n"
+              << "  --pipeline        Stream trace in constant memory, parse overlapped with simulation\n"
+              << "  --spill [dir]     Bounded-memory mode for traces larger than RAM: parse\n"
+              << "                    into a temp file, then stream it through the simulator\n"
+              << "  --cache-segments  Memoize repeated loop segments for faster simulation\n"
+              << "  --simpoint [n]    Phase-sampled simulation: cluster n-event intervals,\n"
+              << "                    simulate one representative per phase (default n: 100000)\n"
+              << "  --simpoint-k <k>  Max phases for --simpoint (default: 8)\n"
+              << "  --sample-sets <n> Simulate 1 of every n cache sets in full detail and\n"
+              << "                    extrapolate the stats with error bars (power of two)\n"
+              << "  --warmup <n>      Warm caches/TLBs on the first n events without counting stats\n"
+              << "  --checkpoint-every <n>  Snapshot simulator state every n events (single-core batch)\n"
+              << "  --checkpoint-file <p>   Checkpoint path (default: cache-sim.ckpt)\n"
+              << "  --restore <p>     Resume from a checkpoint, skipping already-simulated events\n"
+              << "  --checkpoint-keep Keep every snapshot as <file>.<offset> (checkpoint series)\n"
+              << "  --incremental <t> Re-run against baseline trace t: reuse its checkpoint series\n"
+              << "                    up to the first divergence, simulate only the rest\n"
+              << "  --replay-range <a:b>  Simulate only events [a, b) of a --trace-file, seeking\n"
+              << "                    via its sidecar index (trace-tool index) and resuming from\n"
+              << "                    the nearest --checkpoint-keep snapshot\n"
+              << "  --index <p>       Sidecar index path (default: <trace>.cxi)\n"
+              << "  --stream-stats <n>  Emit a compact stats snapshot to stderr every n events\n"
+              << "  --intervals <n>   Record an n-event hit-rate/invalidation/prefetch\n"
+              << "                    time-series into the JSON output (columnar)\n"
+              << "  --diff <path>     Compare against a prior --json result, emit only deltas\n"
+              << "  --no-cache        Bypass the content-addressed result cache\n"
+              << "  --batch <file>    Run a JSON manifest of independent traces on a worker pool,\n"
+              << "                    one result file per trace (--parallel <n> sizes the pool)\n"
+              << "  --daemon <path>   Stay resident, accept jobs over a UNIX socket\n"
+              << "  --shm <path>      Live mode: consume events in place from the shared-memory\n"
+              << "                    segment an instrumented binary exports (CACHE_EXPLORER_SHM)\n"
+              << "  --filter-file <g> Only simulate events whose source file matches the\n"
+              << "                    glob (* and ?) - excluded events cost a predicate check\n"
+              << "  --filter-addr <lo>:<hi>  Only simulate accesses inside [lo, hi) (hex ok)\n"
+              << "  --filter-heap <g> Only simulate accesses into live allocations whose\n"
+              << "                    allocation site (file or file:line) matches the glob\n"
+              << "  --filter-heap-exclude <g>  Inverse: drop accesses into matching allocations\n"
               << "  --parallel [n]    Enable parallel trace parsing with n threads (default: auto)\n"
+              << "  --parallel-sim [n]  Simulate cores on n worker threads with epoch sync (default: auto)\n"
+              << "  --virtual-time    Replay threads in virtual-time order (deterministic interleaving)\n"
               << "  --help            Show this help\n"
               << "\nCustom cache config (use with --config custom):\n"
               << "  --l1-size <bytes>   L1 cache size (default: 32768)\n"
@@ -33,6 +98,8 @@ PrefetchPolicy ArgParser::parse_prefetch_policy(std::string_view name) {
     if (name == "stride") return PrefetchPolicy::STRIDE;
     if (name == "adaptive") return PrefetchPolicy::ADAPTIVE;
     if (name == "intel") return PrefetchPolicy::INTEL;
+    if (name == "bop" || name == "best-offset") return PrefetchPolicy::BEST_OFFSET;
+    if (name == "sms" || name == "spatial") return PrefetchPolicy::SMS;
     return PrefetchPolicy::NONE;
 }
 
@@ -44,6 +111,55 @@ std::string ArgParser::prefetch_policy_name(PrefetchPolicy p) {
         case PrefetchPolicy::STRIDE: return "stride";
         case PrefetchPolicy::ADAPTIVE: return "adaptive";
         case PrefetchPolicy::INTEL: return "intel";
+        case PrefetchPolicy::BEST_OFFSET: return "best_offset";
+        case PrefetchPolicy::SMS: return "sms";
+    }
+    return "unknown";
+}
+
+PageAllocPolicy ArgParser::parse_page_alloc_policy(std::string_view name) {
+    if (name == "sequential" || name == "seq") return PageAllocPolicy::Sequential;
+    if (name == "random") return PageAllocPolicy::Random;
+    if (name == "color" || name == "colored") return PageAllocPolicy::Colored;
+    return PageAllocPolicy::None;
+}
+
+std::string ArgParser::page_alloc_policy_name(PageAllocPolicy p) {
+    switch (p) {
+        case PageAllocPolicy::None: return "none";
+        case PageAllocPolicy::Sequential: return "sequential";
+        case PageAllocPolicy::Random: return "random";
+        case PageAllocPolicy::Colored: return "color";
+    }
+    return "unknown";
+}
+
+CoherenceMode ArgParser::parse_coherence_mode(std::string_view name) {
+    if (name == "snoop" || name == "broadcast") return CoherenceMode::Snoop;
+    if (name == "directory" || name == "dir") return CoherenceMode::Directory;
+    return CoherenceMode::Auto;
+}
+
+std::string ArgParser::coherence_mode_name(CoherenceMode mode) {
+    switch (mode) {
+        case CoherenceMode::Auto: return "auto";
+        case CoherenceMode::Snoop: return "snoop";
+        case CoherenceMode::Directory: return "directory";
+    }
+    return "unknown";
+}
+
+CoherenceProtocol ArgParser::parse_coherence_protocol(std::string_view name) {
+    if (name == "moesi") return CoherenceProtocol::MOESI;
+    if (name == "mesif") return CoherenceProtocol::MESIF;
+    return CoherenceProtocol::MESI;
+}
+
+std::string ArgParser::coherence_protocol_name(CoherenceProtocol protocol) {
+    switch (protocol) {
+        case CoherenceProtocol::MESI: return "mesi";
+        case CoherenceProtocol::MOESI: return "moesi";
+        case CoherenceProtocol::MESIF: return "mesif";
     }
     return "unknown";
 }
@@ -78,8 +194,8 @@ CacheHierarchyConfig ArgParser::get_preset_config(std::string_view name) {
 }
 
 CacheHierarchyConfig ArgParser::build_cache_config(const SimulatorOptions& opts) {
+    CacheHierarchyConfig cfg;
     if (opts.config_name == "custom") {
-        CacheHierarchyConfig cfg;
         // Convert bytes to KB for CacheConfig which expects kb_size
         size_t l1_kb = opts.l1_size / 1024;
         size_t l2_kb = opts.l2_size / 1024;
@@ -89,9 +205,22 @@ CacheHierarchyConfig ArgParser::build_cache_config(const SimulatorOptions& opts)
         cfg.l2 = {l2_kb, opts.l2_assoc, opts.line_size, EvictionPolicy::LRU};
         cfg.l3 = {l3_kb, opts.l3_assoc, opts.line_size, EvictionPolicy::LRU};
         cfg.inclusion_policy = InclusionPolicy::NINE;
-        return cfg;
+    } else {
+        cfg = get_preset_config(opts.config_name);
+    }
+    if (opts.mshr_entries > 0) {
+        cfg.latency.mshr_entries = opts.mshr_entries;
+    }
+    if (opts.wb_buffer_entries > 0) {
+        cfg.latency.writeback_entries = opts.wb_buffer_entries;
     }
-    return get_preset_config(opts.config_name);
+    if (opts.cores_per_ccx >= 0) {
+        cfg.cores_per_ccx = opts.cores_per_ccx;  // --ccx overrides preset topology
+    }
+    if (opts.coherence_protocol_set) {
+        cfg.coherence_protocol = opts.coherence_protocol;  // --protocol overrides preset
+    }
+    return cfg;
 }
 
 void ArgParser::apply_preset_prefetch(SimulatorOptions& opts) {
@@ -111,11 +240,37 @@ void ArgParser::apply_preset_prefetch(SimulatorOptions& opts) {
 SimulatorOptions ArgParser::parse(int argc, char* argv[]) {
     SimulatorOptions opts;
 
+    // Canonical argv digest for the content-addressed result cache: every
+    // flag that can change the output document, minus the trace source
+    // (its content is hashed separately) and the cache toggle itself
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--trace-file") {
+            if (i + 1 < argc) i++;
+            continue;
+        }
+        if (arg == "--no-cache") continue;
+        opts.cache_fingerprint += arg;
+        opts.cache_fingerprint += '\0';
+    }
+
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
 
         if (arg == "--config" && i + 1 < argc) {
             opts.config_name = argv[++i];
+        } else if (arg == "--configs" && i + 1 < argc) {
+            // Comma-separated preset list - one simulation each, shared parse
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == std::string::npos) comma = list.size();
+                if (comma > start) {
+                    opts.config_list.push_back(list.substr(start, comma - start));
+                }
+                start = comma + 1;
+            }
         } else if (arg == "--cores" && i + 1 < argc) {
             opts.num_cores = std::stoi(argv[++i]);
         } else if (arg == "--verbose") {
@@ -129,6 +284,135 @@ SimulatorOptions ArgParser::parse(int argc, char* argv[]) {
             opts.flamegraph_output = true;
         } else if (arg == "--fast") {
             opts.fast_mode = true;
+        } else if (arg == "--mrc") {
+            opts.mrc = true;
+        } else if (arg == "--opt") {
+            opts.opt_analysis = true;
+        } else if (arg == "--hot-line-budget" && i + 1 < argc) {
+            opts.hot_line_budget = std::stoull(argv[++i]);
+        } else if (arg == "--mshr" && i + 1 < argc) {
+            opts.mshr_entries = std::stoi(argv[++i]);
+        } else if (arg == "--numa" && i + 1 < argc) {
+            opts.numa_sockets = std::stoi(argv[++i]);
+        } else if (arg == "--numa-policy" && i + 1 < argc) {
+            std::string policy = argv[++i];
+            opts.numa_interleave = (policy == "interleave");
+        } else if (arg == "--ccx" && i + 1 < argc) {
+            opts.cores_per_ccx = std::stoi(argv[++i]);
+        } else if (arg == "--placement" && i + 1 < argc) {
+            opts.placement = argv[++i];
+        } else if (arg == "--placement-file" && i + 1 < argc) {
+            opts.placement_file = argv[++i];
+        } else if (arg == "--wb-buffer" && i + 1 < argc) {
+            opts.wb_buffer_entries = std::stoi(argv[++i]);
+        } else if (arg == "--victim-cache") {
+            opts.victim_cache_entries = 8;
+            // Optional entry-count argument
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                opts.victim_cache_entries = std::stoull(argv[++i]);
+            }
+        } else if (arg == "--compress-l3") {
+            opts.compress_l3 = true;
+        } else if (arg == "--remap") {
+            opts.remap_analysis = true;
+        } else if (arg == "--no-bulk-sweep") {
+            opts.bulk_sweep = false;
+        } else if (arg == "--no-coherence-memo") {
+            opts.coherence_memo = false;
+        } else if (arg == "--self-profile") {
+            opts.self_profile = true;
+        } else if (arg == "--tlb-walk") {
+            opts.tlb_walk_injection = true;
+        } else if (arg == "--huge-pages") {
+            opts.huge_page_size = 2ULL << 20;
+            // Optional size argument
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                std::string size = argv[++i];
+                if (size == "1g" || size == "1G") {
+                    opts.huge_page_size = 1ULL << 30;
+                }
+            }
+        } else if (arg == "--page-alloc" && i + 1 < argc) {
+            opts.page_alloc = parse_page_alloc_policy(argv[++i]);
+        } else if (arg == "--page-seed" && i + 1 < argc) {
+            opts.page_alloc_seed = std::stoull(argv[++i]);
+        } else if (arg == "--bloom-fp" && i + 1 < argc) {
+            opts.bloom_fp_rate = std::stod(argv[++i]);
+        } else if (arg == "--binary") {
+            opts.binary_input = true;
+        } else if (arg == "--trace-file" && i + 1 < argc) {
+            opts.trace_file = argv[++i];
+        } else if (arg == "--pipeline") {
+            opts.pipeline_mode = true;
+        } else if (arg == "--spill") {
+            opts.spill_mode = true;
+            // Optional spill directory argument
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                opts.spill_dir = argv[++i];
+            }
+        } else if (arg == "--cache-segments") {
+            opts.cache_segments = true;
+        } else if (arg == "--simpoint") {
+            opts.simpoint_interval = 100000;
+            // Optional interval-length argument
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                opts.simpoint_interval = std::stoull(argv[++i]);
+            }
+        } else if (arg == "--simpoint-k" && i + 1 < argc) {
+            opts.simpoint_clusters = std::stoull(argv[++i]);
+        } else if (arg == "--sample-sets" && i + 1 < argc) {
+            opts.sample_sets = (uint32_t)std::stoul(argv[++i]);
+            if (opts.sample_sets == 0) opts.sample_sets = 1;
+            // Round up to a power of two so the kept lines land on an
+            // exact 1-in-n subset of sets at every cache level
+            uint32_t pow2 = 1;
+            while (pow2 < opts.sample_sets) pow2 <<= 1;
+            opts.sample_sets = pow2;
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            opts.warmup_events = std::stoull(argv[++i]);
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            opts.checkpoint_every = std::stoull(argv[++i]);
+        } else if (arg == "--checkpoint-file" && i + 1 < argc) {
+            opts.checkpoint_file = argv[++i];
+        } else if (arg == "--checkpoint-keep") {
+            opts.checkpoint_keep = true;
+        } else if (arg == "--restore" && i + 1 < argc) {
+            opts.restore_file = argv[++i];
+        } else if (arg == "--incremental" && i + 1 < argc) {
+            opts.incremental_baseline = argv[++i];
+        } else if (arg == "--replay-range" && i + 1 < argc) {
+            opts.replay_range = argv[++i];
+        } else if (arg == "--index" && i + 1 < argc) {
+            opts.index_file = argv[++i];
+        } else if (arg == "--stream-stats" && i + 1 < argc) {
+            opts.stream_stats_every = std::stoull(argv[++i]);
+        } else if (arg == "--intervals" && i + 1 < argc) {
+            opts.interval_events = std::stoull(argv[++i]);
+        } else if (arg == "--diff" && i + 1 < argc) {
+            opts.diff_file = argv[++i];
+        } else if (arg == "--no-cache") {
+            opts.no_cache = true;
+        } else if (arg == "--batch" && i + 1 < argc) {
+            opts.batch_manifest = argv[++i];
+        } else if (arg == "--daemon" && i + 1 < argc) {
+            opts.daemon_socket = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            opts.shm_path = argv[++i];
+        } else if (arg == "--filter-file" && i + 1 < argc) {
+            opts.filter_file = argv[++i];
+        } else if (arg == "--filter-addr" && i + 1 < argc) {
+            std::string range = argv[++i];
+            auto colon = range.find(':');
+            if (colon != std::string::npos) {
+                opts.filter_addr_lo = std::stoull(range.substr(0, colon), nullptr, 0);
+                opts.filter_addr_hi = std::stoull(range.substr(colon + 1), nullptr, 0);
+            }
+        } else if (arg == "--filter-heap" && i + 1 < argc) {
+            opts.filter_heap = argv[++i];
+            opts.filter_heap_exclude = false;
+        } else if (arg == "--filter-heap-exclude" && i + 1 < argc) {
+            opts.filter_heap = argv[++i];
+            opts.filter_heap_exclude = true;
         } else if (arg == "--l1-size" && i + 1 < argc) {
             opts.l1_size = std::stoull(argv[++i]);
         } else if (arg == "--l1-assoc" && i + 1 < argc) {
@@ -149,12 +433,27 @@ SimulatorOptions ArgParser::parse(int argc, char* argv[]) {
         } else if (arg == "--prefetch-degree" && i + 1 < argc) {
             opts.prefetch_degree = std::stoi(argv[++i]);
             opts.prefetch_degree_set = true;
+        } else if (arg == "--prefetch-throttle") {
+            opts.prefetch_throttle = true;
+        } else if (arg == "--coherence" && i + 1 < argc) {
+            opts.coherence_mode = parse_coherence_mode(argv[++i]);
+        } else if (arg == "--protocol" && i + 1 < argc) {
+            opts.coherence_protocol = parse_coherence_protocol(argv[++i]);
+            opts.coherence_protocol_set = true;
         } else if (arg == "--parallel") {
             opts.parallel_parsing = true;
             // Optional thread count argument
             if (i + 1 < argc && argv[i + 1][0] != '-') {
                 opts.parallel_threads = std::stoull(argv[++i]);
             }
+        } else if (arg == "--parallel-sim") {
+            opts.parallel_sim = true;
+            // Optional thread count argument
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                opts.parallel_sim_threads = std::stoull(argv[++i]);
+            }
+        } else if (arg == "--virtual-time") {
+            opts.virtual_time = true;
         } else if (arg == "--help") {
             opts.show_help = true;
         }
@@ -1,5 +1,24 @@
 #include "../include/CacheLevel.hpp"
 
+#include <cstring>
+
+// Vector tag compare: AVX2 checks 4 ways per instruction, SSE2 checks 2.
+// The scalar loop below is the fallback and the tail for odd associativities.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Meta word for a line that holds nothing: invalid, clean, coherence
+// Invalid (0), RRPV at max so RRIP policies treat it as distant
+constexpr uint64_t EMPTY_LINE_META = CacheLevel::LINE_FIELD_MASK
+                                     << CacheLevel::LINE_RRIP_SHIFT;
+// The bits that participate in a lookup: a hit means valid set and tag equal
+constexpr uint64_t LOOKUP_MASK = CacheLevel::LINE_VALID | CacheLevel::LINE_TAG_MASK;
+} // namespace
+
 CacheLevel::CacheLevel(const CacheConfig &cfg)
     : config(cfg),
       cached_offset_bits_(cfg.offset_bits()),
@@ -9,36 +28,117 @@ CacheLevel::CacheLevel(const CacheConfig &cfg)
     throw std::invalid_argument("Invalid cache configuration");
   }
   int num_sets = config.num_sets();
-  sets.resize(num_sets, std::vector<CacheLine>(config.associativity));
+  size_t num_lines = static_cast<size_t>(num_sets) * config.associativity;
+  meta_.resize(num_lines, EMPTY_LINE_META);
+  lru_times_.resize(num_lines, 0);
+  // The oracle's next-use times are only consulted under OPT; every other
+  // policy skips the allocation (8 bytes per line on a 4M-line L3)
+  if (config.policy == EvictionPolicy::OPT) {
+    next_use_.resize(num_lines, NEXT_USE_NEVER);
+  }
   plru_bits.resize(num_sets, 0);
   set_unique_lines.resize(num_sets, 0);
   set_mru_.resize(num_sets, -1);
+  select_access_kernel();
 }
 
-int CacheLevel::find_victim_lru(const std::vector<CacheLine> &set) const {
-  for (int i = 0; i < config.associativity; i++) {
-    if (!set[i].valid)
+int CacheLevel::find_way(uint64_t set_index, uint64_t tag) const {
+  size_t base = set_base(set_index);
+  const uint64_t *meta = meta_.data() + base;
+  int assoc = config.associativity;
+  int way = 0;
+
+  // Valid bit and tag live in one word, so masking the flag fields turns
+  // the valid-and-tag-equal test into a single compare per way
+  const uint64_t needle_word = LINE_VALID | tag;
+
+#if defined(__AVX2__)
+  __m256i lookup_mask = _mm256_set1_epi64x(static_cast<long long>(LOOKUP_MASK));
+  __m256i needle = _mm256_set1_epi64x(static_cast<long long>(needle_word));
+  for (; way + 4 <= assoc; way += 4) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(meta + way));
+    chunk = _mm256_and_si256(chunk, lookup_mask);
+    uint32_t mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(chunk, needle)));
+    if (mask)
+      return way + __builtin_ctz(mask);
+  }
+#elif defined(__SSE2__) || defined(__x86_64__)
+  // SSE2 has no 64-bit compare; compare 32-bit halves and require both
+  __m128i lookup_mask = _mm_set1_epi64x(static_cast<long long>(LOOKUP_MASK));
+  __m128i needle = _mm_set1_epi64x(static_cast<long long>(needle_word));
+  for (; way + 2 <= assoc; way += 2) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(meta + way));
+    chunk = _mm_and_si128(chunk, lookup_mask);
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi32(chunk, needle));
+    if ((mask & 0x00FF) == 0x00FF)
+      return way;
+    if ((mask & 0xFF00) == 0xFF00)
+      return way + 1;
+  }
+#endif
+  for (; way < assoc; way++) {
+    if ((meta[way] & LOOKUP_MASK) == needle_word)
+      return way;
+  }
+  return -1;
+}
+
+// Any invalid way in the set is free for the taking; -1 if the set is full
+static int find_free_way(const uint64_t *meta, int assoc) {
+  for (int i = 0; i < assoc; i++) {
+    if (!(meta[i] & CacheLevel::LINE_VALID))
       return i;
   }
+  return -1;
+}
 
+int CacheLevel::find_victim_lru(uint64_t set_index) const {
+  size_t base = set_base(set_index);
+  int free_way = find_free_way(meta_.data() + base, config.associativity);
+  if (free_way >= 0)
+    return free_way;
+
+  const uint64_t *times = lru_times_.data() + base;
   int victim = 0;
-  uint64_t oldest = set[0].lru_time;
+  uint64_t oldest = times[0];
   for (int i = 1; i < config.associativity; i++) {
-    if (set[i].lru_time < oldest) {
-      oldest = set[i].lru_time;
+    if (times[i] < oldest) {
+      oldest = times[i];
       victim = i;
     }
   }
   return victim;
 }
 
-int CacheLevel::find_victim_plru(uint64_t set_index) {
-  const std::vector<CacheLine> &set = sets[set_index];
+// Belady-optimal: evict the line referenced farthest in the future.
+// Only meaningful offline, when the driver stamps every access's next-use
+// time through set_pending_next_use() before calling access()/install().
+int CacheLevel::find_victim_opt(uint64_t set_index) const {
+  size_t base = set_base(set_index);
+  int free_way = find_free_way(meta_.data() + base, config.associativity);
+  if (free_way >= 0)
+    return free_way;
 
-  for (int i = 0; i < config.associativity; i++) {
-    if (!set[i].valid)
-      return i;
+  const uint64_t *next = next_use_.data() + base;
+  int victim = 0;
+  uint64_t farthest = next[0];
+  for (int i = 1; i < config.associativity; i++) {
+    if (next[i] > farthest) {
+      farthest = next[i];
+      victim = i;
+    }
   }
+  return victim;
+}
+
+int CacheLevel::find_victim_plru(uint64_t set_index) {
+  int free_way =
+      find_free_way(meta_.data() + set_base(set_index), config.associativity);
+  if (free_way >= 0)
+    return free_way;
 
   uint64_t bits = plru_bits[set_index];
   int assoc = config.associativity;
@@ -58,9 +158,18 @@ int CacheLevel::find_victim_plru(uint64_t set_index) {
 }
 
 void CacheLevel::update_replacement_state(uint64_t set_index, int way) {
+  if (config.policy == EvictionPolicy::OPT) {
+    // Remember when the oracle says this line is referenced next
+    next_use_[set_base(set_index) + way] = pending_next_use_;
+    return;
+  }
   if (config.policy != EvictionPolicy::PLRU)
     return;
 
+  update_plru_bits(set_index, way);
+}
+
+void CacheLevel::update_plru_bits(uint64_t set_index, int way) {
   uint64_t &bits = plru_bits[set_index];
   int assoc = config.associativity;
   int node = 0;
@@ -82,75 +191,91 @@ void CacheLevel::update_replacement_state(uint64_t set_index, int way) {
   }
 }
 
-int CacheLevel::find_victim_random(const std::vector<CacheLine> &set) const {
-  for (int i = 0; i < config.associativity; i++) {
-    if (!set[i].valid)
-      return i;
-  }
+int CacheLevel::find_victim_random(uint64_t set_index) const {
+  int free_way =
+      find_free_way(meta_.data() + set_base(set_index), config.associativity);
+  if (free_way >= 0)
+    return free_way;
   return std::rand() % config.associativity;
 }
 
 // Static RRIP: Insert with RRPV=2 (long re-reference), hit sets RRPV=0
 // Evict line with RRPV=3, increment all if none found
-int CacheLevel::find_victim_srrip(std::vector<CacheLine> &set) {
+int CacheLevel::find_victim_srrip(uint64_t set_index) {
+  size_t base = set_base(set_index);
+
   // First check for invalid lines
-  for (int i = 0; i < config.associativity; i++) {
-    if (!set[i].valid)
-      return i;
-  }
+  int free_way = find_free_way(meta_.data() + base, config.associativity);
+  if (free_way >= 0)
+    return free_way;
 
   // Find line with RRPV=3 (distant re-reference)
   while (true) {
     for (int i = 0; i < config.associativity; i++) {
-      if (set[i].rrip_value >= 3)
+      if (line_rrip(base + i) >= 3)
         return i;
     }
     // No line with max RRPV, increment all
     for (int i = 0; i < config.associativity; i++) {
-      if (set[i].rrip_value < 3)
-        set[i].rrip_value++;
+      uint8_t v = line_rrip(base + i);
+      if (v < 3)
+        set_line_rrip(base + i, v + 1);
     }
   }
 }
 
 // Bimodal RRIP: Most inserts with RRPV=3 (distant), occasional RRPV=2
 // Better for scan-resistant behavior
-int CacheLevel::find_victim_brrip(std::vector<CacheLine> &set) {
-  // First check for invalid lines
-  for (int i = 0; i < config.associativity; i++) {
-    if (!set[i].valid)
-      return i;
-  }
-
+int CacheLevel::find_victim_brrip(uint64_t set_index) {
   // Same eviction as SRRIP
-  while (true) {
-    for (int i = 0; i < config.associativity; i++) {
-      if (set[i].rrip_value >= 3)
-        return i;
-    }
-    for (int i = 0; i < config.associativity; i++) {
-      if (set[i].rrip_value < 3)
-        set[i].rrip_value++;
+  return find_victim_srrip(set_index);
+}
+
+// RRPV for a newly installed line. Every install is a miss, so for
+// DRRIP this is also where set dueling learns: a fill in a leader set
+// is a miss charged to that leader's policy, nudging PSEL toward the
+// other one. Follower sets insert with whichever policy is winning.
+uint8_t CacheLevel::rrip_insert_value(uint64_t set_index) {
+  bool bimodal = (config.policy == EvictionPolicy::BRRIP);
+  if (config.policy == EvictionPolicy::DRRIP) {
+    uint64_t slot = set_index % DUEL_MODULUS;
+    if (slot == SRRIP_LEADER_SLOT) {
+      if (psel_ < PSEL_MAX)
+        psel_++;
+    } else if (slot == BRRIP_LEADER_SLOT) {
+      bimodal = true;
+      if (psel_ > 0)
+        psel_--;
+    } else {
+      bimodal = psel_ > PSEL_MAX / 2;
     }
   }
+  if (bimodal) {
+    // BRRIP: mostly insert at 3, occasionally at 2 (1/32 chance)
+    return (std::rand() % 32 == 0) ? 2 : 3;
+  }
+  return 2; // SRRIP inserts at 2
 }
 
 int CacheLevel::find_victim(uint64_t set_index) {
-  std::vector<CacheLine> &set = sets[set_index];
-
   switch (config.policy) {
   case EvictionPolicy::LRU:
-    return find_victim_lru(set);
+    return find_victim_lru(set_index);
   case EvictionPolicy::PLRU:
     return find_victim_plru(set_index);
   case EvictionPolicy::RANDOM:
-    return find_victim_random(set);
+    return find_victim_random(set_index);
   case EvictionPolicy::SRRIP:
-    return find_victim_srrip(set);
+    return find_victim_srrip(set_index);
   case EvictionPolicy::BRRIP:
-    return find_victim_brrip(set);
+    return find_victim_brrip(set_index);
+  case EvictionPolicy::DRRIP:
+    // All RRIP variants share the RRPV-based eviction scan
+    return find_victim_srrip(set_index);
+  case EvictionPolicy::OPT:
+    return find_victim_opt(set_index);
   default:
-    return find_victim_lru(set);
+    return find_victim_lru(set_index);
   }
 }
 
@@ -158,103 +283,140 @@ uint64_t CacheLevel::rebuild_address(uint64_t tag, uint64_t index) const {
   return (tag << cached_tag_shift_) | (index << cached_offset_bits_);
 }
 
+void CacheLevel::record_miss_class(uint64_t address, uint64_t index) {
+  uint64_t line_addr = address & ~(static_cast<uint64_t>(config.line_size) - 1);
+  // Check if this is a compulsory (cold) miss. A Bloom false positive
+  // demotes a compulsory miss to capacity/conflict; the filter's
+  // estimated_fp_rate() bounds how often that happens.
+  bool is_compulsory = !ever_accessed.test_and_insert(line_addr);
+  if (is_compulsory) {
+    unique_lines_accessed++;
+    set_unique_lines[index]++;
+    stats.compulsory_misses++;
+  } else {
+    // Non-compulsory miss: capacity or conflict
+    // Use per-set tracking for better classification:
+    // - Conflict miss: this set has seen more unique lines than its associativity
+    //   (set contention even though overall cache has room)
+    // - Capacity miss: overall working set exceeds cache capacity
+    //   (cache is too small for the working set)
+    uint64_t cache_lines = static_cast<uint64_t>(config.num_sets()) * config.associativity;
+    uint64_t set_assoc = static_cast<uint64_t>(config.associativity);
+
+    if (unique_lines_accessed <= cache_lines && set_unique_lines[index] > set_assoc) {
+      // Working set fits in cache, but this particular set has contention
+      stats.conflict_misses++;
+    } else if (unique_lines_accessed > cache_lines) {
+      // Overall working set exceeds cache capacity
+      stats.capacity_misses++;
+    } else {
+      // Edge case: re-access to evicted line before we've exceeded either threshold
+      // This is a conflict (set-level thrashing)
+      stats.conflict_misses++;
+    }
+  }
+}
+
+// Compile-time find_victim: the RRIP variants share the RRPV scan, just
+// like the runtime switch
+template <EvictionPolicy P>
+int CacheLevel::find_victim_for(uint64_t set_index) {
+  if constexpr (P == EvictionPolicy::PLRU)
+    return find_victim_plru(set_index);
+  else if constexpr (P == EvictionPolicy::RANDOM)
+    return find_victim_random(set_index);
+  else if constexpr (P == EvictionPolicy::SRRIP ||
+                     P == EvictionPolicy::BRRIP ||
+                     P == EvictionPolicy::DRRIP)
+    return find_victim_srrip(set_index);
+  else if constexpr (P == EvictionPolicy::OPT)
+    return find_victim_opt(set_index);
+  else
+    return find_victim_lru(set_index);
+}
+
+// Compile-time update_replacement_state: only OPT and PLRU keep
+// per-touch metadata beyond the LRU timestamp
+template <EvictionPolicy P>
+void CacheLevel::touch_replacement(uint64_t set_index, int way) {
+  if constexpr (P == EvictionPolicy::OPT)
+    next_use_[set_base(set_index) + way] = pending_next_use_;
+  else if constexpr (P == EvictionPolicy::PLRU)
+    update_plru_bits(set_index, way);
+}
+
 AccessInfo CacheLevel::access(uint64_t address, bool is_write) {
-  uint64_t tag = config.get_tag(address);
+  return (this->*access_kernel_)(address, is_write);
+}
+
+template <EvictionPolicy P, bool Track3C>
+AccessInfo CacheLevel::access_impl(uint64_t address, bool is_write) {
+  uint64_t tag = config.get_tag(address) & LINE_TAG_MASK;
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-  uint64_t line_addr = address & ~(static_cast<uint64_t>(config.line_size) - 1);
+  size_t base = set_base(index);
+  const uint64_t needle = LINE_VALID | tag;
 
   access_time++;
 
   // Try MRU way first (fast path - ~80% of hits)
   int mru_way = set_mru_[index];
-  if (mru_way >= 0 && set[mru_way].valid && set[mru_way].tag == tag) [[likely]] {
-    set[mru_way].lru_time = access_time;
+  if (mru_way >= 0 && (meta_[base + mru_way] & LOOKUP_MASK) == needle) [[likely]] {
+    lru_times_[base + mru_way] = access_time;
     // RRIP: promote to near-immediate on hit
-    if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-      set[mru_way].rrip_value = 0;
+    if constexpr (P == EvictionPolicy::SRRIP || P == EvictionPolicy::BRRIP) {
+      set_line_rrip(base + mru_way, 0);
     }
-    update_replacement_state(index, mru_way);
+    touch_replacement<P>(index, mru_way);
     if (is_write)
-      set[mru_way].dirty = true;
+      meta_[base + mru_way] |= LINE_DIRTY;
     stats.hits++;
     return {AccessResult::Hit, false, 0, false};
   }
 
   // Full search (MRU miss or invalid MRU)
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) [[likely]] {
-      set[way].lru_time = access_time;
-      // RRIP: promote to near-immediate on hit
-      if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-        set[way].rrip_value = 0;
-      }
-      update_replacement_state(index, way);
-      if (is_write)
-        set[way].dirty = true;
-      stats.hits++;
-      set_mru_[index] = way;  // Update MRU
-      return {AccessResult::Hit, false, 0, false};
+  int way = find_way(index, tag);
+  if (way >= 0) [[likely]] {
+    lru_times_[base + way] = access_time;
+    // RRIP: promote to near-immediate on hit
+    if constexpr (P == EvictionPolicy::SRRIP || P == EvictionPolicy::BRRIP) {
+      set_line_rrip(base + way, 0);
     }
+    touch_replacement<P>(index, way);
+    if (is_write)
+      meta_[base + way] |= LINE_DIRTY;
+    stats.hits++;
+    set_mru_[index] = way;  // Update MRU
+    return {AccessResult::Hit, false, 0, false};
   }
 
   // Miss - classify as compulsory, capacity, or conflict
   stats.misses++;
 
-  // 3C miss classification (expensive - can be disabled for performance)
-  if (track_3c_misses_) [[unlikely]] {
-    // Check if this is a compulsory (cold) miss
-    bool is_compulsory = (ever_accessed.find(line_addr) == ever_accessed.end());
-    if (is_compulsory) {
-      ever_accessed.insert(line_addr);
-      unique_lines_accessed++;
-      set_unique_lines[index]++;
-      stats.compulsory_misses++;
-    } else {
-      // Non-compulsory miss: capacity or conflict
-      // Use per-set tracking for better classification:
-      // - Conflict miss: this set has seen more unique lines than its associativity
-      //   (set contention even though overall cache has room)
-      // - Capacity miss: overall working set exceeds cache capacity
-      //   (cache is too small for the working set)
-      uint64_t cache_lines = static_cast<uint64_t>(config.num_sets()) * config.associativity;
-      uint64_t set_assoc = static_cast<uint64_t>(config.associativity);
-
-      if (unique_lines_accessed <= cache_lines && set_unique_lines[index] > set_assoc) {
-        // Working set fits in cache, but this particular set has contention
-        stats.conflict_misses++;
-      } else if (unique_lines_accessed > cache_lines) {
-        // Overall working set exceeds cache capacity
-        stats.capacity_misses++;
-      } else {
-        // Edge case: re-access to evicted line before we've exceeded either threshold
-        // This is a conflict (set-level thrashing)
-        stats.conflict_misses++;
-      }
-    }
+  // 3C miss classification (expensive - compiled out in fast mode)
+  if constexpr (Track3C) {
+    record_miss_class(address, index);
   }
 
-  int victim = find_victim(index);
-  bool had_valid_line = set[victim].valid;
-  bool was_dirty = had_valid_line && set[victim].dirty;
+  int victim = find_victim_for<P>(index);
+  size_t v = base + victim;
+  bool had_valid_line = line_valid(v);
+  bool was_dirty = had_valid_line && line_dirty(v);
   // Always track evicted address for inclusive cache back-invalidation
-  uint64_t evicted_addr = had_valid_line ? rebuild_address(set[victim].tag, index) : 0;
+  uint64_t evicted_addr = had_valid_line ? rebuild_address(line_tag(v), index) : 0;
 
   if (was_dirty)
     stats.writebacks++;
 
-  set[victim].tag = tag;
-  set[victim].valid = true;
-  set[victim].dirty = is_write;
-  set[victim].lru_time = access_time;
   // RRIP: insert with long re-reference prediction
-  if (config.policy == EvictionPolicy::SRRIP) {
-    set[victim].rrip_value = 2;  // SRRIP inserts at 2
-  } else if (config.policy == EvictionPolicy::BRRIP) {
-    // BRRIP: mostly insert at 3, occasionally at 2 (1/32 chance)
-    set[victim].rrip_value = (std::rand() % 32 == 0) ? 2 : 3;
+  uint64_t rrip_bits = 0;
+  if constexpr (P == EvictionPolicy::SRRIP ||
+                P == EvictionPolicy::BRRIP ||
+                P == EvictionPolicy::DRRIP) {
+    rrip_bits = static_cast<uint64_t>(rrip_insert_value(index)) << LINE_RRIP_SHIFT;
   }
-  update_replacement_state(index, victim);
+  meta_[v] = LINE_VALID | (is_write ? LINE_DIRTY : 0) | rrip_bits | tag;
+  lru_times_[v] = access_time;
+  touch_replacement<P>(index, victim);
   set_mru_[index] = victim;  // Update MRU to newly installed line
 
   AccessResult result =
@@ -262,61 +424,102 @@ AccessInfo CacheLevel::access(uint64_t address, bool is_write) {
   return {result, was_dirty, evicted_addr, had_valid_line};
 }
 
+// Bind access() to the kernel matching the current policy and tracking
+// flag. Taking the addresses here instantiates all fourteen combinations.
+void CacheLevel::select_access_kernel() {
+  const bool t = track_3c_misses_;
+  switch (config.policy) {
+  case EvictionPolicy::LRU:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::LRU, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::LRU, false>;
+    break;
+  case EvictionPolicy::PLRU:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::PLRU, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::PLRU, false>;
+    break;
+  case EvictionPolicy::RANDOM:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::RANDOM, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::RANDOM, false>;
+    break;
+  case EvictionPolicy::SRRIP:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::SRRIP, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::SRRIP, false>;
+    break;
+  case EvictionPolicy::BRRIP:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::BRRIP, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::BRRIP, false>;
+    break;
+  case EvictionPolicy::DRRIP:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::DRRIP, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::DRRIP, false>;
+    break;
+  case EvictionPolicy::OPT:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::OPT, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::OPT, false>;
+    break;
+  default:
+    access_kernel_ = t ? &CacheLevel::access_impl<EvictionPolicy::LRU, true>
+                       : &CacheLevel::access_impl<EvictionPolicy::LRU, false>;
+    break;
+  }
+}
+
 AccessInfo CacheLevel::install(uint64_t address, bool is_dirty) {
-  uint64_t tag = config.get_tag(address);
+  uint64_t tag = config.get_tag(address) & LINE_TAG_MASK;
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
+  size_t base = set_base(index);
+  const uint64_t needle = LINE_VALID | tag;
 
   access_time++;
 
   // Try MRU way first (fast path)
   int mru_way = set_mru_[index];
-  if (mru_way >= 0 && set[mru_way].valid && set[mru_way].tag == tag) [[likely]] {
-    set[mru_way].lru_time = access_time;
-    set[mru_way].dirty |= is_dirty;
+  if (mru_way >= 0 && (meta_[base + mru_way] & LOOKUP_MASK) == needle) [[likely]] {
+    lru_times_[base + mru_way] = access_time;
+    if (is_dirty)
+      meta_[base + mru_way] |= LINE_DIRTY;
     // RRIP: promote to near-immediate on hit
     if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-      set[mru_way].rrip_value = 0;
+      set_line_rrip(base + mru_way, 0);
     }
     update_replacement_state(index, mru_way);
     return {AccessResult::Hit, false, 0, false};
   }
 
   // Full search (MRU miss or invalid MRU)
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      set[way].lru_time = access_time;
-      set[way].dirty |= is_dirty;
-      // RRIP: promote to near-immediate on hit
-      if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-        set[way].rrip_value = 0;
-      }
-      update_replacement_state(index, way);
-      set_mru_[index] = way;  // Update MRU
-      return {AccessResult::Hit, false, 0, false};
+  int way = find_way(index, tag);
+  if (way >= 0) {
+    lru_times_[base + way] = access_time;
+    if (is_dirty)
+      meta_[base + way] |= LINE_DIRTY;
+    // RRIP: promote to near-immediate on hit
+    if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
+      set_line_rrip(base + way, 0);
     }
+    update_replacement_state(index, way);
+    set_mru_[index] = way;  // Update MRU
+    return {AccessResult::Hit, false, 0, false};
   }
 
   int victim = find_victim(index);
-  bool had_valid_line = set[victim].valid;
-  bool was_dirty = had_valid_line && set[victim].dirty;
+  size_t v = base + victim;
+  bool had_valid_line = line_valid(v);
+  bool was_dirty = had_valid_line && line_dirty(v);
   // Always track evicted address for inclusive cache back-invalidation
-  uint64_t evicted_addr = had_valid_line ? rebuild_address(set[victim].tag, index) : 0;
+  uint64_t evicted_addr = had_valid_line ? rebuild_address(line_tag(v), index) : 0;
 
   if (was_dirty)
     stats.writebacks++;
 
-  set[victim].tag = tag;
-  set[victim].valid = true;
-  set[victim].dirty = is_dirty;
-  set[victim].lru_time = access_time;
   // RRIP: insert with long re-reference prediction
-  if (config.policy == EvictionPolicy::SRRIP) {
-    set[victim].rrip_value = 2;  // SRRIP inserts at 2
-  } else if (config.policy == EvictionPolicy::BRRIP) {
-    // BRRIP: mostly insert at 3, occasionally at 2 (1/32 chance)
-    set[victim].rrip_value = (std::rand() % 32 == 0) ? 2 : 3;
+  uint64_t rrip_bits = 0;
+  if (config.policy == EvictionPolicy::SRRIP ||
+      config.policy == EvictionPolicy::BRRIP ||
+      config.policy == EvictionPolicy::DRRIP) {
+    rrip_bits = static_cast<uint64_t>(rrip_insert_value(index)) << LINE_RRIP_SHIFT;
   }
+  meta_[v] = LINE_VALID | (is_dirty ? LINE_DIRTY : 0) | rrip_bits | tag;
+  lru_times_[v] = access_time;
   update_replacement_state(index, victim);
   set_mru_[index] = victim;  // Update MRU to newly installed line
 
@@ -325,195 +528,207 @@ AccessInfo CacheLevel::install(uint64_t address, bool is_dirty) {
   return {result, was_dirty, evicted_addr, had_valid_line};
 }
 
-bool CacheLevel::is_present(uint64_t address) const {
-  uint64_t tag = config.get_tag(address);
+// Guaranteed-miss access for bulk sweeps: the miss path of access_impl
+// with the tag search dropped. The caller (CacheSystem::bulk_sweep) has
+// already established that the line is absent and is touched exactly
+// once, so probing for a hit would be wasted work on every line of a
+// multi-megabyte intrinsic. Stats, 3C classification, victim selection
+// and replacement metadata all evolve exactly as access() would have
+// left them.
+AccessInfo CacheLevel::sweep_install(uint64_t address, bool is_write) {
+  uint64_t tag = config.get_tag(address) & LINE_TAG_MASK;
   uint64_t index = config.get_index(address);
-  const std::vector<CacheLine> &set = sets[index];
+  size_t base = set_base(index);
+
+  access_time++;
+  stats.misses++;
+
+  if (track_3c_misses_) {
+    record_miss_class(address, index);
+  }
 
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag)
+  int victim = find_victim(index);
+  size_t v = base + victim;
+  bool had_valid_line = line_valid(v);
+  bool was_dirty = had_valid_line && line_dirty(v);
+  uint64_t evicted_addr = had_valid_line ? rebuild_address(line_tag(v), index) : 0;
+
+  if (was_dirty)
+    stats.writebacks++;
+
+  // RRIP: insert with long re-reference prediction
+  uint64_t rrip_bits = 0;
+  if (config.policy == EvictionPolicy::SRRIP ||
+      config.policy == EvictionPolicy::BRRIP ||
+      config.policy == EvictionPolicy::DRRIP) {
+    rrip_bits = static_cast<uint64_t>(rrip_insert_value(index)) << LINE_RRIP_SHIFT;
+  }
+  meta_[v] = LINE_VALID | (is_write ? LINE_DIRTY : 0) | rrip_bits | tag;
+  lru_times_[v] = access_time;
+  update_replacement_state(index, victim);
+  set_mru_[index] = victim;  // Update MRU to newly installed line
+
+  AccessResult result =
+      was_dirty ? AccessResult::MissWithEviction : AccessResult::Miss;
+  return {result, was_dirty, evicted_addr, had_valid_line};
+}
+
+bool CacheLevel::overlaps_range(uint64_t base_addr, uint64_t line_count) const {
+  uint64_t lo = base_addr & ~(static_cast<uint64_t>(config.line_size) - 1);
+  uint64_t hi = lo + line_count * config.line_size;
+  for (size_t i = 0; i < meta_.size(); i++) {
+    if (!line_valid(i))
+      continue;
+    uint64_t addr = rebuild_address(line_tag(i), i / config.associativity);
+    if (addr >= lo && addr < hi)
       return true;
   }
   return false;
 }
 
+bool CacheLevel::is_present(uint64_t address) const {
+  return find_way(config.get_index(address),
+                  config.get_tag(address) & LINE_TAG_MASK) >= 0;
+}
+
 void CacheLevel::invalidate(uint64_t address) {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      set[way].valid = false;
-      set[way].dirty = false;
-      stats.invalidations++;
-      return;
-    }
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    meta_[set_base(index) + way] = EMPTY_LINE_META;
+    stats.invalidations++;
   }
 }
 
 bool CacheLevel::is_dirty(uint64_t address) const {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  const std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag)
-      return set[way].dirty;
-  }
-  return false;
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  return way >= 0 && line_dirty(set_base(index) + way);
 }
 
 bool CacheLevel::get_line_for_writeback(uint64_t address, bool &was_dirty) {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      was_dirty = set[way].dirty;
-      set[way].dirty = false;
-      return true;
-    }
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    size_t i = set_base(index) + way;
+    was_dirty = line_dirty(i);
+    set_line_dirty(i, false);
+    return true;
   }
   was_dirty = false;
   return false;
 }
 
-std::vector<uint64_t> CacheLevel::get_all_addresses() const {
-  std::vector<uint64_t> addresses;
-  for (uint64_t index = 0; index < sets.size(); index++) {
-    for (int way = 0; way < config.associativity; way++) {
-      if (sets[index][way].valid)
-        addresses.push_back(rebuild_address(sets[index][way].tag, index));
-    }
-  }
-  return addresses;
-}
-
 // MESI Coherence State Management
 
 CoherenceState CacheLevel::get_coherence_state(uint64_t address) const {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  const std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      return set[way].coherence_state;
-    }
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    return line_coherence(set_base(index) + way);
   }
   return CoherenceState::Invalid;
 }
 
 void CacheLevel::set_coherence_state(uint64_t address, CoherenceState state) {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      set[way].coherence_state = state;
-      // Sync dirty flag with coherence state
-      if (state == CoherenceState::Modified) {
-        set[way].dirty = true;
-      } else if (state == CoherenceState::Shared || state == CoherenceState::Invalid) {
-        set[way].dirty = false;
-      }
-      return;
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    size_t i = set_base(index) + way;
+    set_line_coherence(i, state);
+    // Sync dirty flag with coherence state: Owned stays dirty (MOESI
+    // defers the memory writeback to eviction), Forward is a clean copy
+    if (state == CoherenceState::Modified || state == CoherenceState::Owned) {
+      set_line_dirty(i, true);
+    } else if (state == CoherenceState::Shared ||
+               state == CoherenceState::Invalid ||
+               state == CoherenceState::Forward) {
+      set_line_dirty(i, false);
     }
   }
 }
 
 bool CacheLevel::upgrade_to_modified(uint64_t address) {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      CoherenceState old_state = set[way].coherence_state;
-      if (old_state == CoherenceState::Modified) {
-        return false;  // Already Modified, no upgrade needed
-      }
-      set[way].coherence_state = CoherenceState::Modified;
-      set[way].dirty = true;
-      return true;  // Upgrade was performed
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    size_t i = set_base(index) + way;
+    if (line_coherence(i) == CoherenceState::Modified) {
+      return false;  // Already Modified, no upgrade needed
     }
+    set_line_coherence(i, CoherenceState::Modified);
+    set_line_dirty(i, true);
+    return true;  // Upgrade was performed
   }
   return false;  // Line not present
 }
 
 void CacheLevel::downgrade_to_shared(uint64_t address) {
-  uint64_t tag = config.get_tag(address);
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
-
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      set[way].coherence_state = CoherenceState::Shared;
-      set[way].dirty = false;  // Write back happened, no longer dirty
-      return;
-    }
+  int way = find_way(index, config.get_tag(address) & LINE_TAG_MASK);
+  if (way >= 0) {
+    size_t i = set_base(index) + way;
+    set_line_coherence(i, CoherenceState::Shared);
+    set_line_dirty(i, false);  // Write back happened, no longer dirty
   }
 }
 
 AccessInfo CacheLevel::install_with_state(uint64_t address, CoherenceState state) {
-  uint64_t tag = config.get_tag(address);
+  uint64_t tag = config.get_tag(address) & LINE_TAG_MASK;
   uint64_t index = config.get_index(address);
-  std::vector<CacheLine> &set = sets[index];
+  size_t base = set_base(index);
+  const uint64_t needle = LINE_VALID | tag;
+  bool modified = (state == CoherenceState::Modified);
 
   access_time++;
 
   // Try MRU way first (fast path)
   int mru_way = set_mru_[index];
-  if (mru_way >= 0 && set[mru_way].valid && set[mru_way].tag == tag) [[likely]] {
-    set[mru_way].lru_time = access_time;
-    set[mru_way].coherence_state = state;
-    set[mru_way].dirty = (state == CoherenceState::Modified);
+  if (mru_way >= 0 && (meta_[base + mru_way] & LOOKUP_MASK) == needle) [[likely]] {
+    lru_times_[base + mru_way] = access_time;
+    set_line_coherence(base + mru_way, state);
+    set_line_dirty(base + mru_way, modified);
     if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-      set[mru_way].rrip_value = 0;
+      set_line_rrip(base + mru_way, 0);
     }
     update_replacement_state(index, mru_way);
     return {AccessResult::Hit, false, 0, false};
   }
 
   // Full search (MRU miss or invalid MRU)
-  for (int way = 0; way < config.associativity; way++) {
-    if (set[way].valid && set[way].tag == tag) {
-      set[way].lru_time = access_time;
-      set[way].coherence_state = state;
-      set[way].dirty = (state == CoherenceState::Modified);
-      if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
-        set[way].rrip_value = 0;
-      }
-      update_replacement_state(index, way);
-      set_mru_[index] = way;  // Update MRU
-      return {AccessResult::Hit, false, 0, false};
+  int way = find_way(index, tag);
+  if (way >= 0) {
+    lru_times_[base + way] = access_time;
+    set_line_coherence(base + way, state);
+    set_line_dirty(base + way, modified);
+    if (config.policy == EvictionPolicy::SRRIP || config.policy == EvictionPolicy::BRRIP) {
+      set_line_rrip(base + way, 0);
     }
+    update_replacement_state(index, way);
+    set_mru_[index] = way;  // Update MRU
+    return {AccessResult::Hit, false, 0, false};
   }
 
   // Need to install new line
   int victim = find_victim(index);
-  bool had_valid_line = set[victim].valid;
-  bool was_dirty = had_valid_line && set[victim].dirty;
+  size_t v = base + victim;
+  bool had_valid_line = line_valid(v);
+  bool was_dirty = had_valid_line && line_dirty(v);
   // Always track evicted address for inclusive cache back-invalidation
-  uint64_t evicted_addr = had_valid_line ? rebuild_address(set[victim].tag, index) : 0;
+  uint64_t evicted_addr = had_valid_line ? rebuild_address(line_tag(v), index) : 0;
 
   if (was_dirty)
     stats.writebacks++;
 
-  set[victim].tag = tag;
-  set[victim].valid = true;
-  set[victim].dirty = (state == CoherenceState::Modified);
-  set[victim].coherence_state = state;
-  set[victim].lru_time = access_time;
-
-  if (config.policy == EvictionPolicy::SRRIP) {
-    set[victim].rrip_value = 2;
-  } else if (config.policy == EvictionPolicy::BRRIP) {
-    set[victim].rrip_value = (std::rand() % 32 == 0) ? 2 : 3;
+  uint64_t rrip_bits = 0;
+  if (config.policy == EvictionPolicy::SRRIP ||
+      config.policy == EvictionPolicy::BRRIP ||
+      config.policy == EvictionPolicy::DRRIP) {
+    rrip_bits = static_cast<uint64_t>(rrip_insert_value(index)) << LINE_RRIP_SHIFT;
   }
+  meta_[v] = LINE_VALID | (modified ? LINE_DIRTY : 0) |
+             (static_cast<uint64_t>(state) << LINE_COH_SHIFT) | rrip_bits | tag;
+  lru_times_[v] = access_time;
   update_replacement_state(index, victim);
   set_mru_[index] = victim;  // Update MRU to newly installed line
 
@@ -521,3 +736,46 @@ AccessInfo CacheLevel::install_with_state(uint64_t address, CoherenceState state
       was_dirty ? AccessResult::MissWithEviction : AccessResult::Miss;
   return {result, was_dirty, evicted_addr, had_valid_line};
 }
+
+void CacheLevel::save_state(CheckpointWriter &w) const {
+  // Geometry fingerprint - a snapshot is only meaningful in an
+  // identically shaped cache under the same replacement policy
+  w.write<uint32_t>(static_cast<uint32_t>(config.num_sets()));
+  w.write<uint32_t>(static_cast<uint32_t>(config.associativity));
+  w.write<uint32_t>(static_cast<uint32_t>(config.line_size));
+  w.write<uint32_t>(static_cast<uint32_t>(config.policy));
+
+  w.write_vec(meta_);
+  w.write_vec(lru_times_);
+  w.write_vec(next_use_);
+  w.write_vec(plru_bits);
+  w.write_vec(set_mru_);
+  w.write(access_time);
+  w.write(psel_);
+  // Write the base counters only - the slab's alignment padding is a
+  // memory-layout concern, not part of the checkpoint format
+  w.write<CacheStats>(stats);
+  w.write(unique_lines_accessed);
+  w.write_vec(set_unique_lines);
+  ever_accessed.save_state(w);
+}
+
+void CacheLevel::load_state(CheckpointReader &r) {
+  r.expect<uint32_t>(static_cast<uint32_t>(config.num_sets()), "cache sets");
+  r.expect<uint32_t>(static_cast<uint32_t>(config.associativity),
+                     "cache associativity");
+  r.expect<uint32_t>(static_cast<uint32_t>(config.line_size), "cache line size");
+  r.expect<uint32_t>(static_cast<uint32_t>(config.policy), "eviction policy");
+
+  r.read_vec_expect(meta_, "cache line count");
+  r.read_vec_expect(lru_times_, "cache line count");
+  r.read_vec_expect(next_use_, "cache line count");
+  r.read_vec_expect(plru_bits, "PLRU tree count");
+  r.read_vec_expect(set_mru_, "cache set count");
+  access_time = r.read<uint64_t>();
+  psel_ = r.read<uint16_t>();
+  stats = r.read<CacheStats>();
+  unique_lines_accessed = r.read<uint64_t>();
+  r.read_vec_expect(set_unique_lines, "cache set count");
+  ever_accessed.load_state(r);
+}
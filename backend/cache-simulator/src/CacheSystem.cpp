@@ -1,16 +1,35 @@
 #include "../include/CacheSystem.hpp"
 
-void CacheSystem::handle_inclusive_eviction(uint64_t evicted_addr,
-                                             CacheLevel &from_level) {
-  // Inclusive: when L2/L3 evicts, must back-invalidate lower levels
-  if (has_l3() && &from_level == &(*l3_)) {
-    l2.invalidate(evicted_addr);
-    l1d.invalidate(evicted_addr);
-    l1i.invalidate(evicted_addr);
-  } else if (&from_level == &l2) {
-    l1d.invalidate(evicted_addr);
-    l1i.invalidate(evicted_addr);
+// Record that an upper level filled a line. Only inclusive hierarchies
+// pay for the index - exclusive/NINE never back-invalidate.
+void CacheSystem::note_fill(uint64_t line_addr, uint8_t level_bit) {
+  if (inclusion_policy != InclusionPolicy::Inclusive) {
+    return;
   }
+  upper_presence[line_addr] |= level_bit;
+}
+
+// Inclusive back-invalidation of an L3 victim: probe only the levels
+// whose presence bit is set instead of unconditionally invalidating all
+// three. Bits can be stale after a silent upper-level eviction, but an
+// invalidate of an absent line is a no-op, so this is strictly fewer
+// probes with identical behavior.
+void CacheSystem::back_invalidate(uint64_t line_addr) {
+  victim_cache.invalidate(line_addr);
+  auto it = upper_presence.find(line_addr);
+  if (it == upper_presence.end()) {
+    return;
+  }
+  if (it->second & PRESENT_L2) {
+    l2.invalidate(line_addr);
+  }
+  if (it->second & PRESENT_L1D) {
+    l1d.invalidate(line_addr);
+  }
+  if (it->second & PRESENT_L1I) {
+    l1i.invalidate(line_addr);
+  }
+  upper_presence.erase(it);
 }
 
 void CacheSystem::handle_exclusive_eviction(uint64_t evicted_addr,
@@ -19,6 +38,11 @@ void CacheSystem::handle_exclusive_eviction(uint64_t evicted_addr,
                                              bool was_dirty) {
   // Exclusive: evicted line moves to next level (victim cache behavior)
   to_level.install(evicted_addr, was_dirty);
+  if (&to_level == &l2) {
+    bw_stats.l1_l2_bytes += to_level.get_line_size();
+  } else {
+    bw_stats.l2_l3_bytes += to_level.get_line_size();
+  }
 }
 
 void CacheSystem::issue_prefetches(const std::vector<uint64_t> &addrs) {
@@ -28,10 +52,20 @@ void CacheSystem::issue_prefetches(const std::vector<uint64_t> &addrs) {
     if (!l1d.is_present(addr)) {
       // Install in L1 (like Intel DCU prefetcher)
       l1d.install(addr, false);
+      bw_stats.l1_l2_bytes += l1d.get_line_size();
 
-      // Also install in L2 for inclusive hierarchy
+      // Also install in L2 for inclusive hierarchy; a line absent from
+      // L2 was pulled across the links further down as well
       if (!l2.is_present(addr)) {
         l2.install(addr, false);
+        if (has_l3()) {
+          bw_stats.l2_l3_bytes += l2.get_line_size();
+          if (!l3_->is_present(addr)) {
+            bw_stats.l3_mem_bytes += l2.get_line_size();
+          }
+        } else {
+          bw_stats.l3_mem_bytes += l2.get_line_size();
+        }
       }
 
       // Also install in L3 for inclusive hierarchy (if L3 exists)
@@ -39,6 +73,7 @@ void CacheSystem::issue_prefetches(const std::vector<uint64_t> &addrs) {
         l3_->install(addr, false);
       }
 
+      note_fill(addr, PRESENT_L1D | PRESENT_L2);
       prefetched_addresses.insert(addr);
     }
   }
@@ -62,16 +97,23 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
                                                   uint64_t pc) {
   SystemAccessResult result = {false, false, false, false, false, false, {}, 0, 0};
 
-  // TLB lookup (happens before/in parallel with cache access)
-  bool tlb_miss = false;
+  // MSHR model: the core issues accesses at L1-hit cadence and misses
+  // overlap from here; full charged latencies still accumulate into
+  // total_cycles, the MSHR accounting tracks what overlap saves
+  issue_clock += latency_config.l1_hit;
+
+  // TLB lookup (happens before/in parallel with cache access); a L1
+  // TLB miss falls through to the STLB and then a page-table walk
+  int tlb_extra = 0;
   if (tlb_enabled) {
-    bool tlb_hit = tlb.access(address);
-    tlb_miss = !tlb_hit;
-    if (&tlb == &dtlb) {
-      result.dtlb_hit = tlb_hit;
-    } else {
-      result.itlb_hit = tlb_hit;
-    }
+    tlb_extra = static_cast<int>(translate(address, tlb, result));
+  }
+
+  // The TLBs are virtually indexed; everything below them runs on the
+  // physical address when a page allocator is configured. L1 index bits
+  // sit inside the page offset, so only L2/L3 placement actually moves.
+  if (page_alloc.enabled()) {
+    address = page_alloc.translate(address);
   }
 
   // Try L1
@@ -80,9 +122,9 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
     result.l1_hit = true;
     // Calculate timing: L1 hit
     result.cycles = latency_config.l1_hit;
-    if (tlb_miss) {
-      result.cycles += latency_config.tlb_miss_penalty;
-      timing_stats.tlb_miss_cycles += latency_config.tlb_miss_penalty;
+    if (tlb_extra) {
+      result.cycles += tlb_extra;
+      timing_stats.tlb_miss_cycles += tlb_extra;
     }
     timing_stats.l1_hit_cycles += latency_config.l1_hit;
     timing_stats.total_cycles += result.cycles;
@@ -99,41 +141,87 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
     return result;
   }
 
-  // L1 miss - trigger prefetching (like Intel DCU prefetcher)
-  // Real hardware prefetches on L1 miss, not just L3 miss
-  if (prefetch_enabled) {
-    auto pf_addrs = prefetcher.on_miss(address, pc);
-    result.prefetches_issued = static_cast<int>(pf_addrs.size());
-    issue_prefetches(pf_addrs);
-  }
-
-  // L1 miss - handle eviction
-  if (l1_info.was_dirty) {
+  // L1 miss: the access() above installed the line into L1, so record
+  // it in the inclusive reverse index
+  uint64_t line_addr = address & ~(static_cast<uint64_t>(l1.get_line_size()) - 1);
+  note_fill(line_addr, &l1 == &l1i ? PRESENT_L1I : PRESENT_L1D);
+
+  // L1 miss - handle eviction. With a victim buffer the victim parks
+  // there instead (exclusive hierarchies already use L2 as the victim
+  // store, so the buffer stays out of that path).
+  if (victim_cache.is_enabled() && l1_info.had_eviction &&
+      inclusion_policy != InclusionPolicy::Exclusive) {
+    uint64_t vc_evicted = 0;
+    if (victim_cache.insert(l1_info.evicted_address, l1_info.was_dirty,
+                            vc_evicted)) {
+      wb_l1.on_writeback(vc_evicted, issue_clock, latency_config.l2_hit,
+                         timing_stats);
+      bw_stats.l1_l2_bytes += l1.get_line_size();
+      result.writebacks.push_back(vc_evicted);
+    }
+  } else if (l1_info.was_dirty) {
     if (inclusion_policy == InclusionPolicy::Exclusive) {
       handle_exclusive_eviction(l1_info.evicted_address, l1, l2,
                                  l1_info.was_dirty);
     } else {
+      wb_l1.on_writeback(l1_info.evicted_address, issue_clock,
+                         latency_config.l2_hit, timing_stats);
+      bw_stats.l1_l2_bytes += l1.get_line_size();
       result.writebacks.push_back(l1_info.evicted_address);
     }
   }
 
+  // Victim buffer probe: a hit swaps the line back into L1 (access()
+  // above already installed it) and skips the L2 round trip. The stored
+  // copy's dirty data writes back rather than re-dirtying L1.
+  if (victim_cache.is_enabled()) {
+    bool vc_dirty = false;
+    if (victim_cache.probe_and_extract(line_addr, vc_dirty)) {
+      if (vc_dirty) {
+        wb_l1.on_writeback(line_addr, issue_clock, latency_config.l2_hit,
+                           timing_stats);
+        bw_stats.l1_l2_bytes += l1.get_line_size();
+        result.writebacks.push_back(line_addr);
+      }
+      result.cycles = latency_config.l1_hit;
+      if (tlb_extra) {
+        result.cycles += tlb_extra;
+        timing_stats.tlb_miss_cycles += tlb_extra;
+      }
+      timing_stats.l1_hit_cycles += latency_config.l1_hit;
+      timing_stats.total_cycles += result.cycles;
+      return result;
+    }
+  }
+
+  // The L1 fill wasn't absorbed by the victim buffer, so the line came
+  // up from L2 (or further - those links are charged at their own miss)
+  bw_stats.l1_l2_bytes += l1.get_line_size();
+
+  // L1 miss - trigger prefetching (like Intel DCU prefetcher)
+  // Real hardware prefetches on L1 miss, not just L3 miss
+  if (prefetch_enabled) {
+    auto pf_addrs = prefetcher.on_miss(address, pc);
+    result.prefetches_issued = static_cast<int>(pf_addrs.size());
+    issue_prefetches(pf_addrs);
+  }
+
   // Try L2
   AccessInfo l2_info = l2.access(address, is_write);
   if (l2_info.result == AccessResult::Hit) [[likely]] {
     result.l2_hit = true;
     // Calculate timing: L2 hit (includes L1 miss time)
     result.cycles = latency_config.l2_hit;
-    if (tlb_miss) {
-      result.cycles += latency_config.tlb_miss_penalty;
-      timing_stats.tlb_miss_cycles += latency_config.tlb_miss_penalty;
+    if (tlb_extra) {
+      result.cycles += tlb_extra;
+      timing_stats.tlb_miss_cycles += tlb_extra;
     }
     timing_stats.l2_hit_cycles += latency_config.l2_hit;
     timing_stats.total_cycles += result.cycles;
+    mshrs.on_miss(line_addr, issue_clock, latency_config.l2_hit, timing_stats);
 
     // Check if this was a prefetched line - prefetches go to L2
-    // Must align address to cache line boundary for lookup
     if (prefetch_enabled) {
-      uint64_t line_addr = address & ~(static_cast<uint64_t>(l1d.get_line_size()) - 1);
       if (prefetched_addresses.count(line_addr)) {
         prefetcher.record_useful_prefetch();
         prefetched_addresses.erase(line_addr);
@@ -155,23 +243,41 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
       handle_exclusive_eviction(l2_info.evicted_address, l2, *l3_,
                                  l2_info.was_dirty);
     } else {
+      wb_l2.on_writeback(l2_info.evicted_address, issue_clock,
+                         has_l3() ? latency_config.l3_hit
+                                  : latency_config.memory,
+                         timing_stats);
+      (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) +=
+          l2.get_line_size();
       result.writebacks.push_back(l2_info.evicted_address);
     }
   }
+  note_fill(line_addr, PRESENT_L2);
+  // The L2 fill crosses the L3 link, or the memory link when there is
+  // no L3 between L2 and DRAM
+  (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) +=
+      l2.get_line_size();
 
   // Try L3 (if it exists)
   if (has_l3()) {
+    // The compression shadow sees the same demand stream (PTE fetches
+    // from walk injection are deliberately excluded - they are not the
+    // data whose compressibility the runtime sampled)
+    if (l3_compress_.has_value()) {
+      l3_compress_->access(address);
+    }
     AccessInfo l3_info = l3_->access(address, is_write);
     if (l3_info.result == AccessResult::Hit) {
       result.l3_hit = true;
       // Calculate timing: L3 hit
       result.cycles = latency_config.l3_hit;
-      if (tlb_miss) {
-        result.cycles += latency_config.tlb_miss_penalty;
-        timing_stats.tlb_miss_cycles += latency_config.tlb_miss_penalty;
+      if (tlb_extra) {
+        result.cycles += tlb_extra;
+        timing_stats.tlb_miss_cycles += tlb_extra;
       }
       timing_stats.l3_hit_cycles += latency_config.l3_hit;
       timing_stats.total_cycles += result.cycles;
+      mshrs.on_miss(line_addr, issue_clock, latency_config.l3_hit, timing_stats);
 
       if (inclusion_policy == InclusionPolicy::Exclusive) {
         l3_->invalidate(address);
@@ -184,37 +290,42 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
     result.memory_access = true;
     // Calculate timing: memory access
     result.cycles = latency_config.memory;
-    if (tlb_miss) {
-      result.cycles += latency_config.tlb_miss_penalty;
-      timing_stats.tlb_miss_cycles += latency_config.tlb_miss_penalty;
+    if (tlb_extra) {
+      result.cycles += tlb_extra;
+      timing_stats.tlb_miss_cycles += tlb_extra;
     }
     timing_stats.memory_cycles += latency_config.memory;
     timing_stats.total_cycles += result.cycles;
+    mshrs.on_miss(line_addr, issue_clock, latency_config.memory, timing_stats);
+    dram.access(address, timing_stats);
+    bw_stats.l3_mem_bytes += l3_->get_line_size();
 
     if (l3_info.was_dirty) {
+      wb_l3.on_writeback(l3_info.evicted_address, issue_clock,
+                         latency_config.memory, timing_stats);
+      bw_stats.l3_mem_bytes += l3_->get_line_size();
       result.writebacks.push_back(l3_info.evicted_address);
     }
 
     // Handle L3 eviction for inclusive policy
     // Inclusive caches must back-invalidate on ALL evictions, not just dirty ones
     // This ensures lower levels never have lines not present in higher levels
+    // Note: l3_info.evicted_address is the OLD line being evicted, not the new one
     if (inclusion_policy == InclusionPolicy::Inclusive && l3_info.had_eviction) {
-      // Back-invalidate all levels when L3 evicts any line
-      // Note: l3_info.evicted_address is the OLD line being evicted, not the new one
-      l2.invalidate(l3_info.evicted_address);
-      l1d.invalidate(l3_info.evicted_address);
-      l1i.invalidate(l3_info.evicted_address);
+      back_invalidate(l3_info.evicted_address);
     }
   } else {
     // No L3 - L2 miss goes directly to memory
     result.memory_access = true;
     result.cycles = latency_config.memory;
-    if (tlb_miss) {
-      result.cycles += latency_config.tlb_miss_penalty;
-      timing_stats.tlb_miss_cycles += latency_config.tlb_miss_penalty;
+    if (tlb_extra) {
+      result.cycles += tlb_extra;
+      timing_stats.tlb_miss_cycles += tlb_extra;
     }
     timing_stats.memory_cycles += latency_config.memory;
     timing_stats.total_cycles += result.cycles;
+    mshrs.on_miss(line_addr, issue_clock, latency_config.memory, timing_stats);
+    dram.access(address, timing_stats);
   }
 
   // Note: Prefetching is now triggered on L1 miss (earlier in hierarchy)
@@ -223,21 +334,223 @@ SystemAccessResult CacheSystem::access_hierarchy(uint64_t address,
   return result;
 }
 
+// Two-level TLB lookup; on a full miss, walk the page tables. Returns
+// the extra cycles the translation adds to this access.
+uint64_t CacheSystem::translate(uint64_t address, TLB &tlb,
+                                SystemAccessResult &result) {
+  bool tlb_hit = tlb.access(address);
+  if (&tlb == &dtlb) {
+    result.dtlb_hit = tlb_hit;
+  } else {
+    result.itlb_hit = tlb_hit;
+  }
+  if (tlb_hit) {
+    return 0;
+  }
+
+  if (stlb.access(address)) {
+    return latency_config.stlb_hit;
+  }
+
+  // Full walk: fetch the PTE levels the paging caches don't cover
+  uint64_t vpn = address / stlb.get_config().page_size;
+  auto fetches = walker.walk(vpn, timing_stats);
+  uint64_t cycles = 0;
+  if (walk_injection) {
+    for (uint64_t pte : fetches) {
+      cycles += walk_fetch(pte, result);
+    }
+  } else {
+    cycles = fetches.size() *
+             static_cast<uint64_t>(latency_config.tlb_miss_penalty);
+  }
+  timing_stats.page_walk_cycles += cycles;
+  return cycles;
+}
+
+// One PTE reference through the data hierarchy: hardware walkers skip
+// L1, so probe L2 first, then L3, then the DRAM stage
+uint64_t CacheSystem::walk_fetch(uint64_t pte_addr,
+                                 SystemAccessResult &result) {
+  AccessInfo l2_info = l2.access(pte_addr, false);
+  if (l2_info.result == AccessResult::Hit) {
+    return latency_config.l2_hit;
+  }
+  if (l2_info.was_dirty) {
+    wb_l2.on_writeback(l2_info.evicted_address, issue_clock,
+                       has_l3() ? latency_config.l3_hit
+                                : latency_config.memory,
+                       timing_stats);
+    (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) +=
+        l2.get_line_size();
+    result.writebacks.push_back(l2_info.evicted_address);
+  }
+  note_fill(pte_addr & ~(static_cast<uint64_t>(l2.get_line_size()) - 1),
+            PRESENT_L2);
+  (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) +=
+      l2.get_line_size();
+  if (has_l3()) {
+    AccessInfo l3_info = l3_->access(pte_addr, false);
+    if (l3_info.result == AccessResult::Hit) {
+      return latency_config.l3_hit;
+    }
+    if (l3_info.was_dirty) {
+      wb_l3.on_writeback(l3_info.evicted_address, issue_clock,
+                         latency_config.memory, timing_stats);
+      bw_stats.l3_mem_bytes += l3_->get_line_size();
+      result.writebacks.push_back(l3_info.evicted_address);
+    }
+    if (inclusion_policy == InclusionPolicy::Inclusive && l3_info.had_eviction) {
+      back_invalidate(l3_info.evicted_address);
+    }
+    bw_stats.l3_mem_bytes += l3_->get_line_size();
+  }
+  dram.access(pte_addr, timing_stats);
+  return latency_config.memory;
+}
+
 SystemAccessResult CacheSystem::read(uint64_t address, uint64_t pc) {
-  return access_hierarchy(address, false, l1d, dtlb, pc);
+  SystemAccessResult result = access_hierarchy(address, false, l1d, dtlb, pc);
+  latency_hist_.record(result.cycles);
+  return result;
 }
 
 SystemAccessResult CacheSystem::write(uint64_t address, uint64_t pc) {
-  return access_hierarchy(address, true, l1d, dtlb, pc);
+  SystemAccessResult result = access_hierarchy(address, true, l1d, dtlb, pc);
+  latency_hist_.record(result.cycles);
+  return result;
 }
 
 SystemAccessResult CacheSystem::fetch(uint64_t address, uint64_t pc) {
-  return access_hierarchy(address, false, l1i, itlb, pc);
+  // Front-end sequencing: the fetch stream is per-basic-block events at
+  // real post-layout addresses, so a fetch that neither re-reads the
+  // previous line nor continues into the next sequential line is a taken
+  // branch - its target goes through the BTB
+  if (last_fetch_end != 0 && address != last_fetch_addr &&
+      address != last_fetch_end) {
+    btb.access(last_fetch_addr, address);
+  }
+  last_fetch_addr = address;
+  last_fetch_end = address + l1i.get_line_size();
+
+  SystemAccessResult result = access_hierarchy(address, false, l1i, itlb, pc);
+  latency_hist_.record(result.cycles);
+  return result;
+}
+
+// Sequential-sweep accounting for bulk memory intrinsics. The loop below
+// is access_hierarchy() with the cache-level lookups replaced by
+// guaranteed-miss installs: the guards establish that no line of the
+// range is resident and the sweep touches each line once, so every
+// access misses L1/L2/L3 and the hit paths can never be taken. The
+// small stateful models (TLB, MSHRs, DRAM row buffers, writeback
+// buffers) see exactly the call sequence the per-line path would have
+// produced, in the same order against the same issue clock.
+bool CacheSystem::bulk_sweep(uint64_t base_addr, uint64_t size, bool is_write) {
+  if (size == 0) {
+    return false;
+  }
+  // Side models with per-access behavior the sweep cannot reproduce:
+  // inclusive back-invalidation and exclusive fills move lines between
+  // levels on every access, prefetchers and the victim buffer react to
+  // individual misses, walk injection sends PTE fetches through the
+  // caches, and a page allocator scatters the physical line sequence.
+  if (inclusion_policy != InclusionPolicy::NINE || prefetch_enabled ||
+      victim_cache.is_enabled() || l3_compress_.has_value() ||
+      walk_injection || page_alloc.enabled()) {
+    return false;
+  }
+  // OPT replacement needs the oracle's next-use stamp per access
+  const CacheLevel *levels[] = {&l1d, &l2, has_l3() ? &*l3_ : nullptr};
+  for (const CacheLevel *level : levels) {
+    if (level && level->get_eviction_policy() == EvictionPolicy::OPT) {
+      return false;
+    }
+  }
+  uint32_t line_size = static_cast<uint32_t>(l1d.get_line_size());
+  if (l2.get_line_size() != static_cast<int>(line_size) ||
+      (has_l3() && l3_->get_line_size() != static_cast<int>(line_size))) {
+    return false;
+  }
+
+  uint64_t first_line = base_addr / line_size;
+  uint64_t line_count = (base_addr + size - 1) / line_size - first_line + 1;
+  if (line_count < BULK_SWEEP_MIN_LINES) {
+    return false;
+  }
+  uint64_t base_line_addr = first_line * line_size;
+  // A resident range line would score a hit on the per-line path
+  for (const CacheLevel *level : levels) {
+    if (level && level->overlaps_range(base_line_addr, line_count)) {
+      return false;
+    }
+  }
+
+  uint64_t page_size = stlb.get_config().page_size;
+  for (uint64_t j = 0; j < line_count; j++) {
+    uint64_t address = base_line_addr + j * line_size;
+    issue_clock += latency_config.l1_hit;
+
+    // Translation (mirrors translate() - the per-access result flags
+    // feed SystemAccessResult, which the bulk path doesn't surface)
+    uint64_t tlb_extra = 0;
+    if (tlb_enabled && !dtlb.access(address)) {
+      if (stlb.access(address)) {
+        tlb_extra = latency_config.stlb_hit;
+      } else {
+        auto fetches = walker.walk(address / page_size, timing_stats);
+        tlb_extra = fetches.size() *
+                    static_cast<uint64_t>(latency_config.tlb_miss_penalty);
+        timing_stats.page_walk_cycles += tlb_extra;
+      }
+    }
+
+    AccessInfo l1_info = l1d.sweep_install(address, is_write);
+    if (l1_info.was_dirty) {
+      wb_l1.on_writeback(l1_info.evicted_address, issue_clock,
+                         latency_config.l2_hit, timing_stats);
+      bw_stats.l1_l2_bytes += line_size;
+    }
+    bw_stats.l1_l2_bytes += line_size;
+
+    AccessInfo l2_info = l2.sweep_install(address, is_write);
+    if (l2_info.was_dirty) {
+      wb_l2.on_writeback(l2_info.evicted_address, issue_clock,
+                         has_l3() ? latency_config.l3_hit
+                                  : latency_config.memory,
+                         timing_stats);
+      (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) += line_size;
+    }
+    (has_l3() ? bw_stats.l2_l3_bytes : bw_stats.l3_mem_bytes) += line_size;
+
+    AccessInfo l3_info = {AccessResult::Miss, false, 0, false};
+    if (has_l3()) {
+      l3_info = l3_->sweep_install(address, is_write);
+    }
+    if (tlb_extra) {
+      timing_stats.tlb_miss_cycles += tlb_extra;
+    }
+    timing_stats.memory_cycles += latency_config.memory;
+    timing_stats.total_cycles += latency_config.memory + tlb_extra;
+    latency_hist_.record(latency_config.memory + tlb_extra);
+    mshrs.on_miss(address, issue_clock, latency_config.memory, timing_stats);
+    dram.access(address, timing_stats);
+    if (has_l3()) {
+      bw_stats.l3_mem_bytes += line_size;
+      if (l3_info.was_dirty) {
+        wb_l3.on_writeback(l3_info.evicted_address, issue_clock,
+                           latency_config.memory, timing_stats);
+        bw_stats.l3_mem_bytes += line_size;
+      }
+    }
+  }
+  return true;
 }
 
 HierarchyStats CacheSystem::get_stats() const {
   CacheStats l3_stats = has_l3() ? l3_->get_stats() : CacheStats{};
-  return {l1d.get_stats(), l1i.get_stats(), l2.get_stats(), l3_stats, timing_stats};
+  return {l1d.get_stats(), l1i.get_stats(), l2.get_stats(), l3_stats,
+          timing_stats, victim_cache.get_stats(), bw_stats};
 }
 
 void CacheSystem::reset_stats() {
@@ -248,4 +561,84 @@ void CacheSystem::reset_stats() {
     l3_->reset_stats();
   }
   timing_stats.reset();
+  latency_hist_.reset();
+  victim_cache.reset_stats();
+  bw_stats.reset();
+  btb.reset_stats();
+  if (l3_compress_.has_value()) {
+    l3_compress_->reset_stats();
+  }
+}
+
+void CacheSystem::save_state(CheckpointWriter &w) const {
+  l1d.save_state(w);
+  l1i.save_state(w);
+  l2.save_state(w);
+  w.write<uint8_t>(has_l3() ? 1 : 0);
+  if (l3_.has_value()) {
+    l3_->save_state(w);
+  }
+  dtlb.save_state(w);
+  itlb.save_state(w);
+  stlb.save_state(w);
+  walker.save_state(w);
+  prefetcher.save_state(w);
+  w.write<uint8_t>(prefetch_enabled ? 1 : 0);
+  w.write_set(prefetched_addresses);
+  w.write(timing_stats);
+  latency_hist_.save_state(w);
+  w.write(bw_stats);
+  mshrs.save_state(w);
+  w.write(issue_clock);
+  dram.save_state(w);
+  page_alloc.save_state(w);
+  victim_cache.save_state(w);
+  wb_l1.save_state(w);
+  wb_l2.save_state(w);
+  wb_l3.save_state(w);
+  w.write_map(upper_presence);
+  btb.save_state(w);
+  w.write(last_fetch_addr);
+  w.write(last_fetch_end);
+  w.write<uint8_t>(l3_compress_.has_value() ? 1 : 0);
+  if (l3_compress_.has_value()) {
+    l3_compress_->save_state(w);
+  }
+}
+
+void CacheSystem::load_state(CheckpointReader &r) {
+  l1d.load_state(r);
+  l1i.load_state(r);
+  l2.load_state(r);
+  r.expect<uint8_t>(has_l3() ? 1 : 0, "L3 presence");
+  if (l3_.has_value()) {
+    l3_->load_state(r);
+  }
+  dtlb.load_state(r);
+  itlb.load_state(r);
+  stlb.load_state(r);
+  walker.load_state(r);
+  prefetcher.load_state(r);
+  prefetch_enabled = r.read<uint8_t>() != 0;
+  r.read_set(prefetched_addresses);
+  timing_stats = r.read<TimingStats>();
+  latency_hist_.load_state(r);
+  bw_stats = r.read<BandwidthStats>();
+  mshrs.load_state(r);
+  issue_clock = r.read<uint64_t>();
+  dram.load_state(r);
+  page_alloc.load_state(r);
+  victim_cache.load_state(r);
+  wb_l1.load_state(r);
+  wb_l2.load_state(r);
+  wb_l3.load_state(r);
+  r.read_map(upper_presence);
+  btb.load_state(r);
+  last_fetch_addr = r.read<uint64_t>();
+  last_fetch_end = r.read<uint64_t>();
+  r.expect<uint8_t>(l3_compress_.has_value() ? 1 : 0,
+                    "compressed L3 presence");
+  if (l3_compress_.has_value()) {
+    l3_compress_->load_state(r);
+  }
 }
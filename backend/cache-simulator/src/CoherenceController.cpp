@@ -1,8 +1,23 @@
 #include "include/CoherenceController.hpp"
 #include <algorithm>
 
-CoherenceController::CoherenceController(int cores) : num_cores(cores) {
+CoherenceController::CoherenceController(int cores, CoherenceMode requested,
+                                         CoherenceProtocol protocol)
+    : num_cores(cores), protocol(protocol) {
+  // Auto: the single-word snoop filter is cheapest while it fits; a core
+  // count beyond one bitmap word forces the directory. An explicit Snoop
+  // request above 64 cores is promoted for the same reason.
+  if (requested == CoherenceMode::Snoop && cores > 64)
+    requested = CoherenceMode::Directory;
+  mode = (requested == CoherenceMode::Auto)
+             ? (cores > 64 ? CoherenceMode::Directory : CoherenceMode::Snoop)
+             : requested;
+
   l1_caches.resize(cores, nullptr);
+  if (mode == CoherenceMode::Directory) {
+    dir_words = (cores + 63) / 64;
+    dir_shards.resize(cores);
+  }
 }
 
 void CoherenceController::register_cache(int core_id, CacheLevel *cache) {
@@ -10,40 +25,166 @@ void CoherenceController::register_cache(int core_id, CacheLevel *cache) {
     l1_caches[core_id] = cache;
 }
 
+std::vector<uint64_t> &CoherenceController::dir_entry(uint64_t address) {
+  auto &entry = dir_shards[home_node(address)][address];
+  if (entry.empty())
+    entry.assign(dir_words, 0);
+  return entry;
+}
+
 SnoopResult CoherenceController::request_read(int requesting_core,
                                               uint64_t address) {
+  if (mode == CoherenceMode::Directory)
+    return request_read_dir(requesting_core, address);
+
   SnoopResult result = {false, false, 0};
 
-  for (int core = 0; core < num_cores; core++) {
-    if (core == requesting_core || !l1_caches[core])
+  uint64_t &bits = sharers[address];
+  uint64_t peers = bits & ~core_bit(requesting_core);
+
+  // Probe only the cores the filter names, lowest bit first
+  for (uint64_t rest = peers; rest; rest &= rest - 1) {
+    int core = __builtin_ctzll(rest);
+    if (!l1_caches[core] || !l1_caches[core]->is_present(address)) {
+      bits &= ~core_bit(core);  // stale bit from a silent eviction
       continue;
+    }
+
+    result.found = true;
+    if (l1_caches[core]->is_dirty(address)) {
+      result.was_modified = true;
+      result.data_source_core = core;
+      if (protocol == CoherenceProtocol::MOESI) {
+        // Owner supplies data cache-to-cache and keeps the dirty line
+        // (M -> Owned, applied by the cache system); the memory
+        // writeback is deferred until the Owned line is evicted
+        dirty_shares++;
+      } else {
+        // Downgrade M -> S, need writeback
+        bool was_dirty;
+        l1_caches[core]->get_line_for_writeback(address, was_dirty);
+        snoop_writebacks++;
+      }
+    } else {
+      // A clean Exclusive copy - or the Forward copy under MESIF, since
+      // the requester takes over forwarding - falls back to plain Shared
+      CoherenceState peer = l1_caches[core]->get_coherence_state(address);
+      if (peer == CoherenceState::Exclusive ||
+          (protocol == CoherenceProtocol::MESIF &&
+           peer == CoherenceState::Forward)) {
+        l1_caches[core]->set_coherence_state(address, CoherenceState::Shared);
+      }
+    }
+  }
+
+  if (protocol == CoherenceProtocol::MESIF && result.found &&
+      !result.was_modified)
+    forwards++;
+
+  bits |= core_bit(requesting_core);
+  return result;
+}
+
+SnoopResult CoherenceController::request_read_dir(int requesting_core,
+                                                  uint64_t address) {
+  SnoopResult result = {false, false, 0};
+
+  auto &words = dir_entry(address);
+  for (int w = 0; w < dir_words; w++) {
+    uint64_t rest = words[w];
+    if (w == requesting_core >> 6)
+      rest &= ~core_bit(requesting_core);
+
+    while (rest) {
+      int core = (w << 6) + __builtin_ctzll(rest);
+      rest &= rest - 1;
+      if (!l1_caches[core] || !l1_caches[core]->is_present(address)) {
+        words[w] &= ~core_bit(core);  // stale bit from a silent eviction
+        continue;
+      }
 
-    if (l1_caches[core]->is_present(address)) {
       result.found = true;
       if (l1_caches[core]->is_dirty(address)) {
         result.was_modified = true;
         result.data_source_core = core;
-        // Downgrade M -> S, need writeback
-        bool was_dirty;
-        l1_caches[core]->get_line_for_writeback(address, was_dirty);
+        if (protocol == CoherenceProtocol::MOESI) {
+          // Owner supplies data cache-to-cache and keeps the dirty line
+          // (M -> Owned, applied by the cache system); the memory
+          // writeback is deferred until the Owned line is evicted
+          dirty_shares++;
+        } else {
+          // Downgrade M -> S, need writeback
+          bool was_dirty;
+          l1_caches[core]->get_line_for_writeback(address, was_dirty);
+          snoop_writebacks++;
+        }
+      } else {
+        // Same clean-copy downgrades as the snoop path: E -> S, and the
+        // old Forward copy -> S under MESIF
+        CoherenceState peer = l1_caches[core]->get_coherence_state(address);
+        if (peer == CoherenceState::Exclusive ||
+            (protocol == CoherenceProtocol::MESIF &&
+             peer == CoherenceState::Forward)) {
+          l1_caches[core]->set_coherence_state(address,
+                                               CoherenceState::Shared);
+        }
       }
-      sharers[address].push_back(core);
     }
   }
 
-  sharers[address].push_back(requesting_core);
+  if (protocol == CoherenceProtocol::MESIF && result.found &&
+      !result.was_modified)
+    forwards++;
+
+  words[requesting_core >> 6] |= core_bit(requesting_core);
   return result;
 }
 
 SnoopResult CoherenceController::request_exclusive(int requesting_core,
                                                    uint64_t address) {
+  if (mode == CoherenceMode::Directory)
+    return request_exclusive_dir(requesting_core, address);
+
   SnoopResult result = {false, false, 0};
 
-  for (int core = 0; core < num_cores; core++) {
-    if (core == requesting_core || !l1_caches[core])
-      continue;
+  uint64_t &bits = sharers[address];
+  uint64_t peers = bits & ~core_bit(requesting_core);
+
+  for (uint64_t rest = peers; rest; rest &= rest - 1) {
+    int core = __builtin_ctzll(rest);
+    if (!l1_caches[core] || !l1_caches[core]->is_present(address))
+      continue;  // stale bit - cleared below with the rest
+
+    result.found = true;
+    if (l1_caches[core]->is_dirty(address)) {
+      result.was_modified = true;
+      result.data_source_core = core;
+    }
+    // Invalidate other copies
+    l1_caches[core]->invalidate(address);
+  }
+
+  // All other copies are gone; new owner is the requesting core
+  bits = core_bit(requesting_core);
+  return result;
+}
+
+SnoopResult CoherenceController::request_exclusive_dir(int requesting_core,
+                                                       uint64_t address) {
+  SnoopResult result = {false, false, 0};
+
+  auto &words = dir_entry(address);
+  for (int w = 0; w < dir_words; w++) {
+    uint64_t rest = words[w];
+    if (w == requesting_core >> 6)
+      rest &= ~core_bit(requesting_core);
+
+    while (rest) {
+      int core = (w << 6) + __builtin_ctzll(rest);
+      rest &= rest - 1;
+      if (!l1_caches[core] || !l1_caches[core]->is_present(address))
+        continue;  // stale bit - cleared below with the rest
 
-    if (l1_caches[core]->is_present(address)) {
       result.found = true;
       if (l1_caches[core]->is_dirty(address)) {
         result.was_modified = true;
@@ -54,38 +195,103 @@ SnoopResult CoherenceController::request_exclusive(int requesting_core,
     }
   }
 
-  // Clear sharers, new owner is requesting core
-  sharers[address].clear();
-  owner[address] = requesting_core;
+  // All other copies are gone; new owner is the requesting core
+  std::fill(words.begin(), words.end(), 0);
+  words[requesting_core >> 6] = core_bit(requesting_core);
   return result;
 }
 
+void CoherenceController::add_sharer(int core_id, uint64_t address) {
+  if (mode == CoherenceMode::Directory) {
+    dir_entry(address)[core_id >> 6] |= core_bit(core_id);
+  } else {
+    sharers[address] |= core_bit(core_id);
+  }
+}
+
+bool CoherenceController::has_remote_sharers(int core_id, uint64_t address) {
+  if (mode == CoherenceMode::Directory) {
+    auto &shard = dir_shards[home_node(address)];
+    auto it = shard.find(address);
+    if (it == shard.end())
+      return false;
+
+    auto &words = it->second;
+    for (int w = 0; w < dir_words; w++) {
+      uint64_t rest = words[w];
+      if (w == core_id >> 6)
+        rest &= ~core_bit(core_id);
+
+      while (rest) {
+        int core = (w << 6) + __builtin_ctzll(rest);
+        rest &= rest - 1;
+        if (l1_caches[core] && l1_caches[core]->is_present(address))
+          return true;
+        words[w] &= ~core_bit(core);  // stale bit from a silent eviction
+      }
+    }
+    return false;
+  }
+
+  auto it = sharers.find(address);
+  if (it == sharers.end())
+    return false;
+
+  uint64_t peers = it->second & ~core_bit(core_id);
+  for (uint64_t rest = peers; rest; rest &= rest - 1) {
+    int core = __builtin_ctzll(rest);
+    if (l1_caches[core] && l1_caches[core]->is_present(address))
+      return true;
+    it->second &= ~core_bit(core);  // stale bit from a silent eviction
+  }
+  return false;
+}
+
 bool CoherenceController::detect_false_sharing(uint64_t address,
                                                int line_size) {
   uint64_t line_mask = ~(static_cast<uint64_t>(line_size) - 1);
   uint64_t line_addr = address & line_mask;
 
-  auto it = sharers.find(line_addr);
-  if (it == sharers.end())
-    return false;
-
-  return it->second.size() > 1;
+  return get_sharer_count(line_addr) > 1;
 }
 
 void CoherenceController::evict_line(int core_id, uint64_t address) {
+  if (mode == CoherenceMode::Directory) {
+    auto &shard = dir_shards[home_node(address)];
+    auto it = shard.find(address);
+    if (it == shard.end())
+      return;
+
+    it->second[core_id >> 6] &= ~core_bit(core_id);
+    bool any = false;
+    for (uint64_t word : it->second)
+      any |= (word != 0);
+    if (!any)
+      shard.erase(it);
+    return;
+  }
+
   auto it = sharers.find(address);
   if (it != sharers.end()) {
-    auto &cores = it->second;
-    cores.erase(std::remove(cores.begin(), cores.end(), core_id), cores.end());
-    if (cores.empty())
+    it->second &= ~core_bit(core_id);
+    if (it->second == 0)
       sharers.erase(it);
   }
-
-  if (owner.count(address) && owner[address] == core_id)
-    owner.erase(address);
 }
 
 int CoherenceController::get_sharer_count(uint64_t address) const {
+  if (mode == CoherenceMode::Directory) {
+    const auto &shard = dir_shards[home_node(address)];
+    auto it = shard.find(address);
+    if (it == shard.end())
+      return 0;
+
+    int count = 0;
+    for (uint64_t word : it->second)
+      count += __builtin_popcountll(word);
+    return count;
+  }
+
   auto it = sharers.find(address);
-  return it != sharers.end() ? static_cast<int>(it->second.size()) : 0;
+  return it != sharers.end() ? __builtin_popcountll(it->second) : 0;
 }
@@ -1,7 +1,12 @@
 #include "../include/JsonOutput.hpp"
-#include <iomanip>
+#include "../include/JsonWriter.hpp"
 #include <unordered_map>
 
+// All writers build their section in a JsonWriter (one preallocated
+// buffer, numbers via to_chars) and hand it to the stream in a single
+// write - see JsonWriter.hpp for why. Output bytes are identical to the
+// old operator<< chains; only the formatting path changed.
+
 // ========== Utility Functions ==========
 
 std::string JsonOutput::escape(std::string_view s) {
@@ -21,6 +26,8 @@ const char* JsonOutput::coherence_state_char(CoherenceState state) {
         case CoherenceState::Exclusive: return "E";
         case CoherenceState::Shared: return "S";
         case CoherenceState::Invalid: return "I";
+        case CoherenceState::Owned: return "O";
+        case CoherenceState::Forward: return "F";
     }
     return "I";
 }
@@ -29,21 +36,29 @@ const char* JsonOutput::coherence_state_char(CoherenceState state) {
 
 void JsonOutput::write_cache_state(std::ostream& out, const CacheLevel& cache,
                                    int core, bool first, bool multicore) {
-    const auto& sets = cache.get_sets();
     int num_sets = cache.get_num_sets();
     int assoc = cache.get_associativity();
 
-    if (!first) out << ",";
-    out << "{\"core\":" << core
-        << ",\"sets\":" << num_sets
-        << ",\"ways\":" << assoc
-        << ",\"lines\":[";
+    // This is the big section (sets x ways objects - half a million lines
+    // for a large L3), so stream it out as it's built instead of holding
+    // the whole dump in memory
+    JsonWriter w(64 * 1024 + 256);
+    w.stream_to(out);
+
+    if (!first) w.raw(',');
+    w.raw("{\"core\":");
+    w.number(core);
+    w.raw(",\"sets\":");
+    w.number(num_sets);
+    w.raw(",\"ways\":");
+    w.number(assoc);
+    w.raw(",\"lines\":[");
 
     bool first_line = true;
     for (int set = 0; set < num_sets; set++) {
         for (int way = 0; way < assoc; way++) {
-            const auto& line = sets[set][way];
-            if (!first_line) out << ",";
+            CacheLineView line = cache.get_line(set, way);
+            if (!first_line) w.raw(',');
             first_line = false;
 
             if (line.valid) {
@@ -54,71 +69,383 @@ void JsonOutput::write_cache_state(std::ostream& out, const CacheLevel& cache,
                     // Single-core: derive state from dirty bit (M=dirty, E=clean)
                     state = line.dirty ? "M" : "E";
                 }
-                out << "{\"s\":" << set
-                    << ",\"w\":" << way
-                    << ",\"v\":1"
-                    << ",\"t\":\"0x" << std::hex << line.tag << std::dec << "\""
-                    << ",\"st\":\"" << state << "\"}";
+                w.raw("{\"s\":");
+                w.number(set);
+                w.raw(",\"w\":");
+                w.number(way);
+                w.raw(",\"v\":1,\"t\":\"0x");
+                w.hex(line.tag);
+                w.raw("\",\"st\":\"");
+                w.raw(state);
+                w.raw("\"}");
             } else {
-                out << "{\"s\":" << set << ",\"w\":" << way << ",\"v\":0}";
+                w.raw("{\"s\":");
+                w.number(set);
+                w.raw(",\"w\":");
+                w.number(way);
+                w.raw(",\"v\":0}");
             }
         }
     }
-    out << "]}";
+    w.raw("]}");
+    w.flush(out);
 }
 
 // ========== Cache Statistics ==========
 
 void JsonOutput::write_cache_stats(std::ostream& out, const char* name,
                                    const CacheStats& stats, bool last) {
-    out << "    \"" << name << "\": {"
-        << "\"hits\": " << stats.hits << ", "
-        << "\"misses\": " << stats.misses << ", "
-        << "\"hitRate\": " << std::fixed << std::setprecision(3) << stats.hit_rate() << ", "
-        << "\"writebacks\": " << stats.writebacks << ", "
-        << "\"compulsory\": " << stats.compulsory_misses << ", "
-        << "\"capacity\": " << stats.capacity_misses << ", "
-        << "\"conflict\": " << stats.conflict_misses << "}"
-        << (last ? "\n" : ",\n");
+    JsonWriter w(256);
+    w.raw("    \"");
+    w.raw(name);
+    w.raw("\": {\"hits\": ");
+    w.number(stats.hits);
+    w.raw(", \"misses\": ");
+    w.number(stats.misses);
+    w.raw(", \"hitRate\": ");
+    w.fixed(stats.hit_rate(), 3);
+    w.raw(", \"writebacks\": ");
+    w.number(stats.writebacks);
+    w.raw(", \"compulsory\": ");
+    w.number(stats.compulsory_misses);
+    w.raw(", \"capacity\": ");
+    w.number(stats.capacity_misses);
+    w.raw(", \"conflict\": ");
+    w.number(stats.conflict_misses);
+    w.raw(last ? "}\n" : "},\n");
+    w.flush(out);
 }
 
 // ========== TLB Statistics ==========
 
 void JsonOutput::write_tlb_stats(std::ostream& out, const TLBHierarchyStats& stats) {
-    out << "  \"tlb\": {\n";
-    out << "    \"dtlb\": {\"hits\": " << stats.dtlb.hits
-        << ", \"misses\": " << stats.dtlb.misses
-        << ", \"hitRate\": " << std::fixed << std::setprecision(3) << stats.dtlb.hit_rate() << "},\n";
-    out << "    \"itlb\": {\"hits\": " << stats.itlb.hits
-        << ", \"misses\": " << stats.itlb.misses
-        << ", \"hitRate\": " << std::fixed << std::setprecision(3) << stats.itlb.hit_rate() << "}\n";
-    out << "  },\n";
+    JsonWriter w(256);
+    w.raw("  \"tlb\": {\n    \"dtlb\": {\"hits\": ");
+    w.number(stats.dtlb.hits);
+    w.raw(", \"misses\": ");
+    w.number(stats.dtlb.misses);
+    w.raw(", \"hitRate\": ");
+    w.fixed(stats.dtlb.hit_rate(), 3);
+    w.raw("},\n    \"itlb\": {\"hits\": ");
+    w.number(stats.itlb.hits);
+    w.raw(", \"misses\": ");
+    w.number(stats.itlb.misses);
+    w.raw(", \"hitRate\": ");
+    w.fixed(stats.itlb.hit_rate(), 3);
+    w.raw("}\n  },\n");
+    w.flush(out);
+}
+
+// ========== Branch Target Buffer ==========
+
+void JsonOutput::write_btb_stats(std::ostream& out, const BTBStats& stats) {
+    JsonWriter w(256);
+    w.raw("  \"btb\": {\"lookups\": ");
+    w.number(stats.lookups);
+    w.raw(", \"hits\": ");
+    w.number(stats.hits);
+    w.raw(", \"mispredicts\": ");
+    w.number(stats.target_mispredicts);
+    w.raw(", \"hitRate\": ");
+    w.fixed(stats.hit_rate(), 3);
+    w.raw("},\n");
+    w.flush(out);
+}
+
+// ========== Compressed L3 ==========
+
+void JsonOutput::write_compression(std::ostream& out,
+                                   const CompressedCacheModel& model,
+                                   const CacheStats& l3_stats) {
+    const CompressedL3Stats& cs = model.get_stats();
+    JsonWriter w(512);
+    w.raw("  \"compressedL3\": {\n    \"tagSlots\": ");
+    w.number(static_cast<uint64_t>(model.get_tag_slots()));
+    w.raw(", \"hitRate\": ");
+    w.fixed(cs.hit_rate(), 3);
+    w.raw(", \"baselineHitRate\": ");
+    w.fixed(l3_stats.hit_rate(), 3);
+    w.raw(", \"headroom\": ");
+    w.fixed(cs.hit_rate() - l3_stats.hit_rate(), 3);
+    w.raw(",\n    \"avgRatio\": ");
+    w.fixed(model.avg_compression_ratio(), 2);
+    w.raw(", \"hintCoverage\": ");
+    w.fixed(model.hint_coverage(), 3);
+    w.raw(",\n    \"sampledClasses\": {");
+    const uint64_t* counts = model.get_class_counts();
+    for (int cls = 0; cls < BDI_CLASS_COUNT; cls++) {
+        if (cls > 0) w.raw(", ");
+        w.raw("\"");
+        w.raw(bdi_class_name(static_cast<uint8_t>(cls)));
+        w.raw("\": ");
+        w.number(counts[cls]);
+    }
+    w.raw("}\n  },\n");
+    w.flush(out);
+}
+
+// ========== Set-Associative Remap ==========
+
+void JsonOutput::write_remap(std::ostream& out, const RemapAnalysis& remap) {
+    const auto& variants = remap.get_variants();
+    auto hot = remap.get_hot_lines(10);
+    JsonWriter w(512 + hot.size() * 128);
+    w.raw("  \"remap\": {\n    \"accesses\": ");
+    w.number(remap.accesses());
+    w.raw(", \"baselineMisses\": ");
+    w.number(remap.baseline_misses());
+    w.raw(",\n    \"variants\": [\n");
+    for (size_t v = 0; v < variants.size(); v++) {
+        const auto& r = variants[v];
+        w.raw("      {\"name\": \"");
+        w.raw(r.name);
+        w.raw("\", \"sets\": ");
+        w.number(r.sets);
+        w.raw(", \"ways\": ");
+        w.number(r.ways);
+        w.raw(", \"hashedIndex\": ");
+        w.raw(r.hashed ? "true" : "false");
+        w.raw(", \"misses\": ");
+        w.number(r.misses);
+        w.raw(", \"avoided\": ");
+        w.number(r.avoided);
+        w.raw(", \"missReduction\": ");
+        w.fixed(remap.reduction(v), 3);
+        w.raw(v + 1 < variants.size() ? "},\n" : "}\n");
+    }
+    w.raw("    ],\n    \"hotLines\": [\n");
+    for (size_t i = 0; i < hot.size(); i++) {
+        const auto& h = hot[i];
+        w.raw("      {\"file\": \"");
+        w.escaped(h.file);
+        w.raw("\", \"line\": ");
+        w.number(h.line);
+        w.raw(", \"shadowMisses\": ");
+        w.number(h.shadow_misses);
+        w.raw(", \"avoided\": {");
+        for (size_t v = 0; v < variants.size(); v++) {
+            if (v > 0) w.raw(", ");
+            w.raw("\"");
+            w.raw(variants[v].name);
+            w.raw("\": ");
+            w.number(h.avoided[v]);
+        }
+        w.raw(i + 1 < hot.size() ? "}},\n" : "}}\n");
+    }
+    w.raw("    ]\n  },\n");
+    w.flush(out);
+}
+
+// ========== Region Breakdown ==========
+
+void JsonOutput::write_region_stats(
+    std::ostream& out,
+    const std::array<RegionStats, REGION_KIND_COUNT>& regions) {
+    JsonWriter w(512);
+    w.raw("  \"regions\": {\n");
+    for (size_t i = 0; i < REGION_KIND_COUNT; i++) {
+        const RegionStats& stats = regions[i];
+        w.raw("    \"");
+        w.raw(region_kind_name(static_cast<RegionKind>(i)));
+        w.raw("\": {\"accesses\": ");
+        w.number(stats.accesses);
+        w.raw(", \"l1Misses\": ");
+        w.number(stats.l1_misses);
+        w.raw(", \"memoryAccesses\": ");
+        w.number(stats.memory_accesses);
+        w.raw(", \"missRate\": ");
+        w.fixed(stats.miss_rate(), 3);
+        w.raw(i + 1 < REGION_KIND_COUNT ? "},\n" : "}\n");
+    }
+    w.raw("  },\n");
+    w.flush(out);
 }
 
 // ========== Timing Statistics ==========
 
 void JsonOutput::write_timing_stats(std::ostream& out, const TimingStats& timing,
                                     uint64_t total_accesses,
-                                    const LatencyConfig& latency) {
-    out << "  \"timing\": {\n";
-    out << "    \"totalCycles\": " << timing.total_cycles << ",\n";
-    out << "    \"avgLatency\": " << std::fixed << std::setprecision(2)
-        << timing.average_access_latency(total_accesses) << ",\n";
-    out << "    \"breakdown\": {\n";
-    out << "      \"l1HitCycles\": " << timing.l1_hit_cycles << ",\n";
-    out << "      \"l2HitCycles\": " << timing.l2_hit_cycles << ",\n";
-    out << "      \"l3HitCycles\": " << timing.l3_hit_cycles << ",\n";
-    out << "      \"memoryCycles\": " << timing.memory_cycles << ",\n";
-    out << "      \"tlbMissCycles\": " << timing.tlb_miss_cycles << "\n";
-    out << "    },\n";
-    out << "    \"latencyConfig\": {\n";
-    out << "      \"l1Hit\": " << latency.l1_hit << ",\n";
-    out << "      \"l2Hit\": " << latency.l2_hit << ",\n";
-    out << "      \"l3Hit\": " << latency.l3_hit << ",\n";
-    out << "      \"memory\": " << latency.memory << ",\n";
-    out << "      \"tlbMissPenalty\": " << latency.tlb_miss_penalty << "\n";
-    out << "    }\n";
-    out << "  },\n";
+                                    const LatencyConfig& latency,
+                                    const DramConfig& dram,
+                                    const LatencyHistogram* lat_hist) {
+    JsonWriter w(2048);
+    w.raw("  \"timing\": {\n    \"totalCycles\": ");
+    w.number(timing.total_cycles);
+    w.raw(",\n    \"avgLatency\": ");
+    w.fixed(timing.average_access_latency(total_accesses), 2);
+    // Latency distribution: the average above mixes L1 hits with DRAM
+    // round trips; the percentiles show the bimodality (p99 is what a
+    // service tail actually sees)
+    if (lat_hist != nullptr && lat_hist->count() > 0) {
+        w.raw(",\n    \"latency\": {\n      \"samples\": ");
+        w.number(lat_hist->count());
+        w.raw(",\n      \"p50\": ");
+        w.number(lat_hist->percentile(0.50));
+        w.raw(",\n      \"p90\": ");
+        w.number(lat_hist->percentile(0.90));
+        w.raw(",\n      \"p99\": ");
+        w.number(lat_hist->percentile(0.99));
+        w.raw(",\n      \"p999\": ");
+        w.number(lat_hist->percentile(0.999));
+        w.raw(",\n      \"max\": ");
+        w.number(lat_hist->max());
+        w.raw("\n    }");
+    }
+    w.raw(",\n    \"breakdown\": {\n      \"l1HitCycles\": ");
+    w.number(timing.l1_hit_cycles);
+    w.raw(",\n      \"l2HitCycles\": ");
+    w.number(timing.l2_hit_cycles);
+    w.raw(",\n      \"l3HitCycles\": ");
+    w.number(timing.l3_hit_cycles);
+    w.raw(",\n      \"memoryCycles\": ");
+    w.number(timing.memory_cycles);
+    w.raw(",\n      \"tlbMissCycles\": ");
+    w.number(timing.tlb_miss_cycles);
+    w.raw("\n    },\n");
+    // MSHR / memory-level-parallelism accounting: what overlapping
+    // in-flight misses saves versus the serialized charge above
+    uint64_t overlap_saved =
+        timing.serialized_miss_cycles - timing.overlapped_miss_cycles;
+    double mlp = timing.overlapped_miss_cycles
+                     ? static_cast<double>(timing.serialized_miss_cycles) /
+                           timing.overlapped_miss_cycles
+                     : 1.0;
+    w.raw("    \"mshr\": {\n      \"entries\": ");
+    w.number(latency.mshr_entries);
+    w.raw(",\n      \"serializedMissCycles\": ");
+    w.number(timing.serialized_miss_cycles);
+    w.raw(",\n      \"overlappedMissCycles\": ");
+    w.number(timing.overlapped_miss_cycles);
+    w.raw(",\n      \"overlappedTotalCycles\": ");
+    w.number(timing.total_cycles - overlap_saved + timing.mshr_stall_cycles);
+    w.raw(",\n      \"merges\": ");
+    w.number(timing.mshr_merges);
+    w.raw(",\n      \"fullStalls\": ");
+    w.number(timing.mshr_full_stalls);
+    w.raw(",\n      \"fullStallCycles\": ");
+    w.number(timing.mshr_stall_cycles);
+    w.raw(",\n      \"memoryLevelParallelism\": ");
+    w.fixed(mlp, 2);
+    w.raw("\n    },\n");
+    // Writeback buffer accounting: dirty-eviction traffic after
+    // coalescing, and cycles lost only when a buffer was full
+    w.raw("    \"writebackBuffer\": {\n      \"entries\": ");
+    w.number(latency.writeback_entries);
+    w.raw(",\n      \"drained\": ");
+    w.number(timing.writebacks_drained);
+    w.raw(",\n      \"coalesced\": ");
+    w.number(timing.writebacks_coalesced);
+    w.raw(",\n      \"fullStalls\": ");
+    w.number(timing.writeback_full_stalls);
+    w.raw(",\n      \"fullStallCycles\": ");
+    w.number(timing.writeback_stall_cycles);
+    w.raw("\n    },\n");
+    // DRAM row-buffer accounting: open-page hits vs activates vs
+    // conflicts, and the row-aware cost versus the flat memory charge
+    uint64_t dram_accesses =
+        timing.dram_row_hits + timing.dram_row_empty + timing.dram_row_conflicts;
+    double row_hit_rate = dram_accesses
+                              ? static_cast<double>(timing.dram_row_hits) /
+                                    dram_accesses
+                              : 0.0;
+    w.raw("    \"dram\": {\n      \"channels\": ");
+    w.number(dram.channels);
+    w.raw(",\n      \"banks\": ");
+    w.number(dram.banks);
+    w.raw(",\n      \"rowSize\": ");
+    w.number(dram.row_size);
+    w.raw(",\n      \"rowHits\": ");
+    w.number(timing.dram_row_hits);
+    w.raw(",\n      \"rowEmpty\": ");
+    w.number(timing.dram_row_empty);
+    w.raw(",\n      \"rowConflicts\": ");
+    w.number(timing.dram_row_conflicts);
+    w.raw(",\n      \"rowHitRate\": ");
+    w.fixed(row_hit_rate, 3);
+    w.raw(",\n      \"dramCycles\": ");
+    w.number(timing.dram_cycles);
+    w.raw(",\n      \"flatMemoryCycles\": ");
+    w.number(timing.memory_cycles);
+    w.raw("\n    },\n");
+    // Page-walk accounting: walks after STLB misses, cycles spent on
+    // PTE fetches, and levels the paging-structure caches skipped
+    w.raw("    \"pageWalk\": {\n      \"walks\": ");
+    w.number(timing.page_walks);
+    w.raw(",\n      \"walkCycles\": ");
+    w.number(timing.page_walk_cycles);
+    w.raw(",\n      \"pwcSkippedLevels\": ");
+    w.number(timing.pwc_skipped_levels);
+    w.raw("\n    },\n");
+    w.raw("    \"latencyConfig\": {\n      \"l1Hit\": ");
+    w.number(latency.l1_hit);
+    w.raw(",\n      \"l2Hit\": ");
+    w.number(latency.l2_hit);
+    w.raw(",\n      \"l3Hit\": ");
+    w.number(latency.l3_hit);
+    w.raw(",\n      \"memory\": ");
+    w.number(latency.memory);
+    w.raw(",\n      \"tlbMissPenalty\": ");
+    w.number(latency.tlb_miss_penalty);
+    w.raw(",\n      \"stlbHit\": ");
+    w.number(latency.stlb_hit);
+    w.raw("\n    }\n  },\n");
+    w.flush(out);
+}
+
+// ========== Bandwidth / Roofline ==========
+
+void JsonOutput::write_bandwidth(std::ostream& out, const BandwidthStats& bw,
+                                 uint64_t total_cycles,
+                                 const BandwidthConfig& peak, bool has_l3) {
+    // A link above this fraction of its configured peak is considered
+    // saturated; below it on every link the run is latency-bound
+    constexpr double SATURATION_THRESHOLD = 0.7;
+
+    struct Link {
+        const char* key;
+        uint64_t bytes;
+        double peak_bpc;
+    };
+    Link links[3];
+    size_t n = 0;
+    links[n++] = {"l1l2", bw.l1_l2_bytes, peak.l1_l2};
+    if (has_l3)
+        links[n++] = {"l2l3", bw.l2_l3_bytes, peak.l2_l3};
+    links[n++] = {"memory", bw.l3_mem_bytes, peak.l3_mem};
+
+    const Link* worst = nullptr;
+    double worst_util = 0.0;
+
+    JsonWriter w(1024);
+    w.raw("  \"bandwidth\": {\n    \"links\": {\n");
+    for (size_t i = 0; i < n; i++) {
+        double achieved = BandwidthStats::bytes_per_cycle(links[i].bytes, total_cycles);
+        double util = links[i].peak_bpc > 0.0 ? achieved / links[i].peak_bpc : 0.0;
+        if (util > worst_util) {
+            worst_util = util;
+            worst = &links[i];
+        }
+        w.raw("      \"");
+        w.raw(links[i].key);
+        w.raw("\": {\"bytes\": ");
+        w.number(links[i].bytes);
+        w.raw(", \"achievedBytesPerCycle\": ");
+        w.fixed(achieved, 3);
+        w.raw(", \"peakBytesPerCycle\": ");
+        w.fixed(links[i].peak_bpc, 1);
+        w.raw(", \"utilization\": ");
+        w.fixed(util, 3);
+        w.raw(i + 1 < n ? "},\n" : "}\n");
+    }
+    w.raw("    },\n    \"verdict\": \"");
+    if (worst && worst_util >= SATURATION_THRESHOLD) {
+        w.raw("bandwidth-bound\",\n    \"saturatedLink\": \"");
+        w.raw(worst->key);
+        w.raw("\"\n  },\n");
+    } else {
+        w.raw("latency-bound\"\n  },\n");
+    }
+    w.flush(out);
 }
 
 void JsonOutput::write_timing_stats_multicore(std::ostream& out,
@@ -134,82 +461,118 @@ void JsonOutput::write_timing_stats_multicore(std::ostream& out,
     uint64_t total_accesses = l1_total.hits + l1_total.misses;
     double avg_latency = total_accesses > 0 ? static_cast<double>(total_cycles) / total_accesses : 0.0;
 
-    out << ",\"timing\":{"
-        << "\"totalCycles\":" << total_cycles << ","
-        << "\"avgLatency\":" << std::fixed << std::setprecision(2) << avg_latency << ","
-        << "\"breakdown\":{\"l1HitCycles\":" << l1_hit_cycles
-        << ",\"l2HitCycles\":" << l2_hit_cycles
-        << ",\"l3HitCycles\":" << l3_hit_cycles
-        << ",\"memoryCycles\":" << memory_cycles
-        << ",\"tlbMissCycles\":0},"
-        << "\"latencyConfig\":{"
-        << "\"l1Hit\":" << latency.l1_hit << ","
-        << "\"l2Hit\":" << latency.l2_hit << ","
-        << "\"l3Hit\":" << latency.l3_hit << ","
-        << "\"memory\":" << latency.memory << ","
-        << "\"tlbMissPenalty\":" << latency.tlb_miss_penalty
-        << "}}";
+    JsonWriter w(512);
+    w.raw(",\"timing\":{\"totalCycles\":");
+    w.number(total_cycles);
+    w.raw(",\"avgLatency\":");
+    w.fixed(avg_latency, 2);
+    w.raw(",\"breakdown\":{\"l1HitCycles\":");
+    w.number(l1_hit_cycles);
+    w.raw(",\"l2HitCycles\":");
+    w.number(l2_hit_cycles);
+    w.raw(",\"l3HitCycles\":");
+    w.number(l3_hit_cycles);
+    w.raw(",\"memoryCycles\":");
+    w.number(memory_cycles);
+    w.raw(",\"tlbMissCycles\":0},\"latencyConfig\":{\"l1Hit\":");
+    w.number(latency.l1_hit);
+    w.raw(",\"l2Hit\":");
+    w.number(latency.l2_hit);
+    w.raw(",\"l3Hit\":");
+    w.number(latency.l3_hit);
+    w.raw(",\"memory\":");
+    w.number(latency.memory);
+    w.raw(",\"tlbMissPenalty\":");
+    w.number(latency.tlb_miss_penalty);
+    w.raw("}}");
+    w.flush(out);
 }
 
 // ========== Hot Lines ==========
 
 void JsonOutput::write_hot_lines(std::ostream& out, const std::vector<SourceStats>& hot) {
-    out << "  \"hotLines\": [\n";
+    JsonWriter w(64 + hot.size() * 96);
+    w.raw("  \"hotLines\": [\n");
     for (size_t i = 0; i < hot.size(); i++) {
         const auto& h = hot[i];
-        out << "    {\"file\": \"" << escape(h.file) << "\", "
-            << "\"line\": " << h.line << ", "
-            << "\"hits\": " << h.hits << ", "
-            << "\"misses\": " << h.misses << ", "
-            << "\"missRate\": " << std::fixed << std::setprecision(3) << h.miss_rate() << "}"
-            << (i + 1 < hot.size() ? ",\n" : "\n");
+        w.raw("    {\"file\": \"");
+        w.escaped(h.file);
+        w.raw("\", \"line\": ");
+        w.number(h.line);
+        w.raw(", \"hits\": ");
+        w.number(h.hits);
+        w.raw(", \"misses\": ");
+        w.number(h.misses);
+        w.raw(", \"missRate\": ");
+        w.fixed(h.miss_rate(), 3);
+        w.raw(i + 1 < hot.size() ? "},\n" : "}\n");
     }
-    out << "  ],\n";
+    w.raw("  ],\n");
+    w.flush(out);
 }
 
 void JsonOutput::write_hot_lines_multicore(std::ostream& out,
                                            const std::vector<MultiCoreSourceStats>& hot) {
-    out << "  \"hotLines\": [\n";
+    JsonWriter w(64 + hot.size() * 112);
+    w.raw("  \"hotLines\": [\n");
     for (size_t i = 0; i < hot.size(); i++) {
         const auto& h = hot[i];
-        out << "    {\"file\": \"" << escape(h.file) << "\", "
-            << "\"line\": " << h.line << ", "
-            << "\"hits\": " << h.hits << ", "
-            << "\"misses\": " << h.misses << ", "
-            << "\"missRate\": " << std::fixed << std::setprecision(3) << h.miss_rate() << ", "
-            << "\"threads\": " << h.threads.size() << "}"
-            << (i + 1 < hot.size() ? ",\n" : "\n");
+        w.raw("    {\"file\": \"");
+        w.escaped(h.file);
+        w.raw("\", \"line\": ");
+        w.number(h.line);
+        w.raw(", \"hits\": ");
+        w.number(h.hits);
+        w.raw(", \"misses\": ");
+        w.number(h.misses);
+        w.raw(", \"missRate\": ");
+        w.fixed(h.miss_rate(), 3);
+        w.raw(", \"threads\": ");
+        w.number(static_cast<uint64_t>(h.threads.size()));
+        w.raw(i + 1 < hot.size() ? "},\n" : "}\n");
     }
-    out << "  ],\n";
+    w.raw("  ],\n");
+    w.flush(out);
 }
 
 // ========== Optimization Suggestions ==========
 
 void JsonOutput::write_suggestions(std::ostream& out,
                                    const std::vector<OptimizationSuggestion>& suggestions) {
-    out << "  \"suggestions\": [\n";
+    JsonWriter w(64 + suggestions.size() * 256);
+    w.raw("  \"suggestions\": [\n");
     for (size_t i = 0; i < suggestions.size(); i++) {
         const auto& s = suggestions[i];
-        out << "    {\"type\": \"" << s.type << "\", "
-            << "\"severity\": \"" << s.severity << "\", "
-            << "\"location\": \"" << escape(s.location) << "\", "
-            << "\"message\": \"" << escape(s.message) << "\", "
-            << "\"fix\": \"" << escape(s.fix) << "\"}"
-            << (i + 1 < suggestions.size() ? ",\n" : "\n");
+        w.raw("    {\"type\": \"");
+        w.raw(s.type);
+        w.raw("\", \"severity\": \"");
+        w.raw(s.severity);
+        w.raw("\", \"location\": \"");
+        w.escaped(s.location);
+        w.raw("\", \"message\": \"");
+        w.escaped(s.message);
+        w.raw("\", \"fix\": \"");
+        w.escaped(s.fix);
+        w.raw(i + 1 < suggestions.size() ? "\"},\n" : "\"}\n");
     }
-    out << "  ]";
+    w.raw("  ]");
+    w.flush(out);
 }
 
 // ========== False Sharing ==========
 
 void JsonOutput::write_false_sharing(std::ostream& out,
                                      const std::vector<FalseSharingReport>& reports) {
-    out << "  \"falseSharing\": [\n";
+    JsonWriter w(64 + reports.size() * 512);
+    w.stream_to(out);
+    w.raw("  \"falseSharing\": [\n");
     for (size_t i = 0; i < reports.size(); i++) {
         const auto& fs = reports[i];
-        out << "    {\"cacheLineAddr\": \"0x" << std::hex << fs.cache_line_addr << std::dec << "\", "
-            << "\"accessCount\": " << fs.accesses.size() << ", "
-            << "\"accesses\": [";
+        w.raw("    {\"cacheLineAddr\": \"0x");
+        w.hex(fs.cache_line_addr);
+        w.raw("\", \"accessCount\": ");
+        w.number(static_cast<uint64_t>(fs.accesses.size()));
+        w.raw(", \"accesses\": [");
 
         // Group accesses by thread for cleaner output
         std::unordered_map<uint32_t, std::vector<const FalseSharingEvent*>> by_thread;
@@ -219,88 +582,292 @@ void JsonOutput::write_false_sharing(std::ostream& out,
 
         bool first_thread = true;
         for (const auto& [tid, thread_accesses] : by_thread) {
-            if (!first_thread) out << ", ";
+            if (!first_thread) w.raw(", ");
             first_thread = false;
 
             // Show first access per thread
             const auto& a = *thread_accesses[0];
-            out << "{\"threadId\": " << tid << ", "
-                << "\"offset\": " << a.byte_offset << ", "
-                << "\"isWrite\": " << (a.is_write ? "true" : "false") << ", "
-                << "\"file\": \"" << escape(a.file) << "\", "
-                << "\"line\": " << a.line << ", "
-                << "\"count\": " << thread_accesses.size() << "}";
+            w.raw("{\"threadId\": ");
+            w.number(tid);
+            w.raw(", \"offset\": ");
+            w.number(a.byte_offset);
+            w.raw(", \"isWrite\": ");
+            w.boolean(a.is_write);
+            w.raw(", \"file\": \"");
+            w.escaped(a.file);
+            w.raw("\", \"line\": ");
+            w.number(a.line);
+            w.raw(", \"count\": ");
+            w.number(static_cast<uint64_t>(thread_accesses.size()));
+            w.raw("}");
         }
-        out << "]}"
-            << (i + 1 < reports.size() ? ",\n" : "\n");
+        w.raw(i + 1 < reports.size() ? "]},\n" : "]}\n");
     }
-    out << "  ],\n";
+    w.raw("  ],\n");
+    w.flush(out);
 }
 
 void JsonOutput::write_false_sharing_compact(std::ostream& out,
                                              const std::vector<FalseSharingReport>& reports) {
-    out << ",\"falseSharing\":[";
+    JsonWriter w(32 + reports.size() * 48);
+    w.raw(",\"falseSharing\":[");
     for (size_t i = 0; i < reports.size(); i++) {
-        if (i > 0) out << ",";
+        if (i > 0) w.raw(',');
         const auto& fs = reports[i];
-        out << "{\"addr\":\"0x" << std::hex << fs.cache_line_addr << std::dec << "\""
-            << ",\"accesses\":" << fs.accesses.size() << "}";
+        w.raw("{\"addr\":\"0x");
+        w.hex(fs.cache_line_addr);
+        w.raw("\",\"accesses\":");
+        w.number(static_cast<uint64_t>(fs.accesses.size()));
+        w.raw("}");
     }
-    out << "]";
+    w.raw("]");
+    w.flush(out);
 }
 
 // ========== Prefetch Statistics ==========
 
 void JsonOutput::write_prefetch_stats(std::ostream& out, std::string_view policy_name,
                                       int degree, const PrefetchStats& stats) {
-    out << ",\n  \"prefetch\": {\n"
-        << "    \"policy\": \"" << policy_name << "\",\n"
-        << "    \"degree\": " << degree << ",\n"
-        << "    \"issued\": " << stats.prefetches_issued << ",\n"
-        << "    \"useful\": " << stats.prefetches_useful << ",\n"
-        << "    \"accuracy\": " << std::fixed << std::setprecision(3) << stats.accuracy() << "\n"
-        << "  }";
+    JsonWriter w(256);
+    w.raw(",\n  \"prefetch\": {\n    \"policy\": \"");
+    w.raw(policy_name);
+    w.raw("\",\n    \"degree\": ");
+    w.number(degree);
+    w.raw(",\n    \"issued\": ");
+    w.number(stats.prefetches_issued);
+    w.raw(",\n    \"useful\": ");
+    w.number(stats.prefetches_useful);
+    w.raw(",\n    \"accuracy\": ");
+    w.fixed(stats.accuracy(), 3);
+    w.raw("\n  }");
+    w.flush(out);
+}
+
+void JsonOutput::write_throttle(std::ostream& out, const Prefetcher& pf) {
+    const auto& timeline = pf.get_throttle_timeline();
+    JsonWriter w(64 + timeline.size() * 64);
+    w.raw("{\"finalDegree\":");
+    w.number(pf.get_degree());
+    w.raw(",\"timeline\":[");
+    for (size_t i = 0; i < timeline.size(); i++) {
+        if (i) w.raw(',');
+        w.raw("{\"issued\":");
+        w.number(timeline[i].issued);
+        w.raw(",\"accuracy\":");
+        w.fixed(timeline[i].accuracy, 3);
+        w.raw(",\"degree\":");
+        w.number(timeline[i].degree);
+        w.raw("}");
+    }
+    w.raw("]}");
+    w.flush(out);
 }
 
 // ========== Cache Configuration ==========
 
 void JsonOutput::write_cache_config(std::ostream& out, const CacheHierarchyConfig& cfg) {
-    out << "  \"cacheConfig\": {\n";
-    out << "    \"l1d\": {\"sizeKB\": " << cfg.l1_data.kb_size
-        << ", \"assoc\": " << cfg.l1_data.associativity
-        << ", \"lineSize\": " << cfg.l1_data.line_size
-        << ", \"sets\": " << cfg.l1_data.num_sets() << "},\n";
-    out << "    \"l1i\": {\"sizeKB\": " << cfg.l1_inst.kb_size
-        << ", \"assoc\": " << cfg.l1_inst.associativity
-        << ", \"lineSize\": " << cfg.l1_inst.line_size
-        << ", \"sets\": " << cfg.l1_inst.num_sets() << "},\n";
-    out << "    \"l2\": {\"sizeKB\": " << cfg.l2.kb_size
-        << ", \"assoc\": " << cfg.l2.associativity
-        << ", \"lineSize\": " << cfg.l2.line_size
-        << ", \"sets\": " << cfg.l2.num_sets() << "},\n";
-    out << "    \"l3\": {\"sizeKB\": " << cfg.l3.kb_size
-        << ", \"assoc\": " << cfg.l3.associativity
-        << ", \"lineSize\": " << cfg.l3.line_size
-        << ", \"sets\": " << cfg.l3.num_sets() << "}\n";
-    out << "  },\n";
+    auto level = [](JsonWriter& w, const char* name, const CacheConfig& c, bool last) {
+        w.raw("    \"");
+        w.raw(name);
+        w.raw("\": {\"sizeKB\": ");
+        w.number(c.kb_size);
+        w.raw(", \"assoc\": ");
+        w.number(c.associativity);
+        w.raw(", \"lineSize\": ");
+        w.number(c.line_size);
+        w.raw(", \"sets\": ");
+        w.number(c.num_sets());
+        w.raw(last ? "}\n" : "},\n");
+    };
+    JsonWriter w(512);
+    w.raw("  \"cacheConfig\": {\n");
+    level(w, "l1d", cfg.l1_data, false);
+    level(w, "l1i", cfg.l1_inst, false);
+    level(w, "l2", cfg.l2, false);
+    level(w, "l3", cfg.l3, true);
+    w.raw("  },\n");
+    w.flush(out);
+}
+
+// ========== Reuse Distance / Miss-Ratio Curve ==========
+
+void JsonOutput::write_mrc(std::ostream& out, const ReuseDistanceAnalyzer& mrc,
+                           uint32_t line_size) {
+    auto curve = mrc.miss_ratio_curve(line_size);
+    JsonWriter w(256 + curve.size() * 80);
+    w.raw("  \"mrc\": {\n    \"lineSize\": ");
+    w.number(line_size);
+    w.raw(",\n    \"totalAccesses\": ");
+    w.number(mrc.total_accesses());
+    w.raw(",\n    \"distinctLines\": ");
+    w.number(mrc.distinct_lines());
+    w.raw(",\n    \"coldMisses\": ");
+    w.number(mrc.cold_misses());
+    w.raw(",\n    \"curve\": [");
+    for (size_t i = 0; i < curve.size(); i++) {
+        w.raw(i == 0 ? "\n" : ",\n");
+        w.raw("      {\"bytes\": ");
+        w.number(curve[i].cache_bytes);
+        w.raw(", \"misses\": ");
+        w.number(curve[i].misses);
+        w.raw(", \"missRatio\": ");
+        w.fixed(curve[i].miss_ratio, 3);
+        w.raw("}");
+    }
+    w.raw("\n    ]\n  },\n");
+    w.flush(out);
+}
+
+// ========== Belady OPT Comparison ==========
+
+static const char* eviction_policy_name(EvictionPolicy policy) {
+    switch (policy) {
+        case EvictionPolicy::LRU: return "lru";
+        case EvictionPolicy::PLRU: return "plru";
+        case EvictionPolicy::RANDOM: return "random";
+        case EvictionPolicy::SRRIP: return "srrip";
+        case EvictionPolicy::BRRIP: return "brrip";
+        case EvictionPolicy::DRRIP: return "drrip";
+        case EvictionPolicy::OPT: return "opt";
+    }
+    return "unknown";
+}
+
+void JsonOutput::write_opt_comparison(std::ostream& out,
+                                      const CacheHierarchyConfig& cfg,
+                                      const CacheStats& achieved_l1,
+                                      const CacheStats& achieved_l2,
+                                      const CacheStats& achieved_l3,
+                                      const CacheStats& opt_l1,
+                                      const CacheStats& opt_l2,
+                                      const CacheStats& opt_l3) {
+    JsonWriter w(512);
+    auto level = [&w](const char* name, EvictionPolicy policy,
+                      const CacheStats& achieved, const CacheStats& opt,
+                      bool last) {
+        w.raw("    \"");
+        w.raw(name);
+        w.raw("\": {\"policy\": \"");
+        w.raw(eviction_policy_name(policy));
+        w.raw("\", \"achievedHitRate\": ");
+        w.fixed(achieved.hit_rate(), 3);
+        w.raw(", \"optHitRate\": ");
+        w.fixed(opt.hit_rate(), 3);
+        w.raw(", \"headroom\": ");
+        w.fixed(opt.hit_rate() - achieved.hit_rate(), 3);
+        w.raw(last ? "}\n" : "},\n");
+    };
+    w.raw("  \"beladyOpt\": {\n");
+    level("l1", cfg.l1_data.policy, achieved_l1, opt_l1, false);
+    level("l2", cfg.l2.policy, achieved_l2, opt_l2, false);
+    level("l3", cfg.l3.policy, achieved_l3, opt_l3, true);
+    w.raw("  },\n");
+    w.flush(out);
 }
 
 // ========== Coherence Statistics ==========
 
 void JsonOutput::write_coherence_stats(std::ostream& out, uint64_t invalidations,
                                        uint64_t false_sharing_events) {
-    out << "  \"coherence\": {\n";
-    out << "    \"invalidations\": " << invalidations << ",\n";
-    out << "    \"falseSharingEvents\": " << false_sharing_events << "\n";
-    out << "  },\n";
+    JsonWriter w(128);
+    w.raw("  \"coherence\": {\n    \"invalidations\": ");
+    w.number(invalidations);
+    w.raw(",\n    \"falseSharingEvents\": ");
+    w.number(false_sharing_events);
+    w.raw("\n  },\n");
+    w.flush(out);
 }
 
 // ========== Streaming Mode Messages ==========
 
 void JsonOutput::write_stream_start(std::ostream& out, std::string_view config_name,
                                     bool multicore) {
-    out << "{\"type\":\"start\",\"config\":\"" << config_name
-        << "\",\"multicore\":" << (multicore ? "true" : "false") << "}\n" << std::flush;
+    JsonWriter w(128);
+    w.raw("{\"type\":\"start\",\"config\":\"");
+    w.raw(config_name);
+    w.raw("\",\"multicore\":");
+    w.boolean(multicore);
+    w.raw("}\n");
+    w.flush(out);
+    out << std::flush;
+}
+
+void JsonOutput::write_intervals(std::ostream& out, const IntervalSeries& series,
+                                 const CacheHierarchyConfig& cfg) {
+    // ~12 digits per value across eleven columns
+    JsonWriter w(384 + series.size() * 144);
+    auto column = [&w](const char* name, const std::vector<uint64_t>& values,
+                       bool last) {
+        w.raw("    \"");
+        w.raw(name);
+        w.raw("\": [");
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0) w.raw(',');
+            w.number(values[i]);
+        }
+        w.raw(last ? "]\n" : "],\n");
+    };
+    w.raw("  \"intervals\": {\n    \"granularity\": ");
+    w.number(series.granularity());
+    w.raw(",\n");
+    column("events", series.events, false);
+    column("l1dHits", series.l1d_hits, false);
+    column("l1dMisses", series.l1d_misses, false);
+    column("l2Hits", series.l2_hits, false);
+    column("l2Misses", series.l2_misses, false);
+    column("l3Hits", series.l3_hits, false);
+    column("l3Misses", series.l3_misses, false);
+    column("invalidations", series.invalidations, false);
+    column("prefetchIssued", series.prefetch_issued, false);
+    column("prefetchUseful", series.prefetch_useful, false);
+    column("wssLines", series.wss_lines, false);
+    // Level capacities in lines, so the WSS column plots straight
+    // against the boundaries where the hit rate falls off
+    uint64_t line_size = cfg.l1_data.line_size ? cfg.l1_data.line_size : 64;
+    w.raw("    \"capacityLines\": {\"l1d\": ");
+    w.number(cfg.l1_data.kb_size * 1024 / line_size);
+    w.raw(", \"l2\": ");
+    w.number(cfg.l2.kb_size * 1024 / line_size);
+    w.raw(", \"l3\": ");
+    w.number(cfg.l3.kb_size * 1024 / line_size);
+    w.raw("}\n  },\n");
+    w.flush(out);
+}
+
+void JsonOutput::write_stats_snapshot(std::ostream& out, uint64_t events,
+                                      const CacheStats& l1d_delta,
+                                      const CacheStats& l2_delta,
+                                      const CacheStats& l3_delta,
+                                      const std::vector<HotLineBrief>& hot) {
+    JsonWriter w(256 + hot.size() * 80);
+    w.raw("{\"type\":\"stats\",\"events\":");
+    w.number(events);
+    auto level = [&w](const char* name, const CacheStats& d) {
+        w.raw(",\"");
+        w.raw(name);
+        w.raw("\":{\"hits\":");
+        w.number(d.hits);
+        w.raw(",\"misses\":");
+        w.number(d.misses);
+        w.raw("}");
+    };
+    level("l1d", l1d_delta);
+    level("l2", l2_delta);
+    level("l3", l3_delta);
+    w.raw(",\"hotLines\":[");
+    for (size_t i = 0; i < hot.size(); i++) {
+        if (i > 0) w.raw(',');
+        w.raw("{\"file\":\"");
+        w.escaped(hot[i].file);
+        w.raw("\",\"line\":");
+        w.number(hot[i].line);
+        w.raw(",\"misses\":");
+        w.number(hot[i].misses);
+        w.raw("}");
+    }
+    w.raw("]}\n");
+    w.flush(out);
+    out << std::flush;
 }
 
 void JsonOutput::write_stream_progress(std::ostream& out, size_t event_count,
@@ -308,26 +875,47 @@ void JsonOutput::write_stream_progress(std::ostream& out, size_t event_count,
                                        const CacheStats& l2, const CacheStats& l3,
                                        uint64_t coherence_invalidations,
                                        const std::vector<TimelineEvent>& timeline) {
-    out << "{\"type\":\"progress\""
-        << ",\"events\":" << event_count
-        << ",\"threads\":" << thread_count
-        << ",\"l1d\":{\"hits\":" << l1_total.hits << ",\"misses\":" << l1_total.misses << "}"
-        << ",\"l2\":{\"hits\":" << l2.hits << ",\"misses\":" << l2.misses << "}"
-        << ",\"l3\":{\"hits\":" << l3.hits << ",\"misses\":" << l3.misses << "}"
-        << ",\"coherence\":" << coherence_invalidations
-        << ",\"timeline\":[";
+    JsonWriter w(256 + timeline.size() * 96);
+    w.raw("{\"type\":\"progress\",\"events\":");
+    w.number(static_cast<uint64_t>(event_count));
+    w.raw(",\"threads\":");
+    w.number(static_cast<uint64_t>(thread_count));
+    w.raw(",\"l1d\":{\"hits\":");
+    w.number(l1_total.hits);
+    w.raw(",\"misses\":");
+    w.number(l1_total.misses);
+    w.raw("},\"l2\":{\"hits\":");
+    w.number(l2.hits);
+    w.raw(",\"misses\":");
+    w.number(l2.misses);
+    w.raw("},\"l3\":{\"hits\":");
+    w.number(l3.hits);
+    w.raw(",\"misses\":");
+    w.number(l3.misses);
+    w.raw("},\"coherence\":");
+    w.number(coherence_invalidations);
+    w.raw(",\"timeline\":[");
 
     for (size_t i = 0; i < timeline.size(); i++) {
-        if (i > 0) out << ",";
+        if (i > 0) w.raw(',');
         const auto& e = timeline[i];
-        out << "{\"i\":" << e.index
-            << ",\"t\":\"" << (e.is_icache ? "I" : (e.is_write ? "W" : "R")) << "\""
-            << ",\"l\":" << e.hit_level
-            << ",\"a\":" << e.address;
+        w.raw("{\"i\":");
+        w.number(static_cast<uint64_t>(e.index));
+        w.raw(",\"t\":\"");
+        w.raw(e.is_icache ? "I" : (e.is_write ? "W" : "R"));
+        w.raw("\",\"l\":");
+        w.number(e.hit_level);
+        w.raw(",\"a\":");
+        w.number(e.address);
         if (!e.file.empty()) {
-            out << ",\"f\":\"" << escape(e.file) << "\",\"n\":" << e.line;
+            w.raw(",\"f\":\"");
+            w.escaped(e.file);
+            w.raw("\",\"n\":");
+            w.number(e.line);
         }
-        out << "}";
+        w.raw("}");
     }
-    out << "]}\n" << std::flush;
+    w.raw("]}\n");
+    w.flush(out);
+    out << std::flush;
 }
@@ -1,14 +1,20 @@
 #include "include/MultiCoreCacheSystem.hpp"
+#include "include/FileTable.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <thread>
 
 MultiCoreCacheSystem::MultiCoreCacheSystem(int cores, const CacheConfig &l1_cfg,
                                            const CacheConfig &l2_cfg,
                                            const CacheConfig &l3_cfg,
                                            PrefetchPolicy pf_policy,
-                                           int pf_degree)
+                                           int pf_degree,
+                                           CoherenceMode coherence_mode,
+                                           CoherenceProtocol protocol)
     : num_cores(cores), l2(l2_cfg),
       l3_(l3_cfg.is_valid() ? std::optional<CacheLevel>(l3_cfg) : std::nullopt),
-      coherence(cores),
+      coherence(cores, coherence_mode, protocol),
       prefetch_policy(pf_policy), prefetch_degree(pf_degree),
       line_size(l1_cfg.line_size) {
   for (int i = 0; i < cores; i++) {
@@ -18,7 +24,9 @@ MultiCoreCacheSystem::MultiCoreCacheSystem(int cores, const CacheConfig &l1_cfg,
     prefetchers.push_back(
         std::make_unique<Prefetcher>(pf_policy, pf_degree, l1_cfg.line_size));
     // Each core gets its own DTLB (64 entries, 4-way, 4KB pages)
+    // backed by a unified second-level TLB
     dtlbs.push_back(std::make_unique<TLB>(TLBConfig{64, 4, 4096}));
+    stlbs.push_back(std::make_unique<TLB>(TLBConfig{1536, 8, 4096}));
     // Each core tracks its own prefetched addresses for usefulness measurement
     prefetched_addresses_per_core.emplace_back();
   }
@@ -29,7 +37,31 @@ int MultiCoreCacheSystem::get_core_for_thread(uint32_t thread_id) {
   if (it != thread_to_core.end()) {
     return it->second;
   }
-  int core = next_core % num_cores;
+  // Explicit pins win over the policy and don't consume a policy slot
+  auto pin = pinned_threads.find(thread_id);
+  if (pin != pinned_threads.end()) {
+    thread_to_core[thread_id] = pin->second;
+    return pin->second;
+  }
+  int slot = next_core % num_cores;
+  // The LLC domain size: one CCX under CCX topology, one socket under
+  // NUMA, the whole chip otherwise (where compact and scatter coincide)
+  int domain = ccx_size > 0 ? ccx_size
+               : num_sockets > 1 ? num_cores / num_sockets
+                                 : num_cores;
+  int num_domains = num_cores / domain;
+  int core;
+  if (thread_placement == ThreadPlacement::Compact) {
+    // Fill each domain before spilling to the next, so co-scheduled
+    // threads share an L3 slice - matching OMP_PROC_BIND=close.
+    core = slot;
+  } else {
+    // Scatter: spread threads breadth-first across domains (thread n
+    // lands on domain n % num_domains) so each thread gets its own L3
+    // slice before any domain doubles up - matching how the OS
+    // scheduler spreads load across LLC domains.
+    core = (slot % num_domains) * domain + (slot / num_domains);
+  }
   thread_to_core[thread_id] = core;
   next_core++;
   return core;
@@ -48,15 +80,9 @@ void MultiCoreCacheSystem::issue_prefetches(int core, uint64_t miss_addr,
     if (l1_caches[core]->is_present(line_addr))
       continue;
 
-    // Prefetch into L1 with appropriate coherence state
-    // Check other caches for coherence
-    bool others_have_it = false;
-    for (int other = 0; other < num_cores; other++) {
-      if (other != core && l1_caches[other]->is_present(line_addr)) {
-        others_have_it = true;
-        break;
-      }
-    }
+    // Prefetch into L1 with appropriate coherence state; the snoop filter
+    // answers "does anyone else have it" without probing every core
+    bool others_have_it = coherence.has_remote_sharers(core, line_addr);
 
     // Install prefetched line as Shared (if others have it) or Exclusive
     CoherenceState pf_state =
@@ -64,45 +90,307 @@ void MultiCoreCacheSystem::issue_prefetches(int core, uint64_t miss_addr,
 
     // Fetch into L2/L3 if needed, then L1
     if (!l2.is_present(line_addr)) {
-      if (has_l3()) {
-        l3_->access(line_addr, false);
+      if (CacheLevel *l3 = l3_for_core(core)) {
+        l3->access(line_addr, false);
       }
       l2.install(line_addr, false);
     }
-    l1_caches[core]->install_with_state(line_addr, pf_state);
+    auto pf_info = l1_caches[core]->install_with_state(line_addr, pf_state);
+    shadow_note_eviction(core, pf_info);
+    shadow_update(core, line_addr, pf_state);
+    coherence.add_sharer(core, line_addr);
 
     // Track this address as prefetched for usefulness measurement
     prefetched_addresses_per_core[core].insert(line_addr);
   }
 }
 
+void MultiCoreCacheSystem::build_l3_slices(int cores_per_slice) {
+  if (!l3_.has_value()) {
+    return;
+  }
+  CacheConfig slice_cfg = l3_->get_config();
+  int num_slices = num_cores / cores_per_slice;
+  for (int s = 0; s < num_slices; s++) {
+    l3_slices.push_back(std::make_unique<CacheLevel>(slice_cfg));
+  }
+  cores_per_l3_slice = cores_per_slice;
+  l3_.reset();
+}
+
+void MultiCoreCacheSystem::enable_numa(int sockets, NumaPlacement placement) {
+  if (sockets < 2 || num_cores % sockets != 0) {
+    return;  // sockets must divide the core count
+  }
+  num_sockets = sockets;
+  numa_placement = placement;
+  // The shared L3 becomes one private slice per socket, each with the
+  // preset's full L3 geometry (a dual-socket Xeon has two whole L3s).
+  // If CCX topology already sliced the L3, keep the finer CCX slices -
+  // sockets then only govern page placement.
+  if (l3_slices.empty()) {
+    build_l3_slices(num_cores / sockets);
+  }
+}
+
+void MultiCoreCacheSystem::enable_ccx_topology(int cores_per_ccx) {
+  if (cores_per_ccx < 1 || num_cores % cores_per_ccx != 0 ||
+      cores_per_ccx >= num_cores || !l3_slices.empty()) {
+    return;  // CCXes must divide the core count; one CCX is just shared L3
+  }
+  ccx_size = cores_per_ccx;
+  build_l3_slices(cores_per_ccx);
+}
+
+void MultiCoreCacheSystem::record_numa_access(int core, uint64_t address,
+                                              std::string_view file,
+                                              uint32_t line) {
+  if (num_sockets < 2) {
+    return;
+  }
+  int socket = socket_of_core(core);
+  uint64_t page = address / NUMA_PAGE_SIZE;
+  int home;
+  if (numa_placement == NumaPlacement::Interleave) {
+    home = static_cast<int>(page % num_sockets);
+  } else {
+    // First touch: the first socket to fault a page becomes its home
+    home = page_home.emplace(page, socket).first->second;
+  }
+  bool remote = home != socket;
+  if (remote) {
+    numa_remote++;
+  } else {
+    numa_local++;
+  }
+  uint64_t key =
+      (static_cast<uint64_t>(FileTable::instance().intern(file)) << 32) | line;
+  auto &counts = numa_by_line[key];
+  if (remote) {
+    counts.remote++;
+  } else {
+    counts.local++;
+  }
+}
+
+NumaStats MultiCoreCacheSystem::get_numa_stats() const {
+  NumaStats stats;
+  stats.sockets = num_sockets;
+  stats.placement = numa_placement;
+  stats.local_accesses = numa_local;
+  stats.remote_accesses = numa_remote;
+  return stats;
+}
+
+std::vector<NumaLineStat>
+MultiCoreCacheSystem::get_numa_hot_lines(size_t limit) const {
+  std::vector<NumaLineStat> lines;
+  lines.reserve(numa_by_line.size());
+  for (const auto &[key, counts] : numa_by_line) {
+    lines.push_back({FileTable::instance().view_of(
+                         static_cast<uint32_t>(key >> 32)),
+                     static_cast<uint32_t>(key), counts.local, counts.remote});
+  }
+  // Worst cross-socket offenders first
+  std::sort(lines.begin(), lines.end(),
+            [](const NumaLineStat &a, const NumaLineStat &b) {
+              return a.remote > b.remote;
+            });
+  if (lines.size() > limit) {
+    lines.resize(limit);
+  }
+  return lines;
+}
+
 void MultiCoreCacheSystem::track_access_for_false_sharing(
     uint64_t addr, uint32_t thread_id, bool is_write, std::string_view file,
     uint32_t line) {
   uint64_t line_addr = get_line_address(addr);
   uint32_t byte_offset = addr & (line_size - 1);
 
-  auto &accesses = line_accesses[line_addr];
-  accesses.push_back({thread_id, byte_offset, is_write, std::string(file), line});
-
-  std::unordered_set<uint32_t> threads_seen;
-  std::unordered_set<uint32_t> offsets_seen;
-  bool has_write = false;
+  if (line_trackers.size() >= false_sharing_line_budget &&
+      !line_trackers.count(line_addr)) {
+    // Budget reached: recycle a tracker from a line that hasn't been
+    // flagged. Flagged lines keep their evidence for the report.
+    auto it = line_trackers.begin();
+    while (it != line_trackers.end() && false_sharing_lines.count(it->first))
+      ++it;
+    if (it == line_trackers.end())
+      return;  // every tracked line is flagged - nothing safe to recycle
+    line_trackers.erase(it);
+  }
 
-  for (const auto &a : accesses) {
-    threads_seen.insert(a.thread_id);
-    offsets_seen.insert(a.byte_offset);
-    if (a.is_write)
-      has_write = true;
+  auto &tracker = line_trackers[line_addr];
+  if (tracker.total_accesses == 0) {
+    tracker.first_thread = thread_id;
+    tracker.first_offset = byte_offset;
+  } else {
+    if (thread_id != tracker.first_thread)
+      tracker.saw_second_thread = true;
+    if (byte_offset != tracker.first_offset)
+      tracker.saw_second_offset = true;
+  }
+  if (is_write)
+    tracker.has_write = true;
+  tracker.total_accesses++;
+
+  LineAccess access{thread_id, byte_offset, is_write,
+                    FileTable::instance().intern(file), line};
+  if (tracker.sample_count < FALSE_SHARING_SAMPLES) {
+    tracker.samples[tracker.sample_count++] = access;
+  } else {
+    // Reservoir sampling: slot i keeps each access with probability K/n
+    uint64_t slot = std::rand() % tracker.total_accesses;
+    if (slot < FALSE_SHARING_SAMPLES)
+      tracker.samples[slot] = access;
   }
 
-  if (threads_seen.size() > 1 && offsets_seen.size() > 1 && has_write) {
+  if (tracker.saw_second_thread && tracker.saw_second_offset &&
+      tracker.has_write) {
     if (false_sharing_lines.insert(line_addr).second) {
       false_sharing_count++;
     }
   }
 }
 
+void MultiCoreCacheSystem::adopt_line_for_memo(uint64_t line_addr) {
+  if (line_states.size() >= COHERENCE_MEMO_LINE_BUDGET &&
+      !line_states.count(line_addr))
+    return;
+  uint64_t packed = 0;
+  for (int c = 0; c < num_cores; c++) {
+    packed = CoherenceMemo::set_nibble(
+        packed, c, l1_caches[c]->get_coherence_state(line_addr));
+  }
+  line_states[line_addr] = packed;
+}
+
+SnoopResult MultiCoreCacheSystem::snoop_read(int core, uint64_t line_addr) {
+  auto it = memo_active() ? line_states.find(line_addr) : line_states.end();
+  bool tracked = it != line_states.end();
+  uint64_t packed = 0;
+  if (tracked) {
+    // The requester's own copy never participates in a snoop; masking its
+    // nibble lets transitions that differ only there share a memo entry
+    packed = CoherenceMemo::clear_nibble(it->second, core);
+    if (const CoherenceTransition *t =
+            coherence_memo.lookup(packed, false, core)) {
+      // Replay the recorded peer effects without probing anyone. Every
+      // state change a read snoop causes (M->S downgrade, M->Owned under
+      // MOESI, Forward->S under MESIF) is a set_coherence_state, which
+      // also syncs the dirty bit the slow path's writeback extraction
+      // would have cleared.
+      uint64_t diff = t->peer_states ^ t->new_peer_states;
+      while (diff) {
+        int c = __builtin_ctzll(diff) / 4;
+        diff &= ~(0xFULL << (c * 4));
+        l1_caches[c]->set_coherence_state(
+            line_addr, CoherenceMemo::nibble_state(t->new_peer_states, c));
+      }
+      coherence.apply_memoized(
+          line_addr,
+          CoherenceMemo::present_mask(t->new_peer_states) | (1ULL << core),
+          t->snoop_writebacks, t->dirty_shares, t->forwards);
+      it->second = CoherenceMemo::set_nibble(
+          t->new_peer_states, core, CoherenceMemo::nibble_state(it->second, core));
+      return {t->found, t->was_modified, t->data_source_core};
+    }
+  }
+
+  // Full path: snoop, then apply the owner-side fixup the result implies
+  auto snoop = coherence.request_read(core, line_addr);
+  if (snoop.was_modified) {
+    if (coherence.get_protocol() == CoherenceProtocol::MOESI) {
+      // Owner keeps the dirty line in Owned and supplies data
+      // cache-to-cache; the writeback it would otherwise take here is
+      // charged when the Owned line is eventually evicted
+      l1_caches[snoop.data_source_core]->set_coherence_state(
+          line_addr, CoherenceState::Owned);
+    } else {
+      // Downgrade the owner's line from M to S
+      l1_caches[snoop.data_source_core]->downgrade_to_shared(line_addr);
+    }
+  }
+
+  if (tracked) {
+    // Observe what the transition did to each peer the snapshot named and
+    // memoize it; the next identical snapshot replays from the table
+    uint64_t after = 0;
+    for (uint64_t rest = packed; rest;) {
+      int c = __builtin_ctzll(rest) / 4;
+      rest &= ~(0xFULL << (c * 4));
+      after = CoherenceMemo::set_nibble(
+          after, c, l1_caches[c]->get_coherence_state(line_addr));
+    }
+    bool moesi = coherence.get_protocol() == CoherenceProtocol::MOESI;
+    bool mesif = coherence.get_protocol() == CoherenceProtocol::MESIF;
+    CoherenceTransition t;
+    t.peer_states = packed;
+    t.new_peer_states = after;
+    t.op_core = CoherenceMemo::pack_op(false, core);
+    t.found = snoop.found;
+    t.was_modified = snoop.was_modified;
+    t.data_source_core = static_cast<uint8_t>(snoop.data_source_core);
+    t.snoop_writebacks = (snoop.was_modified && !moesi) ? 1 : 0;
+    t.dirty_shares = (snoop.was_modified && moesi) ? 1 : 0;
+    t.forwards = (mesif && snoop.found && !snoop.was_modified) ? 1 : 0;
+    t.valid = true;
+    coherence_memo.insert(t);
+    it->second = CoherenceMemo::set_nibble(
+        after, core, CoherenceMemo::nibble_state(it->second, core));
+  } else if (memo_active() && snoop.found) {
+    adopt_line_for_memo(line_addr);
+  }
+  return snoop;
+}
+
+SnoopResult MultiCoreCacheSystem::snoop_exclusive(int core,
+                                                  uint64_t line_addr) {
+  auto it = memo_active() ? line_states.find(line_addr) : line_states.end();
+  bool tracked = it != line_states.end();
+  uint64_t packed = 0;
+  if (tracked) {
+    packed = CoherenceMemo::clear_nibble(it->second, core);
+    if (const CoherenceTransition *t =
+            coherence_memo.lookup(packed, true, core)) {
+      // Every peer the snapshot names holds a copy; invalidate them all
+      // exactly as request_exclusive() would, minus the probes
+      for (uint64_t rest = packed; rest;) {
+        int c = __builtin_ctzll(rest) / 4;
+        rest &= ~(0xFULL << (c * 4));
+        l1_caches[c]->invalidate(line_addr);
+      }
+      coherence.apply_memoized(line_addr, 1ULL << core, 0, 0, 0);
+      it->second = CoherenceMemo::set_nibble(
+          0, core, CoherenceMemo::nibble_state(it->second, core));
+      return {t->found, t->was_modified, t->data_source_core};
+    }
+  }
+
+  auto snoop = coherence.request_exclusive(core, line_addr);
+  if (tracked) {
+    // Exclusive requests always leave the peers empty-handed, so the
+    // post-transition snapshot needs no observation pass
+    CoherenceTransition t;
+    t.peer_states = packed;
+    t.new_peer_states = 0;
+    t.op_core = CoherenceMemo::pack_op(true, core);
+    t.found = snoop.found;
+    t.was_modified = snoop.was_modified;
+    t.data_source_core = static_cast<uint8_t>(snoop.data_source_core);
+    t.snoop_writebacks = 0;
+    t.dirty_shares = 0;
+    t.forwards = 0;
+    t.valid = true;
+    coherence_memo.insert(t);
+    it->second = CoherenceMemo::set_nibble(
+        0, core, CoherenceMemo::nibble_state(it->second, core));
+  } else if (memo_active() && snoop.found) {
+    adopt_line_for_memo(line_addr);
+  }
+  return snoop;
+}
+
 MultiCoreAccessResult MultiCoreCacheSystem::read(uint64_t address,
                                                  uint32_t thread_id,
                                                  std::string_view file,
@@ -110,8 +398,10 @@ MultiCoreAccessResult MultiCoreCacheSystem::read(uint64_t address,
   int core = get_core_for_thread(thread_id);
   track_access_for_false_sharing(address, thread_id, false, file, line);
 
-  // TLB lookup for data access
-  dtlbs[core]->access(address);
+  // TLB lookup for data access; misses fall through to the STLB
+  if (!dtlbs[core]->access(address)) {
+    stlbs[core]->access(address);
+  }
 
   uint64_t line_addr = get_line_address(address);
 
@@ -125,37 +415,48 @@ MultiCoreAccessResult MultiCoreCacheSystem::read(uint64_t address,
     }
     return {true, false, false, false};
   }
+  shadow_note_eviction(core, l1_info);
 
   // L1 miss - trigger prefetcher for this core
   issue_prefetches(core, line_addr);
 
   // Snoop other caches - may get data from Modified line
-  auto snoop = coherence.request_read(core, line_addr);
+  auto snoop = snoop_read(core, line_addr);
   if (snoop.was_modified) {
     coherence_invalidations++;
-    // Downgrade the owner's line from M to S
-    l1_caches[snoop.data_source_core]->downgrade_to_shared(line_addr);
+    charge_invalidation(line_addr);
   }
 
-  // Determine coherence state for new line:
-  // Shared if others have it, Exclusive if we're the only one
+  // Determine coherence state for new line: Shared if others have it
+  // (Forward under MESIF - the newest sharer answers future requests),
+  // Exclusive if we're the only one
   CoherenceState new_state =
-      snoop.found ? CoherenceState::Shared : CoherenceState::Exclusive;
+      snoop.found ? (coherence.get_protocol() == CoherenceProtocol::MESIF
+                         ? CoherenceState::Forward
+                         : CoherenceState::Shared)
+                  : CoherenceState::Exclusive;
 
   auto l2_info = l2.access(line_addr, false);
   if (l2_info.result == AccessResult::Hit) {
-    l1_caches[core]->install_with_state(line_addr, new_state);
+    shadow_note_eviction(
+        core, l1_caches[core]->install_with_state(line_addr, new_state));
+    shadow_update(core, line_addr, new_state);
     return {false, true, false, false};
   }
 
-  // L2 miss - check L3 if it exists, otherwise go to memory
+  // L2 miss - check this socket's L3 slice, otherwise go to memory
   bool l3_hit = false;
-  if (has_l3()) {
-    auto l3_info = l3_->access(line_addr, false);
+  if (CacheLevel *l3 = l3_for_core(core)) {
+    auto l3_info = l3->access(line_addr, false);
     l3_hit = (l3_info.result == AccessResult::Hit);
   }
+  if (!l3_hit) {
+    record_numa_access(core, address, file, line);
+  }
   l2.install(line_addr, false);
-  l1_caches[core]->install_with_state(line_addr, new_state);
+  shadow_note_eviction(
+      core, l1_caches[core]->install_with_state(line_addr, new_state));
+  shadow_update(core, line_addr, new_state);
 
   return {false, false, l3_hit, !l3_hit};
 }
@@ -167,15 +468,18 @@ MultiCoreAccessResult MultiCoreCacheSystem::write(uint64_t address,
   int core = get_core_for_thread(thread_id);
   track_access_for_false_sharing(address, thread_id, true, file, line);
 
-  // TLB lookup for data access
-  dtlbs[core]->access(address);
+  // TLB lookup for data access; misses fall through to the STLB
+  if (!dtlbs[core]->access(address)) {
+    stlbs[core]->access(address);
+  }
 
   uint64_t line_addr = get_line_address(address);
 
   // Request exclusive access - invalidates all other copies
-  auto snoop = coherence.request_exclusive(core, line_addr);
+  auto snoop = snoop_exclusive(core, line_addr);
   if (snoop.found) {
     coherence_invalidations++;
+    charge_invalidation(line_addr);
   }
 
   // Check if we have the line in L1
@@ -183,8 +487,10 @@ MultiCoreAccessResult MultiCoreCacheSystem::write(uint64_t address,
   if (l1_info.result == AccessResult::Hit) {
     // Upgrade to Modified state (handles S->M, E->M transitions)
     l1_caches[core]->set_coherence_state(line_addr, CoherenceState::Modified);
+    shadow_update(core, line_addr, CoherenceState::Modified);
     return {true, false, false, false};
   }
+  shadow_note_eviction(core, l1_info);
 
   // L1 miss - trigger prefetcher for this core
   issue_prefetches(core, line_addr);
@@ -192,22 +498,163 @@ MultiCoreAccessResult MultiCoreCacheSystem::write(uint64_t address,
   // Miss in L1 - need to fetch and install as Modified
   auto l2_info = l2.access(line_addr, false);
   if (l2_info.result == AccessResult::Hit) {
-    l1_caches[core]->install_with_state(line_addr, CoherenceState::Modified);
+    shadow_note_eviction(core, l1_caches[core]->install_with_state(
+                                   line_addr, CoherenceState::Modified));
+    shadow_update(core, line_addr, CoherenceState::Modified);
     return {false, true, false, false};
   }
 
-  // L2 miss - check L3 if it exists, otherwise go to memory
+  // L2 miss - check this socket's L3 slice, otherwise go to memory
   bool l3_hit = false;
-  if (has_l3()) {
-    auto l3_info = l3_->access(line_addr, false);
+  if (CacheLevel *l3 = l3_for_core(core)) {
+    auto l3_info = l3->access(line_addr, false);
     l3_hit = (l3_info.result == AccessResult::Hit);
   }
+  if (!l3_hit) {
+    record_numa_access(core, address, file, line);
+  }
   l2.install(line_addr, false);
-  l1_caches[core]->install_with_state(line_addr, CoherenceState::Modified);
+  shadow_note_eviction(core, l1_caches[core]->install_with_state(
+                                 line_addr, CoherenceState::Modified));
+  shadow_update(core, line_addr, CoherenceState::Modified);
 
   return {false, false, l3_hit, !l3_hit};
 }
 
+bool MultiCoreCacheSystem::try_process_epoch_parallel(
+    const EpochAccess *accesses, size_t count, MultiCoreAccessResult *results,
+    int max_threads) {
+  // Prefetch fills land at miss time and change which later accesses hit;
+  // the deferred replay below cannot reproduce that, so prefetching epochs
+  // take the sequential path.
+  // NUMA mode shares the page-placement and traffic maps across cores,
+  // and the deferred L3 replay assumes one shared L3, so multi-socket
+  // and CCX-sliced runs also stay on the sequential path.
+  if (prefetch_policy != PrefetchPolicy::NONE || is_numa_enabled() ||
+      !l3_slices.empty() || max_threads < 2 || num_cores < 2 || count == 0)
+    return false;
+
+  // Pass 1: map each access to its core and prove the epoch conflict-free:
+  // every line touched by exactly one core, held by no other core. Nothing
+  // below this loop runs unless the whole epoch qualifies.
+  std::vector<int> core_of(count);
+  std::unordered_map<uint64_t, int> line_owner;
+  line_owner.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    int core = get_core_for_thread(accesses[i].thread_id);
+    core_of[i] = core;
+    uint64_t line_addr = get_line_address(accesses[i].address);
+    auto [it, inserted] = line_owner.emplace(line_addr, core);
+    if (!inserted && it->second != core)
+      return false;  // two cores touch the line this epoch
+    if (inserted && coherence.has_remote_sharers(core, line_addr))
+      return false;  // someone else may already hold it
+  }
+
+  // Committed to the parallel path. Workers fill L1s without the shadow
+  // bookkeeping the coherence memo relies on, so drop every snapshot -
+  // affected lines fall back to the full snoop path until re-adopted.
+  line_states.clear();
+
+  // The false-sharing tracker sees the accesses in trace order, exactly
+  // as read()/write() would feed it.
+  for (size_t i = 0; i < count; i++) {
+    track_access_for_false_sharing(accesses[i].address, accesses[i].thread_id,
+                                   accesses[i].is_write, accesses[i].file,
+                                   accesses[i].line);
+  }
+
+  std::vector<std::vector<uint32_t>> per_core(num_cores);
+  for (size_t i = 0; i < count; i++)
+    per_core[core_of[i]].push_back(static_cast<uint32_t>(i));
+
+  // Phase 2: per-core workers walk their own access streams. L1 and DTLB
+  // state is core-private, and with no remote sharers the snoop outcome of
+  // every miss is known up front (Exclusive for reads, Modified for
+  // writes), so misses fill L1 immediately and queue only their shared
+  // L2/L3 lookup.
+  struct DeferredMiss {
+    uint32_t seq;
+    uint64_t line_addr;
+  };
+  std::vector<std::vector<DeferredMiss>> deferred(num_cores);
+
+  auto run_core = [&](int core) {
+    for (uint32_t idx : per_core[core]) {
+      const EpochAccess &a = accesses[idx];
+      uint64_t line_addr = get_line_address(a.address);
+
+      if (!dtlbs[core]->access(a.address)) {
+        stlbs[core]->access(a.address);
+      }
+
+      auto l1_info = l1_caches[core]->access(line_addr, a.is_write);
+      if (l1_info.result == AccessResult::Hit) {
+        if (a.is_write)
+          l1_caches[core]->set_coherence_state(line_addr,
+                                               CoherenceState::Modified);
+        results[idx] = {true, false, false, false};
+        continue;
+      }
+
+      l1_caches[core]->install_with_state(line_addr,
+                                          a.is_write
+                                              ? CoherenceState::Modified
+                                              : CoherenceState::Exclusive);
+      deferred[core].push_back({idx, line_addr});
+      results[idx] = {false, false, false, false};
+    }
+  };
+
+  int workers = std::min(max_threads, num_cores);
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (int w = 0; w < workers; w++) {
+    threads.emplace_back([&, w] {
+      for (int core = w; core < num_cores; core += workers)
+        run_core(core);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  // Phase 3: replay the deferred misses through shared L2/L3 in trace
+  // order - the same order the sequential path would have touched them, so
+  // shared-level LRU state and hit/miss stats come out identical.
+  std::vector<DeferredMiss> misses;
+  for (const auto &core_misses : deferred)
+    misses.insert(misses.end(), core_misses.begin(), core_misses.end());
+  std::sort(misses.begin(), misses.end(),
+            [](const DeferredMiss &a, const DeferredMiss &b) {
+              return a.seq < b.seq;
+            });
+
+  for (const auto &miss : misses) {
+    auto l2_info = l2.access(miss.line_addr, false);
+    if (l2_info.result == AccessResult::Hit) {
+      results[miss.seq].l2_hit = true;
+      continue;
+    }
+
+    bool l3_hit = false;
+    if (has_l3()) {
+      auto l3_info = l3_->access(miss.line_addr, false);
+      l3_hit = (l3_info.result == AccessResult::Hit);
+    }
+    l2.install(miss.line_addr, false);
+    results[miss.seq].l3_hit = l3_hit;
+    results[miss.seq].memory_access = !l3_hit;
+  }
+
+  // Commit each line's owner to the snoop filter. Peer bits were already
+  // scrubbed by the has_remote_sharers() probes in pass 1, so OR-ing the
+  // owner matches what the per-access filter updates would have left.
+  for (const auto &[line_addr, core] : line_owner)
+    coherence.add_sharer(core, line_addr);
+
+  return true;
+}
+
 MultiCoreStats MultiCoreCacheSystem::get_stats() const {
   MultiCoreStats stats;
   for (const auto &l1 : l1_caches) {
@@ -217,17 +664,44 @@ MultiCoreStats MultiCoreCacheSystem::get_stats() const {
     stats.prefetch_per_core.push_back(pf->get_stats());
   }
   stats.l2 = l2.get_stats();
-  stats.l3 = has_l3() ? l3_->get_stats() : CacheStats{};
+  stats.l3 = l3_.has_value() ? l3_->get_stats() : CacheStats{};
+  for (const auto &l3 : l3_slices) {
+    stats.l3 += l3->get_stats();
+  }
   stats.coherence_invalidations = coherence_invalidations;
   stats.false_sharing_events = false_sharing_count;
+  stats.snoop_writebacks = coherence.get_snoop_writebacks();
+  stats.dirty_shares = coherence.get_dirty_shares();
+  stats.forwards = coherence.get_forwards();
   return stats;
 }
 
+void MultiCoreCacheSystem::set_page_size(size_t page_size) {
+  // Same sizing as the single-core hierarchy: huge translations get
+  // fewer entries, matching the separate huge-page arrays on real chips
+  TLBConfig l1_cfg{64, 4, 4096};
+  TLBConfig stlb_cfg{1536, 8, 4096};
+  if (page_size == (1ULL << 30)) {
+    l1_cfg = TLBConfig{8, 4, page_size};
+    stlb_cfg = TLBConfig{1024, 8, page_size};
+  } else if (page_size == (2ULL << 20)) {
+    l1_cfg = TLBConfig{32, 4, page_size};
+    stlb_cfg = TLBConfig{1024, 8, page_size};
+  }
+  for (int i = 0; i < num_cores; i++) {
+    dtlbs[i] = std::make_unique<TLB>(l1_cfg);
+    stlbs[i] = std::make_unique<TLB>(stlb_cfg);
+  }
+}
+
 TLBHierarchyStats MultiCoreCacheSystem::get_tlb_stats() const {
   TLBHierarchyStats stats;
   for (const auto &dtlb : dtlbs) {
     stats.dtlb += dtlb->get_stats();
   }
+  for (const auto &stlb : stlbs) {
+    stats.stlb += stlb->get_stats();
+  }
   // ITLB not tracked yet (would need instruction fetch tracking)
   return stats;
 }
@@ -245,15 +719,25 @@ MultiCoreCacheSystem::get_false_sharing_reports() const {
     FalseSharingReport report;
     report.cache_line_addr = line_addr;
 
-    auto it = line_accesses.find(line_addr);
-    if (it != line_accesses.end()) {
-      for (const auto &a : it->second) {
-        report.accesses.push_back({line_addr, a.file, a.line, a.thread_id,
-                                   a.is_write, a.byte_offset});
+    auto it = line_trackers.find(line_addr);
+    if (it != line_trackers.end()) {
+      const auto &tracker = it->second;
+      report.invalidation_count = tracker.invalidations;
+      for (uint32_t i = 0; i < tracker.sample_count; i++) {
+        const auto &a = tracker.samples[i];
+        report.accesses.push_back(
+            {line_addr, FileTable::instance().view_of(a.file_id),
+             a.line, a.thread_id, a.is_write, a.byte_offset});
       }
     }
     reports.push_back(report);
   }
+
+  // Worst offenders first, so callers can truncate or threshold
+  std::sort(reports.begin(), reports.end(),
+            [](const auto &a, const auto &b) {
+              return a.invalidation_count > b.invalidation_count;
+            });
   return reports;
 }
 
@@ -295,7 +779,43 @@ void MultiCoreCacheSystem::set_fast_mode(bool enable) {
     l1->set_track_3c_misses(!enable);
   }
   l2.set_track_3c_misses(!enable);
-  if (has_l3()) {
+  if (l3_.has_value()) {
     l3_->set_track_3c_misses(!enable);
   }
+  for (auto &l3 : l3_slices) {
+    l3->set_track_3c_misses(!enable);
+  }
+}
+
+void MultiCoreCacheSystem::set_classifier_fp_rate(double fp_rate) {
+  for (auto &l1 : l1_caches) {
+    l1->set_classifier_fp_rate(fp_rate);
+  }
+  l2.set_classifier_fp_rate(fp_rate);
+  if (l3_.has_value()) {
+    l3_->set_classifier_fp_rate(fp_rate);
+  }
+  for (auto &l3 : l3_slices) {
+    l3->set_classifier_fp_rate(fp_rate);
+  }
+}
+
+ClassifierSummary MultiCoreCacheSystem::get_classifier_summary() const {
+  ClassifierSummary s;
+  s.fp_rate = l2.get_classifier().configured_fp_rate();
+  auto fold = [&s](const BloomFilter &f) {
+    s.estimated_fp_rate = std::max(s.estimated_fp_rate, f.estimated_fp_rate());
+    s.memory_bytes += f.memory_bytes();
+  };
+  for (const auto &l1 : l1_caches) {
+    fold(l1->get_classifier());
+  }
+  fold(l2.get_classifier());
+  if (l3_.has_value()) {
+    fold(l3_->get_classifier());
+  }
+  for (const auto &l3 : l3_slices) {
+    fold(l3->get_classifier());
+  }
+  return s;
 }
@@ -1,63 +1,340 @@
 #include "include/MultiCoreTraceProcessor.hpp"
 
 #include <algorithm>
+#include <thread>
 
 MultiCoreTraceProcessor::MultiCoreTraceProcessor(int num_cores, const CacheConfig &l1_cfg,
                                                    const CacheConfig &l2_cfg,
                                                    const CacheConfig &l3_cfg,
                                                    PrefetchPolicy prefetch_policy,
-                                                   int prefetch_degree)
-    : cache(num_cores, l1_cfg, l2_cfg, l3_cfg, prefetch_policy, prefetch_degree) {}
+                                                   int prefetch_degree,
+                                                   CoherenceMode coherence_mode,
+                                                   CoherenceProtocol protocol)
+    : cache(num_cores, l1_cfg, l2_cfg, l3_cfg, prefetch_policy, prefetch_degree,
+            coherence_mode, protocol) {}
 
 void MultiCoreTraceProcessor::set_event_callback(std::function<void(const EventResult &)> cb) {
+    // Boundary adapter: the hot path only sees the static hook, which
+    // forwards into the stored type-erased callable
     event_callback = std::move(cb);
+    if (event_callback) {
+        set_event_hook(
+            [](void *ctx, const EventResult &r) {
+                (*static_cast<std::function<void(const EventResult &)> *>(ctx))(r);
+            },
+            &event_callback);
+    } else {
+        set_event_hook(nullptr, nullptr);
+    }
+}
+
+void MultiCoreTraceProcessor::set_batch_callback(BatchCallback cb, size_t batch_size) {
+    batch_callback = std::move(cb);
+    result_batch_size = batch_size ? batch_size : 1;
+    result_buffer.clear();
+    event_callback = nullptr;
+    if (batch_callback) {
+        result_buffer.reserve(result_batch_size);
+        // Route through the per-event hook internally so process_line_access
+        // stays unchanged - the buffering is what amortizes the callback cost
+        set_event_hook(
+            [](void *ctx, const EventResult &r) {
+                auto *self = static_cast<MultiCoreTraceProcessor *>(ctx);
+                self->result_buffer.push_back(r);
+                if (self->result_buffer.size() >= self->result_batch_size)
+                    self->flush_results();
+            },
+            this);
+    } else {
+        set_event_hook(nullptr, nullptr);
+    }
+}
+
+void MultiCoreTraceProcessor::flush_results() {
+    if (batch_callback && !result_buffer.empty()) {
+        batch_callback(result_buffer.data(), result_buffer.size());
+        result_buffer.clear();
+    }
+}
+
+void MultiCoreTraceProcessor::process_batch(const TraceEvent *events, size_t count) {
+    if (virtual_time) {
+        process_batch_virtual_time(events, count);
+        flush_results();
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        process(events[i]);
+    }
+    flush_epoch();
+    flush_results();
 }
 
-std::string MultiCoreTraceProcessor::make_key(std::string_view file, uint32_t line) {
-    return std::string(file) + ":" + std::to_string(line);
+void MultiCoreTraceProcessor::enable_virtual_time(const LatencyConfig &latency) {
+    flush_epoch();
+    virtual_time = true;
+    vt_latency = latency;
+    vt_clocks.assign((size_t)cache.get_num_cores(), 0);
+    // Dispatch depends on each access's simulated latency as soon as it
+    // completes - epoch buffering would decide the order from stale clocks
+    parallel_sim_threads = 0;
+    shard_stats.reset();  // sequential path accounts into source_stats
 }
 
-void MultiCoreTraceProcessor::process_line_access(const TraceEvent &event, uint64_t line_addr, bool is_write) {
+void MultiCoreTraceProcessor::process_batch_virtual_time(const TraceEvent *events,
+                                                         size_t count) {
+    // Partition the batch into per-thread streams of indices - program
+    // order within a thread is untouched, only the interleaving between
+    // threads is rebuilt. Clocks persist across batches, so chunked
+    // callers only constrain dispatch at chunk boundaries (an event can't
+    // be pulled ahead from a chunk not yet parsed).
+    struct Stream {
+        uint32_t thread_id;
+        int core;
+        size_t head = 0;
+        std::vector<size_t> order;
+    };
+    std::vector<Stream> streams;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t tid = events[i].thread_id;
+        Stream *stream = nullptr;
+        for (auto &s : streams) {
+            if (s.thread_id == tid) {
+                stream = &s;
+                break;
+            }
+        }
+        if (!stream) {
+            streams.push_back({tid, cache.get_core_for_thread(tid), 0, {}});
+            stream = &streams.back();
+        }
+        stream->order.push_back(i);
+    }
+    // Sort by thread id so the clock tie-break is a property of the trace,
+    // not of first-appearance order within this batch
+    std::sort(streams.begin(), streams.end(),
+              [](const Stream &a, const Stream &b) {
+                  return a.thread_id < b.thread_id;
+              });
+
+    // Dispatch the head event of whichever stream's core clock is lowest
+    // (ties to the lowest thread id); record_access_result advances the
+    // winning core's clock by the serving level's latency
+    size_t remaining = count;
+    while (remaining > 0) {
+        Stream *next = nullptr;
+        for (auto &s : streams) {
+            if (s.head >= s.order.size())
+                continue;
+            if (!next || vt_clocks[(size_t)s.core] < vt_clocks[(size_t)next->core])
+                next = &s;
+        }
+        process(events[next->order[next->head++]]);
+        remaining--;
+    }
+}
+
+void MultiCoreTraceProcessor::set_parallel_simulation(size_t num_threads) {
+    flush_epoch();
+    parallel_sim_threads = num_threads;
+    if (parallel_sim_threads > 1) {
+        epoch_accesses.reserve(EPOCH_SIZE);
+        epoch_sizes.reserve(EPOCH_SIZE);
+        // Shard hot-line accounting per core so epoch workers bump
+        // private tables (the budgeted tracker stays sequential - its
+        // sketch is shared state)
+        if (!hot_line_tracker) {
+            shard_stats = std::make_unique<ShardedHotLines>(
+                (size_t)cache.get_num_cores());
+        }
+    } else {
+        shard_stats.reset();
+    }
+}
+
+void MultiCoreTraceProcessor::flush_epoch() {
+    if (epoch_accesses.empty())
+        return;
+
+    size_t n = epoch_accesses.size();
+    epoch_results.assign(n, MultiCoreAccessResult{});
+    if (!cache.try_process_epoch_parallel(epoch_accesses.data(), n,
+                                          epoch_results.data(),
+                                          (int)parallel_sim_threads)) {
+        // Conflicted epoch: replay sequentially, same as non-parallel mode
+        for (size_t i = 0; i < n; i++) {
+            const auto &a = epoch_accesses[i];
+            epoch_results[i] =
+                a.is_write ? cache.write(a.address, a.thread_id, a.file, a.line)
+                           : cache.read(a.address, a.thread_id, a.file, a.line);
+        }
+    }
+
+    // Hot-line accounting shards per core, mirroring the epoch engine's
+    // partitioning: each worker owns whole shards, so the tables need no
+    // locks. record_access_result skips source_stats while shards own
+    // the accounting.
+    if (shard_stats && !hot_line_tracker) {
+        std::vector<std::vector<uint32_t>> per_shard(
+            shard_stats->shard_count());
+        for (size_t i = 0; i < n; i++) {
+            if (!epoch_accesses[i].file.empty()) {
+                per_shard[(size_t)cache.get_core_for_thread(
+                              epoch_accesses[i].thread_id)]
+                    .push_back(static_cast<uint32_t>(i));
+            }
+        }
+        size_t workers = std::min(parallel_sim_threads, per_shard.size());
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t w = 0; w < workers; w++) {
+            threads.emplace_back([&, w] {
+                for (size_t s = w; s < per_shard.size(); s += workers) {
+                    for (uint32_t idx : per_shard[s]) {
+                        const auto &a = epoch_accesses[idx];
+                        shard_stats->record(s, a.file, a.line,
+                                            epoch_results[idx].l1_hit,
+                                            a.thread_id);
+                    }
+                }
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+    }
+
+    uint32_t line_size = cache.get_line_size();
+    for (size_t i = 0; i < n; i++) {
+        const auto &a = epoch_accesses[i];
+        record_access_result((a.address / line_size) * line_size, a.is_write,
+                             epoch_sizes[i], a.file, a.line, a.thread_id,
+                             epoch_results[i]);
+    }
+    epoch_accesses.clear();
+    epoch_sizes.clear();
+}
+
+void MultiCoreTraceProcessor::process_line_access(const TraceEvent &event, uint64_t addr, bool is_write) {
     MultiCoreAccessResult result;
     if (is_write) {
-        result = cache.write(line_addr, event.thread_id, event.file, event.line);
+        result = cache.write(addr, event.thread_id, event.file, event.line);
     } else {
-        result = cache.read(line_addr, event.thread_id, event.file, event.line);
+        result = cache.read(addr, event.thread_id, event.file, event.line);
     }
 
+    uint32_t line_size = cache.get_line_size();
+    uint64_t line_addr = (addr / line_size) * line_size;
+    record_access_result(line_addr, is_write, event.size, event.file,
+                         event.line, event.thread_id, result);
+}
+
+void MultiCoreTraceProcessor::record_access_result(
+    uint64_t line_addr, bool is_write, uint32_t size, std::string_view file,
+    uint32_t line, uint32_t thread_id, const MultiCoreAccessResult &result) {
     // Track prefetch usefulness
     if (!is_write && prefetched_addresses.count(line_addr)) {
         sw_prefetch_stats.useful++;
         prefetched_addresses.erase(line_addr);
     }
 
-    if (!event.file.empty()) {
-        auto key = make_key(event.file, event.line);
-        auto &stats = source_stats[key];
-        stats.file = event.file;
-        stats.line = event.line;
-        stats.threads.insert(event.thread_id);
-        if (result.l1_hit)
-            stats.hits++;
-        else
-            stats.misses++;
+    if (!file.empty()) {
+        if (hot_line_tracker) {
+            hot_line_tracker->record(file, line, !result.l1_hit, thread_id);
+        } else if (!shard_stats) {  // epoch shards already took this access
+            // Interned file views are stable for the whole run, so they key
+            // the table directly - no per-event key string to build
+            auto &stats = source_stats[SourceKey{file, line}];
+            stats.file = file;
+            stats.line = line;
+            stats.threads.insert(thread_id);
+            if (result.l1_hit)
+                stats.hits++;
+            else
+                stats.misses++;
+        }
+    }
+
+    // Virtual-time replay: charge the serving level's latency to the
+    // issuing core's clock, which drives the next dispatch decision
+    if (virtual_time) {
+        vt_clocks[(size_t)cache.get_core_for_thread(thread_id)] +=
+            result.l1_hit   ? (uint64_t)vt_latency.l1_hit
+            : result.l2_hit ? (uint64_t)vt_latency.l2_hit
+            : result.l3_hit ? (uint64_t)vt_latency.l3_hit
+                            : (uint64_t)vt_latency.memory;
     }
 
-    if (event_callback) {
-        event_callback({result.l1_hit, result.l2_hit, result.l3_hit,
-                        line_addr, event.size, event.file, event.line});
+    if (event_hook) {
+        event_hook(event_hook_ctx, {result.l1_hit, result.l2_hit, result.l3_hit,
+                                    line_addr, size, file, line});
+    }
+}
+
+void MultiCoreTraceProcessor::handle_line_access(const TraceEvent &event, uint64_t addr, bool is_write) {
+    uint32_t line_size = cache.get_line_size();
+
+    // Set sampling: only lines in the deterministic 1-in-n subset are
+    // simulated; everything downstream sees a proportionally thinner trace
+    if (set_sample_factor > 1 && (addr / line_size) % set_sample_factor != 0)
+        return;
+
+    // Working-set sketch: every distinct line touched this window (kept
+    // here so the parallel epoch path is covered too)
+    wss.observe((addr / line_size) * line_size);
+
+    if (parallel_sim_threads <= 1) {
+        process_line_access(event, addr, is_write);
+        return;
     }
+
+    epoch_accesses.push_back(
+        {addr, event.thread_id, event.file, event.line, is_write});
+    epoch_sizes.push_back(event.size);
+    if (epoch_accesses.size() >= EPOCH_SIZE)
+        flush_epoch();
 }
 
 void MultiCoreTraceProcessor::process(const TraceEvent &event) {
+    // Sample-rate records reweight everything that follows
+    if (event.is_sample_rate) {
+        sampling.on_rate_record(event.count);
+        return;
+    }
+
+    // Heap records (H/F) and phase markers (B/E) are single-core only for
+    // now - dropping them here keeps them out of the demand stream
+    if (event.is_alloc || event.is_free || event.is_phase_begin ||
+        event.is_phase_end) {
+        return;
+    }
+
+    // Expand compressed range events into the scalar accesses they
+    // stand for (see TraceProcessor::process)
+    if (event.is_range) {
+        TraceEvent scalar = event;
+        scalar.is_range = false;
+        scalar.stride = 0;
+        scalar.count = 0;
+        for (uint64_t i = 0; i < event.count; i++) {
+            process(scalar);
+            scalar.address += (uint64_t)event.stride;
+        }
+        return;
+    }
+
     seen_threads.insert(event.thread_id);
 
+    // Every scalar access from here down carries the current sampling
+    // weight (ranges were expanded above, so each expansion counts once)
+    sampling.on_event();
+
     uint32_t line_size = cache.get_line_size();
 
     // Handle software prefetch hints
     if (event.is_prefetch) {
         sw_prefetch_stats.issued++;
         uint64_t line_addr = (event.address / line_size) * line_size;
+        flush_epoch();  // hint reads bypass the epoch buffer - keep order
         cache.read(line_addr, event.thread_id, event.file, event.line);
         prefetched_addresses.insert(line_addr);
         return;
@@ -77,14 +354,14 @@ void MultiCoreTraceProcessor::process(const TraceEvent &event) {
         auto src_lines = split_access_to_cache_lines(
             {event.src_address, event.size, false}, line_size);
         for (const auto &line_access : src_lines) {
-            process_line_access(event, line_access.line_address, false);
+            handle_line_access(event, line_access.address, false);
         }
 
         // Process dest writes
         auto dst_lines = split_access_to_cache_lines(
             {event.address, event.size, true}, line_size);
         for (const auto &line_access : dst_lines) {
-            process_line_access(event, line_access.line_address, true);
+            handle_line_access(event, line_access.address, true);
         }
         return;
     }
@@ -97,7 +374,7 @@ void MultiCoreTraceProcessor::process(const TraceEvent &event) {
         auto lines = split_access_to_cache_lines(
             {event.address, event.size, true}, line_size);
         for (const auto &line_access : lines) {
-            process_line_access(event, line_access.line_address, true);
+            handle_line_access(event, line_access.address, true);
         }
         return;
     }
@@ -113,16 +390,47 @@ void MultiCoreTraceProcessor::process(const TraceEvent &event) {
         }
     }
 
-    // Track atomic statistics
+    // Gather/scatter lanes: each record is one lane of a masked vector
+    // op, so the standard path below charges the lane's own - possibly
+    // discontiguous - cache line. The op-level stats close on the last
+    // lane; the dedupe buffer is keyed by thread since the merged trace
+    // interleaves threads mid-op.
+    if (event.is_gather) {
+        auto &seen = gather_lines_in_flight[event.thread_id];
+        if (event.lane == 0) {
+            (event.is_write ? gather_stats.scatters : gather_stats.gathers)++;
+            seen.clear();
+        }
+        gather_stats.lanes++;
+        gather_stats.bytes += event.size;
+        uint64_t line_addr = (event.address / line_size) * line_size;
+        if (std::find(seen.begin(), seen.end(), line_addr) == seen.end())
+            seen.push_back(line_addr);
+        if (event.lane + 1 >= event.lanes) {
+            gather_stats.lines_touched += seen.size();
+            seen.clear();
+        }
+    }
+
+    // Track atomic statistics and the per-address contention profile
     if (event.is_atomic) {
+        AtomicOpKind kind;
         if (event.is_cmpxchg) {
             atomic_stats.cmpxchg_count++;
+            kind = AtomicOpKind::Cmpxchg;
         } else if (event.is_rmw) {
             atomic_stats.rmw_count++;
+            kind = AtomicOpKind::Rmw;
         } else if (event.is_write) {
             atomic_stats.store_count++;
+            kind = AtomicOpKind::Store;
         } else {
             atomic_stats.load_count++;
+            kind = AtomicOpKind::Load;
+        }
+        if (atomic_contention.record(event.address, event.thread_id, kind,
+                                     event.file, event.line)) {
+            atomic_stats.contention_events++;
         }
     }
 
@@ -136,11 +444,52 @@ void MultiCoreTraceProcessor::process(const TraceEvent &event) {
     }
 
     for (const auto &line_access : lines) {
-        process_line_access(event, line_access.line_address, event.is_write);
+        handle_line_access(event, line_access.address, event.is_write);
     }
 }
 
 std::vector<MultiCoreSourceStats> MultiCoreTraceProcessor::get_hot_lines(size_t limit) const {
+    if (hot_line_tracker) {
+        std::vector<MultiCoreSourceStats> sorted;
+        for (const auto &entry : hot_line_tracker->top(limit)) {
+            MultiCoreSourceStats stats;
+            stats.file = entry.file;
+            stats.line = entry.line;
+            stats.hits = entry.hits;
+            stats.misses = entry.misses;
+            // The tracker keeps a thread bitmask, not exact ids; surface
+            // the set bits so threads.size() still reports the count
+            for (uint32_t t = 0; t < 64; t++) {
+                if (entry.thread_mask & (1ULL << t))
+                    stats.threads.insert(t);
+            }
+            sorted.push_back(std::move(stats));
+        }
+        return sorted;
+    }
+
+    if (shard_stats) {
+        // Streamed k-way merge of the per-core shards - the union map
+        // this replaces was the whole point of sharding (see
+        // ShardedHotLines.hpp)
+        std::vector<MultiCoreSourceStats> sorted;
+        for (const auto &entry : shard_stats->merge_top_k(limit)) {
+            MultiCoreSourceStats stats;
+            stats.file = entry.file;
+            stats.line = entry.line;
+            stats.hits = entry.hits;
+            stats.misses = entry.misses;
+            // Shards keep a thread bitmask like the budgeted tracker;
+            // surface the set bits so threads.size() reports the count
+            for (uint32_t t = 0; t < 64; t++) {
+                if (entry.thread_mask & (1ULL << t))
+                    stats.threads.insert(t);
+            }
+            sorted.push_back(std::move(stats));
+        }
+        return sorted;
+    }
+
     std::vector<MultiCoreSourceStats> sorted;
     sorted.reserve(source_stats.size());
 
@@ -148,8 +497,72 @@ std::vector<MultiCoreSourceStats> MultiCoreTraceProcessor::get_hot_lines(size_t
         sorted.push_back(stats);
     }
 
-    std::sort(sorted.begin(), sorted.end(),
-              [](const auto &a, const auto &b) { return a.misses > b.misses; });
+    // Same ordering as the sharded merge (misses, then file/line) so
+    // --parallel-sim reports the identical top-K
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        if (a.misses != b.misses) {
+            return a.misses > b.misses;
+        }
+        if (a.file != b.file) {
+            return a.file < b.file;
+        }
+        return a.line < b.line;
+    });
+
+    if (sorted.size() > limit) {
+        sorted.resize(limit);
+    }
+
+    return sorted;
+}
+
+std::vector<FunctionStats> MultiCoreTraceProcessor::get_hot_functions(size_t limit) const {
+    const auto &func_map = TraceFuncMap::instance();
+    if (func_map.empty()) {
+        return {};
+    }
+
+    // Fold per-line stats into their enclosing functions. Under a hot-line
+    // budget only resident lines contribute - the rollup is then a view of
+    // the tracked top-K, same contract as get_hot_lines.
+    std::unordered_map<std::string_view, FunctionStats> by_func;
+    auto fold = [&](std::string_view file, uint32_t line, uint64_t hits,
+                    uint64_t misses) {
+        std::string_view func = func_map.function_of(file, line);
+        if (func.empty()) {
+            return;
+        }
+        FunctionStats &f = by_func[func];
+        f.function = func;
+        f.hits += hits;
+        f.misses += misses;
+        f.lines++;
+    };
+    if (hot_line_tracker) {
+        for (const auto &entry : hot_line_tracker->top(hot_line_tracker->budget())) {
+            fold(entry.file, entry.line, entry.hits, entry.misses);
+        }
+    } else if (shard_stats) {
+        shard_stats->for_each_merged([&](const ShardedHotLines::Entry &e) {
+            fold(e.file, e.line, e.hits, e.misses);
+        });
+    } else {
+        for (const auto &[key, stats] : source_stats) {
+            fold(key.file, key.line, stats.hits, stats.misses);
+        }
+    }
+
+    std::vector<FunctionStats> sorted;
+    sorted.reserve(by_func.size());
+    for (const auto &[func, stats] : by_func) {
+        sorted.push_back(stats);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        if (a.misses != b.misses) {
+            return a.misses > b.misses;
+        }
+        return a.function < b.function;
+    });
 
     if (sorted.size() > limit) {
         sorted.resize(limit);
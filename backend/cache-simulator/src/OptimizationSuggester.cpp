@@ -37,7 +37,7 @@ OptimizationSuggester::analyze(const std::vector<FalseSharingReport> &false_shar
     std::string loc;
     for (const auto &a : fs.accesses) {
       if (!a.file.empty()) {
-        loc = a.file + ":" + std::to_string(a.line);
+        loc = std::string(a.file) + ":" + std::to_string(a.line);
         break;
       }
     }
@@ -54,7 +54,7 @@ OptimizationSuggester::analyze(const std::vector<FalseSharingReport> &false_shar
   // Analyze hot lines with high miss rates
   for (const auto &line : hot_lines) {
     if (line.miss_rate() > 0.5 && line.misses > 100) {
-      std::string loc = line.file + ":" + std::to_string(line.line);
+      std::string loc = std::string(line.file) + ":" + std::to_string(line.line);
 
       suggestions.push_back({
           "high_miss_rate",
@@ -69,7 +69,7 @@ OptimizationSuggester::analyze(const std::vector<FalseSharingReport> &false_shar
 
     // Multi-threaded hot spots
     if (line.threads.size() > 1 && line.misses > 50) {
-      std::string loc = line.file + ":" + std::to_string(line.line);
+      std::string loc = std::string(line.file) + ":" + std::to_string(line.line);
       suggestions.push_back({
           "contention",
           "medium",
@@ -121,7 +121,7 @@ OptimizationSuggester::analyze(const std::vector<SourceStats> &hot_lines,
 
   for (const auto &line : hot_lines) {
     if (line.miss_rate() > 0.5 && line.misses > 100) {
-      std::string loc = line.file + ":" + std::to_string(line.line);
+      std::string loc = std::string(line.file) + ":" + std::to_string(line.line);
 
       suggestions.push_back({
           "high_miss_rate",
@@ -147,3 +147,46 @@ OptimizationSuggester::analyze(const std::vector<SourceStats> &hot_lines,
 
   return suggestions;
 }
+
+std::vector<OptimizationSuggestion>
+OptimizationSuggester::analyze_layout(const std::vector<HeapSiteStats> &heap_sites,
+                                      uint32_t line_size) {
+
+  std::vector<OptimizationSuggestion> suggestions;
+  // touched_mask folds lines wider than 64 bytes, so utilization is
+  // measured against the mask's span, not the raw line size
+  uint32_t mask_bytes = std::min<uint32_t>(line_size, 64);
+
+  for (const auto &site : heap_sites) {
+    // Too little traffic to matter, or density was never recorded
+    if (site.l1_misses < 50 || site.touched_mask == 0) continue;
+
+    uint32_t touched = site.line_bytes_touched();
+    double utilization = static_cast<double>(touched) / mask_bytes;
+    if (utilization > 0.5) continue;
+
+    // A dense layout fetches utilization * lines, so the rest of the
+    // misses were spent on bytes the code never looked at
+    auto est_savings =
+        static_cast<uint64_t>((1.0 - utilization) * site.l1_misses);
+    uint64_t avg_alloc =
+        site.alloc_count ? site.bytes_allocated / site.alloc_count : 0;
+
+    std::string loc = std::string(site.file) + ":" + std::to_string(site.line);
+    suggestions.push_back({
+        "partial_struct",
+        utilization <= 0.25 ? "high" : "medium",
+        loc,
+        "Only " + std::to_string(touched) + " of " +
+            std::to_string(mask_bytes) +
+            " bytes per cache line are ever touched in this allocation (" +
+            std::to_string(avg_alloc) + " bytes average)",
+        "Split the hot fields into their own array (AoS->SoA) or reorder "
+        "fields so they share cache lines - up to " +
+            std::to_string(est_savings) + " of " +
+            std::to_string(site.l1_misses) + " L1 misses are fetching "
+            "unused bytes"});
+  }
+
+  return suggestions;
+}
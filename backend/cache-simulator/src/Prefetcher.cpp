@@ -23,12 +23,50 @@ std::vector<uint64_t> Prefetcher::on_miss(uint64_t addr, uint64_t pc) {
   case PrefetchPolicy::INTEL:
     prefetch_addrs = intel_prefetch(addr, pc);
     break;
+  case PrefetchPolicy::BEST_OFFSET:
+    prefetch_addrs = best_offset_prefetch(addr);
+    break;
+  case PrefetchPolicy::SMS:
+    prefetch_addrs = sms_prefetch(addr, pc);
+    break;
   }
 
   stats.prefetches_issued += prefetch_addrs.size();
+  if (throttling_enabled) {
+    update_throttle();
+  }
   return prefetch_addrs;
 }
 
+void Prefetcher::update_throttle() {
+  uint64_t issued_delta = stats.prefetches_issued - epoch_issued;
+  if (issued_delta < THROTTLE_EPOCH) {
+    return;
+  }
+
+  // Usefulness is recorded when a later demand hits a prefetched line,
+  // so the epoch accuracy slightly lags prefetches still in flight
+  uint64_t useful_delta = stats.prefetches_useful - epoch_useful;
+  double accuracy = static_cast<double>(useful_delta) / issued_delta;
+
+  int new_degree = prefetch_degree;
+  if (accuracy >= THROTTLE_HIGH) {
+    new_degree = std::min(prefetch_degree * 2, THROTTLE_MAX_DEGREE);
+  } else if (accuracy < THROTTLE_LOW) {
+    new_degree = std::max(prefetch_degree / 2, THROTTLE_MIN_DEGREE);
+  }
+
+  // The timeline is capped so a long trace can't bloat the JSON output;
+  // adaptation keeps running after the cap
+  if (throttle_timeline.size() < THROTTLE_TIMELINE_CAP) {
+    throttle_timeline.push_back(
+        {stats.prefetches_issued, accuracy, new_degree});
+  }
+  prefetch_degree = new_degree;
+  epoch_issued = stats.prefetches_issued;
+  epoch_useful = stats.prefetches_useful;
+}
+
 std::vector<uint64_t> Prefetcher::next_line_prefetch(uint64_t addr) {
   std::vector<uint64_t> result;
   result.reserve(prefetch_degree);
@@ -210,9 +248,147 @@ std::vector<uint64_t> Prefetcher::adaptive_prefetch(uint64_t addr, uint64_t pc)
   return stream_prefetch(addr, pc);
 }
 
+std::vector<uint64_t> Prefetcher::best_offset_prefetch(uint64_t addr) {
+  uint64_t line = get_line_addr(addr) / line_size;
+
+  // Learning: each miss tests the next candidate offset against the
+  // recent-requests table. Finding (line - d) there means a prefetch
+  // with offset d would have covered this miss.
+  int64_t candidate = BestOffsetState::OFFSETS[bop.test_index];
+  uint64_t wanted = line - candidate;
+  size_t slot = wanted % BestOffsetState::RR_ENTRIES;
+  bool phase_done = false;
+  if (bop.recent_valid[slot] && bop.recent[slot] == wanted) {
+    if (++bop.scores[bop.test_index] >= BestOffsetState::SCORE_MAX) {
+      phase_done = true; // Clear winner, no need to finish the rounds
+    }
+  }
+  if (++bop.test_index == BestOffsetState::OFFSETS.size()) {
+    bop.test_index = 0;
+    if (++bop.round >= BestOffsetState::ROUND_MAX) {
+      phase_done = true;
+    }
+  }
+
+  if (phase_done) {
+    // Adopt the highest-scoring offset for the next phase; a weak best
+    // score means no stable offset exists, so go idle until one does
+    size_t best = 0;
+    for (size_t i = 1; i < bop.scores.size(); i++) {
+      if (bop.scores[i] > bop.scores[best]) {
+        best = i;
+      }
+    }
+    bop.active = bop.scores[best] >= BestOffsetState::BAD_SCORE;
+    bop.best_offset = BestOffsetState::OFFSETS[best];
+    bop.scores.fill(0);
+    bop.test_index = 0;
+    bop.round = 0;
+  }
+
+  // Record this request so later misses can test their offsets against it
+  bop.recent[line % BestOffsetState::RR_ENTRIES] = line;
+  bop.recent_valid[line % BestOffsetState::RR_ENTRIES] = true;
+
+  std::vector<uint64_t> result;
+  if (!bop.active) {
+    return result;
+  }
+
+  // BOP is a degree-1 prefetcher: one line at the trained offset, kept
+  // within the page like the stream prefetcher
+  uint64_t pf_addr = (line + bop.best_offset) * line_size;
+  if (get_page(pf_addr) == get_page(addr)) {
+    result.push_back(pf_addr);
+  }
+  return result;
+}
+
+std::vector<uint64_t> Prefetcher::sms_prefetch(uint64_t addr, uint64_t pc) {
+  uint64_t region = addr / SMS_REGION_SIZE;
+  int line_offset = static_cast<int>((addr % SMS_REGION_SIZE) / line_size);
+  uint32_t bit = 1u << line_offset;
+  // The paper keys patterns by (PC, trigger offset); folding the offset
+  // in keeps the table useful even for traces without PC information
+  uint64_t key = (pc << 6) | static_cast<uint64_t>(line_offset);
+
+  std::vector<uint64_t> result;
+  auto it = sms_active.find(region);
+  if (it != sms_active.end()) {
+    // Ongoing generation: just accumulate the touched line
+    it->second.footprint |= bit;
+    it->second.last_touch = ++sms_clock;
+    return result;
+  }
+
+  // Region entry. Retire the coldest generation if the table is full,
+  // committing its learned footprint to the pattern table.
+  if (sms_active.size() >= SMS_ACTIVE_REGIONS) {
+    auto victim = sms_active.begin();
+    for (auto cand = sms_active.begin(); cand != sms_active.end(); ++cand) {
+      if (cand->second.last_touch < victim->second.last_touch) {
+        victim = cand;
+      }
+    }
+    sms_patterns[victim->second.key] = victim->second.footprint;
+    sms_active.erase(victim);
+  }
+  sms_active[region] = {key, bit, ++sms_clock};
+
+  // Replay the footprint this trigger produced the last time it opened
+  // a region - minus the line the demand access is already fetching
+  auto pattern = sms_patterns.find(key);
+  if (pattern == sms_patterns.end()) {
+    return result;
+  }
+  uint64_t base = region * SMS_REGION_SIZE;
+  int lines_per_region = static_cast<int>(SMS_REGION_SIZE / line_size);
+  for (int i = 0; i < lines_per_region; i++) {
+    uint32_t line_bit = 1u << i;
+    if ((pattern->second & line_bit) && !(line_bit & bit)) {
+      result.push_back(base + static_cast<uint64_t>(i) * line_size);
+    }
+  }
+  return result;
+}
+
 std::vector<uint64_t> Prefetcher::intel_prefetch(uint64_t addr, uint64_t pc) {
   // Intel-like prefetching: adaptive (stride + stream)
   // Note: Adjacent line prefetcher is disabled as it reduced accuracy
   // Real Intel CPUs have complex prefetcher interactions we can't fully model
   return adaptive_prefetch(addr, pc);
 }
+
+void Prefetcher::save_state(CheckpointWriter &w) const {
+  w.write<uint32_t>(static_cast<uint32_t>(policy));
+  w.write<uint32_t>(static_cast<uint32_t>(line_size));
+  w.write(prefetch_degree);
+  w.write(base_degree);
+  w.write_vec(stream_table);
+  w.write_map(stride_table);
+  w.write(bop);
+  w.write_map(sms_active);
+  w.write_map(sms_patterns);
+  w.write(sms_clock);
+  w.write(epoch_issued);
+  w.write(epoch_useful);
+  w.write_vec(throttle_timeline);
+  w.write(stats);
+}
+
+void Prefetcher::load_state(CheckpointReader &r) {
+  r.expect<uint32_t>(static_cast<uint32_t>(policy), "prefetch policy");
+  r.expect<uint32_t>(static_cast<uint32_t>(line_size), "prefetch line size");
+  prefetch_degree = r.read<int>();
+  base_degree = r.read<int>();
+  r.read_vec_expect(stream_table, "stream table size");
+  r.read_map(stride_table);
+  bop = r.read<BestOffsetState>();
+  r.read_map(sms_active);
+  r.read_map(sms_patterns);
+  sms_clock = r.read<uint64_t>();
+  epoch_issued = r.read<uint64_t>();
+  epoch_useful = r.read<uint64_t>();
+  r.read_vec(throttle_timeline);
+  stats = r.read<PrefetchStats>();
+}
@@ -0,0 +1,294 @@
+// result-db - query API over archived simulation results.
+//
+// Ingests cache-sim result JSON documents into the columnar store in
+// ResultDb.hpp and answers the reporting jobs' recurring questions -
+// per-line miss-rate trends, run-over-run regressions, preset x commit
+// matrices - without re-parsing the JSON archive every night.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../include/ResultDb.hpp"
+
+namespace {
+
+void print_usage(const char *prog) {
+  fprintf(stderr, "Usage: %s <command> <db> [options]\n", prog);
+  fprintf(stderr, "\nQuery API over archived cache-sim results. The database is a\n");
+  fprintf(stderr, "compact columnar file; 'add' creates it on first use.\n");
+  fprintf(stderr, "\nCommands:\n");
+  fprintf(stderr, "  add <db> <result.json>   Ingest one run's JSON output\n");
+  fprintf(stderr, "  runs <db>                List archived runs\n");
+  fprintf(stderr, "  trend <db> <file:line>   A source line's miss rate across runs\n");
+  fprintf(stderr, "  regressions <db>         Hot lines that worsened in the newest run\n");
+  fprintf(stderr, "  matrix <db>              Preset x commit matrix of L1D miss rates\n");
+  fprintf(stderr, "  intervals <db> <run>     One run's interval series\n");
+  fprintf(stderr, "\nOptions:\n");
+  fprintf(stderr, "  --label NAME   add: benchmark/trace name (default: the JSON filename)\n");
+  fprintf(stderr, "  --commit REV   add: source revision the run measured\n");
+  fprintf(stderr, "  --time EPOCH   add: run timestamp (default: now)\n");
+  fprintf(stderr, "  --last N       trend: limit to the last N runs (default: 50)\n");
+  fprintf(stderr, "  --threshold P  regressions: minimum miss-rate rise, e.g. 0.05 (default: 0.01)\n");
+  fprintf(stderr, "\nExamples:\n");
+  fprintf(stderr, "  %s add nightly.cxrd result.json --commit abc1234 --label matrix\n", prog);
+  fprintf(stderr, "  %s trend nightly.cxrd kernel.c:42 --last 50\n", prog);
+  fprintf(stderr, "  %s regressions nightly.cxrd --threshold 0.05\n", prog);
+}
+
+struct DbOptions {
+  std::string command;
+  std::string db_path;
+  std::string argument;   // JSON file, file:line, or run id
+  std::string label;      // add --label
+  std::string commit;     // add --commit
+  uint64_t timestamp = 0; // add --time (0 = now)
+  size_t last = 50;       // trend --last
+  double threshold = 0.01; // regressions --threshold
+};
+
+bool parse_args(int argc, char *argv[], DbOptions &opts) {
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return false;
+  }
+  opts.command = argv[1];
+  opts.db_path = argv[2];
+  if (opts.command == "--help" || opts.command == "-h") {
+    print_usage(argv[0]);
+    return false;
+  }
+  for (int i = 3; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      print_usage(argv[0]);
+      return false;
+    } else if (arg == "--label" && i + 1 < argc) {
+      opts.label = argv[++i];
+    } else if (arg == "--commit" && i + 1 < argc) {
+      opts.commit = argv[++i];
+    } else if (arg == "--time" && i + 1 < argc) {
+      opts.timestamp = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--last" && i + 1 < argc) {
+      opts.last = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--threshold" && i + 1 < argc) {
+      opts.threshold = strtod(argv[++i], nullptr);
+    } else if (!arg.empty() && arg[0] == '-') {
+      fprintf(stderr, "Error: unknown option '%s'\n", arg.c_str());
+      print_usage(argv[0]);
+      return false;
+    } else {
+      opts.argument = arg;
+    }
+  }
+  return true;
+}
+
+// Load the database if it exists; 'add' starts a fresh one otherwise
+bool load_db(ResultDb &db, const DbOptions &opts, bool must_exist) {
+  std::ifstream probe(opts.db_path, std::ios::binary);
+  if (!probe) {
+    if (must_exist) {
+      fprintf(stderr, "Error: cannot open database '%s'\n",
+              opts.db_path.c_str());
+      return false;
+    }
+    return true;
+  }
+  probe.close();
+  db.load(opts.db_path);
+  return true;
+}
+
+int run_add(const DbOptions &opts) {
+  std::ifstream in(opts.argument, std::ios::binary);
+  if (!in) {
+    fprintf(stderr, "Error: cannot open result JSON '%s'\n",
+            opts.argument.c_str());
+    return 1;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  auto doc = JsonParser::parse(buffer.str());
+  if (!doc) {
+    fprintf(stderr, "Error: '%s' is not valid JSON\n", opts.argument.c_str());
+    return 1;
+  }
+
+  std::string label = opts.label;
+  if (label.empty()) {
+    size_t slash = opts.argument.find_last_of('/');
+    label = slash == std::string::npos ? opts.argument
+                                       : opts.argument.substr(slash + 1);
+  }
+  uint64_t timestamp = opts.timestamp
+                           ? opts.timestamp
+                           : static_cast<uint64_t>(time(nullptr));
+
+  ResultDb db;
+  if (!load_db(db, opts, false))
+    return 1;
+  uint32_t id = db.add_run(*doc, label, opts.commit, timestamp);
+  db.save(opts.db_path);
+  printf("run %u: %s added to %s (%zu runs, %zu hot lines)\n", id,
+         label.c_str(), opts.db_path.c_str(), db.run_count(),
+         db.hot_line_count());
+  return 0;
+}
+
+int run_runs(const DbOptions &opts) {
+  ResultDb db;
+  if (!load_db(db, opts, true))
+    return 1;
+  printf("%-4s %-12s %-20s %-12s %-12s %12s %9s\n", "id", "config", "label",
+         "commit", "timestamp", "events", "l1d-miss");
+  for (uint32_t id = 0; id < db.run_count(); id++) {
+    ResultRun run = db.get_run(id);
+    printf("%-4u %-12.*s %-20.*s %-12.*s %-12llu %12llu %8.2f%%\n", id,
+           (int)run.config.size(), run.config.data(), (int)run.label.size(),
+           run.label.data(), (int)run.commit.size(), run.commit.data(),
+           (unsigned long long)run.timestamp,
+           (unsigned long long)run.events, run.l1d_miss_rate() * 100);
+  }
+  return 0;
+}
+
+int run_trend(const DbOptions &opts) {
+  size_t colon = opts.argument.find_last_of(':');
+  if (colon == std::string::npos) {
+    fprintf(stderr, "Error: trend expects <file:line>\n");
+    return 1;
+  }
+  std::string file = opts.argument.substr(0, colon);
+  uint32_t line = static_cast<uint32_t>(
+      strtoul(opts.argument.c_str() + colon + 1, nullptr, 10));
+
+  ResultDb db;
+  if (!load_db(db, opts, true))
+    return 1;
+  auto points = db.trend(file, line, opts.last);
+  if (points.empty()) {
+    printf("%s:%u never ranked among the hot lines\n", file.c_str(), line);
+    return 0;
+  }
+  printf("%s:%u across the last %zu run(s):\n", file.c_str(), line,
+         points.size());
+  for (const auto &p : points) {
+    printf("  run %-4u %-12.*s %8llu misses / %8llu accesses  %6.2f%%\n",
+           p.run, (int)p.commit.size(), p.commit.data(),
+           (unsigned long long)p.misses,
+           (unsigned long long)(p.hits + p.misses), p.miss_rate() * 100);
+  }
+  return 0;
+}
+
+int run_regressions(const DbOptions &opts) {
+  ResultDb db;
+  if (!load_db(db, opts, true))
+    return 1;
+  if (db.run_count() < 2) {
+    fprintf(stderr, "Error: regressions needs at least two archived runs\n");
+    return 1;
+  }
+  auto found = db.regressions(opts.threshold);
+  if (found.empty()) {
+    printf("no hot line worsened by %.1f%% or more\n", opts.threshold * 100);
+    return 0;
+  }
+  for (const auto &r : found) {
+    printf("%.*s:%u  %6.2f%% -> %6.2f%%  (+%.2f%%, %llu misses)\n",
+           (int)r.file.size(), r.file.data(), r.line, r.before_rate * 100,
+           r.after_rate * 100, (r.after_rate - r.before_rate) * 100,
+           (unsigned long long)r.after_misses);
+  }
+  return 0;
+}
+
+int run_matrix(const DbOptions &opts) {
+  ResultDb db;
+  if (!load_db(db, opts, true))
+    return 1;
+  printf("%-12s %-12s %-6s %9s\n", "config", "commit", "run", "l1d-miss");
+  for (const auto &cell : db.matrix()) {
+    printf("%-12.*s %-12.*s %-6u %8.2f%%\n", (int)cell.config.size(),
+           cell.config.data(), (int)cell.commit.size(), cell.commit.data(),
+           cell.run, cell.l1d_miss_rate * 100);
+  }
+  return 0;
+}
+
+int run_intervals(const DbOptions &opts) {
+  ResultDb db;
+  if (!load_db(db, opts, true))
+    return 1;
+  uint32_t run = static_cast<uint32_t>(
+      strtoul(opts.argument.c_str(), nullptr, 10));
+  if (run >= db.run_count()) {
+    fprintf(stderr, "Error: no run %u (database holds %zu)\n", run,
+            db.run_count());
+    return 1;
+  }
+  auto rows = db.intervals(run);
+  if (rows.empty()) {
+    printf("run %u carried no interval series (--interval)\n", run);
+    return 0;
+  }
+  printf("%-6s %12s %12s %12s %9s\n", "window", "events", "l1d-hits",
+         "l1d-misses", "miss");
+  for (size_t i = 0; i < rows.size(); i++) {
+    uint64_t total = rows[i][1] + rows[i][2];
+    printf("%-6zu %12llu %12llu %12llu %8.2f%%\n", i,
+           (unsigned long long)rows[i][0], (unsigned long long)rows[i][1],
+           (unsigned long long)rows[i][2],
+           total ? 100.0 * rows[i][2] / total : 0.0);
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  DbOptions opts;
+  if (!parse_args(argc, argv, opts)) {
+    return 1;
+  }
+
+  try {
+    if (opts.command == "add") {
+      if (opts.argument.empty()) {
+        fprintf(stderr, "Error: add expects a result JSON file\n");
+        return 1;
+      }
+      return run_add(opts);
+    } else if (opts.command == "runs") {
+      return run_runs(opts);
+    } else if (opts.command == "trend") {
+      if (opts.argument.empty()) {
+        fprintf(stderr, "Error: trend expects <file:line>\n");
+        return 1;
+      }
+      return run_trend(opts);
+    } else if (opts.command == "regressions") {
+      return run_regressions(opts);
+    } else if (opts.command == "matrix") {
+      return run_matrix(opts);
+    } else if (opts.command == "intervals") {
+      if (opts.argument.empty()) {
+        fprintf(stderr, "Error: intervals expects a run id\n");
+        return 1;
+      }
+      return run_intervals(opts);
+    }
+  } catch (const std::exception &e) {
+    fprintf(stderr, "Error: %s\n", e.what());
+    return 1;
+  }
+
+  fprintf(stderr, "Error: unknown command '%s'\n", opts.command.c_str());
+  print_usage(argv[0]);
+  return 1;
+}
@@ -0,0 +1,189 @@
+#include "../include/ResultDiff.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "../include/JsonParser.hpp"
+#include "../include/JsonWriter.hpp"
+
+std::optional<BaselineResult> BaselineResult::load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::nullopt;
+  std::ostringstream buf;
+  buf << in.rdbuf();
+  std::string text = buf.str();
+
+  auto doc = JsonParser::parse(text);
+  if (!doc || doc->type != JsonValue::Type::Object)
+    return std::nullopt;
+
+  BaselineResult result;
+  if (const JsonValue *config = doc->find("config"))
+    result.config = config->as_string();
+  if (const JsonValue *events = doc->find("events"))
+    result.events = events->as_u64();
+  if (const JsonValue *cycles = doc->find("timing", "totalCycles"))
+    result.total_cycles = cycles->as_u64();
+
+  auto load_level = [&doc](BaselineLevel &level, const char *name,
+                           const char *alias) {
+    const JsonValue *v = doc->find("levels", name);
+    if (v == nullptr && alias != nullptr)
+      v = doc->find("levels", alias);
+    if (v == nullptr)
+      return;
+    level.present = true;
+    if (const JsonValue *hits = v->find("hits"))
+      level.hits = hits->as_u64();
+    if (const JsonValue *misses = v->find("misses"))
+      level.misses = misses->as_u64();
+  };
+  load_level(result.l1d, "l1d", "l1"); // multi-core reports name it "l1"
+  load_level(result.l2, "l2", nullptr);
+  load_level(result.l3, "l3", nullptr);
+  if (!result.l1d.present)
+    return std::nullopt; // not a result document
+
+  if (const JsonValue *hot = doc->find("hotLines");
+      hot != nullptr && hot->type == JsonValue::Type::Array) {
+    for (const JsonValue &entry : hot->array) {
+      BaselineHotLine h;
+      if (const JsonValue *file = entry.find("file"))
+        h.file = file->as_string();
+      if (const JsonValue *line = entry.find("line"))
+        h.line = static_cast<uint32_t>(line->as_u64());
+      if (const JsonValue *hits = entry.find("hits"))
+        h.hits = hits->as_u64();
+      if (const JsonValue *misses = entry.find("misses"))
+        h.misses = misses->as_u64();
+      result.hot_lines.push_back(std::move(h));
+    }
+  }
+  return result;
+}
+
+namespace {
+
+void write_level_diff(JsonWriter &w, const char *name, const CacheStats &cur,
+                      const BaselineLevel &base, bool last) {
+  double cur_rate = cur.hit_rate();
+  w.raw("    \"");
+  w.raw(name);
+  w.raw("\": {\"hitRate\": ");
+  w.fixed(cur_rate, 3);
+  w.raw(", \"baselineHitRate\": ");
+  w.fixed(base.hit_rate(), 3);
+  w.raw(", \"delta\": ");
+  w.fixed(cur_rate - base.hit_rate(), 3);
+  w.raw(", \"misses\": ");
+  w.number(cur.misses);
+  w.raw(", \"baselineMisses\": ");
+  w.number(base.misses);
+  w.raw(last ? "}\n" : "},\n");
+}
+
+void write_hot_entry(JsonWriter &w, const BaselineHotLine &h) {
+  w.raw("{\"file\": \"");
+  w.escaped(h.file);
+  w.raw("\", \"line\": ");
+  w.number(h.line);
+  w.raw(", \"misses\": ");
+  w.number(h.misses);
+  w.raw("}");
+}
+
+} // namespace
+
+void write_result_diff(std::ostream &out, const std::string &config_name,
+                       uint64_t events, const CacheStats &l1d,
+                       const CacheStats &l2, const CacheStats &l3,
+                       uint64_t total_cycles,
+                       const std::vector<BaselineHotLine> &hot_lines,
+                       const BaselineResult &baseline, size_t top_k) {
+  JsonWriter w(4096);
+  w.raw("{\n  \"type\": \"diff\",\n  \"config\": \"");
+  w.escaped(config_name);
+  w.raw("\",\n");
+  if (!baseline.config.empty() && baseline.config != config_name) {
+    // Same warning the frontend shows: deltas across presets mislead
+    w.raw("  \"configMismatch\": \"");
+    w.escaped(baseline.config);
+    w.raw("\",\n");
+  }
+  w.raw("  \"events\": ");
+  w.number(events);
+  w.raw(",\n  \"baselineEvents\": ");
+  w.number(baseline.events);
+  w.raw(",\n  \"levels\": {\n");
+  write_level_diff(w, "l1d", l1d, baseline.l1d, false);
+  write_level_diff(w, "l2", l2, baseline.l2, false);
+  write_level_diff(w, "l3", l3, baseline.l3, true);
+  w.raw("  },\n  \"totalCycles\": {\"current\": ");
+  w.number(total_cycles);
+  w.raw(", \"baseline\": ");
+  w.number(baseline.total_cycles);
+  w.raw("},\n");
+
+  // Hot-line movement within the top-K, keyed by file:line
+  auto key_of = [](const std::string &file, uint32_t line) {
+    return file + ":" + std::to_string(line);
+  };
+  std::unordered_map<std::string, const BaselineHotLine *> baseline_by_key;
+  size_t baseline_k = std::min(top_k, baseline.hot_lines.size());
+  for (size_t i = 0; i < baseline_k; i++)
+    baseline_by_key.emplace(
+        key_of(baseline.hot_lines[i].file, baseline.hot_lines[i].line),
+        &baseline.hot_lines[i]);
+
+  // entered: new in the current top-K; changed: in both, with deltas
+  w.raw("  \"hotLines\": {\n    \"entered\": [");
+  size_t current_k = std::min(top_k, hot_lines.size());
+  bool first = true;
+  for (size_t i = 0; i < current_k; i++) {
+    if (baseline_by_key.count(key_of(hot_lines[i].file, hot_lines[i].line)))
+      continue;
+    if (!first) w.raw(", ");
+    first = false;
+    write_hot_entry(w, hot_lines[i]);
+  }
+  w.raw("],\n    \"changed\": [");
+  first = true;
+  for (size_t i = 0; i < current_k; i++) {
+    auto it = baseline_by_key.find(key_of(hot_lines[i].file, hot_lines[i].line));
+    if (it == baseline_by_key.end())
+      continue;
+    if (!first) w.raw(", ");
+    first = false;
+    w.raw("{\"file\": \"");
+    w.escaped(hot_lines[i].file);
+    w.raw("\", \"line\": ");
+    w.number(hot_lines[i].line);
+    w.raw(", \"misses\": ");
+    w.number(hot_lines[i].misses);
+    w.raw(", \"baselineMisses\": ");
+    w.number(it->second->misses);
+    w.raw(", \"delta\": ");
+    w.number(static_cast<int64_t>(hot_lines[i].misses) -
+             static_cast<int64_t>(it->second->misses));
+    w.raw("}");
+  }
+
+  // resolved: baseline lines that dropped off the current list
+  w.raw("],\n    \"resolved\": [");
+  first = true;
+  std::unordered_map<std::string, bool> current_keys;
+  for (size_t i = 0; i < current_k; i++)
+    current_keys.emplace(key_of(hot_lines[i].file, hot_lines[i].line), true);
+  for (size_t i = 0; i < baseline_k; i++) {
+    const BaselineHotLine &h = baseline.hot_lines[i];
+    if (current_keys.count(key_of(h.file, h.line)))
+      continue;
+    if (!first) w.raw(", ");
+    first = false;
+    write_hot_entry(w, h);
+  }
+  w.raw("]\n  }\n}\n");
+  w.flush(out);
+}
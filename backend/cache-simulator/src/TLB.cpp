@@ -72,3 +72,29 @@ void TLB::reset_stats() {
     stats.reset();
     seen_pages.clear();
 }
+
+void TLB::save_state(CheckpointWriter& w) const {
+    w.write<uint64_t>(config.entries);
+    w.write<uint64_t>(config.associativity);
+    w.write<uint64_t>(config.page_size);
+    for (const auto& set : sets) {
+        w.write_vec(set);
+    }
+    // Base counters only - the slab's alignment padding is a memory-layout
+    // concern, not part of the checkpoint format
+    w.write<TLBStats>(stats);
+    w.write(access_counter);
+    w.write_set(seen_pages);
+}
+
+void TLB::load_state(CheckpointReader& r) {
+    r.expect<uint64_t>(config.entries, "TLB entries");
+    r.expect<uint64_t>(config.associativity, "TLB associativity");
+    r.expect<uint64_t>(config.page_size, "TLB page size");
+    for (auto& set : sets) {
+        r.read_vec_expect(set, "TLB ways");
+    }
+    stats = r.read<TLBStats>();
+    access_counter = r.read<uint64_t>();
+    r.read_set(seen_pages);
+}
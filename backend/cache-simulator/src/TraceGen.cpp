@@ -0,0 +1,289 @@
+/**
+ * trace-gen - synthetic trace generator for the cache simulator
+ *
+ * Emits traces with controlled characteristics so the benchmark suite
+ * and policy validation have known-answer inputs, and so we can stress
+ * production-sized runs without shipping the real 40GB traces around:
+ *
+ *   - working-set size (how much unique memory the trace touches)
+ *   - access pattern: sequential, strided, random, pointer-chase, mixed
+ *   - read/write mix
+ *   - thread count and sharing ratio (fraction of accesses that land in
+ *     a region shared by all threads - drives MESI/false-sharing work)
+ *
+ * Output is the text protocol by default ("L 0x... 8 T0") or the CXTB
+ * binary format with --binary, both straight to stdout:
+ *
+ *   trace-gen --events 1000000 --working-set 8M --pattern stride \
+ *             --stride 4096 | cache-sim --json --config intel
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/BinaryTrace.hpp"
+
+namespace {
+
+enum class Pattern { Sequential, Stride, Random, PointerChase, Mixed };
+
+struct GenOptions {
+  uint64_t events = 100000;
+  uint64_t working_set = 1 << 20; // 1MB
+  Pattern pattern = Pattern::Sequential;
+  uint64_t stride = 64;
+  uint64_t chase_depth = 4096; // nodes in the pointer-chase cycle
+  int threads = 1;
+  double sharing_ratio = 0.0; // fraction of accesses to the shared region
+  double write_ratio = 0.25;
+  uint64_t seed = 42;
+  bool binary = false;
+};
+
+void print_usage(const char *prog) {
+  fprintf(stderr, "Usage: %s [options]\n", prog);
+  fprintf(stderr, "\nSynthetic trace generator (writes to stdout)\n");
+  fprintf(stderr, "\nOptions:\n");
+  fprintf(stderr, "  --events N         Number of events to emit (default 100000)\n");
+  fprintf(stderr, "  --working-set SZ   Unique bytes touched, accepts K/M/G suffix (default 1M)\n");
+  fprintf(stderr, "  --pattern P        sequential|stride|random|chase|mixed (default sequential)\n");
+  fprintf(stderr, "  --stride N         Byte stride for the stride pattern (default 64)\n");
+  fprintf(stderr, "  --chase-depth N    Nodes in the pointer-chase cycle (default 4096)\n");
+  fprintf(stderr, "  --threads N        Round-robin events across N threads (default 1)\n");
+  fprintf(stderr, "  --sharing R        Fraction of accesses to a region shared by all\n");
+  fprintf(stderr, "                     threads, 0..1 (default 0; needs --threads > 1)\n");
+  fprintf(stderr, "  --write-ratio R    Fraction of accesses that are stores (default 0.25)\n");
+  fprintf(stderr, "  --seed N           RNG seed for reproducible traces (default 42)\n");
+  fprintf(stderr, "  --binary           Emit the CXTB binary format instead of text\n");
+  fprintf(stderr, "\nExamples:\n");
+  fprintf(stderr, "  %s --events 1000000 --working-set 8M --pattern random\n", prog);
+  fprintf(stderr, "  %s --pattern chase --chase-depth 65536 | cache-sim --json\n", prog);
+  fprintf(stderr, "  %s --threads 4 --sharing 0.2 --binary > shared.bin\n", prog);
+}
+
+// Parse a size with an optional K/M/G suffix ("8M" -> 8388608)
+uint64_t parse_size(const char *arg) {
+  char *end = nullptr;
+  uint64_t value = strtoull(arg, &end, 10);
+  if (end != nullptr) {
+    switch (*end) {
+    case 'K': case 'k': value <<= 10; break;
+    case 'M': case 'm': value <<= 20; break;
+    case 'G': case 'g': value <<= 30; break;
+    default: break;
+    }
+  }
+  return value;
+}
+
+bool parse_args(int argc, char *argv[], GenOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      print_usage(argv[0]);
+      return false;
+    } else if (arg == "--events" && i + 1 < argc) {
+      opts.events = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--working-set" && i + 1 < argc) {
+      opts.working_set = parse_size(argv[++i]);
+    } else if (arg == "--pattern" && i + 1 < argc) {
+      std::string p = argv[++i];
+      if (p == "sequential") opts.pattern = Pattern::Sequential;
+      else if (p == "stride") opts.pattern = Pattern::Stride;
+      else if (p == "random") opts.pattern = Pattern::Random;
+      else if (p == "chase") opts.pattern = Pattern::PointerChase;
+      else if (p == "mixed") opts.pattern = Pattern::Mixed;
+      else {
+        fprintf(stderr, "Error: unknown pattern '%s'\n", p.c_str());
+        return false;
+      }
+    } else if (arg == "--stride" && i + 1 < argc) {
+      opts.stride = parse_size(argv[++i]);
+    } else if (arg == "--chase-depth" && i + 1 < argc) {
+      opts.chase_depth = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      opts.threads = atoi(argv[++i]);
+    } else if (arg == "--sharing" && i + 1 < argc) {
+      opts.sharing_ratio = atof(argv[++i]);
+    } else if (arg == "--write-ratio" && i + 1 < argc) {
+      opts.write_ratio = atof(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      opts.seed = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--binary") {
+      opts.binary = true;
+    } else {
+      fprintf(stderr, "Error: unknown option '%s'\n", arg.c_str());
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+  if (opts.events == 0 || opts.working_set < 64) {
+    fprintf(stderr, "Error: need --events > 0 and --working-set >= 64\n");
+    return false;
+  }
+  if (opts.threads < 1) {
+    fprintf(stderr, "Error: --threads must be >= 1\n");
+    return false;
+  }
+  if (opts.sharing_ratio < 0.0 || opts.sharing_ratio > 1.0 ||
+      opts.write_ratio < 0.0 || opts.write_ratio > 1.0) {
+    fprintf(stderr, "Error: --sharing and --write-ratio must be in [0, 1]\n");
+    return false;
+  }
+  return true;
+}
+
+// Generates line-aligned offsets into the working set, one pattern each.
+// Each thread gets its own private cursor so per-thread streams look like
+// real per-thread streams rather than one interleaved walk.
+class AddressGenerator {
+public:
+  AddressGenerator(const GenOptions &opts)
+      : opts_(opts), rng_(opts.seed),
+        lines_(opts.working_set / 64),
+        cursors_(static_cast<size_t>(opts.threads), 0) {
+    // Stagger private cursors so threads don't trivially share everything
+    for (size_t t = 0; t < cursors_.size(); t++) {
+      cursors_[t] = (t * lines_) / cursors_.size();
+    }
+    if (opts.pattern == Pattern::PointerChase ||
+        opts.pattern == Pattern::Mixed) {
+      build_chase_cycle();
+    }
+  }
+
+  uint64_t next_offset(int thread) {
+    uint64_t &cursor = cursors_[static_cast<size_t>(thread)];
+    switch (opts_.pattern) {
+    case Pattern::Sequential:
+      cursor = (cursor + 1) % lines_;
+      return cursor * 64;
+    case Pattern::Stride: {
+      uint64_t stride_lines = opts_.stride / 64;
+      if (stride_lines == 0) stride_lines = 1;
+      cursor = (cursor + stride_lines) % lines_;
+      return cursor * 64;
+    }
+    case Pattern::Random:
+      return (rng_() % lines_) * 64;
+    case Pattern::PointerChase:
+      cursor = chase_next_[cursor % chase_next_.size()];
+      return cursor * 64;
+    case Pattern::Mixed:
+      // One-third each: unit-stride streaming, random, pointer chasing -
+      // roughly what a real mixed workload's reuse profile looks like
+      switch (rng_() % 3) {
+      case 0:
+        cursor = (cursor + 1) % lines_;
+        return cursor * 64;
+      case 1:
+        return (rng_() % lines_) * 64;
+      default:
+        cursor = chase_next_[cursor % chase_next_.size()];
+        return cursor * 64;
+      }
+    }
+    return 0;
+  }
+
+private:
+  void build_chase_cycle() {
+    // Random single-cycle permutation (Sattolo's algorithm) so the chase
+    // visits chase_depth distinct lines with no shortcut the prefetchers
+    // could learn
+    uint64_t depth = std::min(opts_.chase_depth, lines_);
+    if (depth < 2) depth = 2;
+    std::vector<uint64_t> perm(depth);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (uint64_t i = depth - 1; i > 0; i--) {
+      std::swap(perm[i], perm[rng_() % i]);
+    }
+    chase_next_.assign(depth, 0);
+    for (uint64_t i = 0; i < depth; i++) {
+      chase_next_[perm[i]] = perm[(i + 1) % depth];
+    }
+  }
+
+  const GenOptions &opts_;
+  std::mt19937_64 rng_;
+  uint64_t lines_;
+  std::vector<uint64_t> cursors_;
+  std::vector<uint64_t> chase_next_;
+};
+
+void emit_binary_header() {
+  fwrite(BINARY_TRACE_MAGIC, 1, sizeof(BINARY_TRACE_MAGIC), stdout);
+  uint32_t version = BINARY_TRACE_VERSION;
+  fwrite(&version, sizeof(version), 1, stdout);
+}
+
+void emit_binary_event(uint64_t addr, bool is_write, uint32_t thread_id) {
+  BinaryEventRecord rec = {};
+  rec.address = addr | (is_write ? BINARY_STORE_FLAG : 0);
+  rec.size = 8;
+  rec.thread_id = thread_id;
+  fputc(BINARY_RECORD_EVENT, stdout);
+  fwrite(&rec, 1, BINARY_EVENT_RECORD_SIZE, stdout);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  GenOptions opts;
+  if (!parse_args(argc, argv, opts)) {
+    return 1;
+  }
+
+  // Layout: each thread owns a private slice of the working set, plus one
+  // shared region the size of a slice that --sharing accesses land in.
+  // All regions are line-aligned so sharing is real line sharing.
+  uint64_t regions = static_cast<uint64_t>(opts.threads) +
+                     (opts.sharing_ratio > 0.0 ? 1 : 0);
+  uint64_t slice = (opts.working_set / regions) & ~63ULL;
+  if (slice < 64) slice = 64;
+  const uint64_t base = 0x10000000;
+  const uint64_t shared_base = base + slice * static_cast<uint64_t>(opts.threads);
+
+  GenOptions slice_opts = opts;
+  slice_opts.working_set = slice;
+  AddressGenerator gen(slice_opts);
+
+  std::mt19937_64 rng(opts.seed ^ 0x9e3779b97f4a7c15ULL);
+  const auto threshold = [&](double ratio) {
+    return static_cast<uint64_t>(ratio * static_cast<double>(UINT64_MAX));
+  };
+  const uint64_t write_threshold = threshold(opts.write_ratio);
+  const uint64_t share_threshold = threshold(opts.sharing_ratio);
+
+  if (opts.binary) {
+    emit_binary_header();
+  }
+
+  char line[64];
+  for (uint64_t i = 0; i < opts.events; i++) {
+    int thread = static_cast<int>(i % static_cast<uint64_t>(opts.threads));
+    uint64_t offset = gen.next_offset(thread);
+    bool shared = opts.threads > 1 && rng() < share_threshold;
+    uint64_t addr = (shared ? shared_base
+                            : base + slice * static_cast<uint64_t>(thread)) +
+                    offset;
+    bool is_write = rng() < write_threshold;
+
+    if (opts.binary) {
+      emit_binary_event(addr, is_write, static_cast<uint32_t>(thread));
+    } else {
+      int len = snprintf(line, sizeof(line), "%c 0x%" PRIx64 " 8 T%d\n",
+                         is_write ? 'S' : 'L', addr, thread);
+      fwrite(line, 1, static_cast<size_t>(len), stdout);
+    }
+  }
+
+  return 0;
+}
@@ -1,9 +1,43 @@
 #include "include/TraceProcessor.hpp"
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+// Field-wise subtraction helpers (defined below with the segment-cache
+// delta capture they were written for)
+static CacheStats diff_stats(const CacheStats &after, const CacheStats &before);
+
+// The byte span [addr, addr+size) clipped to the line at line_addr, as a
+// touched-byte mask (bit i = byte i of the line; wider lines fold to 64)
+static uint64_t span_mask(uint64_t line_addr, uint64_t addr, uint32_t size,
+                          uint32_t line_size) {
+  uint64_t start = std::max(addr, line_addr);
+  uint64_t end = std::min(addr + size, line_addr + line_size);
+  if (end <= start)
+    return 0;
+  uint64_t len = end - start;
+  if (len >= 64)
+    return ~0ULL;
+  uint32_t off = (start - line_addr) & 63;
+  uint64_t bits = (1ULL << len) - 1;
+  uint64_t mask = bits << off;
+  if (off + len > 64)
+    mask |= bits >> (64 - off);
+  return mask;
+}
 
 void TraceProcessor::process_line_access(uint64_t line_addr, bool is_write,
                                          bool is_icache, std::string_view file,
-                                         uint32_t line, uint32_t event_size) {
+                                         uint32_t line, uint32_t event_size,
+                                         uint64_t access_addr) {
+  // Set sampling: only lines in the deterministic 1-in-n subset are
+  // simulated; everything downstream sees a proportionally thinner trace
+  if (set_sample_factor > 1 &&
+      (line_addr / cache.get_l1d().get_line_size()) % set_sample_factor != 0)
+    return;
+
   SystemAccessResult result;
   if (is_icache) {
     result = cache.fetch(line_addr);
@@ -13,34 +47,69 @@ void TraceProcessor::process_line_access(uint64_t line_addr, bool is_write,
     result = cache.read(line_addr);
   }
 
+  // Working-set sketch: every distinct line touched this window
+  wss.observe(line_addr);
+
+  // Conflict-miss what-if shadows follow the demand data stream only -
+  // instruction fetches have their own cache and their own geometry
+  if (remap && !is_icache) {
+    remap->observe(line_addr, file, line);
+  }
+
   // Track prefetch usefulness
   if (!is_write && prefetched_addresses.count(line_addr)) {
     sw_prefetch_stats.useful++;
     prefetched_addresses.erase(line_addr);
   }
 
+  // Attribute the access to its owning heap allocation, if any
+  if (!live_allocs.empty()) {
+    attribute_heap_access(line_addr, result);
+  }
+
+  // Bucket data traffic by region kind (stack/global/heap/other)
+  if (!is_icache) {
+    record_region_access(line_addr, result);
+  }
+
   if (!file.empty()) {
+    // The file view is interned (stable for the whole run), so it can be
+    // used as the map key directly - no per-location string copy needed
     SourceKey key{file, line};
     auto it = source_stats.find(key);
     if (it == source_stats.end()) {
-      // First access to this source location - store the file string
       SourceStats stats;
-      stats.file = std::string(file);
+      stats.file = file;
       stats.line = line;
-      // Use the stored string for the key to ensure lifetime safety
-      auto [inserted_it, _] = source_stats.emplace(
-          SourceKey{stats.file, line}, std::move(stats));
-      it = inserted_it;
+      it = source_stats.emplace(key, std::move(stats)).first;
     }
     if (result.l1_hit)
       it->second.hits++;
     else
       it->second.misses++;
+
+    // Cache-line utilization: a miss refills the line, closing the
+    // previous residency into its filler's aggregate and starting a new
+    // one owned by this site; a hit just widens the touched span
+    if (!is_icache) {
+      uint64_t span = span_mask(line_addr, access_addr, event_size,
+                                cache.get_l1d().get_line_size());
+      if (span) {
+        auto lu = line_use.find(line_addr);
+        if (!result.l1_hit) {
+          if (lu != line_use.end())
+            close_line_residency(lu->second);
+          line_use[line_addr] = {span, key};
+        } else if (lu != line_use.end()) {
+          lu->second.mask |= span;
+        }
+      }
+    }
   }
 
-  if (event_callback) {
-    event_callback({result.l1_hit, result.l2_hit, result.l3_hit, line_addr,
-                    event_size, std::string(file), line});
+  if (event_hook) {
+    event_hook(event_hook_ctx, {result.l1_hit, result.l2_hit, result.l3_hit,
+                                line_addr, event_size, file, line});
   }
 }
 
@@ -48,7 +117,54 @@ TraceProcessor::TraceProcessor(const CacheHierarchyConfig &cfg) : cache(cfg) {}
 
 void TraceProcessor::set_event_callback(
     std::function<void(const EventResult &)> cb) {
+  // Boundary adapter: the hot path only sees the static hook, which
+  // forwards into the stored type-erased callable
   event_callback = std::move(cb);
+  if (event_callback) {
+    set_event_hook(
+        [](void *ctx, const EventResult &r) {
+          (*static_cast<std::function<void(const EventResult &)> *>(ctx))(r);
+        },
+        &event_callback);
+  } else {
+    set_event_hook(nullptr, nullptr);
+  }
+}
+
+void TraceProcessor::set_batch_callback(BatchCallback cb, size_t batch_size) {
+  batch_callback = std::move(cb);
+  result_batch_size = batch_size ? batch_size : 1;
+  result_buffer.clear();
+  event_callback = nullptr;
+  if (batch_callback) {
+    result_buffer.reserve(result_batch_size);
+    // Route through the per-event hook internally so process_line_access
+    // stays unchanged - the buffering is what amortizes the callback cost
+    set_event_hook(
+        [](void *ctx, const EventResult &r) {
+          auto *self = static_cast<TraceProcessor *>(ctx);
+          self->result_buffer.push_back(r);
+          if (self->result_buffer.size() >= self->result_batch_size)
+            self->flush_results();
+        },
+        this);
+  } else {
+    set_event_hook(nullptr, nullptr);
+  }
+}
+
+void TraceProcessor::flush_results() {
+  if (batch_callback && !result_buffer.empty()) {
+    batch_callback(result_buffer.data(), result_buffer.size());
+    result_buffer.clear();
+  }
+}
+
+void TraceProcessor::process_batch(const TraceEvent *events, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    process(events[i]);
+  }
+  flush_results();
 }
 
 void TraceProcessor::enable_prefetching(PrefetchPolicy policy, int degree) {
@@ -69,7 +185,375 @@ const PrefetchStats &TraceProcessor::get_prefetch_stats() const {
   return cache.get_prefetch_stats();
 }
 
+void TraceProcessor::process_heap_event(const TraceEvent &event) {
+  if (event.is_free) {
+    auto it = live_allocs.find(event.address);
+    if (it != live_allocs.end()) {
+      heap_sites[it->second.site].live_bytes -= it->second.size;
+      live_allocs.erase(it);
+    }
+    return;
+  }
+
+  // Allocation: find or create the site aggregate, then record the range
+  SourceKey key{event.file, event.line};
+  auto site_it = heap_site_index.find(key);
+  uint32_t site;
+  if (site_it == heap_site_index.end()) {
+    site = static_cast<uint32_t>(heap_sites.size());
+    HeapSiteStats stats;
+    stats.file = event.file;
+    stats.line = event.line;
+    heap_sites.push_back(stats);
+    heap_site_index.emplace(key, site);
+  } else {
+    site = site_it->second;
+  }
+
+  HeapSiteStats &stats = heap_sites[site];
+  stats.alloc_count++;
+  stats.bytes_allocated += event.size;
+  stats.live_bytes += event.size;
+  stats.peak_live_bytes = std::max(stats.peak_live_bytes, stats.live_bytes);
+  live_allocs[event.address] = {event.size, site};
+
+  // Grow the heap envelope for region classification
+  heap_env_lo = std::min(heap_env_lo, event.address);
+  heap_env_hi = std::max(heap_env_hi, event.address + event.size);
+}
+
+void TraceProcessor::attribute_heap_access(uint64_t line_addr,
+                                           const SystemAccessResult &result) {
+  // Find the last allocation starting at or before this line and check
+  // containment - O(log live) per access, only paid when tracking is on
+  auto it = live_allocs.upper_bound(line_addr);
+  if (it == live_allocs.begin())
+    return;
+  --it;
+  if (line_addr >= it->first + it->second.size)
+    return;
+
+  HeapSiteStats &stats = heap_sites[it->second.site];
+  stats.accesses++;
+  if (!result.l1_hit)
+    stats.l1_misses++;
+  if (result.memory_access)
+    stats.memory_accesses++;
+}
+
+void TraceProcessor::record_region_access(uint64_t line_addr,
+                                          const SystemAccessResult &result) {
+  // Re-snapshot the global map only when a registration landed; with the
+  // version unchanged this is one relaxed-ish atomic load
+  uint64_t version = TraceRegionMap::instance().version();
+  if (version != region_version) {
+    region_ranges = TraceRegionMap::instance().snapshot();
+    region_version = version;
+  }
+  if (region_ranges.empty())
+    return; // trace carries no region map - don't report a useless "other"
+
+  RegionKind kind = RegionKind::Other;
+  for (const auto &range : region_ranges) {
+    if (line_addr >= range.lo && line_addr < range.hi) {
+      kind = range.kind;
+      break;
+    }
+  }
+  // Nothing claimed it: heap if it falls inside the allocation envelope
+  if (kind == RegionKind::Other && line_addr >= heap_env_lo &&
+      line_addr < heap_env_hi) {
+    kind = RegionKind::Heap;
+  }
+
+  RegionStats &stats = region_stats[static_cast<size_t>(kind)];
+  stats.accesses++;
+  if (!result.l1_hit)
+    stats.l1_misses++;
+  if (result.memory_access)
+    stats.memory_accesses++;
+}
+
+void TraceProcessor::record_heap_density(uint64_t addr, uint32_t size) {
+  auto it = live_allocs.upper_bound(addr);
+  if (it == live_allocs.begin())
+    return;
+  --it;
+  if (addr >= it->first + it->second.size)
+    return;
+
+  HeapSiteStats &stats = heap_sites[it->second.site];
+  if (size >= 64) {
+    stats.touched_mask = ~0ULL;
+    return;
+  }
+  uint32_t off = addr & 63;
+  uint64_t bits = (1ULL << size) - 1;
+  stats.touched_mask |= bits << off;
+  // A span crossing the line boundary continues at the start of the next
+  // line; fold the overflowed bytes back to the low positions
+  if (off + size > 64)
+    stats.touched_mask |= bits >> (64 - off);
+}
+
+void TraceProcessor::close_line_residency(const LineUse &use) {
+  auto it = source_stats.find(use.filler);
+  if (it == source_stats.end())
+    return; // the filler's entry is created before any residency opens
+  it->second.lines_fetched++;
+  it->second.line_bytes_used +=
+      static_cast<uint64_t>(__builtin_popcountll(use.mask));
+}
+
+void TraceProcessor::process_phase_marker(const TraceEvent &event) {
+  if (event.is_phase_begin) {
+    // An unterminated region ends where the next one begins
+    if (phase_open) {
+      phases.push_back(capture_phase_delta());
+    }
+    phase_open = true;
+    open_phase_id = static_cast<uint32_t>(event.address);
+    phase_before = cache.get_stats();
+    return;
+  }
+  if (phase_open) {
+    phases.push_back(capture_phase_delta());
+    phase_open = false;
+  }
+}
+
+PhaseStats TraceProcessor::capture_phase_delta() const {
+  HierarchyStats after = cache.get_stats();
+  PhaseStats p;
+  p.id = open_phase_id;
+  p.l1d = diff_stats(after.l1d, phase_before.l1d);
+  p.l2 = diff_stats(after.l2, phase_before.l2);
+  p.l3 = diff_stats(after.l3, phase_before.l3);
+  p.cycles = after.timing.total_cycles - phase_before.timing.total_cycles;
+  return p;
+}
+
+void TraceProcessor::begin_warmup() {
+  warming = true;
+  // 3C classification is the expensive part of a demand access, and the
+  // boundary reset wipes its filter anyway - compulsory misses are
+  // counted relative to the measured region, not the warmup
+  warmup_3c_restore = cache.get_l1d().is_tracking_3c_misses();
+  cache.set_fast_mode(true);
+}
+
+void TraceProcessor::finish_warmup() {
+  if (!warming) {
+    return;
+  }
+  warming = false;
+  cache.set_fast_mode(!warmup_3c_restore);
+  cache.reset_all_stats();
+  sw_prefetch_stats = {};
+  prefetched_addresses.clear();
+  line_use.clear(); // residencies opened pre-boundary have no counters left
+  // A region opened during warmup re-baselines against the wiped stats
+  if (phase_open) {
+    phase_before = cache.get_stats();
+  }
+}
+
+void TraceProcessor::warm_event(const TraceEvent &event) {
+  // Side-band records still matter while warming: heap records define
+  // the ranges later accesses attribute to, phase markers delimit
+  // regions that may extend past the warmup boundary
+  if (event.is_phase_begin || event.is_phase_end) {
+    process_phase_marker(event);
+    return;
+  }
+  if (event.is_alloc || event.is_free) {
+    process_heap_event(event);
+    return;
+  }
+
+  if (event.is_range) {
+    TraceEvent scalar = event;
+    scalar.is_range = false;
+    scalar.stride = 0;
+    scalar.count = 0;
+    for (uint64_t i = 0; i < event.count; i++) {
+      warm_event(scalar);
+      scalar.address += (uint64_t)event.stride;
+    }
+    return;
+  }
+
+  uint32_t line_size = event.is_icache ? cache.get_l1i().get_line_size()
+                                       : cache.get_l1d().get_line_size();
+
+  if (event.is_prefetch) {
+    cache.read((event.address / line_size) * line_size);
+    return;
+  }
+
+  if (event.is_memcpy || event.is_memmove) {
+    auto src_lines = split_access_to_cache_lines(
+        {event.src_address, event.size, false}, line_size);
+    for (const auto &line_access : src_lines) {
+      cache.read(line_access.line_address);
+    }
+    auto dst_lines = split_access_to_cache_lines(
+        {event.address, event.size, true}, line_size);
+    for (const auto &line_access : dst_lines) {
+      cache.write(line_access.line_address);
+    }
+    return;
+  }
+
+  if (event.is_memset) {
+    auto lines =
+        split_access_to_cache_lines({event.address, event.size, true}, line_size);
+    for (const auto &line_access : lines) {
+      cache.write(line_access.line_address);
+    }
+    return;
+  }
+
+  auto lines = split_access_to_cache_lines(
+      {event.address, event.size, event.is_write}, line_size);
+  for (const auto &line_access : lines) {
+    if (event.is_icache) {
+      cache.fetch(line_access.line_address);
+    } else if (event.is_write) {
+      cache.write(line_access.line_address);
+    } else {
+      cache.read(line_access.line_address);
+    }
+  }
+}
+
 void TraceProcessor::process(const TraceEvent &event) {
+  // Sample-rate records reweight everything that follows. They touch no
+  // cache state, so warmup and any buffered segment are unaffected.
+  if (event.is_sample_rate) {
+    sampling.on_rate_record(event.count);
+    return;
+  }
+
+  if (warming) {
+    warm_event(event);
+    return;
+  }
+
+  // Phase markers snapshot the hierarchy stats, so any buffered segment
+  // must be simulated first to land on the right side of the boundary
+  if (event.is_phase_begin || event.is_phase_end) {
+    if (segment_cache) {
+      flush_segments();
+    }
+    process_phase_marker(event);
+    return;
+  }
+
+  // Heap records don't touch the hierarchy - they just update the live
+  // allocation map. Flush any buffered segment first so accesses seen
+  // before a free are attributed before the range disappears.
+  if (event.is_alloc || event.is_free) {
+    if (segment_cache) {
+      flush_segments();
+    }
+    process_heap_event(event);
+    return;
+  }
+
+  // Compressed range events stand for `count` strided accesses; expand
+  // them here so every downstream path (segment caching, callbacks, hot
+  // lines) sees the same scalar stream the uncompressed loop produces.
+  if (event.is_range) {
+    TraceEvent scalar = event;
+    scalar.is_range = false;
+    scalar.stride = 0;
+    scalar.count = 0;
+    for (uint64_t i = 0; i < event.count; i++) {
+      process(scalar);
+      scalar.address += (uint64_t)event.stride;
+    }
+    return;
+  }
+
+  // Every scalar access from here down carries the current sampling
+  // weight (ranges were expanded above, so each expansion counts once)
+  sampling.on_event();
+
+  // Segment caching: buffer plain loads/stores/fetches into fixed windows
+  // and fast-forward windows whose stats delta is already memoized.
+  // Events with side-band stats (prefetch hints, memory intrinsics) and
+  // verbose callbacks flush the window and take the normal path.
+  if (segment_cache && !event_hook) {
+    bool eligible = !event.is_prefetch && !event.is_memcpy &&
+                    !event.is_memmove && !event.is_memset && !event.is_vector &&
+                    !event.is_atomic;
+    if (eligible) {
+      uint32_t flags = (event.is_write ? 1u : 0) | (event.is_icache ? 2u : 0);
+      segment_hash = SegmentCache::hash_access(segment_hash, event.address,
+                                               flags | (event.size << 8));
+      segment_buffer.push_back(event);
+      if (segment_buffer.size() >= segment_length) {
+        complete_segment();
+      }
+      return;
+    }
+    flush_segments();
+  }
+
+  simulate_event(event);
+}
+
+bool TraceProcessor::bulk_intrinsic_sweep(uint64_t base, uint64_t size,
+                                          bool is_write,
+                                          const TraceEvent &event) {
+  // Per-line features the sweep cannot aggregate: sampling thins the
+  // stream line by line, callbacks and heap attribution need a
+  // per-access result, region bucketing classifies each line, and an
+  // outstanding software prefetch is matched against individual reads
+  if (!bulk_intrinsics || set_sample_factor > 1 || event_hook ||
+      !live_allocs.empty() || !prefetched_addresses.empty()) {
+    return false;
+  }
+  uint64_t version = TraceRegionMap::instance().version();
+  if (version != region_version) {
+    region_ranges = TraceRegionMap::instance().snapshot();
+    region_version = version;
+  }
+  if (!region_ranges.empty()) {
+    return false;
+  }
+  if (!cache.bulk_sweep(base, size, is_write)) {
+    return false;
+  }
+  bulk_sweeps++;
+
+  // The bookkeeping the per-line path would have done, aggregated:
+  // every line misses L1, so the site's counts are closed-form, and the
+  // working-set sketch still sees each distinct line. Byte-span
+  // utilization is skipped - a bulk intrinsic touches every byte of
+  // every line, so the residencies it would open carry no signal.
+  uint32_t line_size = cache.get_l1d().get_line_size();
+  uint64_t first_line = base / line_size;
+  uint64_t line_count = (base + size - 1) / line_size - first_line + 1;
+  for (uint64_t j = 0; j < line_count; j++) {
+    wss.observe((first_line + j) * line_size);
+  }
+  if (!event.file.empty()) {
+    SourceKey key{event.file, event.line};
+    auto it = source_stats.find(key);
+    if (it == source_stats.end()) {
+      SourceStats stats;
+      stats.file = event.file;
+      stats.line = event.line;
+      it = source_stats.emplace(key, std::move(stats)).first;
+    }
+    it->second.misses += line_count;
+  }
+  return true;
+}
+
+void TraceProcessor::simulate_event(const TraceEvent &event) {
   uint32_t line_size = event.is_icache ? cache.get_l1i().get_line_size()
                                        : cache.get_l1d().get_line_size();
 
@@ -84,6 +568,15 @@ void TraceProcessor::process(const TraceEvent &event) {
     return; // Don't process further
   }
 
+  // Per-offset density for the layout advisor: fold the byte span into
+  // the owning allocation's touched mask before the access is split into
+  // line-granular cache operations
+  if (!live_allocs.empty() && !event.is_icache) {
+    record_heap_density(event.address, event.size);
+    if (event.is_memcpy || event.is_memmove)
+      record_heap_density(event.src_address, event.size);
+  }
+
   // Handle memcpy - generates reads from source and writes to dest
   if (event.is_memcpy || event.is_memmove) {
     if (event.is_memcpy) {
@@ -94,20 +587,26 @@ void TraceProcessor::process(const TraceEvent &event) {
       mem_intrinsic_stats.memmove_bytes += event.size;
     }
 
-    // Process source reads
-    auto src_lines = split_access_to_cache_lines(
-        {event.src_address, event.size, false}, line_size);
-    for (const auto &line_access : src_lines) {
-      process_line_access(line_access.line_address, false, false, event.file,
-                          event.line, event.size);
+    // Bulk copies sweep each range through the closed-form fast path;
+    // either range can decline independently and go line by line
+    if (!bulk_intrinsic_sweep(event.src_address, event.size, false, event)) {
+      // Process source reads
+      auto src_lines = split_access_to_cache_lines(
+          {event.src_address, event.size, false}, line_size);
+      for (const auto &line_access : src_lines) {
+        process_line_access(line_access.line_address, false, false, event.file,
+                            event.line, event.size, event.src_address);
+      }
     }
 
-    // Process dest writes
-    auto dst_lines = split_access_to_cache_lines(
-        {event.address, event.size, true}, line_size);
-    for (const auto &line_access : dst_lines) {
-      process_line_access(line_access.line_address, true, false, event.file,
-                          event.line, event.size);
+    if (!bulk_intrinsic_sweep(event.address, event.size, true, event)) {
+      // Process dest writes
+      auto dst_lines = split_access_to_cache_lines(
+          {event.address, event.size, true}, line_size);
+      for (const auto &line_access : dst_lines) {
+        process_line_access(line_access.line_address, true, false, event.file,
+                            event.line, event.size, event.address);
+      }
     }
     return;
   }
@@ -117,11 +616,15 @@ void TraceProcessor::process(const TraceEvent &event) {
     mem_intrinsic_stats.memset_count++;
     mem_intrinsic_stats.memset_bytes += event.size;
 
+    if (bulk_intrinsic_sweep(event.address, event.size, true, event)) {
+      return;
+    }
+
     auto lines =
         split_access_to_cache_lines({event.address, event.size, true}, line_size);
     for (const auto &line_access : lines) {
       process_line_access(line_access.line_address, true, false, event.file,
-                          event.line, event.size);
+                          event.line, event.size, event.address);
     }
     return;
   }
@@ -137,6 +640,26 @@ void TraceProcessor::process(const TraceEvent &event) {
     }
   }
 
+  // Gather/scatter lanes: each record is one lane of a masked vector op,
+  // so the standard path below charges the lane's own - possibly
+  // discontiguous - cache line. The op-level stats close on the last lane.
+  if (event.is_gather) {
+    auto &seen = gather_lines_in_flight[event.thread_id];
+    if (event.lane == 0) {
+      (event.is_write ? gather_stats.scatters : gather_stats.gathers)++;
+      seen.clear();
+    }
+    gather_stats.lanes++;
+    gather_stats.bytes += event.size;
+    uint64_t line_addr = (event.address / line_size) * line_size;
+    if (std::find(seen.begin(), seen.end(), line_addr) == seen.end())
+      seen.push_back(line_addr);
+    if (event.lane + 1 >= event.lanes) {
+      gather_stats.lines_touched += seen.size();
+      seen.clear();
+    }
+  }
+
   // Track atomic statistics
   if (event.is_atomic) {
     if (event.is_cmpxchg) {
@@ -161,32 +684,349 @@ void TraceProcessor::process(const TraceEvent &event) {
 
   for (const auto &line_access : lines) {
     process_line_access(line_access.line_address, event.is_write,
-                        event.is_icache, event.file, event.line, event.size);
+                        event.is_icache, event.file, event.line, event.size,
+                        event.address);
+  }
+}
+
+// Field-wise subtraction for delta capture
+static CacheStats diff_stats(const CacheStats &after,
+                             const CacheStats &before) {
+  CacheStats d;
+  d.hits = after.hits - before.hits;
+  d.misses = after.misses - before.misses;
+  d.writebacks = after.writebacks - before.writebacks;
+  d.invalidations = after.invalidations - before.invalidations;
+  d.compulsory_misses = after.compulsory_misses - before.compulsory_misses;
+  d.capacity_misses = after.capacity_misses - before.capacity_misses;
+  d.conflict_misses = after.conflict_misses - before.conflict_misses;
+  return d;
+}
+
+static TimingStats diff_timing(const TimingStats &after,
+                               const TimingStats &before) {
+  TimingStats d;
+  d.total_cycles = after.total_cycles - before.total_cycles;
+  d.l1_hit_cycles = after.l1_hit_cycles - before.l1_hit_cycles;
+  d.l2_hit_cycles = after.l2_hit_cycles - before.l2_hit_cycles;
+  d.l3_hit_cycles = after.l3_hit_cycles - before.l3_hit_cycles;
+  d.memory_cycles = after.memory_cycles - before.memory_cycles;
+  d.tlb_miss_cycles = after.tlb_miss_cycles - before.tlb_miss_cycles;
+  d.serialized_miss_cycles =
+      after.serialized_miss_cycles - before.serialized_miss_cycles;
+  d.overlapped_miss_cycles =
+      after.overlapped_miss_cycles - before.overlapped_miss_cycles;
+  d.mshr_merges = after.mshr_merges - before.mshr_merges;
+  d.mshr_full_stalls = after.mshr_full_stalls - before.mshr_full_stalls;
+  d.mshr_stall_cycles = after.mshr_stall_cycles - before.mshr_stall_cycles;
+  d.writebacks_drained = after.writebacks_drained - before.writebacks_drained;
+  d.writebacks_coalesced =
+      after.writebacks_coalesced - before.writebacks_coalesced;
+  d.writeback_full_stalls =
+      after.writeback_full_stalls - before.writeback_full_stalls;
+  d.writeback_stall_cycles =
+      after.writeback_stall_cycles - before.writeback_stall_cycles;
+  d.dram_row_hits = after.dram_row_hits - before.dram_row_hits;
+  d.dram_row_empty = after.dram_row_empty - before.dram_row_empty;
+  d.dram_row_conflicts = after.dram_row_conflicts - before.dram_row_conflicts;
+  d.dram_cycles = after.dram_cycles - before.dram_cycles;
+  d.page_walks = after.page_walks - before.page_walks;
+  d.page_walk_cycles = after.page_walk_cycles - before.page_walk_cycles;
+  d.pwc_skipped_levels = after.pwc_skipped_levels - before.pwc_skipped_levels;
+  return d;
+}
+
+static VictimStats diff_victim(const VictimStats &after,
+                               const VictimStats &before) {
+  VictimStats d;
+  d.probes = after.probes - before.probes;
+  d.hits = after.hits - before.hits;
+  d.insertions = after.insertions - before.insertions;
+  d.writebacks = after.writebacks - before.writebacks;
+  return d;
+}
+
+void TraceProcessor::enable_segment_caching(size_t window,
+                                            size_t max_segments) {
+  segment_cache = std::make_unique<SegmentCache>(max_segments);
+  segment_length = window;
+  segment_buffer.clear();
+  segment_buffer.reserve(window);
+  segment_hash = SegmentCache::HASH_SEED;
+}
+
+const SegmentCacheStats &TraceProcessor::get_segment_cache_stats() const {
+  static const SegmentCacheStats empty;
+  return segment_cache ? segment_cache->get_stats() : empty;
+}
+
+void TraceProcessor::flush_segments() {
+  for (const auto &event : segment_buffer) {
+    simulate_event(event);
+  }
+  segment_buffer.clear();
+  segment_hash = SegmentCache::HASH_SEED;
+}
+
+SegmentDelta TraceProcessor::capture_segment_delta(
+    const HierarchyStats &before, const TLBHierarchyStats &tlb_before,
+    const std::vector<SegmentSourceDelta> &sources_before) const {
+  SegmentDelta delta;
+  HierarchyStats after = cache.get_stats();
+  TLBHierarchyStats tlb_after = cache.get_tlb_stats();
+
+  delta.hierarchy.l1d = diff_stats(after.l1d, before.l1d);
+  delta.hierarchy.l1i = diff_stats(after.l1i, before.l1i);
+  delta.hierarchy.l2 = diff_stats(after.l2, before.l2);
+  delta.hierarchy.l3 = diff_stats(after.l3, before.l3);
+  delta.hierarchy.timing = diff_timing(after.timing, before.timing);
+  delta.hierarchy.victim = diff_victim(after.victim, before.victim);
+  delta.dtlb.hits = tlb_after.dtlb.hits - tlb_before.dtlb.hits;
+  delta.dtlb.misses = tlb_after.dtlb.misses - tlb_before.dtlb.misses;
+  delta.itlb.hits = tlb_after.itlb.hits - tlb_before.itlb.hits;
+  delta.itlb.misses = tlb_after.itlb.misses - tlb_before.itlb.misses;
+  delta.stlb.hits = tlb_after.stlb.hits - tlb_before.stlb.hits;
+  delta.stlb.misses = tlb_after.stlb.misses - tlb_before.stlb.misses;
+
+  for (const auto &src : sources_before) {
+    auto it = source_stats.find(SourceKey{src.file, src.line});
+    uint64_t hits_after = it != source_stats.end() ? it->second.hits : 0;
+    uint64_t misses_after = it != source_stats.end() ? it->second.misses : 0;
+    if (hits_after != src.hits || misses_after != src.misses) {
+      delta.sources.push_back({src.file, src.line, hits_after - src.hits,
+                               misses_after - src.misses});
+    }
+  }
+  return delta;
+}
+
+void TraceProcessor::complete_segment() {
+  SegmentCache::Entry *entry = segment_cache->lookup(segment_hash);
+
+  if (entry && segment_cache->can_fast_forward(*entry)) {
+    // Known-stable segment: apply the memoized delta instead of simulating
+    cache.apply_stats_delta(entry->delta.hierarchy, entry->delta.dtlb,
+                            entry->delta.itlb, entry->delta.stlb);
+    for (const auto &src : entry->delta.sources) {
+      SourceKey key{src.file, src.line};
+      auto it = source_stats.find(key);
+      if (it == source_stats.end()) {
+        SourceStats stats;
+        stats.file = src.file;
+        stats.line = src.line;
+        it = source_stats.emplace(key, std::move(stats)).first;
+      }
+      it->second.hits += src.hits;
+      it->second.misses += src.misses;
+    }
+    segment_buffer.clear();
+    segment_hash = SegmentCache::HASH_SEED;
+    return;
   }
+
+  // Simulate the window, capturing its stats delta for future fast-forwards
+  HierarchyStats before = cache.get_stats();
+  TLBHierarchyStats tlb_before = cache.get_tlb_stats();
+
+  std::vector<SegmentSourceDelta> sources_before;
+  for (const auto &event : segment_buffer) {
+    if (event.file.empty())
+      continue;
+    SourceKey key{event.file, event.line};
+    bool seen = false;
+    for (const auto &s : sources_before) {
+      if (s.file == event.file && s.line == event.line) {
+        seen = true;
+        break;
+      }
+    }
+    if (seen)
+      continue;
+    auto it = source_stats.find(key);
+    sources_before.push_back({event.file, event.line,
+                              it != source_stats.end() ? it->second.hits : 0,
+                              it != source_stats.end() ? it->second.misses : 0});
+  }
+
+  uint64_t hash = segment_hash;
+  flush_segments();
+  segment_cache->record(hash,
+                        capture_segment_delta(before, tlb_before, sources_before));
 }
 
 HierarchyStats TraceProcessor::get_stats() const { return cache.get_stats(); }
 
 std::vector<SourceStats> TraceProcessor::get_hot_lines(size_t limit) const {
+  // Lines still resident never saw their residency closed by a refetch;
+  // fold their masks in here so utilization covers the whole trace
+  std::unordered_map<SourceKey, std::pair<uint64_t, uint64_t>, SourceKeyHash>
+      open;
+  for (const auto &[addr, use] : line_use) {
+    auto &o = open[use.filler];
+    o.first++;
+    o.second += static_cast<uint64_t>(__builtin_popcountll(use.mask));
+  }
+
   std::vector<SourceStats> sorted;
   for (const auto &[key, stats] : source_stats) {
     sorted.push_back(stats);
+    auto it = open.find(key);
+    if (it != open.end()) {
+      sorted.back().lines_fetched += it->second.first;
+      sorted.back().line_bytes_used += it->second.second;
+    }
+  }
+  // Break miss-count ties on location so output is deterministic
+  // regardless of hash-map iteration order
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    if (a.misses != b.misses)
+      return a.misses > b.misses;
+    if (a.file != b.file)
+      return a.file < b.file;
+    return a.line < b.line;
+  });
+  if (sorted.size() > limit)
+    sorted.resize(limit);
+  return sorted;
+}
+
+std::vector<FunctionStats> TraceProcessor::get_hot_functions(size_t limit) const {
+  const auto &func_map = TraceFuncMap::instance();
+  if (func_map.empty())
+    return {};
+
+  // Fold lines into their enclosing functions; unattributed lines (no G
+  // record - e.g. Pin traces) stay out rather than polluting the table
+  std::unordered_map<std::string_view, FunctionStats> by_func;
+  for (const auto &[key, stats] : source_stats) {
+    std::string_view func = func_map.function_of(key.file, key.line);
+    if (func.empty())
+      continue;
+    FunctionStats &f = by_func[func];
+    f.function = func;
+    f.hits += stats.hits;
+    f.misses += stats.misses;
+    f.lines++;
+  }
+
+  std::vector<FunctionStats> sorted;
+  sorted.reserve(by_func.size());
+  for (const auto &[func, stats] : by_func)
+    sorted.push_back(stats);
+  // Same determinism contract as get_hot_lines: name breaks miss ties
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    if (a.misses != b.misses)
+      return a.misses > b.misses;
+    return a.function < b.function;
+  });
+  if (sorted.size() > limit)
+    sorted.resize(limit);
+  return sorted;
+}
+
+std::vector<PhaseStats> TraceProcessor::get_phase_stats() const {
+  std::vector<PhaseStats> result = phases;
+  if (phase_open) {
+    result.push_back(capture_phase_delta());
   }
-  std::sort(sorted.begin(), sorted.end(),
-            [](const auto &a, const auto &b) { return a.misses > b.misses; });
+  return result;
+}
+
+std::vector<HeapSiteStats> TraceProcessor::get_heap_objects(size_t limit) const {
+  std::vector<HeapSiteStats> sorted = heap_sites;
+  // DRAM trips are what the per-object report exists to expose; break
+  // ties on location for deterministic output
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    if (a.memory_accesses != b.memory_accesses)
+      return a.memory_accesses > b.memory_accesses;
+    if (a.accesses != b.accesses)
+      return a.accesses > b.accesses;
+    if (a.file != b.file)
+      return a.file < b.file;
+    return a.line < b.line;
+  });
   if (sorted.size() > limit)
     sorted.resize(limit);
   return sorted;
 }
 
+void TraceProcessor::save_checkpoint(std::ostream &out,
+                                     uint64_t events_processed) const {
+  CheckpointWriter w(out);
+  w.write(CHECKPOINT_MAGIC);
+  w.write(CHECKPOINT_VERSION);
+  w.write(events_processed);
+  cache.save_state(w);
+  w.write_set(prefetched_addresses);
+  if (!w.ok()) {
+    throw std::runtime_error("checkpoint write failed");
+  }
+}
+
+uint64_t TraceProcessor::load_checkpoint(std::istream &in) {
+  CheckpointReader r(in);
+  auto magic = r.read<std::array<char, 4>>();
+  if (std::memcmp(magic.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+    throw std::runtime_error("not a cache-sim checkpoint (bad magic)");
+  }
+  uint32_t version = r.read<uint32_t>();
+  if (version != CHECKPOINT_VERSION) {
+    throw std::runtime_error("unsupported checkpoint version " +
+                             std::to_string(version));
+  }
+  uint64_t events_processed = r.read<uint64_t>();
+  cache.load_state(r);
+  r.read_set(prefetched_addresses);
+  return events_processed;
+}
+
 void TraceProcessor::reset() {
   cache.reset_stats();
   source_stats.clear();
+  line_use.clear();
+  if (segment_cache) {
+    segment_cache->clear();
+  }
+  segment_buffer.clear();
+  segment_hash = SegmentCache::HASH_SEED;
   sw_prefetch_stats = {};
   vector_stats = {};
+  gather_stats = {};
+  gather_lines_in_flight.clear();
   atomic_stats = {};
   mem_intrinsic_stats = {};
   prefetched_addresses.clear();
+  live_allocs.clear();
+  heap_sites.clear();
+  heap_site_index.clear();
+  phases.clear();
+  phase_open = false;
+  open_phase_id = 0;
+  result_buffer.clear();
+  region_stats = {};
+  region_ranges.clear();
+  region_version = 0;
+  heap_env_lo = UINT64_MAX;
+  heap_env_hi = 0;
+  if (remap) {
+    // Shadow contents and avoided-miss attribution start over too
+    enable_remap_analysis();
+  }
+}
+
+void TraceProcessor::clear() {
+  reset();
+  cache.clear();
+  // Undo per-job configuration too - the next job reapplies its own
+  cache.set_fast_mode(false);
+  event_hook = nullptr;
+  event_hook_ctx = nullptr;
+  event_callback = nullptr;
+  batch_callback = nullptr;
+  result_buffer.clear();
+  result_batch_size = DEFAULT_RESULT_BATCH;
+  segment_cache.reset();
+  remap.reset();
 }
 
 const CacheSystem &TraceProcessor::get_cache_system() const { return cache; }
@@ -199,6 +1039,10 @@ const VectorStats &TraceProcessor::get_vector_stats() const {
   return vector_stats;
 }
 
+const GatherScatterStats &TraceProcessor::get_gather_scatter_stats() const {
+  return gather_stats;
+}
+
 const AtomicStats &TraceProcessor::get_atomic_stats() const {
   return atomic_stats;
 }
@@ -0,0 +1,944 @@
+/**
+ * trace-tool - trace preprocessing without simulation
+ *
+ * Operates on captured traces (text, CXTB binary, either zstd-compressed)
+ * in a single forward pass - inputs are mmap'd or bulk-read and walked
+ * with the FastIO machinery, never materialized as an event vector. This
+ * replaces the awk pipelines we used to keep around for trace surgery,
+ * which were slower than the simulations and corrupted memcpy/memmove
+ * ('M'/'O') records because those carry a second embedded hex address.
+ *
+ * Commands:
+ *   strip    Drop (or with --invert keep) events by file glob, thread, type
+ *   cut      Keep a half-open range of event records
+ *   convert  Convert between the text and CXTB binary formats
+ *   split    Write one output per thread id
+ *   cat      Concatenate traces, renormalizing file-id registrations
+ *   stats    Summarize a trace without simulating it
+ *   index    Write a sidecar index for random-access replay
+ *
+ * Text input flows through verbatim where possible (strip/cut/split copy
+ * the original line bytes, preserving timestamps and formatting exactly);
+ * binary input is decoded and re-encoded as version-1 'E' records, which
+ * also flattens compact delta streams. The binary format carries no
+ * timestamps, so text->binary conversion drops them; compact streams'
+ * function records ('G') survive text pipelines but not binary re-encoding.
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fstream>
+
+#include "../include/BinaryTrace.hpp"
+#include "../include/FastIO.hpp"
+#include "../include/TraceFilter.hpp"
+#include "../include/TraceIndex.hpp"
+
+namespace {
+
+void print_usage(const char *prog) {
+  fprintf(stderr, "Usage: %s <command> [options] [trace ...]\n", prog);
+  fprintf(stderr, "\nTrace preprocessing tool (no simulation). Reads text or CXTB\n");
+  fprintf(stderr, "binary traces, zstd-compressed or not; '-' or no input = stdin.\n");
+  fprintf(stderr, "\nCommands:\n");
+  fprintf(stderr, "  strip      Drop events matching any given criterion\n");
+  fprintf(stderr, "  cut        Keep a half-open range of event records\n");
+  fprintf(stderr, "  convert    Convert between text and binary formats\n");
+  fprintf(stderr, "  split      Write one output file per thread id\n");
+  fprintf(stderr, "  cat        Concatenate traces (renormalizes file ids)\n");
+  fprintf(stderr, "  stats      Summarize a trace\n");
+  fprintf(stderr, "  index      Write a sidecar index (<trace>.cxi) for --replay-range\n");
+  fprintf(stderr, "\nOptions:\n");
+  fprintf(stderr, "  -o FILE        Output file (default stdout)\n");
+  fprintf(stderr, "  --file GLOB    strip: match events from files matching GLOB (* and ?)\n");
+  fprintf(stderr, "  --thread N     strip: match events from thread N\n");
+  fprintf(stderr, "  --type CHARS   strip: match record type letters (e.g. LS, M, P)\n");
+  fprintf(stderr, "  --invert       strip: keep only matching events instead\n");
+  fprintf(stderr, "  --range A:B    cut: keep event records [A, B); 'A:' means to the end\n");
+  fprintf(stderr, "  --to FORMAT    convert: target format, 'text' or 'binary'\n");
+  fprintf(stderr, "  --prefix PATH  split: outputs PATH.t<N>.trace (or .bin)\n");
+  fprintf(stderr, "  --binary       cat: emit binary instead of text\n");
+  fprintf(stderr, "  --every N      index: events between byte-offset marks (default 1000000)\n");
+  fprintf(stderr, "\nExamples:\n");
+  fprintf(stderr, "  %s strip --file 'vendor/*' big.trace -o app.trace\n", prog);
+  fprintf(stderr, "  %s cut --range 1000000:2000000 big.trace | cache-sim --json\n", prog);
+  fprintf(stderr, "  %s convert --to binary big.trace -o big.bin\n", prog);
+  fprintf(stderr, "  %s split --prefix run1 threaded.trace\n", prog);
+  fprintf(stderr, "  %s cat warmup.trace steady.bin -o merged.trace\n", prog);
+  fprintf(stderr, "  %s index big.trace && cache-sim --trace-file big.trace "
+                  "--replay-range 5000000:6000000\n", prog);
+}
+
+struct ToolOptions {
+  std::string command;
+  std::vector<std::string> inputs;
+  std::string output;
+
+  std::string file_glob;  // strip --file
+  bool has_thread = false;
+  uint32_t thread = 0;    // strip --thread
+  std::string types;      // strip --type
+  bool invert = false;    // strip --invert
+
+  uint64_t range_lo = 0;  // cut --range lo:hi, half-open record indices
+  uint64_t range_hi = 0;
+
+  std::string to;         // convert --to
+  std::string prefix;     // split --prefix
+  bool binary = false;    // cat --binary
+  uint64_t every = 1000000;  // index --every, events between marks
+};
+
+bool parse_args(int argc, char *argv[], ToolOptions &opts) {
+  if (argc < 2) {
+    print_usage(argv[0]);
+    return false;
+  }
+  opts.command = argv[1];
+  if (opts.command == "--help" || opts.command == "-h") {
+    print_usage(argv[0]);
+    return false;
+  }
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      print_usage(argv[0]);
+      return false;
+    } else if (arg == "-o" && i + 1 < argc) {
+      opts.output = argv[++i];
+    } else if (arg == "--file" && i + 1 < argc) {
+      opts.file_glob = argv[++i];
+    } else if (arg == "--thread" && i + 1 < argc) {
+      opts.has_thread = true;
+      opts.thread = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--type" && i + 1 < argc) {
+      opts.types = argv[++i];
+    } else if (arg == "--invert") {
+      opts.invert = true;
+    } else if (arg == "--range" && i + 1 < argc) {
+      std::string value = argv[++i];
+      auto colon = value.find(':');
+      if (colon == std::string::npos) {
+        fprintf(stderr, "Error: --range expects lo:hi\n");
+        return false;
+      }
+      opts.range_lo = strtoull(value.substr(0, colon).c_str(), nullptr, 0);
+      std::string hi = value.substr(colon + 1);
+      opts.range_hi = hi.empty() ? UINT64_MAX
+                                 : strtoull(hi.c_str(), nullptr, 0);
+      if (opts.range_hi <= opts.range_lo) {
+        fprintf(stderr, "Error: --range needs lo < hi\n");
+        return false;
+      }
+    } else if (arg == "--to" && i + 1 < argc) {
+      opts.to = argv[++i];
+    } else if (arg == "--prefix" && i + 1 < argc) {
+      opts.prefix = argv[++i];
+    } else if (arg == "--binary") {
+      opts.binary = true;
+    } else if (arg == "--every" && i + 1 < argc) {
+      opts.every = strtoull(argv[++i], nullptr, 10);
+      if (opts.every == 0) {
+        fprintf(stderr, "Error: --every needs a positive event count\n");
+        return false;
+      }
+    } else if (!arg.empty() && arg[0] == '-' && arg != "-") {
+      fprintf(stderr, "Error: unknown option '%s'\n", arg.c_str());
+      print_usage(argv[0]);
+      return false;
+    } else {
+      opts.inputs.push_back(arg);
+    }
+  }
+  return true;
+}
+
+// One opened trace: mmap'd file, bulk-read stdin, or an inflated copy of
+// either when the zstd frame magic leads
+struct TraceInput {
+  MappedFile map;
+  std::string owned;
+  const char *data = nullptr;
+  size_t size = 0;
+};
+
+bool open_trace_input(const std::string &path, TraceInput &in) {
+  if (path.empty() || path == "-") {
+    in.owned = BulkReader::read_all();
+    in.data = in.owned.data();
+    in.size = in.owned.size();
+  } else {
+    if (!in.map.open(path)) {
+      fprintf(stderr, "Error: cannot open trace file: %s\n", path.c_str());
+      return false;
+    }
+    in.data = in.map.data();
+    in.size = in.map.size();
+  }
+  if (in.data != nullptr && is_zstd_trace(in.data, in.size)) {
+    std::string inflated;
+    if (!zstd_inflate(in.data, in.size, inflated)) {
+#ifdef CACHE_EXPLORER_HAVE_ZSTD
+      fprintf(stderr, "Error: corrupt zstd-compressed trace\n");
+#else
+      fprintf(stderr, "Error: zstd-compressed trace, but trace-tool was "
+                      "built without libzstd\n");
+#endif
+      return false;
+    }
+    in.map.close();
+    in.owned = std::move(inflated);
+    in.data = in.owned.data();
+    in.size = in.owned.size();
+  }
+  return true;
+}
+
+FILE *open_output(const std::string &path) {
+  if (path.empty() || path == "-") {
+    return stdout;
+  }
+  FILE *f = fopen(path.c_str(), "wb");
+  if (f == nullptr) {
+    fprintf(stderr, "Error: cannot open output file: %s\n", path.c_str());
+  }
+  return f;
+}
+
+void close_output(FILE *f) {
+  if (f != nullptr && f != stdout) {
+    fclose(f);
+  }
+}
+
+// Single forward pass over either trace format. Events reach on_event
+// (with the raw line bytes for text input, an empty view for binary);
+// everything else in a text trace - comments, D/G registrations,
+// malformed lines - reaches on_side verbatim. The fast parser feeds the
+// file-id and function tables as a side effect, so locations are already
+// resolved when the callbacks run.
+template <typename EventFn, typename SideFn>
+void walk_trace(const TraceInput &in, EventFn &&on_event, SideFn &&on_side) {
+  if (is_binary_trace(in.data, in.size)) {
+    parse_binary_trace(in.data, in.size, [&](TraceEvent &&event) {
+      on_event(event, std::string_view());
+    });
+    return;
+  }
+  for_each_line(in.data, in.size, [&](const char *begin, const char *end) {
+    std::string_view raw(begin, static_cast<size_t>(end - begin));
+    if (auto event = parse_trace_event_fast(begin, end)) {
+      on_event(*event, raw);
+    } else {
+      on_side(raw);
+    }
+  });
+}
+
+// The record's leading type letter as it appears in the text protocol
+// (ranges report 'R' for both RL and RS, gather lanes 'V' for VL and VS)
+char record_letter(const TraceEvent &e) {
+  if (e.is_sample_rate) return 'W';
+  if (e.is_phase_begin) return 'B';
+  if (e.is_phase_end) return 'E';
+  if (e.is_free) return 'F';
+  if (e.is_alloc) return 'H';
+  if (e.is_range) return 'R';
+  if (e.is_memcpy) return 'M';
+  if (e.is_memmove) return 'O';
+  if (e.is_memset) return 'Z';
+  if (e.is_cmpxchg) return 'C';
+  if (e.is_rmw) return 'X';
+  if (e.is_atomic) return 'A';
+  if (e.is_gather) return 'V';
+  if (e.is_vector) return e.is_write ? 'U' : 'V';
+  if (e.is_prefetch) return 'P';
+  if (e.is_icache) return 'I';
+  return e.is_write ? 'S' : 'L';
+}
+
+void print_text_event(FILE *out, const TraceEvent &e) {
+  // Sample-rate records carry only the divisor
+  if (e.is_sample_rate) {
+    fprintf(out, "W %" PRIu64 "\n", e.count);
+    return;
+  }
+
+  // Free records and phase markers carry neither size nor location
+  if (e.is_free || e.is_phase_begin || e.is_phase_end) {
+    fprintf(out, "%c 0x%" PRIx64 " T%u", record_letter(e), e.address,
+            e.thread_id);
+    if (e.timestamp != 0) {
+      fprintf(out, " @%" PRIu64, e.timestamp);
+    }
+    fputc('\n', out);
+    return;
+  }
+
+  if (e.is_range) {
+    fprintf(out, "R%c 0x%" PRIx64 " %" PRId64 " %" PRIu64 " %u",
+            e.is_write ? 'S' : 'L', e.address, e.stride, e.count, e.size);
+  } else if (e.is_memcpy || e.is_memmove) {
+    fprintf(out, "%c 0x%" PRIx64 " 0x%" PRIx64 " %u", e.is_memcpy ? 'M' : 'O',
+            e.address, e.src_address, e.size);
+  } else if (e.is_gather) {
+    fprintf(out, "V%c 0x%" PRIx64 " %u %u %u", e.is_write ? 'S' : 'L',
+            e.address, e.lane, e.lanes, e.size);
+  } else if (e.is_prefetch) {
+    fprintf(out, "P%u 0x%" PRIx64 " %u", e.prefetch_hint, e.address, e.size);
+  } else {
+    fprintf(out, "%c 0x%" PRIx64 " %u", record_letter(e), e.address, e.size);
+  }
+
+  if (!e.file.empty()) {
+    fprintf(out, " %.*s:%u", static_cast<int>(e.file.size()), e.file.data(),
+            e.line);
+  }
+  fprintf(out, " T%u", e.thread_id);
+  if (e.timestamp != 0) {
+    fprintf(out, " @%" PRIu64, e.timestamp);
+  }
+  fputc('\n', out);
+}
+
+// Streaming CXTB encoder: version-1 header, 'F' records interleaved on
+// first sight of each file (the decoder requires them before use), one
+// fixed-width 'E' record per event. Timestamps have no binary field and
+// are dropped - convert warns when that loses data.
+class BinaryTraceWriter {
+public:
+  explicit BinaryTraceWriter(FILE *out) : out_(out) {
+    fwrite(BINARY_TRACE_MAGIC, 1, sizeof(BINARY_TRACE_MAGIC), out_);
+    uint32_t version = BINARY_TRACE_VERSION;
+    fwrite(&version, sizeof(version), 1, out_);
+  }
+
+  void write(const TraceEvent &e) {
+    // Sample-rate records have no binary form - dropped on conversion,
+    // like the other text-only side-band records (K, Y)
+    if (e.is_sample_rate) {
+      return;
+    }
+    BinaryEventRecord rec = {};
+    rec.address = encode_address(e);
+    if (e.is_memcpy || e.is_memmove) {
+      rec.src_address = e.src_address;
+    } else if (e.is_range) {
+      rec.src_address = (e.count << 32) |
+                        static_cast<uint32_t>(static_cast<int32_t>(e.stride));
+    } else if (e.is_gather) {
+      rec.src_address = (static_cast<uint64_t>(e.lanes) << 32) | e.lane;
+    }
+    rec.size = e.size;
+    rec.line = (file_id(e.file) << 20) | (e.line & 0xFFFFF);
+    rec.thread_id = e.thread_id;
+
+    // Field-by-field like the decoder - the struct has trailing padding
+    char buf[BINARY_EVENT_RECORD_SIZE];
+    memcpy(buf, &rec.address, 8);
+    memcpy(buf + 8, &rec.src_address, 8);
+    memcpy(buf + 16, &rec.size, 4);
+    memcpy(buf + 20, &rec.line, 4);
+    memcpy(buf + 24, &rec.thread_id, 4);
+    fputc(BINARY_RECORD_EVENT, out_);
+    fwrite(buf, 1, BINARY_EVENT_RECORD_SIZE, out_);
+  }
+
+  void write_func(std::string_view file, uint32_t line,
+                  std::string_view func) {
+    uint32_t packed = (file_id(file) << 20) | (line & 0xFFFFF);
+    uint16_t name_len =
+        static_cast<uint16_t>(func.size() > 65535 ? 65535 : func.size());
+    fputc(BINARY_RECORD_FUNC, out_);
+    fwrite(&packed, sizeof(packed), 1, out_);
+    fwrite(&name_len, sizeof(name_len), 1, out_);
+    fwrite(func.data(), 1, name_len, out_);
+  }
+
+private:
+  // Reverse of decode_binary_event: one category flag per event, store
+  // bit where the category uses it, address masked below the lowest
+  // stolen bit (real addresses fit in 48 bits)
+  static uint64_t encode_address(const TraceEvent &e) {
+    if (e.is_phase_begin || e.is_phase_end) {
+      return BINARY_PHASE_FLAG | (e.address & BINARY_PHASE_ID_MASK) |
+             (e.is_phase_end ? BINARY_STORE_FLAG : 0);
+    }
+    if (e.is_alloc || e.is_free) {
+      return BINARY_HEAP_FLAG | (e.address & BINARY_HEAP_ADDR_MASK) |
+             (e.is_free ? BINARY_STORE_FLAG : 0);
+    }
+    if (e.is_range) {
+      return BINARY_RANGE_FLAG | (e.address & BINARY_RANGE_ADDR_MASK) |
+             (e.is_write ? BINARY_STORE_FLAG : 0);
+    }
+    constexpr uint64_t low54 = (1ULL << 54) - 1;
+    if (e.is_memcpy || e.is_memset || e.is_memmove) {
+      uint64_t type = e.is_memset ? 1 : (e.is_memmove ? 2 : 0);
+      return BINARY_MEMINTR_FLAG | (type << 54) | (e.address & low54);
+    }
+    if (e.is_atomic) {
+      uint64_t type = e.is_cmpxchg ? 3 : (e.is_rmw ? 2 : 0);
+      return BINARY_ATOMIC_FLAG | (type << 57) |
+             (e.is_write ? BINARY_STORE_FLAG : 0) | (e.address & low54);
+    }
+    if (e.is_gather) {
+      return BINARY_VECTOR_FLAG | BINARY_GATHER_FLAG |
+             (e.is_write ? BINARY_STORE_FLAG : 0) |
+             (e.address & BINARY_GATHER_ADDR_MASK);
+    }
+    if (e.is_vector) {
+      return BINARY_VECTOR_FLAG | (e.is_write ? BINARY_STORE_FLAG : 0) |
+             (e.address & low54);
+    }
+    if (e.is_prefetch) {
+      return BINARY_PREFETCH_FLAG |
+             (static_cast<uint64_t>(e.prefetch_hint) << 54) |
+             (e.address & low54);
+    }
+    if (e.is_icache) {
+      return BINARY_ICACHE_FLAG | (e.address & low54);
+    }
+    return (e.is_write ? BINARY_STORE_FLAG : 0) | (e.address & BINARY_ADDR_MASK);
+  }
+
+  uint32_t file_id(std::string_view file) {
+    if (file.empty()) {
+      return 0; // id 0 stays unregistered; decodes back to an empty file
+    }
+    auto it = ids_.find(file);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    uint32_t id = next_id_++;
+    ids_.emplace(file, id);
+    uint16_t name_len =
+        static_cast<uint16_t>(file.size() > 65535 ? 65535 : file.size());
+    fputc(BINARY_RECORD_FILE, out_);
+    fwrite(&id, sizeof(id), 1, out_);
+    fwrite(&name_len, sizeof(name_len), 1, out_);
+    fwrite(file.data(), 1, name_len, out_);
+    return id;
+  }
+
+  FILE *out_;
+  std::unordered_map<std::string_view, uint32_t> ids_;
+  uint32_t next_id_ = 1;
+};
+
+// Parse a text function-registration line (G <file>:<line> <func>) so
+// re-encoding pipelines can carry it across; the file part may be a
+// numeric id, resolved against the registrations seen so far
+bool parse_func_record(std::string_view raw, std::string_view &file,
+                       uint32_t &line, std::string_view &func) {
+  size_t p = 1; // past the 'G'
+  while (p < raw.size() && raw[p] == ' ')
+    p++;
+  size_t loc_start = p;
+  while (p < raw.size() && raw[p] != ' ')
+    p++;
+  std::string_view loc = raw.substr(loc_start, p - loc_start);
+  while (p < raw.size() && raw[p] == ' ')
+    p++;
+  size_t name_end = raw.size();
+  while (name_end > p && raw[name_end - 1] == ' ')
+    name_end--;
+  auto colon = loc.rfind(':');
+  if (colon == std::string_view::npos || colon == 0 || name_end <= p) {
+    return false;
+  }
+  file = resolve_trace_file(loc.substr(0, colon));
+  line = 0;
+  for (size_t c = colon + 1; c < loc.size(); c++) {
+    if (loc[c] < '0' || loc[c] > '9')
+      return false;
+    line = line * 10 + static_cast<uint32_t>(loc[c] - '0');
+  }
+  func = raw.substr(p, name_end - p);
+  return true;
+}
+
+void write_raw_line(FILE *out, std::string_view raw) {
+  fwrite(raw.data(), 1, raw.size(), out);
+  fputc('\n', out);
+}
+
+int run_strip(const ToolOptions &opts) {
+  if (opts.file_glob.empty() && !opts.has_thread && opts.types.empty()) {
+    fprintf(stderr,
+            "Error: strip needs at least one of --file, --thread, --type\n");
+    return 1;
+  }
+  TraceInput in;
+  if (!open_trace_input(opts.inputs.empty() ? "" : opts.inputs[0], in)) {
+    return 1;
+  }
+  FILE *out = open_output(opts.output);
+  if (out == nullptr) {
+    return 1;
+  }
+
+  const bool binary = is_binary_trace(in.data, in.size);
+  std::optional<BinaryTraceWriter> writer;
+  if (binary) {
+    writer.emplace(out);
+  }
+
+  auto matches = [&](const TraceEvent &e) {
+    if (!opts.file_glob.empty() && glob_match(opts.file_glob, e.file)) {
+      return true;
+    }
+    if (opts.has_thread && e.thread_id == opts.thread) {
+      return true;
+    }
+    if (!opts.types.empty() &&
+        opts.types.find(record_letter(e)) != std::string::npos) {
+      return true;
+    }
+    return false;
+  };
+
+  walk_trace(
+      in,
+      [&](const TraceEvent &e, std::string_view raw) {
+        bool drop = opts.invert ? !matches(e) : matches(e);
+        if (drop) {
+          return;
+        }
+        if (binary) {
+          writer->write(e);
+        } else {
+          write_raw_line(out, raw);
+        }
+      },
+      [&](std::string_view raw) {
+        if (!binary) {
+          write_raw_line(out, raw); // D/G registrations, comments
+        }
+      });
+
+  close_output(out);
+  return 0;
+}
+
+int run_cut(const ToolOptions &opts) {
+  if (opts.range_hi == 0) {
+    fprintf(stderr, "Error: cut needs --range lo:hi\n");
+    return 1;
+  }
+  TraceInput in;
+  if (!open_trace_input(opts.inputs.empty() ? "" : opts.inputs[0], in)) {
+    return 1;
+  }
+  FILE *out = open_output(opts.output);
+  if (out == nullptr) {
+    return 1;
+  }
+
+  const bool binary = is_binary_trace(in.data, in.size);
+  std::optional<BinaryTraceWriter> writer;
+  if (binary) {
+    writer.emplace(out);
+  }
+
+  // Record indices, not expanded accesses: a range record counts once.
+  // Registrations and comments pass through regardless of position so
+  // kept events still resolve their file ids.
+  uint64_t index = 0;
+  walk_trace(
+      in,
+      [&](const TraceEvent &e, std::string_view raw) {
+        uint64_t i = index++;
+        if (i < opts.range_lo || i >= opts.range_hi) {
+          return;
+        }
+        if (binary) {
+          writer->write(e);
+        } else {
+          write_raw_line(out, raw);
+        }
+      },
+      [&](std::string_view raw) {
+        if (!binary) {
+          write_raw_line(out, raw);
+        }
+      });
+
+  close_output(out);
+  return 0;
+}
+
+int run_convert(const ToolOptions &opts) {
+  if (opts.to != "text" && opts.to != "binary") {
+    fprintf(stderr, "Error: convert needs --to text or --to binary\n");
+    return 1;
+  }
+  TraceInput in;
+  if (!open_trace_input(opts.inputs.empty() ? "" : opts.inputs[0], in)) {
+    return 1;
+  }
+  FILE *out = open_output(opts.output);
+  if (out == nullptr) {
+    return 1;
+  }
+
+  const bool from_binary = is_binary_trace(in.data, in.size);
+  const bool to_binary = (opts.to == "binary");
+
+  if (from_binary == to_binary) {
+    // Already in the target format - pass the bytes through (this also
+    // serves as a zstd decompressor)
+    fwrite(in.data, 1, in.size, out);
+    close_output(out);
+    return 0;
+  }
+
+  std::optional<BinaryTraceWriter> writer;
+  if (to_binary) {
+    writer.emplace(out);
+  }
+  uint64_t dropped_timestamps = 0;
+
+  walk_trace(
+      in,
+      [&](const TraceEvent &e, std::string_view) {
+        if (to_binary) {
+          if (e.timestamp != 0) {
+            dropped_timestamps++;
+          }
+          writer->write(e);
+        } else {
+          print_text_event(out, e);
+        }
+      },
+      [&](std::string_view raw) {
+        // Carry function registrations across; file-id registrations are
+        // subsumed by the writer's own table, comments are dropped
+        if (to_binary && !raw.empty() && raw[0] == 'G') {
+          std::string_view file, func;
+          uint32_t line;
+          if (parse_func_record(raw, file, line, func)) {
+            writer->write_func(file, line, func);
+          }
+        }
+      });
+
+  if (dropped_timestamps > 0) {
+    fprintf(stderr,
+            "Warning: binary format carries no timestamps; dropped "
+            "%" PRIu64 " capture timestamps\n",
+            dropped_timestamps);
+  }
+  close_output(out);
+  return 0;
+}
+
+int run_split(const ToolOptions &opts) {
+  if (opts.prefix.empty()) {
+    fprintf(stderr, "Error: split needs --prefix\n");
+    return 1;
+  }
+  TraceInput in;
+  if (!open_trace_input(opts.inputs.empty() ? "" : opts.inputs[0], in)) {
+    return 1;
+  }
+
+  const bool binary = is_binary_trace(in.data, in.size);
+
+  struct SplitOutput {
+    FILE *file = nullptr;
+    std::optional<BinaryTraceWriter> writer;
+  };
+  std::map<uint32_t, SplitOutput> outputs;
+  // Side-band lines (D/G registrations, comments) belong to every
+  // per-thread trace; replay the ones seen so far into late-opened
+  // outputs so each file decodes standalone
+  std::string side_prefix;
+  bool failed = false;
+
+  auto output_for = [&](uint32_t tid) -> SplitOutput * {
+    auto it = outputs.find(tid);
+    if (it != outputs.end()) {
+      return &it->second;
+    }
+    std::string path = opts.prefix + ".t" + std::to_string(tid) +
+                       (binary ? ".bin" : ".trace");
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+      fprintf(stderr, "Error: cannot open output file: %s\n", path.c_str());
+      failed = true;
+      return nullptr;
+    }
+    SplitOutput &slot = outputs[tid];
+    slot.file = f;
+    if (binary) {
+      slot.writer.emplace(f);
+    } else if (!side_prefix.empty()) {
+      fwrite(side_prefix.data(), 1, side_prefix.size(), f);
+    }
+    return &slot;
+  };
+
+  walk_trace(
+      in,
+      [&](const TraceEvent &e, std::string_view raw) {
+        if (failed) {
+          return;
+        }
+        SplitOutput *slot = output_for(e.thread_id);
+        if (slot == nullptr) {
+          return;
+        }
+        if (binary) {
+          slot->writer->write(e);
+        } else {
+          write_raw_line(slot->file, raw);
+        }
+      },
+      [&](std::string_view raw) {
+        if (binary || failed) {
+          return;
+        }
+        for (auto &[tid, slot] : outputs) {
+          write_raw_line(slot.file, raw);
+        }
+        side_prefix.append(raw);
+        side_prefix.push_back('\n');
+      });
+
+  for (auto &[tid, slot] : outputs) {
+    fclose(slot.file);
+  }
+  return failed ? 1 : 0;
+}
+
+int run_cat(const ToolOptions &opts) {
+  FILE *out = open_output(opts.output);
+  if (out == nullptr) {
+    return 1;
+  }
+  std::optional<BinaryTraceWriter> writer;
+  if (opts.binary) {
+    writer.emplace(out);
+  }
+
+  // Re-emit every event through the printer/encoder rather than copying
+  // lines: numeric file ids from different captures collide, so locations
+  // must be resolved against each input's own D records and written back
+  // as full paths (text) or fresh table entries (binary)
+  std::vector<std::string> inputs = opts.inputs;
+  if (inputs.empty()) {
+    inputs.push_back("-");
+  }
+  for (const std::string &path : inputs) {
+    TraceInput in;
+    if (!open_trace_input(path, in)) {
+      close_output(out);
+      return 1;
+    }
+    walk_trace(
+        in,
+        [&](const TraceEvent &e, std::string_view) {
+          if (opts.binary) {
+            writer->write(e);
+          } else {
+            print_text_event(out, e);
+          }
+        },
+        [&](std::string_view raw) {
+          if (raw.empty() || raw[0] != 'G') {
+            return; // D records are renormalized away, comments dropped
+          }
+          std::string_view file, func;
+          uint32_t line;
+          if (!parse_func_record(raw, file, line, func)) {
+            return;
+          }
+          if (opts.binary) {
+            writer->write_func(file, line, func);
+          } else {
+            fprintf(out, "G %.*s:%u %.*s\n", static_cast<int>(file.size()),
+                    file.data(), line, static_cast<int>(func.size()),
+                    func.data());
+          }
+        });
+  }
+
+  close_output(out);
+  return 0;
+}
+
+int run_stats(const ToolOptions &opts) {
+  TraceInput in;
+  if (!open_trace_input(opts.inputs.empty() ? "" : opts.inputs[0], in)) {
+    return 1;
+  }
+  const bool binary = is_binary_trace(in.data, in.size);
+
+  uint64_t events = 0;
+  uint64_t side_lines = 0;
+  uint64_t loads = 0;
+  uint64_t stores = 0;
+  uint64_t bytes = 0;
+  uint64_t timestamped = 0;
+  uint64_t by_type[256] = {};
+  std::map<uint32_t, uint64_t> by_thread;
+  std::unordered_set<std::string_view> files;
+  uint64_t addr_lo = UINT64_MAX;
+  uint64_t addr_hi = 0;
+
+  walk_trace(
+      in,
+      [&](const TraceEvent &e, std::string_view) {
+        events++;
+        by_type[static_cast<uint8_t>(record_letter(e))]++;
+        if (e.is_sample_rate) {
+          return; // no thread, no address, no size - the count is a divisor
+        }
+        by_thread[e.thread_id]++;
+        if (!e.file.empty()) {
+          files.insert(e.file);
+        }
+        if (e.timestamp != 0) {
+          timestamped++;
+        }
+        if (e.is_phase_begin || e.is_phase_end) {
+          return; // the address field is a phase id, not an address
+        }
+        if (e.is_free) {
+          if (e.address < addr_lo) addr_lo = e.address;
+          if (e.address > addr_hi) addr_hi = e.address;
+          return;
+        }
+        uint64_t expanded = e.is_range ? e.count : 1;
+        bytes += static_cast<uint64_t>(e.size) * expanded;
+        if (!e.is_alloc) {
+          if (e.is_write) {
+            stores += expanded;
+          } else {
+            loads += expanded;
+          }
+        }
+        uint64_t last = e.address;
+        if (e.is_range && e.count > 1) {
+          int64_t extent = e.stride * static_cast<int64_t>(e.count - 1);
+          last = e.address + extent;
+        } else if (e.size > 0) {
+          last = e.address + e.size - 1;
+        }
+        uint64_t lo = e.address < last ? e.address : last;
+        uint64_t hi = e.address < last ? last : e.address;
+        if (lo < addr_lo) addr_lo = lo;
+        if (hi > addr_hi) addr_hi = hi;
+      },
+      [&](std::string_view) { side_lines++; });
+
+  printf("Format:         %s\n", binary ? "binary (CXTB)" : "text");
+  printf("Events:         %" PRIu64 "\n", events);
+  printf("Loads / stores: %" PRIu64 " / %" PRIu64
+         " (range records expanded)\n",
+         loads, stores);
+  printf("Bytes accessed: %" PRIu64 "\n", bytes);
+  if (addr_lo <= addr_hi) {
+    printf("Address range:  0x%" PRIx64 " - 0x%" PRIx64 "\n", addr_lo,
+           addr_hi);
+  }
+  printf("Files:          %zu\n", files.size());
+  if (timestamped > 0) {
+    printf("Timestamped:    %" PRIu64 "\n", timestamped);
+  }
+  if (!binary) {
+    printf("Side-band:      %" PRIu64 " lines\n", side_lines);
+  }
+  printf("Threads:        %zu\n", by_thread.size());
+  for (const auto &[tid, count] : by_thread) {
+    printf("  T%-4u %" PRIu64 "\n", tid, count);
+  }
+  printf("By record type:\n");
+  for (int c = 0; c < 256; c++) {
+    if (by_type[c] > 0) {
+      printf("  %c    %" PRIu64 "\n", static_cast<char>(c), by_type[c]);
+    }
+  }
+  return 0;
+}
+
+int run_index(const ToolOptions &opts) {
+  if (opts.inputs.empty() || opts.inputs[0] == "-") {
+    fprintf(stderr, "Error: index needs a trace file (offsets must name a "
+                    "seekable file, not stdin)\n");
+    return 1;
+  }
+  TraceInput in;
+  if (!open_trace_input(opts.inputs[0], in)) {
+    return 1;
+  }
+  if (is_binary_trace(in.data, in.size)) {
+    fprintf(stderr, "Error: index supports text traces only (binary records "
+                    "are fixed-width - seek arithmetic needs no sidecar)\n");
+    return 1;
+  }
+
+  TraceIndex index = build_trace_index(in.data, in.size, opts.every);
+
+  std::string path =
+      opts.output.empty() ? opts.inputs[0] + ".cxi" : opts.output;
+  std::ofstream out(path, std::ios::binary);
+  if (!out || !index.save(out)) {
+    fprintf(stderr, "Error: cannot write index file: %s\n", path.c_str());
+    return 1;
+  }
+
+  fprintf(stderr,
+          "Indexed %" PRIu64 " events: %zu marks every %" PRIu64
+          " events, %zu registration records -> %s\n",
+          index.total_events, index.marks.size(), index.interval,
+          index.registrations.size(), path.c_str());
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  ToolOptions opts;
+  if (!parse_args(argc, argv, opts)) {
+    return 1;
+  }
+
+  if (opts.inputs.size() > 1 && opts.command != "cat") {
+    fprintf(stderr, "Error: %s takes a single input trace\n",
+            opts.command.c_str());
+    return 1;
+  }
+
+  if (opts.command == "strip") {
+    return run_strip(opts);
+  } else if (opts.command == "cut") {
+    return run_cut(opts);
+  } else if (opts.command == "convert") {
+    return run_convert(opts);
+  } else if (opts.command == "split") {
+    return run_split(opts);
+  } else if (opts.command == "cat") {
+    return run_cat(opts);
+  } else if (opts.command == "stats") {
+    return run_stats(opts);
+  } else if (opts.command == "index") {
+    return run_index(opts);
+  }
+
+  fprintf(stderr, "Error: unknown command '%s'\n", opts.command.c_str());
+  print_usage(argv[0]);
+  return 1;
+}
@@ -0,0 +1,246 @@
+#include "../include/cachesim.h"
+
+#include <deque>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../include/ArgParser.hpp"
+#include "../include/FileTable.hpp"
+#include "../include/MultiCoreTraceProcessor.hpp"
+#include "../include/TraceProcessor.hpp"
+
+// Opaque handle behind the C API: one of the two processors, plus the
+// construction parameters so cachesim_reset can rebuild the multi-core
+// processor (which has no clear()) and re-apply per-handle settings
+struct cachesim {
+  CacheHierarchyConfig cfg;
+  int num_cores = 0; // 0 = single-core
+  std::unique_ptr<TraceProcessor> single;
+  std::unique_ptr<MultiCoreTraceProcessor> multi;
+  uint64_t events_processed = 0;
+  PrefetchPolicy prefetch_policy = PrefetchPolicy::NONE;
+  int prefetch_degree = 2;
+  bool fast_mode = false;
+
+  // Interned file views aren't null-terminated; hot-line names handed to
+  // C callers come from this per-handle cache instead. The deque keeps
+  // pointers stable as names accumulate.
+  std::deque<std::string> name_storage;
+  std::unordered_map<std::string_view, const char *> name_index;
+
+  const char *c_name(std::string_view view) {
+    if (view.empty()) {
+      return "";
+    }
+    auto it = name_index.find(view);
+    if (it != name_index.end()) {
+      return it->second;
+    }
+    name_storage.emplace_back(view);
+    const char *stored = name_storage.back().c_str();
+    name_index.emplace(view, stored);
+    return stored;
+  }
+};
+
+// Re-apply the handle's settings after (re)construction
+static void apply_settings(cachesim *sim) {
+  if (sim->single) {
+    sim->single->set_fast_mode(sim->fast_mode);
+    if (sim->prefetch_policy != PrefetchPolicy::NONE) {
+      sim->single->enable_prefetching(sim->prefetch_policy,
+                                      sim->prefetch_degree);
+    }
+  } else {
+    sim->multi->set_fast_mode(sim->fast_mode);
+  }
+}
+
+static TraceEvent to_trace_event(const cachesim_event_t &e) {
+  TraceEvent event;
+  event.address = e.address;
+  event.size = e.size;
+  event.is_write = e.is_write != 0;
+  event.is_icache = e.is_icache != 0;
+  event.thread_id = e.thread_id;
+  event.line = e.line;
+  if (e.file != nullptr && e.file[0] != '\0') {
+    // Intern through the shared table - the caller's pointer only has to
+    // live for the cachesim_process call, ours lives for the process
+    event.file = FileTable::instance().view(e.file);
+  }
+  return event;
+}
+
+static void fill_level(const CacheStats &s, cachesim_level_stats_t *out) {
+  out->hits = s.hits;
+  out->misses = s.misses;
+  out->writebacks = s.writebacks;
+  out->compulsory_misses = s.compulsory_misses;
+  out->capacity_misses = s.capacity_misses;
+  out->conflict_misses = s.conflict_misses;
+  out->hit_rate = s.hit_rate();
+}
+
+extern "C" {
+
+cachesim_t *cachesim_create(const char *preset) {
+  auto *sim = new (std::nothrow) cachesim;
+  if (sim == nullptr) {
+    return nullptr;
+  }
+  sim->cfg = ArgParser::get_preset_config(preset ? preset : "intel");
+  sim->single = std::make_unique<TraceProcessor>(sim->cfg);
+  return sim;
+}
+
+cachesim_t *cachesim_create_multicore(const char *preset, int num_cores) {
+  if (num_cores < 1) {
+    return nullptr;
+  }
+  auto *sim = new (std::nothrow) cachesim;
+  if (sim == nullptr) {
+    return nullptr;
+  }
+  sim->cfg = ArgParser::get_preset_config(preset ? preset : "intel");
+  sim->num_cores = num_cores;
+  sim->multi = std::make_unique<MultiCoreTraceProcessor>(
+      num_cores, sim->cfg.l1_data, sim->cfg.l2, sim->cfg.l3);
+  return sim;
+}
+
+void cachesim_destroy(cachesim_t *sim) { delete sim; }
+
+int cachesim_set_prefetching(cachesim_t *sim, const char *policy, int degree) {
+  if (sim == nullptr || policy == nullptr) {
+    return -1;
+  }
+  std::string name(policy);
+  PrefetchPolicy parsed = ArgParser::parse_prefetch_policy(name);
+  // parse_prefetch_policy falls back to NONE; only accept it for "none"
+  if (parsed == PrefetchPolicy::NONE && name != "none") {
+    return -1;
+  }
+  sim->prefetch_policy = parsed;
+  sim->prefetch_degree = degree > 0 ? degree : 2;
+  if (sim->single) {
+    if (parsed == PrefetchPolicy::NONE) {
+      sim->single->disable_prefetching();
+    } else {
+      sim->single->enable_prefetching(parsed, sim->prefetch_degree);
+    }
+  } else if (parsed != PrefetchPolicy::NONE) {
+    // The multi-core processor takes its prefetch config at construction
+    sim->multi = std::make_unique<MultiCoreTraceProcessor>(
+        sim->num_cores, sim->cfg.l1_data, sim->cfg.l2, sim->cfg.l3, parsed,
+        sim->prefetch_degree);
+    apply_settings(sim);
+    sim->events_processed = 0;
+  }
+  return 0;
+}
+
+void cachesim_set_fast_mode(cachesim_t *sim, int enable) {
+  if (sim == nullptr) {
+    return;
+  }
+  sim->fast_mode = enable != 0;
+  if (sim->single) {
+    sim->single->set_fast_mode(sim->fast_mode);
+  } else {
+    sim->multi->set_fast_mode(sim->fast_mode);
+  }
+}
+
+void cachesim_process(cachesim_t *sim, const cachesim_event_t *events,
+                      size_t count) {
+  if (sim == nullptr || events == nullptr) {
+    return;
+  }
+  if (sim->single) {
+    for (size_t i = 0; i < count; i++) {
+      sim->single->process(to_trace_event(events[i]));
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      sim->multi->process(to_trace_event(events[i]));
+    }
+  }
+  sim->events_processed += count;
+}
+
+void cachesim_get_stats(const cachesim_t *sim, cachesim_stats_t *out) {
+  if (sim == nullptr || out == nullptr) {
+    return;
+  }
+  *out = {};
+  out->events = sim->events_processed;
+
+  if (sim->single) {
+    HierarchyStats stats = sim->single->get_stats();
+    fill_level(stats.l1d, &out->l1d);
+    fill_level(stats.l1i, &out->l1i);
+    fill_level(stats.l2, &out->l2);
+    fill_level(stats.l3, &out->l3);
+    TLBHierarchyStats tlb = sim->single->get_cache_system().get_tlb_stats();
+    out->dtlb_hits = tlb.dtlb.hits;
+    out->dtlb_misses = tlb.dtlb.misses;
+    out->total_cycles = stats.timing.total_cycles;
+    return;
+  }
+
+  MultiCoreStats stats = sim->multi->get_stats();
+  CacheStats l1_total;
+  for (const CacheStats &core : stats.l1_per_core) {
+    l1_total += core;
+  }
+  fill_level(l1_total, &out->l1d);
+  fill_level(stats.l2, &out->l2);
+  fill_level(stats.l3, &out->l3);
+  TLBHierarchyStats tlb = sim->multi->get_cache_system().get_tlb_stats();
+  out->dtlb_hits = tlb.dtlb.hits;
+  out->dtlb_misses = tlb.dtlb.misses;
+  out->coherence_invalidations = stats.coherence_invalidations;
+  out->false_sharing_events = stats.false_sharing_events;
+}
+
+size_t cachesim_get_hot_lines(cachesim_t *sim, cachesim_hot_line_t *out,
+                              size_t max_lines) {
+  if (sim == nullptr || out == nullptr || max_lines == 0) {
+    return 0;
+  }
+  size_t written = 0;
+  if (sim->single) {
+    for (const SourceStats &s : sim->single->get_hot_lines(max_lines)) {
+      out[written++] = {sim->c_name(s.file), s.line, s.hits, s.misses};
+    }
+  } else {
+    for (const MultiCoreSourceStats &s : sim->multi->get_hot_lines(max_lines)) {
+      out[written++] = {sim->c_name(s.file), s.line, s.hits, s.misses};
+    }
+  }
+  return written;
+}
+
+void cachesim_reset(cachesim_t *sim) {
+  if (sim == nullptr) {
+    return;
+  }
+  if (sim->single) {
+    sim->single->clear();
+  } else {
+    // No clear() on the multi-core processor - rebuild it
+    sim->multi = std::make_unique<MultiCoreTraceProcessor>(
+        sim->num_cores, sim->cfg.l1_data, sim->cfg.l2, sim->cfg.l3,
+        sim->prefetch_policy, sim->prefetch_degree);
+  }
+  apply_settings(sim);
+  sim->events_processed = 0;
+}
+
+const char *cachesim_version(void) { return "1.0.0"; }
+
+} // extern "C"
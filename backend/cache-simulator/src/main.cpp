@@ -1,11 +1,38 @@
 #include "../include/ArgParser.hpp"
+#include "../include/BinaryTrace.hpp"
 #include "../include/FastIO.hpp"
+#include "../include/IncrementalSim.hpp"
 #include "../include/JsonOutput.hpp"
+#include "../include/JsonParser.hpp"
+#include "../include/ThreadPool.hpp"
 #include "../include/MultiCoreTraceProcessor.hpp"
 #include "../include/OptimizationSuggester.hpp"
+#include "../include/PhaseSampler.hpp"
+#include "../include/ResultCache.hpp"
+#include "../include/ResultDiff.hpp"
+#include "../include/ReuseDistance.hpp"
+#include "../include/SelfProfiler.hpp"
+#include "../include/ShmTransport.hpp"
+#include "../include/TraceFilter.hpp"
+#include "../include/TraceIndex.hpp"
 #include "../include/TraceProcessor.hpp"
+#include "../include/TraceSpill.hpp"
+#include "../include/ParallelTraceParser.hpp"
+#include "../include/TracePipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
 #include <unordered_set>
 #include <vector>
 
@@ -14,6 +41,18 @@ static size_t progress_total = 0;
 static size_t progress_interval = 0;
 static size_t progress_next = 0;
 
+// Events fed to the processor per process_batch() call - small enough that
+// progress updates stay responsive, large enough to amortize the call
+static constexpr size_t PROCESS_CHUNK = 4096;
+
+// Cooperative cancellation: the web UI's cancel button sends SIGTERM
+// (Ctrl+C sends SIGINT) and the batch loops poll this flag between
+// chunks. A cancelled run stops simulating, falls through to the normal
+// output path, and reports stats for the prefix actually processed,
+// marked partial - twenty minutes into a misconfigured run the partial
+// numbers usually answer the question.
+static volatile sig_atomic_t g_cancel_requested = 0;
+
 static void progress_init(size_t total) {
   progress_total = total;
   // Emit at ~1% intervals, minimum 500 events
@@ -44,6 +83,16 @@ static void progress_done() {
   }
 }
 
+// 95% binomial confidence half-width on a set-sampled hit rate, from the
+// number of accesses actually simulated (call before scaling the stats)
+static double sampling_error_bound(const CacheStats &s) {
+  uint64_t n = s.total_accesses();
+  if (n == 0)
+    return 0.0;
+  double p = s.hit_rate();
+  return 1.96 * std::sqrt(p * (1.0 - p) / static_cast<double>(n));
+}
+
 // Generate SVG flamegraph showing cache miss distribution
 template<typename HotLineType>
 void output_flamegraph_svg(const std::vector<HotLineType>& hot_lines, const std::string& title) {
@@ -108,7 +157,7 @@ void output_flamegraph_svg(const std::vector<HotLineType>& hot_lines, const std:
               << "\" fill=\"" << color << "\" rx=\"2\"/>\n";
 
     // Label (file:line)
-    std::string label = h.file + ":" + std::to_string(h.line);
+    std::string label = std::string(h.file) + ":" + std::to_string(h.line);
     if (label.length() > 30) {
       label = "..." + label.substr(label.length() - 27);
     }
@@ -133,19 +182,440 @@ void output_flamegraph_svg(const std::vector<HotLineType>& hot_lines, const std:
   std::cout << "</svg>\n";
 }
 
-int main(int argc, char *argv[]) {
-  // Disable C/C++ stream sync - massive speedup for stdin/stdout
-  std::ios_base::sync_with_stdio(false);
-  std::cin.tie(nullptr);
+// Daemon mode keeps one processor per distinct hierarchy config alive so
+// repeat jobs skip construction and allocator warmup; in one-shot mode the
+// pool simply holds the single processor for the run
+static TraceProcessor &acquire_processor(const SimulatorOptions &opts) {
+  static std::unordered_map<std::string, std::unique_ptr<TraceProcessor>> pool;
+
+  std::string key = opts.config_name;
+  if (opts.config_name == "custom") {
+    key += ":" + std::to_string(opts.l1_size) + "/" + std::to_string(opts.l1_assoc) +
+           ":" + std::to_string(opts.l2_size) + "/" + std::to_string(opts.l2_assoc) +
+           ":" + std::to_string(opts.l3_size) + "/" + std::to_string(opts.l3_assoc) +
+           ":" + std::to_string(opts.line_size);
+  }
 
-  // Parse command line arguments
-  SimulatorOptions opts = ArgParser::parse(argc, argv);
+  auto it = pool.find(key);
+  if (it == pool.end()) {
+    it = pool.emplace(key, std::make_unique<TraceProcessor>(opts.cache_config)).first;
+  } else {
+    it->second->clear(); // Reuse the allocation, drop all state
+  }
+  return *it->second;
+}
 
-  if (opts.show_help) {
-    ArgParser::print_usage(argv[0]);
-    return 0;
+// One preset's collected results for --configs mode
+struct ConfigRunResult {
+  std::string name;
+  int cores = 0;
+  MultiCoreStats stats;
+  CacheStats l1_total;
+  std::string prefetch_policy;
+  int prefetch_degree = 0;
+};
+
+// Multi-preset batch mode: the trace is parsed once (the shared cost) and
+// the in-memory event stream replays through an independent processor per
+// preset, each on its own thread. The multi-core processor handles
+// single-threaded traces transparently, same as stream and pipeline modes.
+// Results come out as a JSON array in preset order.
+static int run_multi_config(const SimulatorOptions &opts,
+                            const std::vector<TraceEvent> &events,
+                            size_t thread_count) {
+  int num_cores = opts.num_cores;
+  if (num_cores == 0)
+    num_cores = std::max(1, std::min((int)thread_count, 8));
+
+  std::vector<ConfigRunResult> results(opts.config_list.size());
+  std::vector<std::thread> workers;
+  for (size_t c = 0; c < opts.config_list.size(); c++) {
+    workers.emplace_back([&, c, num_cores]() {
+      // Per-preset options: each preset brings its own hierarchy and
+      // prefetch defaults unless overridden on the command line
+      SimulatorOptions cfg_opts = opts;
+      cfg_opts.config_name = opts.config_list[c];
+      cfg_opts.cache_config = ArgParser::build_cache_config(cfg_opts);
+      ArgParser::apply_preset_prefetch(cfg_opts);
+      const CacheHierarchyConfig &cfg = cfg_opts.cache_config;
+
+      MultiCoreTraceProcessor processor(num_cores, cfg.l1_data, cfg.l2,
+                                         cfg.l3, cfg_opts.prefetch_policy,
+                                         cfg_opts.prefetch_degree,
+                                         opts.coherence_mode,
+                                         cfg.coherence_protocol);
+      if (opts.fast_mode) {
+        processor.set_fast_mode(true);
+      } else {
+        processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+      }
+      if (!opts.coherence_memo) {
+        processor.set_coherence_memo(false);
+      }
+      if (opts.hot_line_budget) {
+        processor.set_hot_line_budget(opts.hot_line_budget);
+      }
+      if (opts.huge_page_size) {
+        processor.set_page_size(opts.huge_page_size);
+      }
+      for (size_t i = 0; i < events.size(); i += PROCESS_CHUNK) {
+        size_t n = std::min(PROCESS_CHUNK, events.size() - i);
+        processor.process_batch(events.data() + i, n);
+      }
+
+      ConfigRunResult &r = results[c];
+      r.name = cfg_opts.config_name;
+      r.cores = processor.get_num_cores();
+      r.stats = processor.get_stats();
+      for (const auto &l1 : r.stats.l1_per_core) {
+        r.l1_total += l1;
+      }
+      r.prefetch_policy = ArgParser::prefetch_policy_name(cfg_opts.prefetch_policy);
+      r.prefetch_degree = cfg_opts.prefetch_degree;
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  std::cout << "[\n";
+  for (size_t c = 0; c < results.size(); c++) {
+    const auto &r = results[c];
+    std::cout << "  {\n";
+    std::cout << "    \"config\": \"" << JsonOutput::escape(r.name) << "\",\n";
+    std::cout << "    \"events\": " << events.size() << ",\n";
+    std::cout << "    \"cores\": " << r.cores << ",\n";
+    std::cout << "    \"levels\": {\n";
+    auto json_level = [](const char *name, const CacheStats &s, bool last) {
+      std::cout << "      \"" << name << "\": {"
+                << "\"hits\": " << s.hits << ", "
+                << "\"misses\": " << s.misses << ", "
+                << "\"hitRate\": " << std::fixed << std::setprecision(3) << s.hit_rate() << ", "
+                << "\"writebacks\": " << s.writebacks << ", "
+                << "\"compulsory\": " << s.compulsory_misses << ", "
+                << "\"capacity\": " << s.capacity_misses << ", "
+                << "\"conflict\": " << s.conflict_misses << "}"
+                << (last ? "\n" : ",\n");
+    };
+    json_level("l1", r.l1_total, false);
+    json_level("l2", r.stats.l2, false);
+    json_level("l3", r.stats.l3, true);
+    std::cout << "    },\n";
+    std::cout << "    \"coherence\": {\"invalidations\": "
+              << r.stats.coherence_invalidations
+              << ", \"falseSharingEvents\": " << r.stats.false_sharing_events
+              << "},\n";
+    std::cout << "    \"prefetch\": {\"policy\": \"" << r.prefetch_policy
+              << "\", \"degree\": " << r.prefetch_degree << "}\n";
+    std::cout << "  }" << (c + 1 < results.size() ? ",\n" : "\n");
+  }
+  std::cout << "]\n" << std::flush;
+  return 0;
+}
+
+// Expand one trace event into line-granular demand references, mirroring
+// how the processors break events into line touches. Instruction fetches
+// and prefetch hints are skipped - sinks see demand data references only.
+// The sink receives (line_address, is_write).
+template <typename Sink>
+static void for_each_demand_line(const TraceEvent &event, int line_size,
+                                 Sink &&sink) {
+  if (event.is_icache || event.is_prefetch || event.is_alloc ||
+      event.is_free || event.is_phase_begin || event.is_phase_end ||
+      event.is_sample_rate)
+    return;
+  if (event.is_range) {
+    uint64_t addr = event.address;
+    for (uint64_t i = 0; i < event.count; i++, addr += event.stride) {
+      for (const auto &a : split_access_to_cache_lines(
+               {addr, event.size, event.is_write}, line_size))
+        sink(a.line_address, a.is_write);
+    }
+    return;
+  }
+  if (event.is_memcpy || event.is_memmove) {
+    // Source side reads, then the destination write below
+    for (const auto &a : split_access_to_cache_lines(
+             {event.src_address, event.size, false}, line_size))
+      sink(a.line_address, a.is_write);
+  }
+  for (const auto &a : split_access_to_cache_lines(
+           {event.address, event.size, event.is_write}, line_size))
+    sink(a.line_address, a.is_write);
+}
+
+// Feed one trace event into the reuse-distance analyzer
+static void mrc_feed_event(ReuseDistanceAnalyzer &mrc, const TraceEvent &event,
+                           int line_size) {
+  for_each_demand_line(event, line_size,
+                       [&](uint64_t line, bool) { mrc.access(line); });
+}
+
+// Belady-optimal replacement analysis results (--opt)
+struct OptResult {
+  bool ran = false;
+  CacheStats l1, l2, l3;
+};
+
+// Replay the demand data stream through a hierarchy running Belady OPT at
+// every level. Next-use times come from one backward scan over the
+// line-granular stream (the compact equivalent of per-line occurrence
+// lists); each access then carries its next-use time into the caches,
+// where find_victim_opt() evicts the line referenced farthest ahead. OPT
+// is exact for L1; deeper levels reuse the global next-use order, which
+// is the standard offline bound for a filtered stream.
+static OptResult run_opt_analysis(const std::vector<TraceEvent> &events,
+                                  CacheHierarchyConfig cfg) {
+  struct LineRef {
+    uint64_t line;
+    bool is_write;
+  };
+  std::vector<LineRef> refs;
+  refs.reserve(events.size());
+  for (const auto &event : events) {
+    for_each_demand_line(event, cfg.l1_data.line_size,
+                         [&](uint64_t line, bool is_write) {
+                           refs.push_back({line, is_write});
+                         });
+  }
+
+  // Next-use precomputation: scan backward, carrying each line's most
+  // recently seen (i.e. next in trace order) position
+  std::vector<uint64_t> next_use(refs.size());
+  std::unordered_map<uint64_t, uint64_t> next_seen;
+  next_seen.reserve(refs.size() / 4);
+  for (size_t i = refs.size(); i-- > 0;) {
+    auto it = next_seen.find(refs[i].line);
+    next_use[i] =
+        it == next_seen.end() ? CacheLevel::NEXT_USE_NEVER : it->second;
+    next_seen[refs[i].line] = i;
+  }
+
+  cfg.l1_data.policy = EvictionPolicy::OPT;
+  cfg.l2.policy = EvictionPolicy::OPT;
+  cfg.l3.policy = EvictionPolicy::OPT;
+  CacheSystem system(cfg);
+  system.set_fast_mode(true);  // Only hit/miss counts matter here
+  for (size_t i = 0; i < refs.size(); i++) {
+    system.set_pending_next_use(next_use[i]);
+    if (refs[i].is_write) {
+      system.write(refs[i].line);
+    } else {
+      system.read(refs[i].line);
+    }
+  }
+
+  auto stats = system.get_stats();
+  return {true, stats.l1d, stats.l2, stats.l3};
+}
+
+// Phase-sampled simulation results (--simpoint). Estimates are weighted
+// extrapolations from one simulated representative per phase; the error
+// bound is the clustering-distortion heuristic from PhaseSampler.hpp.
+struct SimPointLevel {
+  double hits = 0, misses = 0;
+  [[nodiscard]] double hit_rate() const {
+    double total = hits + misses;
+    return total > 0 ? hits / total : 0;
+  }
+};
+
+struct SimPointResult {
+  bool ran = false;
+  size_t intervals = 0;
+  size_t phases = 0;
+  uint64_t simulated_events = 0;
+  uint64_t total_events = 0;
+  double error_bound = 0;  // heuristic +/- on the hit-rate estimates
+  SimPointLevel l1d, l2, l3;
+};
+
+static SimPointResult run_simpoint(TraceProcessor &processor,
+                                   const std::vector<TraceEvent> &events,
+                                   size_t interval_len, size_t max_k) {
+  PhaseSampler sampler(interval_len, max_k ? max_k
+                                           : PhaseSampler::DEFAULT_MAX_CLUSTERS);
+  for (const auto &event : events)
+    sampler.add_event(event);
+  sampler.finish();
+  auto plan = sampler.cluster();
+
+  SimPointResult r;
+  r.ran = true;
+  r.intervals = sampler.num_intervals();
+  r.phases = plan.clusters.size();
+  r.total_events = events.size();
+
+  // Events covered by each phase, for event-weighted extrapolation (the
+  // trailing interval is usually shorter than the rest)
+  std::vector<uint64_t> phase_events(plan.clusters.size(), 0);
+  for (size_t i = 0; i < r.intervals; i++)
+    phase_events[plan.assignment[i]] += sampler.events_in_interval(i);
+
+  // Simulate representatives in trace order through the shared processor
+  // and capture each one's per-level delta
+  std::vector<SimPointLevel> rep_l1d(r.phases), rep_l2(r.phases),
+      rep_l3(r.phases);
+  size_t offset = 0;
+  for (size_t i = 0; i < r.intervals; i++) {
+    size_t n = sampler.events_in_interval(i);
+    int phase = plan.assignment[i];
+    if (plan.clusters[phase].representative == i) {
+      auto before = processor.get_stats();
+      processor.process_batch(events.data() + offset, n);
+      processor.flush_segments();
+      auto after = processor.get_stats();
+      rep_l1d[phase] = {double(after.l1d.hits - before.l1d.hits),
+                        double(after.l1d.misses - before.l1d.misses)};
+      rep_l2[phase] = {double(after.l2.hits - before.l2.hits),
+                       double(after.l2.misses - before.l2.misses)};
+      rep_l3[phase] = {double(after.l3.hits - before.l3.hits),
+                       double(after.l3.misses - before.l3.misses)};
+      r.simulated_events += n;
+    }
+    offset += n;
+  }
+
+  // Scale each representative's delta to its phase's event population
+  for (size_t c = 0; c < r.phases; c++) {
+    size_t rep = plan.clusters[c].representative;
+    double scale = double(phase_events[c]) /
+                   double(sampler.events_in_interval(rep));
+    r.l1d.hits += rep_l1d[c].hits * scale;
+    r.l1d.misses += rep_l1d[c].misses * scale;
+    r.l2.hits += rep_l2[c].hits * scale;
+    r.l2.misses += rep_l2[c].misses * scale;
+    r.l3.hits += rep_l3[c].hits * scale;
+    r.l3.misses += rep_l3[c].misses * scale;
+    r.error_bound += (double(phase_events[c]) / double(r.total_events)) *
+                     plan.clusters[c].distortion;
+  }
+  return r;
+}
+
+// Write a checkpoint atomically: a run killed mid-write must not clobber
+// the last good snapshot, so write to a temp file and rename over it
+static bool write_checkpoint(const TraceProcessor &processor,
+                             const std::string &path,
+                             uint64_t events_processed) {
+  std::string tmp = path + ".tmp";
+  std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  try {
+    processor.save_checkpoint(out, events_processed);
+  } catch (const std::exception &) {
+    return false;
+  }
+  out.close();
+  return out && std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// Delta of the counters a --stream-stats snapshot carries
+static CacheStats snapshot_delta(const CacheStats &cur, const CacheStats &prev) {
+  CacheStats d;
+  d.hits = cur.hits - prev.hits;
+  d.misses = cur.misses - prev.misses;
+  return d;
+}
+
+// Redirects std::cout into a buffer for the rest of the run; on scope
+// exit the captured document is replayed to the real stdout and stored
+// in the result cache. Error paths write to stderr only, so an empty
+// capture is never stored.
+class ResultCaptureGuard {
+public:
+  void activate(const ResultCache &cache, uint64_t key) {
+    cache_ = &cache;
+    key_ = key;
+    saved_ = std::cout.rdbuf(buf_.rdbuf());
+  }
+
+  ~ResultCaptureGuard() {
+    if (!saved_)
+      return;
+    std::cout.rdbuf(saved_);
+    std::string text = buf_.str();
+    std::cout << text << std::flush;
+    // A cancelled run's partial document is replayed but never cached -
+    // the same trace and config must not replay truncated stats later
+    if (!text.empty() && text.front() == '{' && !g_cancel_requested)
+      cache_->store(key_, text);
+  }
+
+private:
+  std::ostringstream buf_;
+  std::streambuf *saved_ = nullptr;
+  const ResultCache *cache_ = nullptr;
+  uint64_t key_ = 0;
+};
+
+// Build the parse-time event filter from the --filter-* flags. Events it
+// rejects cost a predicate check instead of a simulation, so narrowing an
+// existing trace is a re-filter, not a re-capture.
+static TraceFilter make_trace_filter(const SimulatorOptions &opts) {
+  TraceFilter filter;
+  if (!opts.filter_file.empty())
+    filter.set_file_glob(opts.filter_file);
+  if (opts.filter_addr_lo != opts.filter_addr_hi)
+    filter.set_addr_range(opts.filter_addr_lo, opts.filter_addr_hi);
+  if (!opts.filter_heap.empty())
+    filter.set_heap_glob(opts.filter_heap, opts.filter_heap_exclude);
+  return filter;
+}
+
+// Apply --placement / --placement-file to a multicore processor: the
+// policy for unpinned threads, plus explicit pins read from a mapping
+// file of "thread core" pairs (one per line, '#' comments). Returns
+// false on an unknown policy, a malformed line, or an out-of-range core.
+static bool configure_thread_placement(MultiCoreTraceProcessor &processor,
+                                       const SimulatorOptions &opts) {
+  if (!opts.placement.empty()) {
+    if (opts.placement == "compact") {
+      processor.set_thread_placement(ThreadPlacement::Compact);
+    } else if (opts.placement == "scatter") {
+      processor.set_thread_placement(ThreadPlacement::Scatter);
+    } else {
+      std::cerr << "Error: unknown placement '" << opts.placement
+                << "' (expected compact or scatter)\n";
+      return false;
+    }
+  }
+  if (!opts.placement_file.empty()) {
+    std::ifstream in(opts.placement_file);
+    if (!in) {
+      std::cerr << "Error: cannot open placement file '"
+                << opts.placement_file << "'\n";
+      return false;
+    }
+    std::string entry;
+    while (std::getline(in, entry)) {
+      if (entry.empty() || entry[0] == '#')
+        continue;
+      std::istringstream iss(entry);
+      uint32_t thread;
+      int core;
+      if (!(iss >> thread >> core)) {
+        std::cerr << "Error: malformed placement line '" << entry
+                  << "' (expected \"thread core\")\n";
+        return false;
+      }
+      if (core < 0 || core >= processor.get_num_cores()) {
+        std::cerr << "Error: placement pins thread " << thread << " to core "
+                  << core << " but the system has "
+                  << processor.get_num_cores() << " cores\n";
+        return false;
+      }
+      processor.pin_thread(thread, core);
+    }
   }
+  return true;
+}
 
+// Run one simulation end-to-end, reading the trace from stdin (or the
+// configured trace file) and writing results to stdout
+static int run_simulation(const SimulatorOptions &opts) {
   // Extract commonly used values for readability
   const std::string& config_name = opts.config_name;
   int num_cores = opts.num_cores;
@@ -157,6 +627,64 @@ int main(int argc, char *argv[]) {
   PrefetchPolicy prefetch_policy = opts.prefetch_policy;
   int prefetch_degree = opts.prefetch_degree;
   CacheHierarchyConfig cfg = opts.cache_config;
+  TraceFilter filter = make_trace_filter(opts);
+
+  // Catch the first cancel signal and finish cleanly with partial
+  // results; SA_RESETHAND restores the default disposition so a second
+  // signal (or the server's SIGKILL escalation) still terminates a run
+  // that never reaches a poll point. Reset the flag for daemon jobs that
+  // reuse the process.
+  g_cancel_requested = 0;
+  struct sigaction cancel_action = {};
+  sigemptyset(&cancel_action.sa_mask);
+  cancel_action.sa_handler = [](int) { g_cancel_requested = 1; };
+  cancel_action.sa_flags = SA_RESETHAND;
+  sigaction(SIGTERM, &cancel_action, nullptr);
+  sigaction(SIGINT, &cancel_action, nullptr);
+
+  // Range replay (--replay-range): seek into a --trace-file via its
+  // sidecar index and simulate only a window of events. The window runs
+  // as a plain single-core batch over a slice, so modes that re-read the
+  // trace or renumber events don't combine with it.
+  size_t replay_lo = 0;
+  size_t replay_hi = 0;
+  const bool replay_mode = !opts.replay_range.empty();
+  if (replay_mode) {
+    auto colon = opts.replay_range.find(':');
+    if (colon == std::string::npos) {
+      std::cerr << "Error: --replay-range expects a:b (event indices)\n";
+      return 1;
+    }
+    replay_lo = std::stoull(opts.replay_range.substr(0, colon));
+    replay_hi = std::stoull(opts.replay_range.substr(colon + 1));
+    if (replay_hi <= replay_lo) {
+      std::cerr << "Error: --replay-range needs a < b\n";
+      return 1;
+    }
+    if (opts.trace_file.empty()) {
+      std::cerr << "Error: --replay-range needs --trace-file (stdin cannot "
+                   "be seeked)\n";
+      return 1;
+    }
+    if (stream_mode || opts.pipeline_mode || opts.spill_mode ||
+        opts.parallel_parsing || opts.simpoint_interval > 0 ||
+        !opts.incremental_baseline.empty() || !opts.restore_file.empty() ||
+        opts.warmup_events > 0 || filter.active()) {
+      std::cerr << "Error: --replay-range cannot be combined with streaming, "
+                   "spill, parallel parsing, --simpoint, --incremental, "
+                   "--restore, --warmup or trace filters\n";
+      return 1;
+    }
+  }
+  size_t replay_base = 0;         // Global index of events[0] in the trace
+  size_t replay_warm = 0;         // Leading slice events that only warm state
+  std::string replay_checkpoint;  // Snapshot the replay resumes from
+
+  // Multi-preset mode needs the whole trace in memory up front
+  if (!opts.config_list.empty() && (opts.stream_mode || opts.pipeline_mode)) {
+    std::cerr << "Error: --configs requires batch mode (no --stream/--pipeline)\n";
+    return 1;
+  }
 
   // Streaming mode: process events as they arrive and output JSON for each
   // Uses MultiCoreTraceProcessor to handle both single and multi-threaded code
@@ -166,6 +694,31 @@ int main(int argc, char *argv[]) {
                                        prefetch_policy, prefetch_degree);
     if (fast_mode) {
       processor.set_fast_mode(true);
+    } else {
+      processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+    }
+    if (!opts.coherence_memo) {
+      processor.set_coherence_memo(false);
+    }
+    if (opts.hot_line_budget) {
+      processor.set_hot_line_budget(opts.hot_line_budget);
+    }
+    if (opts.huge_page_size) {
+      processor.set_page_size(opts.huge_page_size);
+    }
+    if (opts.prefetch_throttle) {
+      processor.enable_prefetch_throttling();
+    }
+    if (cfg.cores_per_ccx > 0) {
+      processor.enable_ccx_topology(cfg.cores_per_ccx);
+    }
+    if (opts.numa_sockets > 1) {
+      processor.enable_numa(opts.numa_sockets,
+                            opts.numa_interleave ? NumaPlacement::Interleave
+                                                 : NumaPlacement::FirstTouch);
+    }
+    if (!configure_thread_placement(processor, opts)) {
+      return 1;
     }
 
     size_t event_count = 0;
@@ -189,8 +742,9 @@ int main(int argc, char *argv[]) {
     const TraceEvent* current_event = nullptr;
     size_t current_index = 0;
 
-    // Set up callback to capture hit level for each access
-    processor.set_event_callback([&](const EventResult& result) {
+    // Visitor capturing the hit level of each access - installed as a
+    // compile-time visitor so the per-event delivery is a direct call
+    auto record_timeline = [&](const EventResult& result) {
       if (current_event) {
         int level = 4;  // memory by default
         if (result.l1_hit) level = 1;
@@ -203,19 +757,21 @@ int main(int argc, char *argv[]) {
           current_event->is_icache,
           level,
           current_event->address,
-          current_event->file,
+          std::string(current_event->file),
           current_event->line
         });
       }
-    });
+    };
+    processor.set_event_visitor(record_timeline);
 
     // Output header with multicore info
     std::cout << "{\"type\":\"start\",\"config\":\"" << config_name << "\",\"multicore\":true}\n" << std::flush;
 
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (!g_cancel_requested && std::getline(std::cin, line)) {
       auto event = parse_trace_event(line);
       if (!event) continue;
+      if (filter.active() && !filter.admit(*event)) continue;
 
       event_count++;
       current_index = event_count;
@@ -311,6 +867,7 @@ int main(int argc, char *argv[]) {
 
     std::cout << "{\"type\":\"complete\""
               << ",\"events\":" << event_count
+              << (g_cancel_requested ? ",\"partial\":true" : "")
               << ",\"threads\":" << processor.get_thread_count()
               << ",\"cores\":" << processor.get_num_cores()
               << ",\"levels\":{";
@@ -335,6 +892,16 @@ int main(int argc, char *argv[]) {
     std::cout << ",\"coherence\":{\"invalidations\":" << stats.coherence_invalidations
               << ",\"falseSharingEvents\":" << stats.false_sharing_events << "}";
 
+    // NUMA stats (only when multi-socket mode is enabled)
+    if (opts.numa_sockets > 1) {
+      auto numa = processor.get_numa_stats();
+      std::cout << ",\"numa\":{\"sockets\":" << numa.sockets
+                << ",\"localAccesses\":" << numa.local_accesses
+                << ",\"remoteAccesses\":" << numa.remote_accesses
+                << ",\"remoteRatio\":" << std::fixed << std::setprecision(3)
+                << numa.remote_ratio() << "}";
+    }
+
     std::cout << ",\"hotLines\":[";
     for (size_t i = 0; i < hot.size(); i++) {
       if (i > 0) std::cout << ",";
@@ -347,6 +914,21 @@ int main(int argc, char *argv[]) {
     }
     std::cout << "]";
 
+    // Per-function rollup (only when the trace carried G records)
+    auto hot_funcs = processor.get_hot_functions(10);
+    if (!hot_funcs.empty()) {
+      std::cout << ",\"hotFunctions\":[";
+      for (size_t i = 0; i < hot_funcs.size(); i++) {
+        if (i > 0) std::cout << ",";
+        std::cout << "{\"function\":\"" << JsonOutput::escape(hot_funcs[i].function) << "\""
+                  << ",\"hits\":" << hot_funcs[i].hits
+                  << ",\"misses\":" << hot_funcs[i].misses
+                  << ",\"missRate\":" << std::fixed << std::setprecision(3) << hot_funcs[i].miss_rate()
+                  << ",\"lines\":" << hot_funcs[i].lines << "}";
+      }
+      std::cout << "]";
+    }
+
     // False sharing reports (if any)
     if (!false_sharing.empty()) {
       std::cout << ",\"falseSharing\":[";
@@ -381,7 +963,11 @@ int main(int argc, char *argv[]) {
               << "},\"itlb\":{\"hits\":" << tlb_stats.itlb.hits
               << ",\"misses\":" << tlb_stats.itlb.misses
               << ",\"hitRate\":" << std::fixed << std::setprecision(3) << tlb_stats.itlb.hit_rate()
-              << "}}";
+              << "},\"stlb\":{\"hits\":" << tlb_stats.stlb.hits
+              << ",\"misses\":" << tlb_stats.stlb.misses
+              << ",\"hitRate\":" << std::fixed << std::setprecision(3) << tlb_stats.stlb.hit_rate()
+              << "},\"pageSize\":" << processor.get_cache_system().get_page_size()
+              << "}";
 
     // Timing estimate based on hit counts and latency config
     uint64_t l1_hit_cycles = l1_total.hits * cfg.latency.l1_hit;
@@ -421,17 +1007,28 @@ int main(int argc, char *argv[]) {
                 << "\"degree\":" << prefetch_degree << ","
                 << "\"issued\":" << total_pf.prefetches_issued << ","
                 << "\"useful\":" << total_pf.prefetches_useful << ","
-                << "\"accuracy\":" << std::fixed << std::setprecision(3) << total_pf.accuracy()
-                << "}";
+                << "\"accuracy\":" << std::fixed << std::setprecision(3) << total_pf.accuracy();
+      if (opts.prefetch_throttle) {
+        const auto &cs = processor.get_cache_system();
+        std::cout << ",\"throttle\":{\"perCore\":[";
+        for (int c = 0; c < cs.get_num_cores(); c++) {
+          if (c) std::cout << ",";
+          JsonOutput::write_throttle(std::cout, cs.get_prefetcher(c));
+        }
+        std::cout << "]}";
+      }
+      std::cout << "}";
     }
 
     // Advanced instrumentation stats
     auto sw_pf = processor.get_software_prefetch_stats();
     auto vec = processor.get_vector_stats();
+    auto gs = processor.get_gather_scatter_stats();
     auto atomic = processor.get_atomic_stats();
     auto mem = processor.get_memory_intrinsic_stats();
 
     bool has_advanced = sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 ||
+                        gs.gathers > 0 || gs.scatters > 0 ||
                         atomic.load_count > 0 || atomic.store_count > 0 ||
                         mem.memcpy_count > 0 || mem.memset_count > 0;
     if (has_advanced) {
@@ -449,15 +1046,24 @@ int main(int argc, char *argv[]) {
                   << ",\"bytesStored\":" << vec.bytes_stored
                   << ",\"crossLineAccesses\":" << vec.cross_line_accesses << "}";
       }
-      if (atomic.load_count > 0 || atomic.store_count > 0 || atomic.rmw_count > 0 || atomic.cmpxchg_count > 0) {
+      if (gs.gathers > 0 || gs.scatters > 0) {
         if (sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0) std::cout << ",";
+        std::cout << "\"gather\":{\"gathers\":" << gs.gathers
+                  << ",\"scatters\":" << gs.scatters
+                  << ",\"lanes\":" << gs.lanes
+                  << ",\"bytes\":" << gs.bytes
+                  << ",\"linesTouched\":" << gs.lines_touched
+                  << ",\"avgLinesPerOp\":" << std::fixed << std::setprecision(3) << gs.avg_lines_per_op() << "}";
+      }
+      if (atomic.load_count > 0 || atomic.store_count > 0 || atomic.rmw_count > 0 || atomic.cmpxchg_count > 0) {
+        if (sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 || gs.gathers > 0 || gs.scatters > 0) std::cout << ",";
         std::cout << "\"atomic\":{\"loads\":" << atomic.load_count
                   << ",\"stores\":" << atomic.store_count
                   << ",\"rmw\":" << atomic.rmw_count
                   << ",\"cmpxchg\":" << atomic.cmpxchg_count << "}";
       }
       if (mem.memcpy_count > 0 || mem.memset_count > 0 || mem.memmove_count > 0) {
-        if (sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 || atomic.load_count > 0 || atomic.store_count > 0) std::cout << ",";
+        if (sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 || gs.gathers > 0 || gs.scatters > 0 || atomic.load_count > 0 || atomic.store_count > 0) std::cout << ",";
         std::cout << "\"memoryIntrinsics\":{\"memcpyCount\":" << mem.memcpy_count
                   << ",\"memcpyBytes\":" << mem.memcpy_bytes
                   << ",\"memsetCount\":" << mem.memset_count
@@ -468,78 +1074,630 @@ int main(int argc, char *argv[]) {
       std::cout << "}";
     }
 
+    if (!fast_mode) {
+      auto cls = processor.get_classifier_summary();
+      std::cout << ",\"missClassifier\":{\"fpRate\":" << std::setprecision(6) << cls.fp_rate
+                << ",\"estimatedFpRate\":" << cls.estimated_fp_rate
+                << ",\"memoryBytes\":" << cls.memory_bytes << "}" << std::setprecision(3);
+    }
+
     std::cout << "}\n" << std::flush;
     return 0;
   }
 
+  // Disk-spill mode keeps memory bounded, so anything that needs the
+  // whole trace (or its raw text) resident is off the table
+  if (opts.spill_mode) {
+    const char *conflict = nullptr;
+    if (opts.pipeline_mode)
+      conflict = "--pipeline";
+    else if (opts.parallel_parsing)
+      conflict = "--parallel";
+    else if (opts.binary_input)
+      conflict = "--binary";
+    else if (opts.simpoint_interval > 0)
+      conflict = "--simpoint";
+    else if (!opts.restore_file.empty())
+      conflict = "--restore";
+    else if (!opts.incremental_baseline.empty())
+      conflict = "--incremental";
+    else if (!opts.config_list.empty())
+      conflict = "--configs";
+    else if (opts.mrc)
+      conflict = "--mrc";
+    else if (opts.opt_analysis)
+      conflict = "--opt";
+    if (conflict) {
+      std::cerr << "Error: " << conflict << " cannot be combined with --spill\n";
+      return 1;
+    }
+  }
+
+  // Virtual-time dispatch is decided one event at a time from simulated
+  // latencies; epoch-parallel simulation would decide it from stale clocks
+  if (opts.virtual_time && opts.parallel_sim) {
+    std::cerr << "Error: --virtual-time cannot be combined with --parallel-sim\n";
+    return 1;
+  }
+
+  // Self-profiling (--self-profile): four stage markers around the batch
+  // pipeline; the destructor prints the per-stage breakdown to stderr
+  SelfProfiler self_prof(opts.self_profile);
+  self_prof.enter(ProfileStage::Read);
+
   // Batch mode: Read all events first to detect thread count
   std::vector<TraceEvent> events;
   std::unordered_set<uint32_t> threads;
 
-  // Bulk-read stdin (eliminates per-character getc/mutex overhead)
-  auto input_buf = BulkReader::read_all();
+  // Input source: mmap'd trace file (no heap copy, pages stream on demand)
+  // or bulk-read stdin (eliminates per-character getc/mutex overhead)
+  MappedFile mapped_trace;
+  std::string input_buf;
+  const char *input_data = nullptr;
+  size_t input_size = 0;
+
+  if (opts.pipeline_mode || opts.spill_mode) {
+    // Pipeline and spill modes stream the input - nothing to read here
+  } else if (!opts.trace_file.empty()) {
+    if (!mapped_trace.open(opts.trace_file)) {
+      std::cerr << "Error: cannot open trace file: " << opts.trace_file << "\n";
+      return 1;
+    }
+    input_data = mapped_trace.data();
+    input_size = mapped_trace.size();
+  } else {
+    input_buf = BulkReader::read_all();
+    input_data = input_buf.data();
+    input_size = input_buf.size();
+  }
+
+  // Compressed traces: detect the zstd frame magic and inflate before any
+  // format sniffing, so compression stacks with both text and binary traces
+  if (input_data != nullptr && is_zstd_trace(input_data, input_size)) {
+    std::string inflated;
+    if (!zstd_inflate(input_data, input_size, inflated)) {
+#ifdef CACHE_EXPLORER_HAVE_ZSTD
+      std::cerr << "Error: corrupt zstd-compressed trace\n";
+#else
+      std::cerr << "Error: zstd-compressed trace, but cache-sim was built "
+                   "without libzstd\n";
+#endif
+      return 1;
+    }
+    mapped_trace.close();
+    input_buf = std::move(inflated);
+    input_data = input_buf.data();
+    input_size = input_buf.size();
+  }
+
+  // Content-addressed result cache: identical trace bytes plus identical
+  // effective configuration always produce identical output, so a repeat
+  // run replays the stored JSON without parsing or simulating. Whole-
+  // document JSON runs only - streaming/pipeline output is incremental,
+  // and --diff/--restore depend on files outside the trace.
+  ResultCache result_cache;
+  ResultCaptureGuard capture;
+  if (!opts.no_cache && json_output && !stream_mode && !opts.pipeline_mode &&
+      !opts.spill_mode && !flamegraph_output && opts.diff_file.empty() &&
+      opts.restore_file.empty() && opts.incremental_baseline.empty() &&
+      opts.checkpoint_every == 0 && !replay_mode &&
+      result_cache.usable()) {
+    uint64_t key = ResultCache::hash_bytes(input_data, input_size);
+    key = ResultCache::hash_string(opts.cache_fingerprint, key);
+    if (auto cached = result_cache.lookup(key)) {
+      std::cout << *cached << std::flush;
+      return 0;
+    }
+    capture.activate(result_cache, key);
+  }
+
+  self_prof.set_bytes_read(input_size);
+  self_prof.enter(ProfileStage::Parse);
 
   // Parse trace events from buffer
-  events.reserve(input_buf.size() / 40); // ~40 chars per line estimate
-  for_each_line(input_buf, [&](const char *begin, const char *end) {
-    auto event = parse_trace_event_fast(begin, end);
-    if (event) {
-      threads.insert(event->thread_id);
-      events.push_back(std::move(*event));
+  // Binary traces are fixed-width records - no hex/decimal re-parsing
+  TraceSpill spill;
+  if (opts.pipeline_mode) {
+    // Events arrive in batches during simulation instead
+  } else if (opts.spill_mode) {
+    // Bounded-memory parse pass: stream the input through the pipeline's
+    // chunked reader, spilling each parsed batch to disk and keeping only
+    // the thread set in memory. Simulation streams the spill file back.
+    if (!spill.open(opts.spill_dir)) {
+      std::cerr << "Error: cannot create spill file"
+                << (opts.spill_dir.empty() ? "" : " in " + opts.spill_dir)
+                << "\n";
+      return 1;
     }
-  });
+    TracePipeline parse_pass;
+    if (!parse_pass.start(opts.trace_file)) {
+      std::cerr << "Error: cannot open trace file: " << opts.trace_file << "\n";
+      return 1;
+    }
+    while (auto batch = parse_pass.next_batch()) {
+      if (filter.active())
+        filter.compact(*batch);
+      for (const auto &event : *batch)
+        if (!event.is_sample_rate)  // W records carry no thread
+          threads.insert(event.thread_id);
+      if (!spill.append(batch->data(), batch->size())) {
+        std::cerr << "Error: spill write failed (disk full?)\n";
+        return 1;
+      }
+      parse_pass.recycle(std::move(*batch));
+    }
+  } else if (replay_mode) {
+    // Seek-and-slice parse: load the sidecar, pick the newest
+    // --checkpoint-keep snapshot at or before the window, and parse only
+    // the bytes between that snapshot's mark and the window's end
+    if (opts.binary_input || is_binary_trace(input_data, input_size)) {
+      std::cerr << "Error: --replay-range works on text traces\n";
+      return 1;
+    }
+    std::string index_path = opts.index_file.empty()
+                                 ? opts.trace_file + ".cxi"
+                                 : opts.index_file;
+    std::ifstream idx_in(index_path, std::ios::binary);
+    TraceIndex index;
+    try {
+      if (!idx_in)
+        throw std::runtime_error("cannot open trace index " + index_path +
+                                 " (build one with: trace-tool index " +
+                                 opts.trace_file + ")");
+      index = TraceIndex::load(idx_in);
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      return 1;
+    }
+    if (replay_lo >= index.total_events) {
+      std::cerr << "Error: --replay-range starts past the end of the trace ("
+                << index.total_events << " events)\n";
+      return 1;
+    }
+    const size_t window_hi =
+        std::min<size_t>(replay_hi, index.total_events);
+
+    // Newest snapshot at or before the window start; without one the
+    // replay warms the hierarchy from the top of the trace instead
+    IncrementalPlan plan = plan_incremental(replay_lo, opts.checkpoint_file);
+    replay_base = plan.resume_offset;
+    replay_checkpoint = plan.checkpoint_path;
+
+    const TraceIndexMark *mark = index.mark_at_or_before(replay_base);
+    if (mark == nullptr) {
+      std::cerr << "Error: trace index has no marks\n";
+      return 1;
+    }
+
+    // Re-apply the id/function/region registrations the seek jumps over
+    for (uint64_t reg : index.registrations) {
+      if (reg >= mark->byte_offset)
+        break;
+      const char *begin = input_data + reg;
+      const char *nl = static_cast<const char *>(
+          memchr(begin, '\n', input_size - reg));
+      parse_trace_event_fast(begin, nl ? nl : input_data + input_size);
+    }
+
+    // Parse from the mark, keeping [replay_base, window_hi) and stopping
+    // at the window's end - the bytes past it are never touched
+    events.reserve(window_hi - replay_base);
+    uint64_t record = mark->event_index;
+    for_each_line_from(
+        input_data, input_size, mark->byte_offset,
+        [&](const char *begin, const char *end) {
+          auto event = parse_trace_event_fast(begin, end);
+          if (!event)
+            return true;
+          uint64_t i = record++;
+          if (i >= window_hi)
+            return false;
+          if (i < replay_base) {
+            // Sample-rate records are positional; the last one before the
+            // window still governs it, so skipped W records warm through
+            if (event->is_sample_rate) {
+              events.push_back(std::move(*event));
+              replay_warm++;
+            }
+            return true;
+          }
+          if (!event->is_sample_rate)
+            threads.insert(event->thread_id);
+          events.push_back(std::move(*event));
+          return true;
+        });
+    replay_warm += replay_lo - replay_base;
+
+    std::cerr << "Replay: events [" << replay_lo << ", " << window_hi
+              << ") of " << index.total_events << ", ";
+    if (replay_checkpoint.empty()) {
+      std::cerr << "no usable snapshot - warming " << replay_warm
+                << " events from the top\n";
+    } else {
+      std::cerr << "resuming from " << replay_checkpoint << " (warming "
+                << replay_warm << " events)\n";
+    }
+  } else if (opts.binary_input || is_binary_trace(input_data, input_size)) {
+    events.reserve(input_size / (BINARY_EVENT_RECORD_SIZE + 1));
+    parse_binary_trace(input_data, input_size, [&](TraceEvent event) {
+      if (filter.active() && !filter.admit(event))
+        return;
+      threads.insert(event.thread_id);
+      events.push_back(std::move(event));
+    });
+  } else if (opts.parallel_parsing) {
+    events = ParallelTraceParser::parse(input_data, input_size,
+                                        opts.parallel_threads);
+    // Worker threads can't share the stateful filter; compact afterwards
+    if (filter.active())
+      filter.compact(events);
+    for (const auto &event : events) {
+      if (!event.is_sample_rate)  // W records carry no thread
+        threads.insert(event.thread_id);
+    }
+  } else {
+    events.reserve(input_size / 40); // ~40 chars per line estimate
+    for_each_line(input_data, input_size, [&](const char *begin, const char *end) {
+      auto event = parse_trace_event_fast(begin, end);
+      if (event) {
+        if (filter.active() && !filter.admit(*event))
+          return;
+        if (!event->is_sample_rate)  // W records carry no thread
+          threads.insert(event->thread_id);
+        events.push_back(std::move(*event));
+      }
+    });
+  }
+
+  if (verbose && filter.active() && !opts.pipeline_mode) {
+    std::cerr << "Filtered out " << filter.excluded() << " events\n";
+  }
+
+  // Timestamped traces (runtime CACHE_EXPLORER_TIMESTAMPS=1) arrive as
+  // per-thread drain bursts; merge them into capture order so the MESI
+  // and false-sharing analysis sees the true interleaving. stable_sort
+  // preserves program order within a thread, whose stamps are monotonic.
+  bool have_timestamps = false;
+  for (const auto &event : events) {
+    if (event.timestamp != 0) {
+      have_timestamps = true;
+      break;
+    }
+  }
+  if (have_timestamps) {
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TraceEvent &a, const TraceEvent &b) {
+                       return a.timestamp < b.timestamp;
+                     });
+  }
 
-  // Release input buffer - no longer needed
+  // Release input buffer/mapping - no longer needed
+  mapped_trace.close();
   input_buf.clear();
   input_buf.shrink_to_fit();
 
-  bool multicore = threads.size() > 1;
+  self_prof.set_events(events.size());
+  self_prof.enter(ProfileStage::Simulate);
+
+  // Multi-preset batch: replay the parsed events through one processor per
+  // preset - parsing was the shared cost and it is already paid
+  if (!opts.config_list.empty())
+    return run_multi_config(opts, events, threads.size());
+
+  // Pipeline mode can't know the thread count up front, so it uses the
+  // multi-core processor which handles single-threaded traces transparently
+  // (same approach as stream mode)
+  bool multicore = opts.pipeline_mode || threads.size() > 1;
+  if (replay_mode && (multicore || num_cores > 1)) {
+    // Checkpoints and their series are single-core batch state
+    std::cerr << "Error: --replay-range is single-core only (the window "
+                 "holds " << threads.size() << " threads)\n";
+    return 1;
+  }
   if (num_cores == 0) {
-    num_cores = multicore ? std::min((int)threads.size(), 8) : 1;
+    num_cores = multicore ? std::max(1, std::min((int)threads.size(), 8)) : 1;
+    if (opts.pipeline_mode)
+      num_cores = 8;
+  }
+
+  // Reuse-distance analysis is hierarchy-independent: one pass over the
+  // trace yields the miss-ratio curve for every cache size at once
+  ReuseDistanceAnalyzer mrc_analyzer;
+  if (opts.mrc && !opts.pipeline_mode) {
+    for (const auto &event : events)
+      mrc_feed_event(mrc_analyzer, event, cfg.l1_data.line_size);
   }
 
+  // Belady OPT replay needs the whole trace, so it's batch-mode only
+  OptResult opt;
+  if (opts.opt_analysis && !opts.pipeline_mode)
+    opt = run_opt_analysis(events, cfg);
+
   if (multicore) {
     // Multi-core mode with coherence and false sharing detection
     MultiCoreTraceProcessor processor(num_cores, cfg.l1_data, cfg.l2, cfg.l3,
-                                       prefetch_policy, prefetch_degree);
+                                       prefetch_policy, prefetch_degree,
+                                       opts.coherence_mode,
+                                       cfg.coherence_protocol);
+    if (opts.parallel_sim) {
+      size_t sim_threads = opts.parallel_sim_threads
+                               ? opts.parallel_sim_threads
+                               : std::thread::hardware_concurrency();
+      processor.set_parallel_simulation(sim_threads);
+    }
+    if (opts.virtual_time) {
+      processor.enable_virtual_time(cfg.latency);
+    }
     if (fast_mode) {
       processor.set_fast_mode(true);
+    } else {
+      processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+    }
+    if (!opts.coherence_memo) {
+      processor.set_coherence_memo(false);
+    }
+    if (opts.sample_sets > 1) {
+      processor.set_set_sampling(opts.sample_sets);
+    }
+    if (opts.hot_line_budget) {
+      processor.set_hot_line_budget(opts.hot_line_budget);
+    }
+    if (opts.huge_page_size) {
+      processor.set_page_size(opts.huge_page_size);
+    }
+    if (opts.prefetch_throttle) {
+      processor.enable_prefetch_throttling();
+    }
+    if (cfg.cores_per_ccx > 0) {
+      processor.enable_ccx_topology(cfg.cores_per_ccx);
+    }
+    if (opts.numa_sockets > 1) {
+      processor.enable_numa(opts.numa_sockets,
+                            opts.numa_interleave ? NumaPlacement::Interleave
+                                                 : NumaPlacement::FirstTouch);
+    }
+    if (!configure_thread_placement(processor, opts)) {
+      return 1;
     }
 
     if (verbose && !json_output) {
-      processor.set_event_callback([](const EventResult &r) {
-        std::cout << (r.l1_hit ? "L1_HIT" : r.l2_hit ? "L2_HIT" : r.l3_hit ? "L3_HIT" : "MISS")
-                  << " 0x" << std::hex << r.address << std::dec;
-        if (!r.file.empty())
-          std::cout << " " << r.file << ":" << r.line;
-        std::cout << "\n";
-      });
+      processor.set_event_hook(
+          [](void *, const EventResult &r) {
+            std::cout << (r.l1_hit ? "L1_HIT" : r.l2_hit ? "L2_HIT" : r.l3_hit ? "L3_HIT" : "MISS")
+                      << " 0x" << std::hex << r.address << std::dec;
+            if (!r.file.empty())
+              std::cout << " " << r.file << ":" << r.line;
+            std::cout << "\n";
+          },
+          nullptr);
     }
 
-    // Process events
-    progress_init(events.size());
-    for (size_t i = 0; i < events.size(); i++) {
-      processor.process(events[i]);
-      progress_update(i);
+    // Periodic stats snapshots on stderr (--stream-stats): level deltas
+    // since the last snapshot plus the top hot lines so far, so the UI
+    // has feedback and a phase time-series during long runs
+    size_t since_stream = 0;
+    CacheStats prev_l1d, prev_l2, prev_l3;
+    auto maybe_stream_stats = [&](uint64_t events_done, size_t n) {
+      if (opts.stream_stats_every == 0)
+        return;
+      since_stream += n;
+      if (since_stream < opts.stream_stats_every)
+        return;
+      auto s = processor.get_stats();
+      CacheStats l1_total;
+      for (const auto &l1 : s.l1_per_core)
+        l1_total += l1;
+      std::vector<JsonOutput::HotLineBrief> brief;
+      for (const auto &h : processor.get_hot_lines(3))
+        brief.push_back({h.file, h.line, h.misses});
+      JsonOutput::write_stats_snapshot(std::cerr, events_done,
+                                       snapshot_delta(l1_total, prev_l1d),
+                                       snapshot_delta(s.l2, prev_l2),
+                                       snapshot_delta(s.l3, prev_l3), brief);
+      prev_l1d = l1_total;
+      prev_l2 = s.l2;
+      prev_l3 = s.l3;
+      since_stream = 0;
+    };
+
+    // Per-interval time-series (--intervals): snapshot the cumulative
+    // accumulators every n events; IntervalSeries stores the deltas
+    size_t since_interval = 0;
+    IntervalSeries intervals(opts.interval_events);
+    auto maybe_record_interval = [&](uint64_t events_done, size_t n,
+                                     bool final_flush) {
+      if (opts.interval_events == 0)
+        return;
+      since_interval += n;
+      if (since_interval < opts.interval_events && !final_flush)
+        return;
+      if (since_interval == 0)
+        return;
+      auto s = processor.get_stats();
+      CacheStats l1_total;
+      for (const auto &l1 : s.l1_per_core)
+        l1_total += l1;
+      PrefetchStats pf_total;
+      for (const auto &pf : s.prefetch_per_core) {
+        pf_total.prefetches_issued += pf.prefetches_issued;
+        pf_total.prefetches_useful += pf.prefetches_useful;
+      }
+      intervals.record(events_done, l1_total, s.l2, s.l3,
+                       s.coherence_invalidations, pf_total,
+                       processor.wss_estimate());
+      processor.close_wss_window();
+      since_interval = 0;
+    };
+
+    // Process events. A cancel signal stops the loops between chunks;
+    // event_count then reflects the simulated prefix and the output is
+    // marked partial (pipeline mode never knows the total up front).
+    size_t event_count = events.size();
+    const size_t planned_events =
+        opts.spill_mode ? spill.event_count() : events.size();
+    if (opts.pipeline_mode) {
+      // Consume parsed batches as the producer thread fills them - I/O and
+      // parsing overlap with simulation through the bounded queue
+      TracePipeline pipeline;
+      if (!pipeline.start(opts.trace_file)) {
+        std::cerr << "Error: cannot open trace file: " << opts.trace_file << "\n";
+        return 1;
+      }
+      while (auto batch = pipeline.next_batch()) {
+        if (g_cancel_requested)
+          break;
+        if (filter.active())
+          filter.compact(*batch);
+        for (const auto &event : *batch) {
+          if (!event.is_sample_rate)  // W records carry no thread
+            threads.insert(event.thread_id);
+        }
+        if (opts.mrc) {
+          for (const auto &event : *batch)
+            mrc_feed_event(mrc_analyzer, event, cfg.l1_data.line_size);
+        }
+        processor.process_batch(*batch);
+        event_count += batch->size();
+        maybe_stream_stats(event_count, batch->size());
+        maybe_record_interval(event_count, batch->size(), false);
+        pipeline.recycle(std::move(*batch));
+      }
+    } else if (opts.spill_mode) {
+      // Stream the spilled events back through the simulator in order
+      progress_init(spill.event_count());
+      if (!spill.for_each_batch([&](const TraceEvent *ev, size_t n) {
+            if (g_cancel_requested)
+              return; // Drain the remaining batches without simulating
+            processor.process_batch(ev, n);
+            event_count += n;
+            progress_update(event_count);
+            maybe_stream_stats(event_count, n);
+            maybe_record_interval(event_count, n, false);
+          })) {
+        std::cerr << "Error: spill read failed\n";
+        return 1;
+      }
+      progress_done();
+    } else {
+      progress_init(events.size());
+      for (size_t i = 0; i < events.size(); i += PROCESS_CHUNK) {
+        if (g_cancel_requested) {
+          event_count = i;
+          break;
+        }
+        size_t n = std::min(PROCESS_CHUNK, events.size() - i);
+        processor.process_batch(events.data() + i, n);
+        progress_update(i + n);
+        maybe_stream_stats(i + n, n);
+        maybe_record_interval(i + n, n, false);
+      }
+      progress_done();
     }
-    progress_done();
+    // Close out the final partial interval
+    maybe_record_interval(event_count, 0, true);
 
     auto stats = processor.get_stats();
     auto hot = processor.get_hot_lines(flamegraph_output ? 20 : 10);  // More lines for flamegraph
     auto false_sharing = processor.get_false_sharing_reports();
 
+    // Set-sampled run (--sample-sets): the counters cover 1-in-n sets.
+    // Capture confidence bounds from the sample actually simulated, then
+    // extrapolate every count back to the full hierarchy.
+    double sample_err_l1 = 0.0, sample_err_l2 = 0.0, sample_err_l3 = 0.0;
+    if (opts.sample_sets > 1) {
+      CacheStats l1_sampled;
+      for (const auto &l1 : stats.l1_per_core)
+        l1_sampled += l1;
+      sample_err_l1 = sampling_error_bound(l1_sampled);
+      sample_err_l2 = sampling_error_bound(stats.l2);
+      sample_err_l3 = sampling_error_bound(stats.l3);
+      for (auto &l1 : stats.l1_per_core)
+        l1.scale(opts.sample_sets);
+      stats.l2.scale(opts.sample_sets);
+      stats.l3.scale(opts.sample_sets);
+    }
+
+    // Severity model for the false-sharing reports (already sorted worst
+    // first): each invalidation forces the bounced line to be refetched
+    // from the shared level instead of hitting L1. Reports below the
+    // noise floor are suppressed - a handful of invalidations over a long
+    // run is not worth padding a struct for.
+    const int coherence_penalty =
+        cfg.l3.is_valid() ? cfg.latency.l3_hit : cfg.latency.memory;
+    constexpr double FS_NOISE_PER_1K_EVENTS = 0.1;
+    auto fs_rate_per_1k = [&](const FalseSharingReport &fs) {
+      return event_count
+                 ? static_cast<double>(fs.invalidation_count) * 1000.0 / event_count
+                 : 0.0;
+    };
+    false_sharing.erase(
+        std::remove_if(false_sharing.begin(), false_sharing.end(),
+                       [&](const FalseSharingReport &fs) {
+                         return fs_rate_per_1k(fs) < FS_NOISE_PER_1K_EVENTS;
+                       }),
+        false_sharing.end());
+
+    self_prof.enter(ProfileStage::Output);
+
     if (flamegraph_output) {
       output_flamegraph_svg(hot, config_name + " (multi-core)");
       return 0;
     }
 
+    if (!opts.diff_file.empty()) {
+      auto baseline = BaselineResult::load(opts.diff_file);
+      if (!baseline) {
+        std::cerr << "Error: cannot load baseline result: " << opts.diff_file
+                  << "\n";
+        return 1;
+      }
+      CacheStats l1_total;
+      for (const auto &l1 : stats.l1_per_core)
+        l1_total += l1;
+      uint64_t total_cycles = l1_total.hits * cfg.latency.l1_hit +
+                              stats.l2.hits * cfg.latency.l2_hit +
+                              stats.l3.hits * cfg.latency.l3_hit +
+                              stats.l3.misses * cfg.latency.memory;
+      std::vector<BaselineHotLine> current;
+      current.reserve(hot.size());
+      for (const auto &h : hot)
+        current.push_back({std::string(h.file), h.line, h.hits, h.misses});
+      write_result_diff(std::cout, config_name, event_count, l1_total,
+                        stats.l2, stats.l3, total_cycles, current, *baseline);
+      return 0;
+    }
+
     if (json_output) {
       std::cout << "{\n";
       std::cout << "  \"config\": \"" << config_name << "\",\n";
       std::cout << "  \"multicore\": true,\n";
       std::cout << "  \"cores\": " << num_cores << ",\n";
       std::cout << "  \"threads\": " << threads.size() << ",\n";
-      std::cout << "  \"events\": " << events.size() << ",\n";
+      if (opts.sample_sets > 1) {
+        std::cout << "  \"setSampling\": {\"factor\": " << opts.sample_sets
+                  << ", \"hitRateError\": {"
+                  << std::fixed << std::setprecision(4)
+                  << "\"l1d\": " << sample_err_l1
+                  << ", \"l2\": " << sample_err_l2
+                  << ", \"l3\": " << sample_err_l3 << "}},\n";
+      }
+      std::cout << "  \"events\": " << event_count << ",\n";
+      if (g_cancel_requested) {
+        std::cout << "  \"partial\": {\"cancelled\": true, "
+                  << "\"eventsProcessed\": " << event_count;
+        if (planned_events >= event_count && planned_events > 0) {
+          std::cout << ", \"eventsTotal\": " << planned_events;
+        }
+        std::cout << "},\n";
+      }
+      if (processor.get_sampling().active()) {
+        const auto &sampling = processor.get_sampling();
+        std::cout << "  \"sampling\": {\"estimatedEvents\": "
+                  << sampling.weighted_events
+                  << ", \"minRate\": " << sampling.min_rate
+                  << ", \"maxRate\": " << sampling.max_rate
+                  << ", \"rateChanges\": " << sampling.rate_changes << "},\n";
+      }
 
       // Aggregate L1 stats
       CacheStats l1_total;
@@ -564,6 +1722,16 @@ int main(int argc, char *argv[]) {
       json_level("l3", stats.l3, true);
       std::cout << "  },\n";
 
+      if (opts.mrc)
+        JsonOutput::write_mrc(std::cout, mrc_analyzer, cfg.l1_data.line_size);
+
+      if (!intervals.empty())
+        JsonOutput::write_intervals(std::cout, intervals, cfg);
+
+      if (opt.ran)
+        JsonOutput::write_opt_comparison(std::cout, cfg, l1_total, stats.l2,
+                                         stats.l3, opt.l1, opt.l2, opt.l3);
+
       // TLB statistics (aggregated from all cores)
       auto tlb_stats = processor.get_cache_system().get_tlb_stats();
       std::cout << "  \"tlb\": {\n";
@@ -572,14 +1740,79 @@ int main(int argc, char *argv[]) {
                 << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.dtlb.hit_rate() << "},\n";
       std::cout << "    \"itlb\": {\"hits\": " << tlb_stats.itlb.hits
                 << ", \"misses\": " << tlb_stats.itlb.misses
-                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.itlb.hit_rate() << "}\n";
+                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.itlb.hit_rate() << "},\n";
+      std::cout << "    \"stlb\": {\"hits\": " << tlb_stats.stlb.hits
+                << ", \"misses\": " << tlb_stats.stlb.misses
+                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.stlb.hit_rate() << "},\n";
+      std::cout << "    \"pageSize\": " << processor.get_cache_system().get_page_size() << "\n";
       std::cout << "  },\n";
 
       std::cout << "  \"coherence\": {\n";
+      std::cout << "    \"protocol\": \""
+                << ArgParser::coherence_protocol_name(cfg.coherence_protocol)
+                << "\",\n";
       std::cout << "    \"invalidations\": " << stats.coherence_invalidations << ",\n";
+      std::cout << "    \"snoopWritebacks\": " << stats.snoop_writebacks << ",\n";
+      std::cout << "    \"dirtyShares\": " << stats.dirty_shares << ",\n";
+      std::cout << "    \"forwards\": " << stats.forwards << ",\n";
       std::cout << "    \"falseSharingEvents\": " << stats.false_sharing_events << "\n";
       std::cout << "  },\n";
 
+      if (opts.numa_sockets > 1) {
+        auto numa = processor.get_numa_stats();
+        uint64_t remote_penalty =
+            numa.remote_accesses *
+            static_cast<uint64_t>(cfg.latency.remote_memory - cfg.latency.memory);
+        std::cout << "  \"numa\": {\n";
+        std::cout << "    \"sockets\": " << numa.sockets << ",\n";
+        std::cout << "    \"placement\": \""
+                  << (opts.numa_interleave ? "interleave" : "first-touch") << "\",\n";
+        std::cout << "    \"localAccesses\": " << numa.local_accesses << ",\n";
+        std::cout << "    \"remoteAccesses\": " << numa.remote_accesses << ",\n";
+        std::cout << "    \"remoteRatio\": " << std::fixed << std::setprecision(3)
+                  << numa.remote_ratio() << ",\n";
+        std::cout << "    \"remotePenaltyCycles\": " << remote_penalty << ",\n";
+        auto numa_hot = processor.get_numa_hot_lines(10);
+        std::cout << "    \"hotLines\": [\n";
+        for (size_t i = 0; i < numa_hot.size(); i++) {
+          const auto &h = numa_hot[i];
+          std::cout << "      {\"file\": \"" << JsonOutput::escape(h.file) << "\", "
+                    << "\"line\": " << h.line << ", "
+                    << "\"local\": " << h.local << ", "
+                    << "\"remote\": " << h.remote << ", "
+                    << "\"remoteRatio\": " << std::fixed << std::setprecision(3)
+                    << h.remote_ratio() << "}"
+                    << (i + 1 < numa_hot.size() ? ",\n" : "\n");
+        }
+        std::cout << "    ]\n";
+        std::cout << "  },\n";
+      }
+
+      if (!opts.placement.empty() || !opts.placement_file.empty()) {
+        std::vector<std::pair<uint32_t, int>> tmap(
+            processor.get_thread_map().begin(),
+            processor.get_thread_map().end());
+        std::sort(tmap.begin(), tmap.end());
+        std::cout << "  \"placement\": {\n";
+        std::cout << "    \"policy\": \""
+                  << (opts.placement.empty() ? "scatter" : opts.placement)
+                  << "\",\n";
+        std::cout << "    \"threads\": [\n";
+        for (size_t i = 0; i < tmap.size(); i++) {
+          std::cout << "      {\"thread\": " << tmap[i].first
+                    << ", \"core\": " << tmap[i].second << "}"
+                    << (i + 1 < tmap.size() ? ",\n" : "\n");
+        }
+        std::cout << "    ],\n";
+        std::cout << "    \"coreAccesses\": [";
+        for (size_t c = 0; c < stats.l1_per_core.size(); c++) {
+          std::cout << stats.l1_per_core[c].total_accesses()
+                    << (c + 1 < stats.l1_per_core.size() ? ", " : "");
+        }
+        std::cout << "]\n";
+        std::cout << "  },\n";
+      }
+
       std::cout << "  \"hotLines\": [\n";
       for (size_t i = 0; i < hot.size(); i++) {
         const auto &h = hot[i];
@@ -593,11 +1826,32 @@ int main(int argc, char *argv[]) {
       }
       std::cout << "  ],\n";
 
+      // Per-function rollup (only when the trace carried G records)
+      auto hot_funcs = processor.get_hot_functions(10);
+      if (!hot_funcs.empty()) {
+        std::cout << "  \"hotFunctions\": [\n";
+        for (size_t i = 0; i < hot_funcs.size(); i++) {
+          const auto &f = hot_funcs[i];
+          std::cout << "    {\"function\": \"" << JsonOutput::escape(f.function) << "\", "
+                    << "\"hits\": " << f.hits << ", "
+                    << "\"misses\": " << f.misses << ", "
+                    << "\"missRate\": " << std::fixed << std::setprecision(3) << f.miss_rate() << ", "
+                    << "\"lines\": " << f.lines << "}"
+                    << (i + 1 < hot_funcs.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ],\n";
+      }
+
       std::cout << "  \"falseSharing\": [\n";
       for (size_t i = 0; i < false_sharing.size(); i++) {
         const auto &fs = false_sharing[i];
         std::cout << "    {\"cacheLineAddr\": \"0x" << std::hex << fs.cache_line_addr << std::dec << "\", "
                   << "\"accessCount\": " << fs.accesses.size() << ", "
+                  << "\"invalidations\": " << fs.invalidation_count << ", "
+                  << "\"perKEvents\": " << std::fixed << std::setprecision(3)
+                  << fs_rate_per_1k(fs) << std::defaultfloat << ", "
+                  << "\"cyclesLost\": "
+                  << fs.invalidation_count * (uint64_t)coherence_penalty << ", "
                   << "\"accesses\": [";
 
         // Group accesses by thread for cleaner output
@@ -625,6 +1879,29 @@ int main(int argc, char *argv[]) {
       }
       std::cout << "  ],\n";
 
+      // Contended atomics: locks/counters ping-ponging between threads
+      // or spinning in cmpxchg retry loops
+      auto contended = processor.get_contended_atomics(10);
+      if (!contended.empty()) {
+        std::cout << "  \"atomicContention\": [\n";
+        for (size_t i = 0; i < contended.size(); i++) {
+          const auto &c = contended[i];
+          std::cout << "    {\"address\": \"0x" << std::hex << c.address
+                    << std::dec << "\", "
+                    << "\"loads\": " << c.loads << ", "
+                    << "\"stores\": " << c.stores << ", "
+                    << "\"rmw\": " << c.rmws << ", "
+                    << "\"cmpxchg\": " << c.cmpxchgs << ", "
+                    << "\"threads\": " << c.threads << ", "
+                    << "\"pingPongs\": " << c.ping_pongs << ", "
+                    << "\"retries\": " << c.retries << ", "
+                    << "\"file\": \"" << JsonOutput::escape(c.file) << "\", "
+                    << "\"line\": " << c.line << "}"
+                    << (i + 1 < contended.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ],\n";
+      }
+
       // Generate optimization suggestions
       auto suggestions = OptimizationSuggester::analyze(
           false_sharing, hot, stats, cfg.l1_data.line_size);
@@ -680,19 +1957,31 @@ int main(int argc, char *argv[]) {
                   << "    \"degree\": " << prefetch_degree << ",\n"
                   << "    \"issued\": " << total_pf.prefetches_issued << ",\n"
                   << "    \"useful\": " << total_pf.prefetches_useful << ",\n"
-                  << "    \"accuracy\": " << std::fixed << std::setprecision(3) << total_pf.accuracy() << "\n"
-                  << "  }";
+                  << "    \"accuracy\": " << std::fixed << std::setprecision(3) << total_pf.accuracy();
+        if (opts.prefetch_throttle) {
+          const auto &cs = processor.get_cache_system();
+          std::cout << ",\n    \"throttle\": {\"perCore\": [";
+          for (int c = 0; c < cs.get_num_cores(); c++) {
+            if (c) std::cout << ", ";
+            JsonOutput::write_throttle(std::cout, cs.get_prefetcher(c));
+          }
+          std::cout << "]}";
+        }
+        std::cout << "\n  }";
       }
 
       // Advanced instrumentation stats
       {
         auto sw_pf = processor.get_software_prefetch_stats();
         auto vec = processor.get_vector_stats();
+        auto gs = processor.get_gather_scatter_stats();
         auto atomic = processor.get_atomic_stats();
         auto mem = processor.get_memory_intrinsic_stats();
 
         bool has_advanced = sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 ||
+                            gs.gathers > 0 || gs.scatters > 0 ||
                             atomic.load_count > 0 || atomic.store_count > 0 ||
+                            atomic.rmw_count > 0 || atomic.cmpxchg_count > 0 ||
                             mem.memcpy_count > 0 || mem.memset_count > 0;
         if (has_advanced) {
           std::cout << ",\n  \"advancedStats\": {\n";
@@ -712,12 +2001,23 @@ int main(int argc, char *argv[]) {
                       << ", \"crossLineAccesses\": " << vec.cross_line_accesses << "}";
             need_comma = true;
           }
+          if (gs.gathers > 0 || gs.scatters > 0) {
+            if (need_comma) std::cout << ",\n";
+            std::cout << "    \"gather\": {\"gathers\": " << gs.gathers
+                      << ", \"scatters\": " << gs.scatters
+                      << ", \"lanes\": " << gs.lanes
+                      << ", \"bytes\": " << gs.bytes
+                      << ", \"linesTouched\": " << gs.lines_touched
+                      << ", \"avgLinesPerOp\": " << std::fixed << std::setprecision(3) << gs.avg_lines_per_op() << "}";
+            need_comma = true;
+          }
           if (atomic.load_count > 0 || atomic.store_count > 0 || atomic.rmw_count > 0 || atomic.cmpxchg_count > 0) {
             if (need_comma) std::cout << ",\n";
             std::cout << "    \"atomic\": {\"loads\": " << atomic.load_count
                       << ", \"stores\": " << atomic.store_count
                       << ", \"rmw\": " << atomic.rmw_count
-                      << ", \"cmpxchg\": " << atomic.cmpxchg_count << "}";
+                      << ", \"cmpxchg\": " << atomic.cmpxchg_count
+                      << ", \"contentionEvents\": " << atomic.contention_events << "}";
             need_comma = true;
           }
           if (mem.memcpy_count > 0 || mem.memset_count > 0 || mem.memmove_count > 0) {
@@ -733,6 +2033,14 @@ int main(int argc, char *argv[]) {
         }
       }
 
+      // 3C classifier health (Bloom filter false-positive bound)
+      if (!fast_mode) {
+        auto cls = processor.get_classifier_summary();
+        std::cout << ",\n  \"missClassifier\": {\"fpRate\": " << std::setprecision(6) << cls.fp_rate
+                  << ", \"estimatedFpRate\": " << cls.estimated_fp_rate
+                  << ", \"memoryBytes\": " << cls.memory_bytes << "}" << std::setprecision(3);
+      }
+
       // Output L1 cache state for visualization
       std::cout << ",\n  \"cacheState\": {\"l1d\": [";
       const auto& cache_sys = processor.get_cache_system();
@@ -749,7 +2057,28 @@ int main(int argc, char *argv[]) {
       std::cout << "\n=== Multi-Core Cache Simulation ===\n";
       std::cout << "Config: " << config_name << "\n";
       std::cout << "Cores: " << num_cores << ", Threads: " << threads.size() << "\n";
-      std::cout << "Events: " << events.size() << "\n\n";
+      std::cout << "Events: " << event_count << "\n";
+      if (g_cancel_requested) {
+        std::cout << "PARTIAL RESULT: run cancelled after " << event_count;
+        if (planned_events >= event_count && planned_events > 0)
+          std::cout << " of " << planned_events;
+        std::cout << " events\n";
+      }
+      if (processor.get_sampling().active()) {
+        const auto &sampling = processor.get_sampling();
+        std::cout << "Sampling: 1/" << sampling.min_rate;
+        if (sampling.max_rate != sampling.min_rate)
+          std::cout << " to 1/" << sampling.max_rate << " (adaptive)";
+        std::cout << " of accesses captured, ~" << sampling.weighted_events
+                  << " estimated\n";
+      }
+      if (opts.sample_sets > 1) {
+        std::cout << "Set sampling: 1/" << opts.sample_sets
+                  << " sets simulated, counts extrapolated (L1 hit rate "
+                  << std::fixed << std::setprecision(2)
+                  << "+/-" << (sample_err_l1 * 100) << "%)\n";
+      }
+      std::cout << "\n";
 
       CacheStats l1_total;
       for (const auto &l1 : stats.l1_per_core) {
@@ -775,12 +2104,69 @@ int main(int argc, char *argv[]) {
       print_level("L3", stats.l3);
 
       std::cout << "\n=== Coherence ===\n";
+      std::cout << "Protocol: "
+                << (cfg.coherence_protocol == CoherenceProtocol::MOESI ? "MOESI"
+                    : cfg.coherence_protocol == CoherenceProtocol::MESIF
+                        ? "MESIF"
+                        : "MESI")
+                << "\n";
       std::cout << "Invalidations: " << stats.coherence_invalidations << "\n";
+      if (cfg.coherence_protocol == CoherenceProtocol::MOESI) {
+        std::cout << "Dirty shares (writebacks avoided): " << stats.dirty_shares
+                  << "\n";
+      } else {
+        std::cout << "Snoop writebacks: " << stats.snoop_writebacks << "\n";
+      }
+      if (cfg.coherence_protocol == CoherenceProtocol::MESIF)
+        std::cout << "Forwarded clean lines: " << stats.forwards << "\n";
+
+      if (opts.numa_sockets > 1) {
+        auto numa = processor.get_numa_stats();
+        std::cout << "\n=== NUMA ===\n";
+        std::cout << "Sockets: " << numa.sockets
+                  << " (" << (opts.numa_interleave ? "interleave" : "first-touch")
+                  << " placement)\n";
+        std::cout << "Local DRAM accesses:  " << numa.local_accesses << "\n";
+        std::cout << "Remote DRAM accesses: " << numa.remote_accesses
+                  << " (" << std::fixed << std::setprecision(1)
+                  << (numa.remote_ratio() * 100) << "%)\n";
+        for (const auto &h : processor.get_numa_hot_lines(5)) {
+          if (h.remote == 0) continue;
+          std::cout << "  " << h.file << ":" << h.line
+                    << " - " << h.remote << " remote / " << h.local << " local\n";
+        }
+      }
+
+      if (!opts.placement.empty() || !opts.placement_file.empty()) {
+        std::vector<std::pair<uint32_t, int>> tmap(
+            processor.get_thread_map().begin(),
+            processor.get_thread_map().end());
+        std::sort(tmap.begin(), tmap.end());
+        std::cout << "\n=== Thread Placement ===\n";
+        std::cout << "Policy: "
+                  << (opts.placement.empty() ? "scatter" : opts.placement)
+                  << "\n";
+        for (const auto &[thread, core] : tmap) {
+          std::cout << "  T" << thread << " -> core " << core << "\n";
+        }
+        std::cout << "Per-core accesses:";
+        for (size_t c = 0; c < stats.l1_per_core.size(); c++) {
+          std::cout << " c" << c << "="
+                    << stats.l1_per_core[c].total_accesses();
+        }
+        std::cout << "\n";
+      }
 
       if (!false_sharing.empty()) {
         std::cout << "\n=== FALSE SHARING DETECTED ===\n";
         for (const auto &fs : false_sharing) {
           std::cout << "Cache line 0x" << std::hex << fs.cache_line_addr << std::dec << ":\n";
+          std::cout << "  Severity: " << fs.invalidation_count
+                    << " invalidations (" << std::fixed << std::setprecision(2)
+                    << fs_rate_per_1k(fs) << std::defaultfloat
+                    << " per 1K events), ~"
+                    << fs.invalidation_count * (uint64_t)coherence_penalty
+                    << " cycles lost\n";
           std::unordered_set<uint32_t> threads_involved;
           for (const auto &a : fs.accesses) {
             threads_involved.insert(a.thread_id);
@@ -812,6 +2198,20 @@ int main(int argc, char *argv[]) {
         }
       }
 
+      auto contended = processor.get_contended_atomics(10);
+      if (!contended.empty()) {
+        std::cout << "\n=== Atomic Contention ===\n";
+        for (const auto &c : contended) {
+          std::cout << "0x" << std::hex << c.address << std::dec << " - "
+                    << c.total() << " ops, " << c.threads << " thread(s), "
+                    << c.ping_pongs << " ping-pong(s), "
+                    << c.retries << " retry(ies)";
+          if (!c.file.empty())
+            std::cout << " (" << c.file << ":" << c.line << ")";
+          std::cout << "\n";
+        }
+      }
+
       if (!hot.empty()) {
         std::cout << "\n=== Hottest Lines ===\n";
         for (const auto &s : hot) {
@@ -820,47 +2220,355 @@ int main(int argc, char *argv[]) {
                     << s.threads.size() << " thread(s)\n";
         }
       }
+
+      auto hot_funcs = processor.get_hot_functions(10);
+      if (!hot_funcs.empty()) {
+        std::cout << "\n=== Hottest Functions ===\n";
+        for (const auto &f : hot_funcs) {
+          std::cout << f.function << " - " << f.misses << " misses over "
+                    << f.lines << " line(s)\n";
+        }
+      }
     }
   } else {
     // Single-core mode (original behavior)
-    TraceProcessor processor(cfg);
+    TraceProcessor &processor = acquire_processor(opts);
     if (fast_mode) {
       processor.set_fast_mode(true);
+    } else {
+      processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+    }
+    if (opts.sample_sets > 1) {
+      processor.set_set_sampling(opts.sample_sets);
+    }
+    if (opts.cache_segments) {
+      processor.enable_segment_caching();
+    }
+    if (opts.tlb_walk_injection) {
+      processor.set_walk_injection(true);
+    }
+    if (opts.huge_page_size) {
+      processor.set_page_size(opts.huge_page_size);
+    }
+    if (opts.page_alloc != PageAllocPolicy::None) {
+      processor.set_page_allocation(opts.page_alloc, opts.page_alloc_seed);
+    }
+    if (opts.victim_cache_entries > 0) {
+      processor.enable_victim_cache(opts.victim_cache_entries);
+    }
+    if (opts.compress_l3) {
+      processor.enable_l3_compression({.enabled = true});
+    }
+    if (opts.remap_analysis) {
+      processor.enable_remap_analysis();
+    }
+    if (!opts.bulk_sweep) {
+      processor.set_bulk_intrinsics(false);
     }
     if (prefetch_policy != PrefetchPolicy::NONE) {
       processor.enable_prefetching(prefetch_policy, prefetch_degree);
+      if (opts.prefetch_throttle) {
+        processor.enable_prefetch_throttling();
+      }
     }
 
     if (verbose && !json_output) {
-      processor.set_event_callback([](const EventResult &r) {
-        std::cout << (r.l1_hit ? "L1_HIT" : r.l2_hit ? "L2_HIT" : r.l3_hit ? "L3_HIT" : "MISS")
-                  << " 0x" << std::hex << r.address << std::dec;
-        if (!r.file.empty())
-          std::cout << " " << r.file << ":" << r.line;
-        std::cout << "\n";
-      });
+      processor.set_event_hook(
+          [](void *, const EventResult &r) {
+            std::cout << (r.l1_hit ? "L1_HIT" : r.l2_hit ? "L2_HIT" : r.l3_hit ? "L3_HIT" : "MISS")
+                      << " 0x" << std::hex << r.address << std::dec;
+            if (!r.file.empty())
+              std::cout << " " << r.file << ":" << r.line;
+            std::cout << "\n";
+          },
+          nullptr);
     }
 
-    // Process events
-    progress_init(events.size());
-    for (size_t i = 0; i < events.size(); i++) {
-      processor.process(events[i]);
-      progress_update(i);
+    // Process events. With --simpoint only the representative intervals
+    // are simulated; the detailed stats below then cover that subset and
+    // the extrapolated full-trace estimates land in the simpoint block.
+    SimPointResult simpoint;
+    IncrementalPlan inc_plan;
+    IntervalSeries intervals(opts.interval_events);
+    const size_t total_events =
+        opts.spill_mode ? spill.event_count() : events.size();
+    // Events actually simulated - falls short of total_events only when a
+    // cancel signal stopped the loops, and the output then says so
+    size_t events_done = total_events;
+    if (opts.simpoint_interval > 0) {
+      progress_init(events.size());
+      simpoint = run_simpoint(processor, events, opts.simpoint_interval,
+                              opts.simpoint_clusters);
+      progress_done();
+    } else {
+      // Incremental comparison re-run: align against the baseline trace
+      // and resume from its checkpoint series at the first divergence
+      if (!opts.incremental_baseline.empty() && !opts.spill_mode) {
+        MappedFile base_trace;
+        if (!base_trace.open(opts.incremental_baseline)) {
+          std::cerr << "Error: cannot open baseline trace: "
+                    << opts.incremental_baseline << "\n";
+          return 1;
+        }
+        std::vector<TraceEvent> base_events;
+        base_events.reserve(base_trace.size() / 40);
+        for_each_line(base_trace.data(), base_trace.size(),
+                      [&](const char *begin, const char *end) {
+                        if (auto ev = parse_trace_event_fast(begin, end))
+                          base_events.push_back(std::move(*ev));
+                      });
+        inc_plan = plan_incremental(common_trace_prefix(base_events, events),
+                                    opts.checkpoint_file);
+        if (!inc_plan.checkpoint_path.empty()) {
+          std::cerr << "Incremental: traces identical through event "
+                    << inc_plan.prefix_events << ", resuming from "
+                    << inc_plan.checkpoint_path << " (skipping "
+                    << inc_plan.resume_offset << " of " << events.size()
+                    << " events)\n";
+        } else {
+          std::cerr << "Incremental: no usable snapshot within the "
+                    << inc_plan.prefix_events
+                    << "-event identical prefix, simulating in full\n";
+        }
+      }
+
+      // Resume from a snapshot: restore the warm hierarchy and skip the
+      // events the checkpointed run already simulated (--restore, or the
+      // snapshot the incremental plan picked)
+      std::string restore_path = !inc_plan.checkpoint_path.empty()
+                                     ? inc_plan.checkpoint_path
+                                     : opts.restore_file;
+      if (replay_mode) {
+        restore_path = replay_checkpoint;
+      }
+      size_t resume_offset = 0;
+      if (!restore_path.empty()) {
+        std::ifstream in(restore_path, std::ios::binary);
+        if (!in) {
+          std::cerr << "Error: cannot open checkpoint " << restore_path << "\n";
+          return 1;
+        }
+        try {
+          resume_offset = processor.load_checkpoint(in);
+        } catch (const std::exception &e) {
+          std::cerr << "Error: restore failed: " << e.what() << "\n";
+          return 1;
+        }
+        if (replay_mode) {
+          // The snapshot's offset is global; the sliced event vector
+          // starts at replay_base, which is exactly where it was taken
+          resume_offset = resume_offset > replay_base
+                              ? resume_offset - replay_base
+                              : 0;
+        }
+        resume_offset = std::min(resume_offset, events.size());
+      }
+
+      progress_init(total_events);
+
+      // Functional warming: fast-forward the first --warmup events
+      // through the stripped-down path, then start counting from a warm
+      // hierarchy. A restore that already covers the warmup skips it.
+      size_t warm_end = std::min(opts.warmup_events, total_events);
+      if (replay_mode) {
+        // Everything between the snapshot and the window start is replayed
+        // for its state only; stats begin at the window
+        warm_end = std::min(replay_warm, total_events);
+      }
+      if (!opts.spill_mode && resume_offset < warm_end) {
+        processor.begin_warmup();
+        for (size_t i = resume_offset; i < warm_end; i += PROCESS_CHUNK) {
+          if (g_cancel_requested) {
+            events_done = i;
+            break;
+          }
+          size_t n = std::min(PROCESS_CHUNK, warm_end - i);
+          processor.process_batch(events.data() + i, n);
+          progress_update(i + n);
+        }
+        processor.finish_warmup();
+        resume_offset = warm_end;
+      }
+
+      size_t since_checkpoint = 0;
+      size_t since_stream = 0;
+      size_t since_interval = 0;
+      CacheStats prev_l1d, prev_l2, prev_l3;
+      // Periodic work shared by the in-memory and spill replay loops
+      auto after_chunk = [&](size_t done, size_t n) {
+        if (opts.interval_events > 0) {
+          since_interval += n;
+          if (since_interval >= opts.interval_events) {
+            auto s = processor.get_stats();
+            intervals.record(done, s.l1d, s.l2, s.l3, 0,
+                             processor.get_prefetch_stats(),
+                             processor.wss_estimate());
+            processor.close_wss_window();
+            since_interval = 0;
+          }
+        }
+        if (opts.stream_stats_every > 0) {
+          since_stream += n;
+          if (since_stream >= opts.stream_stats_every) {
+            auto s = processor.get_stats();
+            std::vector<JsonOutput::HotLineBrief> brief;
+            for (const auto &h : processor.get_hot_lines(3))
+              brief.push_back({h.file, h.line, h.misses});
+            JsonOutput::write_stats_snapshot(std::cerr, done,
+                                             snapshot_delta(s.l1d, prev_l1d),
+                                             snapshot_delta(s.l2, prev_l2),
+                                             snapshot_delta(s.l3, prev_l3),
+                                             brief);
+            prev_l1d = s.l1d;
+            prev_l2 = s.l2;
+            prev_l3 = s.l3;
+            since_stream = 0;
+          }
+        }
+        if (opts.checkpoint_every > 0) {
+          since_checkpoint += n;
+          if (since_checkpoint >= opts.checkpoint_every) {
+            // Buffered segment events aren't in the hierarchy yet
+            processor.flush_segments();
+            // --checkpoint-keep builds the <file>.<offset> series the
+            // incremental engine picks its resume point from
+            std::string path =
+                opts.checkpoint_keep
+                    ? opts.checkpoint_file + "." + std::to_string(done)
+                    : opts.checkpoint_file;
+            if (!write_checkpoint(processor, path, done)) {
+              std::cerr << "Warning: failed to write checkpoint " << path
+                        << "\n";
+            }
+            since_checkpoint = 0;
+          }
+        }
+      };
+      if (opts.spill_mode) {
+        // Stream the spilled events back in order; warmup boundaries can
+        // land mid-batch, so the leading slice is fast-forwarded separately
+        size_t done = 0;
+        bool warming = warm_end > 0;
+        if (warming)
+          processor.begin_warmup();
+        bool spill_ok = spill.for_each_batch([&](const TraceEvent *ev,
+                                                 size_t n) {
+          if (g_cancel_requested)
+            return; // Drain the remaining batches without simulating
+          size_t off = 0;
+          if (warming) {
+            size_t take = std::min(n, warm_end - done);
+            processor.process_batch(ev, take);
+            done += take;
+            off = take;
+            if (done >= warm_end) {
+              processor.finish_warmup();
+              warming = false;
+            }
+          }
+          if (off < n) {
+            processor.process_batch(ev + off, n - off);
+            done += n - off;
+            after_chunk(done, n - off);
+          }
+          progress_update(done);
+        });
+        if (!spill_ok) {
+          std::cerr << "Error: spill read failed\n";
+          return 1;
+        }
+        events_done = done;
+      } else {
+        for (size_t i = resume_offset; i < events.size(); i += PROCESS_CHUNK) {
+          if (g_cancel_requested) {
+            events_done = std::min(events_done, i);
+            break;
+          }
+          size_t n = std::min(PROCESS_CHUNK, events.size() - i);
+          processor.process_batch(events.data() + i, n);
+          progress_update(i + n);
+          after_chunk(i + n, n);
+        }
+      }
+      progress_done();
+      processor.flush_segments();
+      if (opts.interval_events > 0 && since_interval > 0) {
+        // Close out the final partial interval
+        auto s = processor.get_stats();
+        intervals.record(total_events, s.l1d, s.l2, s.l3, 0,
+                         processor.get_prefetch_stats(),
+                         processor.wss_estimate());
+        processor.close_wss_window();
+      }
     }
-    progress_done();
 
     auto stats = processor.get_stats();
     auto hot = processor.get_hot_lines(20);  // Get more for flamegraph
 
+    // Set-sampled run (--sample-sets): capture confidence bounds from the
+    // sample actually simulated, then extrapolate the whole hierarchy
+    double sample_err_l1 = 0.0, sample_err_l2 = 0.0, sample_err_l3 = 0.0;
+    if (opts.sample_sets > 1) {
+      sample_err_l1 = sampling_error_bound(stats.l1d);
+      sample_err_l2 = sampling_error_bound(stats.l2);
+      sample_err_l3 = sampling_error_bound(stats.l3);
+      stats.scale(opts.sample_sets);
+    }
+
+    self_prof.enter(ProfileStage::Output);
+
     if (flamegraph_output) {
       output_flamegraph_svg(hot, config_name);
       return 0;
     }
 
+    if (!opts.diff_file.empty()) {
+      auto baseline = BaselineResult::load(opts.diff_file);
+      if (!baseline) {
+        std::cerr << "Error: cannot load baseline result: " << opts.diff_file
+                  << "\n";
+        return 1;
+      }
+      std::vector<BaselineHotLine> current;
+      current.reserve(hot.size());
+      for (const auto &h : hot)
+        current.push_back({std::string(h.file), h.line, h.hits, h.misses});
+      write_result_diff(std::cout, config_name, total_events, stats.l1d,
+                        stats.l2, stats.l3, stats.timing.total_cycles, current,
+                        *baseline);
+      return 0;
+    }
+
     if (json_output) {
       std::cout << "{\n";
       std::cout << "  \"config\": \"" << config_name << "\",\n";
-      std::cout << "  \"events\": " << events.size() << ",\n";
+      std::cout << "  \"events\": " << events_done << ",\n";
+      if (g_cancel_requested) {
+        std::cout << "  \"partial\": {\"cancelled\": true, "
+                  << "\"eventsProcessed\": " << events_done
+                  << ", \"eventsTotal\": " << total_events << "},\n";
+      }
+      if (processor.get_sampling().active()) {
+        const auto &sampling = processor.get_sampling();
+        std::cout << "  \"sampling\": {\"estimatedEvents\": "
+                  << sampling.weighted_events
+                  << ", \"minRate\": " << sampling.min_rate
+                  << ", \"maxRate\": " << sampling.max_rate
+                  << ", \"rateChanges\": " << sampling.rate_changes << "},\n";
+      }
+      if (opts.sample_sets > 1) {
+        std::cout << "  \"setSampling\": {\"factor\": " << opts.sample_sets
+                  << ", \"hitRateError\": {"
+                  << std::fixed << std::setprecision(4)
+                  << "\"l1d\": " << sample_err_l1
+                  << ", \"l2\": " << sample_err_l2
+                  << ", \"l3\": " << sample_err_l3 << "}},\n";
+      }
+      if (opts.warmup_events > 0) {
+        // Stats below exclude the functionally warmed prefix
+        std::cout << "  \"warmupEvents\": "
+                  << std::min(opts.warmup_events, total_events) << ",\n";
+      }
 
       // Output cache configuration for visualization
       std::cout << "  \"cacheConfig\": {\n";
@@ -903,6 +2611,16 @@ int main(int argc, char *argv[]) {
 
       std::cout << "  },\n";
 
+      if (opts.mrc)
+        JsonOutput::write_mrc(std::cout, mrc_analyzer, cfg.l1_data.line_size);
+
+      if (!intervals.empty())
+        JsonOutput::write_intervals(std::cout, intervals, cfg);
+
+      if (opt.ran)
+        JsonOutput::write_opt_comparison(std::cout, cfg, stats.l1d, stats.l2,
+                                         stats.l3, opt.l1, opt.l2, opt.l3);
+
       // TLB statistics
       auto tlb_stats = processor.get_cache_system().get_tlb_stats();
       std::cout << "  \"tlb\": {\n";
@@ -911,31 +2629,57 @@ int main(int argc, char *argv[]) {
                 << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.dtlb.hit_rate() << "},\n";
       std::cout << "    \"itlb\": {\"hits\": " << tlb_stats.itlb.hits
                 << ", \"misses\": " << tlb_stats.itlb.misses
-                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.itlb.hit_rate() << "}\n";
+                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.itlb.hit_rate() << "},\n";
+      std::cout << "    \"stlb\": {\"hits\": " << tlb_stats.stlb.hits
+                << ", \"misses\": " << tlb_stats.stlb.misses
+                << ", \"hitRate\": " << std::fixed << std::setprecision(3) << tlb_stats.stlb.hit_rate() << "},\n";
+      std::cout << "    \"pageSize\": " << processor.get_cache_system().get_page_size() << "\n";
       std::cout << "  },\n";
 
-      // Timing statistics
-      auto timing = stats.timing;
-      auto latency_cfg = processor.get_cache_system().get_latency_config();
+      // Front-end branch-target statistics (fed by I-cache fetch events)
+      JsonOutput::write_btb_stats(std::cout,
+                                  processor.get_cache_system().get_btb_stats());
+
+      // Compressed-L3 what-if comparison (--compress-l3)
+      if (processor.get_cache_system().has_l3_compression()) {
+        JsonOutput::write_compression(
+            std::cout, processor.get_cache_system().get_l3_compression(),
+            stats.l3);
+      }
+
+      // Conflict-miss remap what-if (--remap)
+      if (processor.has_remap_analysis()) {
+        JsonOutput::write_remap(std::cout, processor.get_remap_analysis());
+      }
+
+      // Stack/global/heap breakdown (only when the trace carried K records)
+      if (processor.has_region_records()) {
+        JsonOutput::write_region_stats(std::cout, processor.get_region_stats());
+      }
+
+      // Incremental re-run provenance: how much of the trace the
+      // checkpoint series let us skip (--incremental)
+      if (!opts.incremental_baseline.empty()) {
+        std::cout << "  \"incremental\": {\"prefixEvents\": "
+                  << inc_plan.prefix_events
+                  << ", \"resumeOffset\": " << inc_plan.resume_offset
+                  << ", \"checkpoint\": \""
+                  << JsonOutput::escape(inc_plan.checkpoint_path)
+                  << "\", \"simulatedEvents\": "
+                  << (events.size() - inc_plan.resume_offset) << "},\n";
+      }
+
+      // Timing statistics (includes MSHR/MLP accounting)
       uint64_t total_accesses = stats.l1d.total_accesses() + stats.l1i.total_accesses();
-      std::cout << "  \"timing\": {\n";
-      std::cout << "    \"totalCycles\": " << timing.total_cycles << ",\n";
-      std::cout << "    \"avgLatency\": " << std::fixed << std::setprecision(2) << timing.average_access_latency(total_accesses) << ",\n";
-      std::cout << "    \"breakdown\": {\n";
-      std::cout << "      \"l1HitCycles\": " << timing.l1_hit_cycles << ",\n";
-      std::cout << "      \"l2HitCycles\": " << timing.l2_hit_cycles << ",\n";
-      std::cout << "      \"l3HitCycles\": " << timing.l3_hit_cycles << ",\n";
-      std::cout << "      \"memoryCycles\": " << timing.memory_cycles << ",\n";
-      std::cout << "      \"tlbMissCycles\": " << timing.tlb_miss_cycles << "\n";
-      std::cout << "    },\n";
-      std::cout << "    \"latencyConfig\": {\n";
-      std::cout << "      \"l1Hit\": " << latency_cfg.l1_hit << ",\n";
-      std::cout << "      \"l2Hit\": " << latency_cfg.l2_hit << ",\n";
-      std::cout << "      \"l3Hit\": " << latency_cfg.l3_hit << ",\n";
-      std::cout << "      \"memory\": " << latency_cfg.memory << ",\n";
-      std::cout << "      \"tlbMissPenalty\": " << latency_cfg.tlb_miss_penalty << "\n";
-      std::cout << "    }\n";
-      std::cout << "  },\n";
+      JsonOutput::write_timing_stats(std::cout, stats.timing, total_accesses,
+                                     processor.get_cache_system().get_latency_config(),
+                                     processor.get_cache_system().get_dram_config(),
+                                     &processor.get_cache_system().get_latency_histogram());
+
+      // Per-link bandwidth vs preset peaks (roofline verdict)
+      JsonOutput::write_bandwidth(std::cout, stats.bandwidth,
+                                  stats.timing.total_cycles, cfg.bandwidth,
+                                  cfg.l3.is_valid());
       std::cout << "  \"hotLines\": [\n";
 
       for (size_t i = 0; i < hot.size(); i++) {
@@ -944,16 +2688,41 @@ int main(int argc, char *argv[]) {
                   << "\"line\": " << h.line << ", "
                   << "\"hits\": " << h.hits << ", "
                   << "\"misses\": " << h.misses << ", "
-                  << "\"missRate\": " << std::fixed << std::setprecision(3) << h.miss_rate() << "}"
+                  << "\"missRate\": " << std::fixed << std::setprecision(3) << h.miss_rate() << ", "
+                  << "\"lineUtilization\": " << std::fixed << std::setprecision(3)
+                  << h.line_utilization(cfg.l1_data.line_size) << "}"
                   << (i + 1 < hot.size() ? ",\n" : "\n");
       }
 
       std::cout << "  ],\n";
 
+      // Per-function rollup (only when the trace carried G records)
+      auto hot_funcs = processor.get_hot_functions(10);
+      if (!hot_funcs.empty()) {
+        std::cout << "  \"hotFunctions\": [\n";
+        for (size_t i = 0; i < hot_funcs.size(); i++) {
+          const auto &f = hot_funcs[i];
+          std::cout << "    {\"function\": \"" << JsonOutput::escape(f.function) << "\", "
+                    << "\"hits\": " << f.hits << ", "
+                    << "\"misses\": " << f.misses << ", "
+                    << "\"missRate\": " << std::fixed << std::setprecision(3) << f.miss_rate() << ", "
+                    << "\"lines\": " << f.lines << "}"
+                    << (i + 1 < hot_funcs.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ],\n";
+      }
+
       // Generate optimization suggestions for single-core
       auto suggestions =
           OptimizationSuggester::analyze(hot, stats.l1d, stats.l2);
 
+      // Layout advisor: partially-used structs from heap attribution
+      if (processor.has_heap_records()) {
+        auto layout = OptimizationSuggester::analyze_layout(
+            processor.get_heap_objects(10), cfg.l1_data.line_size);
+        suggestions.insert(suggestions.end(), layout.begin(), layout.end());
+      }
+
       std::cout << "  \"suggestions\": [\n";
       for (size_t i = 0; i < suggestions.size(); i++) {
         const auto &s = suggestions[i];
@@ -965,6 +2734,76 @@ int main(int argc, char *argv[]) {
                   << (i + 1 < suggestions.size() ? ",\n" : "\n");
       }
       std::cout << "  ]";
+
+      // Phase-sampled extrapolation (--simpoint)
+      if (simpoint.ran) {
+        auto json_simpoint_level = [&](const char *name, const SimPointLevel &l,
+                                       bool last) {
+          double bound = simpoint.error_bound;
+          double rate = l.hit_rate();
+          std::cout << "    \"" << name << "\": {"
+                    << "\"hits\": " << std::fixed << std::setprecision(0) << l.hits << ", "
+                    << "\"misses\": " << l.misses << ", "
+                    << std::setprecision(3)
+                    << "\"hitRate\": " << rate << ", "
+                    << "\"hitRateLow\": " << std::max(0.0, rate - bound) << ", "
+                    << "\"hitRateHigh\": " << std::min(1.0, rate + bound) << "}"
+                    << (last ? "\n" : ",\n");
+        };
+        std::cout << ",\n  \"simpoint\": {\n"
+                  << "    \"intervalLength\": " << opts.simpoint_interval << ",\n"
+                  << "    \"intervals\": " << simpoint.intervals << ",\n"
+                  << "    \"phases\": " << simpoint.phases << ",\n"
+                  << "    \"simulatedEvents\": " << simpoint.simulated_events << ",\n"
+                  << "    \"totalEvents\": " << simpoint.total_events << ",\n"
+                  << "    \"errorBound\": " << std::fixed << std::setprecision(3)
+                  << simpoint.error_bound << ",\n";
+        json_simpoint_level("l1d", simpoint.l1d, false);
+        json_simpoint_level("l2", simpoint.l2, false);
+        json_simpoint_level("l3", simpoint.l3, true);
+        std::cout << "  }";
+      }
+
+      // Per-region stats from B/E phase markers (ROI API)
+      if (processor.has_phase_records()) {
+        auto phases = processor.get_phase_stats();
+        std::cout << ",\n  \"phases\": [\n";
+        for (size_t i = 0; i < phases.size(); i++) {
+          const auto &p = phases[i];
+          std::cout << "    {\"id\": " << p.id << ", "
+                    << "\"accesses\": " << p.accesses() << ", "
+                    << "\"l1dHits\": " << p.l1d.hits << ", "
+                    << "\"l1dMisses\": " << p.l1d.misses << ", "
+                    << "\"l1dHitRate\": " << std::fixed << std::setprecision(3)
+                    << p.l1d.hit_rate() << ", "
+                    << "\"l2Misses\": " << p.l2.misses << ", "
+                    << "\"l3Misses\": " << p.l3.misses << ", "
+                    << "\"cycles\": " << p.cycles << "}"
+                    << (i + 1 < phases.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ]";
+      }
+
+      // Per-object heap attribution (CACHE_EXPLORER_TRACK_HEAP=1)
+      if (processor.has_heap_records()) {
+        auto heap = processor.get_heap_objects(10);
+        std::cout << ",\n  \"heapObjects\": [\n";
+        for (size_t i = 0; i < heap.size(); i++) {
+          const auto &h = heap[i];
+          std::cout << "    {\"site\": \"" << JsonOutput::escape(h.file) << "\", "
+                    << "\"line\": " << h.line << ", "
+                    << "\"allocs\": " << h.alloc_count << ", "
+                    << "\"bytesAllocated\": " << h.bytes_allocated << ", "
+                    << "\"peakLiveBytes\": " << h.peak_live_bytes << ", "
+                    << "\"accesses\": " << h.accesses << ", "
+                    << "\"l1Misses\": " << h.l1_misses << ", "
+                    << "\"memoryAccesses\": " << h.memory_accesses << ", "
+                    << "\"lineBytesTouched\": " << h.line_bytes_touched() << "}"
+                    << (i + 1 < heap.size() ? ",\n" : "\n");
+        }
+        std::cout << "  ]";
+      }
+
       // Add prefetch stats if enabled
       if (prefetch_policy != PrefetchPolicy::NONE) {
         auto pf_stats = processor.get_prefetch_stats();
@@ -973,18 +2812,38 @@ int main(int argc, char *argv[]) {
                   << "    \"degree\": " << prefetch_degree << ",\n"
                   << "    \"issued\": " << pf_stats.prefetches_issued << ",\n"
                   << "    \"useful\": " << pf_stats.prefetches_useful << ",\n"
-                  << "    \"accuracy\": " << std::fixed << std::setprecision(3) << pf_stats.accuracy() << "\n"
-                  << "  }";
+                  << "    \"accuracy\": " << std::fixed << std::setprecision(3) << pf_stats.accuracy();
+        if (opts.prefetch_throttle) {
+          std::cout << ",\n    \"throttle\": ";
+          JsonOutput::write_throttle(
+              std::cout, processor.get_cache_system().get_prefetcher());
+        }
+        std::cout << "\n  }";
+      }
+
+      // Victim buffer stats if enabled
+      if (opts.victim_cache_entries > 0) {
+        const auto &vc = stats.victim;
+        std::cout << ",\n  \"victimCache\": {\n"
+                  << "    \"entries\": " << opts.victim_cache_entries << ",\n"
+                  << "    \"probes\": " << vc.probes << ",\n"
+                  << "    \"hits\": " << vc.hits << ",\n"
+                  << "    \"insertions\": " << vc.insertions << ",\n"
+                  << "    \"writebacks\": " << vc.writebacks << ",\n"
+                  << "    \"hitRate\": " << std::fixed << std::setprecision(3)
+                  << vc.hit_rate() << "\n  }";
       }
 
       // Advanced instrumentation stats
       {
         auto sw_pf = processor.get_software_prefetch_stats();
         auto vec = processor.get_vector_stats();
+        auto gs = processor.get_gather_scatter_stats();
         auto atomic = processor.get_atomic_stats();
         auto mem = processor.get_memory_intrinsic_stats();
 
         bool has_advanced = sw_pf.issued > 0 || vec.loads > 0 || vec.stores > 0 ||
+                            gs.gathers > 0 || gs.scatters > 0 ||
                             atomic.load_count > 0 || atomic.store_count > 0 ||
                             mem.memcpy_count > 0 || mem.memset_count > 0;
         if (has_advanced) {
@@ -1005,6 +2864,16 @@ int main(int argc, char *argv[]) {
                       << ", \"crossLineAccesses\": " << vec.cross_line_accesses << "}";
             need_comma = true;
           }
+          if (gs.gathers > 0 || gs.scatters > 0) {
+            if (need_comma) std::cout << ",\n";
+            std::cout << "    \"gather\": {\"gathers\": " << gs.gathers
+                      << ", \"scatters\": " << gs.scatters
+                      << ", \"lanes\": " << gs.lanes
+                      << ", \"bytes\": " << gs.bytes
+                      << ", \"linesTouched\": " << gs.lines_touched
+                      << ", \"avgLinesPerOp\": " << std::fixed << std::setprecision(3) << gs.avg_lines_per_op() << "}";
+            need_comma = true;
+          }
           if (atomic.load_count > 0 || atomic.store_count > 0 || atomic.rmw_count > 0 || atomic.cmpxchg_count > 0) {
             if (need_comma) std::cout << ",\n";
             std::cout << "    \"atomic\": {\"loads\": " << atomic.load_count
@@ -1026,6 +2895,27 @@ int main(int argc, char *argv[]) {
         }
       }
 
+      // Segment cache stats (if enabled)
+      if (processor.is_segment_caching_enabled()) {
+        const auto &seg = processor.get_segment_cache_stats();
+        std::cout << ",\n  \"segmentCache\": {\n"
+                  << "    \"lookups\": " << seg.lookups << ",\n"
+                  << "    \"fastForwards\": " << seg.fast_forwards << ",\n"
+                  << "    \"hitRate\": " << std::fixed << std::setprecision(3) << seg.hit_rate() << ",\n"
+                  << "    \"verifications\": " << seg.verifications << ",\n"
+                  << "    \"divergences\": " << seg.divergences << ",\n"
+                  << "    \"evictions\": " << seg.evictions << "\n"
+                  << "  }";
+      }
+
+      // 3C classifier health (Bloom filter false-positive bound)
+      if (!fast_mode) {
+        auto cls = processor.get_classifier_summary();
+        std::cout << ",\n  \"missClassifier\": {\"fpRate\": " << std::setprecision(6) << cls.fp_rate
+                  << ", \"estimatedFpRate\": " << cls.estimated_fp_rate
+                  << ", \"memoryBytes\": " << cls.memory_bytes << "}" << std::setprecision(3);
+      }
+
       // Output L1 cache state for visualization (single core = core 0)
       std::cout << ",\n  \"cacheState\": {\"l1d\": [";
       const auto& cache_sys = processor.get_cache_system();
@@ -1036,7 +2926,26 @@ int main(int argc, char *argv[]) {
     } else {
       std::cout << "\n=== Cache Simulation Results ===\n";
       std::cout << "Config: " << config_name << "\n";
-      std::cout << "Events: " << events.size() << "\n\n";
+      std::cout << "Events: " << events_done << "\n";
+      if (g_cancel_requested) {
+        std::cout << "PARTIAL RESULT: run cancelled after " << events_done
+                  << " of " << total_events << " events\n";
+      }
+      if (processor.get_sampling().active()) {
+        const auto &sampling = processor.get_sampling();
+        std::cout << "Sampling: 1/" << sampling.min_rate;
+        if (sampling.max_rate != sampling.min_rate)
+          std::cout << " to 1/" << sampling.max_rate << " (adaptive)";
+        std::cout << " of accesses captured, ~" << sampling.weighted_events
+                  << " estimated\n";
+      }
+      if (opts.sample_sets > 1) {
+        std::cout << "Set sampling: 1/" << opts.sample_sets
+                  << " sets simulated, counts extrapolated (L1 hit rate "
+                  << std::fixed << std::setprecision(2)
+                  << "+/-" << (sample_err_l1 * 100) << "%)\n";
+      }
+      std::cout << "\n";
 
       std::cout << "Level     Hits       Misses     Hit Rate   Writebacks\n";
       std::cout << "-------   --------   --------   --------   ----------\n";
@@ -1055,15 +2964,618 @@ int main(int argc, char *argv[]) {
       print_level("L2", stats.l2);
       print_level("L3", stats.l3);
 
+      if (opts.victim_cache_entries > 0) {
+        std::cout << "\nVictim buffer (" << opts.victim_cache_entries
+                  << " entries): " << stats.victim.hits << "/"
+                  << stats.victim.probes << " misses absorbed ("
+                  << std::fixed << std::setprecision(1)
+                  << (stats.victim.hit_rate() * 100) << "%)\n";
+      }
+
+      if (processor.get_cache_system().has_l3_compression()) {
+        const auto &comp = processor.get_cache_system().get_l3_compression();
+        std::cout << "\nCompressed L3 (what-if): "
+                  << std::fixed << std::setprecision(1)
+                  << (comp.get_stats().hit_rate() * 100) << "% hit rate vs "
+                  << (stats.l3.hit_rate() * 100) << "% uncompressed, avg ratio "
+                  << std::setprecision(2) << comp.avg_compression_ratio()
+                  << "x (" << std::setprecision(0)
+                  << (comp.hint_coverage() * 100) << "% of installs hinted)\n";
+      }
+
+      if (processor.has_remap_analysis()) {
+        const auto &remap = processor.get_remap_analysis();
+        std::cout << "\n=== L1D Remap (what-if) ===\n";
+        for (size_t v = 0; v < remap.get_variants().size(); v++) {
+          const auto &r = remap.get_variants()[v];
+          std::cout << r.name << " (" << r.sets << " sets x " << r.ways
+                    << " ways" << (r.hashed ? ", hashed index" : "")
+                    << "): " << r.avoided << " of " << remap.baseline_misses()
+                    << " misses avoided (" << std::fixed
+                    << std::setprecision(1) << (remap.reduction(v) * 100)
+                    << "%)\n";
+        }
+        auto fixable = remap.get_hot_lines(5);
+        for (const auto &h : fixable) {
+          std::cout << "  " << h.file << ":" << h.line << " - "
+                    << h.shadow_misses << " misses, avoided:";
+          for (size_t v = 0; v < remap.get_variants().size(); v++) {
+            std::cout << " " << remap.get_variants()[v].name << "="
+                      << h.avoided[v];
+          }
+          std::cout << "\n";
+        }
+      }
+
+      if (stats.timing.total_cycles > 0) {
+        const auto &bw = stats.bandwidth;
+        uint64_t cycles = stats.timing.total_cycles;
+        bool has_l3_level = cfg.l3.is_valid();
+        std::cout << "\n=== Bandwidth ===\n";
+        auto print_link = [&](const char *name, uint64_t bytes, double peak) {
+          double achieved = BandwidthStats::bytes_per_cycle(bytes, cycles);
+          std::cout << name << ": " << bytes << " bytes, "
+                    << std::fixed << std::setprecision(2) << achieved
+                    << " B/cyc of " << std::setprecision(0) << peak
+                    << " peak (" << std::setprecision(0)
+                    << (peak > 0.0 ? achieved / peak * 100 : 0.0) << "%)\n";
+        };
+        print_link("L1<->L2 ", bw.l1_l2_bytes, cfg.bandwidth.l1_l2);
+        if (has_l3_level)
+          print_link("L2<->L3 ", bw.l2_l3_bytes, cfg.bandwidth.l2_l3);
+        print_link("Memory  ", bw.l3_mem_bytes, cfg.bandwidth.l3_mem);
+      }
+
       if (!hot.empty()) {
         std::cout << "\n=== Hottest Lines ===\n";
         for (const auto &s : hot) {
           std::cout << s.file << ":" << s.line << " - "
-                    << s.misses << " misses\n";
+                    << s.misses << " misses";
+          if (s.lines_fetched) {
+            std::cout << ", " << std::fixed << std::setprecision(0)
+                      << (s.line_utilization(cfg.l1_data.line_size) * 100)
+                      << "% line utilization";
+          }
+          std::cout << "\n";
+        }
+      }
+
+      auto hot_funcs = processor.get_hot_functions(10);
+      if (!hot_funcs.empty()) {
+        std::cout << "\n=== Hottest Functions ===\n";
+        for (const auto &f : hot_funcs) {
+          std::cout << f.function << " - " << f.misses << " misses over "
+                    << f.lines << " line(s)\n";
+        }
+      }
+
+      if (simpoint.ran) {
+        std::cout << "\n=== SimPoint Extrapolation ===\n";
+        std::cout << "Simulated " << simpoint.simulated_events << " of "
+                  << simpoint.total_events << " events ("
+                  << simpoint.phases << " phase(s) over "
+                  << simpoint.intervals << " intervals)\n";
+        auto print_est = [&](const char *name, const SimPointLevel &l) {
+          std::cout << name << " hit rate: "
+                    << std::fixed << std::setprecision(1)
+                    << (l.hit_rate() * 100) << "% (+/- "
+                    << (simpoint.error_bound * 100) << ")\n";
+        };
+        print_est("L1d", simpoint.l1d);
+        print_est("L2", simpoint.l2);
+        print_est("L3", simpoint.l3);
+      }
+
+      if (processor.has_phase_records()) {
+        std::cout << "\n=== Phases ===\n";
+        for (const auto &p : processor.get_phase_stats()) {
+          std::cout << "Region " << p.id << ": "
+                    << p.accesses() << " accesses, "
+                    << std::fixed << std::setprecision(1)
+                    << (p.l1d.hit_rate() * 100) << "% L1d hit rate, "
+                    << p.l3.misses << " L3 misses, "
+                    << p.cycles << " cycles\n";
+        }
+      }
+
+      if (processor.has_heap_records()) {
+        std::cout << "\n=== Heap Objects ===\n";
+        for (const auto &h : processor.get_heap_objects(10)) {
+          std::cout << h.file << ":" << h.line << " - "
+                    << h.alloc_count << " alloc(s), "
+                    << h.peak_live_bytes << " bytes peak, "
+                    << h.accesses << " accesses, "
+                    << h.memory_accesses << " to memory, "
+                    << h.line_bytes_touched() << " bytes/line touched\n";
         }
+
+        auto layout = OptimizationSuggester::analyze_layout(
+            processor.get_heap_objects(10), cfg.l1_data.line_size);
+        if (!layout.empty()) {
+          std::cout << "\n=== Layout Suggestions ===\n";
+          for (const auto &s : layout) {
+            std::cout << "[" << s.severity << "] " << s.location << ": "
+                      << s.message << "\n  Fix: " << s.fix << "\n";
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+// Daemon mode: stay resident and accept simulation jobs over a UNIX socket.
+// Protocol: the first line of each connection is a cache-sim argument string
+// (e.g. "--config intel --json"), everything after it is the trace. The
+// client half-closes its write side and reads the result back. The processor
+// pool persists across jobs, so repeat analyses skip construction cost.
+// ============ Multi-trace batch scheduler (--batch) ============
+//
+// The nightly farm used to launch one cache-sim process per trace; each
+// simulation is single-threaded, so a many-core box sat mostly idle
+// while hundreds of processes each re-paid binary startup and
+// intern-table warmup. --batch schedules the independent simulations
+// across one worker pool inside a single process - the global file-name
+// intern table already serves concurrent parser threads - and writes
+// one result file per trace.
+
+struct BatchJob {
+  std::string trace;
+  std::string output;
+  SimulatorOptions opts;
+};
+
+// Manifest: either a bare array of jobs or {"args": "...", "jobs":
+// [...]}. Each job carries "trace" (required), "output" (default:
+// trace + ".result.json") and optional "args" - ordinary cache-sim
+// flags, parsed the way the daemon parses its argument line.
+// Manifest-level args apply to every job; job-level args append.
+static bool parse_batch_manifest(const std::string &path,
+                                 std::vector<BatchJob> &jobs) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Error: cannot open manifest: " << path << "\n";
+    return false;
+  }
+  std::stringstream buf;
+  buf << in.rdbuf();
+  auto doc = JsonParser::parse(buf.str());
+  if (!doc) {
+    std::cerr << "Error: malformed manifest JSON: " << path << "\n";
+    return false;
+  }
+
+  std::string shared_args;
+  const JsonValue *list =
+      doc->type == JsonValue::Type::Array ? &*doc : doc->find("jobs");
+  if (const JsonValue *a = doc->find("args"))
+    shared_args = a->as_string();
+  if (!list || list->type != JsonValue::Type::Array || list->array.empty()) {
+    std::cerr << "Error: manifest has no jobs: " << path << "\n";
+    return false;
+  }
+
+  for (const JsonValue &entry : list->array) {
+    const JsonValue *trace = entry.find("trace");
+    if (!trace || trace->as_string().empty()) {
+      std::cerr << "Error: manifest job without \"trace\": " << path << "\n";
+      return false;
+    }
+    BatchJob job;
+    job.trace = trace->as_string();
+    const JsonValue *output = entry.find("output");
+    job.output = output ? output->as_string() : job.trace + ".result.json";
+
+    std::vector<std::string> tokens = {"cache-sim"};
+    std::string job_args = entry.find("args") ? entry.find("args")->as_string() : "";
+    std::istringstream iss(shared_args + " " + job_args);
+    std::string token;
+    while (iss >> token)
+      tokens.push_back(token);
+    std::vector<char *> job_argv;
+    job_argv.reserve(tokens.size());
+    for (auto &t : tokens)
+      job_argv.push_back(t.data());
+    job.opts =
+        ArgParser::parse(static_cast<int>(job_argv.size()), job_argv.data());
+    jobs.push_back(std::move(job));
+  }
+  return true;
+}
+
+// One trace end to end on a worker thread: load, parse, simulate, write
+// the result file. Returns false on a missing trace or unwritable
+// output; other jobs keep running either way.
+static bool run_batch_job(const BatchJob &job) {
+  MappedFile mapped;
+  if (!mapped.open(job.trace)) {
+    return false;
+  }
+  const char *data = mapped.data();
+  size_t size = mapped.size();
+  std::string inflated;
+  if (is_zstd_trace(data, size)) {
+    if (!zstd_inflate(data, size, inflated)) {
+      return false;
+    }
+    mapped.close();
+    data = inflated.data();
+    size = inflated.size();
+  }
+
+  std::vector<TraceEvent> events;
+  std::unordered_set<uint32_t> threads;
+  if (job.opts.binary_input || is_binary_trace(data, size)) {
+    events.reserve(size / (BINARY_EVENT_RECORD_SIZE + 1));
+    parse_binary_trace(data, size, [&](TraceEvent event) {
+      threads.insert(event.thread_id);
+      events.push_back(std::move(event));
+    });
+  } else {
+    events.reserve(size / 40);
+    for_each_line(data, size, [&](const char *begin, const char *end) {
+      auto event = parse_trace_event_fast(begin, end);
+      if (event) {
+        if (!event->is_sample_rate)  // W records carry no thread
+          threads.insert(event->thread_id);
+        events.push_back(std::move(*event));
       }
+    });
+  }
+  mapped.close();
+
+  std::ofstream out(job.output);
+  if (!out) {
+    return false;
+  }
+
+  const SimulatorOptions &opts = job.opts;
+  const CacheHierarchyConfig &cfg = opts.cache_config;
+  out << "{\n";
+  out << "  \"trace\": \"" << JsonOutput::escape(job.trace) << "\",\n";
+  out << "  \"config\": \"" << JsonOutput::escape(opts.config_name) << "\",\n";
+
+  if (threads.size() > 1) {
+    int num_cores = std::max(1, std::min(static_cast<int>(threads.size()), 8));
+    MultiCoreTraceProcessor processor(num_cores, cfg.l1_data, cfg.l2, cfg.l3,
+                                       opts.prefetch_policy,
+                                       opts.prefetch_degree,
+                                       opts.coherence_mode,
+                                       cfg.coherence_protocol);
+    if (opts.fast_mode) {
+      processor.set_fast_mode(true);
+    } else {
+      processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+    }
+    if (!opts.coherence_memo) {
+      processor.set_coherence_memo(false);
+    }
+    if (opts.huge_page_size) {
+      processor.set_page_size(opts.huge_page_size);
+    }
+    for (size_t i = 0; i < events.size(); i += PROCESS_CHUNK) {
+      processor.process_batch(events.data() + i,
+                              std::min(PROCESS_CHUNK, events.size() - i));
+    }
+
+    auto stats = processor.get_stats();
+    CacheStats l1_total;
+    for (const auto &l1 : stats.l1_per_core) {
+      l1_total += l1;
+    }
+    out << "  \"multicore\": true,\n";
+    out << "  \"cores\": " << processor.get_num_cores() << ",\n";
+    out << "  \"levels\": {\n";
+    JsonOutput::write_cache_stats(out, "l1", l1_total, false);
+    JsonOutput::write_cache_stats(out, "l2", stats.l2, false);
+    JsonOutput::write_cache_stats(out, "l3", stats.l3, true);
+    out << "  },\n";
+    out << "  \"coherence\": {\"invalidations\": "
+        << stats.coherence_invalidations
+        << ", \"falseSharingEvents\": " << stats.false_sharing_events
+        << "},\n";
+    JsonOutput::write_hot_lines_multicore(out, processor.get_hot_lines(10));
+  } else {
+    TraceProcessor processor(cfg);
+    if (opts.fast_mode) {
+      processor.set_fast_mode(true);
+    } else {
+      processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+    }
+    if (opts.sample_sets > 1) {
+      processor.set_set_sampling(opts.sample_sets);
+    }
+    if (opts.tlb_walk_injection) {
+      processor.set_walk_injection(true);
+    }
+    if (opts.huge_page_size) {
+      processor.set_page_size(opts.huge_page_size);
+    }
+    if (opts.page_alloc != PageAllocPolicy::None) {
+      processor.set_page_allocation(opts.page_alloc, opts.page_alloc_seed);
+    }
+    if (opts.victim_cache_entries > 0) {
+      processor.enable_victim_cache(opts.victim_cache_entries);
+    }
+    if (opts.compress_l3) {
+      processor.enable_l3_compression({.enabled = true});
+    }
+    if (opts.remap_analysis) {
+      processor.enable_remap_analysis();
+    }
+    if (!opts.bulk_sweep) {
+      processor.set_bulk_intrinsics(false);
+    }
+    if (opts.prefetch_policy != PrefetchPolicy::NONE) {
+      processor.enable_prefetching(opts.prefetch_policy, opts.prefetch_degree);
+    }
+    for (size_t i = 0; i < events.size(); i += PROCESS_CHUNK) {
+      processor.process_batch(events.data() + i,
+                              std::min(PROCESS_CHUNK, events.size() - i));
+    }
+
+    auto stats = processor.get_stats();
+    if (opts.sample_sets > 1) {
+      stats.scale(opts.sample_sets);
+    }
+    out << "  \"multicore\": false,\n";
+    out << "  \"cores\": 1,\n";
+    out << "  \"levels\": {\n";
+    JsonOutput::write_cache_stats(out, "l1d", stats.l1d, false);
+    JsonOutput::write_cache_stats(out, "l1i", stats.l1i, false);
+    JsonOutput::write_cache_stats(out, "l2", stats.l2, false);
+    JsonOutput::write_cache_stats(out, "l3", stats.l3, true);
+    out << "  },\n";
+    JsonOutput::write_tlb_stats(out,
+                                processor.get_cache_system().get_tlb_stats());
+    JsonOutput::write_btb_stats(out,
+                                processor.get_cache_system().get_btb_stats());
+    if (processor.get_cache_system().has_l3_compression()) {
+      JsonOutput::write_compression(
+          out, processor.get_cache_system().get_l3_compression(), stats.l3);
     }
+    if (processor.has_remap_analysis()) {
+      JsonOutput::write_remap(out, processor.get_remap_analysis());
+    }
+    if (processor.has_region_records()) {
+      JsonOutput::write_region_stats(out, processor.get_region_stats());
+    }
+    uint64_t total_accesses =
+        stats.l1d.total_accesses() + stats.l1i.total_accesses();
+    JsonOutput::write_timing_stats(
+        out, stats.timing, total_accesses,
+        processor.get_cache_system().get_latency_config(),
+        processor.get_cache_system().get_dram_config(),
+        &processor.get_cache_system().get_latency_histogram());
+    JsonOutput::write_hot_lines(out, processor.get_hot_lines(10));
+  }
+
+  out << "  \"events\": " << events.size() << "\n";
+  out << "}\n";
+  return out.good();
+}
+
+static int run_batch(const SimulatorOptions &opts) {
+  std::vector<BatchJob> jobs;
+  if (!parse_batch_manifest(opts.batch_manifest, jobs)) {
+    return 1;
+  }
+
+  size_t pool_size = opts.parallel_threads ? opts.parallel_threads
+                                           : std::thread::hardware_concurrency();
+  pool_size = std::min(pool_size ? pool_size : 1, jobs.size());
+
+  std::cerr << "[batch] " << jobs.size() << " trace(s) on " << pool_size
+            << " worker(s)\n";
+
+  ThreadPool pool(pool_size);
+  std::atomic<size_t> done{0};
+  std::atomic<size_t> failed{0};
+  std::mutex log_mutex;
+  for (const BatchJob &job : jobs) {
+    pool.submit([&job, &jobs, &done, &failed, &log_mutex] {
+      bool ok = run_batch_job(job);
+      size_t n = ++done;
+      std::lock_guard lock(log_mutex);
+      if (!ok) {
+        failed++;
+        std::cerr << "[batch] " << n << "/" << jobs.size() << " FAILED "
+                  << job.trace << "\n";
+      } else {
+        std::cerr << "[batch] " << n << "/" << jobs.size() << " done "
+                  << job.trace << " -> " << job.output << "\n";
+      }
+    });
+  }
+  pool.wait_idle();
+
+  if (failed > 0) {
+    std::cerr << "[batch] " << failed.load() << " job(s) failed\n";
+    return 1;
+  }
+  return 0;
+}
+
+// Live shared-memory mode (--shm): the instrumented binary exports its
+// per-thread rings in a mapped segment (CACHE_EXPLORER_SHM=<path>) and we
+// consume the packed CacheEvent records in place while it runs - no
+// formatting, no pipe copies, no parse step. Uses the stream-mode
+// processor shape (8 cores) so single- and multi-threaded programs work
+// transparently; results go to stdout as the usual multicore JSON.
+static int run_shm_live(const SimulatorOptions &opts) {
+  ShmTraceConsumer consumer;
+  if (!consumer.open(opts.shm_path)) {
+    std::cerr << "Error: no shm trace segment at " << opts.shm_path
+              << " (is the producer running with CACHE_EXPLORER_SHM set?)\n";
+    return 1;
   }
 
+  const CacheHierarchyConfig &cfg = opts.cache_config;
+  MultiCoreTraceProcessor processor(8, cfg.l1_data, cfg.l2, cfg.l3,
+                                     opts.prefetch_policy,
+                                     opts.prefetch_degree,
+                                     opts.coherence_mode,
+                                     cfg.coherence_protocol);
+  if (opts.fast_mode) {
+    processor.set_fast_mode(true);
+  } else {
+    processor.set_classifier_fp_rate(opts.bloom_fp_rate);
+  }
+  if (!opts.coherence_memo) {
+    processor.set_coherence_memo(false);
+  }
+  if (opts.hot_line_budget) {
+    processor.set_hot_line_budget(opts.hot_line_budget);
+  }
+  if (opts.huge_page_size) {
+    processor.set_page_size(opts.huge_page_size);
+  }
+  if (opts.prefetch_throttle) {
+    processor.enable_prefetch_throttling();
+  }
+  if (cfg.cores_per_ccx > 0) {
+    processor.enable_ccx_topology(cfg.cores_per_ccx);
+  }
+  if (!configure_thread_placement(processor, opts)) {
+    return 1;
+  }
+
+  TraceFilter filter = make_trace_filter(opts);
+  uint64_t events = consumer.consume([&](TraceEvent event) {
+    if (filter.active() && !filter.admit(event))
+      return;
+    processor.process(event);
+  });
+
+  auto stats = processor.get_stats();
+  CacheStats l1_total;
+  for (const auto &l1 : stats.l1_per_core) {
+    l1_total += l1;
+  }
+
+  std::cout << "{\n";
+  std::cout << "  \"config\": \"" << JsonOutput::escape(opts.config_name)
+            << "\",\n";
+  std::cout << "  \"multicore\": true,\n";
+  std::cout << "  \"cores\": " << processor.get_num_cores() << ",\n";
+  std::cout << "  \"threads\": " << processor.get_thread_count() << ",\n";
+  std::cout << "  \"levels\": {\n";
+  JsonOutput::write_cache_stats(std::cout, "l1", l1_total, false);
+  JsonOutput::write_cache_stats(std::cout, "l2", stats.l2, false);
+  JsonOutput::write_cache_stats(std::cout, "l3", stats.l3, true);
+  std::cout << "  },\n";
+  std::cout << "  \"coherence\": {\"invalidations\": "
+            << stats.coherence_invalidations
+            << ", \"falseSharingEvents\": " << stats.false_sharing_events
+            << "},\n";
+  JsonOutput::write_hot_lines_multicore(std::cout, processor.get_hot_lines(10));
+  std::cout << "  \"droppedEvents\": " << consumer.dropped() << ",\n";
+  std::cout << "  \"events\": " << events << "\n";
+  std::cout << "}\n";
   return 0;
 }
+
+static int run_daemon(const std::string &socket_path) {
+  signal(SIGPIPE, SIG_IGN);
+
+  sockaddr_un addr{};
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Error: socket path too long: " << socket_path << "\n";
+    return 1;
+  }
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "Error: cannot create socket\n";
+    return 1;
+  }
+
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(socket_path.c_str()); // Replace a stale socket from a previous run
+
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd, 4) < 0) {
+    std::cerr << "Error: cannot bind " << socket_path << "\n";
+    close(listen_fd);
+    return 1;
+  }
+
+  std::cerr << "cache-sim daemon listening on " << socket_path << "\n";
+
+  while (true) {
+    int conn = accept(listen_fd, nullptr, nullptr);
+    if (conn < 0)
+      continue;
+
+    // The argument line ends at the first newline; trace data follows it
+    std::string arg_line;
+    char c;
+    while (read(conn, &c, 1) == 1 && c != '\n')
+      arg_line += c;
+
+    std::vector<std::string> tokens = {"cache-sim"};
+    std::istringstream iss(arg_line);
+    std::string token;
+    while (iss >> token)
+      tokens.push_back(token);
+
+    std::vector<char *> job_argv;
+    job_argv.reserve(tokens.size());
+    for (auto &t : tokens)
+      job_argv.push_back(t.data());
+
+    SimulatorOptions job =
+        ArgParser::parse(static_cast<int>(job_argv.size()), job_argv.data());
+    if (job.show_help) {
+      close(conn);
+      continue;
+    }
+
+    // Swap the connection in for stdio while the job runs
+    int saved_in = dup(STDIN_FILENO);
+    int saved_out = dup(STDOUT_FILENO);
+    dup2(conn, STDIN_FILENO);
+    dup2(conn, STDOUT_FILENO);
+    clearerr(stdin); // Previous job left stdin at EOF
+
+    run_simulation(job);
+
+    std::cout.flush();
+    fflush(stdout);
+    dup2(saved_in, STDIN_FILENO);
+    dup2(saved_out, STDOUT_FILENO);
+    close(saved_in);
+    close(saved_out);
+    close(conn);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  // Disable C/C++ stream sync - massive speedup for stdin/stdout
+  std::ios_base::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
+  // Parse command line arguments
+  SimulatorOptions opts = ArgParser::parse(argc, argv);
+
+  if (opts.show_help) {
+    ArgParser::print_usage(argv[0]);
+    return 0;
+  }
+
+  if (!opts.batch_manifest.empty()) {
+    return run_batch(opts);
+  }
+
+  if (!opts.shm_path.empty()) {
+    return run_shm_live(opts);
+  }
+
+  if (!opts.daemon_socket.empty()) {
+    return run_daemon(opts.daemon_socket);
+  }
+
+  return run_simulation(opts);
+}
@@ -112,6 +112,35 @@ TEST(test_parse_vector_store_event) {
   ASSERT_EQ(event->size, 32U);
 }
 
+TEST(test_parse_gather_lane_event) {
+  // Format: VL <addr> <lane> <lanes> <size> <file:line> <thread>
+  // One record per active lane of a masked gather, each with its own address
+  auto event = parse_trace_event("VL 0x1000 2 8 4 gather.c:30 T1");
+
+  ASSERT(event.has_value());
+  ASSERT(event->is_gather);
+  ASSERT(!event->is_write);
+  ASSERT(!event->is_vector);  // Counted separately from contiguous vector ops
+  ASSERT_EQ(event->address, 0x1000ULL);
+  ASSERT_EQ(event->lane, 2);
+  ASSERT_EQ(event->lanes, 8);
+  ASSERT_EQ(event->size, 4U);  // Element size, not the whole vector
+  ASSERT_EQ(event->file, "gather.c");
+  ASSERT_EQ(event->line, 30U);
+}
+
+TEST(test_parse_scatter_lane_event) {
+  // Format: VS <addr> <lane> <lanes> <size> <file:line> <thread>
+  auto event = parse_trace_event("VS 0x2000 0 4 8 scatter.c:31 T2");
+
+  ASSERT(event.has_value());
+  ASSERT(event->is_gather);
+  ASSERT(event->is_write);
+  ASSERT_EQ(event->lane, 0);
+  ASSERT_EQ(event->lanes, 4);
+  ASSERT_EQ(event->size, 8U);
+}
+
 TEST(test_parse_atomic_load_event) {
   // Format: A <address> <size> <file:line> <thread>
   // A indicates an atomic load
@@ -246,6 +275,81 @@ TEST(test_simulator_vector_stats_tracked) {
   ASSERT_EQ(vec_stats.bytes_loaded, 32ULL);
 }
 
+// Helper: one lane of a gather/scatter op
+static TraceEvent make_lane(uint64_t addr, uint8_t lane, uint8_t lanes,
+                            bool is_write) {
+  TraceEvent e{};
+  e.is_gather = true;
+  e.is_write = is_write;
+  e.address = addr;
+  e.size = 4;
+  e.lane = lane;
+  e.lanes = lanes;
+  e.file = "gather.c";
+  e.line = 40;
+  return e;
+}
+
+TEST(test_simulator_gather_lanes_charge_discontiguous_lines) {
+  // An 8-lane gather with lanes a page apart must charge 8 distinct
+  // cache lines - the whole point of per-lane records
+  auto cfg = make_educational_config();
+  TraceProcessor processor(cfg);
+
+  for (uint8_t lane = 0; lane < 8; lane++) {
+    processor.process(make_lane(0x10000 + lane * 4096ULL, lane, 8, false));
+  }
+
+  auto stats = processor.get_stats();
+  ASSERT_EQ(stats.l1d.misses, 8ULL);
+
+  auto gs = processor.get_gather_scatter_stats();
+  ASSERT_EQ(gs.gathers, 1ULL);
+  ASSERT_EQ(gs.scatters, 0ULL);
+  ASSERT_EQ(gs.lanes, 8ULL);
+  ASSERT_EQ(gs.bytes, 32ULL);
+  ASSERT_EQ(gs.lines_touched, 8ULL);
+}
+
+TEST(test_simulator_gather_contiguous_lanes_share_one_line) {
+  // Adjacent lanes dedupe to one line - avg_lines_per_op near 1.0 means
+  // the "gather" was really a contiguous load in disguise
+  auto cfg = make_educational_config();
+  TraceProcessor processor(cfg);
+
+  for (uint8_t lane = 0; lane < 8; lane++) {
+    processor.process(make_lane(0x2000 + lane * 4ULL, lane, 8, false));
+  }
+
+  auto stats = processor.get_stats();
+  ASSERT_EQ(stats.l1d.misses, 1ULL);
+
+  auto gs = processor.get_gather_scatter_stats();
+  ASSERT_EQ(gs.gathers, 1ULL);
+  ASSERT_EQ(gs.lines_touched, 1ULL);
+  ASSERT(gs.avg_lines_per_op() < 1.5);
+}
+
+TEST(test_simulator_scatter_lanes_tracked_per_op) {
+  // Two 4-lane scatters: op count groups by the lane index, not records
+  auto cfg = make_educational_config();
+  TraceProcessor processor(cfg);
+
+  for (int op = 0; op < 2; op++) {
+    for (uint8_t lane = 0; lane < 4; lane++) {
+      processor.process(
+          make_lane(0x30000 + op * 0x8000ULL + lane * 256ULL, lane, 4, true));
+    }
+  }
+
+  auto gs = processor.get_gather_scatter_stats();
+  ASSERT_EQ(gs.gathers, 0ULL);
+  ASSERT_EQ(gs.scatters, 2ULL);
+  ASSERT_EQ(gs.lanes, 8ULL);
+  ASSERT_EQ(gs.lines_touched, 8ULL);
+  ASSERT_EQ(gs.avg_lines_per_op(), 4.0);
+}
+
 TEST(test_simulator_atomic_triggers_coherence) {
   // In multi-core, atomic operations should cause coherence traffic
   auto cfg = make_educational_config();
@@ -366,6 +470,73 @@ TEST(test_atomic_contention_detection) {
   ASSERT(stats.coherence_invalidations > 50);
 }
 
+TEST(test_contended_atomics_ranked) {
+  // The contention report ranks addresses bounced between threads and
+  // drops atomics only one thread ever touches
+  auto cfg = make_educational_config();
+  MultiCoreTraceProcessor processor(4, cfg.l1_data, cfg.l2, cfg.l3);
+
+  // Contended counter: RMWs alternating across 4 threads
+  for (int i = 0; i < 100; i++) {
+    TraceEvent atomic{};
+    atomic.is_atomic = true;
+    atomic.is_write = true;
+    atomic.is_rmw = true;
+    atomic.address = 0x1000;
+    atomic.size = 4;
+    atomic.thread_id = (i % 4) + 1;
+    processor.process(atomic);
+  }
+
+  // Uncontended counter: one thread, no retries
+  for (int i = 0; i < 100; i++) {
+    TraceEvent atomic{};
+    atomic.is_atomic = true;
+    atomic.is_write = true;
+    atomic.is_rmw = true;
+    atomic.address = 0x2000;
+    atomic.size = 4;
+    atomic.thread_id = 1;
+    processor.process(atomic);
+  }
+
+  auto contended = processor.get_contended_atomics();
+  ASSERT_EQ(contended.size(), 1UL);
+  ASSERT_EQ(contended[0].address, 0x1000ULL);
+  ASSERT_EQ(contended[0].rmws, 100ULL);
+  ASSERT_EQ(contended[0].threads, 4U);
+  // Every RMW after the first came from a different thread than the
+  // previous writer
+  ASSERT_EQ(contended[0].ping_pongs, 99ULL);
+
+  // Ping-pongs also feed the global contention counter
+  ASSERT_EQ(processor.get_atomic_stats().contention_events, 99ULL);
+}
+
+TEST(test_cmpxchg_retry_clustering) {
+  // Back-to-back cmpxchg ops by one thread read as a failed-CAS retry
+  // loop; the spin qualifies the address even without a second thread
+  auto cfg = make_educational_config();
+  MultiCoreTraceProcessor processor(2, cfg.l1_data, cfg.l2, cfg.l3);
+
+  for (int i = 0; i < 5; i++) {
+    TraceEvent cas{};
+    cas.is_atomic = true;
+    cas.is_cmpxchg = true;
+    cas.is_write = true;
+    cas.address = 0x3000;
+    cas.size = 8;
+    cas.thread_id = 1;
+    processor.process(cas);
+  }
+
+  auto contended = processor.get_contended_atomics();
+  ASSERT_EQ(contended.size(), 1UL);
+  ASSERT_EQ(contended[0].cmpxchgs, 5ULL);
+  ASSERT_EQ(contended[0].retries, 4ULL);  // first attempt is not a retry
+  ASSERT_EQ(contended[0].ping_pongs, 0ULL);
+}
+
 // =============================================================================
 // PART 4: End-to-End Integration Tests
 // =============================================================================
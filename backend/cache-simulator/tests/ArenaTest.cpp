@@ -0,0 +1,132 @@
+#include "../include/Arena.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void test_basic_allocation() {
+  Arena arena;
+
+  auto *a = static_cast<uint64_t *>(arena.allocate(sizeof(uint64_t)));
+  auto *b = static_cast<uint64_t *>(arena.allocate(sizeof(uint64_t)));
+  *a = 1;
+  *b = 2;
+  assert(a != b);
+  assert(*a == 1 && *b == 2);
+  assert(arena.bytes_used() == 2 * sizeof(uint64_t));
+
+  std::cout << "[PASS] test_basic_allocation\n";
+}
+
+void test_alignment() {
+  Arena arena;
+
+  arena.allocate(1, 1);  // misalign the bump pointer
+  auto *p = arena.allocate(sizeof(uint64_t), alignof(uint64_t));
+  assert(reinterpret_cast<uintptr_t>(p) % alignof(uint64_t) == 0);
+
+  std::cout << "[PASS] test_alignment\n";
+}
+
+void test_copy_string_stable_across_blocks() {
+  // Views handed out earlier must survive later block growth
+  Arena arena(256);
+
+  std::vector<std::string_view> views;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100; i++) {
+    expected.push_back("file_" + std::to_string(i) + ".c");
+    views.push_back(arena.copy_string(expected.back()));
+  }
+
+  for (int i = 0; i < 100; i++) {
+    assert(views[i] == expected[i]);
+  }
+
+  std::cout << "[PASS] test_copy_string_stable_across_blocks\n";
+}
+
+void test_oversized_allocation() {
+  Arena arena(64);
+
+  auto *small = static_cast<char *>(arena.allocate(16, 1));
+  std::memset(small, 'a', 16);
+
+  // Bigger than the block size: gets its own block, and the current
+  // block keeps bumping afterwards without trampling it
+  auto *big = static_cast<char *>(arena.allocate(1024, 1));
+  std::memset(big, 'b', 1024);
+  auto *small2 = static_cast<char *>(arena.allocate(16, 1));
+  std::memset(small2, 'c', 16);
+
+  assert(small[0] == 'a' && small[15] == 'a');
+  for (int i = 0; i < 1024; i++) {
+    assert(big[i] == 'b');
+  }
+  assert(small2[0] == 'c');
+
+  std::cout << "[PASS] test_oversized_allocation\n";
+}
+
+void test_oversized_first_allocation() {
+  // A dedicated block as the very first allocation must not become the
+  // bump target for subsequent small ones
+  Arena arena(64);
+
+  auto *big = static_cast<char *>(arena.allocate(1024, 1));
+  std::memset(big, 'b', 1024);
+  auto *small = static_cast<char *>(arena.allocate(16, 1));
+  std::memset(small, 's', 16);
+
+  for (int i = 0; i < 1024; i++) {
+    assert(big[i] == 'b');
+  }
+
+  std::cout << "[PASS] test_oversized_first_allocation\n";
+}
+
+void test_release_and_reuse() {
+  Arena arena(256);
+
+  for (int i = 0; i < 50; i++) {
+    arena.copy_string("some_source_file.c");
+  }
+  assert(arena.bytes_used() > 0);
+  assert(arena.bytes_reserved() > 0);
+
+  arena.release();
+  assert(arena.bytes_used() == 0);
+  assert(arena.bytes_reserved() == 0);
+
+  auto view = arena.copy_string("fresh.c");
+  assert(view == "fresh.c");
+
+  std::cout << "[PASS] test_release_and_reuse\n";
+}
+
+void test_empty_string() {
+  Arena arena;
+
+  auto view = arena.copy_string("");
+  assert(view.empty());
+  assert(arena.bytes_used() == 0);
+
+  std::cout << "[PASS] test_empty_string\n";
+}
+
+int main() {
+  std::cout << "Running Arena tests...\n\n";
+
+  test_basic_allocation();
+  test_alignment();
+  test_copy_string_stable_across_blocks();
+  test_oversized_allocation();
+  test_oversized_first_allocation();
+  test_release_and_reuse();
+  test_empty_string();
+
+  std::cout << "\nAll Arena tests passed!\n";
+  return 0;
+}
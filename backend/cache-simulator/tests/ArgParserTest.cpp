@@ -94,6 +94,45 @@ void test_cores_flag() {
   std::cout << "[PASS] test_cores_flag\n";
 }
 
+void test_coherence_flag() {
+  ArgvBuilder builder;
+  builder.add("--coherence").add("directory");
+  auto opts = ArgParser::parse(builder.argc(), builder.argv());
+
+  assert(opts.coherence_mode == CoherenceMode::Directory);
+  assert(ArgParser::parse_coherence_mode("snoop") == CoherenceMode::Snoop);
+  assert(ArgParser::parse_coherence_mode("auto") == CoherenceMode::Auto);
+  assert(ArgParser::coherence_mode_name(CoherenceMode::Directory) ==
+         "directory");
+  std::cout << "[PASS] test_coherence_flag\n";
+}
+
+void test_configs_flag() {
+  ArgvBuilder builder;
+  builder.add("--configs").add("intel,amd,epyc");
+  auto opts = ArgParser::parse(builder.argc(), builder.argv());
+
+  assert(opts.config_list.size() == 3);
+  assert(opts.config_list[0] == "intel");
+  assert(opts.config_list[1] == "amd");
+  assert(opts.config_list[2] == "epyc");
+
+  // Empty segments are dropped, single name still works
+  ArgvBuilder single;
+  single.add("--configs").add("zen3,");
+  auto single_opts = ArgParser::parse(single.argc(), single.argv());
+  assert(single_opts.config_list.size() == 1);
+  assert(single_opts.config_list[0] == "zen3");
+
+  // Plain --config leaves the list empty
+  ArgvBuilder plain;
+  plain.add("--config").add("intel");
+  auto plain_opts = ArgParser::parse(plain.argc(), plain.argv());
+  assert(plain_opts.config_list.empty());
+
+  std::cout << "[PASS] test_configs_flag\n";
+}
+
 void test_prefetch_policy_none() {
   auto policy = ArgParser::parse_prefetch_policy("none");
   assert(policy == PrefetchPolicy::NONE);
@@ -258,6 +297,8 @@ int main() {
   test_stream_flag();
   test_help_flag();
   test_cores_flag();
+  test_coherence_flag();
+  test_configs_flag();
   test_flamegraph_flag();
 
   // Prefetch parsing
@@ -0,0 +1,238 @@
+#include "../include/BinaryTrace.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Helper to build a binary trace buffer the way the runtime emits it
+class BinaryTraceBuilder {
+public:
+  BinaryTraceBuilder() {
+    buf.append(BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC));
+    uint32_t version = BINARY_TRACE_VERSION;
+    append(&version, 4);
+  }
+
+  BinaryTraceBuilder &add_file(uint32_t id, const std::string &name) {
+    char tag = BINARY_RECORD_FILE;
+    uint16_t len = static_cast<uint16_t>(name.size());
+    append(&tag, 1);
+    append(&id, 4);
+    append(&len, 2);
+    buf.append(name);
+    return *this;
+  }
+
+  BinaryTraceBuilder &add_event(uint64_t address, uint64_t src_address,
+                                uint32_t size, uint32_t file_id, uint32_t line,
+                                uint32_t thread_id) {
+    char tag = BINARY_RECORD_EVENT;
+    uint32_t packed_line = (file_id << 20) | (line & 0xFFFFF);
+    append(&tag, 1);
+    append(&address, 8);
+    append(&src_address, 8);
+    append(&size, 4);
+    append(&packed_line, 4);
+    append(&thread_id, 4);
+    return *this;
+  }
+
+  // Compact delta event, keeping the same state the runtime's encoder
+  // keeps so generated bytes match cache-explorer-rt.c exactly
+  BinaryTraceBuilder &add_compact(uint64_t address, bool is_store,
+                                  uint32_t size, uint32_t file_id,
+                                  uint32_t line, uint32_t thread_id) {
+    uint32_t packed_line = (file_id << 20) | (line & 0xFFFFF);
+    char payload[24];
+    int n = 0;
+    uint8_t op = BINARY_COMPACT_BIT;
+    if (is_store)
+      op |= BINARY_COMPACT_STORE;
+    int64_t delta = static_cast<int64_t>(address - prev_addr);
+    n += put_varint(payload + n, (static_cast<uint64_t>(delta) << 1) ^
+                                     static_cast<uint64_t>(delta >> 63));
+    prev_addr = address;
+    if (size != prev_size) {
+      op |= BINARY_COMPACT_SIZE;
+      n += put_varint(payload + n, size);
+      prev_size = size;
+    }
+    if (packed_line != prev_line) {
+      op |= BINARY_COMPACT_LINE;
+      n += put_varint(payload + n, packed_line);
+      prev_line = packed_line;
+    }
+    if (thread_id != prev_tid) {
+      op |= BINARY_COMPACT_THREAD;
+      n += put_varint(payload + n, thread_id);
+      prev_tid = thread_id;
+    }
+    buf.push_back(static_cast<char>(op));
+    buf.append(payload, n);
+    return *this;
+  }
+
+  const std::string &data() const { return buf; }
+
+private:
+  static int put_varint(char *out, uint64_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+      out[n++] = static_cast<char>(v | 0x80);
+      v >>= 7;
+    }
+    out[n++] = static_cast<char>(v);
+    return n;
+  }
+
+  void append(const void *p, size_t n) {
+    buf.append(reinterpret_cast<const char *>(p), n);
+  }
+
+  uint64_t prev_addr = 0;
+  uint32_t prev_size = 0;
+  uint32_t prev_line = 0;
+  uint32_t prev_tid = 1;
+  std::string buf;
+};
+
+void test_magic_detection() {
+  BinaryTraceBuilder builder;
+  assert(is_binary_trace(builder.data().data(), builder.data().size()));
+
+  const char *text = "L 0x1000 4 main.c:10 T1\n";
+  assert(!is_binary_trace(text, strlen(text)));
+
+  std::cout << "[PASS] test_magic_detection\n";
+}
+
+void test_load_store_decode() {
+  BinaryTraceBuilder builder;
+  builder.add_file(0, "main.c");
+  builder.add_event(0x1000, 0, 4, 0, 10, 1);                     // load
+  builder.add_event(0x2000 | BINARY_STORE_FLAG, 0, 8, 0, 20, 2); // store
+
+  std::vector<TraceEvent> events;
+  size_t n = parse_binary_trace(builder.data().data(), builder.data().size(),
+                                [&](TraceEvent e) { events.push_back(e); });
+
+  assert(n == 2);
+  assert(events[0].address == 0x1000);
+  assert(events[0].size == 4);
+  assert(events[0].file == "main.c");
+  assert(events[0].line == 10);
+  assert(events[0].thread_id == 1);
+  assert(!events[0].is_write);
+
+  assert(events[1].address == 0x2000);
+  assert(events[1].is_write);
+  assert(events[1].line == 20);
+  assert(events[1].thread_id == 2);
+
+  std::cout << "[PASS] test_load_store_decode\n";
+}
+
+void test_file_table_interleaving() {
+  // File records may arrive mid-stream - events only reference ids
+  // already emitted
+  BinaryTraceBuilder builder;
+  builder.add_file(0, "first.c");
+  builder.add_event(0x1000, 0, 4, 0, 1, 1);
+  builder.add_file(1, "second.c");
+  builder.add_event(0x2000, 0, 4, 1, 2, 1);
+
+  std::vector<TraceEvent> events;
+  parse_binary_trace(builder.data().data(), builder.data().size(),
+                     [&](TraceEvent e) { events.push_back(e); });
+
+  assert(events.size() == 2);
+  assert(events[0].file == "first.c");
+  assert(events[1].file == "second.c");
+
+  std::cout << "[PASS] test_file_table_interleaving\n";
+}
+
+void test_event_type_flags() {
+  BinaryTraceBuilder builder;
+  builder.add_file(0, "a.c");
+  builder.add_event(0x100 | BINARY_ICACHE_FLAG, 0, 16, 0, 1, 1);
+  builder.add_event(0x200 | BINARY_VECTOR_FLAG, 0, 32, 0, 2, 1);
+  builder.add_event(0x300 | BINARY_ATOMIC_FLAG, 0, 8, 0, 3, 1);
+  builder.add_event(0x400 | BINARY_MEMINTR_FLAG, 0x500, 128, 0, 4, 1); // memcpy
+
+  std::vector<TraceEvent> events;
+  parse_binary_trace(builder.data().data(), builder.data().size(),
+                     [&](TraceEvent e) { events.push_back(e); });
+
+  assert(events.size() == 4);
+  assert(events[0].is_icache);
+  assert(events[1].is_vector && !events[1].is_write);
+  assert(events[2].is_atomic && !events[2].is_rmw);
+  assert(events[3].is_memcpy && events[3].src_address == 0x500);
+
+  std::cout << "[PASS] test_event_type_flags\n";
+}
+
+void test_truncated_stream() {
+  BinaryTraceBuilder builder;
+  builder.add_file(0, "a.c");
+  builder.add_event(0x1000, 0, 4, 0, 1, 1);
+
+  // Chop the last event record short - parser must stop cleanly
+  std::string truncated = builder.data().substr(0, builder.data().size() - 10);
+
+  std::vector<TraceEvent> events;
+  size_t n = parse_binary_trace(truncated.data(), truncated.size(),
+                                [&](TraceEvent e) { events.push_back(e); });
+
+  assert(n == 0);
+  assert(events.empty());
+
+  std::cout << "[PASS] test_truncated_stream\n";
+}
+
+void test_compact_delta_decode() {
+  BinaryTraceBuilder builder;
+  builder.add_file(0, "main.c").add_file(1, "util.c");
+
+  // Forward stride, repeated fields, a backward jump, a thread switch,
+  // and a fixed 'E' record in the middle (which must not disturb deltas)
+  builder.add_compact(0x1000, false, 8, 0, 10, 1);
+  size_t before = builder.data().size();
+  builder.add_compact(0x1040, false, 8, 0, 10, 1);
+  // Steady state: opcode byte + 2-byte varint for a 64-byte stride delta
+  assert(builder.data().size() - before == 3);
+  builder.add_event(0x9000 | (1ULL << 60), 0, 32, 1, 5, 1); // vector load
+  builder.add_compact(0x0800, true, 4, 1, 20, 2);
+
+  std::vector<TraceEvent> events;
+  size_t n = parse_binary_trace(builder.data().data(), builder.data().size(),
+                                [&](TraceEvent e) { events.push_back(e); });
+
+  assert(n == 4);
+  assert(events[0].address == 0x1000 && !events[0].is_write);
+  assert(events[0].size == 8 && events[0].file == "main.c" &&
+         events[0].line == 10 && events[0].thread_id == 1);
+  assert(events[1].address == 0x1040 && events[1].size == 8);
+  assert(events[2].is_vector && events[2].address == 0x9000);
+  assert(events[3].address == 0x0800 && events[3].is_write);
+  assert(events[3].size == 4 && events[3].file == "util.c" &&
+         events[3].line == 20 && events[3].thread_id == 2);
+
+  std::cout << "[PASS] test_compact_delta_decode\n";
+}
+
+int main() {
+  std::cout << "Running BinaryTrace tests...\n\n";
+
+  test_magic_detection();
+  test_load_store_decode();
+  test_file_table_interleaving();
+  test_event_type_flags();
+  test_truncated_stream();
+  test_compact_delta_decode();
+
+  std::cout << "\n=== All 6 BinaryTrace tests passed! ===\n";
+  return 0;
+}
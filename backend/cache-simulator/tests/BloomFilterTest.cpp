@@ -0,0 +1,79 @@
+#include "../include/BloomFilter.hpp"
+#include <cassert>
+#include <iostream>
+
+void test_membership() {
+  BloomFilter filter(1000, 0.01);
+
+  for (uint64_t i = 0; i < 500; i++) {
+    assert(!filter.contains(i * 64));
+    filter.test_and_insert(i * 64);
+  }
+  // No false negatives, ever
+  for (uint64_t i = 0; i < 500; i++) {
+    assert(filter.contains(i * 64));
+  }
+
+  std::cout << "[PASS] test_membership\n";
+}
+
+void test_test_and_insert() {
+  BloomFilter filter(1000, 0.01);
+
+  assert(!filter.test_and_insert(0x7fff1000));
+  assert(filter.test_and_insert(0x7fff1000));
+  assert(!filter.test_and_insert(0x7fff1040));
+
+  std::cout << "[PASS] test_test_and_insert\n";
+}
+
+void test_false_positive_rate() {
+  const uint64_t n = 10000;
+  BloomFilter filter(n, 0.01);
+
+  for (uint64_t i = 0; i < n; i++) {
+    filter.test_and_insert(i * 64);
+  }
+
+  // Probe keys that were never inserted; hit rate should be near the target
+  uint64_t false_positives = 0;
+  const uint64_t probes = 100000;
+  for (uint64_t i = 0; i < probes; i++) {
+    if (filter.contains((n + i) * 64 + 0x100000000ULL))
+      false_positives++;
+  }
+  double observed = static_cast<double>(false_positives) / probes;
+  assert(observed < 0.03); // Target 1%, allow slack for variance
+
+  // The analytic estimate should agree with the configured target
+  assert(filter.estimated_fp_rate() > 0.0);
+  assert(filter.estimated_fp_rate() < 0.03);
+  assert(filter.memory_bytes() > 0);
+
+  std::cout << "[PASS] test_false_positive_rate\n";
+}
+
+void test_clear() {
+  BloomFilter filter(1000, 0.01);
+  filter.test_and_insert(0x1000);
+  assert(filter.contains(0x1000));
+
+  filter.clear();
+  assert(!filter.contains(0x1000));
+  assert(filter.estimated_fp_rate() == 0.0);
+  assert(filter.memory_bytes() == 0); // Storage released until next insert
+
+  std::cout << "[PASS] test_clear\n";
+}
+
+int main() {
+  std::cout << "Running BloomFilter tests...\n\n";
+
+  test_membership();
+  test_test_and_insert();
+  test_false_positive_rate();
+  test_clear();
+
+  std::cout << "\n=== All 4 BloomFilter tests passed! ===\n";
+  return 0;
+}
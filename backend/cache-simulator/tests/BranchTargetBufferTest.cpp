@@ -0,0 +1,171 @@
+#include "../include/BranchTargetBuffer.hpp"
+#include "../include/CacheSystem.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+void test_miss_then_hit_after_training() {
+  BranchTargetBuffer btb;
+
+  // First sight of a branch installs it; the second sight with the same
+  // target is a hit
+  assert(!btb.access(0x401000, 0x402000));
+  assert(btb.access(0x401000, 0x402000));
+  assert(btb.access(0x401000, 0x402000));
+
+  auto stats = btb.get_stats();
+  assert(stats.lookups == 3);
+  assert(stats.hits == 2);
+  assert(stats.misses() == 1);
+  assert(stats.target_mispredicts == 0);
+
+  std::cout << "[PASS] test_miss_then_hit_after_training\n";
+}
+
+void test_stale_target_retrains() {
+  BranchTargetBuffer btb;
+
+  // An indirect branch flipping between two targets: each flip is a
+  // target mispredict that retrains the entry in place
+  btb.access(0x401000, 0x402000);
+  assert(!btb.access(0x401000, 0x403000)); // stale
+  assert(btb.access(0x401000, 0x403000));  // retrained
+  assert(!btb.access(0x401000, 0x402000)); // stale again
+
+  auto stats = btb.get_stats();
+  assert(stats.lookups == 4);
+  assert(stats.hits == 1);
+  assert(stats.target_mispredicts == 2);
+
+  std::cout << "[PASS] test_stale_target_retrains\n";
+}
+
+void test_lru_eviction() {
+  // 2 entries, 2-way: a single set, so a third branch evicts the LRU one
+  BranchTargetBuffer btb(BTBConfig{.entries = 2, .associativity = 2});
+
+  btb.access(0x1000, 0xA000);
+  btb.access(0x2000, 0xB000);
+  btb.access(0x1000, 0xA000); // touch 0x1000, making 0x2000 the LRU way
+  btb.access(0x3000, 0xC000); // evicts 0x2000
+
+  assert(btb.access(0x1000, 0xA000)); // survived
+  assert(btb.access(0x3000, 0xC000)); // just installed
+  assert(!btb.access(0x2000, 0xB000)); // was evicted
+
+  std::cout << "[PASS] test_lru_eviction\n";
+}
+
+void test_flush_and_reset() {
+  BranchTargetBuffer btb;
+  btb.access(0x1000, 0x2000);
+  btb.access(0x1000, 0x2000);
+
+  btb.flush();
+  assert(!btb.access(0x1000, 0x2000)); // contents gone, stats kept
+  assert(btb.get_stats().lookups == 3);
+
+  btb.reset_stats();
+  assert(btb.get_stats().lookups == 0);
+  assert(btb.access(0x1000, 0x2000)); // contents kept, stats gone
+
+  std::cout << "[PASS] test_flush_and_reset\n";
+}
+
+// ========== CacheSystem front-end integration ==========
+
+void test_sequential_fetches_bypass_btb() {
+  CacheSystem cache(make_educational_config());
+
+  // A straight-line fetch stream - each line continues the previous one -
+  // never consults the BTB
+  for (uint64_t addr = 0x400000; addr < 0x400400; addr += 64) {
+    cache.fetch(addr);
+  }
+
+  assert(cache.get_btb_stats().lookups == 0);
+  std::cout << "[PASS] test_sequential_fetches_bypass_btb\n";
+}
+
+void test_loop_back_edge_hits_after_first_iteration() {
+  CacheSystem cache(make_educational_config());
+
+  // A two-block loop body: the jump from the tail back to the head is the
+  // only discontinuity, and it repeats with the same target every
+  // iteration - one BTB miss on the first back edge, hits thereafter
+  for (int iter = 0; iter < 10; iter++) {
+    cache.fetch(0x400000); // loop head
+    cache.fetch(0x400040); // falls through
+  }
+
+  auto stats = cache.get_btb_stats();
+  assert(stats.lookups == 9); // back edges only; the first fetch is cold
+  assert(stats.hits == 8);
+  assert(stats.misses() == 1);
+  assert(stats.target_mispredicts == 0);
+
+  std::cout << "[PASS] test_loop_back_edge_hits_after_first_iteration\n";
+}
+
+void test_alternating_targets_mispredict() {
+  CacheSystem cache(make_educational_config());
+
+  // A branch at the end of the head block alternating between two arms:
+  // the return to the head trains, but the head's outgoing target flips
+  // every iteration
+  for (int iter = 0; iter < 8; iter++) {
+    cache.fetch(0x400000);                              // head
+    cache.fetch(iter % 2 == 0 ? 0x500000 : 0x600000);   // then-arm / else-arm
+  }
+
+  auto stats = cache.get_btb_stats();
+  // Head->arm flips target each iteration: 2 cold misses then mispredicts
+  assert(stats.target_mispredicts >= 5);
+  // Arm->head edges are stable and hit once trained
+  assert(stats.hits >= 5);
+
+  std::cout << "[PASS] test_alternating_targets_mispredict\n";
+}
+
+void test_checkpoint_roundtrip_preserves_btb() {
+  CacheSystem a(make_educational_config());
+  for (int iter = 0; iter < 5; iter++) {
+    a.fetch(0x400000);
+    a.fetch(0x400040);
+  }
+
+  std::stringstream snapshot;
+  CheckpointWriter w(snapshot);
+  a.save_state(w);
+  assert(w.ok());
+
+  CacheSystem b(make_educational_config());
+  CheckpointReader r(snapshot);
+  b.load_state(r);
+
+  assert(a.get_btb_stats() == b.get_btb_stats());
+
+  // The restored BTB is warm: the next back edge hits without retraining
+  b.fetch(0x400000);
+  b.fetch(0x400040);
+  assert(b.get_btb_stats().hits == a.get_btb_stats().hits + 1);
+
+  std::cout << "[PASS] test_checkpoint_roundtrip_preserves_btb\n";
+}
+
+int main() {
+  std::cout << "Running BranchTargetBuffer tests...\n\n";
+
+  test_miss_then_hit_after_training();
+  test_stale_target_retrains();
+  test_lru_eviction();
+  test_flush_and_reset();
+  test_sequential_fetches_bypass_btb();
+  test_loop_back_edge_hits_after_first_iteration();
+  test_alternating_targets_mispredict();
+  test_checkpoint_roundtrip_preserves_btb();
+
+  std::cout << "\nAll BranchTargetBuffer tests passed!\n";
+  return 0;
+}
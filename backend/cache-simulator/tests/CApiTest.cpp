@@ -0,0 +1,137 @@
+#include "../include/cachesim.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+// Build a load/store event at the given address
+cachesim_event_t make_event(uint64_t addr, int is_write = 0,
+                            const char *file = nullptr, uint32_t line = 0) {
+  cachesim_event_t event = {};
+  event.address = addr;
+  event.size = 4;
+  event.thread_id = 0;
+  event.is_write = static_cast<uint8_t>(is_write);
+  event.file = file;
+  event.line = line;
+  return event;
+}
+
+// Test 1: create/feed/stats round trip on a single core
+void test_single_core_stats() {
+  cachesim_t *sim = cachesim_create("educational");
+  assert(sim != nullptr);
+
+  cachesim_event_t events[3] = {
+      make_event(0x1000),          // cold miss
+      make_event(0x1000),          // hit
+      make_event(0x1000, 1),       // write hit
+  };
+  cachesim_process(sim, events, 3);
+
+  cachesim_stats_t stats;
+  cachesim_get_stats(sim, &stats);
+  assert(stats.events == 3);
+  assert(stats.l1d.hits == 2);
+  assert(stats.l1d.misses == 1);
+  assert(stats.l1d.compulsory_misses == 1);
+  assert(stats.total_cycles > 0);
+  assert(stats.dtlb_hits + stats.dtlb_misses == 3);
+
+  cachesim_destroy(sim);
+  std::cout << "[PASS] test_single_core_stats\n";
+}
+
+// Test 2: hot lines come back with usable C strings
+void test_hot_lines() {
+  cachesim_t *sim = cachesim_create("educational");
+  for (int i = 0; i < 10; i++) {
+    // A fresh line each time so kernel.c:42 accumulates misses
+    cachesim_event_t e = make_event(0x100000 + i * 4096, 0, "kernel.c", 42);
+    cachesim_process(sim, &e, 1);
+  }
+
+  cachesim_hot_line_t lines[4];
+  size_t n = cachesim_get_hot_lines(sim, lines, 4);
+  assert(n == 1);
+  assert(std::strcmp(lines[0].file, "kernel.c") == 0);
+  assert(lines[0].line == 42);
+  assert(lines[0].misses == 10);
+
+  cachesim_destroy(sim);
+  std::cout << "[PASS] test_hot_lines\n";
+}
+
+// Test 3: multi-core handle routes threads to cores and sees coherence
+void test_multicore_coherence() {
+  cachesim_t *sim = cachesim_create_multicore("educational", 2);
+  assert(sim != nullptr);
+
+  // Two threads ping-pong writes to one line: invalidations must show up
+  for (int i = 0; i < 8; i++) {
+    cachesim_event_t e = make_event(0x2000, 1);
+    e.thread_id = static_cast<uint32_t>(i % 2);
+    cachesim_process(sim, &e, 1);
+  }
+
+  cachesim_stats_t stats;
+  cachesim_get_stats(sim, &stats);
+  assert(stats.events == 8);
+  assert(stats.l1d.hits + stats.l1d.misses == 8);
+  assert(stats.coherence_invalidations > 0);
+
+  cachesim_destroy(sim);
+  std::cout << "[PASS] test_multicore_coherence\n";
+}
+
+// Test 4: reset clears counters and cache contents
+void test_reset() {
+  cachesim_t *sim = cachesim_create("educational");
+  cachesim_event_t e = make_event(0x3000);
+  cachesim_process(sim, &e, 1);
+
+  cachesim_reset(sim);
+  cachesim_stats_t stats;
+  cachesim_get_stats(sim, &stats);
+  assert(stats.events == 0);
+  assert(stats.l1d.hits + stats.l1d.misses == 0);
+
+  // Contents were dropped too: the line misses again
+  cachesim_process(sim, &e, 1);
+  cachesim_get_stats(sim, &stats);
+  assert(stats.l1d.misses == 1);
+
+  cachesim_destroy(sim);
+  std::cout << "[PASS] test_reset\n";
+}
+
+// Test 5: argument validation across the API surface
+void test_argument_validation() {
+  assert(cachesim_create_multicore("educational", 0) == nullptr);
+
+  cachesim_t *sim = cachesim_create("educational");
+  assert(cachesim_set_prefetching(sim, "no-such-policy", 2) == -1);
+  assert(cachesim_set_prefetching(sim, "stream", 2) == 0);
+  assert(cachesim_set_prefetching(sim, "none", 2) == 0);
+
+  // NULL-tolerant entry points must not crash
+  cachesim_process(sim, nullptr, 5);
+  cachesim_get_stats(nullptr, nullptr);
+  cachesim_destroy(nullptr);
+
+  assert(cachesim_version() != nullptr);
+  cachesim_destroy(sim);
+  std::cout << "[PASS] test_argument_validation\n";
+}
+
+int main() {
+  std::cout << "=== C API (libcachesim) Tests ===\n\n";
+
+  test_single_core_stats();
+  test_hot_lines();
+  test_multicore_coherence();
+  test_reset();
+  test_argument_validation();
+
+  std::cout << "\n=== All C API Tests Passed! ===\n";
+  return 0;
+}
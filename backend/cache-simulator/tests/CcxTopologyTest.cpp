@@ -0,0 +1,149 @@
+#include "../include/MultiCoreCacheSystem.hpp"
+#include "../profiles/CacheConfig.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+
+// Small caches so evictions are easy to force. 8 cores / 4 per CCX:
+// cores 0-3 share slice 0, cores 4-7 share slice 1.
+CacheConfig make_ccx_l1_config() {
+  return {.kb_size = 1, .associativity = 2, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_ccx_l2_config() {
+  return {.kb_size = 4, .associativity = 4, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_ccx_l3_config() {
+  return {.kb_size = 16, .associativity = 8, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+// Evict line 0x0 from core 0's L1 and the shared L2 (but not slice 0's
+// L3) by touching conflicting lines: multiples of 0x400 share L2 set 0
+void evict_from_l1_and_l2(MultiCoreCacheSystem &cache, uint32_t thread_id) {
+  for (uint64_t i = 1; i <= 5; i++) {
+    cache.read(i * 0x400, thread_id);
+  }
+}
+
+// Test 1: enabling CCX topology slices the L3 per core complex
+void test_ccx_slices_created() {
+  MultiCoreCacheSystem cache(8, make_ccx_l1_config(), make_ccx_l2_config(),
+                             make_ccx_l3_config());
+  assert(!cache.is_ccx_enabled());
+  assert(cache.get_num_l3_slices() == 0);
+
+  cache.enable_ccx_topology(4);
+  assert(cache.is_ccx_enabled());
+  assert(cache.get_num_l3_slices() == 2);
+
+  std::cout << "[PASS] test_ccx_slices_created\n";
+}
+
+// Test 2: threads spread breadth-first across CCXes, not packed into one
+void test_threads_spread_across_ccxes() {
+  MultiCoreCacheSystem cache(8, make_ccx_l1_config(), make_ccx_l2_config(),
+                             make_ccx_l3_config());
+  cache.enable_ccx_topology(4);
+
+  // First two threads should land on different CCXes (cores 0 and 4),
+  // so their L1 traffic shows up on those cores only
+  cache.read(0x0000, 0);
+  cache.read(0x1000, 1);
+
+  auto stats = cache.get_stats();
+  assert(stats.l1_per_core[0].total_accesses() == 1);
+  assert(stats.l1_per_core[4].total_accesses() == 1);
+  for (int core : {1, 2, 3, 5, 6, 7}) {
+    assert(stats.l1_per_core[core].total_accesses() == 0);
+  }
+
+  std::cout << "[PASS] test_threads_spread_across_ccxes\n";
+}
+
+// Test 3: a core missing its own slice goes to memory - it never hits a
+// line that only a neighbor CCX's slice holds
+void test_ccx_miss_goes_to_memory_not_neighbor() {
+  MultiCoreCacheSystem cache(8, make_ccx_l1_config(), make_ccx_l2_config(),
+                             make_ccx_l3_config());
+  cache.enable_ccx_topology(4);
+
+  // Thread 0 (CCX 0) pulls 0x0 into slice 0, then loses it from L1/L2
+  cache.read(0x0000, 0);
+  evict_from_l1_and_l2(cache, 0);
+
+  // Thread 1 (core 4, CCX 1) misses everywhere: slice 1 is cold and
+  // slice 0 is not probed
+  auto result = cache.read(0x0000, 1);
+  assert(!result.l1_hit && !result.l2_hit && !result.l3_hit);
+  assert(result.memory_access);
+
+  std::cout << "[PASS] test_ccx_miss_goes_to_memory_not_neighbor\n";
+}
+
+// Test 4: the same re-read from the owning CCX hits its own slice
+void test_own_ccx_slice_hits() {
+  MultiCoreCacheSystem cache(8, make_ccx_l1_config(), make_ccx_l2_config(),
+                             make_ccx_l3_config());
+  cache.enable_ccx_topology(4);
+
+  cache.read(0x0000, 0);
+  evict_from_l1_and_l2(cache, 0);
+
+  auto result = cache.read(0x0000, 0);
+  assert(!result.l1_hit && !result.l2_hit);
+  assert(result.l3_hit);
+  assert(!result.memory_access);
+
+  std::cout << "[PASS] test_own_ccx_slice_hits\n";
+}
+
+// Test 5: invalid CCX sizes leave the L3 monolithic
+void test_ccx_requires_dividing_cores() {
+  MultiCoreCacheSystem cache(8, make_ccx_l1_config(), make_ccx_l2_config(),
+                             make_ccx_l3_config());
+
+  cache.enable_ccx_topology(3);  // 3 doesn't divide 8
+  assert(!cache.is_ccx_enabled());
+
+  cache.enable_ccx_topology(8);  // one CCX spanning every core = shared L3
+  assert(!cache.is_ccx_enabled());
+  assert(cache.get_num_l3_slices() == 0);
+
+  std::cout << "[PASS] test_ccx_requires_dividing_cores\n";
+}
+
+// Test 6: the AMD presets declare their CCX geometry
+void test_amd_presets_declare_ccx() {
+  assert(make_amd_zen4_config().cores_per_ccx == 8);
+  assert(make_amd_zen3_config().cores_per_ccx == 8);
+  assert(make_amd_zen2_config().cores_per_ccx == 4);
+  assert(make_amd_epyc_config().cores_per_ccx == 8);
+  assert(make_amd_epyc_genoa_config().cores_per_ccx == 8);
+
+  // EPYC now quotes the per-CCX slice, not the full-socket total
+  assert(make_amd_epyc_config().l3.kb_size == 32768);
+
+  // Intel keeps its monolithic (or NUMA-sliced) L3
+  assert(make_intel_12th_gen_config().cores_per_ccx == 0);
+  assert(make_intel_xeon_config().cores_per_ccx == 0);
+
+  std::cout << "[PASS] test_amd_presets_declare_ccx\n";
+}
+
+int main() {
+  std::cout << "=== CCX Topology Tests ===\n\n";
+
+  test_ccx_slices_created();
+  test_threads_spread_across_ccxes();
+  test_ccx_miss_goes_to_memory_not_neighbor();
+  test_own_ccx_slice_hits();
+  test_ccx_requires_dividing_cores();
+  test_amd_presets_declare_ccx();
+
+  std::cout << "\n=== All CCX Topology Tests Passed! ===\n";
+  return 0;
+}
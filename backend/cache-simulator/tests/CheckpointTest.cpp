@@ -0,0 +1,143 @@
+#include "../include/TraceProcessor.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Build a load/store event at the given address
+TraceEvent make_event(uint64_t addr, bool is_write = false) {
+  TraceEvent event;
+  event.address = addr;
+  event.size = 4;
+  event.is_write = is_write;
+  event.file = "test.c";
+  event.line = 1;
+  return event;
+}
+
+// Feed a mixed read/write stride pattern - enough to dirty lines, cause
+// evictions and exercise the TLB and timing model
+void feed_pattern(TraceProcessor &processor, size_t start, size_t count) {
+  for (size_t i = start; i < start + count; i++) {
+    uint64_t addr = 0x100000 + (i % 512) * 64 + (i * 4096);
+    processor.process(make_event(addr, i % 3 == 0));
+  }
+}
+
+// Test 1: save/load round-trips every accumulated stat
+void test_roundtrip_preserves_stats() {
+  TraceProcessor a(make_educational_config());
+  feed_pattern(a, 0, 500);
+
+  std::stringstream snapshot;
+  a.save_checkpoint(snapshot, 500);
+
+  TraceProcessor b(make_educational_config());
+  uint64_t offset = b.load_checkpoint(snapshot);
+  assert(offset == 500);
+
+  auto sa = a.get_stats();
+  auto sb = b.get_stats();
+  assert(sa.l1d == sb.l1d);
+  assert(sa.l1i == sb.l1i);
+  assert(sa.l2 == sb.l2);
+  assert(sa.l3 == sb.l3);
+  assert(sa.timing == sb.timing);
+  assert(a.get_cache_system().get_tlb_stats().dtlb ==
+         b.get_cache_system().get_tlb_stats().dtlb);
+  std::cout << "[PASS] test_roundtrip_preserves_stats\n";
+}
+
+// Test 2: restored caches are warm - a line resident at save time hits
+// after the restore
+void test_restore_preserves_warm_lines() {
+  TraceProcessor a(make_educational_config());
+  a.process(make_event(0x4000)); // miss, line now resident
+
+  std::stringstream snapshot;
+  a.save_checkpoint(snapshot, 1);
+
+  TraceProcessor b(make_educational_config());
+  (void)b.load_checkpoint(snapshot);
+  b.process(make_event(0x4000));
+
+  auto stats = b.get_stats();
+  assert(stats.l1d.hits == 1);
+  assert(stats.l1d.misses == 1); // the pre-snapshot miss carried over
+  std::cout << "[PASS] test_restore_preserves_warm_lines\n";
+}
+
+// Test 3: checkpoint mid-run, resume in a fresh processor, and the final
+// stats match an uninterrupted run exactly
+void test_split_run_matches_uninterrupted() {
+  TraceProcessor full(make_educational_config());
+  feed_pattern(full, 0, 2000);
+
+  TraceProcessor first_half(make_educational_config());
+  feed_pattern(first_half, 0, 1000);
+  std::stringstream snapshot;
+  first_half.save_checkpoint(snapshot, 1000);
+
+  TraceProcessor second_half(make_educational_config());
+  uint64_t offset = second_half.load_checkpoint(snapshot);
+  feed_pattern(second_half, offset, 1000);
+
+  auto sf = full.get_stats();
+  auto sr = second_half.get_stats();
+  assert(sf.l1d == sr.l1d);
+  assert(sf.l1i == sr.l1i);
+  assert(sf.l2 == sr.l2);
+  assert(sf.l3 == sr.l3);
+  assert(sf.timing == sr.timing);
+  assert(full.get_cache_system().get_tlb_stats().dtlb ==
+         second_half.get_cache_system().get_tlb_stats().dtlb);
+  std::cout << "[PASS] test_split_run_matches_uninterrupted\n";
+}
+
+// Test 4: garbage input is rejected, not silently loaded
+void test_rejects_bad_magic() {
+  std::stringstream bogus("this is not a checkpoint at all");
+  TraceProcessor processor(make_educational_config());
+  bool threw = false;
+  try {
+    (void)processor.load_checkpoint(bogus);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "[PASS] test_rejects_bad_magic\n";
+}
+
+// Test 5: restoring under a different hardware preset fails loudly
+// instead of corrupting the simulation
+void test_rejects_config_mismatch() {
+  TraceProcessor a(make_educational_config());
+  feed_pattern(a, 0, 100);
+  std::stringstream snapshot;
+  a.save_checkpoint(snapshot, 100);
+
+  TraceProcessor b(make_intel_12th_gen_config());
+  bool threw = false;
+  try {
+    (void)b.load_checkpoint(snapshot);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "[PASS] test_rejects_config_mismatch\n";
+}
+
+int main() {
+  std::cout << "=== Checkpoint Tests ===\n\n";
+
+  test_roundtrip_preserves_stats();
+  test_restore_preserves_warm_lines();
+  test_split_run_matches_uninterrupted();
+  test_rejects_bad_magic();
+  test_rejects_config_mismatch();
+
+  std::cout << "\n=== All Checkpoint Tests Passed! ===\n";
+  return 0;
+}
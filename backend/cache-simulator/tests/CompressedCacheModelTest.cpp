@@ -0,0 +1,188 @@
+#include "../include/CompressedCacheModel.hpp"
+#include "../include/CacheSystem.hpp"
+#include "../include/TraceEvent.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+// Tiny L3 for testing: 4KB, 4-way, 64B lines = 16 sets, 4 lines of data
+// budget per set. With tag_factor 2 the model has 8 tags per set.
+static CacheConfig tiny_l3() {
+  return CacheConfig{4, 4, 64};
+}
+
+void test_bdi_class_sizes() {
+  assert(bdi_class_bytes(BDI_ZEROS, 64) == 8);
+  assert(bdi_class_bytes(BDI_REPEATED, 64) == 16);
+  assert(bdi_class_bytes(BDI_BASE_DELTA, 64) == 24);
+  assert(bdi_class_bytes(BDI_UNCOMPRESSED, 64) == 64);
+
+  std::cout << "[PASS] test_bdi_class_sizes\n";
+}
+
+void test_miss_then_hit() {
+  TraceCompressHints::instance().clear();
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+
+  assert(!model.access(0x1000));
+  assert(model.access(0x1000));
+  assert(model.access(0x1020)); // same 64B line
+
+  auto stats = model.get_stats();
+  assert(stats.lookups == 3);
+  assert(stats.hits == 2);
+  assert(stats.installs == 1);
+
+  std::cout << "[PASS] test_miss_then_hit\n";
+}
+
+void test_incompressible_matches_physical_capacity() {
+  TraceCompressHints::instance().clear();
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+
+  // Without any hints the model assumes uncompressed lines, so a set
+  // holds exactly the physical 4 lines despite having 8 tags. Five
+  // distinct lines in one set (stride = 16 sets x 64B) evict the LRU.
+  for (uint64_t i = 0; i < 5; i++) {
+    assert(!model.access(i * 1024));
+  }
+  assert(!model.access(0)); // line 0 was the LRU victim
+
+  std::cout << "[PASS] test_incompressible_matches_physical_capacity\n";
+}
+
+void test_compressible_lines_expand_capacity() {
+  TraceCompressHints::instance().clear();
+  // All-zero lines compress to 8B: all 8 tags of a set fit in 64 of the
+  // 256 budget bytes, doubling effective capacity
+  for (uint64_t i = 0; i < 8; i++) {
+    TraceCompressHints::instance().register_hint(i * 1024, BDI_ZEROS);
+  }
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+
+  for (uint64_t i = 0; i < 8; i++) {
+    assert(!model.access(i * 1024));
+  }
+  for (uint64_t i = 0; i < 8; i++) {
+    assert(model.access(i * 1024)); // all still resident
+  }
+
+  auto stats = model.get_stats();
+  assert(stats.installs == 8);
+  assert(stats.hinted_installs == 8);
+  assert(model.hint_coverage() == 1.0);
+  assert(model.avg_compression_ratio() == 8.0); // 64B lines in 8B each
+  assert(model.get_class_counts()[BDI_ZEROS] == 8);
+
+  TraceCompressHints::instance().clear();
+  std::cout << "[PASS] test_compressible_lines_expand_capacity\n";
+}
+
+void test_unhinted_lines_use_sampled_average() {
+  TraceCompressHints::instance().clear();
+  // Sample says everything seen so far is all-zero; unhinted lines
+  // should take the 8B average rather than pessimistic 64B
+  TraceCompressHints::instance().register_hint(0x100000, BDI_ZEROS);
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+
+  for (uint64_t i = 0; i < 8; i++) {
+    assert(!model.access(i * 1024));
+  }
+  for (uint64_t i = 0; i < 8; i++) {
+    assert(model.access(i * 1024));
+  }
+  assert(model.get_stats().hinted_installs == 0);
+
+  TraceCompressHints::instance().clear();
+  std::cout << "[PASS] test_unhinted_lines_use_sampled_average\n";
+}
+
+void test_hints_refresh_mid_run() {
+  TraceCompressHints::instance().clear();
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+
+  assert(!model.access(0x1000)); // installs at 64B (no hints yet)
+
+  // A hint arriving mid-run is picked up on the next access
+  TraceCompressHints::instance().register_hint(0x2000, BDI_REPEATED);
+  assert(!model.access(0x2000));
+  assert(model.get_stats().hinted_installs == 1);
+
+  TraceCompressHints::instance().clear();
+  std::cout << "[PASS] test_hints_refresh_mid_run\n";
+}
+
+void test_parse_y_records() {
+  TraceCompressHints::instance().clear();
+
+  // Y records carry no event but register a hint
+  assert(!parse_trace_event("Y 0x7fff1200 2").has_value());
+  assert(!parse_trace_event("Y 0x5000 0").has_value());
+
+  auto hints = TraceCompressHints::instance().snapshot();
+  assert(hints.size() == 2);
+  assert(hints[0].first == 0x7fff1200 && hints[0].second == BDI_BASE_DELTA);
+  assert(hints[1].first == 0x5000 && hints[1].second == BDI_ZEROS);
+
+  TraceCompressHints::instance().clear();
+  std::cout << "[PASS] test_parse_y_records\n";
+}
+
+void test_checkpoint_roundtrip() {
+  TraceCompressHints::instance().clear();
+  CompressedCacheModel model(tiny_l3(), CompressionConfig{true, 2});
+  model.access(0x1000);
+  model.access(0x1000);
+  model.access(0x2000);
+
+  std::stringstream buf;
+  CheckpointWriter w(buf);
+  model.save_state(w);
+
+  CompressedCacheModel restored(tiny_l3(), CompressionConfig{true, 2});
+  CheckpointReader r(buf);
+  restored.load_state(r);
+
+  assert(restored.get_stats().lookups == 3);
+  assert(restored.get_stats().hits == 1);
+  assert(restored.get_stats().installs == 2);
+  assert(restored.access(0x1000)); // contents survived the roundtrip
+
+  std::cout << "[PASS] test_checkpoint_roundtrip\n";
+}
+
+void test_cache_system_shadow() {
+  TraceCompressHints::instance().clear();
+  CacheSystem system(make_educational_config());
+  system.enable_l3_compression(CompressionConfig{true, 2});
+  assert(system.has_l3_compression());
+
+  // Misses that reach the L3 feed the shadow; L1 hits don't
+  system.read(0x10000);
+  system.read(0x10000);
+  const auto &model = system.get_l3_compression();
+  assert(model.get_stats().lookups == 1);
+
+  system.reset_stats();
+  assert(model.get_stats().lookups == 0);
+
+  std::cout << "[PASS] test_cache_system_shadow\n";
+}
+
+int main() {
+  std::cout << "=== CompressedCacheModel Tests ===\n\n";
+
+  test_bdi_class_sizes();
+  test_miss_then_hit();
+  test_incompressible_matches_physical_capacity();
+  test_compressible_lines_expand_capacity();
+  test_unhinted_lines_use_sampled_average();
+  test_hints_refresh_mid_run();
+  test_parse_y_records();
+  test_checkpoint_roundtrip();
+  test_cache_system_shadow();
+
+  std::cout << "\n=== All 9 CompressedCacheModel tests passed! ===\n";
+  return 0;
+}
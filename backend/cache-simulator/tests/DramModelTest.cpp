@@ -0,0 +1,124 @@
+#include "../include/CacheSystem.hpp"
+#include "../include/DramModel.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+
+namespace {
+DramConfig small_dram() {
+  // One channel, four banks, 4KB rows: 64 lines per row
+  return {.channels = 1,
+          .banks = 4,
+          .row_size = 4096,
+          .row_hit = 50,
+          .row_empty = 100,
+          .row_conflict = 150};
+}
+}  // namespace
+
+void test_streaming_hits_row_buffer() {
+  DramModel dram(small_dram());
+  TimingStats timing;
+
+  // One full row of sequential lines: the first access activates the
+  // row, every following line rides the open row buffer
+  for (uint64_t line = 0; line < 64; line++) {
+    dram.access(line * 64, timing);
+  }
+
+  assert(timing.dram_row_empty == 1);
+  assert(timing.dram_row_hits == 63);
+  assert(timing.dram_row_conflicts == 0);
+  assert(timing.dram_cycles == 100 + 63 * 50);
+
+  std::cout << "[PASS] test_streaming_hits_row_buffer\n";
+}
+
+void test_alternating_rows_conflict() {
+  DramModel dram(small_dram());
+  TimingStats timing;
+
+  // Lines 0 and 1024 map to bank 0 but different rows: ping-ponging
+  // between them precharges on every access after the first
+  for (int i = 0; i < 10; i++) {
+    dram.access(0, timing);
+    dram.access(1024 * 64, timing);
+  }
+
+  assert(timing.dram_row_empty == 1);
+  assert(timing.dram_row_conflicts == 19);
+  assert(timing.dram_row_hits == 0);
+
+  std::cout << "[PASS] test_alternating_rows_conflict\n";
+}
+
+void test_channel_interleaving() {
+  DramConfig cfg = small_dram();
+  cfg.channels = 2;
+  DramModel dram(cfg);
+  TimingStats timing;
+
+  // Consecutive lines alternate channels, so a linear stream keeps one
+  // row open per channel: one activate each, hits after that
+  for (uint64_t line = 0; line < 64; line++) {
+    dram.access(line * 64, timing);
+  }
+
+  assert(timing.dram_row_empty == 2);
+  assert(timing.dram_row_hits == 62);
+  assert(timing.dram_row_conflicts == 0);
+
+  std::cout << "[PASS] test_channel_interleaving\n";
+}
+
+void test_clear_closes_rows() {
+  DramModel dram(small_dram());
+  TimingStats timing;
+
+  dram.access(0, timing);
+  dram.access(0, timing);
+  assert(timing.dram_row_hits == 1);
+
+  dram.clear();
+  TimingStats fresh;
+  dram.access(0, fresh);
+  assert(fresh.dram_row_empty == 1);
+  assert(fresh.dram_row_hits == 0);
+
+  std::cout << "[PASS] test_clear_closes_rows\n";
+}
+
+void test_cache_system_accounts_dram() {
+  // Streaming misses through the hierarchy reach the DRAM stage; the
+  // row-aware accounting fills in while total_cycles keeps charging the
+  // flat memory latency
+  CacheSystem cache(make_educational_config());
+
+  for (int i = 0; i < 512; i++) {
+    cache.read(0x100000 + static_cast<uint64_t>(i) * 4096);
+  }
+
+  const TimingStats &timing = cache.get_timing_stats();
+  uint64_t dram_accesses =
+      timing.dram_row_hits + timing.dram_row_empty + timing.dram_row_conflicts;
+  uint64_t memory_accesses =
+      timing.memory_cycles / cache.get_latency_config().memory;
+  assert(dram_accesses == memory_accesses);
+  assert(dram_accesses > 0);
+  assert(timing.dram_cycles > 0);
+
+  std::cout << "[PASS] test_cache_system_accounts_dram\n";
+}
+
+int main() {
+  std::cout << "Running DramModel tests...\n\n";
+
+  test_streaming_hits_row_buffer();
+  test_alternating_rows_conflict();
+  test_channel_interleaving();
+  test_clear_closes_rows();
+  test_cache_system_accounts_dram();
+
+  std::cout << "\nAll DramModel tests passed!\n";
+  return 0;
+}
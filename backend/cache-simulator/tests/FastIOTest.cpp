@@ -0,0 +1,237 @@
+#include "../include/FastIO.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void test_find_newline() {
+  // Newline at every position across SIMD chunk boundaries
+  for (size_t pos = 0; pos < 80; pos++) {
+    std::string buf(80, 'x');
+    buf[pos] = '\n';
+    const char *nl = find_newline(buf.data(), buf.data() + buf.size());
+    assert(nl == buf.data() + pos);
+  }
+
+  // No newline at all returns end
+  std::string flat(100, 'y');
+  assert(find_newline(flat.data(), flat.data() + flat.size()) ==
+         flat.data() + flat.size());
+
+  // First of several newlines wins
+  std::string multi = "abc\ndef\nghi";
+  assert(find_newline(multi.data(), multi.data() + multi.size()) ==
+         multi.data() + 3);
+
+  std::cout << "[PASS] test_find_newline\n";
+}
+
+void test_parse_hex_run() {
+  auto parse = [](const std::string &s) {
+    uint64_t value = 0;
+    const char *stop = parse_hex_run(s.data(), s.data() + s.size(), value);
+    return std::make_pair(value, static_cast<size_t>(stop - s.data()));
+  };
+
+  assert(parse("0").first == 0x0);
+  assert(parse("f").first == 0xf);
+  assert(parse("7fff1234").first == 0x7fff1234);
+  assert(parse("DEADbeef").first == 0xDEADBEEF);
+  assert(parse("ffffffffffffffff").first == 0xffffffffffffffffULL);
+
+  // Stops at the first non-hex character and reports the position
+  auto [value, consumed] = parse("1a2b 4 main.c:10");
+  assert(value == 0x1a2b);
+  assert(consumed == 4);
+
+  // A delimiter up front means nothing is consumed
+  assert(parse(" 123").second == 0);
+  assert(parse("g123").second == 0);
+
+  // Runs longer than one SIMD chunk keep accumulating like the scalar loop
+  auto [long_value, long_consumed] = parse("00000000000000001234");
+  assert(long_value == 0x1234);
+  assert(long_consumed == 20);
+
+  std::cout << "[PASS] test_parse_hex_run\n";
+}
+
+void test_parser_equivalence() {
+  // The SIMD fast path must agree with the reference parser on every field
+  std::vector<std::string> lines = {
+      "L 0x7fff12345678 4 main.c:10 T0",
+      "S 0x1000 8 kernel.c:42 T3",
+      "I 0x400000 16",
+      "P1 0x2000 64 prefetch.c:7 T1",
+      "V 0x3000 32 simd.c:99 T0",
+      "A 0x4000 4 atomic.c:12 T2",
+      "X 0x5000 8 atomic.c:13 T2",
+      "C 0x6000 8 atomic.c:14 T2",
+      "Z 0x7000 256 memset.c:5 T0",
+      "M 0x8000 0x9000 128 memcpy.c:8 T0",
+      "O 0xa000 0xb000 64 memmove.c:9 T1",
+      "L 0xDEADBEEF 4 UPPER.C:1 T0",
+      "L 0x10 1 T5",
+      "RL 0xc000 64 128 4 loop.c:5 T0",
+      "RS 0xd000 -8 32 8 loop.c:6 T2",
+      "VL 0xc100 0 8 4 gather.c:11 T0",
+      "VS 0xc200 7 8 4 gather.c:12 T1",
+      "L 0xe000 8 timed.c:3 T1 @123456789012",
+      "S 0xf000 4 T2 @42",
+  };
+
+  for (const auto &line : lines) {
+    auto slow = parse_trace_event(line);
+    auto fast = parse_trace_event_fast(line.data(), line.data() + line.size());
+    assert(slow.has_value());
+    assert(fast.has_value());
+    assert(fast->address == slow->address);
+    assert(fast->src_address == slow->src_address);
+    assert(fast->size == slow->size);
+    assert(fast->is_write == slow->is_write);
+    assert(fast->is_icache == slow->is_icache);
+    assert(fast->is_prefetch == slow->is_prefetch);
+    assert(fast->prefetch_hint == slow->prefetch_hint);
+    assert(fast->is_vector == slow->is_vector);
+    assert(fast->is_atomic == slow->is_atomic);
+    assert(fast->is_rmw == slow->is_rmw);
+    assert(fast->is_cmpxchg == slow->is_cmpxchg);
+    assert(fast->is_memcpy == slow->is_memcpy);
+    assert(fast->is_memset == slow->is_memset);
+    assert(fast->is_memmove == slow->is_memmove);
+    assert(fast->is_range == slow->is_range);
+    assert(fast->stride == slow->stride);
+    assert(fast->count == slow->count);
+    assert(fast->is_gather == slow->is_gather);
+    assert(fast->lane == slow->lane);
+    assert(fast->lanes == slow->lanes);
+    assert(fast->file == slow->file);
+    assert(fast->line == slow->line);
+    assert(fast->thread_id == slow->thread_id);
+  }
+
+  // Comments and garbage are rejected by both
+  assert(!parse_trace_event_fast("# comment", "# comment" + 9).has_value());
+  std::string bad = "Q 0x1000 4";
+  assert(!parse_trace_event_fast(bad.data(), bad.data() + bad.size())
+              .has_value());
+
+  std::cout << "[PASS] test_parser_equivalence\n";
+}
+
+void test_file_id_protocol() {
+  // Registration records bind numeric file ids; "12:10" locations
+  // resolve through them in both parsers and produce no event
+  std::string reg = "D 12 src/engine/hash.cpp";
+  assert(!parse_trace_event_fast(reg.data(), reg.data() + reg.size())
+              .has_value());
+  assert(!parse_trace_event("D 13 src/engine/table.cpp").has_value());
+
+  std::string by_id = "L 0x1000 4 12:10 T0";
+  auto fast = parse_trace_event_fast(by_id.data(), by_id.data() + by_id.size());
+  auto slow = parse_trace_event(by_id);
+  assert(fast.has_value() && slow.has_value());
+  assert(fast->file == "src/engine/hash.cpp");
+  assert(fast->line == 10);
+  assert(slow->file == fast->file);
+
+  std::string other = "S 0x2000 8 13:99 T1";
+  auto ev = parse_trace_event_fast(other.data(), other.data() + other.size());
+  assert(ev.has_value() && ev->file == "src/engine/table.cpp" && ev->line == 99);
+
+  // Re-registration rebinds (daemon jobs reuse the process)
+  std::string rebind = "D 12 src/engine/rehash.cpp";
+  parse_trace_event_fast(rebind.data(), rebind.data() + rebind.size());
+  ev = parse_trace_event_fast(by_id.data(), by_id.data() + by_id.size());
+  assert(ev.has_value() && ev->file == "src/engine/rehash.cpp");
+
+  // An unregistered all-digit file part stays a literal path
+  std::string literal = "L 0x3000 4 777:5 T0";
+  ev = parse_trace_event_fast(literal.data(), literal.data() + literal.size());
+  assert(ev.has_value() && ev->file == "777" && ev->line == 5);
+
+  TraceFileIds::instance().clear();
+  std::cout << "[PASS] test_file_id_protocol\n";
+}
+
+void test_sample_rate_record() {
+  // W records (adaptive sampling divisor) parse identically in both
+  // parsers and produce an ordered event, unlike the registrations
+  std::string rec = "W 64";
+  auto fast = parse_trace_event_fast(rec.data(), rec.data() + rec.size());
+  auto slow = parse_trace_event(rec);
+  assert(fast.has_value() && slow.has_value());
+  assert(fast->is_sample_rate && slow->is_sample_rate);
+  assert(fast->count == 64 && slow->count == 64);
+
+  // A zero divisor is malformed, not "no sampling"
+  std::string zero = "W 0";
+  assert(!parse_trace_event_fast(zero.data(), zero.data() + zero.size())
+              .has_value());
+  assert(!parse_trace_event("W 0").has_value());
+
+  std::cout << "[PASS] test_sample_rate_record\n";
+}
+
+void test_line_iteration() {
+  std::string buf = "L 0x1000 4\n\nL 0x2000 8\nL 0x3000 4"; // no trailing \n
+  size_t count = 0;
+  std::vector<std::string> seen;
+  for_each_line(buf, [&](const char *begin, const char *end) {
+    count++;
+    seen.emplace_back(begin, end);
+  });
+
+  // Empty lines are skipped; the unterminated last line is still delivered
+  assert(count == 3);
+  assert(seen[0] == "L 0x1000 4");
+  assert(seen[2] == "L 0x3000 4");
+
+  std::cout << "[PASS] test_line_iteration\n";
+}
+
+void test_zstd_roundtrip() {
+#ifdef CACHE_EXPLORER_HAVE_ZSTD
+  std::string trace;
+  for (int i = 0; i < 1000; i++) {
+    trace += "L 0x" + std::to_string(0x1000 + i * 64) + " 4 main.c:10 T0\n";
+  }
+
+  std::vector<char> packed(ZSTD_compressBound(trace.size()));
+  size_t packed_size = ZSTD_compress(packed.data(), packed.size(),
+                                     trace.data(), trace.size(), 3);
+  assert(!ZSTD_isError(packed_size));
+
+  assert(is_zstd_trace(packed.data(), packed_size));
+  assert(!is_zstd_trace(trace.data(), trace.size()));
+
+  std::string inflated;
+  assert(zstd_inflate(packed.data(), packed_size, inflated));
+  assert(inflated == trace);
+
+  // Truncated input is rejected, not silently accepted
+  std::string garbage;
+  assert(!zstd_inflate(packed.data(), packed_size / 2, garbage) ||
+         garbage.size() < trace.size());
+
+  std::cout << "[PASS] test_zstd_roundtrip\n";
+#else
+  std::cout << "[SKIP] test_zstd_roundtrip (built without zstd)\n";
+#endif
+}
+
+int main() {
+  std::cout << "Running FastIO tests...\n\n";
+
+  test_find_newline();
+  test_parse_hex_run();
+  test_parser_equivalence();
+  test_file_id_protocol();
+  test_sample_rate_record();
+  test_line_iteration();
+  test_zstd_roundtrip();
+
+  std::cout << "\n=== All 7 FastIO tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,193 @@
+#include "../include/FlatMap.hpp"
+#include "../include/SourceKey.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+void test_insert_and_find() {
+  FlatMap<uint64_t, uint64_t> map;
+
+  assert(map.empty());
+  assert(map.find(42) == map.end());
+
+  map[42] = 7;
+  assert(map.size() == 1);
+  auto it = map.find(42);
+  assert(it != map.end());
+  assert(it->second == 7);
+
+  // operator[] on an existing key returns the same slot
+  map[42]++;
+  assert(map.find(42)->second == 8);
+
+  std::cout << "[PASS] test_insert_and_find\n";
+}
+
+void test_emplace() {
+  FlatMap<uint64_t, std::string> map;
+
+  auto [it, inserted] = map.emplace(1, "one");
+  assert(inserted);
+  assert(it->second == "one");
+
+  // Second emplace with the same key is a no-op
+  auto [it2, inserted2] = map.emplace(1, "uno");
+  assert(!inserted2);
+  assert(it2->second == "one");
+  assert(map.size() == 1);
+
+  std::cout << "[PASS] test_emplace\n";
+}
+
+void test_growth_and_aligned_keys() {
+  // Cache-line addresses: low 6 bits always zero. The mixing hash must
+  // spread them so the table doesn't degrade to 1/64th occupancy.
+  FlatMap<uint64_t, uint64_t> map(16);
+
+  const uint64_t n = 20000;
+  for (uint64_t i = 0; i < n; i++) {
+    map[i * 64] = i;
+  }
+  assert(map.size() == n);
+  for (uint64_t i = 0; i < n; i++) {
+    auto it = map.find(i * 64);
+    assert(it != map.end());
+    assert(it->second == i);
+  }
+  assert(map.find(n * 64) == map.end());
+
+  std::cout << "[PASS] test_growth_and_aligned_keys\n";
+}
+
+void test_erase_and_reuse() {
+  FlatMap<uint64_t, uint64_t> map(16);
+
+  for (uint64_t i = 0; i < 8; i++) {
+    map[i * 64] = i;
+  }
+
+  // Erase through an iterator, like the line-tracker budget eviction does
+  auto it = map.find(3 * 64);
+  assert(it != map.end());
+  map.erase(it);
+  assert(map.size() == 7);
+  assert(map.count(3 * 64) == 0);
+
+  // Keys probing past the tombstone are still reachable
+  for (uint64_t i = 0; i < 8; i++) {
+    if (i != 3) {
+      assert(map.count(i * 64) == 1);
+    }
+  }
+
+  // Reinsert lands back in the table
+  map[3 * 64] = 33;
+  assert(map.size() == 8);
+  assert(map.find(3 * 64)->second == 33);
+
+  std::cout << "[PASS] test_erase_and_reuse\n";
+}
+
+void test_iteration() {
+  FlatMap<uint64_t, uint64_t> map;
+
+  uint64_t expected_sum = 0;
+  for (uint64_t i = 1; i <= 100; i++) {
+    map[i * 4096] = i;
+    expected_sum += i;
+  }
+
+  uint64_t sum = 0;
+  size_t seen = 0;
+  for (const auto &[key, value] : map) {
+    assert(key == value * 4096);
+    sum += value;
+    seen++;
+  }
+  assert(seen == 100);
+  assert(sum == expected_sum);
+
+  std::cout << "[PASS] test_iteration\n";
+}
+
+void test_clear_keeps_working() {
+  FlatMap<uint64_t, uint64_t> map;
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+  map.clear();
+  assert(map.empty());
+  assert(map.find(5) == map.end());
+
+  // Reuse after clear: stale slot contents must not leak through
+  map[5] = 55;
+  assert(map.size() == 1);
+  assert(map.find(5)->second == 55);
+
+  std::cout << "[PASS] test_clear_keeps_working\n";
+}
+
+void test_source_key_map() {
+  FlatMap<SourceKey, uint64_t, SourceKeyHash> map;
+
+  map[SourceKey{"main.c", 10}] = 1;
+  map[SourceKey{"main.c", 20}] = 2;
+  map[SourceKey{"util.c", 10}] = 3;
+
+  assert(map.size() == 3);
+  assert(map.find(SourceKey{"main.c", 10})->second == 1);
+  assert(map.find(SourceKey{"util.c", 10})->second == 3);
+  assert(map.find(SourceKey{"util.c", 20}) == map.end());
+
+  std::cout << "[PASS] test_source_key_map\n";
+}
+
+void test_matches_unordered_map() {
+  // Randomized cross-check against the reference container
+  FlatMap<uint64_t, uint64_t> flat(16);
+  std::unordered_map<uint64_t, uint64_t> ref;
+
+  std::srand(17);
+  for (int i = 0; i < 50000; i++) {
+    uint64_t key = (uint64_t)(std::rand() % 2000) * 64;
+    if (std::rand() % 8 == 0) {
+      auto it = flat.find(key);
+      if (it != flat.end()) {
+        flat.erase(it);
+      }
+      ref.erase(key);
+    } else {
+      flat[key]++;
+      ref[key]++;
+    }
+  }
+
+  assert(flat.size() == ref.size());
+  for (const auto &[key, value] : ref) {
+    auto it = flat.find(key);
+    assert(it != flat.end());
+    assert(it->second == value);
+  }
+
+  std::cout << "[PASS] test_matches_unordered_map\n";
+}
+
+int main() {
+  std::cout << "Running FlatMap tests...\n\n";
+
+  test_insert_and_find();
+  test_emplace();
+  test_growth_and_aligned_keys();
+  test_erase_and_reuse();
+  test_iteration();
+  test_clear_keeps_working();
+  test_source_key_map();
+  test_matches_unordered_map();
+
+  std::cout << "\nAll FlatMap tests passed!\n";
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include "../include/HotLineTracker.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void test_exact_under_budget() {
+  // Fewer distinct lines than the budget: everything stays exact
+  HotLineTracker tracker(8);
+
+  for (int rep = 0; rep < 10; rep++) {
+    tracker.record("a.c", 1, true);
+    tracker.record("a.c", 1, false);
+    tracker.record("b.c", 2, true);
+  }
+  tracker.record("c.c", 3, false);  // hit-only line never promotes
+
+  assert(tracker.size() == 2);
+  auto top = tracker.top();
+  assert(top.size() == 2);
+  assert(top[0].file == "a.c" || top[0].misses == top[1].misses);
+  assert(top[0].misses == 10);
+  assert(top[1].misses == 10);
+  for (const auto &e : top) {
+    if (e.file == "a.c") {
+      assert(e.hits == 10);
+    }
+  }
+
+  std::cout << "[PASS] test_exact_under_budget\n";
+}
+
+void test_size_never_exceeds_budget() {
+  HotLineTracker tracker(4);
+
+  // Interned names must outlive the tracker (string_view keys)
+  std::vector<std::string> files;
+  for (int i = 0; i < 200; i++) {
+    files.push_back("f" + std::to_string(i) + ".c");
+  }
+  for (int i = 0; i < 200; i++) {
+    tracker.record(files[i], (uint32_t)i, true);
+  }
+
+  assert(tracker.size() <= 4);
+  assert(tracker.top().size() <= 4);
+
+  std::cout << "[PASS] test_size_never_exceeds_budget\n";
+}
+
+void test_hot_line_survives_cold_tail() {
+  // One genuinely hot line among many cold ones must be retained by a
+  // small budget, with its miss count at least the true value (count-min
+  // sketches only over-count)
+  HotLineTracker tracker(4);
+
+  std::vector<std::string> files;
+  for (int i = 0; i < 500; i++) {
+    files.push_back("cold" + std::to_string(i) + ".c");
+  }
+
+  const uint64_t hot_misses = 2000;
+  for (uint64_t i = 0; i < hot_misses; i++) {
+    tracker.record("hot.c", 42, true);
+    // Interleave cold lines, each missing once
+    if (i < 500) {
+      tracker.record(files[i], (uint32_t)i, true);
+    }
+  }
+
+  auto top = tracker.top(1);
+  assert(top.size() == 1);
+  assert(top[0].file == "hot.c");
+  assert(top[0].line == 42);
+  assert(top[0].misses >= hot_misses);
+
+  std::cout << "[PASS] test_hot_line_survives_cold_tail\n";
+}
+
+void test_comeback_resumes_count() {
+  // A line evicted and re-promoted should not lose its history: the
+  // sketch carries it, so its final count is at least the true total
+  HotLineTracker tracker(2);
+
+  std::vector<std::string> files;
+  for (int i = 0; i < 50; i++) {
+    files.push_back("x" + std::to_string(i) + ".c");
+  }
+
+  for (int i = 0; i < 100; i++) {
+    tracker.record("comeback.c", 7, true);
+  }
+  // Two hotter lines push it out
+  for (int i = 0; i < 300; i++) {
+    tracker.record("loud1.c", 1, true);
+    tracker.record("loud2.c", 2, true);
+  }
+  // It heats back up past the residents
+  for (int i = 0; i < 400; i++) {
+    tracker.record("comeback.c", 7, true);
+  }
+
+  auto top = tracker.top(1);
+  assert(top[0].file == "comeback.c");
+  assert(top[0].misses >= 500);
+
+  std::cout << "[PASS] test_comeback_resumes_count\n";
+}
+
+void test_thread_mask() {
+  HotLineTracker tracker(4);
+
+  tracker.record("mt.c", 5, true, 0);
+  tracker.record("mt.c", 5, true, 1);
+  tracker.record("mt.c", 5, false, 3);
+
+  auto top = tracker.top();
+  assert(top.size() == 1);
+  assert(top[0].thread_mask == ((1ULL << 0) | (1ULL << 1) | (1ULL << 3)));
+  assert(__builtin_popcountll(top[0].thread_mask) == 3);
+
+  std::cout << "[PASS] test_thread_mask\n";
+}
+
+void test_clear() {
+  HotLineTracker tracker(4);
+
+  for (int i = 0; i < 100; i++) {
+    tracker.record("a.c", 1, true);
+  }
+  tracker.clear();
+  assert(tracker.size() == 0);
+  assert(tracker.top().empty());
+
+  // Sketch counts must not survive the clear
+  tracker.record("a.c", 1, true);
+  auto top = tracker.top();
+  assert(top.size() == 1);
+  assert(top[0].misses == 1);
+
+  std::cout << "[PASS] test_clear\n";
+}
+
+int main() {
+  std::cout << "Running HotLineTracker tests...\n\n";
+
+  test_exact_under_budget();
+  test_size_never_exceeds_budget();
+  test_hot_line_survives_cold_tail();
+  test_comeback_resumes_count();
+  test_thread_mask();
+  test_clear();
+
+  std::cout << "\nAll HotLineTracker tests passed!\n";
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include "../include/IncrementalSim.hpp"
+#include "../include/TraceProcessor.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+// Build a load/store event at the given address
+static TraceEvent make_event(uint64_t addr, bool is_write = false) {
+  TraceEvent event;
+  event.address = addr;
+  event.size = 4;
+  event.is_write = is_write;
+  event.file = "test.c";
+  event.line = 1;
+  return event;
+}
+
+// Baseline-shaped stream: stride pattern over a few hundred lines
+static std::vector<TraceEvent> make_stream(size_t count) {
+  std::vector<TraceEvent> events;
+  events.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    events.push_back(make_event(0x100000 + (i % 512) * 64, i % 3 == 0));
+  }
+  return events;
+}
+
+void test_common_prefix() {
+  auto base = make_stream(100);
+  auto same = make_stream(100);
+  assert(common_trace_prefix(base, same) == 100);
+
+  // A "source edit" that changes one access site diverges the streams
+  auto edited = make_stream(100);
+  edited[60].address += 64;
+  assert(common_trace_prefix(base, edited) == 60);
+  edited[60] = base[60];
+  edited[60].line = 2;
+  assert(common_trace_prefix(base, edited) == 60);
+
+  // Different lengths: the shorter stream bounds the prefix
+  auto shorter = make_stream(40);
+  assert(common_trace_prefix(base, shorter) == 40);
+  assert(common_trace_prefix(std::vector<TraceEvent>{}, base) == 0);
+
+  std::cout << "[PASS] test_common_prefix\n";
+}
+
+void test_presentation_fields_dont_diverge() {
+  auto base = make_stream(10);
+  auto timed = make_stream(10);
+  // Capture timestamps wobble between runs but don't feed the simulation
+  for (auto &event : timed) {
+    event.timestamp = 12345;
+  }
+  assert(common_trace_prefix(base, timed) == 10);
+
+  std::cout << "[PASS] test_presentation_fields_dont_diverge\n";
+}
+
+void test_plan_picks_newest_snapshot_within_prefix() {
+  std::string dir = "/tmp/incremental-sim-test";
+  mkdir(dir.c_str(), 0755);
+  std::string base = dir + "/run.ckpt";
+  for (const char *suffix : {".100", ".200", ".300", ".junk", ""}) {
+    std::ofstream(base + suffix) << "x";
+  }
+
+  // Newest snapshot at or before the divergence wins
+  auto plan = plan_incremental(250, base);
+  assert(plan.resume_offset == 200);
+  assert(plan.checkpoint_path == base + ".200");
+
+  // Exact-offset snapshot is usable
+  plan = plan_incremental(300, base);
+  assert(plan.resume_offset == 300);
+
+  // Divergence before the first snapshot: nothing to reuse
+  plan = plan_incremental(99, base);
+  assert(plan.checkpoint_path.empty());
+  assert(plan.resume_offset == 0);
+
+  for (const char *suffix : {".100", ".200", ".300", ".junk", ""}) {
+    std::remove((base + suffix).c_str());
+  }
+  std::cout << "[PASS] test_plan_picks_newest_snapshot_within_prefix\n";
+}
+
+// The point of the feature: resuming from a baseline snapshot inside the
+// identical prefix gives stats bit-identical to simulating the new trace
+// in full
+void test_incremental_matches_full_simulation() {
+  auto baseline = make_stream(2000);
+  auto edited = make_stream(2000);
+  for (size_t i = 1500; i < 2000; i++) {
+    edited[i].address += 0x40000; // the diff's new access pattern
+  }
+  size_t prefix = common_trace_prefix(baseline, edited);
+  assert(prefix == 1500);
+
+  // Full re-simulation of the edited trace
+  TraceProcessor full(make_educational_config());
+  for (const auto &event : edited) {
+    full.process(event);
+  }
+
+  // Baseline run snapshots at event 1000 (inside the prefix)
+  TraceProcessor base_run(make_educational_config());
+  for (size_t i = 0; i < 1000; i++) {
+    base_run.process(baseline[i]);
+  }
+  std::stringstream snapshot;
+  base_run.save_checkpoint(snapshot, 1000);
+
+  // Incremental re-run: restore, then simulate only from the snapshot
+  TraceProcessor inc(make_educational_config());
+  uint64_t offset = inc.load_checkpoint(snapshot);
+  assert(offset == 1000);
+  for (size_t i = offset; i < edited.size(); i++) {
+    inc.process(edited[i]);
+  }
+
+  auto sf = full.get_stats();
+  auto si = inc.get_stats();
+  assert(sf.l1d == si.l1d);
+  assert(sf.l2 == si.l2);
+  assert(sf.l3 == si.l3);
+  assert(sf.timing == si.timing);
+
+  std::cout << "[PASS] test_incremental_matches_full_simulation\n";
+}
+
+int main() {
+  std::cout << "=== IncrementalSim Tests ===\n\n";
+
+  test_common_prefix();
+  test_presentation_fields_dont_diverge();
+  test_plan_picks_newest_snapshot_within_prefix();
+  test_incremental_matches_full_simulation();
+
+  std::cout << "\n=== All 4 IncrementalSim tests passed! ===\n";
+  return 0;
+}
@@ -98,9 +98,36 @@ void test_write_timing_stats() {
   assert(json.find("\"totalCycles\"") != std::string::npos);
   assert(json.find("\"avgLatency\"") != std::string::npos);
   assert(json.find("\"breakdown\"") != std::string::npos);
+  // No histogram passed: the latency percentile block stays out
+  assert(json.find("\"latency\"") == std::string::npos);
   std::cout << "[PASS] test_write_timing_stats\n";
 }
 
+void test_write_timing_latency_percentiles() {
+  std::ostringstream out;
+  TimingStats timing;
+  timing.total_cycles = 10000;
+  LatencyConfig latency;
+
+  LatencyHistogram hist;
+  for (int i = 0; i < 9900; i++) {
+    hist.record(4);
+  }
+  for (int i = 0; i < 100; i++) {
+    hist.record(200);
+  }
+  JsonOutput::write_timing_stats(out, timing, 10000, latency, {}, &hist);
+
+  std::string json = out.str();
+  assert(json.find("\"latency\"") != std::string::npos);
+  assert(json.find("\"samples\": 10000") != std::string::npos);
+  assert(json.find("\"p50\": 4") != std::string::npos);
+  assert(json.find("\"p99\": 4") != std::string::npos);
+  assert(json.find("\"p999\": 200") != std::string::npos);
+  assert(json.find("\"max\": 200") != std::string::npos);
+  std::cout << "[PASS] test_write_timing_latency_percentiles\n";
+}
+
 void test_write_hot_lines() {
   std::ostringstream out;
   std::vector<SourceStats> hot;
@@ -264,6 +291,7 @@ int main() {
   test_write_cache_stats();
   test_write_tlb_stats();
   test_write_timing_stats();
+  test_write_timing_latency_percentiles();
   test_write_hot_lines();
   test_write_suggestions();
   test_write_coherence_stats();
@@ -274,6 +302,6 @@ int main() {
   test_write_stream_start();
   test_write_stream_progress();
 
-  std::cout << "\n=== All 18 JsonOutput tests passed! ===\n";
+  std::cout << "\n=== All 19 JsonOutput tests passed! ===\n";
   return 0;
 }
@@ -1,8 +1,10 @@
 #include "../include/MultiCoreCacheSystem.hpp"
+#include "../include/MultiCoreTraceProcessor.hpp"
 #include "../include/CoherenceController.hpp"
 #include "../include/CoherenceState.hpp"
 #include "../include/CacheLevel.hpp"
 #include "../profiles/CacheConfig.hpp"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -349,6 +351,317 @@ void test_no_false_sharing_reads_only() {
   std::cout << "[PASS] test_no_false_sharing_reads_only\n";
 }
 
+// Test: Evidence stays bounded on long traces, still naming both threads
+void test_false_sharing_evidence_bounded() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config());
+
+  uint64_t base = 0x1000;
+
+  // Hammer one falsely-shared line far past the per-line sample budget
+  for (int i = 0; i < 5000; i++) {
+    cache.write(base + 0, 0, "writer_a.c", 10);
+    cache.write(base + 32, 1, "writer_b.c", 20);
+  }
+
+  auto stats = cache.get_stats();
+  assert(stats.false_sharing_events == 1);
+
+  auto reports = cache.get_false_sharing_reports();
+  assert(reports.size() == 1);
+
+  // Evidence is a fixed-size sample, not the full 10000-access history
+  const auto &report = reports[0];
+  assert(report.accesses.size() >= 2);
+  assert(report.accesses.size() <= 16);
+
+  // The sample should still name both threads and resolve file names
+  bool saw_t0 = false, saw_t1 = false;
+  for (const auto &a : report.accesses) {
+    if (a.thread_id == 0) {
+      saw_t0 = true;
+      assert(a.file == "writer_a.c");
+    }
+    if (a.thread_id == 1) {
+      saw_t1 = true;
+      assert(a.file == "writer_b.c");
+    }
+  }
+  assert(saw_t0 && saw_t1);
+
+  std::cout << "[PASS] test_false_sharing_evidence_bounded (samples: "
+            << report.accesses.size() << ")\n";
+}
+
+// Test: Line budget recycles cold trackers but keeps flagged lines
+void test_false_sharing_line_budget() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config());
+  cache.set_false_sharing_budget(8);
+
+  // Flag one line first
+  uint64_t shared_line = 0x1000;
+  for (int i = 0; i < 10; i++) {
+    cache.write(shared_line + 0, 0, "test.c", 10);
+    cache.write(shared_line + 32, 1, "test.c", 20);
+  }
+
+  // Then touch far more distinct lines than the budget allows
+  for (int i = 0; i < 1000; i++) {
+    cache.read(0x100000 + i * 64, 0, "sweep.c", 1);
+  }
+
+  auto stats = cache.get_stats();
+  assert(stats.false_sharing_events == 1);
+
+  // The flagged line survived the budget pressure with its evidence
+  auto reports = cache.get_false_sharing_reports();
+  assert(reports.size() == 1);
+  assert(reports[0].cache_line_addr == shared_line);
+  assert(reports[0].accesses.size() >= 2);
+
+  std::cout << "[PASS] test_false_sharing_line_budget\n";
+}
+
+// Test: Reports carry invalidation counts and come back worst-first
+void test_false_sharing_severity_ranking() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config());
+
+  // Line A bounces hard: two threads trading writes every iteration
+  uint64_t hot_line = 0x1000;
+  for (int i = 0; i < 100; i++) {
+    cache.write(hot_line + 0, 0, "hot.c", 10);
+    cache.write(hot_line + 32, 1, "hot.c", 20);
+  }
+
+  // Line B is falsely shared too, but barely bounces
+  uint64_t mild_line = 0x8000;
+  for (int i = 0; i < 3; i++) {
+    cache.write(mild_line + 0, 0, "mild.c", 10);
+    cache.write(mild_line + 32, 1, "mild.c", 20);
+  }
+
+  auto reports = cache.get_false_sharing_reports();
+  assert(reports.size() == 2);
+
+  // Worst offender first, and every flagged line has real invalidations
+  assert(reports[0].cache_line_addr == hot_line);
+  assert(reports[1].cache_line_addr == mild_line);
+  assert(reports[0].invalidation_count > reports[1].invalidation_count);
+  assert(reports[1].invalidation_count > 0);
+
+  std::cout << "[PASS] test_false_sharing_severity_ranking (worst: "
+            << reports[0].invalidation_count << " invalidations)\n";
+}
+
+// Test: Directory mode preserves MESI semantics beyond 64 cores
+void test_directory_coherence_large_core_count() {
+  // 96 cores forces the multi-word directory (Auto picks it above 64)
+  MultiCoreCacheSystem cache(96, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config());
+  assert(cache.get_coherence_mode() == CoherenceMode::Directory);
+
+  uint64_t addr = 0x1000;
+
+  // Pin the high threads to matching cores so the sharers straddle the
+  // 64-core directory word boundary regardless of placement policy
+  cache.pin_thread(70, 70);
+  cache.pin_thread(90, 90);
+
+  // Readers on both sides of the 64-core word boundary share the line.
+  cache.read(addr, 0, "test.c", 1);
+  cache.read(addr, 70, "test.c", 2);
+  assert(cache.get_l1_coherence_state(0, addr) == CoherenceState::Shared);
+  assert(cache.get_l1_coherence_state(70, addr) == CoherenceState::Shared);
+
+  // A write from a third high core invalidates both copies
+  cache.write(addr, 90, "test.c", 3);
+  assert(cache.get_l1_coherence_state(90, addr) == CoherenceState::Modified);
+  assert(cache.get_l1_coherence_state(0, addr) == CoherenceState::Invalid);
+  assert(cache.get_l1_coherence_state(70, addr) == CoherenceState::Invalid);
+
+  auto stats = cache.get_stats();
+  assert(stats.coherence_invalidations >= 1);
+
+  std::cout << "[PASS] test_directory_coherence_large_core_count\n";
+}
+
+// Test: Explicit directory mode matches snoop mode on a small system
+void test_directory_matches_snoop_small() {
+  MultiCoreCacheSystem snoop(4, make_test_l1_config(), make_test_l2_config(),
+                             make_test_l3_config(), PrefetchPolicy::NONE, 2,
+                             CoherenceMode::Snoop);
+  MultiCoreCacheSystem dir(4, make_test_l1_config(), make_test_l2_config(),
+                           make_test_l3_config(), PrefetchPolicy::NONE, 2,
+                           CoherenceMode::Directory);
+  assert(snoop.get_coherence_mode() == CoherenceMode::Snoop);
+  assert(dir.get_coherence_mode() == CoherenceMode::Directory);
+
+  // Same producer/consumer workload through both; stats must agree
+  for (int i = 0; i < 50; i++) {
+    uint64_t addr = 0x1000 + (i % 8) * 64;
+    snoop.write(addr, 0, "test.c", 1);
+    snoop.read(addr, 1, "test.c", 2);
+    dir.write(addr, 0, "test.c", 1);
+    dir.read(addr, 1, "test.c", 2);
+  }
+
+  auto s = snoop.get_stats();
+  auto d = dir.get_stats();
+  assert(s.coherence_invalidations == d.coherence_invalidations);
+  assert(s.l2.hits == d.l2.hits);
+  assert(s.l2.misses == d.l2.misses);
+
+  std::cout << "[PASS] test_directory_matches_snoop_small (invs: "
+            << s.coherence_invalidations << ")\n";
+}
+
+// Test: Epoch-parallel simulation produces the same stats as sequential
+void test_parallel_simulation_matches_sequential() {
+  MultiCoreTraceProcessor seq(4, make_test_l1_config(), make_test_l2_config(),
+                              make_test_l3_config());
+  MultiCoreTraceProcessor par(4, make_test_l1_config(), make_test_l2_config(),
+                              make_test_l3_config());
+  par.set_parallel_simulation(4);
+
+  std::vector<TraceEvent> events;
+  auto push = [&](uint64_t addr, bool write, uint32_t tid, std::string_view file,
+                  uint32_t line) {
+    TraceEvent e;
+    e.address = addr;
+    e.size = 8;
+    e.is_write = write;
+    e.file = file;
+    e.line = line;
+    e.thread_id = tid;
+    events.push_back(e);
+  };
+
+  // Phase 1: four threads streaming over disjoint regions - these epochs
+  // are conflict-free and run on the parallel workers
+  for (int i = 0; i < 3000; i++) {
+    for (uint32_t t = 0; t < 4; t++) {
+      push(0x100000 * (t + 1) + (uint64_t)(i % 512) * 64, i % 3 == 0, t,
+           "worker.c", 10 + t);
+    }
+  }
+  // Phase 2: every thread hammers the same line - these epochs conflict
+  // and must fall back to the sequential path, false sharing included
+  for (int i = 0; i < 200; i++) {
+    push(0x9000 + (uint64_t)(i % 4) * 8, i % 2 == 0, (uint32_t)(i % 4),
+         "shared.c", 99);
+  }
+
+  for (size_t i = 0; i < events.size(); i += 1024) {
+    size_t n = std::min<size_t>(1024, events.size() - i);
+    seq.process_batch(events.data() + i, n);
+    par.process_batch(events.data() + i, n);
+  }
+
+  auto s = seq.get_stats();
+  auto p = par.get_stats();
+  for (int core = 0; core < 4; core++) {
+    assert(s.l1_per_core[core].hits == p.l1_per_core[core].hits);
+    assert(s.l1_per_core[core].misses == p.l1_per_core[core].misses);
+  }
+  assert(s.l2.hits == p.l2.hits);
+  assert(s.l2.misses == p.l2.misses);
+  assert(s.l3.hits == p.l3.hits);
+  assert(s.l3.misses == p.l3.misses);
+  assert(s.coherence_invalidations == p.coherence_invalidations);
+  assert(s.false_sharing_events == p.false_sharing_events);
+  assert(s.false_sharing_events >= 1);
+
+  // Hot-line attribution must also agree
+  auto sh = seq.get_hot_lines(5);
+  auto ph = par.get_hot_lines(5);
+  assert(sh.size() == ph.size());
+  for (size_t i = 0; i < sh.size(); i++) {
+    assert(sh[i].file == ph[i].file);
+    assert(sh[i].line == ph[i].line);
+    assert(sh[i].hits == ph[i].hits);
+    assert(sh[i].misses == ph[i].misses);
+  }
+
+  std::cout << "[PASS] test_parallel_simulation_matches_sequential\n";
+}
+
+void test_virtual_time_deterministic_interleaving() {
+  // Two captures of the same program: identical per-thread streams, but
+  // one arrived neatly interleaved and one as per-thread drain bursts -
+  // exactly the scheduling noise between two runs of the same binary
+  auto make_capture = [](bool interleaved) {
+    std::vector<TraceEvent> per_thread[2];
+    for (uint32_t t = 0; t < 2; t++) {
+      for (int i = 0; i < 400; i++) {
+        TraceEvent e;
+        e.size = 8;
+        e.thread_id = t;
+        e.file = "worker.c";
+        e.line = 10 + t;
+        if (i % 4 == 0) {
+          // Both threads write disjoint bytes of one line - false sharing
+          e.address = 0x9000 + t * 8;
+          e.is_write = true;
+        } else {
+          e.address = 0x100000 * (t + 1) + (uint64_t)(i % 64) * 64;
+          e.is_write = (i % 3 == 0);
+        }
+        per_thread[t].push_back(e);
+      }
+    }
+    std::vector<TraceEvent> events;
+    if (interleaved) {
+      for (size_t i = 0; i < per_thread[0].size(); i++) {
+        events.push_back(per_thread[0][i]);
+        events.push_back(per_thread[1][i]);
+      }
+    } else {
+      events.insert(events.end(), per_thread[0].begin(), per_thread[0].end());
+      events.insert(events.end(), per_thread[1].begin(), per_thread[1].end());
+    }
+    return events;
+  };
+  auto capture_a = make_capture(true);
+  auto capture_b = make_capture(false);
+
+  // Arrival-order replay sees two different interleavings - the
+  // run-to-run instability this mode exists to remove
+  MultiCoreTraceProcessor raw_a(2, make_test_l1_config(), make_test_l2_config(),
+                                make_test_l3_config());
+  MultiCoreTraceProcessor raw_b(2, make_test_l1_config(), make_test_l2_config(),
+                                make_test_l3_config());
+  raw_a.process_batch(capture_a);
+  raw_b.process_batch(capture_b);
+  assert(raw_a.get_stats().coherence_invalidations !=
+         raw_b.get_stats().coherence_invalidations);
+
+  // Virtual-time replay rebuilds the interleaving from per-core clocks,
+  // so both captures produce identical results
+  MultiCoreTraceProcessor vt_a(2, make_test_l1_config(), make_test_l2_config(),
+                               make_test_l3_config());
+  MultiCoreTraceProcessor vt_b(2, make_test_l1_config(), make_test_l2_config(),
+                               make_test_l3_config());
+  vt_a.enable_virtual_time(LatencyConfig{});
+  vt_b.enable_virtual_time(LatencyConfig{});
+  vt_a.process_batch(capture_a);
+  vt_b.process_batch(capture_b);
+
+  auto a = vt_a.get_stats();
+  auto b = vt_b.get_stats();
+  for (int core = 0; core < 2; core++) {
+    assert(a.l1_per_core[core].hits == b.l1_per_core[core].hits);
+    assert(a.l1_per_core[core].misses == b.l1_per_core[core].misses);
+  }
+  assert(a.l2.hits == b.l2.hits && a.l2.misses == b.l2.misses);
+  assert(a.coherence_invalidations == b.coherence_invalidations);
+  assert(a.false_sharing_events == b.false_sharing_events);
+  assert(a.false_sharing_events >= 1);
+
+  std::cout << "[PASS] test_virtual_time_deterministic_interleaving\n";
+}
+
 // ============================================================================
 // COHERENCE STATE TRANSITION TESTS
 // ============================================================================
@@ -375,9 +688,103 @@ void test_coherence_state_helpers() {
   assert(can_write_silently(CoherenceState::Modified));
   assert(is_dirty_state(CoherenceState::Modified));
 
+  // Owned state (MOESI): dirty but shared, readable, not silently writable
+  assert(can_read(CoherenceState::Owned));
+  assert(!can_write_silently(CoherenceState::Owned));
+  assert(is_dirty_state(CoherenceState::Owned));
+
+  // Forward state (MESIF): clean shared copy that answers requests
+  assert(can_read(CoherenceState::Forward));
+  assert(!can_write_silently(CoherenceState::Forward));
+  assert(!is_dirty_state(CoherenceState::Forward));
+
   std::cout << "[PASS] test_coherence_state_helpers\n";
 }
 
+// ============================================================================
+// MOESI / MESIF PROTOCOL TESTS
+// ============================================================================
+
+// MESI baseline: a remote read of a dirty line forces a snoop writeback
+// and leaves the owner in Shared
+void test_mesi_remote_read_writes_back() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config());
+
+  cache.write(0x1000, 0);  // core 0 holds the line Modified
+  cache.read(0x1000, 1);   // core 1's read snoops it
+
+  auto stats = cache.get_stats();
+  assert(stats.snoop_writebacks == 1);
+  assert(stats.dirty_shares == 0);
+  assert(stats.forwards == 0);
+  assert(cache.get_l1_coherence_state(0, 0x1000) == CoherenceState::Shared);
+
+  std::cout << "[PASS] test_mesi_remote_read_writes_back\n";
+}
+
+// MOESI: the same remote read leaves the owner's line dirty in Owned and
+// counts a dirty share instead of a writeback
+void test_moesi_dirty_share_keeps_owner_dirty() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config(),
+                              PrefetchPolicy::NONE, 2, CoherenceMode::Auto,
+                              CoherenceProtocol::MOESI);
+
+  cache.write(0x1000, 0);
+  cache.read(0x1000, 1);
+
+  auto stats = cache.get_stats();
+  assert(stats.dirty_shares == 1);
+  assert(stats.snoop_writebacks == 0);
+  assert(cache.get_l1_coherence_state(0, 0x1000) == CoherenceState::Owned);
+  assert(cache.get_l1_coherence_state(1, 0x1000) == CoherenceState::Shared);
+
+  std::cout << "[PASS] test_moesi_dirty_share_keeps_owner_dirty\n";
+}
+
+// MOESI: the writeback a dirty share avoided is still charged when the
+// Owned line is eventually evicted - it is deferred, not lost
+void test_moesi_writeback_deferred_to_eviction() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config(),
+                              PrefetchPolicy::NONE, 2, CoherenceMode::Auto,
+                              CoherenceProtocol::MOESI);
+
+  cache.write(0x1000, 0);
+  cache.read(0x1000, 1);  // core 0: M -> Owned, no writeback yet
+  assert(cache.get_stats().l1_per_core[0].writebacks == 0);
+
+  // 1KB 2-way L1 has 8 sets (512B stride); two more lines in 0x1000's
+  // set push the Owned line out and its deferred writeback lands
+  cache.read(0x1200, 0);
+  cache.read(0x1400, 0);
+  assert(cache.get_stats().l1_per_core[0].writebacks == 1);
+
+  std::cout << "[PASS] test_moesi_writeback_deferred_to_eviction\n";
+}
+
+// MESIF: a clean shared line is supplied cache-to-cache and the newest
+// sharer holds it in Forward; the previous F copy falls back to Shared
+void test_mesif_forward_state() {
+  MultiCoreCacheSystem cache(4, make_test_l1_config(),
+                              make_test_l2_config(), make_test_l3_config(),
+                              PrefetchPolicy::NONE, 2, CoherenceMode::Auto,
+                              CoherenceProtocol::MESIF);
+
+  cache.read(0x1000, 0);  // core 0: Exclusive, sole copy
+  cache.read(0x1000, 1);  // core 1 gets the line in Forward
+  assert(cache.get_l1_coherence_state(1, 0x1000) == CoherenceState::Forward);
+  assert(cache.get_stats().forwards == 1);
+
+  cache.read(0x1000, 2);  // core 2 takes over as the F copy
+  assert(cache.get_l1_coherence_state(2, 0x1000) == CoherenceState::Forward);
+  assert(cache.get_l1_coherence_state(1, 0x1000) == CoherenceState::Shared);
+  assert(cache.get_stats().forwards == 2);
+
+  std::cout << "[PASS] test_mesif_forward_state\n";
+}
+
 // ============================================================================
 // MULTI-CORE SYSTEM TESTS
 // ============================================================================
@@ -469,10 +876,23 @@ int main() {
   test_false_sharing_detection();
   test_no_false_sharing_same_bytes();
   test_no_false_sharing_reads_only();
+  test_false_sharing_evidence_bounded();
+  test_false_sharing_line_budget();
+  test_false_sharing_severity_ranking();
+  test_directory_coherence_large_core_count();
+  test_directory_matches_snoop_small();
+  test_parallel_simulation_matches_sequential();
+  test_virtual_time_deterministic_interleaving();
 
   std::cout << "\n--- State Helper Tests ---\n";
   test_coherence_state_helpers();
 
+  std::cout << "\n--- MOESI / MESIF Protocol Tests ---\n";
+  test_mesi_remote_read_writes_back();
+  test_moesi_dirty_share_keeps_owner_dirty();
+  test_moesi_writeback_deferred_to_eviction();
+  test_mesif_forward_state();
+
   std::cout << "\n--- Multi-Core System Tests ---\n";
   test_multicore_l1_isolation();
   test_multicore_shared_l2l3();
@@ -0,0 +1,168 @@
+#include "../include/CacheSystem.hpp"
+#include "../include/MSHR.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+
+void test_independent_misses_overlap() {
+  MSHRSet mshrs(10);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  // Two misses to different lines issued 10 cycles apart, 100 cycles
+  // latency each: serialized cost is 200, but the busy intervals
+  // [0,100) and [10,110) union to just 110
+  mshrs.on_miss(0x1000, now, 100, timing);
+  now = 10;
+  mshrs.on_miss(0x2000, now, 100, timing);
+
+  assert(timing.serialized_miss_cycles == 200);
+  assert(timing.overlapped_miss_cycles == 110);
+  assert(timing.mshr_merges == 0);
+  assert(timing.mshr_full_stalls == 0);
+
+  std::cout << "[PASS] test_independent_misses_overlap\n";
+}
+
+void test_secondary_miss_merges() {
+  MSHRSet mshrs(10);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  mshrs.on_miss(0x1000, now, 100, timing);
+  now = 10;
+  // Same line still in flight: merged, no new request charged
+  mshrs.on_miss(0x1000, now, 100, timing);
+
+  assert(timing.mshr_merges == 1);
+  assert(timing.serialized_miss_cycles == 100);
+  assert(timing.overlapped_miss_cycles == 100);
+  assert(mshrs.in_flight() == 1);
+
+  std::cout << "[PASS] test_secondary_miss_merges\n";
+}
+
+void test_fill_ends_merging() {
+  MSHRSet mshrs(10);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  mshrs.on_miss(0x1000, now, 100, timing);
+  // After the fill lands the entry retires, so a later miss to the
+  // same line is a fresh primary miss
+  now = 200;
+  mshrs.on_miss(0x1000, now, 100, timing);
+
+  assert(timing.mshr_merges == 0);
+  assert(timing.serialized_miss_cycles == 200);
+  assert(timing.overlapped_miss_cycles == 200);
+
+  std::cout << "[PASS] test_fill_ends_merging\n";
+}
+
+void test_full_mshrs_stall() {
+  MSHRSet mshrs(2);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  mshrs.on_miss(0x1000, now, 100, timing);
+  mshrs.on_miss(0x2000, now, 100, timing);
+  // Both entries busy: the third miss stalls until the earliest fill
+  mshrs.on_miss(0x3000, now, 100, timing);
+
+  assert(timing.mshr_full_stalls == 1);
+  assert(timing.mshr_stall_cycles == 100);
+  assert(now == 100);
+  assert(timing.serialized_miss_cycles == 300);
+
+  std::cout << "[PASS] test_full_mshrs_stall\n";
+}
+
+void test_spaced_misses_do_not_overlap() {
+  MSHRSet mshrs(10);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  mshrs.on_miss(0x1000, now, 100, timing);
+  now = 500;
+  mshrs.on_miss(0x2000, now, 100, timing);
+
+  // No overlap between [0,100) and [500,600)
+  assert(timing.serialized_miss_cycles == 200);
+  assert(timing.overlapped_miss_cycles == 200);
+
+  std::cout << "[PASS] test_spaced_misses_do_not_overlap\n";
+}
+
+void test_clear() {
+  MSHRSet mshrs(4);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  mshrs.on_miss(0x1000, now, 100, timing);
+  assert(mshrs.in_flight() == 1);
+
+  mshrs.clear();
+  assert(mshrs.in_flight() == 0);
+
+  // Busy horizon is gone too: a fresh miss at time 0 pays full cost
+  TimingStats fresh;
+  now = 0;
+  mshrs.on_miss(0x2000, now, 100, fresh);
+  assert(fresh.overlapped_miss_cycles == 100);
+
+  std::cout << "[PASS] test_clear\n";
+}
+
+void test_cache_system_reports_mlp() {
+  // Streaming misses through the hierarchy: back-to-back memory misses
+  // overlap, so the MSHR model reports less wall-clock cost than the
+  // serialized charge while total_cycles keeps the serialized figure
+  CacheSystem cache(make_educational_config());
+
+  for (int i = 0; i < 256; i++) {
+    cache.read(0x100000 + static_cast<uint64_t>(i) * 4096);
+  }
+
+  const TimingStats &timing = cache.get_timing_stats();
+  assert(timing.serialized_miss_cycles > 0);
+  assert(timing.overlapped_miss_cycles > 0);
+  assert(timing.overlapped_miss_cycles < timing.serialized_miss_cycles);
+  assert(timing.total_cycles >= timing.serialized_miss_cycles);
+
+  std::cout << "[PASS] test_cache_system_reports_mlp\n";
+}
+
+void test_single_entry_serializes() {
+  // With one MSHR every miss drains before the next issues: the
+  // overlapped cost degenerates to the serialized cost plus stalls
+  CacheHierarchyConfig cfg = make_educational_config();
+  cfg.latency.mshr_entries = 1;
+  CacheSystem cache(cfg);
+
+  for (int i = 0; i < 64; i++) {
+    cache.read(0x100000 + static_cast<uint64_t>(i) * 4096);
+  }
+
+  const TimingStats &timing = cache.get_timing_stats();
+  assert(timing.overlapped_miss_cycles == timing.serialized_miss_cycles);
+  assert(timing.mshr_full_stalls > 0);
+
+  std::cout << "[PASS] test_single_entry_serializes\n";
+}
+
+int main() {
+  std::cout << "Running MSHR tests...\n\n";
+
+  test_independent_misses_overlap();
+  test_secondary_miss_merges();
+  test_fill_ends_merging();
+  test_full_mshrs_stall();
+  test_spaced_misses_do_not_overlap();
+  test_clear();
+  test_cache_system_reports_mlp();
+  test_single_entry_serializes();
+
+  std::cout << "\nAll MSHR tests passed!\n";
+  return 0;
+}
@@ -182,6 +182,144 @@ void test_prefetch_reset() {
   std::cout << "[PASS] test_prefetch_reset\n";
 }
 
+// Test: BEST_OFFSET learns a non-unit stride offset
+void test_prefetch_best_offset_learns_offset() {
+  Prefetcher pf(PrefetchPolicy::BEST_OFFSET, 2, 64);
+
+  // Constant stride of 4 lines: next-line misses, BOP should score
+  // offset 4 highest and adopt it when the learning phase completes
+  uint64_t base = 0x100000;
+  for (int i = 0; i < 300; i++) {
+    pf.on_miss(base + i * 4 * 64);
+  }
+
+  auto addrs = pf.on_miss(base + 300 * 4 * 64);
+  assert(addrs.size() == 1);
+  assert(addrs[0] == base + (300 * 4 + 4) * 64);
+
+  std::cout << "[PASS] test_prefetch_best_offset_learns_offset\n";
+}
+
+// Test: BEST_OFFSET goes idle when no stable offset exists
+void test_prefetch_best_offset_goes_idle() {
+  Prefetcher pf(PrefetchPolicy::BEST_OFFSET, 2, 64);
+
+  // Pseudo-random misses: no offset scores, so after one learning
+  // phase the prefetcher should stop issuing instead of polluting
+  uint64_t addr = 0x500000;
+  for (int i = 0; i < 256; i++) {
+    addr = addr * 2862933555777941757ULL + 3037000493ULL;
+    pf.on_miss(addr & ~0x3FULL);
+  }
+
+  auto addrs = pf.on_miss(0x900000);
+  assert(addrs.empty());
+
+  std::cout << "[PASS] test_prefetch_best_offset_goes_idle\n";
+}
+
+// Test: SMS replays a learned sparse footprint on region re-entry
+void test_prefetch_sms_replays_footprint() {
+  Prefetcher pf(PrefetchPolicy::SMS, 2, 64);
+  uint64_t pc = 0x400000;
+
+  // Sparse footprint in region A: lines 0, 3, 7 and 17
+  uint64_t region_a = 0x100000;
+  pf.on_miss(region_a, pc);
+  pf.on_miss(region_a + 3 * 64, pc);
+  pf.on_miss(region_a + 7 * 64, pc);
+  pf.on_miss(region_a + 17 * 64, pc);
+
+  // Open enough other regions to retire A's generation into the
+  // pattern table
+  for (int i = 0; i < 64; i++) {
+    pf.on_miss(0x800000 + i * 2048, pc + 8 + i);
+  }
+
+  // Same trigger opening a fresh region replays the footprint (minus
+  // the line the demand access already fetches)
+  uint64_t region_b = 0x200000;
+  auto addrs = pf.on_miss(region_b, pc);
+  assert(addrs.size() == 3);
+  assert(addrs[0] == region_b + 3 * 64);
+  assert(addrs[1] == region_b + 7 * 64);
+  assert(addrs[2] == region_b + 17 * 64);
+
+  std::cout << "[PASS] test_prefetch_sms_replays_footprint\n";
+}
+
+// Test: SMS stays quiet for triggers it has never seen
+void test_prefetch_sms_unknown_trigger() {
+  Prefetcher pf(PrefetchPolicy::SMS, 2, 64);
+
+  auto addrs = pf.on_miss(0x100000, 0x400000);
+  assert(addrs.empty());
+  assert(pf.get_stats().prefetches_issued == 0);
+
+  std::cout << "[PASS] test_prefetch_sms_unknown_trigger\n";
+}
+
+// Test: Throttle backs off when prefetches go unused
+void test_throttle_degree_drops_on_useless() {
+  Prefetcher pf(PrefetchPolicy::NEXT_LINE, 4, 64);
+  pf.enable_throttling();
+
+  // Far-apart misses: next-line prefetches are never used, so each
+  // epoch's accuracy is 0 and the degree should fall to the minimum
+  for (int i = 0; i < 600; i++) {
+    pf.on_miss(0x100000 + static_cast<uint64_t>(i) * 0x10000);
+  }
+
+  assert(pf.get_degree() == 1);
+  const auto &timeline = pf.get_throttle_timeline();
+  assert(!timeline.empty());
+  assert(timeline.back().degree == pf.get_degree());
+  assert(timeline.back().accuracy < 0.35);
+
+  std::cout << "[PASS] test_throttle_degree_drops_on_useless\n";
+}
+
+// Test: Throttle ramps up when accuracy stays high
+void test_throttle_degree_grows_on_accurate() {
+  Prefetcher pf(PrefetchPolicy::NEXT_LINE, 1, 64);
+  pf.enable_throttling();
+
+  // Credit every prefetch as useful: 100% accuracy should double the
+  // degree each epoch up to the cap
+  for (int i = 0; i < 4000; i++) {
+    auto addrs = pf.on_miss(0x100000 + static_cast<uint64_t>(i) * 64);
+    for (size_t j = 0; j < addrs.size(); j++) {
+      pf.record_useful_prefetch();
+    }
+  }
+
+  assert(pf.get_degree() == 8);
+
+  std::cout << "[PASS] test_throttle_degree_grows_on_accurate\n";
+}
+
+// Test: Throttling through the multi-core hierarchy
+void test_multicore_throttle_timeline() {
+  MultiCoreCacheSystem cache(2, make_test_l1_config(), make_test_l2_config(),
+                             make_test_l3_config(),
+                             PrefetchPolicy::NEXT_LINE, 4);
+  cache.enable_prefetch_throttling();
+
+  // Core 0 streams (accurate), core 1 jumps around (inaccurate)
+  for (int i = 0; i < 3000; i++) {
+    cache.read(0x100000 + i * 64, 0);
+    cache.read(0x4000000 + static_cast<uint64_t>(i) * 0x8000, 1);
+  }
+
+  assert(!cache.get_prefetcher(0).get_throttle_timeline().empty());
+  assert(!cache.get_prefetcher(1).get_throttle_timeline().empty());
+  // The polluting core should have throttled below the streaming core
+  assert(cache.get_prefetcher(1).get_degree() <
+         cache.get_prefetcher(0).get_degree());
+
+  std::cout << "[PASS] test_multicore_throttle_timeline\n";
+}
+
 // ============================================================================
 // MULTI-CORE PREFETCHING TESTS
 // These tests verify prefetching behavior in multi-core context.
@@ -345,6 +483,25 @@ void test_prefetch_page_boundary() {
   std::cout << "[PASS] test_prefetch_page_boundary\n";
 }
 
+// Test: Strided workload through the hierarchy with BEST_OFFSET
+void test_prefetch_best_offset_strided_benefit() {
+  MultiCoreCacheSystem cache(1, make_test_l1_config(), make_test_l2_config(),
+                             make_test_l3_config(),
+                             PrefetchPolicy::BEST_OFFSET, 2);
+
+  // Stride of 2 lines defeats next-line prefetching but trains offset 2
+  for (int i = 0; i < 2000; i++) {
+    cache.read(0x100000 + i * 128, 0);
+  }
+
+  auto stats = cache.get_prefetch_stats(0);
+  assert(stats.prefetches_issued >= 1);
+  assert(stats.prefetches_useful >= 1);
+
+  std::cout << "[PASS] test_prefetch_best_offset_strided_benefit (accuracy: "
+            << stats.accuracy() << ")\n";
+}
+
 // ============================================================================
 // INTEGRATION TESTS
 // ============================================================================
@@ -416,6 +573,13 @@ int main() {
   test_prefetch_stats();
   test_prefetch_accuracy();
   test_prefetch_reset();
+  test_prefetch_best_offset_learns_offset();
+  test_prefetch_best_offset_goes_idle();
+  test_prefetch_sms_replays_footprint();
+  test_prefetch_sms_unknown_trigger();
+  test_throttle_degree_drops_on_useless();
+  test_throttle_degree_grows_on_accurate();
+  test_multicore_throttle_timeline();
 
   std::cout << "\n--- Multi-Core Context Tests ---\n";
   test_multicore_prefetch_per_core_isolation();
@@ -427,6 +591,7 @@ int main() {
   test_prefetch_random_no_benefit();
   test_prefetch_strided_benefit();
   test_prefetch_page_boundary();
+  test_prefetch_best_offset_strided_benefit();
 
   std::cout << "\n--- Integration Tests ---\n";
   test_integration_multicore_sequential();
@@ -0,0 +1,156 @@
+#include "../include/MultiCoreCacheSystem.hpp"
+#include "../profiles/CacheConfig.hpp"
+#include <cassert>
+#include <iostream>
+
+// Small caches so cold misses reliably reach DRAM, where NUMA placement
+// is decided. 4 cores / 2 sockets: cores 0-1 on socket 0, cores 2-3 on
+// socket 1. The default scatter placement spreads threads breadth-first
+// across sockets in order of first access: thread 0 -> core 0, thread 1
+// -> core 2, thread 2 -> core 1, thread 3 -> core 3.
+CacheConfig make_numa_l1_config() {
+  return {.kb_size = 1, .associativity = 2, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_numa_l2_config() {
+  return {.kb_size = 4, .associativity = 4, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_numa_l3_config() {
+  return {.kb_size = 16, .associativity = 8, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+// Test 1: first-touch placement keeps a single-socket workload fully local
+void test_first_touch_all_local() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+  cache.enable_numa(2, NumaPlacement::FirstTouch);
+  assert(cache.is_numa_enabled());
+
+  // Thread 0 (core 0, socket 0) faults four pages - it becomes their home
+  cache.read(0x0000, 0);
+  cache.read(0x1000, 0);
+  cache.read(0x2000, 0);
+  cache.read(0x3000, 0);
+
+  auto stats = cache.get_numa_stats();
+  assert(stats.sockets == 2);
+  assert(stats.local_accesses == 4);
+  assert(stats.remote_accesses == 0);
+  assert(stats.remote_ratio() == 0.0);
+
+  std::cout << "[PASS] test_first_touch_all_local\n";
+}
+
+// Test 2: a page homed by socket 0 costs a remote access from socket 1
+void test_first_touch_remote_access() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+  cache.enable_numa(2, NumaPlacement::FirstTouch);
+
+  // Thread 0 (core 0, socket 0) homes pages 0 and 2
+  cache.read(0x0000, 0);
+  cache.read(0x2000, 0);
+
+  // Thread 1 scatters to core 2 (socket 1) and touches a different line
+  // of page 0 - a cold DRAM access against socket 0's memory
+  cache.read(0x0040, 1);
+
+  auto stats = cache.get_numa_stats();
+  assert(stats.local_accesses == 2);
+  assert(stats.remote_accesses == 1);
+
+  std::cout << "[PASS] test_first_touch_remote_access\n";
+}
+
+// Test 3: interleave places pages round-robin regardless of who touches them
+void test_interleave_placement() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+  cache.enable_numa(2, NumaPlacement::Interleave);
+
+  // Thread 0 (socket 0): page 0 is home socket 0 (local), page 1 is
+  // home socket 1 (remote) - even though thread 0 touched both first
+  cache.read(0x0000, 0);
+  cache.read(0x1000, 0);
+
+  auto stats = cache.get_numa_stats();
+  assert(stats.placement == NumaPlacement::Interleave);
+  assert(stats.local_accesses == 1);
+  assert(stats.remote_accesses == 1);
+  assert(stats.remote_ratio() == 0.5);
+
+  std::cout << "[PASS] test_interleave_placement\n";
+}
+
+// Test 4: remote traffic is attributed to source lines for the report
+void test_numa_hot_lines() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+  cache.enable_numa(2, NumaPlacement::FirstTouch);
+
+  cache.read(0x0000, 0, "main.c", 10);  // homes page 0 on socket 0
+  cache.read(0x0040, 1, "main.c", 20);  // thread 1 (socket 1) -> remote
+
+  auto hot = cache.get_numa_hot_lines(10);
+  assert(!hot.empty());
+  // Sorted by remote count - the cross-socket line comes first
+  assert(hot[0].file == "main.c");
+  assert(hot[0].line == 20);
+  assert(hot[0].remote == 1);
+  assert(hot[0].local == 0);
+  assert(hot[0].remote_ratio() == 1.0);
+
+  std::cout << "[PASS] test_numa_hot_lines\n";
+}
+
+// Test 5: per-socket L3 slices aggregate into the reported L3 stats
+void test_socket_l3_slices_aggregate() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+  cache.enable_numa(2, NumaPlacement::FirstTouch);
+
+  // Three cold lines from cores on both sockets - one L3 miss each,
+  // landing in different slices
+  cache.read(0x0000, 0);
+  cache.read(0x1000, 1);
+  cache.read(0x2000, 2);
+
+  auto stats = cache.get_stats();
+  assert(stats.l3.misses == 3);
+
+  std::cout << "[PASS] test_socket_l3_slices_aggregate\n";
+}
+
+// Test 6: invalid socket counts leave the system single-socket
+void test_numa_requires_dividing_sockets() {
+  MultiCoreCacheSystem cache(4, make_numa_l1_config(), make_numa_l2_config(),
+                             make_numa_l3_config());
+
+  cache.enable_numa(3, NumaPlacement::FirstTouch);  // 3 doesn't divide 4
+  assert(!cache.is_numa_enabled());
+
+  cache.read(0x0000, 0);
+  auto stats = cache.get_numa_stats();
+  assert(stats.sockets == 1);
+  assert(stats.local_accesses == 0 && stats.remote_accesses == 0);
+
+  std::cout << "[PASS] test_numa_requires_dividing_sockets\n";
+}
+
+int main() {
+  std::cout << "=== NUMA Multi-Socket Tests ===\n\n";
+
+  test_first_touch_all_local();
+  test_first_touch_remote_access();
+  test_interleave_placement();
+  test_numa_hot_lines();
+  test_socket_l3_slices_aggregate();
+  test_numa_requires_dividing_sockets();
+
+  std::cout << "\n=== All NUMA Tests Passed! ===\n";
+  return 0;
+}
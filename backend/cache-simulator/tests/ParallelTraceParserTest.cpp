@@ -0,0 +1,187 @@
+#include "../include/ParallelTraceParser.hpp"
+#include "../include/ThreadPool.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void test_thread_pool_runs_all_tasks() {
+  ThreadPool pool(4);
+  std::atomic<int> counter{0};
+
+  for (int i = 0; i < 1000; i++) {
+    pool.submit([&counter] { counter++; });
+  }
+  pool.wait_idle();
+  assert(counter == 1000);
+
+  // Pool is reusable after wait_idle
+  for (int i = 0; i < 100; i++) {
+    pool.submit([&counter] { counter++; });
+  }
+  pool.wait_idle();
+  assert(counter == 1100);
+
+  std::cout << "[PASS] test_thread_pool_runs_all_tasks\n";
+}
+
+void test_thread_pool_uses_multiple_workers() {
+  ThreadPool pool(4);
+  assert(pool.size() == 4);
+
+  std::atomic<int> concurrent{0};
+  std::atomic<int> peak{0};
+  for (int i = 0; i < 64; i++) {
+    pool.submit([&] {
+      int now = ++concurrent;
+      int seen = peak.load();
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      for (volatile int spin = 0; spin < 100000; spin++) {
+      }
+      concurrent--;
+    });
+  }
+  pool.wait_idle();
+  assert(peak > 1);
+
+  std::cout << "[PASS] test_thread_pool_uses_multiple_workers\n";
+}
+
+// Build a synthetic trace mixing event types, comments, and blank lines
+static std::string make_trace(size_t lines) {
+  std::string buf;
+  buf.reserve(lines * 40);
+  for (size_t i = 0; i < lines; i++) {
+    uint64_t addr = 0x10000000 + i * 64;
+    char hex[32];
+    snprintf(hex, sizeof(hex), "%lx", (unsigned long)addr);
+    switch (i % 7) {
+    case 0:
+      buf += "L 0x" + std::string(hex) + " 4 main.c:" +
+             std::to_string(10 + i % 50) + " T" + std::to_string(i % 4) + "\n";
+      break;
+    case 1:
+      buf += "S 0x" + std::string(hex) + " 8 util.c:" +
+             std::to_string(i % 30) + " T" + std::to_string(i % 4) + "\n";
+      break;
+    case 2:
+      buf += "V 0x" + std::string(hex) + " 32 simd.c:5 T0\n";
+      break;
+    case 3:
+      buf += "# comment line\n";
+      break;
+    case 4:
+      buf += "X 0x" + std::string(hex) + " 8 atomic.c:7 T1\n";
+      break;
+    case 5:
+      buf += "\n";
+      break;
+    case 6:
+      buf += "L 0x" + std::string(hex) + " 4\n"; // no location, no thread
+      break;
+    }
+  }
+  return buf;
+}
+
+static std::vector<TraceEvent> parse_serial(const std::string &buf) {
+  std::vector<TraceEvent> events;
+  for_each_line(buf.data(), buf.size(), [&](const char *b, const char *e) {
+    auto event = parse_trace_event_fast(b, e);
+    if (event)
+      events.push_back(std::move(*event));
+  });
+  return events;
+}
+
+static void assert_same_events(const std::vector<TraceEvent> &a,
+                               const std::vector<TraceEvent> &b) {
+  assert(a.size() == b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    assert(a[i].address == b[i].address);
+    assert(a[i].size == b[i].size);
+    assert(a[i].is_write == b[i].is_write);
+    assert(a[i].is_vector == b[i].is_vector);
+    assert(a[i].is_atomic == b[i].is_atomic);
+    assert(a[i].file == b[i].file);
+    assert(a[i].line == b[i].line);
+    assert(a[i].thread_id == b[i].thread_id);
+  }
+}
+
+void test_matches_serial_parse() {
+  // Above the parallel threshold so chunking actually engages
+  std::string buf = make_trace(60000);
+  assert(buf.size() >= ParallelTraceParser::MIN_PARALLEL_BYTES);
+
+  auto serial = parse_serial(buf);
+  auto parallel = ParallelTraceParser::parse(buf.data(), buf.size(), 4);
+
+  assert_same_events(serial, parallel);
+  assert(!serial.empty());
+
+  std::cout << "[PASS] test_matches_serial_parse (" << serial.size()
+            << " events)\n";
+}
+
+void test_small_buffer_falls_back() {
+  std::string buf = make_trace(100);
+  assert(buf.size() < ParallelTraceParser::MIN_PARALLEL_BYTES);
+
+  auto serial = parse_serial(buf);
+  auto parallel = ParallelTraceParser::parse(buf.data(), buf.size(), 8);
+  assert_same_events(serial, parallel);
+
+  std::cout << "[PASS] test_small_buffer_falls_back\n";
+}
+
+void test_order_preserved() {
+  // Strictly increasing addresses must come back strictly increasing -
+  // any chunk misalignment or out-of-order splice would break this
+  std::string buf;
+  const size_t lines = 100000;
+  for (size_t i = 0; i < lines; i++) {
+    char line[64];
+    snprintf(line, sizeof(line), "L 0x%lx 4 seq.c:1 T0\n",
+             (unsigned long)(0x1000 + i * 8));
+    buf += line;
+  }
+
+  auto events = ParallelTraceParser::parse(buf.data(), buf.size(), 8);
+  assert(events.size() == lines);
+  for (size_t i = 1; i < events.size(); i++) {
+    assert(events[i].address > events[i - 1].address);
+  }
+
+  std::cout << "[PASS] test_order_preserved\n";
+}
+
+void test_missing_trailing_newline() {
+  std::string buf = make_trace(50000);
+  buf += "S 0xdeadbeef 4 tail.c:99 T3"; // no trailing newline
+
+  auto serial = parse_serial(buf);
+  auto parallel = ParallelTraceParser::parse(buf.data(), buf.size(), 4);
+  assert_same_events(serial, parallel);
+  assert(parallel.back().address == 0xdeadbeef);
+  assert(parallel.back().file == "tail.c");
+
+  std::cout << "[PASS] test_missing_trailing_newline\n";
+}
+
+int main() {
+  std::cout << "Running ParallelTraceParser tests...\n\n";
+
+  test_thread_pool_runs_all_tasks();
+  test_thread_pool_uses_multiple_workers();
+  test_matches_serial_parse();
+  test_small_buffer_falls_back();
+  test_order_preserved();
+  test_missing_trailing_newline();
+
+  std::cout << "\nAll ParallelTraceParser tests passed!\n";
+  return 0;
+}
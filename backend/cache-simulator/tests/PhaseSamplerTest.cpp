@@ -0,0 +1,127 @@
+#include "../include/PhaseSampler.hpp"
+#include <cassert>
+#include <iostream>
+
+// Build a load event at the given address
+TraceEvent make_load(uint64_t addr) {
+  TraceEvent event;
+  event.address = addr;
+  event.size = 4;
+  return event;
+}
+
+// Feed `count` sequential loads walking a region starting at `base`
+void feed_region(PhaseSampler &sampler, uint64_t base, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    sampler.add_event(make_load(base + i * 64));
+  }
+}
+
+// Test 1: intervals close at the configured length, plus a short tail
+void test_interval_boundaries() {
+  PhaseSampler sampler(100, 4);
+  feed_region(sampler, 0x10000, 250);
+  assert(sampler.num_intervals() == 2); // tail still open
+  sampler.finish();
+  assert(sampler.num_intervals() == 3);
+  assert(sampler.events_in_interval(0) == 100);
+  assert(sampler.events_in_interval(2) == 50);
+  std::cout << "[PASS] test_interval_boundaries\n";
+}
+
+// Test 2: alternating access patterns cluster into two phases with the
+// right populations
+void test_clustering_separates_patterns() {
+  PhaseSampler sampler(100, 4);
+  for (int rep = 0; rep < 3; rep++) {
+    feed_region(sampler, 0x100000, 100);   // pattern A
+    feed_region(sampler, 0x8000000, 100);  // pattern B (disjoint lines)
+  }
+  sampler.finish();
+  assert(sampler.num_intervals() == 6);
+
+  auto plan = sampler.cluster();
+  assert(plan.clusters.size() == 2);
+  assert(plan.clusters[0].weight + plan.clusters[1].weight == 6);
+
+  // Intervals of the same pattern land in the same phase
+  assert(plan.assignment[0] == plan.assignment[2]);
+  assert(plan.assignment[2] == plan.assignment[4]);
+  assert(plan.assignment[1] == plan.assignment[3]);
+  assert(plan.assignment[0] != plan.assignment[1]);
+
+  // Each representative belongs to the phase it represents
+  for (size_t c = 0; c < plan.clusters.size(); c++) {
+    assert(plan.assignment[plan.clusters[c].representative] ==
+           static_cast<int>(c));
+  }
+  std::cout << "[PASS] test_clustering_separates_patterns\n";
+}
+
+// Test 3: identical intervals collapse into one phase with zero distortion
+void test_uniform_trace_single_phase() {
+  PhaseSampler sampler(100, 8);
+  for (int rep = 0; rep < 5; rep++) {
+    feed_region(sampler, 0x100000, 100); // same pattern every interval
+  }
+  sampler.finish();
+
+  auto plan = sampler.cluster();
+  assert(plan.clusters.size() == 1);
+  assert(plan.clusters[0].weight == 5);
+  assert(plan.clusters[0].distortion < 1e-9);
+  std::cout << "[PASS] test_uniform_trace_single_phase\n";
+}
+
+// Test 4: max_clusters caps the number of phases
+void test_max_clusters_cap() {
+  PhaseSampler sampler(100, 2);
+  for (int i = 0; i < 4; i++) {
+    feed_region(sampler, 0x100000ULL << i, 100); // four distinct patterns
+  }
+  sampler.finish();
+
+  auto plan = sampler.cluster();
+  assert(plan.clusters.size() <= 2);
+  uint64_t total = 0;
+  for (const auto &c : plan.clusters)
+    total += c.weight;
+  assert(total == 4);
+  std::cout << "[PASS] test_max_clusters_cap\n";
+}
+
+// Test 5: side-band records count toward interval length but not the
+// access pattern
+void test_sideband_records_ignored_in_pattern() {
+  PhaseSampler a(100, 4);
+  PhaseSampler b(100, 4);
+  feed_region(a, 0x100000, 100);
+  for (size_t i = 0; i < 100; i++) {
+    if (i % 2 == 0) {
+      b.add_event(make_load(0x100000 + (i / 2) * 64));
+    } else {
+      TraceEvent marker;
+      marker.is_phase_begin = true;
+      marker.address = 0xdead; // must not perturb the pattern vector
+      b.add_event(marker);
+    }
+  }
+  a.finish();
+  b.finish();
+  assert(a.num_intervals() == 1);
+  assert(b.num_intervals() == 1);
+  std::cout << "[PASS] test_sideband_records_ignored_in_pattern\n";
+}
+
+int main() {
+  std::cout << "=== PhaseSampler Tests ===\n\n";
+
+  test_interval_boundaries();
+  test_clustering_separates_patterns();
+  test_uniform_trace_single_phase();
+  test_max_clusters_cap();
+  test_sideband_records_ignored_in_pattern();
+
+  std::cout << "\n=== All PhaseSampler Tests Passed! ===\n";
+  return 0;
+}
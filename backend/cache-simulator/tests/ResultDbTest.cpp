@@ -0,0 +1,186 @@
+#include "../include/ResultDb.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// A result document the way cache-sim emits it, trimmed to the fields
+// the database ingests
+static JsonValue make_doc(const std::string &config, uint64_t hits,
+                          uint64_t misses, uint64_t hot_hits,
+                          uint64_t hot_misses) {
+  std::string json = "{\"config\": \"" + config + "\", \"events\": " +
+                     std::to_string(hits + misses) +
+                     ", \"levels\": {\"l1d\": {\"hits\": " +
+                     std::to_string(hits) + ", \"misses\": " +
+                     std::to_string(misses) +
+                     "}, \"l2\": {\"hits\": 5, \"misses\": 5}, "
+                     "\"l3\": {\"hits\": 3, \"misses\": 2}}, "
+                     "\"timing\": {\"totalCycles\": 1000}, "
+                     "\"hotLines\": [{\"file\": \"kernel.c\", \"line\": 42, "
+                     "\"hits\": " + std::to_string(hot_hits) +
+                     ", \"misses\": " + std::to_string(hot_misses) + "}]}";
+  auto doc = JsonParser::parse(json);
+  assert(doc.has_value());
+  return *doc;
+}
+
+void test_ingest_run() {
+  ResultDb db;
+  uint32_t id = db.add_run(make_doc("intel", 900, 100, 50, 50), "matrix",
+                           "abc1234", 1000);
+  assert(id == 0);
+  assert(db.run_count() == 1);
+  assert(db.hot_line_count() == 1);
+
+  ResultRun run = db.get_run(0);
+  assert(run.config == "intel");
+  assert(run.label == "matrix");
+  assert(run.commit == "abc1234");
+  assert(run.events == 1000);
+  assert(run.l1d_hits == 900 && run.l1d_misses == 100);
+  assert(run.l2_hits == 5 && run.l3_misses == 2);
+  assert(run.total_cycles == 1000);
+  assert(run.l1d_miss_rate() == 0.1);
+
+  std::cout << "[PASS] test_ingest_run\n";
+}
+
+void test_trend() {
+  ResultDb db;
+  // The line's miss rate climbs across three nightly runs
+  db.add_run(make_doc("intel", 900, 100, 90, 10), "m", "aaa", 1000);
+  db.add_run(make_doc("intel", 900, 100, 70, 30), "m", "bbb", 2000);
+  db.add_run(make_doc("intel", 900, 100, 50, 50), "m", "ccc", 3000);
+
+  auto points = db.trend("kernel.c", 42);
+  assert(points.size() == 3);
+  assert(points[0].commit == "aaa" && points[0].miss_rate() == 0.1);
+  assert(points[2].commit == "ccc" && points[2].miss_rate() == 0.5);
+
+  // --last trims from the oldest end
+  auto tail = db.trend("kernel.c", 42, 2);
+  assert(tail.size() == 2);
+  assert(tail[0].commit == "bbb");
+
+  // An unknown line has no history
+  assert(db.trend("kernel.c", 999).empty());
+
+  std::cout << "[PASS] test_trend\n";
+}
+
+void test_regressions() {
+  ResultDb db;
+  db.add_run(make_doc("intel", 900, 100, 90, 10), "m", "aaa", 1000);
+  db.add_run(make_doc("intel", 900, 100, 60, 40), "m", "bbb", 2000);
+
+  // 10% -> 40% between the two newest runs
+  auto found = db.regressions(0.05);
+  assert(found.size() == 1);
+  assert(found[0].file == "kernel.c" && found[0].line == 42);
+  assert(found[0].before_rate == 0.1 && found[0].after_rate == 0.4);
+
+  // A higher bar filters it out
+  assert(db.regressions(0.5).empty());
+
+  // Improvements are never regressions
+  db.add_run(make_doc("intel", 900, 100, 95, 5), "m", "ccc", 3000);
+  assert(db.regressions(0.01).empty());
+
+  std::cout << "[PASS] test_regressions\n";
+}
+
+void test_matrix() {
+  ResultDb db;
+  db.add_run(make_doc("intel", 900, 100, 50, 50), "m", "aaa", 1000);
+  db.add_run(make_doc("amd", 800, 200, 50, 50), "m", "aaa", 1100);
+  db.add_run(make_doc("intel", 950, 50, 50, 50), "m", "bbb", 2000);
+  // A re-run of an existing cell replaces it
+  db.add_run(make_doc("amd", 700, 300, 50, 50), "m", "aaa", 2100);
+
+  auto cells = db.matrix();
+  assert(cells.size() == 3);
+  // Sorted by preset then commit
+  assert(cells[0].config == "amd" && cells[0].commit == "aaa");
+  assert(cells[0].l1d_miss_rate == 0.3); // the newer amd/aaa run won
+  assert(cells[1].config == "intel" && cells[1].commit == "aaa");
+  assert(cells[2].config == "intel" && cells[2].commit == "bbb");
+  assert(cells[2].l1d_miss_rate == 0.05);
+
+  std::cout << "[PASS] test_matrix\n";
+}
+
+void test_interval_ingestion() {
+  auto doc = JsonParser::parse(
+      "{\"config\": \"intel\", \"events\": 300, "
+      "\"intervals\": {\"granularity\": 100, "
+      "\"events\": [100, 100, 100], "
+      "\"l1dHits\": [90, 80, 70], "
+      "\"l1dMisses\": [10, 20, 30]}}");
+  assert(doc.has_value());
+
+  ResultDb db;
+  uint32_t id = db.add_run(*doc, "m", "aaa", 1000);
+  auto rows = db.intervals(id);
+  assert(rows.size() == 3);
+  assert(rows[0][0] == 100 && rows[0][1] == 90 && rows[0][2] == 10);
+  assert(rows[2][2] == 30);
+  assert(db.intervals(99).empty());
+
+  std::cout << "[PASS] test_interval_ingestion\n";
+}
+
+void test_save_load_roundtrip() {
+  const char *path = "/tmp/resultdb_test.cxrd";
+  {
+    ResultDb db;
+    db.add_run(make_doc("intel", 900, 100, 90, 10), "m", "aaa", 1000);
+    db.add_run(make_doc("amd", 800, 200, 60, 40), "m", "bbb", 2000);
+    db.save(path);
+  }
+
+  ResultDb loaded;
+  loaded.load(path);
+  assert(loaded.run_count() == 2);
+  assert(loaded.hot_line_count() == 2);
+  ResultRun run = loaded.get_run(1);
+  assert(run.config == "amd" && run.commit == "bbb");
+  assert(run.l1d_misses == 200);
+  assert(loaded.trend("kernel.c", 42).size() == 2);
+
+  // Appending after a reload keeps interning consistent
+  loaded.add_run(make_doc("amd", 850, 150, 50, 50), "m", "bbb", 3000);
+  auto cells = loaded.matrix();
+  assert(cells.size() == 2);
+
+  // A truncated file fails loudly instead of returning half a database
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write("CXRD", 4);
+  }
+  bool threw = false;
+  try {
+    ResultDb broken;
+    broken.load(path);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+
+  remove(path);
+  std::cout << "[PASS] test_save_load_roundtrip\n";
+}
+
+int main() {
+  std::cout << "Running ResultDb tests...\n\n";
+
+  test_ingest_run();
+  test_trend();
+  test_regressions();
+  test_matrix();
+  test_interval_ingestion();
+  test_save_load_roundtrip();
+
+  std::cout << "\n=== All 6 ResultDb tests passed! ===\n";
+  return 0;
+}
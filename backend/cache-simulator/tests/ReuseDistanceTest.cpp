@@ -0,0 +1,167 @@
+#include "../include/ReuseDistance.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Reference model: fully associative LRU cache of `lines` cache lines.
+// Counts misses the slow, obviously-correct way.
+static uint64_t reference_lru_misses(const std::vector<uint64_t> &trace,
+                                     uint64_t lines) {
+  std::list<uint64_t> stack; // front = MRU
+  std::unordered_map<uint64_t, std::list<uint64_t>::iterator> where;
+  uint64_t misses = 0;
+
+  for (uint64_t addr : trace) {
+    auto it = where.find(addr);
+    if (it != where.end()) {
+      stack.erase(it->second);
+    } else {
+      misses++;
+      if (stack.size() == lines) {
+        where.erase(stack.back());
+        stack.pop_back();
+      }
+    }
+    stack.push_front(addr);
+    where[addr] = stack.begin();
+  }
+  return misses;
+}
+
+void test_cold_misses_only() {
+  ReuseDistanceAnalyzer mrc;
+
+  // Every access touches a new line - all cold, no reuse
+  for (uint64_t i = 0; i < 1000; i++) {
+    mrc.access(i * 64);
+  }
+
+  assert(mrc.total_accesses() == 1000);
+  assert(mrc.cold_misses() == 1000);
+  assert(mrc.distinct_lines() == 1000);
+
+  // Cold misses are compulsory at every cache size
+  assert(mrc.misses_at(1) == 1000);
+  assert(mrc.misses_at(1 << 20) == 1000);
+
+  std::cout << "[PASS] test_cold_misses_only\n";
+}
+
+void test_exact_stack_distances() {
+  ReuseDistanceAnalyzer mrc;
+
+  // A B C A: the second A has stack distance 2 (B and C in between)
+  mrc.access(0x000);
+  mrc.access(0x040);
+  mrc.access(0x080);
+  mrc.access(0x000);
+
+  assert(mrc.total_accesses() == 4);
+  assert(mrc.cold_misses() == 3);
+
+  // A 1-line cache misses the reuse; a 4-line cache holds it
+  assert(mrc.misses_at(1) == 4);
+  assert(mrc.misses_at(4) == 3);
+
+  // Immediate reuse (distance 0) hits even in a 1-line cache
+  mrc.access(0x000);
+  assert(mrc.misses_at(1) == 4);
+
+  std::cout << "[PASS] test_exact_stack_distances\n";
+}
+
+void test_matches_reference_lru() {
+  // Mixed workload: a hot working set plus a cold streaming component
+  std::vector<uint64_t> trace;
+  std::srand(99);
+  for (int i = 0; i < 20000; i++) {
+    if (std::rand() % 4 == 0) {
+      trace.push_back((uint64_t)i * 64 + 0x100000); // streaming
+    } else {
+      trace.push_back((uint64_t)(std::rand() % 700) * 64); // hot set
+    }
+  }
+
+  ReuseDistanceAnalyzer mrc;
+  for (uint64_t addr : trace) {
+    mrc.access(addr);
+  }
+
+  // Power-of-two sizes are exact despite the bucketed histogram
+  for (uint64_t lines = 1; lines <= 4096; lines *= 2) {
+    assert(mrc.misses_at(lines) == reference_lru_misses(trace, lines));
+  }
+
+  std::cout << "[PASS] test_matches_reference_lru\n";
+}
+
+void test_compaction() {
+  // Tiny initial capacity forces many timestamp renumberings
+  ReuseDistanceAnalyzer small(64);
+  ReuseDistanceAnalyzer large(1 << 20);
+
+  std::srand(7);
+  std::vector<uint64_t> trace;
+  for (int i = 0; i < 50000; i++) {
+    trace.push_back((uint64_t)(std::rand() % 300) * 64);
+  }
+  for (uint64_t addr : trace) {
+    small.access(addr);
+    large.access(addr);
+  }
+
+  // Compaction must not change any answer
+  assert(small.cold_misses() == large.cold_misses());
+  for (uint64_t lines = 1; lines <= 1024; lines *= 2) {
+    assert(small.misses_at(lines) == large.misses_at(lines));
+  }
+
+  std::cout << "[PASS] test_compaction\n";
+}
+
+void test_miss_ratio_curve() {
+  ReuseDistanceAnalyzer mrc;
+
+  // 256 lines (16KB at 64B lines) swept repeatedly: fits in >=16KB caches
+  for (int pass = 0; pass < 10; pass++) {
+    for (uint64_t i = 0; i < 256; i++) {
+      mrc.access(i * 64);
+    }
+  }
+
+  auto curve = mrc.miss_ratio_curve(64, 4096, 1 << 20);
+  assert(!curve.empty());
+
+  // Monotonically non-increasing (LRU inclusion property)
+  for (size_t i = 1; i < curve.size(); i++) {
+    assert(curve[i].misses <= curve[i - 1].misses);
+    assert(curve[i].cache_bytes == curve[i - 1].cache_bytes * 2);
+  }
+
+  // Below the working set the sweep thrashes; at 16KB+ only cold misses remain
+  for (const auto &point : curve) {
+    if (point.cache_bytes >= 16384) {
+      assert(point.misses == 256);
+    } else {
+      assert(point.misses == 2560);
+    }
+  }
+
+  std::cout << "[PASS] test_miss_ratio_curve\n";
+}
+
+int main() {
+  std::cout << "Running ReuseDistance tests...\n\n";
+
+  test_cold_misses_only();
+  test_exact_stack_distances();
+  test_matches_reference_lru();
+  test_compaction();
+  test_miss_ratio_curve();
+
+  std::cout << "\nAll ReuseDistance tests passed!\n";
+  return 0;
+}
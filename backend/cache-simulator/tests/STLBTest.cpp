@@ -0,0 +1,213 @@
+#include "../include/CacheSystem.hpp"
+#include "../include/MultiCoreCacheSystem.hpp"
+#include "../include/PageWalker.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+
+void test_stlb_catches_l1_tlb_evictions() {
+  // 256 pages overflow the 64-entry DTLB but fit the STLB easily, so a
+  // second sweep misses the DTLB and hits the STLB
+  CacheSystem cache(make_educational_config());
+
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint64_t page = 0; page < 256; page++) {
+      cache.read(page * 4096);
+    }
+  }
+
+  auto tlb = cache.get_tlb_stats();
+  assert(tlb.dtlb.misses >= 256);
+  assert(tlb.stlb.hits >= 256);  // Second sweep translated by the STLB
+
+  std::cout << "[PASS] test_stlb_catches_l1_tlb_evictions\n";
+}
+
+void test_stlb_miss_triggers_walk() {
+  CacheSystem cache(make_educational_config());
+
+  cache.read(0x100000);
+
+  const TimingStats &timing = cache.get_timing_stats();
+  assert(timing.page_walks == 1);
+  assert(timing.page_walk_cycles > 0);
+  assert(cache.get_tlb_stats().stlb.misses == 1);
+
+  std::cout << "[PASS] test_stlb_miss_triggers_walk\n";
+}
+
+void test_pwc_shortens_neighbouring_walks() {
+  // Sequential pages share upper page-table levels: the first walk
+  // fetches all four, later walks only fetch the leaf PTE
+  PageWalker walker;
+  TimingStats timing;
+
+  auto first = walker.walk(0, timing);
+  auto second = walker.walk(1, timing);
+
+  assert(first.size() == 4);
+  assert(second.size() == 1);
+  assert(timing.page_walks == 2);
+  assert(timing.pwc_skipped_levels == 3);
+
+  std::cout << "[PASS] test_pwc_shortens_neighbouring_walks\n";
+}
+
+void test_pwc_partial_hit() {
+  // Same 1GB region but a different 2MB region: the PDE isn't cached
+  // yet, so the walk fetches the PDE and the PTE
+  PageWalker walker;
+  TimingStats timing;
+
+  walker.walk(0, timing);
+  auto walk = walker.walk(1 << 9, timing);  // Next 2MB region
+
+  assert(walk.size() == 2);
+
+  std::cout << "[PASS] test_pwc_partial_hit\n";
+}
+
+void test_walk_injection_reaches_caches() {
+  // With injection enabled, PTE fetches show up as L2 traffic; without
+  // it the walk only charges the flat per-PTE cost
+  CacheSystem flat(make_educational_config());
+  CacheSystem injected(make_educational_config());
+  injected.set_walk_injection(true);
+
+  flat.read(0x100000);
+  injected.read(0x100000);
+
+  auto flat_l2 = flat.get_stats().l2;
+  auto injected_l2 = injected.get_stats().l2;
+  assert(injected_l2.total_accesses() > flat_l2.total_accesses());
+  assert(injected.get_timing_stats().page_walk_cycles >
+         flat.get_timing_stats().page_walk_cycles);
+
+  std::cout << "[PASS] test_walk_injection_reaches_caches\n";
+}
+
+void test_repeated_walks_hit_cached_ptes() {
+  // Far-apart pages walked twice: the second round's PTE fetches hit
+  // the lines the first round installed in L2
+  CacheSystem cache(make_educational_config());
+  cache.set_walk_injection(true);
+
+  // Pages spaced 2MB apart: every walk fetches a distinct PDE and PTE,
+  // but the paging caches cover the two upper levels after walk one
+  for (uint64_t i = 0; i < 8; i++) {
+    cache.read(0x40000000 + i * (2ULL << 20));
+  }
+
+  const TimingStats &timing = cache.get_timing_stats();
+  assert(timing.page_walks == 8);
+  assert(timing.pwc_skipped_levels == 7 * 2);
+  // Walks never cost more than four uncached memory references each
+  uint64_t memory = static_cast<uint64_t>(cache.get_latency_config().memory);
+  assert(timing.page_walk_cycles < timing.page_walks * 4 * memory);
+
+  std::cout << "[PASS] test_repeated_walks_hit_cached_ptes\n";
+}
+
+void test_huge_pages_reduce_dtlb_misses() {
+  // A 4MB sweep touches 1024 4KB pages (thrashing the 64-entry DTLB on
+  // re-sweep) but only two 2MB pages
+  CacheSystem small(make_educational_config());
+  CacheSystem huge(make_educational_config());
+  huge.set_page_size(2ULL << 20);
+
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint64_t addr = 0; addr < (4ULL << 20); addr += 4096) {
+      small.read(addr);
+      huge.read(addr);
+    }
+  }
+
+  auto small_tlb = small.get_tlb_stats();
+  auto huge_tlb = huge.get_tlb_stats();
+  assert(huge_tlb.dtlb.misses == 2);
+  assert(small_tlb.dtlb.misses > huge_tlb.dtlb.misses);
+
+  std::cout << "[PASS] test_huge_pages_reduce_dtlb_misses\n";
+}
+
+void test_huge_page_walk_is_shorter() {
+  // 2MB pages resolve at the PDE (3 levels), 1GB at the PDPTE (2)
+  PageWalker walker;
+  TimingStats timing;
+
+  walker.set_levels(3);
+  assert(walker.walk(0, timing).size() == 3);
+  walker.set_levels(2);
+  assert(walker.walk(0, timing).size() == 2);
+
+  std::cout << "[PASS] test_huge_page_walk_is_shorter\n";
+}
+
+void test_page_size_round_trip() {
+  CacheSystem cache(make_educational_config());
+  assert(cache.get_page_size() == 4096);
+
+  cache.set_page_size(1ULL << 30);
+  assert(cache.get_page_size() == (1ULL << 30));
+
+  cache.set_page_size(4096);
+  assert(cache.get_page_size() == 4096);
+
+  std::cout << "[PASS] test_page_size_round_trip\n";
+}
+
+void test_multicore_huge_pages() {
+  CacheConfig l1 = {.kb_size = 1, .associativity = 2};
+  CacheConfig l2 = {.kb_size = 4, .associativity = 4};
+  CacheConfig l3 = {.kb_size = 16, .associativity = 8};
+  MultiCoreCacheSystem cache(2, l1, l2, l3);
+  cache.set_page_size(2ULL << 20);
+
+  for (uint64_t addr = 0; addr < (2ULL << 20); addr += 4096) {
+    cache.read(addr, 0, "test.c", 1);
+  }
+
+  auto tlb = cache.get_tlb_stats();
+  assert(tlb.dtlb.misses == 1);  // Whole sweep fits one 2MB page
+  assert(cache.get_page_size() == (2ULL << 20));
+
+  std::cout << "[PASS] test_multicore_huge_pages\n";
+}
+
+void test_multicore_stlb_stats() {
+  CacheConfig l1 = {.kb_size = 1, .associativity = 2};
+  CacheConfig l2 = {.kb_size = 4, .associativity = 4};
+  CacheConfig l3 = {.kb_size = 16, .associativity = 8};
+  MultiCoreCacheSystem cache(1, l1, l2, l3);
+
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint64_t page = 0; page < 128; page++) {
+      cache.read(page * 4096, 0, "test.c", 1);
+    }
+  }
+
+  auto tlb = cache.get_tlb_stats();
+  assert(tlb.dtlb.misses >= 128);
+  assert(tlb.stlb.hits >= 128);
+
+  std::cout << "[PASS] test_multicore_stlb_stats\n";
+}
+
+int main() {
+  std::cout << "Running STLB tests...\n\n";
+
+  test_stlb_catches_l1_tlb_evictions();
+  test_stlb_miss_triggers_walk();
+  test_pwc_shortens_neighbouring_walks();
+  test_pwc_partial_hit();
+  test_walk_injection_reaches_caches();
+  test_repeated_walks_hit_cached_ptes();
+  test_huge_pages_reduce_dtlb_misses();
+  test_huge_page_walk_is_shorter();
+  test_page_size_round_trip();
+  test_multicore_huge_pages();
+  test_multicore_stlb_stats();
+
+  std::cout << "\nAll STLB tests passed!\n";
+  return 0;
+}
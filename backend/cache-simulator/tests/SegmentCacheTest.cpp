@@ -0,0 +1,142 @@
+#include "../include/SegmentCache.hpp"
+#include "../include/TraceProcessor.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// Build a trace that replays the same access window many times (a tight loop)
+static std::vector<TraceEvent> make_loop_trace(size_t window, size_t repeats) {
+  std::vector<TraceEvent> events;
+  events.reserve(window * repeats);
+  for (size_t r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < window; i++) {
+      TraceEvent e;
+      e.address = 0x10000 + i * 64;
+      e.size = 4;
+      e.file = "loop.c";
+      e.line = 10;
+      events.push_back(e);
+    }
+  }
+  return events;
+}
+
+void test_pattern_hashing() {
+  uint64_t h1 = SegmentCache::HASH_SEED;
+  uint64_t h2 = SegmentCache::HASH_SEED;
+  h1 = SegmentCache::hash_access(h1, 0x1000, 0);
+  h2 = SegmentCache::hash_access(h2, 0x1000, 0);
+  assert(h1 == h2);
+
+  // Different address, flags, or order must produce different hashes
+  uint64_t h3 = SegmentCache::hash_access(SegmentCache::HASH_SEED, 0x1040, 0);
+  uint64_t h4 = SegmentCache::hash_access(SegmentCache::HASH_SEED, 0x1000, 1);
+  assert(h1 != h3);
+  assert(h1 != h4);
+
+  uint64_t a = SegmentCache::hash_access(
+      SegmentCache::hash_access(SegmentCache::HASH_SEED, 0x1000, 0), 0x2000, 0);
+  uint64_t b = SegmentCache::hash_access(
+      SegmentCache::hash_access(SegmentCache::HASH_SEED, 0x2000, 0), 0x1000, 0);
+  assert(a != b);
+
+  std::cout << "[PASS] test_pattern_hashing\n";
+}
+
+void test_basic_caching() {
+  // A repeated loop window must produce identical totals with and without
+  // segment caching, and the cached run must actually fast-forward
+  auto cfg = make_educational_config();
+  auto events = make_loop_trace(64, 100);
+
+  TraceProcessor reference(cfg);
+  for (const auto &e : events)
+    reference.process(e);
+  auto ref_stats = reference.get_stats();
+
+  TraceProcessor cached(cfg);
+  cached.enable_segment_caching(64);
+  for (const auto &e : events)
+    cached.process(e);
+  cached.flush_segments();
+  auto stats = cached.get_stats();
+
+  assert(stats.l1d.hits == ref_stats.l1d.hits);
+  assert(stats.l1d.misses == ref_stats.l1d.misses);
+  assert(stats.l2.hits == ref_stats.l2.hits);
+  assert(stats.l2.misses == ref_stats.l2.misses);
+  assert(stats.l3.hits == ref_stats.l3.hits);
+  assert(stats.l3.misses == ref_stats.l3.misses);
+  assert(stats.timing.total_cycles == ref_stats.timing.total_cycles);
+
+  const auto &seg = cached.get_segment_cache_stats();
+  assert(seg.fast_forwards > 0);
+
+  // Hot-line attribution must survive fast-forwarding too
+  auto hot = cached.get_hot_lines(5);
+  auto ref_hot = reference.get_hot_lines(5);
+  assert(hot.size() == ref_hot.size());
+  assert(hot[0].hits == ref_hot[0].hits);
+  assert(hot[0].misses == ref_hot[0].misses);
+
+  std::cout << "[PASS] test_basic_caching\n";
+}
+
+void test_cache_statistics() {
+  auto cfg = make_educational_config();
+  auto events = make_loop_trace(64, 20);
+
+  TraceProcessor processor(cfg);
+  processor.enable_segment_caching(64);
+  for (const auto &e : events)
+    processor.process(e);
+  processor.flush_segments();
+
+  const auto &seg = processor.get_segment_cache_stats();
+  assert(seg.lookups == 20); // One lookup per completed window
+  // The cold first window and the cache/TLB warm-up behind it keep the
+  // early deltas shifting; the entry goes stable once two consecutive
+  // simulated runs agree (the fourth window here), then every later
+  // window fast-forwards
+  assert(seg.fast_forwards == 16);
+  assert(seg.hit_rate() >= 0.8);
+  assert(seg.divergences == 0);
+
+  std::cout << "[PASS] test_cache_statistics\n";
+}
+
+void test_lru_eviction() {
+  SegmentCache cache(2); // Room for only two entries
+
+  SegmentDelta delta;
+  delta.hierarchy.l1d.hits = 1;
+
+  cache.record(0x1, delta);
+  cache.record(0x2, delta);
+  assert(cache.size() == 2);
+
+  // Touch 0x1 so 0x2 becomes the LRU victim
+  assert(cache.lookup(0x1) != nullptr);
+  cache.record(0x3, delta);
+
+  assert(cache.size() == 2);
+  assert(cache.lookup(0x1) != nullptr);
+  assert(cache.lookup(0x2) == nullptr);
+  assert(cache.lookup(0x3) != nullptr);
+  assert(cache.get_stats().evictions == 1);
+
+  std::cout << "[PASS] test_lru_eviction\n";
+}
+
+int main() {
+  std::cout << "Running SegmentCache tests...\n\n";
+
+  test_pattern_hashing();
+  test_basic_caching();
+  test_cache_statistics();
+  test_lru_eviction();
+
+  std::cout << "\n=== All 4 SegmentCache tests passed! ===\n";
+  return 0;
+}
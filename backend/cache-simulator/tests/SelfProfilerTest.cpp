@@ -0,0 +1,99 @@
+#include "../include/SelfProfiler.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+void test_tick_source_monotonic() {
+  uint64_t a = SelfProfiler::read_ticks();
+  volatile uint64_t sink = 0;
+  for (int i = 0; i < 100000; i++) {
+    sink += i;
+  }
+  uint64_t b = SelfProfiler::read_ticks();
+  assert(b > a);
+
+  std::cout << "[PASS] test_tick_source_monotonic\n";
+}
+
+void test_disabled_is_inert() {
+  std::stringstream out;
+  {
+    SelfProfiler prof(false);
+    prof.set_report_stream(out);
+    prof.enter(ProfileStage::Read);
+    prof.enter(ProfileStage::Simulate);
+    assert(!prof.is_enabled());
+    assert(prof.stage_ticks(ProfileStage::Read) == 0);
+  }
+  // Disabled profiler prints nothing at destruction
+  assert(out.str().empty());
+
+  std::cout << "[PASS] test_disabled_is_inert\n";
+}
+
+void test_stage_accounting() {
+  SelfProfiler prof(true);
+  std::stringstream sink;
+  prof.set_report_stream(sink);
+
+  prof.enter(ProfileStage::Read);
+  volatile uint64_t work = 0;
+  for (int i = 0; i < 100000; i++) {
+    work += i;
+  }
+  prof.enter(ProfileStage::Parse);
+  for (int i = 0; i < 100000; i++) {
+    work += i;
+  }
+  prof.enter(ProfileStage::Simulate);
+
+  // enter() closes the previous stage, so read and parse have ticks and
+  // the still-open simulate stage does not yet
+  assert(prof.stage_ticks(ProfileStage::Read) > 0);
+  assert(prof.stage_ticks(ProfileStage::Parse) > 0);
+  assert(prof.stage_ticks(ProfileStage::Simulate) == 0);
+  assert(prof.stage_ticks(ProfileStage::Output) == 0);
+
+  // Re-entering a stage accumulates rather than resets
+  uint64_t read_before = prof.stage_ticks(ProfileStage::Read);
+  prof.enter(ProfileStage::Read);
+  prof.enter(ProfileStage::Output);
+  assert(prof.stage_ticks(ProfileStage::Read) >= read_before);
+
+  std::cout << "[PASS] test_stage_accounting\n";
+}
+
+void test_report_format() {
+  std::stringstream out;
+  {
+    SelfProfiler prof(true);
+    prof.set_report_stream(out);
+    prof.set_bytes_read(1 << 20);
+    prof.set_events(50000);
+    prof.enter(ProfileStage::Read);
+    prof.enter(ProfileStage::Parse);
+    prof.enter(ProfileStage::Simulate);
+    prof.enter(ProfileStage::Output);
+  }
+  std::string report = out.str();
+  assert(report.find("[self-profile]") != std::string::npos);
+  assert(report.find("read") != std::string::npos);
+  assert(report.find("parse") != std::string::npos);
+  assert(report.find("simulate") != std::string::npos);
+  assert(report.find("output") != std::string::npos);
+  assert(report.find("events: 50000") != std::string::npos);
+
+  std::cout << "[PASS] test_report_format\n";
+}
+
+int main() {
+  std::cout << "Running SelfProfiler tests...\n\n";
+
+  test_tick_source_monotonic();
+  test_disabled_is_inert();
+  test_stage_accounting();
+  test_report_format();
+
+  std::cout << "\n=== All 4 SelfProfiler tests passed! ===\n";
+  return 0;
+}
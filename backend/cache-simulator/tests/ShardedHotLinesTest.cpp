@@ -0,0 +1,129 @@
+#include "../include/ShardedHotLines.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Test 1: counts recorded into a single shard come back intact
+void test_single_shard_counts() {
+  ShardedHotLines shards(4);
+  std::string_view file = "kernel.c";
+  for (int i = 0; i < 10; i++)
+    shards.record(0, file, 42, i % 2 == 0, 0);
+
+  auto top = shards.merge_top_k(10);
+  assert(top.size() == 1);
+  assert(top[0].file == "kernel.c" && top[0].line == 42);
+  assert(top[0].hits == 5 && top[0].misses == 5);
+
+  std::cout << "[PASS] test_single_shard_counts\n";
+}
+
+// Test 2: the same line recorded by several shards folds into one record
+// - counts sum, thread masks union
+void test_cross_shard_fold() {
+  ShardedHotLines shards(4);
+  std::string_view file = "worker.c";
+  shards.record(0, file, 10, false, 0); // miss on core 0
+  shards.record(1, file, 10, false, 1); // miss on core 1
+  shards.record(2, file, 10, true, 2);  // hit on core 2
+  shards.record(3, file, 10, true, 3);  // hit on core 3
+
+  auto top = shards.merge_top_k(10);
+  assert(top.size() == 1);
+  assert(top[0].hits == 2 && top[0].misses == 2);
+  assert(top[0].thread_mask == 0xF);
+
+  std::cout << "[PASS] test_cross_shard_fold\n";
+}
+
+// Test 3: merge_top_k keeps only the K hottest lines, descending by
+// misses, even when their counts are split across shards
+void test_top_k_bound() {
+  ShardedHotLines shards(2);
+  // Lines 0..9: line n collects n+1 misses, alternating shards
+  std::string_view file = "hot.c";
+  for (uint32_t line = 0; line < 10; line++) {
+    for (uint32_t i = 0; i <= line; i++)
+      shards.record(i % 2, file, line, false, 0);
+  }
+
+  auto top = shards.merge_top_k(3);
+  assert(top.size() == 3);
+  assert(top[0].line == 9 && top[0].misses == 10);
+  assert(top[1].line == 8 && top[1].misses == 9);
+  assert(top[2].line == 7 && top[2].misses == 8);
+
+  std::cout << "[PASS] test_top_k_bound\n";
+}
+
+// Test 4: equal miss counts break ties by file then line, so the cut is
+// deterministic regardless of shard count
+void test_deterministic_ties() {
+  std::string_view a = "a.c";
+  std::string_view b = "b.c";
+  for (size_t num_shards : {1, 2, 8}) {
+    ShardedHotLines shards(num_shards);
+    shards.record(0, b, 5, false, 0);
+    shards.record(num_shards - 1, a, 9, false, 0);
+    shards.record(0, a, 3, false, 0);
+
+    auto top = shards.merge_top_k(2);
+    assert(top.size() == 2);
+    assert(top[0].file == "a.c" && top[0].line == 3);
+    assert(top[1].file == "a.c" && top[1].line == 9);
+  }
+
+  std::cout << "[PASS] test_deterministic_ties\n";
+}
+
+// Test 5: for_each_merged visits each distinct line exactly once with
+// folded counts - the per-function rollup depends on it
+void test_for_each_merged() {
+  ShardedHotLines shards(3);
+  std::string_view file = "loop.c";
+  for (size_t s = 0; s < 3; s++) {
+    shards.record(s, file, 1, false, (uint32_t)s);
+    shards.record(s, file, 2, true, (uint32_t)s);
+  }
+
+  size_t visits = 0;
+  uint64_t hits = 0, misses = 0;
+  shards.for_each_merged([&](const ShardedHotLines::Entry &e) {
+    visits++;
+    hits += e.hits;
+    misses += e.misses;
+    assert(e.line == 1 ? e.misses == 3 : e.hits == 3);
+  });
+  assert(visits == 2);
+  assert(hits == 3 && misses == 3);
+
+  std::cout << "[PASS] test_for_each_merged\n";
+}
+
+// Test 6: empty shards stay out of the way
+void test_empty() {
+  ShardedHotLines shards(8);
+  assert(shards.empty());
+  assert(shards.merge_top_k(10).empty());
+
+  shards.record(5, "only.c", 1, false, 0);
+  assert(!shards.empty());
+  assert(shards.merge_top_k(10).size() == 1);
+
+  std::cout << "[PASS] test_empty\n";
+}
+
+int main() {
+  std::cout << "Running ShardedHotLines tests...\n\n";
+
+  test_single_shard_counts();
+  test_cross_shard_fold();
+  test_top_k_bound();
+  test_deterministic_ties();
+  test_for_each_merged();
+  test_empty();
+
+  std::cout << "\n=== All 6 ShardedHotLines tests passed! ===\n";
+  return 0;
+}
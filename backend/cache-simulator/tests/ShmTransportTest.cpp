@@ -0,0 +1,212 @@
+#include "../include/ShmTransport.hpp"
+#include "../include/TraceEvent.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Stands in for the runtime: creates a segment with the CXSM layout and
+// produces events the way cache-explorer-rt.c does (claim a ring slot,
+// write the record, release-store head)
+class FakeProducer {
+public:
+  explicit FakeProducer(const std::string &path) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    int rc = ftruncate(fd, (off_t)SHM_SEGMENT_SIZE);
+    assert(rc == 0);
+    (void)rc;
+    base_ = mmap(nullptr, SHM_SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+    close(fd);
+    assert(base_ != MAP_FAILED);
+    header_ = static_cast<ShmTraceHeader *>(base_);
+    header_->version = SHM_TRACE_VERSION;
+    header_->ring_events = SHM_RING_EVENTS;
+    header_->max_rings = SHM_MAX_RINGS;
+    header_->max_files = SHM_MAX_FILES;
+    uint32_t magic;
+    memcpy(&magic, SHM_TRACE_MAGIC, 4);
+    __atomic_store_n(reinterpret_cast<uint32_t *>(header_->magic), magic,
+                     __ATOMIC_RELEASE);
+  }
+
+  ~FakeProducer() {
+    munmap(base_, SHM_SEGMENT_SIZE);
+    remove(path_.c_str());
+  }
+
+  uint32_t claim_ring() {
+    return __atomic_fetch_add(&header_->num_rings, 1, __ATOMIC_RELAXED);
+  }
+
+  void register_file(uint32_t id, const char *name) {
+    auto *entries = reinterpret_cast<ShmFileEntry *>(
+        static_cast<char *>(base_) + SHM_FILE_OFF);
+    strncpy(entries[id].name, name, SHM_NAME_MAX - 1);
+    __atomic_store_n(&entries[id].ready, 1, __ATOMIC_RELEASE);
+  }
+
+  // Blocks while the ring is full, like the runtime's bounded wait
+  void push(uint32_t slot, uint64_t address, uint32_t size, uint32_t file_id,
+            uint32_t line, uint32_t tid) {
+    ShmRing *r = ring(slot);
+    uint64_t head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    uint64_t next = (head + 1) & (SHM_RING_EVENTS - 1);
+    while (next == __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE)) {
+      std::this_thread::yield();
+    }
+    r->events[head] = {address, 0, size, (file_id << 20) | line, tid, 0};
+    __atomic_store_n(&r->head, next, __ATOMIC_RELEASE);
+  }
+
+  void finish(uint64_t dropped = 0) {
+    __atomic_store_n(&header_->dropped_events, dropped, __ATOMIC_RELAXED);
+    __atomic_store_n(&header_->producer_done, 1, __ATOMIC_RELEASE);
+  }
+
+  const std::string &path() const { return path_; }
+
+private:
+  ShmRing *ring(uint32_t slot) {
+    return reinterpret_cast<ShmRing *>(static_cast<char *>(base_) +
+                                       SHM_RING_OFF + slot * SHM_RING_STRIDE);
+  }
+
+  std::string path_;
+  void *base_ = nullptr;
+  ShmTraceHeader *header_ = nullptr;
+};
+
+void test_open_times_out_without_producer() {
+  ShmTraceConsumer consumer;
+  assert(!consumer.open("/tmp/shm-transport-test-missing", 50));
+
+  std::cout << "[PASS] test_open_times_out_without_producer\n";
+}
+
+void test_consume_decodes_events_and_files() {
+  FakeProducer producer("/tmp/shm-transport-test-basic");
+  uint32_t slot = producer.claim_ring();
+  producer.register_file(0, "main.c");
+  producer.push(slot, 0x1000, 8, 0, 42, 1);
+  producer.push(slot, 0x2000 | (1ULL << 63), 4, 0, 43, 1);  // store bit
+  producer.finish();
+
+  ShmTraceConsumer consumer;
+  bool opened = consumer.open(producer.path(), 1000);
+  assert(opened);
+  (void)opened;
+
+  std::vector<TraceEvent> events;
+  uint64_t n = consumer.consume([&](TraceEvent e) { events.push_back(e); });
+  assert(n == 2);
+  assert(events[0].address == 0x1000 && !events[0].is_write);
+  assert(events[0].size == 8 && events[0].line == 42);
+  assert(events[0].file == "main.c");
+  assert(events[1].address == 0x2000 && events[1].is_write);
+  assert(events[1].line == 43);
+  assert(consumer.dropped() == 0);
+
+  std::cout << "[PASS] test_consume_decodes_events_and_files\n";
+}
+
+void test_multiple_rings_and_dropped_count() {
+  FakeProducer producer("/tmp/shm-transport-test-rings");
+  producer.register_file(0, "a.c");
+  uint32_t s0 = producer.claim_ring();
+  uint32_t s1 = producer.claim_ring();
+  for (int i = 0; i < 10; i++) {
+    producer.push(s0, 0x1000 + i * 64, 8, 0, 1, 1);
+  }
+  for (int i = 0; i < 7; i++) {
+    producer.push(s1, 0x8000 + i * 64, 8, 0, 2, 2);
+  }
+  producer.finish(3);
+
+  ShmTraceConsumer consumer;
+  bool opened = consumer.open(producer.path(), 1000);
+  assert(opened);
+  (void)opened;
+  uint64_t per_thread[3] = {0, 0, 0};
+  uint64_t n = consumer.consume(
+      [&](TraceEvent e) { per_thread[e.thread_id]++; });
+  assert(n == 17);
+  assert(per_thread[1] == 10 && per_thread[2] == 7);
+  assert(consumer.dropped() == 3);
+
+  std::cout << "[PASS] test_multiple_rings_and_dropped_count\n";
+}
+
+void test_ring_wraparound() {
+  FakeProducer producer("/tmp/shm-transport-test-wrap");
+  producer.register_file(0, "wrap.c");
+  uint32_t slot = producer.claim_ring();
+
+  // More events than the ring holds: drain concurrently so the producer's
+  // bounded wait always finds space, and the indices wrap several times
+  const uint64_t total = SHM_RING_EVENTS * 3ull + 123;
+  std::thread writer([&] {
+    for (uint64_t i = 0; i < total; i++) {
+      producer.push(slot, 0x10000 + (i % 4096) * 64, 8, 0, 1, 1);
+    }
+    producer.finish();
+  });
+
+  ShmTraceConsumer consumer;
+  bool opened = consumer.open(producer.path(), 1000);
+  assert(opened);
+  (void)opened;
+  uint64_t n = consumer.consume([&](const TraceEvent &) {});
+  writer.join();
+  assert(n == total);
+
+  std::cout << "[PASS] test_ring_wraparound\n";
+}
+
+void test_live_producer_registers_late() {
+  // The consumer may map the segment before any ring or file exists;
+  // rings and registrations published mid-run must still be picked up
+  FakeProducer producer("/tmp/shm-transport-test-late");
+
+  ShmTraceConsumer consumer;
+  bool opened = consumer.open(producer.path(), 1000);
+  assert(opened);
+  (void)opened;
+
+  std::thread writer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    producer.register_file(0, "late.c");
+    uint32_t slot = producer.claim_ring();
+    for (int i = 0; i < 100; i++) {
+      producer.push(slot, 0x4000 + i * 8, 8, 0, 9, 1);
+    }
+    producer.finish();
+  });
+
+  std::vector<TraceEvent> events;
+  uint64_t n = consumer.consume([&](TraceEvent e) { events.push_back(e); });
+  writer.join();
+  assert(n == 100);
+  assert(events.front().file == "late.c");
+  assert(events.back().address == 0x4000 + 99 * 8);
+
+  std::cout << "[PASS] test_live_producer_registers_late\n";
+}
+
+int main() {
+  std::cout << "Running ShmTransport tests...\n\n";
+
+  test_open_times_out_without_producer();
+  test_consume_decodes_events_and_files();
+  test_multiple_rings_and_dropped_count();
+  test_ring_wraparound();
+  test_live_producer_registers_late();
+
+  std::cout << "\nAll ShmTransport tests passed!\n";
+  return 0;
+}
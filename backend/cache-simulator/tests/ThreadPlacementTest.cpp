@@ -0,0 +1,146 @@
+#include "../include/MultiCoreCacheSystem.hpp"
+#include "../profiles/CacheConfig.hpp"
+#include <cassert>
+#include <iostream>
+
+// Small caches - placement is about which core a thread lands on, not
+// about hits and misses. 8 cores throughout.
+CacheConfig make_tp_l1_config() {
+  return {.kb_size = 1, .associativity = 2, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_tp_l2_config() {
+  return {.kb_size = 4, .associativity = 4, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+CacheConfig make_tp_l3_config() {
+  return {.kb_size = 16, .associativity = 8, .line_size = 64,
+          .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back};
+}
+
+MultiCoreCacheSystem make_system() {
+  return MultiCoreCacheSystem(8, make_tp_l1_config(), make_tp_l2_config(),
+                              make_tp_l3_config());
+}
+
+// Test 1: without topology, compact and scatter coincide with the old
+// round-robin - one LLC domain means there is nothing to spread across
+void test_flat_chip_round_robin() {
+  for (ThreadPlacement policy :
+       {ThreadPlacement::Scatter, ThreadPlacement::Compact}) {
+    MultiCoreCacheSystem cache = make_system();
+    cache.set_thread_placement(policy);
+    for (uint32_t t = 0; t < 8; t++) {
+      assert(cache.get_core_for_thread(t) == static_cast<int>(t));
+    }
+  }
+
+  std::cout << "[PASS] test_flat_chip_round_robin\n";
+}
+
+// Test 2: scatter under CCX topology spreads breadth-first across
+// complexes - the behavior the CCX work introduced, now as the default
+// policy
+void test_scatter_across_ccxes() {
+  MultiCoreCacheSystem cache = make_system();
+  cache.enable_ccx_topology(4);
+  assert(cache.get_thread_placement() == ThreadPlacement::Scatter);
+
+  // 2 CCXes of 4: threads alternate complexes (0, 4, 1, 5, ...)
+  assert(cache.get_core_for_thread(0) == 0);
+  assert(cache.get_core_for_thread(1) == 4);
+  assert(cache.get_core_for_thread(2) == 1);
+  assert(cache.get_core_for_thread(3) == 5);
+
+  std::cout << "[PASS] test_scatter_across_ccxes\n";
+}
+
+// Test 3: compact fills one CCX before spilling into the next, so
+// co-scheduled threads share an L3 slice
+void test_compact_fills_ccx_first() {
+  MultiCoreCacheSystem cache = make_system();
+  cache.enable_ccx_topology(4);
+  cache.set_thread_placement(ThreadPlacement::Compact);
+
+  for (uint32_t t = 0; t < 8; t++) {
+    assert(cache.get_core_for_thread(t) == static_cast<int>(t));
+  }
+
+  std::cout << "[PASS] test_compact_fills_ccx_first\n";
+}
+
+// Test 4: scatter is socket-aware under NUMA - threads alternate
+// sockets just as they alternate CCXes
+void test_socket_aware_scatter() {
+  MultiCoreCacheSystem cache = make_system();
+  cache.enable_numa(2, NumaPlacement::FirstTouch);
+
+  // 2 sockets of 4 cores: threads alternate sockets (0, 4, 1, 5, ...)
+  assert(cache.get_core_for_thread(0) == 0);
+  assert(cache.get_core_for_thread(1) == 4);
+  assert(cache.get_core_for_thread(2) == 1);
+
+  std::cout << "[PASS] test_socket_aware_scatter\n";
+}
+
+// Test 5: explicit pins override the policy and don't consume policy
+// slots, so unpinned threads assign as if the pins weren't there
+void test_pins_override_policy() {
+  MultiCoreCacheSystem cache = make_system();
+  cache.enable_ccx_topology(4);
+  cache.pin_thread(1, 7);
+  cache.pin_thread(3, 7);
+  assert(cache.get_pinned_thread_count() == 2);
+
+  assert(cache.get_core_for_thread(0) == 0);  // policy slot 0
+  assert(cache.get_core_for_thread(1) == 7);  // pinned
+  assert(cache.get_core_for_thread(2) == 4);  // policy slot 1, not 2
+  assert(cache.get_core_for_thread(3) == 7);  // pinned, shares the core
+  assert(cache.get_core_for_thread(4) == 1);  // policy slot 2
+
+  // Assignments are sticky on repeat lookups
+  assert(cache.get_core_for_thread(1) == 7);
+  assert(cache.get_core_for_thread(2) == 4);
+
+  std::cout << "[PASS] test_pins_override_policy\n";
+}
+
+// Test 6: the thread map records every assignment (pins and policy
+// alike) and traffic lands on the mapped cores
+void test_thread_map_and_traffic() {
+  MultiCoreCacheSystem cache = make_system();
+  cache.enable_ccx_topology(4);
+  cache.set_thread_placement(ThreadPlacement::Compact);
+  cache.pin_thread(1, 6);
+
+  cache.read(0x0000, 0);  // compact slot 0 -> core 0
+  cache.read(0x1000, 1);  // pinned -> core 6
+  cache.read(0x2000, 2);  // compact slot 1 -> core 1
+
+  const auto &tmap = cache.get_thread_map();
+  assert(tmap.size() == 3);
+  assert(tmap.at(0) == 0 && tmap.at(1) == 6 && tmap.at(2) == 1);
+
+  auto stats = cache.get_stats();
+  assert(stats.l1_per_core[0].total_accesses() == 1);
+  assert(stats.l1_per_core[1].total_accesses() == 1);
+  assert(stats.l1_per_core[6].total_accesses() == 1);
+
+  std::cout << "[PASS] test_thread_map_and_traffic\n";
+}
+
+int main() {
+  std::cout << "Running ThreadPlacement tests...\n\n";
+
+  test_flat_chip_round_robin();
+  test_scatter_across_ccxes();
+  test_compact_fills_ccx_first();
+  test_socket_aware_scatter();
+  test_pins_override_policy();
+  test_thread_map_and_traffic();
+
+  std::cout << "\n=== All 6 ThreadPlacement tests passed! ===\n";
+  return 0;
+}
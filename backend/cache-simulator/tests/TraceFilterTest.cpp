@@ -0,0 +1,208 @@
+#include "../include/TraceFilter.hpp"
+#include <cassert>
+#include <iostream>
+
+namespace {
+
+TraceEvent make_access(uint64_t addr, std::string_view file, uint32_t line,
+                       bool is_write = false) {
+  TraceEvent e;
+  e.address = addr;
+  e.size = 8;
+  e.file = file;
+  e.line = line;
+  e.is_write = is_write;
+  return e;
+}
+
+TraceEvent make_alloc(uint64_t base, uint32_t size, std::string_view site_file,
+                      uint32_t site_line) {
+  TraceEvent e;
+  e.is_alloc = true;
+  e.address = base;
+  e.size = size;
+  e.file = site_file;
+  e.line = site_line;
+  return e;
+}
+
+TraceEvent make_free(uint64_t base) {
+  TraceEvent e;
+  e.is_free = true;
+  e.address = base;
+  return e;
+}
+
+} // namespace
+
+void test_glob_match() {
+  assert(glob_match("main.c", "main.c"));
+  assert(!glob_match("main.c", "main.cpp"));
+  assert(glob_match("*.c", "main.c"));
+  assert(!glob_match("*.c", "main.cpp"));
+  assert(glob_match("src/*", "src/hash.c"));
+  assert(glob_match("*hash*", "src/hash_table.cpp"));
+  assert(glob_match("?ain.c", "main.c"));
+  assert(!glob_match("?ain.c", "ain.c"));
+  assert(glob_match("*", "anything/at.all"));
+  assert(glob_match("heap[0x*]", "heap[0x401234]"));
+  assert(!glob_match("", "main.c"));
+  assert(glob_match("", ""));
+
+  std::cout << "[PASS] test_glob_match\n";
+}
+
+void test_inactive_filter_admits_everything() {
+  TraceFilter filter;
+  assert(!filter.active());
+  assert(filter.admit(make_access(0x1000, "main.c", 10)));
+  assert(filter.admit(make_alloc(0x5000, 64, "main.c", 3)));
+  assert(filter.excluded() == 0);
+
+  std::cout << "[PASS] test_inactive_filter_admits_everything\n";
+}
+
+void test_file_glob() {
+  TraceFilter filter;
+  filter.set_file_glob("hash*.c");
+  assert(filter.active());
+  assert(filter.admit(make_access(0x1000, "hash_table.c", 10)));
+  assert(!filter.admit(make_access(0x2000, "main.c", 5)));
+  // Events with no source attribution fail a file filter
+  assert(!filter.admit(make_access(0x3000, "", 0)));
+  assert(filter.excluded() == 2);
+
+  std::cout << "[PASS] test_file_glob\n";
+}
+
+void test_addr_range() {
+  TraceFilter filter;
+  filter.set_addr_range(0x1000, 0x2000);
+  assert(filter.admit(make_access(0x1000, "a.c", 1)));
+  assert(filter.admit(make_access(0x1ff8, "a.c", 1)));
+  assert(!filter.admit(make_access(0x2000, "a.c", 1)));
+  assert(!filter.admit(make_access(0xff0, "a.c", 1)));
+  // An 8-byte access straddling the lower bound overlaps the window
+  assert(filter.admit(make_access(0xffc, "a.c", 1)));
+
+  std::cout << "[PASS] test_addr_range\n";
+}
+
+void test_addr_range_covers_strided_span() {
+  TraceFilter filter;
+  filter.set_addr_range(0x10000, 0x11000);
+
+  // Range event starting below the window but striding through it
+  TraceEvent e = make_access(0x8000, "loop.c", 7);
+  e.is_range = true;
+  e.stride = 64;
+  e.count = 1024;  // spans [0x8000, 0x18008)
+  assert(filter.admit(e));
+
+  // Same base, too few iterations to reach the window
+  e.count = 4;
+  assert(!filter.admit(e));
+
+  // Negative stride walking down into the window
+  e.address = 0x18000;
+  e.stride = -64;
+  e.count = 1024;
+  assert(filter.admit(e));
+
+  std::cout << "[PASS] test_addr_range_covers_strided_span\n";
+}
+
+void test_heap_include() {
+  TraceFilter filter;
+  filter.set_heap_glob("table.c*", false);
+
+  // Side-band records always pass, whatever they match
+  assert(filter.admit(make_alloc(0x10000, 256, "table.c", 42)));
+  assert(filter.admit(make_alloc(0x20000, 256, "other.c", 9)));
+
+  // Only accesses into the table.c allocation survive
+  assert(filter.admit(make_access(0x10080, "a.c", 1)));
+  assert(!filter.admit(make_access(0x20080, "a.c", 1)));
+  assert(!filter.admit(make_access(0x30000, "a.c", 1)));  // not heap at all
+  assert(!filter.admit(make_access(0x10100, "a.c", 1)));  // one past the end
+
+  // After the free, the range no longer matches
+  assert(filter.admit(make_free(0x10000)));
+  assert(!filter.admit(make_access(0x10080, "a.c", 1)));
+
+  std::cout << "[PASS] test_heap_include\n";
+}
+
+void test_heap_site_line_match() {
+  TraceFilter filter;
+  filter.set_heap_glob("alloc.c:42", false);
+  assert(filter.admit(make_alloc(0x10000, 128, "alloc.c", 42)));
+  assert(filter.admit(make_alloc(0x20000, 128, "alloc.c", 99)));
+  assert(filter.admit(make_access(0x10000, "a.c", 1)));
+  assert(!filter.admit(make_access(0x20000, "a.c", 1)));
+
+  std::cout << "[PASS] test_heap_site_line_match\n";
+}
+
+void test_heap_exclude() {
+  TraceFilter filter;
+  filter.set_heap_glob("scratch.c*", true);
+  assert(filter.admit(make_alloc(0x10000, 256, "scratch.c", 7)));
+  assert(filter.admit(make_alloc(0x20000, 256, "table.c", 3)));
+
+  assert(!filter.admit(make_access(0x10010, "a.c", 1)));  // in scratch buffer
+  assert(filter.admit(make_access(0x20010, "a.c", 1)));   // other allocation
+  assert(filter.admit(make_access(0x90000, "a.c", 1)));   // stack/global
+
+  std::cout << "[PASS] test_heap_exclude\n";
+}
+
+void test_filters_compose() {
+  TraceFilter filter;
+  filter.set_file_glob("hot.c");
+  filter.set_addr_range(0x1000, 0x2000);
+  assert(filter.admit(make_access(0x1800, "hot.c", 12)));
+  assert(!filter.admit(make_access(0x1800, "cold.c", 12)));
+  assert(!filter.admit(make_access(0x4000, "hot.c", 12)));
+
+  std::cout << "[PASS] test_filters_compose\n";
+}
+
+void test_compact_preserves_order() {
+  TraceFilter filter;
+  filter.set_file_glob("keep.c");
+
+  std::vector<TraceEvent> events;
+  events.push_back(make_access(0x100, "keep.c", 1));
+  events.push_back(make_access(0x200, "drop.c", 2));
+  events.push_back(make_access(0x300, "keep.c", 3));
+  events.push_back(make_access(0x400, "drop.c", 4));
+  events.push_back(make_access(0x500, "keep.c", 5));
+
+  filter.compact(events);
+  assert(events.size() == 3);
+  assert(events[0].address == 0x100);
+  assert(events[1].address == 0x300);
+  assert(events[2].address == 0x500);
+  assert(filter.excluded() == 2);
+
+  std::cout << "[PASS] test_compact_preserves_order\n";
+}
+
+int main() {
+  std::cout << "Running TraceFilter tests...\n\n";
+
+  test_glob_match();
+  test_inactive_filter_admits_everything();
+  test_file_glob();
+  test_addr_range();
+  test_addr_range_covers_strided_span();
+  test_heap_include();
+  test_heap_site_line_match();
+  test_heap_exclude();
+  test_filters_compose();
+  test_compact_preserves_order();
+
+  std::cout << "\nAll TraceFilter tests passed!\n";
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include "../include/TraceIndex.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// A small text trace with registrations interleaved between events
+static std::string make_trace() {
+  std::string t;
+  t += "# header comment\n";
+  t += "D 1 main.c\n";
+  for (int i = 0; i < 10; i++) {
+    t += "L 0x" + std::to_string(1000 + i * 64) + " 4 1:10 T0\n";
+  }
+  t += "G 1:10 compute\n";
+  for (int i = 0; i < 10; i++) {
+    t += "S 0x2000 8 1:20 T0\n";
+  }
+  return t;
+}
+
+// Test 1: marks land every interval, on event-record line starts
+void test_build_marks() {
+  std::string trace = make_trace();
+  TraceIndex index = build_trace_index(trace.data(), trace.size(), 4);
+
+  assert(index.total_events == 20);
+  assert(index.interval == 4);
+  assert(index.marks.size() == 5);
+  for (size_t k = 0; k < index.marks.size(); k++) {
+    assert(index.marks[k].event_index == k * 4);
+    char first = trace[index.marks[k].byte_offset];
+    assert(first == 'L' || first == 'S');
+  }
+
+  std::cout << "[PASS] test_build_marks\n";
+}
+
+// Test 2: registration records are indexed, comments are not
+void test_registrations_recorded() {
+  std::string trace = make_trace();
+  TraceIndex index = build_trace_index(trace.data(), trace.size(), 4);
+
+  assert(index.registrations.size() == 2);
+  assert(trace[index.registrations[0]] == 'D');
+  assert(trace[index.registrations[1]] == 'G');
+  // The G record sits between the two event runs
+  assert(index.registrations[1] > index.marks[2].byte_offset);
+
+  std::cout << "[PASS] test_registrations_recorded\n";
+}
+
+// Test 3: seek resolves to the newest mark at or before the event
+void test_mark_at_or_before() {
+  std::string trace = make_trace();
+  TraceIndex index = build_trace_index(trace.data(), trace.size(), 4);
+
+  assert(index.mark_at_or_before(0)->event_index == 0);
+  assert(index.mark_at_or_before(3)->event_index == 0);
+  assert(index.mark_at_or_before(4)->event_index == 4);
+  assert(index.mark_at_or_before(19)->event_index == 16);
+  assert(index.mark_at_or_before(1000)->event_index == 16);
+
+  TraceIndex empty;
+  assert(empty.mark_at_or_before(0) == nullptr);
+
+  std::cout << "[PASS] test_mark_at_or_before\n";
+}
+
+// Test 4: save/load round-trips the whole index
+void test_save_load_roundtrip() {
+  std::string trace = make_trace();
+  TraceIndex index = build_trace_index(trace.data(), trace.size(), 4);
+
+  std::stringstream buf;
+  bool saved = index.save(buf);  // Side effect kept outside the assert
+  assert(saved);
+  TraceIndex loaded = TraceIndex::load(buf);
+
+  assert(loaded.interval == index.interval);
+  assert(loaded.total_events == index.total_events);
+  assert(loaded.marks.size() == index.marks.size());
+  for (size_t k = 0; k < loaded.marks.size(); k++) {
+    assert(loaded.marks[k].event_index == index.marks[k].event_index);
+    assert(loaded.marks[k].byte_offset == index.marks[k].byte_offset);
+  }
+  assert(loaded.registrations == index.registrations);
+
+  // A foreign file fails loudly, like checkpoint restore
+  std::stringstream junk("CXTBnot an index");
+  bool threw = false;
+  try {
+    TraceIndex::load(junk);
+  } catch (const std::exception &) {
+    threw = true;
+  }
+  assert(threw);
+
+  std::cout << "[PASS] test_save_load_roundtrip\n";
+}
+
+// Test 5: the early-exit line walker stops where the callback says
+void test_for_each_line_from() {
+  std::string trace = make_trace();
+  TraceIndex index = build_trace_index(trace.data(), trace.size(), 4);
+
+  // Walk from the second mark, counting events until the fourth
+  const TraceIndexMark *mark = index.mark_at_or_before(5);
+  assert(mark->event_index == 4);
+  uint64_t seen = 0;
+  for_each_line_from(trace.data(), trace.size(), mark->byte_offset,
+                     [&](const char *begin, const char *end) {
+                       if (parse_trace_event_fast(begin, end))
+                         seen++;
+                       return seen < 8;
+                     });
+  assert(seen == 8);
+
+  std::cout << "[PASS] test_for_each_line_from\n";
+}
+
+int main() {
+  std::cout << "Running TraceIndex tests...\n\n";
+
+  test_build_marks();
+  test_registrations_recorded();
+  test_mark_at_or_before();
+  test_save_load_roundtrip();
+  test_for_each_line_from();
+
+  std::cout << "\n=== All 5 TraceIndex tests passed! ===\n";
+  return 0;
+}
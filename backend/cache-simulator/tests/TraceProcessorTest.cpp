@@ -1,8 +1,12 @@
+#include "../include/OptimizationSuggester.hpp"
 #include "../include/TraceProcessor.hpp"
 #include "../include/TraceEvent.hpp"
 #include "../profiles/HardwarePresets.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 // Use educational config for predictable results
 CacheHierarchyConfig make_test_hierarchy() {
@@ -129,6 +133,174 @@ void test_event_callback() {
   std::cout << "[PASS] test_event_callback\n";
 }
 
+void test_event_visitor() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // The visitor form of the batched API: results are delivered through a
+  // static hook trampoline instead of a std::function, and the hook in
+  // place before the call is restored afterwards
+  std::vector<TraceEvent> events;
+  for (int i = 0; i < 10; i++) {
+    TraceEvent event;
+    event.address = 0x3000 + (i % 2) * 64;
+    event.size = 4;
+    events.push_back(event);
+  }
+
+  int visited = 0;
+  int misses = 0;
+  processor.process_batch(events.data(), events.size(),
+                          [&](const EventResult &r) {
+                            visited++;
+                            if (!r.l1_hit)
+                              misses++;
+                          });
+  assert(visited == 10);
+  assert(misses == 2);  // two distinct lines, cold misses only
+
+  // Hook restored: further processing is silent
+  processor.process(events[0]);
+  assert(visited == 10);
+
+  // A persistent visitor installed directly observes per-event results
+  int seen = 0;
+  auto count_results = [&](const EventResult &) { seen++; };
+  processor.set_event_visitor(count_results);
+  processor.process(events[0]);
+  processor.process(events[1]);
+  assert(seen == 2);
+
+  std::cout << "[PASS] test_event_visitor\n";
+}
+
+void test_process_batch_matches_per_event() {
+  TraceProcessor per_event(make_test_hierarchy());
+  TraceProcessor batched(make_test_hierarchy());
+
+  // Mixed read/write pattern with some reuse
+  std::vector<TraceEvent> events;
+  for (int i = 0; i < 500; i++) {
+    TraceEvent event;
+    event.address = 0x1000 + (i % 100) * 64;
+    event.size = 4;
+    event.is_write = (i % 3 == 0);
+    event.file = "batch.c";
+    event.line = 10 + (i % 5);
+    events.push_back(event);
+  }
+
+  for (const auto &event : events) {
+    per_event.process(event);
+  }
+  batched.process_batch(events);
+
+  auto a = per_event.get_stats();
+  auto b = batched.get_stats();
+  assert(a.l1d.hits == b.l1d.hits);
+  assert(a.l1d.misses == b.l1d.misses);
+  assert(a.l2.hits == b.l2.hits);
+  assert(a.l2.misses == b.l2.misses);
+  assert(per_event.get_hot_lines(5).size() == batched.get_hot_lines(5).size());
+  std::cout << "[PASS] test_process_batch_matches_per_event\n";
+}
+
+void test_batch_callback() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  size_t total_results = 0;
+  size_t chunks = 0;
+  size_t max_chunk = 0;
+  processor.set_batch_callback(
+      [&](const EventResult *results, size_t count) {
+        assert(results != nullptr && count > 0);
+        total_results += count;
+        chunks++;
+        max_chunk = std::max(max_chunk, count);
+      },
+      16);
+
+  // 40 events: two full chunks of 16 plus an 8-result flush at the end
+  std::vector<TraceEvent> events;
+  for (int i = 0; i < 40; i++) {
+    TraceEvent event;
+    event.address = 0x2000 + i * 64;
+    event.size = 4;
+    event.is_write = false;
+    events.push_back(event);
+  }
+  processor.process_batch(events);
+
+  assert(total_results == 40);
+  assert(chunks == 3);
+  assert(max_chunk == 16);
+  std::cout << "[PASS] test_batch_callback\n";
+}
+
+void test_parse_range_event() {
+  auto event = parse_trace_event("RL 0x1000 64 8 4 loop.c:12 T2");
+  assert(event.has_value());
+  assert(event->is_range);
+  assert(event->address == 0x1000);
+  assert(event->stride == 64);
+  assert(event->count == 8);
+  assert(event->size == 4);
+  assert(event->is_write == false);
+  assert(event->file == "loop.c");
+  assert(event->line == 12);
+  assert(event->thread_id == 2);
+
+  // Store range with a negative stride (backwards iteration)
+  auto store = parse_trace_event("RS 0x2000 -8 16 8 loop.c:20 T0");
+  assert(store.has_value());
+  assert(store->is_range);
+  assert(store->is_write == true);
+  assert(store->stride == -8);
+  assert(store->count == 16);
+
+  // Bare 'R' stays a load alias
+  auto load = parse_trace_event("R 0x3000 4 main.c:1 T0");
+  assert(load.has_value());
+  assert(!load->is_range);
+  assert(!load->is_write);
+  std::cout << "[PASS] test_parse_range_event\n";
+}
+
+void test_range_expansion_matches_scalar() {
+  TraceProcessor expanded(make_test_hierarchy());
+  TraceProcessor scalar(make_test_hierarchy());
+
+  // One range record vs the loop it stands for
+  TraceEvent range;
+  range.address = 0x1000;
+  range.size = 4;
+  range.is_range = true;
+  range.stride = 64;
+  range.count = 32;
+  range.file = "loop.c";
+  range.line = 5;
+  expanded.process(range);
+
+  for (uint64_t i = 0; i < 32; i++) {
+    TraceEvent event;
+    event.address = 0x1000 + i * 64;
+    event.size = 4;
+    event.is_write = false;
+    event.file = "loop.c";
+    event.line = 5;
+    scalar.process(event);
+  }
+
+  auto a = expanded.get_stats();
+  auto b = scalar.get_stats();
+  assert(a.l1d.hits == b.l1d.hits);
+  assert(a.l1d.misses == b.l1d.misses);
+  assert(a.l2.misses == b.l2.misses);
+  auto hot = expanded.get_hot_lines(5);
+  assert(hot.size() == 1);
+  assert(hot[0].line == 5);
+  std::cout << "[PASS] test_range_expansion_matches_scalar\n";
+}
+
 void test_prefetching_enabled() {
   TraceProcessor processor(make_test_hierarchy());
   processor.enable_prefetching(PrefetchPolicy::NEXT_LINE, 2);
@@ -256,6 +428,723 @@ void test_tlb_simulation() {
   std::cout << "[PASS] test_tlb_simulation\n";
 }
 
+void test_parse_heap_records() {
+  auto alloc = parse_trace_event("H 0x5000 256 heap[0x401234]:0 T1");
+  assert(alloc.has_value());
+  assert(alloc->is_alloc);
+  assert(!alloc->is_free);
+  assert(alloc->address == 0x5000);
+  assert(alloc->size == 256);
+  assert(alloc->file == "heap[0x401234]");
+  assert(alloc->thread_id == 1);
+
+  // Free records carry only the base address
+  auto freed = parse_trace_event("F 0x5000 T1");
+  assert(freed.has_value());
+  assert(freed->is_free);
+  assert(!freed->is_alloc);
+  assert(freed->address == 0x5000);
+  assert(freed->thread_id == 1);
+  std::cout << "[PASS] test_parse_heap_records\n";
+}
+
+void test_heap_attribution() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // Allocate a 256-byte object at 0x5000
+  TraceEvent alloc;
+  alloc.is_alloc = true;
+  alloc.address = 0x5000;
+  alloc.size = 256;
+  alloc.file = "heap[0x401234]";
+  processor.process(alloc);
+
+  // Two accesses inside the object, one outside it
+  TraceEvent inside;
+  inside.address = 0x5010;
+  inside.size = 4;
+  processor.process(inside);
+  inside.address = 0x5080;
+  processor.process(inside);
+
+  TraceEvent outside;
+  outside.address = 0x9000;
+  outside.size = 4;
+  processor.process(outside);
+
+  assert(processor.has_heap_records());
+  auto heap = processor.get_heap_objects();
+  assert(heap.size() == 1);
+  assert(heap[0].file == "heap[0x401234]");
+  assert(heap[0].alloc_count == 1);
+  assert(heap[0].bytes_allocated == 256);
+  assert(heap[0].accesses == 2);
+  assert(heap[0].l1_misses == 2); // both lines were cold
+  std::cout << "[PASS] test_heap_attribution\n";
+}
+
+void test_heap_free_ends_attribution() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent alloc;
+  alloc.is_alloc = true;
+  alloc.address = 0x5000;
+  alloc.size = 64;
+  alloc.file = "heap[0x401234]";
+  processor.process(alloc);
+
+  TraceEvent access;
+  access.address = 0x5000;
+  access.size = 4;
+  processor.process(access);
+
+  TraceEvent freed;
+  freed.is_free = true;
+  freed.address = 0x5000;
+  processor.process(freed);
+
+  // Accesses after the free no longer belong to the object
+  processor.process(access);
+
+  auto heap = processor.get_heap_objects();
+  assert(heap.size() == 1);
+  assert(heap[0].accesses == 1);
+  assert(heap[0].live_bytes == 0);
+  assert(heap[0].peak_live_bytes == 64);
+  std::cout << "[PASS] test_heap_free_ends_attribution\n";
+}
+
+void test_heap_sites_aggregate_and_sort() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // Two allocations from the same site aggregate; a second site with no
+  // traffic sorts after the hot one
+  TraceEvent alloc;
+  alloc.is_alloc = true;
+  alloc.file = "heap[0xaaa]";
+  alloc.address = 0x5000;
+  alloc.size = 128;
+  processor.process(alloc);
+  alloc.address = 0x6000;
+  processor.process(alloc);
+
+  alloc.file = "heap[0xbbb]";
+  alloc.address = 0x7000;
+  alloc.size = 32;
+  processor.process(alloc);
+
+  TraceEvent access;
+  access.address = 0x6000;
+  access.size = 4;
+  processor.process(access);
+
+  auto heap = processor.get_heap_objects();
+  assert(heap.size() == 2);
+  assert(heap[0].file == "heap[0xaaa]");
+  assert(heap[0].alloc_count == 2);
+  assert(heap[0].bytes_allocated == 256);
+  assert(heap[0].accesses == 1);
+  assert(heap[1].file == "heap[0xbbb]");
+  assert(heap[1].accesses == 0);
+  std::cout << "[PASS] test_heap_sites_aggregate_and_sort\n";
+}
+
+void test_parse_phase_markers() {
+  auto begin = parse_trace_event("B 0x1 T1");
+  assert(begin.has_value());
+  assert(begin->is_phase_begin);
+  assert(!begin->is_phase_end);
+  assert(begin->address == 1);
+  assert(begin->thread_id == 1);
+
+  auto end = parse_trace_event("E 0x1 T1");
+  assert(end.has_value());
+  assert(end->is_phase_end);
+  assert(!end->is_phase_begin);
+  assert(end->address == 1);
+  std::cout << "[PASS] test_parse_phase_markers\n";
+}
+
+void test_phase_region_stats() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent access;
+  access.address = 0x1000;
+  access.size = 4;
+
+  // Warmup traffic outside any region
+  processor.process(access);
+
+  TraceEvent begin;
+  begin.is_phase_begin = true;
+  begin.address = 1;
+  processor.process(begin);
+
+  processor.process(access); // hit (warmed)
+  access.address = 0x8000;
+  processor.process(access); // cold miss
+
+  TraceEvent end;
+  end.is_phase_end = true;
+  end.address = 1;
+  processor.process(end);
+
+  // Traffic after the region is excluded
+  access.address = 0x9000;
+  processor.process(access);
+
+  assert(processor.has_phase_records());
+  auto phases = processor.get_phase_stats();
+  assert(phases.size() == 1);
+  assert(phases[0].id == 1);
+  assert(phases[0].accesses() == 2);
+  assert(phases[0].l1d.hits == 1);
+  assert(phases[0].l1d.misses == 1);
+  assert(phases[0].cycles > 0);
+
+  // Global stats still cover the whole trace
+  assert(processor.get_stats().l1d.total_accesses() == 4);
+  std::cout << "[PASS] test_phase_region_stats\n";
+}
+
+void test_open_phase_reported_to_current_point() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent begin;
+  begin.is_phase_begin = true;
+  begin.address = 1;
+  processor.process(begin);
+
+  TraceEvent access;
+  access.address = 0x1000;
+  access.size = 4;
+  processor.process(access);
+
+  // No end marker: the open region is reported up to the last event
+  auto phases = processor.get_phase_stats();
+  assert(phases.size() == 1);
+  assert(phases[0].accesses() == 1);
+
+  // A second begin closes the first region implicitly
+  begin.address = 2;
+  processor.process(begin);
+  processor.process(access);
+  phases = processor.get_phase_stats();
+  assert(phases.size() == 2);
+  assert(phases[0].id == 1);
+  assert(phases[1].id == 2);
+  std::cout << "[PASS] test_open_phase_reported_to_current_point\n";
+}
+
+void test_warmup_wipes_stats_keeps_contents() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent access;
+  access.address = 0x9000;
+  access.size = 4;
+
+  processor.begin_warmup();
+  processor.process(access); // cold miss, absorbed by the warmup
+  processor.finish_warmup();
+
+  // Counters restart at the boundary, but the line stayed resident
+  assert(processor.get_stats().l1d.total_accesses() == 0);
+  processor.process(access);
+  auto stats = processor.get_stats();
+  assert(stats.l1d.hits == 1);
+  assert(stats.l1d.misses == 0);
+  std::cout << "[PASS] test_warmup_wipes_stats_keeps_contents\n";
+}
+
+void test_warmup_restores_3c_tracking() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent access;
+  access.address = 0x9000;
+  access.size = 4;
+  processor.begin_warmup();
+  processor.process(access);
+  processor.finish_warmup();
+
+  // A fresh line after warmup still classifies as a compulsory miss
+  access.address = 0x20000;
+  processor.process(access);
+  auto stats = processor.get_stats();
+  assert(stats.l1d.misses == 1);
+  assert(stats.l1d.compulsory_misses == 1);
+  std::cout << "[PASS] test_warmup_restores_3c_tracking\n";
+}
+
+void test_function_rollup_from_g_records() {
+  TraceFuncMap::instance().clear();
+  TraceProcessor processor(make_test_hierarchy());
+
+  // Without registrations the rollup is empty - hot lines stand alone
+  assert(processor.get_hot_functions().empty());
+
+  // G records bind source lines to their enclosing function; like D
+  // records they register state but produce no event
+  assert(!parse_trace_event("D 7 matrix.c").has_value());
+  assert(!parse_trace_event("G 7:10 multiply").has_value());
+  assert(!parse_trace_event("G 7:11 multiply").has_value());
+  assert(!parse_trace_event("G 7:20 transpose").has_value());
+
+  auto process_line = [&](const char *line) {
+    auto ev = parse_trace_event(line);
+    assert(ev.has_value());
+    processor.process(*ev);
+  };
+  process_line("L 0x1000 4 7:10 T0"); // miss
+  process_line("L 0x1000 4 7:10 T0"); // hit
+  process_line("L 0x2000 4 7:11 T0"); // miss
+  process_line("S 0x3000 4 7:20 T0"); // miss
+
+  auto funcs = processor.get_hot_functions();
+  assert(funcs.size() == 2);
+  assert(funcs[0].function == "multiply"); // 2 misses over 2 lines
+  assert(funcs[0].misses == 2);
+  assert(funcs[0].hits == 1);
+  assert(funcs[0].lines == 2);
+  assert(funcs[1].function == "transpose");
+  assert(funcs[1].misses == 1);
+  assert(funcs[1].lines == 1);
+
+  // Lines without a registration stay out of the rollup
+  process_line("L 0x4000 4 7:99 T0");
+  funcs = processor.get_hot_functions();
+  assert(funcs.size() == 2);
+
+  TraceFuncMap::instance().clear();
+  std::cout << "[PASS] test_function_rollup_from_g_records\n";
+}
+
+void test_partial_struct_layout_advice() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // An array of 64-byte structs where the hot loop reads 8 bytes of
+  // each, and a second array it consumes in full
+  TraceEvent alloc;
+  alloc.is_alloc = true;
+  alloc.file = "heap[0xccc]";
+  alloc.address = 0x100000;
+  alloc.size = 64 * 1024;
+  processor.process(alloc);
+  alloc.file = "heap[0xddd]";
+  alloc.address = 0x200000;
+  processor.process(alloc);
+
+  TraceEvent access;
+  for (uint64_t off = 0; off < 64 * 1024; off += 64) {
+    access.address = 0x100000 + off;
+    access.size = 8;
+    processor.process(access);
+    access.address = 0x200000 + off;
+    access.size = 64;
+    processor.process(access);
+  }
+
+  auto heap = processor.get_heap_objects();
+  assert(heap.size() == 2);
+  for (const auto &h : heap) {
+    if (h.file == "heap[0xccc]") {
+      assert(h.line_bytes_touched() == 8);
+      assert(h.l1_misses >= 50);
+    } else {
+      assert(h.line_bytes_touched() == 64);
+    }
+  }
+
+  // Only the sparse site draws a suggestion; 8/64 utilization is severe
+  auto suggestions = OptimizationSuggester::analyze_layout(heap, 64);
+  assert(suggestions.size() == 1);
+  assert(suggestions[0].type == "partial_struct");
+  assert(suggestions[0].severity == "high");
+  assert(suggestions[0].location.find("heap[0xccc]") != std::string::npos);
+  std::cout << "[PASS] test_partial_struct_layout_advice\n";
+}
+
+void test_line_utilization_tracking() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // Two passes over 8KB at stride 64 reading 8 bytes: the second pass
+  // refetches every line (it outsizes the educational L1), closing each
+  // residency with 8 of 64 bytes touched; lines still resident at the
+  // end fold in with the same sparse mask
+  TraceEvent ev;
+  ev.size = 8;
+  ev.file = "util.c";
+  ev.line = 10;
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint64_t off = 0; off < 8192; off += 64) {
+      ev.address = 0x10000 + off;
+      processor.process(ev);
+    }
+  }
+
+  // Same pattern consuming full lines - utilization should be 100%
+  ev.line = 20;
+  ev.size = 64;
+  for (int pass = 0; pass < 2; pass++) {
+    for (uint64_t off = 0; off < 8192; off += 64) {
+      ev.address = 0x40000 + off;
+      processor.process(ev);
+    }
+  }
+
+  for (const auto &h : processor.get_hot_lines()) {
+    if (h.line == 10) {
+      assert(h.lines_fetched >= 128);
+      assert(h.line_utilization(64) == 0.125);
+    } else if (h.line == 20) {
+      assert(h.line_utilization(64) == 1.0);
+    }
+  }
+  std::cout << "[PASS] test_line_utilization_tracking\n";
+}
+
+void test_set_sampling_subset_and_extrapolation() {
+  // Full run and a 1-in-4 sampled run over the same uniform sweep
+  TraceProcessor full(make_test_hierarchy());
+  TraceProcessor sampled(make_test_hierarchy());
+  sampled.set_set_sampling(4);
+
+  TraceEvent ev;
+  ev.size = 8;
+  ev.file = "sweep.c";
+  ev.line = 1;
+  for (int pass = 0; pass < 4; pass++) {
+    for (uint64_t off = 0; off < 64 * 1024; off += 64) {
+      ev.address = 0x100000 + off;
+      full.process(ev);
+      sampled.process(ev);
+    }
+  }
+
+  auto fs = full.get_stats();
+  auto ss = sampled.get_stats();
+
+  // Exactly 1 in 4 lines survives the deterministic filter
+  assert(ss.l1d.total_accesses() * 4 == fs.l1d.total_accesses());
+
+  // The sweep is set-uniform, so the sampled hit rate matches closely
+  assert(std::abs(ss.l1d.hit_rate() - fs.l1d.hit_rate()) < 0.02);
+
+  // Scaling extrapolates the counts back to full-trace magnitude
+  ss.scale(4);
+  assert(ss.l1d.total_accesses() == fs.l1d.total_accesses());
+
+  std::cout << "[PASS] test_set_sampling_subset_and_extrapolation\n";
+}
+
+void test_set_sampling_deterministic() {
+  // Two sampled runs of the same trace are bit-identical - the subset is
+  // chosen by line index, not by chance
+  TraceProcessor a(make_test_hierarchy());
+  TraceProcessor b(make_test_hierarchy());
+  a.set_set_sampling(8);
+  b.set_set_sampling(8);
+
+  TraceEvent ev;
+  ev.size = 8;
+  for (uint64_t off = 0; off < 32 * 1024; off += 24) {
+    ev.address = 0x200000 + off;
+    ev.is_write = (off % 5 == 0);
+    a.process(ev);
+    b.process(ev);
+  }
+
+  assert(a.get_stats().l1d == b.get_stats().l1d);
+  assert(a.get_stats().l2 == b.get_stats().l2);
+  assert(a.get_stats().l1d.total_accesses() > 0);
+  std::cout << "[PASS] test_set_sampling_deterministic\n";
+}
+
+void test_parse_region_records() {
+  TraceRegionMap::instance().clear();
+
+  // K records register ranges and produce no event
+  assert(!parse_trace_event("K stack 0x7ffd00000000 0x7ffd00800000").has_value());
+  assert(!parse_trace_event("K data 0x600000 0x610000").has_value());
+
+  auto ranges = TraceRegionMap::instance().snapshot();
+  assert(ranges.size() == 2);
+  assert(ranges[0].kind == RegionKind::Stack);
+  assert(ranges[0].lo == 0x7ffd00000000ULL);
+  assert(ranges[0].hi == 0x7ffd00800000ULL);
+  assert(ranges[1].kind == RegionKind::Global);
+
+  TraceRegionMap::instance().clear();
+  std::cout << "[PASS] test_parse_region_records\n";
+}
+
+void test_region_classification() {
+  TraceRegionMap::instance().clear();
+  TraceRegionMap::instance().register_range(RegionKind::Stack,
+                                            0x7ffd00000000ULL,
+                                            0x7ffd00800000ULL);
+  TraceRegionMap::instance().register_range(RegionKind::Global, 0x600000,
+                                            0x610000);
+
+  TraceProcessor processor(make_test_hierarchy());
+
+  // A heap allocation grows the envelope for the heap bucket
+  TraceEvent alloc;
+  alloc.is_alloc = true;
+  alloc.address = 0x5000;
+  alloc.size = 256;
+  alloc.file = "heap[0x401234]";
+  processor.process(alloc);
+
+  TraceEvent ev;
+  ev.size = 4;
+  ev.address = 0x7ffd00400000ULL; // stack
+  processor.process(ev);
+  processor.process(ev);          // second access hits in L1
+  ev.address = 0x605000;          // global (.data)
+  processor.process(ev);
+  ev.address = 0x5010;            // heap (inside the allocation)
+  processor.process(ev);
+  ev.address = 0x90000000;        // nothing claims it
+  processor.process(ev);
+
+  assert(processor.has_region_records());
+  const auto &regions = processor.get_region_stats();
+  const auto &stack = regions[(size_t)RegionKind::Stack];
+  assert(stack.accesses == 2);
+  assert(stack.l1_misses == 1);
+  assert(regions[(size_t)RegionKind::Global].accesses == 1);
+  assert(regions[(size_t)RegionKind::Heap].accesses == 1);
+  assert(regions[(size_t)RegionKind::Other].accesses == 1);
+
+  TraceRegionMap::instance().clear();
+  std::cout << "[PASS] test_region_classification\n";
+}
+
+void test_no_region_records_no_buckets() {
+  TraceRegionMap::instance().clear();
+  TraceProcessor processor(make_test_hierarchy());
+
+  TraceEvent ev;
+  ev.address = 0x5000;
+  ev.size = 4;
+  processor.process(ev);
+
+  // Without K records every bucket stays empty - the regions section
+  // would be all "other" noise
+  for (const auto &stats : processor.get_region_stats())
+    assert(stats.accesses == 0);
+  std::cout << "[PASS] test_no_region_records_no_buckets\n";
+}
+
+// Small NINE hierarchy the bulk sweep accepts (educational is inclusive,
+// which the fast path declines because of back-invalidation)
+CacheHierarchyConfig make_bulk_hierarchy(EvictionPolicy policy) {
+  CacheHierarchyConfig cfg = make_educational_config();
+  cfg.inclusion_policy = InclusionPolicy::NINE;
+  cfg.l1_data.policy = policy;
+  cfg.l1_inst.policy = policy;
+  cfg.l2.policy = policy;
+  cfg.l3.policy = policy;
+  return cfg;
+}
+
+// Run the same stream through a bulk-enabled and a forced-per-line
+// processor and demand identical stats - the fast path is exact
+// accounting, not an estimate
+void assert_bulk_matches_per_line(const CacheHierarchyConfig &cfg,
+                                  const std::vector<TraceEvent> &events,
+                                  uint64_t expected_sweeps) {
+  TraceRegionMap::instance().clear();
+  TraceProcessor bulk(cfg);
+  TraceProcessor per_line(cfg);
+  per_line.set_bulk_intrinsics(false);
+
+  for (const auto &event : events) {
+    bulk.process(event);
+    per_line.process(event);
+  }
+  assert(bulk.get_bulk_sweeps() == expected_sweeps);
+  assert(per_line.get_bulk_sweeps() == 0);
+
+  auto sb = bulk.get_stats();
+  auto sp = per_line.get_stats();
+  assert(sb.l1d == sp.l1d);
+  assert(sb.l2 == sp.l2);
+  assert(sb.l3 == sp.l3);
+  assert(sb.timing == sp.timing);
+  assert(sb.bandwidth.l1_l2_bytes == sp.bandwidth.l1_l2_bytes);
+  assert(sb.bandwidth.l2_l3_bytes == sp.bandwidth.l2_l3_bytes);
+  assert(sb.bandwidth.l3_mem_bytes == sp.bandwidth.l3_mem_bytes);
+  auto tb = bulk.get_cache_system().get_tlb_stats();
+  auto tp = per_line.get_cache_system().get_tlb_stats();
+  assert(tb.dtlb == tp.dtlb);
+  assert(tb.stlb == tp.stlb);
+}
+
+void test_bulk_memset_matches_per_line() {
+  // Warm both hierarchies with scattered dirty lines so the sweep has
+  // real content to evict, then memset well away from them, then keep
+  // accessing - the trailing traffic only matches if the sweep left the
+  // caches in the same state the per-line path would have
+  std::vector<TraceEvent> events;
+  TraceEvent ev;
+  ev.size = 8;
+  ev.is_write = true;
+  ev.file = "warm.c";
+  ev.line = 1;
+  for (int i = 0; i < 200; i++) {
+    ev.address = 0x10000 + static_cast<uint64_t>(i) * 192;
+    events.push_back(ev);
+  }
+
+  TraceEvent ms;
+  ms.is_memset = true;
+  ms.address = 0x4000000;
+  ms.size = CacheSystem::BULK_SWEEP_MIN_LINES * 64;
+  ms.file = "memset.c";
+  ms.line = 42;
+  events.push_back(ms);
+
+  TraceEvent tail;
+  tail.size = 8;
+  tail.file = "tail.c";
+  tail.line = 2;
+  for (int i = 0; i < 300; i++) {
+    // Mix of swept lines (early ones evicted, late ones resident),
+    // pre-memset lines and fresh lines
+    tail.address = 0x4000000 + static_cast<uint64_t>(i) * 1216;
+    events.push_back(tail);
+    tail.address = 0x10000 + static_cast<uint64_t>(i) * 192;
+    events.push_back(tail);
+  }
+
+  assert_bulk_matches_per_line(make_bulk_hierarchy(EvictionPolicy::LRU),
+                               events, 1);
+  std::cout << "[PASS] test_bulk_memset_matches_per_line\n";
+}
+
+void test_bulk_memcpy_matches_per_line() {
+  std::vector<TraceEvent> events;
+  TraceEvent ev;
+  ev.size = 8;
+  ev.is_write = true;
+  for (int i = 0; i < 100; i++) {
+    ev.address = 0x20000 + static_cast<uint64_t>(i) * 320;
+    events.push_back(ev);
+  }
+
+  TraceEvent mc;
+  mc.is_memcpy = true;
+  mc.src_address = 0x8000000;
+  mc.address = 0xc000000;
+  // Unaligned base and odd size: the sweep must cover the same partial
+  // head and tail lines the per-line split produces
+  mc.src_address += 24;
+  mc.address += 8;
+  mc.size = CacheSystem::BULK_SWEEP_MIN_LINES * 64 + 100;
+  mc.file = "memcpy.c";
+  mc.line = 7;
+  events.push_back(mc);
+
+  // PLRU covers the intel-style presets; both ranges sweep
+  assert_bulk_matches_per_line(make_bulk_hierarchy(EvictionPolicy::PLRU),
+                               events, 2);
+  std::cout << "[PASS] test_bulk_memcpy_matches_per_line\n";
+}
+
+void test_bulk_sweep_fallback_gates() {
+  TraceRegionMap::instance().clear();
+  CacheHierarchyConfig cfg = make_bulk_hierarchy(EvictionPolicy::LRU);
+
+  // Below the line threshold: per-line path, results trivially identical
+  TraceProcessor small(cfg);
+  TraceEvent ms;
+  ms.is_memset = true;
+  ms.address = 0x4000000;
+  ms.size = (CacheSystem::BULK_SWEEP_MIN_LINES - 1) * 64;
+  small.process(ms);
+  assert(small.get_bulk_sweeps() == 0);
+
+  // A resident range line would turn into a hit per-line, so the sweep
+  // must decline (and the fallback still gets the stats right)
+  TraceProcessor warm_overlap(cfg);
+  TraceEvent touch;
+  touch.address = 0x4000040;
+  touch.size = 8;
+  touch.is_write = true;
+  warm_overlap.process(touch);
+  ms.size = CacheSystem::BULK_SWEEP_MIN_LINES * 64;
+  warm_overlap.process(ms);
+  assert(warm_overlap.get_bulk_sweeps() == 0);
+  auto stats = warm_overlap.get_stats();
+  assert(stats.l1d.hits == 1); // the touched line hit inside the memset
+
+  // The inclusive educational hierarchy always declines
+  TraceProcessor inclusive(make_educational_config());
+  inclusive.process(ms);
+  assert(inclusive.get_bulk_sweeps() == 0);
+
+  std::cout << "[PASS] test_bulk_sweep_fallback_gates\n";
+}
+
+void test_parse_sample_rate_record() {
+  // W records carry only the divisor; everything after one stands for
+  // that many captured accesses
+  auto event = parse_trace_event("W 64");
+  assert(event.has_value());
+  assert(event->is_sample_rate);
+  assert(event->count == 64);
+  assert(!event->is_write && !event->is_range);
+
+  // A zero divisor is malformed, not "no sampling"
+  assert(!parse_trace_event("W 0").has_value());
+  assert(!parse_trace_event("W").has_value());
+
+  std::cout << "[PASS] test_parse_sample_rate_record\n";
+}
+
+void test_sample_rate_reweighting() {
+  TraceProcessor processor(make_test_hierarchy());
+
+  // Before any W record the trace is unsampled and reports nothing
+  assert(!processor.get_sampling().active());
+
+  TraceEvent load;
+  load.address = 0x1000;
+  load.size = 4;
+
+  // 10 events at 1/1, then the adaptive sampler backs off to 1/100
+  for (int i = 0; i < 10; i++) {
+    processor.process(load);
+  }
+  processor.process(*parse_trace_event("W 1"));
+  for (int i = 0; i < 10; i++) {
+    processor.process(load);
+  }
+  processor.process(*parse_trace_event("W 100"));
+  for (int i = 0; i < 5; i++) {
+    processor.process(load);
+  }
+
+  const auto &sampling = processor.get_sampling();
+  assert(sampling.active());
+  assert(sampling.min_rate == 1);
+  assert(sampling.max_rate == 100);
+  assert(sampling.rate_changes == 1);  // only the move to 100 changed it
+  // 20 events at weight 1, 5 at weight 100
+  assert(sampling.weighted_events == 20 + 5 * 100);
+
+  // A range record weights each expanded access
+  processor.process(*parse_trace_event("RL 0x2000 64 8 4 loop.c:5 T0"));
+  assert(processor.get_sampling().weighted_events == 520 + 8 * 100);
+
+  // The W record itself is not an access
+  auto stats = processor.get_stats();
+  assert(stats.l1d.total_accesses() == 25 + 8);
+
+  std::cout << "[PASS] test_sample_rate_reweighting\n";
+}
+
 int main() {
   std::cout << "Running TraceProcessor tests...\n\n";
 
@@ -265,6 +1154,11 @@ int main() {
   test_repeated_access_hits();
   test_hot_lines_tracking();
   test_event_callback();
+  test_event_visitor();
+  test_process_batch_matches_per_event();
+  test_batch_callback();
+  test_parse_range_event();
+  test_range_expansion_matches_scalar();
   test_prefetching_enabled();
 
   // Trace parsing
@@ -280,6 +1174,48 @@ int main() {
   test_stats_timing();
   test_tlb_simulation();
 
-  std::cout << "\n=== All 15 TraceProcessor tests passed! ===\n";
+  // Heap object attribution
+  test_parse_heap_records();
+  test_heap_attribution();
+  test_heap_free_ends_attribution();
+  test_heap_sites_aggregate_and_sort();
+
+  // Phase markers (region-of-interest)
+  test_parse_phase_markers();
+  test_phase_region_stats();
+  test_open_phase_reported_to_current_point();
+
+  // Warmup fast-forward (functional warming)
+  test_warmup_wipes_stats_keeps_contents();
+  test_warmup_restores_3c_tracking();
+
+  // Per-function rollup (G registration records)
+  test_function_rollup_from_g_records();
+
+  // Layout advisor (per-offset heap access density)
+  test_partial_struct_layout_advice();
+
+  // Cache-line utilization per source line
+  test_line_utilization_tracking();
+
+  // Set-sampled simulation (--sample-sets)
+  test_set_sampling_subset_and_extrapolation();
+  test_set_sampling_deterministic();
+
+  // Region classification (K registration records)
+  test_parse_region_records();
+  test_region_classification();
+  test_no_region_records_no_buckets();
+
+  // Bulk-intrinsic fast path (large memset/memcpy sweeps)
+  test_bulk_memset_matches_per_line();
+  test_bulk_memcpy_matches_per_line();
+  test_bulk_sweep_fallback_gates();
+
+  // Sample-rate records (adaptive sampling reweighting)
+  test_parse_sample_rate_record();
+  test_sample_rate_reweighting();
+
+  std::cout << "\n=== All 39 TraceProcessor tests passed! ===\n";
   return 0;
 }
@@ -0,0 +1,127 @@
+#include "../include/CacheSystem.hpp"
+#include "../include/WritebackBuffer.hpp"
+#include "../profiles/HardwarePresets.hpp"
+#include <cassert>
+#include <iostream>
+
+void test_writebacks_free_until_full() {
+  WritebackBuffer wb(4);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  // Four dirty evictions fit in the buffer: accepted, no stall cycles
+  for (uint64_t i = 0; i < 4; i++) {
+    wb.on_writeback(0x1000 + i * 64, now, 100, timing);
+  }
+
+  assert(timing.writebacks_drained == 4);
+  assert(timing.writeback_full_stalls == 0);
+  assert(timing.writeback_stall_cycles == 0);
+  assert(now == 0);
+  assert(wb.in_flight() == 4);
+
+  std::cout << "[PASS] test_writebacks_free_until_full\n";
+}
+
+void test_full_buffer_stalls() {
+  WritebackBuffer wb(2);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  // Two drains in flight until cycle 100; a third eviction at cycle 10
+  // waits for the earliest slot to free
+  wb.on_writeback(0x1000, now, 100, timing);
+  wb.on_writeback(0x2000, now, 100, timing);
+  now = 10;
+  wb.on_writeback(0x3000, now, 100, timing);
+
+  assert(timing.writeback_full_stalls == 1);
+  assert(timing.writeback_stall_cycles == 90);
+  assert(now == 100);
+  assert(timing.writebacks_drained == 3);
+
+  std::cout << "[PASS] test_full_buffer_stalls\n";
+}
+
+void test_repeat_writeback_coalesces() {
+  WritebackBuffer wb(4);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  wb.on_writeback(0x1000, now, 100, timing);
+  now = 10;
+  // Same line still draining: folded into the existing entry
+  wb.on_writeback(0x1000, now, 100, timing);
+
+  assert(timing.writebacks_coalesced == 1);
+  assert(timing.writebacks_drained == 1);
+  assert(wb.in_flight() == 1);
+
+  // After the drain completes a repeat is fresh traffic again
+  now = 200;
+  wb.on_writeback(0x1000, now, 100, timing);
+  assert(timing.writebacks_coalesced == 1);
+  assert(timing.writebacks_drained == 2);
+
+  std::cout << "[PASS] test_repeat_writeback_coalesces\n";
+}
+
+void test_drains_retire_over_time() {
+  WritebackBuffer wb(2);
+  TimingStats timing;
+  uint64_t now = 0;
+
+  wb.on_writeback(0x1000, now, 50, timing);
+  wb.on_writeback(0x2000, now, 50, timing);
+
+  // Both drains land by cycle 50, so a later eviction finds free slots
+  now = 60;
+  wb.on_writeback(0x3000, now, 50, timing);
+
+  assert(timing.writeback_full_stalls == 0);
+  assert(timing.writeback_stall_cycles == 0);
+  assert(wb.in_flight() == 1);
+
+  std::cout << "[PASS] test_drains_retire_over_time\n";
+}
+
+void test_hierarchy_accounts_dirty_evictions() {
+  // Thrash one L1 set with dirty lines so the system routes dirty
+  // evictions through the L1 writeback buffer
+  CacheHierarchyConfig cfg = {
+      .l1_data = {.kb_size = 1, .associativity = 2, .line_size = 64,
+                  .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back},
+      .l1_inst = {.kb_size = 1, .associativity = 2, .line_size = 64,
+                  .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::ReadOnly},
+      .l2 = {.kb_size = 4, .associativity = 4, .line_size = 64,
+             .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back},
+      .l3 = {.kb_size = 16, .associativity = 8, .line_size = 64,
+             .policy = EvictionPolicy::LRU, .write_policy = WritePolicy::Back},
+      .inclusion_policy = InclusionPolicy::NINE};
+  CacheSystem cache(cfg);
+
+  // 1KB, 2-way, 64B L1d = 8 sets; stride 0x200 stays in set 0
+  for (uint64_t i = 0; i < 8; i++) {
+    cache.write(i * 0x200);
+  }
+
+  auto timing = cache.get_timing_stats();
+  assert(timing.writebacks_drained > 0);
+  assert(timing.writebacks_drained ==
+         cache.get_stats().l1d.writebacks);
+
+  std::cout << "[PASS] test_hierarchy_accounts_dirty_evictions\n";
+}
+
+int main() {
+  std::cout << "Running WritebackBuffer tests...\n\n";
+
+  test_writebacks_free_until_full();
+  test_full_buffer_stalls();
+  test_repeat_writeback_coalesces();
+  test_drains_retire_over_time();
+  test_hierarchy_accounts_dirty_evictions();
+
+  std::cout << "\nAll WritebackBuffer tests passed!\n";
+  return 0;
+}
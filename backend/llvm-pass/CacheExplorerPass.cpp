@@ -1,18 +1,36 @@
 #include "CacheExplorerPass.hpp"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+#include "llvm/Transforms/Utils/ScalarEvolutionExpander.h"
+
+#include <set>
+#include <string>
+#include <tuple>
 
 using namespace llvm;
 
 // Configuration flags - set via environment variables
 // CACHE_EXPLORER_DEBUG=1 - enable debug output
 // CACHE_EXPLORER_INCLUDE_STL=1 - instrument STL/standard library (disabled by default)
+// CACHE_EXPLORER_INLINE=1 - inline the event fast path instead of calling
+//                           the runtime per load/store (plain loads/stores only)
+// CACHE_EXPLORER_RANGES=1 - compress constant-stride loop accesses with known
+//                           trip counts into single range events
 static bool DebugFiltering = false;
 static bool IncludeStdLib = false;
+static bool InlineFastPath = false;
+static bool RangeCompression = false;
 static bool ConfigInitialized = false;
 
 static void initConfig() {
@@ -26,6 +44,16 @@ static void initConfig() {
       if (DebugFiltering && IncludeStdLib)
         errs() << "[CacheExplorer] STL instrumentation ENABLED\n";
     }
+    if (const char *env = getenv("CACHE_EXPLORER_INLINE")) {
+      InlineFastPath = (env[0] == '1');
+      if (DebugFiltering && InlineFastPath)
+        errs() << "[CacheExplorer] Inline fast path ENABLED\n";
+    }
+    if (const char *env = getenv("CACHE_EXPLORER_RANGES")) {
+      RangeCompression = (env[0] == '1');
+      if (DebugFiltering && RangeCompression)
+        errs() << "[CacheExplorer] Range compression ENABLED\n";
+    }
   }
 }
 
@@ -158,6 +186,43 @@ struct InstrumentationData {
   Value *Line;
 };
 
+// --- Pre-inlining attribution ---------------------------------------------
+//
+// An instruction inlined from elsewhere carries the callee's location,
+// chained back through inlinedAt to the line the enclosing function
+// actually wrote. Attributing to the root of that chain keeps
+// template-heavy code from fragmenting into scattered callee lines, and
+// the root scope names the enclosing function, which the module pass
+// registers with the runtime (one constructor of
+// __cache_explorer_site_func calls) so cache-sim can roll per-line stats
+// up to function granularity.
+
+struct SiteLocation {
+  StringRef File = "<unknown>";
+  uint32_t Line = 0;
+};
+
+// Unique (file, line, function) sites seen while instrumenting the
+// current module; drained by emitSiteRegistrations
+static std::set<std::tuple<std::string, uint32_t, std::string>> ModuleSites;
+
+SiteLocation resolveSite(const DebugLoc &DbgLoc) {
+  SiteLocation Site;
+  const DILocation *Loc = DbgLoc.get();
+  if (!Loc)
+    return Site;
+  while (Loc->getInlinedAt())
+    Loc = Loc->getInlinedAt();
+  Site.File = Loc->getFilename();
+  Site.Line = Loc->getLine();
+  if (DISubprogram *SP = Loc->getScope()->getSubprogram()) {
+    StringRef Func = SP->getName();
+    if (!Func.empty())
+      ModuleSites.emplace(Site.File.str(), Site.Line, Func.str());
+  }
+  return Site;
+}
+
 InstrumentationData prepareInstrumentation(Module *M, LLVMContext &Ctx,
                                            Instruction &I, Value *Addr,
                                            Type *AccessType) {
@@ -166,19 +231,289 @@ InstrumentationData prepareInstrumentation(Module *M, LLVMContext &Ctx,
   uint64_t Size = M->getDataLayout().getTypeStoreSize(AccessType);
   Value *SizeVal = ConstantInt::get(Type::getInt32Ty(Ctx), Size);
 
-  const DebugLoc &DbgLoc = I.getDebugLoc();
-  Value *File;
-  Value *Line;
+  SiteLocation Site = resolveSite(I.getDebugLoc());
+  Value *File = Builder.CreateGlobalString(Site.File);
+  Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
+
+  return {Addr, SizeVal, File, Line};
+}
+
+// --- Inline fast path (CACHE_EXPLORER_INLINE=1) ---------------------------
+//
+// Instead of calling __tag_mem_load/__tag_mem_store per access, emit the
+// runtime's ring-buffer slot claim directly as IR: load the thread's ring
+// pointer, bump head, and store a packed 32-byte CacheEvent. The runtime
+// call survives only as the slow path - thread not yet registered, ring
+// full, or inline mode disabled at runtime (the runtime publishes a NULL
+// ring pointer when sampling or event limits require the full entry path).
+//
+// Layout constants mirror cache-explorer-rt.c, which carries matching
+// _Static_asserts so a drift breaks the runtime build, not the trace.
+
+constexpr uint64_t InlineRingSize = 1 << 16;
+constexpr uint64_t InlineRingMask = InlineRingSize - 1;
+constexpr uint64_t InlineEventSize = 32;
+constexpr uint64_t InlineHeadOffset = InlineRingSize * InlineEventSize;
+constexpr uint64_t InlineTailOffset = InlineHeadOffset + 64;
+constexpr uint64_t InlineStoreFlag = 1ULL << 63;
+
+GlobalVariable *getTLSExtern(Module *M, Type *Ty, StringRef Name) {
+  if (GlobalVariable *GV = M->getNamedGlobal(Name))
+    return GV;
+  return new GlobalVariable(*M, Ty, false, GlobalValue::ExternalLinkage,
+                            nullptr, Name, nullptr,
+                            GlobalValue::GeneralDynamicTLSModel);
+}
+
+// Per-filename cache of the interned file id, resolved lazily at runtime
+// by __cache_explorer_site_id (-1 = not yet resolved)
+GlobalVariable *getSiteIdGlobal(Module *M, StringRef Filename) {
+  SmallString<128> Name("__ce_site_id.");
+  Name += Filename;
+  if (GlobalVariable *GV = M->getNamedGlobal(Name))
+    return GV;
+  Type *Int32Ty = Type::getInt32Ty(M->getContext());
+  return new GlobalVariable(*M, Int32Ty, false, GlobalValue::PrivateLinkage,
+                            ConstantInt::get(Int32Ty, -1), Name);
+}
+
+void emitInlineFastPath(Module *M, Instruction *InsertBefore, Value *Addr,
+                        uint64_t Size, StringRef Filename, uint32_t Line,
+                        bool IsStore, Function *SlowFn) {
+  LLVMContext &Ctx = M->getContext();
+  Type *Int8Ty = Type::getInt8Ty(Ctx);
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+  Type *PtrTy = PointerType::getUnqual(Ctx);
+
+  GlobalVariable *RingTLS =
+      getTLSExtern(M, PtrTy, "__cache_explorer_inline_ring");
+  GlobalVariable *TidTLS = getTLSExtern(M, Int32Ty, "__cache_explorer_tid");
+  GlobalVariable *SiteId = getSiteIdGlobal(M, Filename);
+
+  FunctionCallee SiteIdFn = M->getOrInsertFunction(
+      "__cache_explorer_site_id", FunctionType::get(Int32Ty, {PtrTy}, false));
+
+  Function *F = InsertBefore->getFunction();
+  BasicBlock *Orig = InsertBefore->getParent();
+  BasicBlock *Cont = Orig->splitBasicBlock(InsertBefore, "ce.cont");
+  Orig->getTerminator()->eraseFromParent();
+
+  BasicBlock *FastBB = BasicBlock::Create(Ctx, "ce.fast", F, Cont);
+  BasicBlock *InternBB = BasicBlock::Create(Ctx, "ce.intern", F, Cont);
+  BasicBlock *ClaimBB = BasicBlock::Create(Ctx, "ce.claim", F, Cont);
+  BasicBlock *StoreBB = BasicBlock::Create(Ctx, "ce.store", F, Cont);
+  BasicBlock *SlowBB = BasicBlock::Create(Ctx, "ce.slow", F, Cont);
+
+  // Shared operands for the slow-path call
+  IRBuilder<> B(Orig);
+  Value *File = B.CreateGlobalString(Filename);
+  Value *SizeVal = ConstantInt::get(Int32Ty, Size);
+  Value *LineVal = ConstantInt::get(Int32Ty, Line);
+
+  // entry: registered for inline tracing?
+  Value *Ring = B.CreateLoad(PtrTy, RingTLS, "ce.ring");
+  B.CreateCondBr(B.CreateIsNotNull(Ring), FastBB, SlowBB);
+
+  // fast: is this site's file id resolved yet?
+  B.SetInsertPoint(FastBB);
+  Value *Sid0 = B.CreateLoad(Int32Ty, SiteId, "ce.sid");
+  B.CreateCondBr(B.CreateICmpSLT(Sid0, ConstantInt::get(Int32Ty, 0)),
+                 InternBB, ClaimBB);
+
+  // intern (once per site per run): resolve and cache the file id
+  B.SetInsertPoint(InternBB);
+  Value *Sid1 = B.CreateCall(SiteIdFn, {File});
+  B.CreateStore(Sid1, SiteId);
+  B.CreateBr(ClaimBB);
+
+  // claim: reserve the next slot unless the ring is full
+  B.SetInsertPoint(ClaimBB);
+  PHINode *Sid = B.CreatePHI(Int32Ty, 2, "ce.sid.phi");
+  Sid->addIncoming(Sid0, FastBB);
+  Sid->addIncoming(Sid1, InternBB);
+  Value *HeadPtr = B.CreateConstInBoundsGEP1_64(Int8Ty, Ring, InlineHeadOffset,
+                                                "ce.headp");
+  // Only the owning thread writes head, so a plain load is enough
+  Value *Head = B.CreateAlignedLoad(Int64Ty, HeadPtr, Align(8), "ce.head");
+  Value *Next =
+      B.CreateAnd(B.CreateAdd(Head, ConstantInt::get(Int64Ty, 1)),
+                  ConstantInt::get(Int64Ty, InlineRingMask), "ce.next");
+  Value *TailPtr = B.CreateConstInBoundsGEP1_64(Int8Ty, Ring, InlineTailOffset,
+                                                "ce.tailp");
+  LoadInst *Tail = B.CreateAlignedLoad(Int64Ty, TailPtr, Align(8), "ce.tail");
+  Tail->setAtomic(AtomicOrdering::Acquire);
+  B.CreateCondBr(B.CreateICmpEQ(Next, Tail), SlowBB, StoreBB);
+
+  // store: write the packed CacheEvent and publish head
+  B.SetInsertPoint(StoreBB);
+  Value *SlotOff =
+      B.CreateMul(Head, ConstantInt::get(Int64Ty, InlineEventSize));
+  Value *Slot = B.CreateGEP(Int8Ty, Ring, SlotOff, "ce.slot");
+  Value *Addr64 = B.CreatePtrToInt(Addr, Int64Ty);
+  if (IsStore)
+    Addr64 = B.CreateOr(Addr64, ConstantInt::get(Int64Ty, InlineStoreFlag));
+  B.CreateAlignedStore(Addr64, Slot, Align(8));
+  B.CreateAlignedStore(ConstantInt::get(Int64Ty, 0),
+                       B.CreateConstInBoundsGEP1_64(Int8Ty, Slot, 8), Align(8));
+  B.CreateAlignedStore(SizeVal,
+                       B.CreateConstInBoundsGEP1_64(Int8Ty, Slot, 16),
+                       Align(8));
+  Value *Packed =
+      B.CreateOr(B.CreateShl(Sid, ConstantInt::get(Int32Ty, 20)),
+                 ConstantInt::get(Int32Ty, Line & 0xFFFFF), "ce.line");
+  B.CreateAlignedStore(Packed,
+                       B.CreateConstInBoundsGEP1_64(Int8Ty, Slot, 20),
+                       Align(4));
+  Value *Tid = B.CreateAlignedLoad(Int32Ty, TidTLS, Align(4), "ce.tid");
+  B.CreateAlignedStore(Tid, B.CreateConstInBoundsGEP1_64(Int8Ty, Slot, 24),
+                       Align(8));
+  StoreInst *Publish = B.CreateAlignedStore(Next, HeadPtr, Align(8));
+  Publish->setAtomic(AtomicOrdering::Release);
+  B.CreateBr(Cont);
+
+  // slow: unregistered thread or full ring - take the runtime call
+  B.SetInsertPoint(SlowBB);
+  B.CreateCall(SlowFn, {Addr, SizeVal, File, LineVal});
+  B.CreateBr(Cont);
+}
+
+// --- Loop-aware trace compression (CACHE_EXPLORER_RANGES=1) ---------------
+//
+// Affine loops emit one event per access per iteration; when the access
+// pointer is a constant-stride recurrence and the trip count is a
+// compile-time constant, the whole series is described by (base, stride,
+// count). Emit a single __tag_range_load/store call in the preheader and
+// skip the per-iteration instrumentation - the simulator expands the record
+// back into scalar accesses, so downstream stats are unchanged. Only the
+// interleaving with other accesses inside the same loop gets coarser, which
+// is why the mode is opt-in.
+
+void compressStridedAccesses(Function &F, Module *M,
+                             SmallPtrSetImpl<Instruction *> &Compressed,
+                             Function *RangeLoad, Function *RangeStore) {
+  LLVMContext &Ctx = M->getContext();
+  const DataLayout &DL = M->getDataLayout();
+
+  // The module driver runs with an empty analysis manager, so build the
+  // loop analyses directly
+  DominatorTree DT(F);
+  LoopInfo LI(DT);
+  if (LI.empty())
+    return;
+  TargetLibraryInfoImpl TLII;
+  TargetLibraryInfo TLI(TLII);
+  AssumptionCache AC(F);
+  ScalarEvolution SE(F, TLI, AC, DT, LI);
+
+  for (Loop *L : LI.getLoopsInPreorder()) {
+    if (!L->isInnermost())
+      continue;
+    BasicBlock *Preheader = L->getLoopPreheader();
+    BasicBlock *Latch = L->getLoopLatch();
+    // Bottom-tested loops only: blocks dominating the latch then execute
+    // exactly trip-count times, so the record's count is exact
+    if (!Preheader || !Latch || L->getExitingBlock() != Latch)
+      continue;
+    unsigned TripCount = SE.getSmallConstantTripCount(L);
+    if (TripCount < 2)
+      continue;
+
+    for (BasicBlock *BB : L->blocks()) {
+      if (!DT.dominates(BB, Latch))
+        continue;
+      for (Instruction &I : *BB) {
+        Value *Ptr = nullptr;
+        Type *AccessTy = nullptr;
+        bool IsStore = false;
+        if (auto *Load = dyn_cast<LoadInst>(&I)) {
+          if (Load->isAtomic() || Load->getType()->isVectorTy())
+            continue;
+          Ptr = Load->getPointerOperand();
+          AccessTy = Load->getType();
+        } else if (auto *Store = dyn_cast<StoreInst>(&I)) {
+          if (Store->isAtomic() ||
+              Store->getValueOperand()->getType()->isVectorTy())
+            continue;
+          Ptr = Store->getPointerOperand();
+          AccessTy = Store->getValueOperand()->getType();
+          IsStore = true;
+        } else {
+          continue;
+        }
+
+        const DebugLoc &DbgLoc = I.getDebugLoc();
+        if (!DbgLoc || isSystemHeader(DbgLoc->getFilename()))
+          continue;
+
+        const auto *AR = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(Ptr));
+        if (!AR || AR->getLoop() != L || !AR->isAffine())
+          continue;
+        const auto *Step = dyn_cast<SCEVConstant>(AR->getStepRecurrence(SE));
+        if (!Step)
+          continue;
+        int64_t Stride = Step->getAPInt().getSExtValue();
+        if (Stride == 0 || !isInt<32>(Stride))
+          continue;
+        // Expanding the base at the preheader must not introduce a
+        // division the original code may have guarded against
+        const SCEV *Start = AR->getStart();
+        if (SCEVExprContains(
+                Start, [](const SCEV *S) { return isa<SCEVUDivExpr>(S); }))
+          continue;
 
-  if (DbgLoc) {
-    File = Builder.CreateGlobalString(DbgLoc->getFilename());
-    Line = ConstantInt::get(Type::getInt32Ty(Ctx), DbgLoc->getLine());
-  } else {
-    File = Builder.CreateGlobalString("<unknown>");
-    Line = ConstantInt::get(Type::getInt32Ty(Ctx), 0);
+        Instruction *InsertPt = Preheader->getTerminator();
+        SCEVExpander Expander(SE, DL, "ce.range");
+        Value *Base = Expander.expandCodeFor(Start, Ptr->getType(), InsertPt);
+
+        IRBuilder<> Builder(InsertPt);
+        uint64_t Size = DL.getTypeStoreSize(AccessTy);
+        SiteLocation Site = resolveSite(DbgLoc);
+        Value *File = Builder.CreateGlobalString(Site.File);
+        Builder.CreateCall(
+            IsStore ? RangeStore : RangeLoad,
+            {Base, ConstantInt::get(Type::getInt64Ty(Ctx), Stride),
+             ConstantInt::get(Type::getInt64Ty(Ctx), TripCount),
+             ConstantInt::get(Type::getInt32Ty(Ctx), Size), File,
+             ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line)});
+        Compressed.insert(&I);
+
+        if (DebugFiltering)
+          errs() << "[RANGE] " << Site.File << ":" << Site.Line
+                 << " stride=" << Stride << " count=" << TripCount << "\n";
+      }
+    }
+  }
+}
+
+// Emit a module constructor that reports every (file, line, function) site
+// collected by resolveSite to the runtime, which forwards them to cache-sim
+// as G registration records for the per-function rollup
+void emitSiteRegistrations(Module &M) {
+  LLVMContext &Ctx = M.getContext();
+  Type *VoidTy = Type::getVoidTy(Ctx);
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+  PointerType *PtrTy = PointerType::getUnqual(Ctx);
+
+  FunctionCallee SiteFunc = M.getOrInsertFunction(
+      "__cache_explorer_site_func",
+      FunctionType::get(VoidTy, {PtrTy, Int32Ty, PtrTy}, false));
+
+  Function *Ctor = Function::Create(FunctionType::get(VoidTy, false),
+                                    GlobalValue::InternalLinkage,
+                                    "__cache_explorer_register_sites", &M);
+  BasicBlock *Entry = BasicBlock::Create(Ctx, "entry", Ctor);
+  IRBuilder<> Builder(Entry);
+
+  for (const auto &[File, Line, Func] : ModuleSites) {
+    Builder.CreateCall(SiteFunc,
+                       {Builder.CreateGlobalString(File),
+                        ConstantInt::get(Int32Ty, Line),
+                        Builder.CreateGlobalString(Func)});
   }
+  Builder.CreateRetVoid();
 
-  return {Addr, SizeVal, File, Line};
+  appendToGlobalCtors(M, Ctor, /*Priority=*/0);
 }
 
 } // anonymous namespace
@@ -254,6 +589,31 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
                                       "__tag_vector_store", M);
   }
 
+  // Gather/scatter lane instrumentation (one call per active lane)
+  Function *TagGatherLane = M->getFunction("__tag_gather_lane");
+  if (!TagGatherLane) {
+    FunctionType *GatherFnTy =
+        FunctionType::get(Type::getVoidTy(Ctx),
+                          {PointerType::getUnqual(Ctx), Type::getInt32Ty(Ctx),
+                           Type::getInt32Ty(Ctx), Type::getInt32Ty(Ctx),
+                           PointerType::getUnqual(Ctx), Type::getInt32Ty(Ctx)},
+                          false);
+    TagGatherLane = Function::Create(GatherFnTy, Function::ExternalLinkage,
+                                     "__tag_gather_lane", M);
+  }
+
+  Function *TagScatterLane = M->getFunction("__tag_scatter_lane");
+  if (!TagScatterLane) {
+    FunctionType *ScatterFnTy =
+        FunctionType::get(Type::getVoidTy(Ctx),
+                          {PointerType::getUnqual(Ctx), Type::getInt32Ty(Ctx),
+                           Type::getInt32Ty(Ctx), Type::getInt32Ty(Ctx),
+                           PointerType::getUnqual(Ctx), Type::getInt32Ty(Ctx)},
+                          false);
+    TagScatterLane = Function::Create(ScatterFnTy, Function::ExternalLinkage,
+                                      "__tag_scatter_lane", M);
+  }
+
   // Atomic operation instrumentation
   Function *TagAtomicLoad = M->getFunction("__tag_atomic_load");
   if (!TagAtomicLoad) {
@@ -348,6 +708,31 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
                                   "__tag_bb_entry", M);
   }
 
+  // Loop-aware range compression (opt-in): replace constant-stride loop
+  // accesses with a single preheader range call and skip them in the scan
+  SmallPtrSet<Instruction *, 16> RangeCompressed;
+  if (RangeCompression) {
+    FunctionType *RangeFnTy = FunctionType::get(
+        Type::getVoidTy(Ctx),
+        {PointerType::getUnqual(Ctx), Type::getInt64Ty(Ctx),
+         Type::getInt64Ty(Ctx), Type::getInt32Ty(Ctx),
+         PointerType::getUnqual(Ctx), Type::getInt32Ty(Ctx)},
+        false);
+    Function *TagRangeLoad = M->getFunction("__tag_range_load");
+    if (!TagRangeLoad)
+      TagRangeLoad = Function::Create(RangeFnTy, Function::ExternalLinkage,
+                                      "__tag_range_load", M);
+    Function *TagRangeStore = M->getFunction("__tag_range_store");
+    if (!TagRangeStore)
+      TagRangeStore = Function::Create(RangeFnTy, Function::ExternalLinkage,
+                                       "__tag_range_store", M);
+    compressStridedAccesses(F, M, RangeCompressed, TagRangeLoad, TagRangeStore);
+  }
+
+  // Inline fast-path emission splits basic blocks, so eligible accesses
+  // are collected during the scan and rewritten afterwards
+  SmallVector<Instruction *, 32> InlineSites;
+
   for (auto &BB : F) {
     // Count instructions in this basic block for I-cache simulation
     uint32_t instrCount = 0;
@@ -360,9 +745,13 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
       }
     }
 
-    // Insert BB entry tracking at the start of each block (if it has debug info)
+    // Insert BB entry tracking at the start of each block. Blocks with no
+    // debug location of their own (compiler-generated joins, unrolled loop
+    // tails) fall back to the enclosing function's subprogram so they still
+    // contribute to the I-cache stream - the runtime captures their real
+    // post-layout address via the return address of this call.
     // IMPORTANT: Skip landing pad blocks - landingpad must be first non-PHI instruction
-    if (firstDbgLoc && instrCount > 0) {
+    if (instrCount > 0 && (firstDbgLoc || F.getSubprogram())) {
       Instruction *firstInst = &*BB.begin();
 
       // Skip PHI nodes to find the first real instruction
@@ -378,8 +767,15 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
       // Use a unique counter instead of BlockAddress (fixes ARM64 issues)
       Value *BBID = ConstantInt::get(Type::getInt64Ty(Ctx), GlobalBBCounter++);
       Value *InstrCount = ConstantInt::get(Type::getInt32Ty(Ctx), instrCount);
-      Value *File = Builder.CreateGlobalString((*firstDbgLoc)->getFilename());
-      Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), (*firstDbgLoc)->getLine());
+      SiteLocation Site;
+      if (firstDbgLoc) {
+        Site = resolveSite(*firstDbgLoc);
+      } else {
+        Site.File = F.getSubprogram()->getFilename();
+        Site.Line = F.getSubprogram()->getLine();
+      }
+      Value *File = Builder.CreateGlobalString(Site.File);
+      Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
 
       Builder.CreateCall(TagBBEntry, {BBID, InstrCount, File, Line});
     }
@@ -431,8 +827,9 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
                           : ConstantInt::get(Type::getInt8Ty(Ctx), 0);
             IRBuilder<> Builder(&I);
             Value *SizeVal = ConstantInt::get(Type::getInt32Ty(Ctx), 64);  // Cache line
-            Value *File = Builder.CreateGlobalString(I.getDebugLoc()->getFilename());
-            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), I.getDebugLoc()->getLine());
+            SiteLocation Site = resolveSite(I.getDebugLoc());
+            Value *File = Builder.CreateGlobalString(Site.File);
+            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
             // Truncate hint to i8 if needed
             if (Hint->getType() != Type::getInt8Ty(Ctx))
               Hint = Builder.CreateTrunc(Hint, Type::getInt8Ty(Ctx));
@@ -447,8 +844,9 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
             Value *Len = CI->getArgOperand(2);
             IRBuilder<> Builder(&I);
             Value *SizeVal = Builder.CreateTrunc(Len, Type::getInt32Ty(Ctx));
-            Value *File = Builder.CreateGlobalString(I.getDebugLoc()->getFilename());
-            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), I.getDebugLoc()->getLine());
+            SiteLocation Site = resolveSite(I.getDebugLoc());
+            Value *File = Builder.CreateGlobalString(Site.File);
+            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
             Builder.CreateCall(TagMemcpy, {Dest, Src, SizeVal, File, Line});
             continue;
           }
@@ -459,12 +857,62 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
             Value *Len = CI->getArgOperand(2);
             IRBuilder<> Builder(&I);
             Value *SizeVal = Builder.CreateTrunc(Len, Type::getInt32Ty(Ctx));
-            Value *File = Builder.CreateGlobalString(I.getDebugLoc()->getFilename());
-            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), I.getDebugLoc()->getLine());
+            SiteLocation Site = resolveSite(I.getDebugLoc());
+            Value *File = Builder.CreateGlobalString(Site.File);
+            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
             Builder.CreateCall(TagMemset, {Dest, SizeVal, File, Line});
             continue;
           }
 
+          // llvm.masked.gather / llvm.masked.scatter: the pointer operand
+          // is a vector of per-lane addresses, so tagging one base would
+          // collapse up to 16 discontiguous lines into a single access.
+          // Tag each lane with its own pointer instead. Lanes a constant
+          // mask disables are skipped; a variable mask conservatively
+          // tags every lane. Scalable (SVE) vectors have no compile-time
+          // lane count and stay uninstrumented, like before.
+          if (Name.starts_with("llvm.masked.gather") ||
+              Name.starts_with("llvm.masked.scatter")) {
+            bool IsScatter = Name.starts_with("llvm.masked.scatter");
+            Value *Ptrs = CI->getArgOperand(IsScatter ? 1 : 0);
+            Value *Mask = CI->getArgOperand(IsScatter ? 3 : 2);
+            Type *ElemTy = IsScatter
+                               ? CI->getArgOperand(0)->getType()->getScalarType()
+                               : CI->getType()->getScalarType();
+            if (auto *PtrVecTy = dyn_cast<FixedVectorType>(Ptrs->getType())) {
+              unsigned NumLanes = PtrVecTy->getNumElements();
+              auto *ConstMask = dyn_cast<Constant>(Mask);
+              SmallVector<unsigned, 16> Active;
+              for (unsigned Lane = 0; Lane < NumLanes; Lane++) {
+                if (ConstMask) {
+                  Constant *Bit = ConstMask->getAggregateElement(Lane);
+                  if (Bit && Bit->isZeroValue())
+                    continue;
+                }
+                Active.push_back(Lane);
+              }
+              if (!Active.empty()) {
+                IRBuilder<> Builder(&I);
+                uint64_t ElemSize = M->getDataLayout().getTypeStoreSize(ElemTy);
+                Value *SizeVal =
+                    ConstantInt::get(Type::getInt32Ty(Ctx), ElemSize);
+                Value *LanesVal =
+                    ConstantInt::get(Type::getInt32Ty(Ctx), Active.size());
+                SiteLocation Site = resolveSite(I.getDebugLoc());
+                Value *File = Builder.CreateGlobalString(Site.File);
+                Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
+                for (unsigned K = 0; K < Active.size(); K++) {
+                  Value *Addr = Builder.CreateExtractElement(Ptrs, Active[K]);
+                  Value *LaneVal = ConstantInt::get(Type::getInt32Ty(Ctx), K);
+                  Builder.CreateCall(IsScatter ? TagScatterLane : TagGatherLane,
+                                     {Addr, SizeVal, LaneVal, LanesVal, File,
+                                      Line});
+                }
+              }
+            }
+            continue;
+          }
+
           // llvm.memmove intrinsic
           if (Name.starts_with("llvm.memmove")) {
             Value *Dest = CI->getArgOperand(0);
@@ -472,8 +920,9 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
             Value *Len = CI->getArgOperand(2);
             IRBuilder<> Builder(&I);
             Value *SizeVal = Builder.CreateTrunc(Len, Type::getInt32Ty(Ctx));
-            Value *File = Builder.CreateGlobalString(I.getDebugLoc()->getFilename());
-            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), I.getDebugLoc()->getLine());
+            SiteLocation Site = resolveSite(I.getDebugLoc());
+            Value *File = Builder.CreateGlobalString(Site.File);
+            Value *Line = ConstantInt::get(Type::getInt32Ty(Ctx), Site.Line);
             Builder.CreateCall(TagMemmove, {Dest, Src, SizeVal, File, Line});
             continue;
           }
@@ -482,6 +931,12 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
 
       // Load instruction
       if (auto *LI = dyn_cast<LoadInst>(&I)) {
+        if (RangeCompressed.count(LI))
+          continue; // Covered by a preheader range event
+        if (InlineFastPath && !LI->isAtomic() && !LI->getType()->isVectorTy()) {
+          InlineSites.push_back(&I);
+          continue;
+        }
         auto data = prepareInstrumentation(M, Ctx, I, LI->getPointerOperand(),
                                            LI->getType());
         IRBuilder<> Builder(&I);
@@ -506,6 +961,13 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
 
       // Store instruction
       if (auto *SI = dyn_cast<StoreInst>(&I)) {
+        if (RangeCompressed.count(SI))
+          continue; // Covered by a preheader range event
+        if (InlineFastPath && !SI->isAtomic() &&
+            !SI->getValueOperand()->getType()->isVectorTy()) {
+          InlineSites.push_back(&I);
+          continue;
+        }
         auto data = prepareInstrumentation(M, Ctx, I, SI->getPointerOperand(),
                                            SI->getValueOperand()->getType());
         IRBuilder<> Builder(&I);
@@ -530,6 +992,23 @@ PreservedAnalyses CacheExplorerPass::run(Function &F,
     }
   }
 
+  // Rewrite the collected plain loads/stores with the inline fast path
+  for (Instruction *Site : InlineSites) {
+    SiteLocation Loc = resolveSite(Site->getDebugLoc());
+    if (auto *LI = dyn_cast<LoadInst>(Site)) {
+      emitInlineFastPath(M, LI, LI->getPointerOperand(),
+                         M->getDataLayout().getTypeStoreSize(LI->getType()),
+                         Loc.File, Loc.Line,
+                         /*IsStore=*/false, TagLoad);
+    } else {
+      auto *SI = cast<StoreInst>(Site);
+      emitInlineFastPath(
+          M, SI, SI->getPointerOperand(),
+          M->getDataLayout().getTypeStoreSize(SI->getValueOperand()->getType()),
+          Loc.File, Loc.Line, /*IsStore=*/true, TagStore);
+    }
+  }
+
   return PreservedAnalyses::none();
 }
 
@@ -561,6 +1040,12 @@ PreservedAnalyses CacheExplorerModulePass::run(Module &M,
       Changed = true;
   }
 
+  if (!ModuleSites.empty()) {
+    emitSiteRegistrations(M);
+    ModuleSites.clear();
+    Changed = true;
+  }
+
   return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
 }
 
@@ -4,6 +4,13 @@
  * Dynamic binary instrumentation for cache profiling.
  * Works with any compiled binary (GCC, MSVC, etc.) without recompilation.
  *
+ * Capture mirrors the runtime library (backend/runtime/cache-explorer-rt.c):
+ * packed events accumulate in a per-thread buffer and are flushed in large
+ * batches under a single lock instead of formatting and locking per access.
+ * Source locations are resolved once at instrumentation time and baked into
+ * the analysis call as a packed (file_id << 20 | line) word, so the hot path
+ * never touches a map or a string.
+ *
  * Build:
  *   make PIN_ROOT=/path/to/pin obj-intel64/cache_profiler.so
  *
@@ -12,19 +19,26 @@
  *   # Output goes to cache_trace.txt, then:
  *   cat cache_trace.txt | cache-sim --json
  *
+ *   # Binary CXTB output (smaller, faster to parse):
+ *   pin -t obj-intel64/cache_profiler.so -binary 1 -- ./your_binary
+ *
+ *   # Attach to a running process, capture a bounded window, detach:
+ *   pin -pid $(pidof my_service) -t obj-intel64/cache_profiler.so \
+ *       -detach-after 5000000
+ *
  * Or with wrapper:
  *   cache-explore-pin ./your_binary
  */
 
 #include "pin.H"
-#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
-#include <unordered_map>
+#include <map>
 #include <string>
-#include <cstring>
 
 // Output file
-static std::ofstream trace_file;
+static FILE* trace_file = nullptr;
 
 // Knobs (command line options)
 KNOB<std::string> KnobOutputFile(KNOB_MODE_WRITEONCE, "pintool",
@@ -36,99 +50,316 @@ KNOB<BOOL> KnobTraceLoads(KNOB_MODE_WRITEONCE, "pintool",
 KNOB<BOOL> KnobTraceStores(KNOB_MODE_WRITEONCE, "pintool",
     "s", "1", "Trace store instructions");
 
+KNOB<BOOL> KnobBinary(KNOB_MODE_WRITEONCE, "pintool",
+    "binary", "0", "Emit binary CXTB trace instead of text");
+
 KNOB<UINT64> KnobMaxEvents(KNOB_MODE_WRITEONCE, "pintool",
     "max", "10000000", "Maximum events to trace");
 
 KNOB<UINT64> KnobSampleRate(KNOB_MODE_WRITEONCE, "pintool",
     "sample", "1", "Sample rate (1 = all, 100 = 1%%)");
 
+KNOB<BOOL> KnobRoi(KNOB_MODE_WRITEONCE, "pintool",
+    "roi", "0", "Start with capture off; __cache_explorer_start/stop toggle it");
+
+KNOB<UINT64> KnobDetachAfter(KNOB_MODE_WRITEONCE, "pintool",
+    "detach-after", "0", "Detach from the process after N events (0 = never)");
+
 // Statistics
 static UINT64 total_loads = 0;
 static UINT64 total_stores = 0;
 static UINT64 traced_events = 0;
-static UINT64 sample_counter = 0;
 
-// Thread ID tracking
-static TLS_KEY tls_key = INVALID_TLS_KEY;
+// Region-of-interest gate, same semantics as the runtime library: start
+// opens a numbered phase and turns emission on, stop emits the matching
+// end marker and turns it off, pause/resume toggle without markers. The
+// markers are the runtime API symbols, so a binary linked against
+// cache-explorer-rt (or carrying stub functions with those names) marks
+// its regions identically under Pin.
+static volatile BOOL emission_on = TRUE;
+static UINT32 phase_counter = 0;
+
+// Set once a -detach-after flush crosses the cap; Pin detaches and the
+// process continues at full speed
+static volatile BOOL detach_requested = FALSE;
+
+// One buffered memory access. Mirrors the runtime's CacheEvent: the store
+// bit rides in the top of the address (real addresses fit in 48 bits) and
+// line packs (file_id << 20) | line.
+struct PinEvent {
+    UINT64 addr;  // bit 63 = store
+    UINT32 size;
+    UINT32 line;
+};
+
+static const UINT64 PIN_EVENT_STORE = 1ULL << 63;
+static const UINT64 PIN_EVENT_PHASE = 1ULL << 51;
+static const UINT64 PIN_EVENT_ADDR_MASK = 0x00FFFFFFFFFFFFFFULL;
+
+// Per-thread capture buffer, flushed in one batch when full. 64K events
+// is ~1MB per thread - the same ring depth the runtime uses - and turns
+// millions of per-access lock/format round trips into a few dozen.
+static const UINT32 BUF_EVENTS = 1 << 16;
 
 struct ThreadData {
     UINT32 thread_id;
-    UINT64 event_count;
+    UINT32 count;            // events buffered so far
+    UINT64 sample_countdown; // keep 1 in every KnobSampleRate accesses
+    PinEvent events[BUF_EVENTS];
 };
 
-// Image and routine info for source attribution
-struct SourceLocation {
-    std::string file;
-    UINT32 line;
-    std::string routine;
-};
+// Thread ID tracking
+static TLS_KEY tls_key = INVALID_TLS_KEY;
 
-static std::unordered_map<ADDRINT, SourceLocation> addr_to_source;
+// File interning: paths become small ids at instrumentation time, emitted
+// once as D (text) or F (binary) records. Id 0 is reserved for "no debug
+// info" so a zero location word means "omit the location" in text mode.
+static std::map<std::string, UINT32> file_ids;
+static UINT32 next_file_id = 1;
+static PIN_LOCK file_lock;
+
+// Serializes batch flushes to the output file
 static PIN_LOCK output_lock;
 
+// Staging buffer for formatted text output; shared because it is only
+// touched while holding output_lock (same shape as the runtime's write_buf)
+static const size_t WRITE_BUF_SIZE = 1 << 20;
+static char write_buf[WRITE_BUF_SIZE];
+
+// --- Minimal formatters (no snprintf in the flush loop) ---
+
+static char* fmt_hex(char* p, UINT64 value) {
+    static const char digits[] = "0123456789abcdef";
+    *p++ = '0';
+    *p++ = 'x';
+    char tmp[16];
+    int n = 0;
+    do {
+        tmp[n++] = digits[value & 0xF];
+        value >>= 4;
+    } while (value);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static char* fmt_dec(char* p, UINT64 value) {
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
 // Get thread-local data
 static ThreadData* GetThreadData(THREADID tid) {
     ThreadData* data = static_cast<ThreadData*>(PIN_GetThreadData(tls_key, tid));
     if (!data) {
         data = new ThreadData();
         data->thread_id = tid;
-        data->event_count = 0;
+        data->count = 0;
+        data->sample_countdown = KnobSampleRate.Value();
         PIN_SetThreadData(tls_key, data, tid);
     }
     return data;
 }
 
-// Record a memory access
-static VOID RecordMemAccess(THREADID tid, VOID* addr, UINT32 size, BOOL is_write, ADDRINT ip) {
-    if (traced_events >= KnobMaxEvents.Value()) {
+// Intern a source path, emitting its registration record on first sight.
+// Runs at instrumentation (JIT) time only, never on the analysis hot path.
+static UINT32 InternFile(const std::string& file, THREADID tid) {
+    PIN_GetLock(&file_lock, tid + 1);
+    UINT32 id;
+    std::map<std::string, UINT32>::iterator it = file_ids.find(file);
+    if (it != file_ids.end()) {
+        id = it->second;
+    } else {
+        id = next_file_id++;
+        file_ids[file] = id;
+        PIN_GetLock(&output_lock, tid + 1);
+        if (KnobBinary.Value()) {
+            UINT16 len = (UINT16)file.size();
+            fputc('F', trace_file);
+            fwrite(&id, sizeof(id), 1, trace_file);
+            fwrite(&len, sizeof(len), 1, trace_file);
+            fwrite(file.data(), 1, len, trace_file);
+        } else {
+            char* p = write_buf;
+            *p++ = 'D';
+            *p++ = ' ';
+            p = fmt_dec(p, id);
+            *p++ = ' ';
+            memcpy(p, file.data(), file.size());
+            p += file.size();
+            *p++ = '\n';
+            fwrite(write_buf, 1, p - write_buf, trace_file);
+        }
+        PIN_ReleaseLock(&output_lock);
+    }
+    PIN_ReleaseLock(&file_lock);
+    return id;
+}
+
+// Write a full batch out under the lock. Text events format into write_buf
+// and flush in ~1MB slabs; binary events go out as CXTB 'E' records.
+static VOID FlushBuffer(ThreadData* tdata) {
+    if (tdata->count == 0) {
         return;
     }
 
-    // Sampling
-    if (KnobSampleRate.Value() > 1) {
-        sample_counter++;
-        if (sample_counter % KnobSampleRate.Value() != 0) {
-            return;
+    PIN_GetLock(&output_lock, tdata->thread_id + 1);
+
+    if (KnobBinary.Value()) {
+        // CXTB 'E' record: tag + {addr, src_addr, size, line, thread}
+        for (UINT32 i = 0; i < tdata->count; i++) {
+            const PinEvent& e = tdata->events[i];
+            char rec[1 + 28];
+            rec[0] = 'E';
+            UINT64 src = 0;
+            memcpy(rec + 1, &e.addr, 8);
+            memcpy(rec + 9, &src, 8);
+            memcpy(rec + 17, &e.size, 4);
+            memcpy(rec + 21, &e.line, 4);
+            memcpy(rec + 25, &tdata->thread_id, 4);
+            fwrite(rec, 1, sizeof(rec), trace_file);
         }
+    } else {
+        char* p = write_buf;
+        for (UINT32 i = 0; i < tdata->count; i++) {
+            const PinEvent& e = tdata->events[i];
+            // Worst case line is ~64 bytes; flush the slab before it fills
+            if ((size_t)(p - write_buf) > WRITE_BUF_SIZE - 80) {
+                fwrite(write_buf, 1, p - write_buf, trace_file);
+                p = write_buf;
+            }
+            *p++ = (e.addr & PIN_EVENT_STORE) ? 'S' : 'L';
+            *p++ = ' ';
+            p = fmt_hex(p, e.addr & PIN_EVENT_ADDR_MASK);
+            *p++ = ' ';
+            p = fmt_dec(p, e.size);
+            if (e.line != 0) {
+                *p++ = ' ';
+                p = fmt_dec(p, e.line >> 20);
+                *p++ = ':';
+                p = fmt_dec(p, e.line & 0xFFFFF);
+            }
+            *p++ = ' ';
+            *p++ = 'T';
+            p = fmt_dec(p, tdata->thread_id);
+            *p++ = '\n';
+        }
+        fwrite(write_buf, 1, p - write_buf, trace_file);
     }
 
-    ThreadData* tdata = GetThreadData(tid);
+    // Update statistics while we hold the lock; the hot-path limit check
+    // reads traced_events unlocked, so the cap is enforced at batch
+    // granularity (same approximation the runtime makes)
+    for (UINT32 i = 0; i < tdata->count; i++) {
+        if (tdata->events[i].addr & PIN_EVENT_STORE) {
+            total_stores++;
+        } else {
+            total_loads++;
+        }
+    }
+    traced_events += tdata->count;
+    tdata->count = 0;
+
+    // Bounded-window capture for attach mode: once the cap is crossed,
+    // detach and let the process run at native speed again. Buffers still
+    // in flight on other threads are dropped, which is fine for a window.
+    if (KnobDetachAfter.Value() > 0 && !detach_requested &&
+        traced_events >= KnobDetachAfter.Value()) {
+        detach_requested = TRUE;
+        PIN_ReleaseLock(&output_lock);
+        PIN_Detach();
+        return;
+    }
 
-    // Find source location
-    std::string file = "";
-    UINT32 line = 0;
+    PIN_ReleaseLock(&output_lock);
+}
 
-    auto it = addr_to_source.find(ip);
-    if (it != addr_to_source.end()) {
-        file = it->second.file;
-        line = it->second.line;
-    }
+// Emit a B/E phase marker. The caller's buffer is flushed first so the
+// marker lands in trace order relative to that thread's events.
+static VOID EmitPhaseMarker(THREADID tid, UINT32 id, BOOL is_end) {
+    ThreadData* tdata = GetThreadData(tid);
+    FlushBuffer(tdata);
 
-    // Format: R/W address size thread_id file line
-    // Example: R 0x7fff5fbff8e0 4 0 main.c 42
     PIN_GetLock(&output_lock, tid + 1);
+    if (KnobBinary.Value()) {
+        char rec[1 + 28];
+        rec[0] = 'E';
+        UINT64 addr = (UINT64)id | PIN_EVENT_PHASE |
+                      (is_end ? PIN_EVENT_STORE : 0);
+        UINT64 src = 0;
+        UINT32 zero = 0;
+        memcpy(rec + 1, &addr, 8);
+        memcpy(rec + 9, &src, 8);
+        memcpy(rec + 17, &zero, 4);
+        memcpy(rec + 21, &zero, 4);
+        memcpy(rec + 25, &tid, 4);
+        fwrite(rec, 1, sizeof(rec), trace_file);
+    } else {
+        char* p = write_buf;
+        *p++ = is_end ? 'E' : 'B';
+        *p++ = ' ';
+        p = fmt_hex(p, id);
+        *p++ = ' ';
+        *p++ = 'T';
+        p = fmt_dec(p, tid);
+        *p++ = '\n';
+        fwrite(write_buf, 1, p - write_buf, trace_file);
+    }
+    PIN_ReleaseLock(&output_lock);
+}
+
+// --- Region-of-interest markers (runtime API semantics) ---
 
-    trace_file << (is_write ? "W" : "R") << " "
-               << reinterpret_cast<UINT64>(addr) << " "
-               << size << " "
-               << tdata->thread_id;
+static VOID RoiStart(THREADID tid) {
+    UINT32 id = ++phase_counter;
+    emission_on = TRUE;
+    EmitPhaseMarker(tid, id, FALSE);
+}
+
+static VOID RoiStop(THREADID tid) {
+    EmitPhaseMarker(tid, phase_counter, TRUE);
+    emission_on = FALSE;
+}
+
+static VOID RoiPause(THREADID tid) {
+    emission_on = FALSE;
+}
 
-    if (!file.empty()) {
-        trace_file << " " << file << " " << line;
+static VOID RoiResume(THREADID tid) {
+    emission_on = TRUE;
+}
+
+// Record a memory access: two compares, one packed store, one increment.
+// All formatting and locking happens in FlushBuffer.
+static VOID RecordMemAccess(THREADID tid, VOID* addr, UINT32 size,
+                            BOOL is_write, UINT32 location) {
+    if (!emission_on || traced_events >= KnobMaxEvents.Value()) {
+        return;
     }
 
-    trace_file << "\n";
+    ThreadData* tdata = GetThreadData(tid);
 
-    traced_events++;
-    tdata->event_count++;
+    // Sampling (per-thread countdown; the old shared counter raced)
+    if (KnobSampleRate.Value() > 1) {
+        if (--tdata->sample_countdown != 0) {
+            return;
+        }
+        tdata->sample_countdown = KnobSampleRate.Value();
+    }
 
-    PIN_ReleaseLock(&output_lock);
+    PinEvent& e = tdata->events[tdata->count++];
+    e.addr = (reinterpret_cast<UINT64>(addr) & PIN_EVENT_ADDR_MASK) |
+             (is_write ? PIN_EVENT_STORE : 0);
+    e.size = size;
+    e.line = location;
 
-    // Update statistics
-    if (is_write) {
-        total_stores++;
-    } else {
-        total_loads++;
+    if (tdata->count == BUF_EVENTS) {
+        FlushBuffer(tdata);
     }
 }
 
@@ -142,24 +373,18 @@ static VOID InstrumentInstruction(INS ins, VOID* v) {
         return;
     }
 
-    // Cache source location for this instruction
+    // Resolve the source location once, here, and bake the packed
+    // (file_id << 20 | line) word into the analysis call
     ADDRINT ip = INS_Address(ins);
-    if (addr_to_source.find(ip) == addr_to_source.end()) {
-        SourceLocation loc;
-        loc.line = 0;
-
-        // Try to get source info from debug info
-        INT32 column;
-        PIN_GetSourceLocation(ip, &column, reinterpret_cast<INT32*>(&loc.line),
-                              const_cast<std::string*>(&loc.file));
-
-        // Get routine name
-        RTN rtn = INS_Rtn(ins);
-        if (RTN_Valid(rtn)) {
-            loc.routine = RTN_Name(rtn);
-        }
+    INT32 column = 0;
+    INT32 line = 0;
+    std::string file;
+    PIN_GetSourceLocation(ip, &column, &line, &file);
 
-        addr_to_source[ip] = loc;
+    UINT32 location = 0;
+    if (!file.empty() && line > 0) {
+        UINT32 id = InternFile(file, PIN_ThreadId());
+        location = (id << 20) | ((UINT32)line & 0xFFFFF);
     }
 
     // Instrument each memory operand
@@ -173,7 +398,7 @@ static VOID InstrumentInstruction(INS ins, VOID* v) {
                 IARG_MEMORYOP_EA, memOp,
                 IARG_UINT32, size,
                 IARG_BOOL, FALSE,  // is_write = false
-                IARG_INST_PTR,
+                IARG_UINT32, location,
                 IARG_END);
         }
 
@@ -184,12 +409,34 @@ static VOID InstrumentInstruction(INS ins, VOID* v) {
                 IARG_MEMORYOP_EA, memOp,
                 IARG_UINT32, size,
                 IARG_BOOL, TRUE,   // is_write = true
-                IARG_INST_PTR,
+                IARG_UINT32, location,
                 IARG_END);
         }
     }
 }
 
+// Image load callback: hook the runtime's ROI marker symbols so a binary
+// that brackets its regions with __cache_explorer_start/stop (or stubs
+// with those names) toggles capture under Pin exactly as it does under
+// the compiled-in runtime
+static VOID InstrumentImage(IMG img, VOID* v) {
+    struct { const char* name; AFUNPTR fn; } hooks[] = {
+        { "__cache_explorer_start",  (AFUNPTR)RoiStart },
+        { "__cache_explorer_stop",   (AFUNPTR)RoiStop },
+        { "__cache_explorer_pause",  (AFUNPTR)RoiPause },
+        { "__cache_explorer_resume", (AFUNPTR)RoiResume },
+    };
+    for (size_t i = 0; i < sizeof(hooks) / sizeof(hooks[0]); i++) {
+        RTN rtn = RTN_FindByName(img, hooks[i].name);
+        if (RTN_Valid(rtn)) {
+            RTN_Open(rtn);
+            RTN_InsertCall(rtn, IPOINT_BEFORE, hooks[i].fn,
+                           IARG_THREAD_ID, IARG_END);
+            RTN_Close(rtn);
+        }
+    }
+}
+
 // Thread start callback
 static VOID ThreadStart(THREADID tid, CONTEXT* ctxt, INT32 flags, VOID* v) {
     GetThreadData(tid);
@@ -197,8 +444,9 @@ static VOID ThreadStart(THREADID tid, CONTEXT* ctxt, INT32 flags, VOID* v) {
 
 // Thread end callback
 static VOID ThreadFini(THREADID tid, const CONTEXT* ctxt, INT32 code, VOID* v) {
-    ThreadData* data = GetThreadData(tid);
+    ThreadData* data = static_cast<ThreadData*>(PIN_GetThreadData(tls_key, tid));
     if (data) {
+        FlushBuffer(data);
         delete data;
         PIN_SetThreadData(tls_key, nullptr, tid);
     }
@@ -206,7 +454,7 @@ static VOID ThreadFini(THREADID tid, const CONTEXT* ctxt, INT32 code, VOID* v) {
 
 // Finalization callback
 static VOID Fini(INT32 code, VOID* v) {
-    trace_file.close();
+    fclose(trace_file);
 
     std::cerr << "\n=== Cache Explorer Pin Tool ===" << std::endl;
     std::cerr << "Total loads:  " << total_loads << std::endl;
@@ -217,6 +465,17 @@ static VOID Fini(INT32 code, VOID* v) {
               << " | cache-sim --json" << std::endl;
 }
 
+// Detach callback: runs after Pin has stopped instrumenting (attach-mode
+// window complete). The calling thread's buffer was flushed before
+// PIN_Detach; close out the trace and report like a normal exit.
+static VOID Detach(VOID* v) {
+    fclose(trace_file);
+
+    std::cerr << "\n=== Cache Explorer Pin Tool (detached) ===" << std::endl;
+    std::cerr << "Traced events: " << traced_events << std::endl;
+    std::cerr << "Output: " << KnobOutputFile.Value() << std::endl;
+}
+
 // Usage message
 static INT32 Usage() {
     std::cerr << "Cache Explorer Pin Tool" << std::endl;
@@ -232,8 +491,9 @@ int main(int argc, char* argv[]) {
         return Usage();
     }
 
-    // Initialize lock
+    // Initialize locks
     PIN_InitLock(&output_lock);
+    PIN_InitLock(&file_lock);
 
     // Allocate TLS key
     tls_key = PIN_CreateThreadDataKey(nullptr);
@@ -243,21 +503,38 @@ int main(int argc, char* argv[]) {
     }
 
     // Open output file
-    trace_file.open(KnobOutputFile.Value().c_str());
-    if (!trace_file.is_open()) {
+    trace_file = fopen(KnobOutputFile.Value().c_str(),
+                       KnobBinary.Value() ? "wb" : "w");
+    if (!trace_file) {
         std::cerr << "Failed to open output file: "
                   << KnobOutputFile.Value() << std::endl;
         return 1;
     }
 
+    // Binary header: magic "CXTB" + uint32 version
+    if (KnobBinary.Value()) {
+        UINT32 version = 1;
+        fwrite("CXTB", 1, 4, trace_file);
+        fwrite(&version, sizeof(version), 1, trace_file);
+    }
+
+    // ROI mode: begin with capture off and let the markers open it
+    if (KnobRoi.Value()) {
+        emission_on = FALSE;
+    }
+
     // Register callbacks
+    PIN_InitSymbols();
     INS_AddInstrumentFunction(InstrumentInstruction, nullptr);
+    IMG_AddInstrumentFunction(InstrumentImage, nullptr);
     PIN_AddThreadStartFunction(ThreadStart, nullptr);
     PIN_AddThreadFiniFunction(ThreadFini, nullptr);
     PIN_AddFiniFunction(Fini, nullptr);
+    PIN_AddDetachFunction(Detach, nullptr);
 
     std::cerr << "Cache Explorer Pin Tool started" << std::endl;
-    std::cerr << "  Output: " << KnobOutputFile.Value() << std::endl;
+    std::cerr << "  Output: " << KnobOutputFile.Value()
+              << (KnobBinary.Value() ? " (binary)" : "") << std::endl;
     std::cerr << "  Max events: " << KnobMaxEvents.Value() << std::endl;
     if (KnobSampleRate.Value() > 1) {
         std::cerr << "  Sample rate: 1/" << KnobSampleRate.Value() << std::endl;
@@ -1,88 +1,662 @@
+#define _GNU_SOURCE  // RTLD_NEXT for the malloc interposition below
 #include "cache-explorer-rt.h"
+#include <dlfcn.h>
 #include <fcntl.h>
+#if defined(__linux__)
+#include <link.h>  // dl_iterate_phdr for the region map below
+#endif
 #include <pthread.h>
 #include <stdatomic.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <time.h>
 #include <unistd.h>
 
-static _Thread_local uint32_t cached_thread_id = 0;
+// Exported so the pass's inline fast path can read it directly (see
+// CACHE_EXPLORER_INLINE in CacheExplorerPass.cpp)
+_Thread_local uint32_t __cache_explorer_tid = 0;
 static atomic_uint_fast32_t thread_counter = 1;
 
 static uint32_t get_thread_id(void) {
-  if (cached_thread_id == 0) {
-    cached_thread_id = atomic_fetch_add(&thread_counter, 1);
+  if (__cache_explorer_tid == 0) {
+    __cache_explorer_tid = atomic_fetch_add(&thread_counter, 1);
   }
-  return cached_thread_id;
+  return __cache_explorer_tid;
 }
 
-#define BUFFER_SIZE (1 << 20)
-#define BUFFER_MASK (BUFFER_SIZE - 1)
+// Per-thread SPSC ring buffers: each thread produces into its own ring,
+// so __tag_mem_load/__tag_mem_store never contend on a shared head/tail
+// cache line. The flush path (serialized by flush_mutex) is the single
+// consumer that drains every registered ring.
+#define RING_SIZE (1 << 16)
+#define RING_MASK (RING_SIZE - 1)
+#define MAX_THREADS 1024
+
+typedef struct {
+  CacheEvent events[RING_SIZE];
+  // head is written only by the owning thread, tail only by the drain
+  // path - separate cache lines so draining doesn't stall the producer
+  _Alignas(64) atomic_uint_fast64_t head;
+  _Alignas(64) atomic_uint_fast64_t tail;
+} ThreadRing;
+
+// Ring geometry is baked into pass-generated IR when the inline fast
+// path is enabled - keep these in sync with CacheExplorerPass.cpp
+_Static_assert(sizeof(CacheEvent) == 32, "CacheEvent layout baked into pass IR");
+_Static_assert(RING_SIZE == (1 << 16), "ring size baked into pass IR");
+_Static_assert(offsetof(ThreadRing, head) == (size_t)RING_SIZE * 32,
+               "head offset baked into pass IR");
+_Static_assert(offsetof(ThreadRing, tail) == (size_t)RING_SIZE * 32 + 64,
+               "tail offset baked into pass IR");
+
+static ThreadRing *_Atomic thread_rings[MAX_THREADS];
+static _Thread_local ThreadRing *my_ring = NULL;
+
+// Inline fast path (CACHE_EXPLORER_INLINE in the pass): instrumented code
+// claims ring slots directly through this pointer, calling the runtime
+// only when the ring is full or the thread is unregistered. It is only
+// published when the configuration allows bypassing the slow path -
+// sampling and event limits need every event to go through emit_event,
+// and without the flusher thread nothing would drain an inline-filled
+// ring. NULL otherwise, which sends the generated code down the call.
+_Thread_local void *__cache_explorer_inline_ring = NULL;
+static int inline_path_ok = 0;
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int thread_overflow_warned = 0;
+
+// Shared-memory transport (CACHE_EXPLORER_SHM=<path>): the rings live in
+// a mapped segment instead of private calloc'd memory, and cache-sim
+// --shm maps the same file and drains them in place. The simulator is
+// the single consumer (it moves tail), so no flusher thread runs, the
+// flush path never drains, and a full ring means the simulator is
+// behind - same bounded-wait-then-drop policy as the flusher. Layout
+// contract lives in cache-explorer-rt.h, mirrored by ShmTransport.hpp.
+static void *shm_base = NULL;
+static CacheShmHeader *shm_hdr = NULL;
+static int shm_mode = 0;
+static int shm_overflow_warned = 0;
+
+_Static_assert(CACHE_SHM_RING_EVENTS == RING_SIZE,
+               "shm ring geometry must match the in-process rings");
+_Static_assert(sizeof(ThreadRing) <= CACHE_SHM_RING_STRIDE,
+               "ring slots must hold a whole ThreadRing");
+
+static int shm_open_segment(const char *path) {
+  // O_TRUNC so a reused path can't leak stale ring contents; ftruncate
+  // makes the segment sparse - only touched pages ever commit
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return 0;
+  if (ftruncate(fd, (off_t)CACHE_SHM_SEGMENT_SIZE) != 0) {
+    close(fd);
+    return 0;
+  }
+  void *base = mmap(NULL, CACHE_SHM_SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return 0;
+
+  shm_base = base;
+  shm_hdr = (CacheShmHeader *)base;
+  shm_hdr->version = CACHE_SHM_VERSION;
+  shm_hdr->ring_events = CACHE_SHM_RING_EVENTS;
+  shm_hdr->max_rings = CACHE_SHM_MAX_RINGS;
+  shm_hdr->max_files = CACHE_SHM_MAX_FILES;
+  // Publish the magic last so a consumer that sees it sees a complete
+  // header (it polls the first page until this lands)
+  uint32_t magic;
+  memcpy(&magic, "CXSM", 4);
+  __atomic_store_n((uint32_t *)shm_hdr->magic, magic, __ATOMIC_RELEASE);
+  return 1;
+}
 
-static struct {
-  CacheEvent events[BUFFER_SIZE];
-  atomic_uint_fast64_t head;
-  atomic_uint_fast64_t tail;
-  char padding[64];
-} ring_buffer;
+static CacheShmFile *shm_file_entry(uint32_t id) {
+  return (CacheShmFile *)((char *)shm_base + CACHE_SHM_FILE_OFF) + id;
+}
+
+// Dedicated flush thread: drains the rings and issues the batched writes
+// so traced threads never stall on formatting or pipe backpressure.
+// Overload policy: a producer that finds its ring full waits a bounded
+// time for the flusher to free space, then drops the event and counts it
+// (reported at shutdown). If the thread can't be started the runtime
+// falls back to the old synchronous flush-from-producer path.
+static pthread_t flusher_thread;
+static int flusher_started = 0;
+static atomic_int flusher_run = 0;
+static atomic_int flush_requested = 0;
+static atomic_uint_fast64_t dropped_events = 0;
+
+// Bounded wait on a full ring: FULL_WAIT_SPINS x FULL_WAIT_NSEC (~10ms)
+#define FULL_WAIT_SPINS 100
+#define FULL_WAIT_NSEC 100000
+
+// Adaptive sampling (CACHE_EXPLORER_ADAPTIVE=1): instead of guessing the
+// divisor up front, the flush thread watches ring occupancy and the
+// captured event rate and moves it between CACHE_EXPLORER_SAMPLE_RATE
+// (the floor) and CACHE_EXPLORER_ADAPTIVE_MAX, aiming the capture at
+// CACHE_EXPLORER_ADAPTIVE_TARGET events/sec. Every change reaches the
+// trace as a "W <divisor>" record so cache-sim can reweight its stats.
+static int adaptive_sampling = 0;
+static _Atomic uint32_t adaptive_divisor = 1;
+static uint32_t adaptive_min = 1;
+static uint32_t adaptive_max = 1024;
+static uint64_t adaptive_target = 2000000;
+static atomic_uint_fast64_t adaptive_drained = 0;
+
+// How often the rate side of the controller re-decides; the occupancy
+// side reacts on every call (a filling ring is the overload the
+// drop-and-count policy would otherwise absorb)
+#define ADAPTIVE_INTERVAL_NSEC 100000000ull /* 100ms */
+
+// Runs on the flush thread right after each drain, so a new divisor
+// mislabels at most the handful of events produced since - the W record
+// announcing it goes out at the next flush, ahead of everything sampled
+// under it (see emit_text_rate_record). Doubling/halving with a 4x
+// hysteresis band keeps the divisor from oscillating: halving doubles
+// the captured rate, so requiring a quarter of the target first leaves
+// it at half the target afterwards.
+static void adaptive_adjust(void) {
+  uint32_t divisor =
+      atomic_load_explicit(&adaptive_divisor, memory_order_relaxed);
+
+  // Occupancy pressure: any ring past 3/4 full means the flusher is
+  // losing ground at this divisor - back off immediately
+  uint32_t threads = atomic_load(&thread_counter) - 1;  // ids start at 1
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+  uint64_t max_occ = 0;
+  for (uint32_t slot = 0; slot < threads; slot++) {
+    ThreadRing *ring =
+        atomic_load_explicit(&thread_rings[slot], memory_order_acquire);
+    if (ring == NULL)
+      continue;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t occ = (head - tail) & RING_MASK;
+    if (occ > max_occ)
+      max_occ = occ;
+  }
+  if (max_occ > (RING_SIZE * 3) / 4 && divisor < adaptive_max) {
+    divisor *= 2;
+    if (divisor > adaptive_max)
+      divisor = adaptive_max;
+    atomic_store_explicit(&adaptive_divisor, divisor, memory_order_relaxed);
+    return;
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t now = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+  static uint64_t last_check = 0;
+  static uint64_t last_drained = 0;
+  if (last_check == 0) {
+    last_check = now;
+    last_drained =
+        atomic_load_explicit(&adaptive_drained, memory_order_relaxed);
+    return;
+  }
+  uint64_t elapsed = now - last_check;
+  if (elapsed < ADAPTIVE_INTERVAL_NSEC)
+    return;
+  uint64_t drained =
+      atomic_load_explicit(&adaptive_drained, memory_order_relaxed);
+  uint64_t per_sec = (drained - last_drained) * 1000000000ull / elapsed;
+  last_check = now;
+  last_drained = drained;
+
+  if (per_sec > adaptive_target && divisor < adaptive_max) {
+    divisor *= 2;
+    if (divisor > adaptive_max)
+      divisor = adaptive_max;
+  } else if (per_sec < adaptive_target / 4 && divisor > adaptive_min) {
+    divisor /= 2;
+    if (divisor < adaptive_min)
+      divisor = adaptive_min;
+  } else {
+    return;
+  }
+  atomic_store_explicit(&adaptive_divisor, divisor, memory_order_relaxed);
+}
+
+static void *flusher_main(void *arg) {
+  (void)arg;
+  while (atomic_load_explicit(&flusher_run, memory_order_relaxed)) {
+    atomic_store_explicit(&flush_requested, 0, memory_order_relaxed);
+    __cache_explorer_flush();
+    if (adaptive_sampling) {
+      adaptive_adjust();
+    }
+    if (!atomic_load_explicit(&flush_requested, memory_order_relaxed)) {
+      struct timespec ts = {0, 500000};  // 500us idle poll
+      nanosleep(&ts, NULL);
+    }
+  }
+  return NULL;
+}
+
+// Region map registration (defined with the region table below)
+static void region_register_thread_stack(void);
+
+static ThreadRing *register_thread_ring(void) {
+  // One-time per thread: record its stack range in the region map
+  region_register_thread_stack();
+
+  if (shm_mode) {
+    // Claim the next shm ring slot; its memory is fresh (O_TRUNC +
+    // ftruncate), so head/tail start zeroed and the consumer may scan
+    // it the moment num_rings covers the slot
+    uint32_t shm_slot =
+        __atomic_fetch_add(&shm_hdr->num_rings, 1, __ATOMIC_RELAXED);
+    if (shm_slot >= CACHE_SHM_MAX_RINGS) {
+      if (!shm_overflow_warned) {
+        shm_overflow_warned = 1;
+        fprintf(stderr, "[cache-explorer] WARNING: shm ring slots exhausted "
+                "(>%d threads). Events from additional threads will be "
+                "dropped.\n", CACHE_SHM_MAX_RINGS);
+      }
+      return NULL;
+    }
+    ThreadRing *ring =
+        (ThreadRing *)((char *)shm_base + CACHE_SHM_RING_OFF +
+                       (uint64_t)shm_slot * CACHE_SHM_RING_STRIDE);
+    my_ring = ring;
+    if (inline_path_ok)
+      __cache_explorer_inline_ring = ring;
+    return ring;
+  }
+
+  uint32_t slot = get_thread_id() - 1;
+  if (slot >= MAX_THREADS) {
+    if (!thread_overflow_warned) {
+      thread_overflow_warned = 1;
+      fprintf(stderr, "[cache-explorer] WARNING: Thread limit exceeded (>%d). "
+              "Events from additional threads will be dropped.\n", MAX_THREADS);
+    }
+    return NULL;
+  }
+  ThreadRing *ring = calloc(1, sizeof(ThreadRing));
+  if (ring == NULL)
+    return NULL;
+  my_ring = ring;
+  // Release so the flush path's acquire load sees the zeroed ring
+  atomic_store_explicit(&thread_rings[slot], ring, memory_order_release);
+  if (inline_path_ok)
+    __cache_explorer_inline_ring = ring;
+  return ring;
+}
 
 #define MAX_FILES 4096
 #define MAX_FILENAME 256
 static struct {
   char names[MAX_FILES][MAX_FILENAME];
-  uint32_t count;
-  uint32_t overflow_count;  // Track how many files couldn't be registered
-  pthread_mutex_t mutex;
-} file_table = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+  atomic_uint_fast32_t count;         // ids handed out so far
+  atomic_uchar ready[MAX_FILES];      // set once names[id] is fully copied
+  atomic_uint_fast32_t overflow_count;  // files that couldn't be registered
+} file_table;
 static int file_overflow_warned = 0;
 
+_Static_assert(CACHE_SHM_NAME_MAX == MAX_FILENAME,
+               "shm file entries hold one file_table name");
+_Static_assert(CACHE_SHM_MAX_FILES == MAX_FILES,
+               "shm file region mirrors the whole id table");
+
+// Lock-free interning: an open-addressing table maps a filename to its id
+// with CAS-claimed slots, and a thread-local pointer cache short-circuits
+// repeat lookups (the LLVM pass emits stable string pointers, so the same
+// call site always passes the same pointer). 4x MAX_FILES entries keeps
+// the probe chains short even with the table fully populated.
+#define INTERN_TABLE_SIZE (MAX_FILES * 4)
+#define INTERN_TABLE_MASK (INTERN_TABLE_SIZE - 1)
+
+typedef struct {
+  _Atomic(const char *) name;   // claimant's string, NULL = empty slot
+  atomic_uint_fast32_t id;      // id + 1, 0 = claimed but not yet published
+} InternSlot;
+
+static InternSlot intern_table[INTERN_TABLE_SIZE];
+
+#define PTR_CACHE_SIZE 64
+static _Thread_local struct {
+  const char *ptr;
+  uint32_t id;
+} intern_cache[PTR_CACHE_SIZE];
+
+static uint32_t hash_filename(const char *s) {
+  uint32_t h = 2166136261u;  // FNV-1a
+  while (*s) {
+    h ^= (unsigned char)*s++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
 static int output_fd = -1;
 static int text_mode = 1;
+// Delta/varint compact events within the binary stream
+// (CACHE_EXPLORER_COMPACT=1) - see emit_binary_event
+static int compact_mode = 0;
 static atomic_int initialized = 0;
 
+// Capture-order timestamps (CACHE_EXPLORER_TIMESTAMPS=1): each event is
+// stamped with the cycle counter at emit time, and text records carry an
+// "@<cycles>" suffix so the simulator can merge the per-thread drain
+// bursts back into true interleaving for the coherence analysis.
+static int timestamps_on = 0;
+
+static inline uint64_t read_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+  uint64_t v;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
 // Sampling: only emit every Nth event (1 = no sampling, 100 = 1% of events)
 static uint32_t sample_rate = 1;
 static _Thread_local uint32_t sample_counter = 0;
 
+// Heap tracking (CACHE_EXPLORER_TRACK_HEAP=1): emit H/F records from the
+// malloc interposition at the bottom of this file
+static int track_heap = 0;
+
+// Compressibility sampling (CACHE_EXPLORER_COMPRESS_HINTS=1): classify a
+// subset of stores' target lines BDI-style and emit Y records for the
+// simulator's compressed-L3 model
+static int compress_hints = 0;
+static _Thread_local uint32_t compress_tick = 0;
+
+// Region-of-interest gate (__cache_explorer_start/stop/pause/resume):
+// one relaxed load on the emit path. CACHE_EXPLORER_ROI=1 starts with
+// emission off so only marked regions are traced.
+static atomic_int emission_on = 1;
+static atomic_uint phase_counter = 0;
+
 // Event limit: stop after this many events (0 = no limit)
 static uint64_t max_events = 0;
 static atomic_uint_fast64_t total_events = 0;
 
+// Fold per-thread counts into total_events in batches so the shared
+// counter's cache line isn't contended on every access. The event limit
+// and progress points become approximate to within one batch per thread;
+// each thread's remainder is folded whenever it flushes.
+#define COUNT_BATCH 256
+static _Thread_local uint32_t local_event_count = 0;
+
 // Progress reporting to stderr (for server/UI progress bar)
 static uint64_t progress_interval = 0;
 static atomic_uint_fast64_t progress_next = 0;
 
-static uint32_t intern_filename(const char *file) {
-  pthread_mutex_lock(&file_table.mutex);
+// Register a filename in the id table, claiming its intern slot via CAS.
+// The claimant copies the name into file_table before publishing the id;
+// losers (same content, possibly a different pointer) spin briefly until
+// the id appears, so any id a producer ever sees has a complete name.
+static uint32_t intern_filename_slow(const char *file) {
+  uint32_t h = hash_filename(file) & INTERN_TABLE_MASK;
+
+  for (uint32_t probes = 0; probes < INTERN_TABLE_SIZE; probes++) {
+    const char *cur = atomic_load_explicit(&intern_table[h].name,
+                                           memory_order_acquire);
+    if (cur == NULL) {
+      const char *expected = NULL;
+      if (atomic_compare_exchange_strong(&intern_table[h].name, &expected,
+                                         file)) {
+        // We own the slot: allocate an id, copy the name, then publish
+        uint32_t idx = atomic_fetch_add(&file_table.count, 1);
+        if (idx >= MAX_FILES) {
+          atomic_fetch_add(&file_table.overflow_count, 1);
+          if (!file_overflow_warned) {
+            file_overflow_warned = 1;
+            fprintf(stderr, "[cache-explorer] WARNING: File table overflow (>%d unique files). "
+                    "Additional files will be attributed to first file. "
+                    "Consider using fewer source files or merging headers.\n", MAX_FILES);
+          }
+          atomic_store_explicit(&intern_table[h].id, 1, memory_order_release);
+          return 0;  // Attribute to first file when overflow
+        }
+        strncpy(file_table.names[idx], file, MAX_FILENAME - 1);
+        file_table.names[idx][MAX_FILENAME - 1] = '\0';
+        atomic_store_explicit(&file_table.ready[idx], 1, memory_order_release);
+        if (shm_mode) {
+          // Mirror the registration into the segment before the id can
+          // appear in any event: this thread emits only after intern
+          // returns, and other threads acquire the id through the intern
+          // table, so the consumer's acquire on a ring head sees ready
+          CacheShmFile *entry = shm_file_entry(idx);
+          memcpy(entry->name, file_table.names[idx], MAX_FILENAME);
+          __atomic_store_n(&entry->ready, 1, __ATOMIC_RELEASE);
+        }
+        atomic_store_explicit(&intern_table[h].id, idx + 1,
+                              memory_order_release);
+        return idx;
+      }
+      cur = expected;  // CAS failed - expected now holds the winner's name
+    }
 
-  // Search for existing entry
-  for (uint32_t i = 0; i < file_table.count; i++) {
-    if (strcmp(file_table.names[i], file) == 0) {
-      pthread_mutex_unlock(&file_table.mutex);
-      return i;
+    if (cur == file || strcmp(cur, file) == 0) {
+      // Slot claimed by this name - wait for the claimant to publish the id
+      uint64_t id;
+      while ((id = atomic_load_explicit(&intern_table[h].id,
+                                        memory_order_acquire)) == 0)
+        ;
+      return (uint32_t)(id - 1);
     }
+
+    h = (h + 1) & INTERN_TABLE_MASK;  // Collision - linear probe
   }
 
-  // Add new entry if space available
-  if (file_table.count < MAX_FILES) {
-    uint32_t idx = file_table.count++;
-    strncpy(file_table.names[idx], file, MAX_FILENAME - 1);
-    file_table.names[idx][MAX_FILENAME - 1] = '\0';  // Ensure null termination
-    pthread_mutex_unlock(&file_table.mutex);
-    return idx;
+  return 0;  // Table full (can't happen: 4x as many slots as MAX_FILES ids)
+}
+
+static inline uint32_t intern_filename(const char *file) {
+  // Per-call-site fast path: the pass passes the same pointer every time,
+  // so a tiny thread-local direct-mapped cache absorbs nearly all lookups
+  uint32_t slot = (uint32_t)((uintptr_t)file >> 4) & (PTR_CACHE_SIZE - 1);
+  if (intern_cache[slot].ptr == file)
+    return intern_cache[slot].id;
+  uint32_t id = intern_filename_slow(file);
+  intern_cache[slot].ptr = file;
+  intern_cache[slot].id = id;
+  return id;
+}
+
+// One-time per call site: resolve a filename to its interned id so the
+// inline fast path can pack (id << 20) | line without calling into the
+// runtime per event
+uint32_t __cache_explorer_site_id(const char *file) {
+  return intern_filename(file);
+}
+
+// Function-attribution sites: each instrumented source line maps to its
+// enclosing pre-inlining function, registered once at startup by the
+// pass's per-module constructor and emitted as G records at flush so
+// cache-sim can roll per-line stats up to function granularity. Nothing
+// here is on the event path, so a mutex-guarded static table is fine.
+#define MAX_FUNC_SITES 65536
+static struct {
+  struct {
+    uint32_t file_id;
+    uint32_t line;
+    const char *func; // global string in the instrumented binary
+  } sites[MAX_FUNC_SITES];
+  atomic_uint_fast32_t count;
+  atomic_uint_fast32_t overflow_count;
+} func_table;
+static pthread_mutex_t func_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void __cache_explorer_site_func(const char *file, uint32_t line,
+                                const char *func) {
+  // Registration constructors can run before our own init; initialize
+  // first so init's table reset cannot orphan ids interned here
+  if (!atomic_load_explicit(&initialized, memory_order_relaxed))
+    __cache_explorer_init();
+
+  uint32_t file_id = intern_filename(file);
+  pthread_mutex_lock(&func_table_mutex);
+  uint32_t idx = (uint32_t)atomic_load_explicit(&func_table.count,
+                                                memory_order_relaxed);
+  if (idx >= MAX_FUNC_SITES) {
+    atomic_fetch_add(&func_table.overflow_count, 1);
+    pthread_mutex_unlock(&func_table_mutex);
+    return;
+  }
+  func_table.sites[idx].file_id = file_id;
+  func_table.sites[idx].line = line;
+  func_table.sites[idx].func = func;
+  // Release so the flush path's acquire load sees a fully written entry
+  atomic_store_explicit(&func_table.count, idx + 1, memory_order_release);
+  pthread_mutex_unlock(&func_table_mutex);
+}
+
+// --- Memory-region map (stack / globals) -----------------------------------
+//
+// Classifying an address as stack, global or heap traffic changes which
+// optimization applies (spills from register pressure vs pointer
+// chasing), so the runtime records the regions it can see - each
+// thread's stack range and the module's writable PT_LOAD segments
+// (.data/.bss) - and emits them as K records ("K <kind> <lo> <hi>") at
+// flush, before any event that could reference them. Heap ranges need no
+// records of their own: the malloc interposition's H/F records already
+// carry every allocation. Registration runs at init and thread startup,
+// never on the event path.
+#define MAX_REGIONS 64
+static struct {
+  struct {
+    const char *kind; // static string: "stack" or "data"
+    uint64_t lo, hi;
+  } entries[MAX_REGIONS];
+  atomic_uint_fast32_t count;
+} region_table;
+static pthread_mutex_t region_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void region_register(const char *kind, uint64_t lo, uint64_t hi) {
+  if (hi <= lo)
+    return;
+  pthread_mutex_lock(&region_table_mutex);
+  uint32_t idx = (uint32_t)atomic_load_explicit(&region_table.count,
+                                                memory_order_relaxed);
+  if (idx >= MAX_REGIONS) {
+    pthread_mutex_unlock(&region_table_mutex);
+    return;
   }
+  region_table.entries[idx].kind = kind;
+  region_table.entries[idx].lo = lo;
+  region_table.entries[idx].hi = hi;
+  // Release so the flush path's acquire load sees a fully written entry
+  atomic_store_explicit(&region_table.count, idx + 1, memory_order_release);
+  pthread_mutex_unlock(&region_table_mutex);
+}
 
-  // File table overflow - track and warn
-  file_table.overflow_count++;
-  if (!file_overflow_warned) {
-    file_overflow_warned = 1;
-    fprintf(stderr, "[cache-explorer] WARNING: File table overflow (>%d unique files). "
-            "Additional files will be attributed to first file. "
-            "Consider using fewer source files or merging headers.\n", MAX_FILES);
+// The calling thread's stack range, queried from the pthread runtime.
+// Called once per thread when its ring is registered - stacks of threads
+// that never emit an event never make it into the map, which is fine:
+// no event will land in them either.
+static void region_register_thread_stack(void) {
+#if defined(__GLIBC__)
+  pthread_attr_t attr;
+  if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+    void *base;
+    size_t size;
+    if (pthread_attr_getstack(&attr, &base, &size) == 0)
+      region_register("stack", (uint64_t)base, (uint64_t)base + size);
+    pthread_attr_destroy(&attr);
   }
-  pthread_mutex_unlock(&file_table.mutex);
-  return 0;  // Attribute to first file when overflow
+#elif defined(__APPLE__)
+  uint64_t top = (uint64_t)pthread_get_stackaddr_np(pthread_self());
+  uint64_t size = (uint64_t)pthread_get_stacksize_np(pthread_self());
+  region_register("stack", top - size, top);
+#endif
+}
+
+#if defined(__linux__)
+static int region_phdr_cb(struct dl_phdr_info *info, size_t size, void *data) {
+  (void)size;
+  (void)data;
+  // Main executable only (empty name): shared-library data segments would
+  // swamp the map with allocator and libc internals
+  if (info->dlpi_name && info->dlpi_name[0] != '\0')
+    return 0;
+  for (int i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+    // Writable PT_LOAD covers .data and .bss (p_memsz includes the
+    // zero-fill tail past p_filesz)
+    if (ph->p_type == PT_LOAD && (ph->p_flags & PF_W)) {
+      uint64_t lo = info->dlpi_addr + ph->p_vaddr;
+      region_register("data", lo, lo + ph->p_memsz);
+    }
+  }
+  return 0;
+}
+#endif
+
+static void region_register_module_data(void) {
+#if defined(__linux__)
+  dl_iterate_phdr(region_phdr_cb, NULL);
+#endif
+}
+
+// --- Data-value compressibility sampling (CACHE_EXPLORER_COMPRESS_HINTS=1) -
+//
+// The simulator's compressed-L3 what-if model (cache-sim --compress-l3)
+// needs to know how compressible the program's data actually is. Every
+// Nth store, the target's cache line is read back and classified into a
+// BDI class - all zeros, one repeated 8-byte value, narrow deltas from a
+// base, or incompressible - and the (line, class) pair lands in a small
+// table emitted as Y records at flush. Reading the line is safe: a
+// 64-byte-aligned line never crosses the page the store just proved
+// writable. Sampling is sparse enough that the table mutex stays cold.
+#define MAX_COMPRESS_HINTS 1024
+#define COMPRESS_SAMPLE_MASK 0xFF  // Classify every 256th store per thread
+static struct {
+  struct {
+    uint64_t line;
+    uint32_t cls;
+  } entries[MAX_COMPRESS_HINTS];
+  atomic_uint_fast32_t count;
+} compress_table;
+static pthread_mutex_t compress_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void compress_sample(const void *addr) {
+  uint64_t line = (uint64_t)(uintptr_t)addr & ~63ULL;
+  uint64_t w[8];
+  memcpy(w, (const void *)(uintptr_t)line, sizeof(w));
+
+  // BDI classes, most to least compressible (values mirror the
+  // simulator's BDI_* constants in CompressedCacheModel.hpp)
+  uint32_t cls;
+  int zeros = 1, repeated = 1, narrow = 1;
+  for (int i = 0; i < 8; i++) {
+    if (w[i] != 0)
+      zeros = 0;
+    if (w[i] != w[0])
+      repeated = 0;
+    int64_t delta = (int64_t)(w[i] - w[0]);
+    if (delta < INT16_MIN || delta > INT16_MAX)
+      narrow = 0;
+  }
+  cls = zeros ? 0 : repeated ? 1 : narrow ? 2 : 3;
+
+  pthread_mutex_lock(&compress_table_mutex);
+  uint32_t idx = (uint32_t)atomic_load_explicit(&compress_table.count,
+                                                memory_order_relaxed);
+  if (idx >= MAX_COMPRESS_HINTS) {
+    pthread_mutex_unlock(&compress_table_mutex);
+    return;
+  }
+  compress_table.entries[idx].line = line;
+  compress_table.entries[idx].cls = cls;
+  // Release so the flush path's acquire load sees a fully written entry
+  atomic_store_explicit(&compress_table.count, idx + 1, memory_order_release);
+  pthread_mutex_unlock(&compress_table_mutex);
 }
 
 static void emit_runtime_progress(uint64_t count) {
@@ -93,6 +667,19 @@ static void emit_runtime_progress(uint64_t count) {
   if (len > 0) write(STDERR_FILENO, buf, len);
 }
 
+// Progress reporting (~1% intervals); safe to call from any thread
+static void maybe_report_progress(void) {
+  if (progress_interval == 0)
+    return;
+  uint64_t count = atomic_load_explicit(&total_events, memory_order_relaxed);
+  uint64_t expected = atomic_load(&progress_next);
+  if (count >= expected &&
+      atomic_compare_exchange_strong(&progress_next, &expected,
+                                     expected + progress_interval)) {
+    emit_runtime_progress(count);
+  }
+}
+
 static inline void emit_event_with_src(uint64_t addr_with_flag, uint64_t src_addr,
                                         uint32_t size, const char *file, uint32_t line) {
   // Lazy initialization: handles runtimes where .init_array constructors
@@ -101,57 +688,97 @@ static inline void emit_event_with_src(uint64_t addr_with_flag, uint64_t src_add
     __cache_explorer_init();
   }
 
-  // Sampling: skip events based on sample rate
-  if (sample_rate > 1) {
+  // Region-of-interest gate: phase markers always pass so begin/end
+  // pairs survive in the trace even when emission is off
+  if (__builtin_expect(!atomic_load_explicit(&emission_on, memory_order_relaxed), 0) &&
+      !(addr_with_flag & EVENT_PHASE_FLAG)) {
+    return;
+  }
+
+  // Sampling: skip events based on sample rate (markers exempt - dropping
+  // one would unbalance its region). Under adaptive sampling the divisor
+  // is whatever the flush thread last published.
+  uint32_t rate = adaptive_sampling
+      ? atomic_load_explicit(&adaptive_divisor, memory_order_relaxed)
+      : sample_rate;
+  if (rate > 1 && !(addr_with_flag & EVENT_PHASE_FLAG)) {
     sample_counter++;
-    if (sample_counter < sample_rate) {
+    if (sample_counter < rate) {
       return;  // Skip this event
     }
     sample_counter = 0;  // Reset counter, emit this one
   }
 
-  // Always count events for progress reporting
-  uint64_t count = atomic_fetch_add(&total_events, 1);
-
-  // Event limit: stop emitting after max_events
-  if (max_events > 0 && count >= max_events) {
-    return;  // Hit limit, skip remaining events
-  }
-
-  // Progress reporting (~1% intervals)
-  if (__builtin_expect(progress_interval > 0 &&
-      count >= atomic_load_explicit(&progress_next, memory_order_relaxed), 0)) {
-    uint64_t expected = atomic_load(&progress_next);
-    if (count >= expected &&
-        atomic_compare_exchange_strong(&progress_next, &expected, expected + progress_interval)) {
-      emit_runtime_progress(count);
+  // Event limit: counted here (batched - see COUNT_BATCH) so production
+  // can stop. Without a limit, events are instead counted exactly once
+  // as the rings drain - the inline fast path never enters this function,
+  // but everything it produces still passes through drain_ring.
+  if (max_events > 0 && !(addr_with_flag & EVENT_PHASE_FLAG)) {
+    local_event_count++;
+    if (local_event_count >= COUNT_BATCH) {
+      atomic_fetch_add_explicit(&total_events, local_event_count,
+                                memory_order_relaxed);
+      local_event_count = 0;
+    }
+    uint64_t count = atomic_load_explicit(&total_events, memory_order_relaxed);
+    if (count >= max_events) {
+      return;  // Hit limit, skip remaining events
     }
+    maybe_report_progress();
   }
 
-  uint64_t head = atomic_load_explicit(&ring_buffer.head, memory_order_relaxed);
-  uint64_t next = (head + 1) & BUFFER_MASK;
+  ThreadRing *ring = my_ring;
+  if (__builtin_expect(ring == NULL, 0)) {
+    ring = register_thread_ring();
+    if (ring == NULL)
+      return;  // Thread limit exceeded - events dropped (warned once)
+  }
 
-  uint64_t tail = atomic_load_explicit(&ring_buffer.tail, memory_order_acquire);
-  if (next == tail) {
-    // Buffer full - must flush
-    __cache_explorer_flush();
-    head = atomic_load_explicit(&ring_buffer.head, memory_order_relaxed);
-    next = (head + 1) & BUFFER_MASK;
-  } else if ((head & 0xFFF) == 0 && head != tail) {
-    // Periodic flush every 4096 events - ensures output even when
-    // destructors don't fire (e.g., Zig's _start calls _exit directly)
-    __cache_explorer_flush();
+  uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint64_t next = (head + 1) & RING_MASK;
+
+  uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (flusher_started || shm_mode) {
+    if (next == tail) {
+      // Ring full - ask the flusher for an immediate drain and wait a
+      // bounded time for space; under sustained overload, drop and count.
+      // In shm mode the consumer is cache-sim polling continuously, so
+      // the same bounded wait applies (flush_requested is a no-op there)
+      atomic_store_explicit(&flush_requested, 1, memory_order_relaxed);
+      for (int spin = 0; spin < FULL_WAIT_SPINS && next == tail; spin++) {
+        struct timespec ts = {0, FULL_WAIT_NSEC};
+        nanosleep(&ts, NULL);
+        tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+      }
+      if (next == tail) {
+        atomic_fetch_add_explicit(&dropped_events, 1, memory_order_relaxed);
+        return;
+      }
+    }
+  } else {
+    // No flusher thread - producers drain synchronously (old behavior)
+    if (next == tail) {
+      // Ring full - must flush
+      __cache_explorer_flush();
+      head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+      next = (head + 1) & RING_MASK;
+    } else if ((head & 0xFFF) == 0 && head != tail) {
+      // Periodic flush every 4096 events - ensures output even when
+      // destructors don't fire (e.g., Zig's _start calls _exit directly)
+      __cache_explorer_flush();
+    }
   }
 
-  ring_buffer.events[head] = (CacheEvent){
+  ring->events[head] = (CacheEvent){
       .address = addr_with_flag,
       .src_address = src_addr,
       .size = size,
       .line = (intern_filename(file) << 20) | (line & 0xFFFFF),
       .thread_id = get_thread_id(),
+      .tsc = timestamps_on ? (uint32_t)read_cycles() : 0,
   };
 
-  atomic_store_explicit(&ring_buffer.head, next, memory_order_release);
+  atomic_store_explicit(&ring->head, next, memory_order_release);
 }
 
 static inline void emit_event(uint64_t addr_with_flag, uint32_t size,
@@ -164,14 +791,53 @@ void __tag_mem_load(void *addr, uint32_t size, const char *file, uint32_t line)
 }
 
 void __tag_mem_store(void *addr, uint32_t size, const char *file, uint32_t line) {
+  if (compress_hints && ((++compress_tick & COMPRESS_SAMPLE_MASK) == 0))
+    compress_sample(addr);
   emit_event((uint64_t)addr | EVENT_STORE_FLAG, size, file, line);
 }
 
 void __tag_bb_entry(uint64_t bb_id, uint32_t instr_count, const char *file, uint32_t line) {
   // Estimate instruction fetch size: instr_count * 4 bytes (average instruction size)
-  // bb_id is a unique identifier for this basic block
   uint32_t fetch_size = instr_count * 4;
-  emit_event(bb_id | EVENT_ICACHE_FLAG, fetch_size, file, line);
+  // Fetch address: the call into this hook sits at the top of the block,
+  // so the return address is the block's real post-layout address. That
+  // makes the simulated L1I stream reflect the linker's actual code
+  // placement (hot/cold splitting, section ordering) instead of the
+  // meaningless dense bb_id space the pass assigns at IR time.
+#if defined(__GNUC__) || defined(__clang__)
+  uint64_t fetch_addr = (uint64_t)__builtin_return_address(0);
+  (void)bb_id;
+#else
+  // No return-address intrinsic: spread blocks a cache line apart so they
+  // at least don't all alias to one set
+  uint64_t fetch_addr = bb_id << 6;
+#endif
+  emit_event(fetch_addr | EVENT_ICACHE_FLAG, fetch_size, file, line);
+}
+
+// Region-of-interest markers: start opens a numbered phase and turns
+// emission on; stop emits the matching end marker and turns it off.
+// pause/resume toggle emission without touching the phase markers, so a
+// region can skip over uninteresting stretches without splitting.
+void __cache_explorer_start(void) {
+  uint32_t id = atomic_fetch_add_explicit(&phase_counter, 1,
+                                          memory_order_relaxed) + 1;
+  atomic_store_explicit(&emission_on, 1, memory_order_relaxed);
+  emit_event((uint64_t)id | EVENT_PHASE_FLAG, 0, "?", 0);
+}
+
+void __cache_explorer_stop(void) {
+  uint32_t id = atomic_load_explicit(&phase_counter, memory_order_relaxed);
+  emit_event((uint64_t)id | EVENT_PHASE_FLAG | EVENT_STORE_FLAG, 0, "?", 0);
+  atomic_store_explicit(&emission_on, 0, memory_order_relaxed);
+}
+
+void __cache_explorer_pause(void) {
+  atomic_store_explicit(&emission_on, 0, memory_order_relaxed);
+}
+
+void __cache_explorer_resume(void) {
+  atomic_store_explicit(&emission_on, 1, memory_order_relaxed);
 }
 
 // Software prefetch hints (__builtin_prefetch)
@@ -190,6 +856,24 @@ void __tag_vector_store(void *addr, uint32_t size, const char *file, uint32_t li
   emit_event((uint64_t)addr | EVENT_VECTOR_FLAG | EVENT_STORE_FLAG, size, file, line);
 }
 
+// Gather/scatter lanes: one ring slot per active lane, each with the
+// lane's own address. The lane index and lane count share src_address
+// (low/high 32 bits) so the record stays inside the fixed 32 bytes.
+void __tag_gather_lane(void *addr, uint32_t size, uint32_t lane,
+                       uint32_t lanes, const char *file, uint32_t line) {
+  uint64_t packed = ((uint64_t)lanes << 32) | lane;
+  emit_event_with_src((uint64_t)addr | EVENT_VECTOR_FLAG | EVENT_GATHER_FLAG,
+                      packed, size, file, line);
+}
+
+void __tag_scatter_lane(void *addr, uint32_t size, uint32_t lane,
+                        uint32_t lanes, const char *file, uint32_t line) {
+  uint64_t packed = ((uint64_t)lanes << 32) | lane;
+  emit_event_with_src((uint64_t)addr | EVENT_VECTOR_FLAG | EVENT_GATHER_FLAG |
+                          EVENT_STORE_FLAG,
+                      packed, size, file, line);
+}
+
 // Atomic operations
 void __tag_atomic_load(void *addr, uint32_t size, const char *file, uint32_t line) {
   emit_event((uint64_t)addr | EVENT_ATOMIC_FLAG, size, file, line);
@@ -207,6 +891,22 @@ void __tag_atomic_cmpxchg(void *addr, uint32_t size, const char *file, uint32_t
   emit_event((uint64_t)addr | EVENT_ATOMIC_FLAG | EVENT_ATOMIC_CMPXCHG, size, file, line);
 }
 
+// Compressed range events: one ring slot stands for `count` strided
+// accesses. stride and count share src_address (low/high 32 bits), so a
+// range still fits the fixed 32-byte CacheEvent.
+void __tag_range_load(void *base, int64_t stride, uint64_t count,
+                      uint32_t size, const char *file, uint32_t line) {
+  uint64_t packed = ((count & 0xFFFFFFFFULL) << 32) | (uint32_t)(int32_t)stride;
+  emit_event_with_src((uint64_t)base | EVENT_RANGE_FLAG, packed, size, file, line);
+}
+
+void __tag_range_store(void *base, int64_t stride, uint64_t count,
+                       uint32_t size, const char *file, uint32_t line) {
+  uint64_t packed = ((count & 0xFFFFFFFFULL) << 32) | (uint32_t)(int32_t)stride;
+  emit_event_with_src((uint64_t)base | EVENT_RANGE_FLAG | EVENT_STORE_FLAG,
+                      packed, size, file, line);
+}
+
 // Memory intrinsics
 void __tag_memcpy(void *dest, void *src, uint32_t size, const char *file, uint32_t line) {
   emit_event_with_src((uint64_t)dest | EVENT_MEMINTR_FLAG, (uint64_t)src, size, file, line);
@@ -220,20 +920,60 @@ void __tag_memmove(void *dest, void *src, uint32_t size, const char *file, uint3
   emit_event_with_src((uint64_t)dest | EVENT_MEMINTR_FLAG | EVENT_MEMMOVE_TYPE, (uint64_t)src, size, file, line);
 }
 
+static int zstd_open(int level);  // defined with the write buffer below
+
 void __cache_explorer_init(void) {
   if (atomic_exchange(&initialized, 1))
     return;
 
-  atomic_store(&ring_buffer.head, 0);
-  atomic_store(&ring_buffer.tail, 0);
   atomic_store(&total_events, 0);
-  file_table.count = 0;
+  atomic_store(&file_table.count, 0);
+  atomic_store(&func_table.count, 0);
+  atomic_store(&region_table.count, 0);
+  atomic_store(&compress_table.count, 0);
+
+  // Record the module's .data/.bss ranges; each thread's stack follows
+  // when its ring is registered
+  region_register_module_data();
 
   const char *out = getenv("CACHE_EXPLORER_OUTPUT");
   if (out) {
     __cache_explorer_set_output(out);
   }
 
+  // Shared-memory transport: export the rings in a mapped segment and
+  // let cache-sim --shm consume events in place. Falls back to the
+  // normal output path with a warning if the segment can't be created.
+  const char *shm_path = getenv("CACHE_EXPLORER_SHM");
+  if (shm_path) {
+    if (shm_open_segment(shm_path)) {
+      shm_mode = 1;
+    } else {
+      fprintf(stderr, "[cache-explorer] WARNING: could not create shm "
+              "segment at %s - falling back to pipe output\n", shm_path);
+    }
+  }
+
+  // Force binary trace output even on stdout (for piping into cache-sim --binary)
+  const char *binary = getenv("CACHE_EXPLORER_BINARY");
+  if (binary && atoi(binary) != 0) {
+    text_mode = 0;
+  }
+
+  // Delta-encode plain loads/stores inside the binary stream (~3-4
+  // bytes/event versus the fixed 28-byte records)
+  const char *compact = getenv("CACHE_EXPLORER_COMPACT");
+  if (compact && atoi(compact) != 0) {
+    text_mode = 0; // compact is a binary-stream variant
+    compact_mode = 1;
+  }
+
+  // Stamp each event with the capture-time cycle counter
+  const char *timestamps = getenv("CACHE_EXPLORER_TIMESTAMPS");
+  if (timestamps && atoi(timestamps) != 0) {
+    timestamps_on = 1;
+  }
+
   // Sample rate: emit 1 in N events (1 = all, 100 = 1%, 1000 = 0.1%)
   const char *rate = getenv("CACHE_EXPLORER_SAMPLE_RATE");
   if (rate) {
@@ -247,6 +987,39 @@ void __cache_explorer_init(void) {
     max_events = (uint64_t)atoll(limit);
   }
 
+  // Heap object attribution: interpose malloc/free and emit H/F records
+  const char *heap = getenv("CACHE_EXPLORER_TRACK_HEAP");
+  if (heap && atoi(heap) != 0) {
+    track_heap = 1;
+  }
+
+  // Data-value compressibility sampling for the compressed-L3 model
+  const char *comp = getenv("CACHE_EXPLORER_COMPRESS_HINTS");
+  if (comp && atoi(comp) != 0) {
+    compress_hints = 1;
+  }
+
+  // Region-of-interest mode: begin with emission off and let the
+  // __cache_explorer_start/stop markers open the traced regions
+  const char *roi = getenv("CACHE_EXPLORER_ROI");
+  int roi_mode = roi && atoi(roi) != 0;
+  if (roi_mode) {
+    atomic_store_explicit(&emission_on, 0, memory_order_relaxed);
+  }
+
+  // Compressed output: 1 enables zstd at the default level, values > 1
+  // select the compression level directly
+  const char *compress = getenv("CACHE_EXPLORER_COMPRESS");
+  if (compress && atoi(compress) != 0) {
+    int level = atoi(compress);
+    if (level <= 1)
+      level = 3;  // zstd's own default
+    if (!zstd_open(level)) {
+      fprintf(stderr, "[cache-explorer] WARNING: CACHE_EXPLORER_COMPRESS set "
+              "but libzstd could not be loaded - writing uncompressed trace\n");
+    }
+  }
+
   // Set up progress reporting interval
   if (max_events >= 100) {
     progress_interval = max_events / 100;
@@ -256,6 +1029,57 @@ void __cache_explorer_init(void) {
   atomic_store(&progress_next, progress_interval);
   // Emit initial progress
   emit_runtime_progress(0);
+
+  // Start the flush thread unless synchronous flushing was requested
+  // (CACHE_EXPLORER_SYNC_FLUSH=1 restores the stall-never-drop behavior).
+  // In shm mode cache-sim is the consumer, so no flusher runs at all.
+  const char *sync_flush = getenv("CACHE_EXPLORER_SYNC_FLUSH");
+  if (!shm_mode && !(sync_flush && atoi(sync_flush) != 0)) {
+    atomic_store(&flusher_run, 1);
+    if (pthread_create(&flusher_thread, NULL, flusher_main, NULL) == 0) {
+      flusher_started = 1;
+    } else {
+      atomic_store(&flusher_run, 0);
+    }
+  }
+
+  // Adaptive sampling: hand the divisor to the flush thread, bounded by
+  // the static rate below and CACHE_EXPLORER_ADAPTIVE_MAX above, aiming
+  // at CACHE_EXPLORER_ADAPTIVE_TARGET captured events/sec. Needs the
+  // flusher (the controller runs there) and text output (the W records
+  // it announces changes with have no binary form).
+  const char *adaptive = getenv("CACHE_EXPLORER_ADAPTIVE");
+  if (adaptive && atoi(adaptive) != 0) {
+    if (flusher_started && text_mode) {
+      adaptive_sampling = 1;
+      adaptive_min = sample_rate;
+      const char *amax = getenv("CACHE_EXPLORER_ADAPTIVE_MAX");
+      if (amax && atoi(amax) > 0) {
+        adaptive_max = (uint32_t)atoi(amax);
+      }
+      if (adaptive_max < adaptive_min) {
+        adaptive_max = adaptive_min;
+      }
+      const char *target = getenv("CACHE_EXPLORER_ADAPTIVE_TARGET");
+      if (target && atoll(target) > 0) {
+        adaptive_target = (uint64_t)atoll(target);
+      }
+      atomic_store_explicit(&adaptive_divisor, adaptive_min,
+                            memory_order_relaxed);
+    } else {
+      fprintf(stderr, "[cache-explorer] WARNING: CACHE_EXPLORER_ADAPTIVE "
+              "needs the flush thread and text output - ignored\n");
+    }
+  }
+
+  // Publish the inline fast path only when every event may bypass
+  // emit_event: sampling (static or adaptive), event limits, the ROI
+  // gate, and timestamping must see each event, and the flusher thread
+  // must exist to drain inline-filled rings
+  const char *no_inline = getenv("CACHE_EXPLORER_NO_INLINE");
+  inline_path_ok = (flusher_started || shm_mode) && sample_rate == 1 &&
+                   !adaptive_sampling && max_events == 0 && !roi_mode &&
+                   !timestamps_on && !(no_inline && atoi(no_inline) != 0);
 }
 
 void __cache_explorer_set_output(const char *path) {
@@ -276,18 +1100,100 @@ void __cache_explorer_set_output(const char *path) {
 static char write_buf[WRITE_BUF_SIZE];
 static int write_buf_pos = 0;
 
+static void wb_write(const char *p, int remaining) {
+  while (remaining > 0) {
+    ssize_t n = write(output_fd, p, remaining);
+    if (n <= 0) break;
+    p += n;
+    remaining -= (int)n;
+  }
+}
+
+// --- zstd streaming compression (CACHE_EXPLORER_COMPRESS=1) ---------------
+//
+// Traces are highly compressible text; compressing in the output path cuts
+// disk usage and pipe pressure by an order of magnitude. The runtime is
+// linked into arbitrary user programs, so libzstd is loaded with dlopen
+// rather than adding a link-time dependency to every instrumented binary -
+// only the stable streaming ABI below is used. If the library is missing,
+// the trace falls back to uncompressed output with a one-time warning.
+// cache-sim detects the zstd frame magic and inflates transparently.
+
+typedef struct { const void *src; size_t size; size_t pos; } zstd_in_buf;
+typedef struct { void *dst; size_t size; size_t pos; } zstd_out_buf;
+
+static void *(*zstd_create_cstream)(void);
+static size_t (*zstd_init_cstream)(void *stream, int level);
+static size_t (*zstd_compress_stream)(void *stream, zstd_out_buf *out,
+                                      zstd_in_buf *in);
+static size_t (*zstd_end_stream)(void *stream, zstd_out_buf *out);
+static unsigned (*zstd_is_error)(size_t code);
+
+static void *zstd_cstream = NULL;
+// Large enough for the worst-case expansion of one write buffer plus
+// stream framing, so one compress call per chunk never truncates
+static char zstd_out[WRITE_BUF_SIZE + (WRITE_BUF_SIZE >> 7) + 1024];
+
+static int zstd_open(int level) {
+  void *h = dlopen("libzstd.so.1", RTLD_NOW | RTLD_LOCAL);
+  if (!h)
+    h = dlopen("libzstd.so", RTLD_NOW | RTLD_LOCAL);
+  if (!h)
+    return 0;
+
+  zstd_create_cstream = (void *(*)(void))dlsym(h, "ZSTD_createCStream");
+  zstd_init_cstream = (size_t (*)(void *, int))dlsym(h, "ZSTD_initCStream");
+  zstd_compress_stream = (size_t (*)(void *, zstd_out_buf *, zstd_in_buf *))
+      dlsym(h, "ZSTD_compressStream");
+  zstd_end_stream =
+      (size_t (*)(void *, zstd_out_buf *))dlsym(h, "ZSTD_endStream");
+  zstd_is_error = (unsigned (*)(size_t))dlsym(h, "ZSTD_isError");
+  if (!zstd_create_cstream || !zstd_init_cstream || !zstd_compress_stream ||
+      !zstd_end_stream || !zstd_is_error)
+    return 0;
+
+  zstd_cstream = zstd_create_cstream();
+  if (!zstd_cstream)
+    return 0;
+  if (zstd_is_error(zstd_init_cstream(zstd_cstream, level))) {
+    zstd_cstream = NULL;
+    return 0;
+  }
+  return 1;
+}
+
+// Finish the frame at shutdown - repeated until zstd reports 0 bytes left
+static void zstd_close(void) {
+  if (!zstd_cstream)
+    return;
+  size_t left;
+  do {
+    zstd_out_buf out = {zstd_out, sizeof(zstd_out), 0};
+    left = zstd_end_stream(zstd_cstream, &out);
+    if (zstd_is_error(left))
+      break;
+    if (out.pos > 0)
+      wb_write(zstd_out, (int)out.pos);
+  } while (left != 0);
+  zstd_cstream = NULL;
+}
+
 static inline void wb_flush(void) {
-  if (write_buf_pos > 0) {
-    const char *p = write_buf;
-    int remaining = write_buf_pos;
-    while (remaining > 0) {
-      ssize_t n = write(output_fd, p, remaining);
-      if (n <= 0) break;
-      p += n;
-      remaining -= n;
+  if (write_buf_pos <= 0)
+    return;
+  if (zstd_cstream) {
+    zstd_in_buf in = {write_buf, (size_t)write_buf_pos, 0};
+    while (in.pos < in.size) {
+      zstd_out_buf out = {zstd_out, sizeof(zstd_out), 0};
+      if (zstd_is_error(zstd_compress_stream(zstd_cstream, &out, &in)))
+        break;
+      if (out.pos > 0)
+        wb_write(zstd_out, (int)out.pos);
     }
-    write_buf_pos = 0;
+  } else {
+    wb_write(write_buf, write_buf_pos);
   }
+  write_buf_pos = 0;
 }
 
 // Fast hex formatting: write "0x" + hex digits for a 64-bit value
@@ -327,10 +1233,45 @@ static inline int fmt_dec(char *buf, uint32_t val) {
   return len;
 }
 
-// Format one event into write buffer, flushing if needed
+// Fast decimal formatting for uint64_t (timestamps)
+static inline int fmt_dec64(char *buf, uint64_t val) {
+  if (val == 0) {
+    buf[0] = '0';
+    return 1;
+  }
+  char tmp[20];
+  int len = 0;
+  while (val > 0) {
+    tmp[len++] = '0' + (val % 10);
+    val /= 10;
+  }
+  for (int i = 0; i < len; i++) {
+    buf[i] = tmp[len - 1 - i];
+  }
+  return len;
+}
+
+// Capture timestamp of the record being formatted; every fmt_* helper
+// appends it as " @<cycles>" in timestamp mode. The drain path is
+// serialized by flush_mutex, so one pending value suffices.
+static uint64_t pending_ts = 0;
+
+static inline char *fmt_ts_suffix(char *p) {
+  if (!timestamps_on)
+    return p;
+  *p++ = ' ';
+  *p++ = '@';
+  p += fmt_dec64(p, pending_ts);
+  return p;
+}
+
+// Format one event into write buffer, flushing if needed. Locations are
+// written as "<file_id>:<line>" - the id was bound to its path by an
+// earlier "D <id> <path>" registration record (emit_text_file_records),
+// so deep source paths cost their bytes once per trace, not per event.
 static inline void fmt_event(char type, uint64_t addr, uint32_t size,
-                             const char *file, uint32_t line, uint32_t tid) {
-  // Max line: "X 0x1234567890abcdef 12345 somefile.c:99999 T99\n" ~80 chars
+                             uint32_t file_id, uint32_t line, uint32_t tid) {
+  // Max line: "X 0x1234567890abcdef 12345 4095:99999 T99\n" ~48 chars
   if (write_buf_pos + 128 > WRITE_BUF_SIZE)
     wb_flush();
   char *p = write_buf + write_buf_pos;
@@ -340,20 +1281,21 @@ static inline void fmt_event(char type, uint64_t addr, uint32_t size,
   *p++ = ' ';
   p += fmt_dec(p, size);
   *p++ = ' ';
-  while (*file) *p++ = *file++;
+  p += fmt_dec(p, file_id);
   *p++ = ':';
   p += fmt_dec(p, line);
   *p++ = ' ';
   *p++ = 'T';
   p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
   *p++ = '\n';
   write_buf_pos = (int)(p - write_buf);
 }
 
 // Format event with two addresses (memcpy/memmove)
 static inline void fmt_event_src(char type, uint64_t addr, uint64_t src_addr,
-                                 uint32_t size, const char *file, uint32_t line,
-                                 uint32_t tid) {
+                                 uint32_t size, uint32_t file_id,
+                                 uint32_t line, uint32_t tid) {
   if (write_buf_pos + 160 > WRITE_BUF_SIZE)
     wb_flush();
   char *p = write_buf + write_buf_pos;
@@ -365,19 +1307,83 @@ static inline void fmt_event_src(char type, uint64_t addr, uint64_t src_addr,
   *p++ = ' ';
   p += fmt_dec(p, size);
   *p++ = ' ';
-  while (*file) *p++ = *file++;
+  p += fmt_dec(p, file_id);
+  *p++ = ':';
+  p += fmt_dec(p, line);
+  *p++ = ' ';
+  *p++ = 'T';
+  p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
+  *p++ = '\n';
+  write_buf_pos = (int)(p - write_buf);
+}
+
+// Format a compressed range event: RL/RS base stride count size loc tid
+static inline void fmt_range(int is_store, uint64_t base, int32_t stride,
+                             uint32_t count, uint32_t size, uint32_t file_id,
+                             uint32_t line, uint32_t tid) {
+  if (write_buf_pos + 160 > WRITE_BUF_SIZE)
+    wb_flush();
+  char *p = write_buf + write_buf_pos;
+  *p++ = 'R';
+  *p++ = is_store ? 'S' : 'L';
+  *p++ = ' ';
+  p += fmt_hex(p, base);
+  *p++ = ' ';
+  if (stride < 0) {
+    *p++ = '-';
+    p += fmt_dec(p, (uint32_t)-stride);
+  } else {
+    p += fmt_dec(p, (uint32_t)stride);
+  }
+  *p++ = ' ';
+  p += fmt_dec(p, count);
+  *p++ = ' ';
+  p += fmt_dec(p, size);
+  *p++ = ' ';
+  p += fmt_dec(p, file_id);
+  *p++ = ':';
+  p += fmt_dec(p, line);
+  *p++ = ' ';
+  *p++ = 'T';
+  p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
+  *p++ = '\n';
+  write_buf_pos = (int)(p - write_buf);
+}
+
+// Format a gather/scatter lane: VL/VS addr lane lanes size loc tid
+static inline void fmt_gather(int is_store, uint64_t addr, uint32_t lane,
+                              uint32_t lanes, uint32_t size, uint32_t file_id,
+                              uint32_t line, uint32_t tid) {
+  if (write_buf_pos + 160 > WRITE_BUF_SIZE)
+    wb_flush();
+  char *p = write_buf + write_buf_pos;
+  *p++ = 'V';
+  *p++ = is_store ? 'S' : 'L';
+  *p++ = ' ';
+  p += fmt_hex(p, addr);
+  *p++ = ' ';
+  p += fmt_dec(p, lane);
+  *p++ = ' ';
+  p += fmt_dec(p, lanes);
+  *p++ = ' ';
+  p += fmt_dec(p, size);
+  *p++ = ' ';
+  p += fmt_dec(p, file_id);
   *p++ = ':';
   p += fmt_dec(p, line);
   *p++ = ' ';
   *p++ = 'T';
   p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
   *p++ = '\n';
   write_buf_pos = (int)(p - write_buf);
 }
 
 // Format prefetch with hint level
 static inline void fmt_prefetch(uint8_t hint, uint64_t addr, uint32_t size,
-                                const char *file, uint32_t line, uint32_t tid) {
+                                uint32_t file_id, uint32_t line, uint32_t tid) {
   if (write_buf_pos + 128 > WRITE_BUF_SIZE)
     wb_flush();
   char *p = write_buf + write_buf_pos;
@@ -388,79 +1394,618 @@ static inline void fmt_prefetch(uint8_t hint, uint64_t addr, uint32_t size,
   *p++ = ' ';
   p += fmt_dec(p, size);
   *p++ = ' ';
-  while (*file) *p++ = *file++;
+  p += fmt_dec(p, file_id);
   *p++ = ':';
   p += fmt_dec(p, line);
   *p++ = ' ';
   *p++ = 'T';
   p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
   *p++ = '\n';
   write_buf_pos = (int)(p - write_buf);
 }
 
-void __cache_explorer_flush(void) {
-  if (output_fd < 0)
-    output_fd = STDOUT_FILENO;
+// Format a type+address-only record (free: F <addr> T<tid>, phase
+// markers: B/E <id> T<tid>) - no size, no call site
+static inline void fmt_bare(char type, uint64_t addr, uint32_t tid) {
+  if (write_buf_pos + 64 > WRITE_BUF_SIZE)
+    wb_flush();
+  char *p = write_buf + write_buf_pos;
+  *p++ = type;
+  *p++ = ' ';
+  p += fmt_hex(p, addr);
+  *p++ = ' ';
+  *p++ = 'T';
+  p += fmt_dec(p, tid);
+  p = fmt_ts_suffix(p);
+  *p++ = '\n';
+  write_buf_pos = (int)(p - write_buf);
+}
 
-  uint64_t tail = atomic_load_explicit(&ring_buffer.tail, memory_order_relaxed);
-  uint64_t head = atomic_load_explicit(&ring_buffer.head, memory_order_acquire);
+// Write file-registration records ("D <id> <path>") for names interned
+// since the last flush. Same contract as the binary 'F' records: a
+// registration always precedes the first event that references its id,
+// because flushes emit new registrations before draining any ring.
+static uint32_t text_files_written = 0;
+
+static void emit_text_file_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&file_table.count,
+                                                  memory_order_acquire);
+  if (count > MAX_FILES)
+    count = MAX_FILES;
+
+  for (uint32_t id = text_files_written; id < count; id++) {
+    // An id claimed by another thread may still be mid-copy; the copy is
+    // a bounded strncpy, so just wait for its ready flag
+    while (!atomic_load_explicit(&file_table.ready[id], memory_order_acquire))
+      ;
+    if (write_buf_pos + 16 + MAX_FILENAME > WRITE_BUF_SIZE)
+      wb_flush();
+    const char *name = file_table.names[id];
+    char *p = write_buf + write_buf_pos;
+    *p++ = 'D';
+    *p++ = ' ';
+    p += fmt_dec(p, id);
+    *p++ = ' ';
+    while (*name) *p++ = *name++;
+    *p++ = '\n';
+    write_buf_pos = (int)(p - write_buf);
+  }
+  text_files_written = count;
+}
 
-  if (text_mode) {
-    while (tail != head) {
-      CacheEvent *e = &ring_buffer.events[tail];
-      uint64_t addr = e->address & EVENT_ADDR_MASK;
-      uint32_t file_id = e->line >> 20;
-      uint32_t line = e->line & 0xFFFFF;
-      const char *file = (file_id < file_table.count) ? file_table.names[file_id] : "?";
-
-      // Check event type flags from high bits
-      int is_store = (e->address & EVENT_STORE_FLAG) != 0;
-      int is_icache = (e->address & EVENT_ICACHE_FLAG) != 0;
-      int is_prefetch = (e->address & EVENT_PREFETCH_FLAG) != 0;
-      int is_vector = (e->address & EVENT_VECTOR_FLAG) != 0;
-      int is_atomic = (e->address & EVENT_ATOMIC_FLAG) != 0;
-      int is_memintr = (e->address & EVENT_MEMINTR_FLAG) != 0;
-
-      if (is_memintr) {
-        uint64_t intrinsic_type = (e->address >> 54) & 0x3;
-        if (intrinsic_type == 1) {
-          fmt_event('Z', addr, e->size, file, line, e->thread_id);
-        } else if (intrinsic_type == 2) {
-          fmt_event_src('O', addr, e->src_address, e->size, file, line, e->thread_id);
-        } else {
-          fmt_event_src('M', addr, e->src_address, e->size, file, line, e->thread_id);
-        }
-      } else if (is_atomic) {
-        uint64_t atomic_type = (e->address >> 57) & 0x3;
-        char event_type;
-        if (atomic_type == 3) event_type = 'C';
-        else if (atomic_type == 2) event_type = 'X';
-        else if (is_store) event_type = 'X';
-        else event_type = 'A';
-        fmt_event(event_type, addr, e->size, file, line, e->thread_id);
-      } else if (is_vector) {
-        fmt_event(is_store ? 'U' : 'V', addr, e->size, file, line, e->thread_id);
-      } else if (is_prefetch) {
-        uint8_t hint = (e->address >> 54) & 0x3;
-        fmt_prefetch(hint, addr, e->size, file, line, e->thread_id);
-      } else if (is_icache) {
-        fmt_event('I', addr, e->size, file, line, e->thread_id);
-      } else {
-        fmt_event(is_store ? 'S' : 'L', addr, e->size, file, line, e->thread_id);
-      }
+// Write function-registration records ("G <file_id>:<line> <func>") for
+// sites registered since the last flush. Emitted after the file records,
+// so the file ids they reference are already bound.
+static uint32_t text_funcs_written = 0;
+
+static void emit_text_func_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&func_table.count,
+                                                  memory_order_acquire);
+
+  for (uint32_t i = text_funcs_written; i < count; i++) {
+    const char *func = func_table.sites[i].func;
+    int func_len = (int)strlen(func);
+    if (write_buf_pos + 32 + func_len > WRITE_BUF_SIZE)
+      wb_flush();
+    char *p = write_buf + write_buf_pos;
+    *p++ = 'G';
+    *p++ = ' ';
+    p += fmt_dec(p, func_table.sites[i].file_id);
+    *p++ = ':';
+    p += fmt_dec(p, func_table.sites[i].line);
+    *p++ = ' ';
+    memcpy(p, func, func_len);
+    p += func_len;
+    *p++ = '\n';
+    write_buf_pos = (int)(p - write_buf);
+  }
+  text_funcs_written = count;
+}
+
+// Write region records ("K <kind> <lo> <hi>") for stack/data ranges
+// registered since the last flush. Text mode only - the binary format
+// has no side-band record for them, and the binary consumers don't
+// classify regions.
+static uint32_t text_regions_written = 0;
+
+static void emit_text_region_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&region_table.count,
+                                                  memory_order_acquire);
+  if (count > MAX_REGIONS)
+    count = MAX_REGIONS;
+
+  for (uint32_t i = text_regions_written; i < count; i++) {
+    if (write_buf_pos + 64 > WRITE_BUF_SIZE)
+      wb_flush();
+    const char *kind = region_table.entries[i].kind;
+    char *p = write_buf + write_buf_pos;
+    *p++ = 'K';
+    *p++ = ' ';
+    while (*kind) *p++ = *kind++;
+    *p++ = ' ';
+    p += fmt_hex(p, region_table.entries[i].lo);
+    *p++ = ' ';
+    p += fmt_hex(p, region_table.entries[i].hi);
+    *p++ = '\n';
+    write_buf_pos = (int)(p - write_buf);
+  }
+  text_regions_written = count;
+}
+
+// Write compressibility hints ("Y <line> <class>") sampled since the
+// last flush. Text mode only, like the K records - the binary format
+// has no side-band record for them.
+static uint32_t text_hints_written = 0;
+
+static void emit_text_compress_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&compress_table.count,
+                                                  memory_order_acquire);
+  if (count > MAX_COMPRESS_HINTS)
+    count = MAX_COMPRESS_HINTS;
+
+  for (uint32_t i = text_hints_written; i < count; i++) {
+    if (write_buf_pos + 32 > WRITE_BUF_SIZE)
+      wb_flush();
+    char *p = write_buf + write_buf_pos;
+    *p++ = 'Y';
+    *p++ = ' ';
+    p += fmt_hex(p, compress_table.entries[i].line);
+    *p++ = ' ';
+    *p++ = (char)('0' + (compress_table.entries[i].cls & 3));
+    *p++ = '\n';
+    write_buf_pos = (int)(p - write_buf);
+  }
+  text_hints_written = count;
+}
+
+// Announce the sampling divisor ("W <divisor>") whenever it changed
+// since the last flush - once at the first flush for a static
+// CACHE_EXPLORER_SAMPLE_RATE, and after every adjustment the adaptive
+// controller makes. Emitted ahead of the ring drain: the controller
+// only moves the divisor right after a drain, so the events that
+// follow were (near enough) all sampled under it. Text mode only, like
+// the K and Y records.
+static uint32_t text_rate_written = 0;
+
+static void emit_text_rate_record(void) {
+  uint32_t rate = adaptive_sampling
+      ? atomic_load_explicit(&adaptive_divisor, memory_order_relaxed)
+      : sample_rate;
+  if (rate == text_rate_written || (text_rate_written == 0 && rate == 1))
+    return;
+  if (write_buf_pos + 16 > WRITE_BUF_SIZE)
+    wb_flush();
+  char *p = write_buf + write_buf_pos;
+  *p++ = 'W';
+  *p++ = ' ';
+  p += fmt_dec(p, rate);
+  *p++ = '\n';
+  write_buf_pos = (int)(p - write_buf);
+  text_rate_written = rate;
+}
+
+// --- Heap object attribution (CACHE_EXPLORER_TRACK_HEAP=1) ----------------
+//
+// malloc/calloc/realloc/free are interposed at link time (operator new
+// reaches malloc through libstdc++, so C++ allocations are covered too)
+// and emit H/F records into the same per-thread rings as memory accesses -
+// the allocation path takes no locks beyond what libc itself does.
+// cache-sim keeps the live address ranges and attributes every access to
+// its owning allocation site, turning "which line misses" into "which
+// data structure misses". The wrappers forward straight to libc unless
+// tracking is enabled, so instrumented binaries that don't ask for it
+// keep stock allocator behavior.
+
+static void *(*real_malloc)(size_t);
+static void *(*real_calloc)(size_t, size_t);
+static void *(*real_realloc)(void *, size_t);
+static void (*real_free)(void *);
+
+// dlsym may itself allocate while the real functions are being resolved;
+// those early requests are served from a static pool and never freed
+static char boot_pool[4096];
+static size_t boot_used = 0;
+static atomic_int heap_resolving = 0;
+
+static int is_boot_ptr(void *p) {
+  return (char *)p >= boot_pool && (char *)p < boot_pool + sizeof(boot_pool);
+}
+
+static void *boot_alloc(size_t bytes) {
+  bytes = (bytes + 15) & ~(size_t)15;
+  if (boot_used + bytes > sizeof(boot_pool))
+    return NULL;
+  void *p = boot_pool + boot_used;
+  boot_used += bytes;
+  return p;  // calloc semantics for free: the pool is zero-initialized
+}
+
+static void resolve_real_alloc(void) {
+  if (atomic_exchange(&heap_resolving, 1))
+    return;  // dlsym re-entered the allocator - boot pool serves it
+  real_calloc = (void *(*)(size_t, size_t))dlsym(RTLD_NEXT, "calloc");
+  real_realloc = (void *(*)(void *, size_t))dlsym(RTLD_NEXT, "realloc");
+  real_free = (void (*)(void *))dlsym(RTLD_NEXT, "free");
+  // malloc last: its non-NULL value is what ends the boot-pool fallback
+  real_malloc = (void *(*)(size_t))dlsym(RTLD_NEXT, "malloc");
+  atomic_store(&heap_resolving, 0);
+}
 
-      tail = (tail + 1) & BUFFER_MASK;
+// Call sites are identified by return address; without debug info the
+// trace carries them as "heap[0x...]" pseudo-filenames that addr2line can
+// resolve. Slots are CAS-claimed like the filename intern table so the
+// name buffer each emitted event points at is stable for the whole run.
+#define MAX_HEAP_SITES 512
+static struct {
+  _Atomic(void *) ra;
+  char name[32];  // "heap[0x...]"
+  atomic_uchar ready;
+} heap_site_table[MAX_HEAP_SITES];
+
+static const char *heap_site_name(void *ra) {
+  uint32_t h =
+      (uint32_t)(((uintptr_t)ra >> 2) * 2654435761u) & (MAX_HEAP_SITES - 1);
+  for (uint32_t probes = 0; probes < MAX_HEAP_SITES; probes++) {
+    void *cur =
+        atomic_load_explicit(&heap_site_table[h].ra, memory_order_acquire);
+    if (cur == NULL) {
+      void *expected = NULL;
+      if (atomic_compare_exchange_strong(&heap_site_table[h].ra, &expected,
+                                         ra)) {
+        char *p = heap_site_table[h].name;
+        memcpy(p, "heap[", 5);
+        p += 5;
+        p += fmt_hex(p, (uint64_t)(uintptr_t)ra);
+        *p++ = ']';
+        *p = '\0';
+        atomic_store_explicit(&heap_site_table[h].ready, 1,
+                              memory_order_release);
+        return heap_site_table[h].name;
+      }
+      cur = expected;
+    }
+    if (cur == ra) {
+      while (!atomic_load_explicit(&heap_site_table[h].ready,
+                                   memory_order_acquire))
+        ;
+      return heap_site_table[h].name;
     }
-    // Flush remaining buffered output
+    h = (h + 1) & (MAX_HEAP_SITES - 1);
+  }
+  return "heap";  // table full - lump the overflow into one site
+}
+
+// Re-entrancy guard: emit_event may allocate (ring registration, interned
+// names), and those allocations must not recurse into the note hooks
+static _Thread_local int in_heap_hook = 0;
+
+static void note_alloc(void *p, size_t size, void *ra) {
+  if (!track_heap || p == NULL || in_heap_hook)
+    return;
+  in_heap_hook = 1;
+  // CacheEvent carries a 32-bit size; clamp >4GB allocations
+  uint32_t sz = size > 0xFFFFFFFFULL ? 0xFFFFFFFFu : (uint32_t)size;
+  emit_event((uint64_t)p | EVENT_HEAP_FLAG, sz, heap_site_name(ra), 0);
+  in_heap_hook = 0;
+}
+
+static void note_free(void *p) {
+  if (!track_heap || p == NULL || in_heap_hook)
+    return;
+  in_heap_hook = 1;
+  emit_event((uint64_t)p | EVENT_HEAP_FLAG | EVENT_STORE_FLAG, 0, "heap", 0);
+  in_heap_hook = 0;
+}
+
+void *malloc(size_t size) {
+  if (__builtin_expect(real_malloc == NULL, 0)) {
+    resolve_real_alloc();
+    if (real_malloc == NULL)
+      return boot_alloc(size);
+  }
+  void *p = real_malloc(size);
+  note_alloc(p, size, __builtin_return_address(0));
+  return p;
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  if (__builtin_expect(real_calloc == NULL, 0)) {
+    resolve_real_alloc();
+    if (real_calloc == NULL)
+      return boot_alloc(nmemb * size);
+  }
+  void *p = real_calloc(nmemb, size);
+  note_alloc(p, nmemb * size, __builtin_return_address(0));
+  return p;
+}
+
+void *realloc(void *old, size_t size) {
+  if (__builtin_expect(real_realloc == NULL, 0)) {
+    resolve_real_alloc();
+    if (real_realloc == NULL)
+      return boot_alloc(size);
+  }
+  if (is_boot_ptr(old))
+    old = NULL;  // boot memory can't be handed to libc
+  note_free(old);
+  void *p = real_realloc(old, size);
+  note_alloc(p, size, __builtin_return_address(0));
+  return p;
+}
+
+void free(void *p) {
+  if (p == NULL || is_boot_ptr(p))
+    return;
+  if (__builtin_expect(real_free == NULL, 0)) {
+    resolve_real_alloc();
+    if (real_free == NULL)
+      return;
+  }
+  note_free(p);
+  real_free(p);
+}
+
+// Binary trace format ("CXTB") - see BinaryTrace.hpp in the simulator.
+// Header: magic + version. Records: 'F' (file table entry: id, len, name)
+// and 'E' (packed 28-byte event). File records are written before any
+// event that references them, so the stream decodes in one forward pass.
+static int binary_header_written = 0;
+static uint32_t binary_files_written = 0;
+
+static void wb_append(const void *data, int len) {
+  if (write_buf_pos + len > WRITE_BUF_SIZE)
     wb_flush();
+  memcpy(write_buf + write_buf_pos, data, len);
+  write_buf_pos += len;
+}
+
+static void emit_binary_header(void) {
+  static const char magic[4] = {'C', 'X', 'T', 'B'};
+  // Version 2 announces that compact delta records may follow, so a
+  // reader that only knows version 1 fails at the header, not mid-record
+  uint32_t version = compact_mode ? 2 : 1;
+  wb_append(magic, 4);
+  wb_append(&version, 4);
+  binary_header_written = 1;
+}
+
+// Write file-table entries interned since the last flush
+static void emit_binary_file_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&file_table.count,
+                                                  memory_order_acquire);
+  if (count > MAX_FILES)
+    count = MAX_FILES;
+
+  for (uint32_t id = binary_files_written; id < count; id++) {
+    // An id claimed by another thread may still be mid-copy; the copy is
+    // a bounded strncpy, so just wait for its ready flag
+    while (!atomic_load_explicit(&file_table.ready[id], memory_order_acquire))
+      ;
+    char tag = 'F';
+    uint16_t name_len = (uint16_t)strlen(file_table.names[id]);
+    wb_append(&tag, 1);
+    wb_append(&id, 4);
+    wb_append(&name_len, 2);
+    wb_append(file_table.names[id], name_len);
+  }
+  binary_files_written = count;
+}
+
+// Write function-registration records ('G': packed file_id<<20|line,
+// name_len, name) for sites registered since the last flush
+static uint32_t binary_funcs_written = 0;
+
+static void emit_binary_func_records(void) {
+  uint32_t count = (uint32_t)atomic_load_explicit(&func_table.count,
+                                                  memory_order_acquire);
+
+  for (uint32_t i = binary_funcs_written; i < count; i++) {
+    char tag = 'G';
+    uint32_t packed = (func_table.sites[i].file_id << 20) |
+                      (func_table.sites[i].line & 0xFFFFF);
+    uint16_t name_len = (uint16_t)strlen(func_table.sites[i].func);
+    wb_append(&tag, 1);
+    wb_append(&packed, 4);
+    wb_append(&name_len, 2);
+    wb_append(func_table.sites[i].func, name_len);
+  }
+  binary_funcs_written = count;
+}
+
+// Compact-event delta state. The flush path is serialized by flush_mutex,
+// so plain statics suffice; only compact records advance the state, and
+// the decoder (BinaryTrace.hpp) mirrors it with the same four scalars.
+static uint64_t compact_prev_addr = 0;
+static uint32_t compact_prev_size = 0;
+static uint32_t compact_prev_line = 0;
+static uint32_t compact_prev_tid = 1;
+
+// LEB128 varint encode; returns the byte count
+static inline int fmt_varint(char *buf, uint64_t v) {
+  int n = 0;
+  while (v >= 0x80) {
+    buf[n++] = (char)(v | 0x80);
+    v >>= 7;
+  }
+  buf[n++] = (char)v;
+  return n;
+}
+
+static void emit_binary_event(const CacheEvent *e) {
+  // Plain loads/stores delta-encode against the previous compact event:
+  // one opcode byte (high bit set, low bits = store + which fields
+  // changed) plus a zigzag-varint address delta, then size/line/thread
+  // varints only when they differ. Strided loops settle at 2-4 bytes per
+  // event. Anything carrying other flag bits keeps the fixed 'E' record.
+  if (compact_mode &&
+      (e->address & ~EVENT_STORE_FLAG & ~EVENT_PHASE_ID_MASK) == 0) {
+    uint64_t addr = e->address & EVENT_ADDR_MASK;
+    char buf[24];
+    int n = 1;
+    uint8_t op = 0x80;
+    if (e->address & EVENT_STORE_FLAG)
+      op |= 0x01;
+    int64_t delta = (int64_t)(addr - compact_prev_addr);
+    n += fmt_varint(buf + n, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+    compact_prev_addr = addr;
+    if (e->size != compact_prev_size) {
+      op |= 0x02;
+      n += fmt_varint(buf + n, e->size);
+      compact_prev_size = e->size;
+    }
+    if (e->line != compact_prev_line) {
+      op |= 0x04;
+      n += fmt_varint(buf + n, e->line);
+      compact_prev_line = e->line;
+    }
+    if (e->thread_id != compact_prev_tid) {
+      op |= 0x08;
+      n += fmt_varint(buf + n, e->thread_id);
+      compact_prev_tid = e->thread_id;
+    }
+    buf[0] = (char)op;
+    wb_append(buf, n);
+    return;
+  }
+
+  char tag = 'E';
+  wb_append(&tag, 1);
+  wb_append(&e->address, 8);
+  wb_append(&e->src_address, 8);
+  wb_append(&e->size, 4);
+  wb_append(&e->line, 4);
+  wb_append(&e->thread_id, 4);
+}
+
+static void emit_text_event(const CacheEvent *e) {
+  uint64_t addr = e->address & EVENT_ADDR_MASK;
+  // Locations go out as numeric "<file_id>:<line>"; the id's path was
+  // bound by the D record emit_text_file_records() wrote at flush time
+  uint32_t file_id = e->line >> 20;
+  uint32_t line = e->line & 0xFFFFF;
+
+  if (timestamps_on) {
+    // Extend the stored 32-bit stamp back to 64 bits against the current
+    // counter: the event is at most one drain period old, far inside the
+    // ~2^32-cycle wrap, so (now - age mod 2^32) recovers capture time
+    uint64_t now = read_cycles();
+    pending_ts = now - (uint32_t)((uint32_t)now - e->tsc);
+  }
+
+  // Check event type flags from high bits
+  int is_store = (e->address & EVENT_STORE_FLAG) != 0;
+  int is_icache = (e->address & EVENT_ICACHE_FLAG) != 0;
+  int is_prefetch = (e->address & EVENT_PREFETCH_FLAG) != 0;
+  int is_vector = (e->address & EVENT_VECTOR_FLAG) != 0;
+  int is_atomic = (e->address & EVENT_ATOMIC_FLAG) != 0;
+  int is_memintr = (e->address & EVENT_MEMINTR_FLAG) != 0;
+  int is_range = (e->address & EVENT_RANGE_FLAG) != 0;
+  int is_heap = (e->address & EVENT_HEAP_FLAG) != 0;
+  int is_phase = (e->address & EVENT_PHASE_FLAG) != 0;
+  int is_gather = (e->address & EVENT_GATHER_FLAG) != 0;
+
+  if (is_phase) {
+    // Phase markers reuse the store bit: 0=begin (B), 1=end (E)
+    fmt_bare(is_store ? 'E' : 'B', e->address & EVENT_PHASE_ID_MASK,
+             e->thread_id);
+  } else if (is_heap) {
+    // Heap records reuse the store bit: 0=alloc (H), 1=free (F)
+    if (is_store) {
+      fmt_bare('F', e->address & EVENT_HEAP_ADDR_MASK, e->thread_id);
+    } else {
+      fmt_event('H', e->address & EVENT_HEAP_ADDR_MASK, e->size, file_id, line,
+                e->thread_id);
+    }
+  } else if (is_range) {
+    fmt_range(is_store, e->address & EVENT_RANGE_ADDR_MASK,
+              (int32_t)(e->src_address & 0xFFFFFFFF),
+              (uint32_t)(e->src_address >> 32), e->size, file_id, line,
+              e->thread_id);
+  } else if (is_memintr) {
+    uint64_t intrinsic_type = (e->address >> 54) & 0x3;
+    if (intrinsic_type == 1) {
+      fmt_event('Z', addr, e->size, file_id, line, e->thread_id);
+    } else if (intrinsic_type == 2) {
+      fmt_event_src('O', addr, e->src_address, e->size, file_id, line, e->thread_id);
+    } else {
+      fmt_event_src('M', addr, e->src_address, e->size, file_id, line, e->thread_id);
+    }
+  } else if (is_atomic) {
+    uint64_t atomic_type = (e->address >> 57) & 0x3;
+    char event_type;
+    if (atomic_type == 3) event_type = 'C';
+    else if (atomic_type == 2) event_type = 'X';
+    else if (is_store) event_type = 'X';
+    else event_type = 'A';
+    fmt_event(event_type, addr, e->size, file_id, line, e->thread_id);
+  } else if (is_gather) {
+    fmt_gather(is_store, e->address & EVENT_GATHER_ADDR_MASK,
+               (uint32_t)(e->src_address & 0xFFFFFFFF),
+               (uint32_t)(e->src_address >> 32), e->size, file_id, line,
+               e->thread_id);
+  } else if (is_vector) {
+    fmt_event(is_store ? 'U' : 'V', addr, e->size, file_id, line, e->thread_id);
+  } else if (is_prefetch) {
+    uint8_t hint = (e->address >> 54) & 0x3;
+    fmt_prefetch(hint, addr, e->size, file_id, line, e->thread_id);
+  } else if (is_icache) {
+    fmt_event('I', addr, e->size, file_id, line, e->thread_id);
   } else {
-    while (tail != head) {
-      write(output_fd, &ring_buffer.events[tail], sizeof(CacheEvent));
-      tail = (tail + 1) & BUFFER_MASK;
+    fmt_event(is_store ? 'S' : 'L', addr, e->size, file_id, line, e->thread_id);
+  }
+}
+
+// Drain one ring into the write buffer. Only the flush path moves tail;
+// the owning thread keeps producing at head while this runs.
+static void drain_ring(ThreadRing *ring) {
+  uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  uint64_t drained = 0;
+  while (tail != head) {
+    if (text_mode) {
+      emit_text_event(&ring->events[tail]);
+    } else {
+      emit_binary_event(&ring->events[tail]);
     }
+    tail = (tail + 1) & RING_MASK;
+    drained++;
+  }
+  atomic_store_explicit(&ring->tail, tail, memory_order_release);
+  // Drain-side event counting (emit-side counts when a limit is set)
+  if (max_events == 0 && drained > 0) {
+    atomic_fetch_add_explicit(&total_events, drained, memory_order_relaxed);
+  }
+  // The adaptive controller's rate input: captured events per interval
+  if (adaptive_sampling && drained > 0) {
+    atomic_fetch_add_explicit(&adaptive_drained, drained,
+                              memory_order_relaxed);
   }
+}
 
-  atomic_store_explicit(&ring_buffer.tail, tail, memory_order_release);
+void __cache_explorer_flush(void) {
+  // Fold this thread's batched event count so short runs still report
+  // accurate totals at shutdown
+  if (local_event_count > 0) {
+    atomic_fetch_add_explicit(&total_events, local_event_count,
+                              memory_order_relaxed);
+    local_event_count = 0;
+  }
+
+  // Shm transport: the consumer drains the rings and reads file
+  // registrations straight from the segment - nothing to format or write
+  if (shm_mode)
+    return;
+
+  pthread_mutex_lock(&flush_mutex);
+  if (output_fd < 0)
+    output_fd = STDOUT_FILENO;
+
+  if (text_mode) {
+    emit_text_file_records();
+    emit_text_func_records();
+    emit_text_region_records();
+    emit_text_compress_records();
+    emit_text_rate_record();
+  } else {
+    if (!binary_header_written)
+      emit_binary_header();
+    emit_binary_file_records();
+    emit_binary_func_records();
+  }
+
+  uint32_t threads = atomic_load(&thread_counter) - 1;  // ids start at 1
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+  for (uint32_t slot = 0; slot < threads; slot++) {
+    ThreadRing *ring = atomic_load_explicit(&thread_rings[slot], memory_order_acquire);
+    if (ring)
+      drain_ring(ring);
+  }
+  wb_flush();
+  pthread_mutex_unlock(&flush_mutex);
+
+  maybe_report_progress();
 }
 
 static atomic_int shutdown_done = 0;
@@ -470,13 +2015,37 @@ void __cache_explorer_shutdown(void) {
   if (atomic_exchange(&shutdown_done, 1))
     return;
 
-  // Emit final progress (total events collected)
+  // Stop the flush thread before the final drain so it can't race the
+  // fd close below
+  if (flusher_started) {
+    atomic_store(&flusher_run, 0);
+    pthread_join(flusher_thread, NULL);
+    flusher_started = 0;
+  }
+
+  uint64_t dropped = atomic_load(&dropped_events);
+  if (dropped > 0) {
+    fprintf(stderr, "[cache-explorer] WARNING: %llu events dropped - trace "
+            "consumer could not keep up (see drop-and-count policy in "
+            "cache-explorer-rt.c)\n", (unsigned long long)dropped);
+  }
+
+  // Shm transport: every event is already in the segment; hand the
+  // remaining contents to the consumer and stop
+  if (shm_mode) {
+    __atomic_store_n(&shm_hdr->dropped_events, dropped, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm_hdr->producer_done, 1, __ATOMIC_RELEASE);
+    return;
+  }
+
+  // Final drain, then emit final progress (drain-side counting means the
+  // total is only complete after the last flush)
+  __cache_explorer_flush();
+  zstd_close();
   uint64_t final_count = atomic_load(&total_events);
   if (progress_interval > 0) {
     emit_runtime_progress(max_events > 0 ? (final_count < max_events ? final_count : max_events) : final_count);
   }
-
-  __cache_explorer_flush();
   if (output_fd > 2) {
     close(output_fd);
     output_fd = -1;
@@ -13,6 +13,10 @@ typedef struct {
   uint32_t size;
   uint32_t line;
   uint32_t thread_id;
+  // Low 32 bits of the capture-time cycle counter when
+  // CACHE_EXPLORER_TIMESTAMPS=1 (otherwise 0). Occupies what used to be
+  // tail padding, so the 32-byte layout the pass bakes into IR holds.
+  uint32_t tsc;
 } CacheEvent;
 
 // Event type flags in high bits of address
@@ -24,6 +28,13 @@ typedef struct {
 // Bit 58-57: atomic subtype (00=load, 01=store, 10=RMW, 11=cmpxchg)
 // Bit 56: 1=memory intrinsic
 // Bit 55-54: intrinsic type (00=memcpy, 01=memset, 10=memmove)
+// Bit 53: 1=compressed range (bits 54+ are exhausted; real addresses fit
+//         in 48 bits, so range records just use a narrower address mask)
+// Bit 52: 1=heap record from malloc interposition (store bit: 0=alloc, 1=free)
+// Bit 51: 1=phase marker from the ROI API (store bit: 0=begin, 1=end);
+//         the address field carries the phase id
+// Bit 50: 1=gather/scatter lane (set together with the vector bit); the
+//         lane index and lane count pack into src_address
 #define EVENT_STORE_FLAG    (1ULL << 63)
 #define EVENT_ICACHE_FLAG   (1ULL << 62)
 #define EVENT_PREFETCH_FLAG (1ULL << 61)
@@ -34,7 +45,65 @@ typedef struct {
 #define EVENT_MEMINTR_FLAG  (1ULL << 56)
 #define EVENT_MEMSET_TYPE   (1ULL << 54)    // Bit 55-54 = 01
 #define EVENT_MEMMOVE_TYPE  (2ULL << 54)    // Bit 55-54 = 10
+#define EVENT_RANGE_FLAG    (1ULL << 53)
+#define EVENT_HEAP_FLAG     (1ULL << 52)
+#define EVENT_PHASE_FLAG    (1ULL << 51)
+#define EVENT_GATHER_FLAG   (1ULL << 50)
 #define EVENT_ADDR_MASK     0x00FFFFFFFFFFFFFFULL  // Lower 56 bits for address
+#define EVENT_RANGE_ADDR_MASK (EVENT_RANGE_FLAG - 1)  // Lower 53 bits for ranges
+#define EVENT_HEAP_ADDR_MASK  (EVENT_HEAP_FLAG - 1)   // Lower 52 bits for heap records
+#define EVENT_PHASE_ID_MASK   (EVENT_PHASE_FLAG - 1)  // Lower 51 bits for phase ids
+#define EVENT_GATHER_ADDR_MASK (EVENT_GATHER_FLAG - 1) // Lower 50 bits for gather lanes
+
+// Shared-memory transport (CACHE_EXPLORER_SHM=<path>): instead of
+// formatting events and pushing them through a pipe, the runtime places
+// its per-thread rings in a file-backed segment and cache-sim --shm maps
+// the same file and consumes CacheEvent records in place - no
+// per-event formatting, no kernel copies, no producer-side syscalls.
+// The simulator is the single consumer (it advances each ring's tail).
+//
+// Segment layout (all offsets fixed so both sides agree at compile time):
+//   [0, 4096)                      CacheShmHeader
+//   [CACHE_SHM_FILE_OFF, ...)      CACHE_SHM_MAX_FILES x CacheShmFile
+//   [CACHE_SHM_RING_OFF, ...)      CACHE_SHM_MAX_RINGS ring slots of
+//                                  CACHE_SHM_RING_STRIDE bytes, each
+//                                  holding one ThreadRing (events array,
+//                                  then cache-line-isolated head and tail)
+//
+// The producer writes every header field, then publishes the magic with a
+// release store; a ring becomes live when num_rings covers its slot.
+// Function-site G records are not carried over this transport (live
+// analysis does not do function rollups).
+#define CACHE_SHM_VERSION 1
+#define CACHE_SHM_MAX_RINGS 64
+#define CACHE_SHM_MAX_FILES 4096
+#define CACHE_SHM_NAME_MAX 256
+#define CACHE_SHM_RING_EVENTS 65536  /* must equal RING_SIZE in the .c */
+#define CACHE_SHM_FILE_OFF 4096
+#define CACHE_SHM_RING_OFF \
+  (CACHE_SHM_FILE_OFF + CACHE_SHM_MAX_FILES * (uint64_t)sizeof(CacheShmFile))
+/* events + head/tail cache lines, rounded up to a whole page */
+#define CACHE_SHM_RING_STRIDE \
+  (((CACHE_SHM_RING_EVENTS * 32ULL + 128 + 4095) / 4096) * 4096)
+#define CACHE_SHM_SEGMENT_SIZE \
+  (CACHE_SHM_RING_OFF + CACHE_SHM_MAX_RINGS * CACHE_SHM_RING_STRIDE)
+
+typedef struct {
+  char magic[4];           /* "CXSM" - written last, with release order */
+  uint32_t version;        /* CACHE_SHM_VERSION */
+  uint32_t ring_events;    /* events per ring (power of two) */
+  uint32_t max_rings;
+  uint32_t max_files;
+  uint32_t num_rings;      /* atomic: ring slots claimed by producer threads */
+  uint32_t producer_done;  /* atomic: no more events after this is set */
+  uint64_t dropped_events; /* valid once producer_done is set */
+} CacheShmHeader;
+
+typedef struct {
+  uint32_t ready;  /* atomic: name fully written */
+  uint32_t pad;
+  char name[CACHE_SHM_NAME_MAX];
+} CacheShmFile;
 
 void __tag_mem_load(void *addr, uint32_t size, const char *file, uint32_t line);
 void __tag_mem_store(void *addr, uint32_t size, const char *file,
@@ -51,17 +120,68 @@ void __tag_prefetch(void *addr, uint32_t size, uint8_t hint, const char *file, u
 void __tag_vector_load(void *addr, uint32_t size, const char *file, uint32_t line);
 void __tag_vector_store(void *addr, uint32_t size, const char *file, uint32_t line);
 
+// Gather/scatter lanes (llvm.masked.gather/scatter): the pass resolves
+// each active lane's pointer and tags it separately, one call per lane.
+// lane is the 0-based index among the op's active lanes; lanes is their
+// total, so the simulator can group the records back into one op.
+void __tag_gather_lane(void *addr, uint32_t size, uint32_t lane,
+                       uint32_t lanes, const char *file, uint32_t line);
+void __tag_scatter_lane(void *addr, uint32_t size, uint32_t lane,
+                        uint32_t lanes, const char *file, uint32_t line);
+
 // Atomic operations
 void __tag_atomic_load(void *addr, uint32_t size, const char *file, uint32_t line);
 void __tag_atomic_store(void *addr, uint32_t size, const char *file, uint32_t line);
 void __tag_atomic_rmw(void *addr, uint32_t size, const char *file, uint32_t line);
 void __tag_atomic_cmpxchg(void *addr, uint32_t size, const char *file, uint32_t line);
 
+// Compressed range events (CACHE_EXPLORER_RANGES in CacheExplorerPass.cpp):
+// one record standing for `count` accesses of `size` bytes starting at
+// `base`, `stride` bytes apart. stride must fit in int32, count in uint32.
+void __tag_range_load(void *base, int64_t stride, uint64_t count,
+                      uint32_t size, const char *file, uint32_t line);
+void __tag_range_store(void *base, int64_t stride, uint64_t count,
+                       uint32_t size, const char *file, uint32_t line);
+
 // Memory intrinsics (llvm.memcpy, llvm.memset, llvm.memmove)
 void __tag_memcpy(void *dest, void *src, uint32_t size, const char *file, uint32_t line);
 void __tag_memset(void *dest, uint32_t size, const char *file, uint32_t line);
 void __tag_memmove(void *dest, void *src, uint32_t size, const char *file, uint32_t line);
 
+// Inline fast-path support (CACHE_EXPLORER_INLINE in CacheExplorerPass.cpp):
+// pass-generated IR claims ring slots through these instead of calling the
+// __tag_* entry points per access. The ring pointer is NULL whenever the
+// runtime configuration requires the slow path (sampling, event limits, no
+// flush thread), which routes the generated code back through the calls.
+#ifdef __cplusplus
+extern thread_local void *__cache_explorer_inline_ring;
+extern thread_local uint32_t __cache_explorer_tid;
+#else
+extern _Thread_local void *__cache_explorer_inline_ring;
+extern _Thread_local uint32_t __cache_explorer_tid;
+#endif
+// One-time per call site: interned id for a filename, for packing
+// (id << 20) | line into the event's line field
+uint32_t __cache_explorer_site_id(const char *file);
+
+// Bind a source line to its enclosing pre-inlining function. Called from
+// the pass's per-module registration constructor; emitted as G records
+// so cache-sim can roll per-line stats up to function granularity.
+void __cache_explorer_site_func(const char *file, uint32_t line,
+                                const char *func);
+
+// Region-of-interest markers: bracket the phases worth tracing and skip
+// warmup. start/stop toggle event emission (one relaxed atomic load on
+// the fast path) and emit B/E phase markers so cache-sim reports stats
+// per marked region; pause/resume toggle emission without markers.
+// Set CACHE_EXPLORER_ROI=1 to begin with emission off (trace only marked
+// regions) - this also routes the pass's inline fast path through the
+// calls so the toggle is honored.
+void __cache_explorer_start(void);
+void __cache_explorer_stop(void);
+void __cache_explorer_pause(void);
+void __cache_explorer_resume(void);
+
 void __cache_explorer_init(void);
 void __cache_explorer_flush(void);
 void __cache_explorer_shutdown(void);
@@ -138,11 +138,89 @@ test_source_attribution() {
     rm -f /tmp/zig_attr_output.json
 }
 
+# Test 5: Sampling knob (parity with the C driver's --sample)
+test_sampling() {
+    echo -n "Test 5: Sampling reduces captured events... "
+
+    if ! "$CACHE_EXPLORE_ZIG" "$SCRIPT_DIR/test-programs/array.zig" --json > /tmp/zig_full_output.json 2>&1; then
+        echo -e "${RED}FAIL${NC} (full run failed)"
+        FAILED=$((FAILED + 1))
+        return
+    fi
+    if ! "$CACHE_EXPLORE_ZIG" "$SCRIPT_DIR/test-programs/array.zig" --json --sample 10 > /tmp/zig_sampled_output.json 2>&1; then
+        echo -e "${RED}FAIL${NC} (sampled run failed)"
+        FAILED=$((FAILED + 1))
+        return
+    fi
+
+    FULL_EVENTS=$(jq '.events' /tmp/zig_full_output.json)
+    SAMPLED_EVENTS=$(jq '.events' /tmp/zig_sampled_output.json)
+
+    # 1-in-10 sampling should capture well under half the events
+    if [ "$SAMPLED_EVENTS" -gt 0 ] && [ $((SAMPLED_EVENTS * 2)) -lt "$FULL_EVENTS" ]; then
+        echo -e "${GREEN}PASS${NC} ($FULL_EVENTS → $SAMPLED_EVENTS events)"
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}FAIL${NC} (full: $FULL_EVENTS, sampled: $SAMPLED_EVENTS)"
+        FAILED=$((FAILED + 1))
+    fi
+
+    rm -f /tmp/zig_full_output.json /tmp/zig_sampled_output.json
+}
+
+# Test 6: Event limit knob (parity with the C driver's --limit)
+test_event_limit() {
+    echo -n "Test 6: Event limit caps the trace... "
+
+    if ! "$CACHE_EXPLORE_ZIG" "$SCRIPT_DIR/test-programs/array.zig" --json --limit 500 > /tmp/zig_limit_output.json 2>&1; then
+        echo -e "${RED}FAIL${NC} (limited run failed)"
+        FAILED=$((FAILED + 1))
+        return
+    fi
+
+    EVENTS=$(jq '.events' /tmp/zig_limit_output.json)
+    # The limit is approximate to within one flush batch per thread
+    if [ "$EVENTS" -gt 0 ] && [ "$EVENTS" -lt 5000 ]; then
+        echo -e "${GREEN}PASS${NC} ($EVENTS events)"
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}FAIL${NC} (events: $EVENTS)"
+        FAILED=$((FAILED + 1))
+    fi
+
+    rm -f /tmp/zig_limit_output.json
+}
+
+# Test 7: Binary trace format (CXTB capture + --binary decode)
+test_binary_trace() {
+    echo -n "Test 7: Binary trace format parity... "
+
+    if ! "$CACHE_EXPLORE_ZIG" "$SCRIPT_DIR/test-programs/array.zig" --json --binary > /tmp/zig_binary_output.json 2>&1; then
+        echo -e "${RED}FAIL${NC} (binary run failed)"
+        FAILED=$((FAILED + 1))
+        return
+    fi
+
+    EVENTS=$(jq '.events' /tmp/zig_binary_output.json)
+    if [ "$EVENTS" -gt 0 ]; then
+        echo -e "${GREEN}PASS${NC} ($EVENTS events)"
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}FAIL${NC} (no events decoded)"
+        FAILED=$((FAILED + 1))
+    fi
+
+    rm -f /tmp/zig_binary_output.json
+}
+
 # Run all tests
 test_simple_array
 test_nested_loops
 test_struct_access
 test_source_attribution
+test_sampling
+test_event_limit
+test_binary_trace
 
 echo ""
 echo "=========================================="
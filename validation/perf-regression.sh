@@ -0,0 +1,241 @@
+#!/bin/bash
+# Performance Regression Harness
+# Runs the synthetic-trace suite (trace-gen) through cache-sim across
+# configurations, measuring simulation throughput (events/second) and
+# peak RSS. Compares against a saved baseline and fails on regression,
+# so throughput losses show up in review instead of in production.
+#
+# Usage:
+#   ./perf-regression.sh                   # compare against saved baseline
+#   ./perf-regression.sh --update-baseline # record current machine as baseline
+#
+# Environment:
+#   PERF_EVENTS          Events per synthetic trace (default 2000000)
+#   PERF_THRESHOLD_PCT   Max allowed throughput drop in % (default 15)
+#   PERF_RSS_THRESHOLD_PCT  Max allowed peak-RSS growth in % (default 20)
+#
+# Exit codes:
+#   0 - All scenarios within threshold (or baseline updated)
+#   1 - Some scenario regressed beyond threshold
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+BASELINES_DIR="$SCRIPT_DIR/baselines"
+BASELINE_FILE="$BASELINES_DIR/perf-baseline.json"
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;36m'
+NC='\033[0m'
+
+EVENTS="${PERF_EVENTS:-2000000}"
+THRESHOLD="${PERF_THRESHOLD_PCT:-15}"
+RSS_THRESHOLD="${PERF_RSS_THRESHOLD_PCT:-20}"
+RUNS=3  # best-of-N to shave scheduler noise
+
+# Find the binaries (component build first - that's the development one)
+find_binary() {
+    local name="$1"
+    for candidate in \
+        "$PROJECT_ROOT/backend/cache-simulator/build/$name" \
+        "$PROJECT_ROOT/build/backend/cache-simulator/$name"; do
+        if [[ -x "$candidate" ]]; then
+            echo "$candidate"
+            return 0
+        fi
+    done
+    return 1
+}
+
+CACHE_SIM=$(find_binary cache-sim) || {
+    echo -e "${RED}Error: cache-sim not found - build backend/cache-simulator first${NC}"
+    exit 1
+}
+TRACE_GEN=$(find_binary trace-gen) || {
+    echo -e "${RED}Error: trace-gen not found - build backend/cache-simulator first${NC}"
+    exit 1
+}
+
+if ! command -v python3 &> /dev/null; then
+    echo -e "${RED}Error: python3 is required (wall-clock + peak-RSS measurement)${NC}"
+    exit 1
+fi
+
+if ! command -v jq &> /dev/null; then
+    echo -e "${YELLOW}Warning: jq not found, using grep-based parsing${NC}"
+    USE_JQ=false
+else
+    USE_JQ=true
+fi
+
+# Scenarios: name | trace-gen args | cache-sim args
+# Chosen to cover the paths that have regressed before: the default batch
+# path, fast mode, multi-core coherence, prefetching, and binary input.
+SCENARIOS=(
+    "seq_intel|--pattern sequential --working-set 8M|--config intel"
+    "random_intel|--pattern random --working-set 32M|--config intel"
+    "random_fast|--pattern random --working-set 32M|--config intel --fast"
+    "chase_prefetch|--pattern chase --chase-depth 65536 --working-set 8M|--config intel --prefetch adaptive"
+    "multicore_shared|--pattern random --working-set 16M --threads 4 --sharing 0.2|--config intel"
+    "binary_seq|--pattern sequential --working-set 8M --binary|--config intel --binary"
+)
+
+# Run a command, print "wall_seconds peak_rss_kb" (no /usr/bin/time here)
+measure() {
+    python3 - "$@" <<'EOF'
+import resource, subprocess, sys, time
+start = time.monotonic()
+with open("/dev/null", "wb") as devnull:
+    rc = subprocess.call(sys.argv[1:], stdout=devnull, stderr=devnull, stdin=subprocess.DEVNULL)
+wall = time.monotonic() - start
+rss_kb = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+if rc != 0:
+    sys.exit(rc)
+print(f"{wall:.3f} {rss_kb}")
+EOF
+}
+
+UPDATE_BASELINE=false
+if [[ "$1" == "--update-baseline" ]]; then
+    UPDATE_BASELINE=true
+fi
+
+echo -e "${BLUE}=== Cache Explorer Performance Regression Harness ===${NC}"
+echo "Simulator: $CACHE_SIM"
+echo "Events per trace: $EVENTS"
+echo ""
+
+TRACE_DIR=$(mktemp -d)
+trap 'rm -rf "$TRACE_DIR"' EXIT
+
+declare -A CUR_RATE CUR_RSS
+FAILURES=0
+
+echo -e "${YELLOW}Running scenarios (best of $RUNS)...${NC}"
+echo ""
+
+for scenario in "${SCENARIOS[@]}"; do
+    IFS='|' read -r name gen_args sim_args <<< "$scenario"
+
+    TRACE_FILE="$TRACE_DIR/$name.trace"
+    # shellcheck disable=SC2086
+    "$TRACE_GEN" --events "$EVENTS" $gen_args > "$TRACE_FILE"
+
+    BEST_WALL=""
+    BEST_RSS=""
+    for ((run = 0; run < RUNS; run++)); do
+        # shellcheck disable=SC2086
+        RESULT=$(measure "$CACHE_SIM" --json $sim_args --trace-file "$TRACE_FILE") || {
+            echo -e "${RED}[$name] cache-sim failed${NC}"
+            FAILURES=$((FAILURES + 1))
+            continue 2
+        }
+        WALL=$(echo "$RESULT" | cut -d' ' -f1)
+        RSS=$(echo "$RESULT" | cut -d' ' -f2)
+        if [[ -z "$BEST_WALL" ]] || python3 -c "exit(0 if $WALL < $BEST_WALL else 1)"; then
+            BEST_WALL="$WALL"
+        fi
+        if [[ -z "$BEST_RSS" ]] || python3 -c "exit(0 if $RSS < $BEST_RSS else 1)"; then
+            BEST_RSS="$RSS"
+        fi
+    done
+
+    CUR_RATE[$name]=$(python3 -c "print(int($EVENTS / $BEST_WALL))")
+    CUR_RSS[$name]="$BEST_RSS"
+    echo "[$name] $(printf "%'d" "${CUR_RATE[$name]}") events/s, peak RSS ${CUR_RSS[$name]} KB"
+done
+
+echo ""
+
+if $UPDATE_BASELINE; then
+    mkdir -p "$BASELINES_DIR"
+    {
+        echo "{"
+        echo "  \"host\": \"$(uname -n) ($(uname -m))\","
+        echo "  \"date\": \"$(date -Iseconds)\","
+        echo "  \"events\": $EVENTS,"
+        echo "  \"scenarios\": {"
+        FIRST=true
+        for scenario in "${SCENARIOS[@]}"; do
+            IFS='|' read -r name _ _ <<< "$scenario"
+            [[ -z "${CUR_RATE[$name]}" ]] && continue
+            $FIRST || echo ","
+            FIRST=false
+            printf '    "%s": {"events_per_sec": %s, "peak_rss_kb": %s}' \
+                "$name" "${CUR_RATE[$name]}" "${CUR_RSS[$name]}"
+        done
+        echo ""
+        echo "  }"
+        echo "}"
+    } > "$BASELINE_FILE"
+    echo -e "${GREEN}Baseline written to $BASELINE_FILE${NC}"
+    exit 0
+fi
+
+if [[ ! -f "$BASELINE_FILE" ]]; then
+    echo -e "${RED}Error: no performance baseline at $BASELINE_FILE${NC}"
+    echo "Record one on this machine first: $0 --update-baseline"
+    exit 1
+fi
+
+if $USE_JQ; then
+    BASELINE_HOST=$(jq -r '.host' "$BASELINE_FILE")
+    BASELINE_DATE=$(jq -r '.date' "$BASELINE_FILE")
+else
+    BASELINE_HOST=$(grep -o '"host"[[:space:]]*:[[:space:]]*"[^"]*"' "$BASELINE_FILE" | cut -d'"' -f4)
+    BASELINE_DATE=$(grep -o '"date"[[:space:]]*:[[:space:]]*"[^"]*"' "$BASELINE_FILE" | cut -d'"' -f4)
+fi
+
+echo -e "${BLUE}=== Comparing against baseline ===${NC}"
+echo "Baseline: $BASELINE_HOST ($BASELINE_DATE)"
+echo "Thresholds: throughput -$THRESHOLD%, peak RSS +$RSS_THRESHOLD%"
+echo ""
+
+printf "| %-16s | %14s | %14s | %7s | %6s |\n" "Scenario" "Current ev/s" "Baseline ev/s" "Delta" "Status"
+printf "|------------------|----------------|----------------|---------|--------|\n"
+
+for scenario in "${SCENARIOS[@]}"; do
+    IFS='|' read -r name _ _ <<< "$scenario"
+    [[ -z "${CUR_RATE[$name]}" ]] && continue
+
+    if $USE_JQ; then
+        BASE_RATE=$(jq -r ".scenarios.$name.events_per_sec // \"N/A\"" "$BASELINE_FILE")
+        BASE_RSS=$(jq -r ".scenarios.$name.peak_rss_kb // \"N/A\"" "$BASELINE_FILE")
+    else
+        BASE_LINE=$(grep "\"$name\"" "$BASELINE_FILE" || true)
+        BASE_RATE=$(echo "$BASE_LINE" | grep -o '"events_per_sec": *[0-9]*' | grep -o '[0-9]*$' || echo "N/A")
+        BASE_RSS=$(echo "$BASE_LINE" | grep -o '"peak_rss_kb": *[0-9]*' | grep -o '[0-9]*$' || echo "N/A")
+    fi
+
+    if [[ -z "$BASE_RATE" ]] || [[ "$BASE_RATE" == "N/A" ]] || [[ "$BASE_RATE" == "null" ]]; then
+        printf "| %-16s | %14s | %14s | %7s | SKIP   |\n" "$name" "${CUR_RATE[$name]}" "N/A" "N/A"
+        continue
+    fi
+
+    DELTA_PCT=$(python3 -c "print(f'{(${CUR_RATE[$name]} - $BASE_RATE) * 100 / $BASE_RATE:+.1f}')")
+    STATUS="${GREEN}PASS${NC}"
+    if python3 -c "exit(0 if ${CUR_RATE[$name]} < $BASE_RATE * (100 - $THRESHOLD) / 100 else 1)"; then
+        STATUS="${RED}FAIL${NC}"
+        FAILURES=$((FAILURES + 1))
+    elif [[ "$BASE_RSS" != "N/A" ]] && [[ "$BASE_RSS" != "null" ]] && \
+         python3 -c "exit(0 if ${CUR_RSS[$name]} > $BASE_RSS * (100 + $RSS_THRESHOLD) / 100 else 1)"; then
+        STATUS="${RED}FAIL (RSS ${CUR_RSS[$name]} KB vs $BASE_RSS KB)${NC}"
+        FAILURES=$((FAILURES + 1))
+    fi
+
+    printf "| %-16s | %14s | %14s | %6s%% | " "$name" "${CUR_RATE[$name]}" "$BASE_RATE" "$DELTA_PCT"
+    echo -e "$STATUS |"
+done
+
+echo ""
+if [[ $FAILURES -gt 0 ]]; then
+    echo -e "${RED}$FAILURES scenario(s) regressed beyond threshold${NC}"
+    echo "If the slowdown is intentional, re-record: $0 --update-baseline"
+    exit 1
+fi
+echo -e "${GREEN}All scenarios within threshold${NC}"
+exit 0
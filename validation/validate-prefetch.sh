@@ -0,0 +1,394 @@
+#!/bin/bash
+# Prefetcher Validation Script
+# Compares Prefetcher.hpp's policies against real prefetch PMU counters
+#
+# Usage: ./validate-prefetch.sh [--update-calibration] [--config <config>] [--runs <n>]
+#
+# For each benchmark the simulator runs once per prefetch policy
+# (stream/stride/intel, plus none as the no-prefetch reference), and the
+# hardware runs --runs times with the real prefetchers enabled so the
+# reported deltas carry error bars instead of a single noisy sample.
+#
+# The hardware side counts prefetch requests that hit vs miss in L2 -
+# that is not the same quantity as PrefetchStats.accuracy (useful/issued:
+# a prefetched line that is later demanded), but it is the closest thing
+# silicon exposes, and it moves the same way when a policy stops matching
+# the access pattern. The calibration offset stored per policy is
+# (simulated accuracy - hardware prefetch efficiency); downstream
+# consumers subtract it before comparing runs across the two worlds.
+#
+# Supported architectures:
+#   - Intel: l2_rqsts.pf_hit / l2_rqsts.pf_miss
+#   - AMD: l2_pf_hit_l2 / l2_pf_miss_l2_hit_l3 + l2_pf_miss_l2_l3 (dropped)
+#   - Others: generic L1-dcache-prefetches (efficiency unavailable)
+#
+# Requirements: same as validate-hardware.sh (Linux, perf, built tree)
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+CACHE_EXPLORE="$PROJECT_ROOT/backend/scripts/cache-explore"
+BENCHMARKS_DIR="$SCRIPT_DIR/benchmarks"
+BASELINES_DIR="$SCRIPT_DIR/baselines"
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;36m'
+NC='\033[0m'
+
+UPDATE_CALIBRATION=false
+FORCE_CONFIG=""
+RUNS=5
+
+# Parse arguments
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --update-calibration)
+            UPDATE_CALIBRATION=true
+            shift
+            ;;
+        --config)
+            FORCE_CONFIG="$2"
+            shift 2
+            ;;
+        --runs)
+            RUNS="$2"
+            shift 2
+            ;;
+        *)
+            echo "Unknown option: $1"
+            exit 1
+            ;;
+    esac
+done
+
+# Check platform
+if [[ "$(uname)" != "Linux" ]]; then
+    echo -e "${RED}Error: Prefetch validation requires Linux with perf${NC}"
+    exit 1
+fi
+
+if ! command -v perf &> /dev/null; then
+    echo -e "${RED}Error: perf not found${NC}"
+    echo "Install: sudo apt install linux-tools-generic linux-tools-\$(uname -r)"
+    exit 1
+fi
+
+if ! perf stat true 2>/dev/null; then
+    echo -e "${RED}Error: perf requires permissions${NC}"
+    echo "Run: echo 0 | sudo tee /proc/sys/kernel/perf_event_paranoid"
+    exit 1
+fi
+
+if [[ ! -x "$CACHE_EXPLORE" ]]; then
+    echo -e "${RED}Error: cache-explore not found at $CACHE_EXPLORE${NC}"
+    echo "Run ./scripts/build.sh first"
+    exit 1
+fi
+
+# Get hardware info
+CPU_MODEL=$(lscpu | grep "Model name" | cut -d: -f2 | xargs)
+KERNEL_VERSION=$(uname -r)
+TIMESTAMP=$(date -Iseconds)
+ARCH=$(uname -m)
+
+detect_cpu_vendor() {
+    local vendor=$(lscpu | grep "Vendor ID" | cut -d: -f2 | xargs)
+    case "$vendor" in
+        GenuineIntel) echo "intel" ;;
+        AuthenticAMD) echo "amd" ;;
+        *)
+            if [[ "$ARCH" == "aarch64" ]] || [[ "$ARCH" == "arm64" ]]; then
+                echo "arm"
+            else
+                echo "unknown"
+            fi
+            ;;
+    esac
+}
+
+CPU_VENDOR=$(detect_cpu_vendor)
+
+if [[ -n "$FORCE_CONFIG" ]]; then
+    SIM_CONFIG="$FORCE_CONFIG"
+    echo -e "${YELLOW}Using forced config: $SIM_CONFIG${NC}"
+else
+    case "$CPU_VENDOR" in
+        intel) SIM_CONFIG="xeon8488c" ;;
+        amd)   SIM_CONFIG="zen4" ;;
+        arm)   SIM_CONFIG="graviton3" ;;
+        *)
+            SIM_CONFIG="intel"
+            echo -e "${YELLOW}Warning: Unknown CPU vendor, using intel config${NC}"
+            ;;
+    esac
+fi
+
+# Prefetch counters per vendor. PF_MODE controls how efficiency is
+# derived; "unavailable" still runs the simulator side so the sim-only
+# numbers land in the report, just without hardware error bars.
+case "$CPU_VENDOR" in
+    intel)
+        if perf list 2>/dev/null | grep -q "l2_rqsts.pf_hit"; then
+            PF_HIT_COUNTER="l2_rqsts.pf_hit"
+            PF_MISS_COUNTER="l2_rqsts.pf_miss"
+            PF_DROP_COUNTER=""
+            PF_MODE="hit_miss"
+        else
+            PF_HIT_COUNTER="L1-dcache-prefetches"
+            PF_MISS_COUNTER=""
+            PF_DROP_COUNTER=""
+            PF_MODE="unavailable"
+        fi
+        ;;
+    amd)
+        if perf list 2>/dev/null | grep -q "l2_pf_hit_l2"; then
+            PF_HIT_COUNTER="l2_pf_hit_l2"
+            PF_MISS_COUNTER="l2_pf_miss_l2_hit_l3"
+            PF_DROP_COUNTER="l2_pf_miss_l2_l3"
+            PF_MODE="hit_miss_drop"
+        else
+            PF_HIT_COUNTER="L1-dcache-prefetches"
+            PF_MISS_COUNTER=""
+            PF_DROP_COUNTER=""
+            PF_MODE="unavailable"
+        fi
+        ;;
+    *)
+        PF_HIT_COUNTER="L1-dcache-prefetches"
+        PF_MISS_COUNTER=""
+        PF_DROP_COUNTER=""
+        PF_MODE="unavailable"
+        ;;
+esac
+
+echo -e "${BLUE}=== Cache Explorer Prefetcher Validation ===${NC}"
+echo "CPU: $CPU_MODEL"
+echo "Vendor: $CPU_VENDOR"
+echo "Kernel: $KERNEL_VERSION"
+echo "Simulator config: $SIM_CONFIG"
+echo "Prefetch counter mode: $PF_MODE"
+echo "Hardware runs per benchmark: $RUNS"
+echo ""
+
+TEMP_DIR=$(mktemp -d)
+trap "rm -rf $TEMP_DIR" EXIT
+
+# Prefetch-sensitive subset of the validation benchmarks: the stream
+# detector should own sequential/matrix_row, the stride detector
+# strided_*, and nothing should claim credit on random/linked_list
+BENCHMARKS=(sequential strided_16 strided_64 matrix_row random linked_list)
+POLICIES=(stream stride intel)
+
+# Results: simulator accuracy per policy per benchmark
+declare -A SIM_ACCURACY SIM_ISSUED SIM_USEFUL
+# Results: hardware prefetch efficiency mean/stddev per benchmark
+declare -A HW_EFF_MEAN HW_EFF_STDDEV HW_PF_HITS HW_PF_MISSES HW_PF_DROPS
+
+echo -e "${YELLOW}Running benchmarks...${NC}"
+echo ""
+
+for bench in "${BENCHMARKS[@]}"; do
+    BENCH_FILE="$BENCHMARKS_DIR/$bench.c"
+    if [[ ! -f "$BENCH_FILE" ]]; then
+        echo -e "${RED}Benchmark not found: $BENCH_FILE${NC}"
+        continue
+    fi
+
+    echo -e "${BLUE}[$bench]${NC}"
+
+    # 1. Simulator, once per policy
+    for policy in "${POLICIES[@]}"; do
+        echo "  Running simulator ($policy)..."
+        SIM_OUTPUT=$("$CACHE_EXPLORE" "$BENCH_FILE" --config "$SIM_CONFIG" -O2 \
+                         --prefetch "$policy" --json 2>/dev/null || echo "{}")
+
+        PF_BLOCK=$(echo "$SIM_OUTPUT" | sed -n '/"prefetch"/,/}/p')
+        ISSUED=$(echo "$PF_BLOCK" | grep -oE '"issued":[[:space:]]*[0-9]+' | grep -o '[0-9]*' || echo "0")
+        USEFUL=$(echo "$PF_BLOCK" | grep -oE '"useful":[[:space:]]*[0-9]+' | grep -o '[0-9]*' || echo "0")
+        ACCURACY=$(echo "$PF_BLOCK" | grep -oE '"accuracy":[[:space:]]*[0-9.]+' | grep -oE '[0-9.]+' || echo "0")
+
+        SIM_ISSUED[$bench,$policy]=${ISSUED:-0}
+        SIM_USEFUL[$bench,$policy]=${USEFUL:-0}
+        SIM_ACCURACY[$bench,$policy]=$(echo "scale=1; ${ACCURACY:-0} * 100 / 1" | bc)
+    done
+
+    # 2. Hardware, $RUNS times with the real prefetchers
+    if [[ "$PF_MODE" != "unavailable" ]]; then
+        echo "  Running hardware (perf, ${RUNS}x)..."
+        gcc -O2 "$BENCH_FILE" -o "$TEMP_DIR/$bench" 2>/dev/null
+
+        COUNTERS="$PF_HIT_COUNTER,$PF_MISS_COUNTER"
+        [[ -n "$PF_DROP_COUNTER" ]] && COUNTERS="$COUNTERS,$PF_DROP_COUNTER"
+
+        EFF_SAMPLES=()
+        for ((run = 0; run < RUNS; run++)); do
+            PERF_OUTPUT=$(perf stat -e "$COUNTERS" "$TEMP_DIR/$bench" 2>&1)
+            PF_HIT=$(echo "$PERF_OUTPUT" | grep -i "$PF_HIT_COUNTER" | head -1 | awk '{gsub(/,/,"",$1); print $1}')
+            PF_MISS=$(echo "$PERF_OUTPUT" | grep -i "$PF_MISS_COUNTER" | head -1 | awk '{gsub(/,/,"",$1); print $1}')
+            PF_DROP=0
+            if [[ -n "$PF_DROP_COUNTER" ]]; then
+                PF_DROP=$(echo "$PERF_OUTPUT" | grep -i "$PF_DROP_COUNTER" | head -1 | awk '{gsub(/,/,"",$1); print $1}')
+            fi
+
+            PF_TOTAL=$((${PF_HIT:-0} + ${PF_MISS:-0} + ${PF_DROP:-0}))
+            if [[ $PF_TOTAL -gt 0 ]]; then
+                EFF_SAMPLES+=("$(echo "scale=3; ${PF_HIT:-0} * 100 / $PF_TOTAL" | bc)")
+            fi
+            # Keep the last run's raw counts for the calibration file
+            HW_PF_HITS[$bench]=${PF_HIT:-0}
+            HW_PF_MISSES[$bench]=${PF_MISS:-0}
+            HW_PF_DROPS[$bench]=${PF_DROP:-0}
+        done
+
+        # Mean and standard deviation over the runs (the error bar)
+        if [[ ${#EFF_SAMPLES[@]} -gt 0 ]]; then
+            SUM=0
+            for s in "${EFF_SAMPLES[@]}"; do SUM=$(echo "$SUM + $s" | bc); done
+            MEAN=$(echo "scale=3; $SUM / ${#EFF_SAMPLES[@]}" | bc)
+            SQSUM=0
+            for s in "${EFF_SAMPLES[@]}"; do
+                SQSUM=$(echo "$SQSUM + ($s - $MEAN) * ($s - $MEAN)" | bc)
+            done
+            HW_EFF_MEAN[$bench]=$(echo "scale=1; $MEAN / 1" | bc)
+            HW_EFF_STDDEV[$bench]=$(echo "scale=1; sqrt($SQSUM / ${#EFF_SAMPLES[@]}) / 1" | bc -l)
+        else
+            HW_EFF_MEAN[$bench]="N/A"
+            HW_EFF_STDDEV[$bench]="N/A"
+        fi
+    else
+        HW_EFF_MEAN[$bench]="N/A"
+        HW_EFF_STDDEV[$bench]="N/A"
+    fi
+
+    echo "    HW efficiency: ${HW_EFF_MEAN[$bench]}% +/- ${HW_EFF_STDDEV[$bench]}%"
+    echo ""
+done
+
+# Summary table: simulator accuracy per policy vs hardware efficiency
+echo -e "${BLUE}=== Prefetcher Validation ===${NC}"
+echo ""
+printf "| %-12s | %8s | %8s | %8s | %16s |\n" "Benchmark" "stream" "stride" "intel" "Hardware"
+printf "|--------------|----------|----------|----------|------------------|\n"
+
+for bench in "${BENCHMARKS[@]}"; do
+    HW="${HW_EFF_MEAN[$bench]:-N/A}"
+    if [[ "$HW" != "N/A" ]]; then
+        HW="${HW}% +/-${HW_EFF_STDDEV[$bench]}%"
+    fi
+    printf "| %-12s | %7s%% | %7s%% | %7s%% | %16s |\n" "$bench" \
+        "${SIM_ACCURACY[$bench,stream]:-N/A}" \
+        "${SIM_ACCURACY[$bench,stride]:-N/A}" \
+        "${SIM_ACCURACY[$bench,intel]:-N/A}" \
+        "$HW"
+done
+echo ""
+
+# Per-policy calibration offsets: mean of (sim accuracy - hw efficiency)
+# across the benchmarks that produced both numbers
+declare -A OFFSET_MEAN OFFSET_STDDEV
+for policy in "${POLICIES[@]}"; do
+    DELTAS=()
+    for bench in "${BENCHMARKS[@]}"; do
+        SIM="${SIM_ACCURACY[$bench,$policy]}"
+        HW="${HW_EFF_MEAN[$bench]}"
+        if [[ -n "$SIM" ]] && [[ "$HW" != "N/A" ]] && [[ -n "$HW" ]]; then
+            DELTAS+=("$(echo "scale=3; $SIM - $HW" | bc)")
+        fi
+    done
+    if [[ ${#DELTAS[@]} -gt 0 ]]; then
+        SUM=0
+        for d in "${DELTAS[@]}"; do SUM=$(echo "$SUM + $d" | bc); done
+        MEAN=$(echo "scale=3; $SUM / ${#DELTAS[@]}" | bc)
+        SQSUM=0
+        for d in "${DELTAS[@]}"; do
+            SQSUM=$(echo "$SQSUM + ($d - $MEAN) * ($d - $MEAN)" | bc)
+        done
+        OFFSET_MEAN[$policy]=$(echo "scale=1; $MEAN / 1" | bc)
+        OFFSET_STDDEV[$policy]=$(echo "scale=1; sqrt($SQSUM / ${#DELTAS[@]}) / 1" | bc -l)
+        echo "Policy $policy: offset ${OFFSET_MEAN[$policy]}% +/- ${OFFSET_STDDEV[$policy]}%"
+    else
+        OFFSET_MEAN[$policy]="null"
+        OFFSET_STDDEV[$policy]="null"
+        echo "Policy $policy: no hardware counters available, offset not computed"
+    fi
+done
+echo ""
+
+# Write the calibration file next to the hit-rate baselines, keyed by
+# preset so validate-against-baseline consumers can pick it up per config
+if $UPDATE_CALIBRATION; then
+    echo -e "${YELLOW}Updating calibration...${NC}"
+    mkdir -p "$BASELINES_DIR"
+    CALIB_FILE="$BASELINES_DIR/$SIM_CONFIG-prefetch-calibration.json"
+
+    cat > "$CALIB_FILE" << EOF
+{
+  "hardware": "$CPU_MODEL",
+  "vendor": "$CPU_VENDOR",
+  "kernel": "$KERNEL_VERSION",
+  "simulator_config": "$SIM_CONFIG",
+  "pf_counter_mode": "$PF_MODE",
+  "runs": $RUNS,
+  "date": "$TIMESTAMP",
+  "offsets": {
+EOF
+
+    FIRST=true
+    for policy in "${POLICIES[@]}"; do
+        if ! $FIRST; then echo "," >> "$CALIB_FILE"; fi
+        FIRST=false
+        cat >> "$CALIB_FILE" << EOF
+    "$policy": {
+      "mean_offset": ${OFFSET_MEAN[$policy]},
+      "stddev": ${OFFSET_STDDEV[$policy]}
+    }
+EOF
+    done
+
+    cat >> "$CALIB_FILE" << EOF
+
+  },
+  "benchmarks": {
+EOF
+
+    FIRST=true
+    for bench in "${BENCHMARKS[@]}"; do
+        if ! $FIRST; then echo "," >> "$CALIB_FILE"; fi
+        FIRST=false
+
+        HW_MEAN_JSON=${HW_EFF_MEAN[$bench]}
+        HW_STDDEV_JSON=${HW_EFF_STDDEV[$bench]}
+        [[ "$HW_MEAN_JSON" == "N/A" ]] && HW_MEAN_JSON="null"
+        [[ "$HW_STDDEV_JSON" == "N/A" ]] && HW_STDDEV_JSON="null"
+
+        cat >> "$CALIB_FILE" << EOF
+    "$bench": {
+      "hardware_efficiency": $HW_MEAN_JSON,
+      "hardware_stddev": $HW_STDDEV_JSON,
+      "hardware_pf_hits": ${HW_PF_HITS[$bench]:-0},
+      "hardware_pf_misses": ${HW_PF_MISSES[$bench]:-0},
+      "hardware_pf_drops": ${HW_PF_DROPS[$bench]:-0},
+      "simulator": {
+        "stream": {"issued": ${SIM_ISSUED[$bench,stream]:-0}, "useful": ${SIM_USEFUL[$bench,stream]:-0}, "accuracy": ${SIM_ACCURACY[$bench,stream]:-0}},
+        "stride": {"issued": ${SIM_ISSUED[$bench,stride]:-0}, "useful": ${SIM_USEFUL[$bench,stride]:-0}, "accuracy": ${SIM_ACCURACY[$bench,stride]:-0}},
+        "intel": {"issued": ${SIM_ISSUED[$bench,intel]:-0}, "useful": ${SIM_USEFUL[$bench,intel]:-0}, "accuracy": ${SIM_ACCURACY[$bench,intel]:-0}}
+      }
+    }
+EOF
+    done
+
+    cat >> "$CALIB_FILE" << EOF
+
+  }
+}
+EOF
+
+    echo -e "${GREEN}Calibration saved to: $CALIB_FILE${NC}"
+fi
+
+echo ""
+echo "Done."